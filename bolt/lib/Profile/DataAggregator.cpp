@@ -1368,6 +1368,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
   // LBRs are stored in reverse execution order. NextPC refers to the next
   // recorded executed PC.
   uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
+  // The function containing NextPC. Each LBR address is looked up once, as
+  // the lookups dominate the parsing of large profiles.
+  const BinaryFunction *NextPCFunc =
+      NextPC ? getBinaryFunctionContainingAddress(NextPC) : nullptr;
   uint32_t NumEntry = 0;
   for (const LBREntry &LBR : Sample.LBR) {
     ++NumEntry;
@@ -1379,12 +1383,14 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
     // chronological order)
     if (NeedsSkylakeFix && NumEntry <= 2)
       continue;
+    const BinaryFunction *FromFunc =
+        getBinaryFunctionContainingAddress(LBR.From);
+    const BinaryFunction *ToFunc = getBinaryFunctionContainingAddress(LBR.To);
     if (NextPC) {
       // Record fall-through trace.
       const uint64_t TraceFrom = LBR.To;
       const uint64_t TraceTo = NextPC;
-      const BinaryFunction *TraceBF =
-          getBinaryFunctionContainingAddress(TraceFrom);
+      const BinaryFunction *TraceBF = ToFunc;
       if (TraceBF && TraceBF->containsAddress(TraceTo)) {
         FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
         if (TraceBF->containsAddress(LBR.From))
@@ -1392,9 +1398,7 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
         else
           ++Info.ExternCount;
       } else {
-        const BinaryFunction *ToFunc =
-            getBinaryFunctionContainingAddress(TraceTo);
-        if (TraceBF && ToFunc) {
+        if (TraceBF && NextPCFunc) {
           LLVM_DEBUG({
             dbgs() << "Invalid trace starting in " << TraceBF->getPrintName()
                    << formatv(" @ {0:x}", TraceFrom - TraceBF->getAddress())
@@ -1408,9 +1412,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
                    << formatv(" @ {0:x}",
                               TraceFrom - (TraceBF ? TraceBF->getAddress() : 0))
                    << " and ending in "
-                   << (ToFunc ? ToFunc->getPrintName() : "None")
+                   << (NextPCFunc ? NextPCFunc->getPrintName() : "None")
                    << formatv(" @ {0:x}\n",
-                              TraceTo - (ToFunc ? ToFunc->getAddress() : 0));
+                              TraceTo -
+                                  (NextPCFunc ? NextPCFunc->getAddress() : 0));
           });
           ++NumLongRangeTraces;
         }
@@ -1418,9 +1423,10 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
       ++NumTraces;
     }
     NextPC = LBR.From;
+    NextPCFunc = FromFunc;
 
-    uint64_t From = getBinaryFunctionContainingAddress(LBR.From) ? LBR.From : 0;
-    uint64_t To = getBinaryFunctionContainingAddress(LBR.To) ? LBR.To : 0;
+    uint64_t From = FromFunc ? LBR.From : 0;
+    uint64_t To = ToFunc ? LBR.To : 0;
     if (!From && !To)
       continue;
     BranchInfo &Info = BranchLBRs[Trace(From, To)];
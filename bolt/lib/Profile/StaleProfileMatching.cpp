@@ -191,11 +191,17 @@ public:
       FlowBlock *Block = Blocks[I];
       uint16_t OpHash = Hashes[I].OpcodeHash;
       OpHashToBlocks[OpHash].push_back(std::make_pair(Hashes[I], Block));
+      HashToBlock.try_emplace(Hashes[I].combine(), Block);
     }
   }
 
   /// Find the most similar block for a given hash.
   const FlowBlock *matchBlock(BlendedBlockHash BlendedHash) const {
+    // Blocks of functions that did not change have an identical hash. That
+    // is the closest possible match, so skip scanning all the candidates.
+    auto ExactIt = HashToBlock.find(BlendedHash.combine());
+    if (ExactIt != HashToBlock.end())
+      return ExactIt->second;
     auto BlockIt = OpHashToBlocks.find(BlendedHash.OpcodeHash);
     if (BlockIt == OpHashToBlocks.end())
       return nullptr;
@@ -222,6 +228,8 @@ public:
 private:
   using HashBlockPairType = std::pair<BlendedBlockHash, FlowBlock *>;
   std::unordered_map<uint16_t, std::vector<HashBlockPairType>> OpHashToBlocks;
+  /// The first block with each combined hash.
+  std::unordered_map<uint64_t, FlowBlock *> HashToBlock;
 };
 
 void BinaryFunction::computeBlockHashes() const {
@@ -2686,6 +2686,8 @@ void RewriteInstance::handleRelocation(const SectionRef &RelocatedSection,
 }
 
 void RewriteInstance::selectFunctionsToProcess() {
+  NamedRegionTimer T("selectFunctions", "select functions to process",
+                     TimerGroupName, TimerGroupDesc, opts::TimeRewrite);
   // Extend the list of functions to process or skip from a file.
   auto populateFunctionNames = [](cl::opt<std::string> &FunctionNamesFile,
                                   cl::list<std::string> &FunctionNames) {
@@ -2927,14 +2929,20 @@ void RewriteInstance::initializeMetadataManager() {
 }
 
 void RewriteInstance::processMetadataPreCFG() {
-  initializeMetadataManager();
+  {
+    NamedRegionTimer T("processMetadataPreCFG", "process metadata pre-CFG",
+                       TimerGroupName, TimerGroupDesc, opts::TimeRewrite);
+    initializeMetadataManager();
 
-  MetadataManager.runInitializersPreCFG();
+    MetadataManager.runInitializersPreCFG();
+  }
 
   processProfileDataPreCFG();
 }
 
 void RewriteInstance::processMetadataPostCFG() {
+  NamedRegionTimer T("processMetadataPostCFG", "process metadata post-CFG",
+                     TimerGroupName, TimerGroupDesc, opts::TimeRewrite);
   MetadataManager.runInitializersPostCFG();
 }
 
@@ -3116,6 +3124,8 @@ void RewriteInstance::buildFunctionsCFG() {
 }
 
 void RewriteInstance::postProcessFunctions() {
+  NamedRegionTimer T("postProcessFunctions", "post-process functions",
+                     TimerGroupName, TimerGroupDesc, opts::TimeRewrite);
   // We mark fragments as non-simple here, not during disassembly,
   // So we can build their CFGs.
   BC->skipMarkedFragments();
@@ -3298,7 +3308,11 @@ void RewriteInstance::emitAndLink() {
 }
 
 void RewriteInstance::updateMetadata() {
-  MetadataManager.runFinalizersAfterEmit();
+  {
+    NamedRegionTimer T("updateMetadata", "update metadata", TimerGroupName,
+                       TimerGroupDesc, opts::TimeRewrite);
+    MetadataManager.runFinalizersAfterEmit();
+  }
 
   if (opts::UpdateDebugSections) {
     NamedRegionTimer T("updateDebugInfo", "update debug info", TimerGroupName,
@@ -5175,6 +5189,8 @@ uint64_t RewriteInstance::getNewFunctionOrDataAddress(uint64_t OldAddress) {
 }
 
 void RewriteInstance::rewriteFile() {
+  NamedRegionTimer T("rewriteFile", "rewrite output file", TimerGroupName,
+                     TimerGroupDesc, opts::TimeRewrite);
   std::error_code EC;
   Out = std::make_unique<ToolOutputFile>(opts::OutputFilename, EC,
                                          sys::fs::OF_None);
@@ -94,6 +94,7 @@ BackgroundIndex::BackgroundIndex(
     const ThreadsafeFS &TFS, const GlobalCompilationDatabase &CDB,
     BackgroundIndexStorage::Factory IndexStorageFactory, Options Opts)
     : SwapIndex(std::make_unique<MemIndex>()), TFS(TFS), CDB(CDB),
+      ThreadPoolSize(Opts.ThreadPoolSize),
       IndexingPriority(Opts.IndexingPriority),
       ContextProvider(std::move(Opts.ContextProvider)),
       IndexedSymbols(IndexContents::All),
@@ -367,7 +368,7 @@ BackgroundIndex::loadProject(std::vector<std::string> MainFiles) {
   Rebuilder.startLoading();
   // Load shards for all of the mainfiles.
   const std::vector<LoadedShard> Result =
-      loadIndexShards(MainFiles, IndexStorageFactory, CDB);
+      loadIndexShards(MainFiles, IndexStorageFactory, CDB, ThreadPoolSize);
   size_t LoadedShards = 0;
   {
     // Update in-memory state.
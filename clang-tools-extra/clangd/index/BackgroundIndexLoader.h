@@ -37,11 +37,12 @@ struct LoadedShard {
   std::unique_ptr<IndexFileIn> Shard;
 };
 
-/// Loads all shards for the TU \p MainFile from \p Storage.
+/// Loads all shards for the TUs \p MainFiles from \p Storage, reading up to
+/// \p NumThreads shards concurrently.
 std::vector<LoadedShard>
 loadIndexShards(llvm::ArrayRef<Path> MainFiles,
                 BackgroundIndexStorage::Factory &IndexStorageFactory,
-                const GlobalCompilationDatabase &CDB);
+                const GlobalCompilationDatabase &CDB, size_t NumThreads = 1);
 
 } // namespace clangd
 } // namespace clang
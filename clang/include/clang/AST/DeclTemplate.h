@@ -820,7 +820,30 @@ protected:
     return SpecIterator<EntryType>(isEnd ? Specs.end() : Specs.begin());
   }
 
-  void loadLazySpecializationsImpl() const;
+  /// A specialization (including partial specializations) known only by its
+  /// external declaration ID.
+  struct LazySpecializationInfo {
+    /// The external declaration ID, or 0 once the specialization is loaded.
+    uint32_t DeclID = 0;
+    /// The hash of the template arguments of the specialization, see
+    /// getSpecializationArgsHash().
+    unsigned ArgsHash = 0;
+    /// Whether this is a partial specialization. Partial specializations are
+    /// found by deduction rather than by their arguments, so all of them are
+    /// loaded for any partial specialization lookup.
+    bool IsPartial = false;
+  };
+
+  /// Loads the lazy specializations of this template, or only the partial
+  /// specializations if \p OnlyPartial is true.
+  void loadLazySpecializationsImpl(bool OnlyPartial = false) const;
+
+  /// Loads the lazy specializations of this template which might have the
+  /// template arguments \p Args.
+  void loadLazySpecializationsImpl(ArrayRef<TemplateArgument> Args) const;
+
+  /// Loads a single lazy specialization and marks it as loaded.
+  void loadLazySpecializationImpl(LazySpecializationInfo &Info) const;
 
   template <class EntryType, typename ...ProfileArguments>
   typename SpecEntryTraits<EntryType>::DeclType*
@@ -845,9 +868,9 @@ protected:
     /// If non-null, points to an array of specializations (including
     /// partial specializations) known only by their external declaration IDs.
     ///
-    /// The first value in the array is the number of specializations/partial
-    /// specializations that follow.
-    uint32_t *LazySpecializations = nullptr;
+    /// The DeclID of the first entry in the array is the number of
+    /// specializations/partial specializations that follow.
+    LazySpecializationInfo *LazySpecializations = nullptr;
 
     /// The set of "injected" template arguments used within this
     /// template.
@@ -882,6 +905,15 @@ public:
   friend class ASTReader;
   template <class decl_type> friend class RedeclarableTemplate;
 
+  /// Computes the hash of \p Args that lazily loaded specializations are
+  /// keyed by. Template argument lists which are the same have the same hash,
+  /// even across AST files.
+  static unsigned getSpecializationArgsHash(ArrayRef<TemplateArgument> Args);
+
+  /// Computes the hash of the template arguments of \p Spec, which is a
+  /// class, variable or function template specialization.
+  static unsigned getSpecializationArgsHash(const Decl *Spec);
+
   /// Retrieves the canonical declaration of this template.
   RedeclarableTemplateDecl *getCanonicalDecl() override {
     return getFirstDecl();
@@ -1050,6 +1082,10 @@ public:
   /// Load any lazily-loaded specializations from the external source.
   void LoadLazySpecializations() const;
 
+  /// Load the lazily-loaded specializations from the external source which
+  /// might have the template arguments \p Args.
+  void LoadLazySpecializations(ArrayRef<TemplateArgument> Args) const;
+
   /// Get the underlying function declaration of the template.
   FunctionDecl *getTemplatedDecl() const {
     return static_cast<FunctionDecl *>(TemplatedDecl);
@@ -2317,8 +2353,13 @@ public:
   friend class ASTDeclWriter;
   friend class TemplateDeclInstantiator;
 
-  /// Load any lazily-loaded specializations from the external source.
-  void LoadLazySpecializations() const;
+  /// Load any lazily-loaded specializations from the external source, or
+  /// only the partial specializations if \p OnlyPartial is true.
+  void LoadLazySpecializations(bool OnlyPartial = false) const;
+
+  /// Load the lazily-loaded specializations from the external source which
+  /// might have the template arguments \p Args.
+  void LoadLazySpecializations(ArrayRef<TemplateArgument> Args) const;
 
   /// Get the underlying class declarations of the template.
   CXXRecordDecl *getTemplatedDecl() const {
@@ -3151,8 +3192,13 @@ public:
   friend class ASTDeclReader;
   friend class ASTDeclWriter;
 
-  /// Load any lazily-loaded specializations from the external source.
-  void LoadLazySpecializations() const;
+  /// Load any lazily-loaded specializations from the external source, or
+  /// only the partial specializations if \p OnlyPartial is true.
+  void LoadLazySpecializations(bool OnlyPartial = false) const;
+
+  /// Load the lazily-loaded specializations from the external source which
+  /// might have the template arguments \p Args.
+  void LoadLazySpecializations(ArrayRef<TemplateArgument> Args) const;
 
   /// Get the underlying variable declarations of the template.
   VarDecl *getTemplatedDecl() const {
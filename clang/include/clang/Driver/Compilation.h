@@ -21,6 +21,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -123,6 +124,13 @@ class Compilation {
   /// class Command and the exit status of the corresponding child process.
   std::function<void(const Command &, int)> PostCallback;
 
+  /// The number of jobs which may be executed at the same time.
+  unsigned NumParallelJobs = 1;
+
+  /// Serializes the logging, the diagnostics and the callback of commands
+  /// which are executed in parallel.
+  mutable std::mutex ExecuteMutex;
+
   /// Whether we're compiling for diagnostic purposes.
   bool ForDiagnostics = false;
 
@@ -236,6 +244,11 @@ public:
     PostCallback = CB;
   }
 
+  /// Sets the number of independent jobs which ExecuteJobs may run at the
+  /// same time (-parallel-jobs=).
+  void setNumParallelJobs(unsigned N) { NumParallelJobs = N; }
+  unsigned getNumParallelJobs() const { return NumParallelJobs; }
+
   /// Returns the sysroot path.
   StringRef getSysRoot() const;
 
@@ -228,6 +228,10 @@ public:
   /// diagnostics.
   unsigned ModulesStrictContextHash : 1;
 
+  /// Whether the results of status lookups on the file system are cached for
+  /// the lifetime of the file system (-fvfs-stat-cache).
+  unsigned CacheVFSStatus : 1;
+
   HeaderSearchOptions(StringRef _Sysroot = "/")
       : Sysroot(_Sysroot), ModuleFormat("raw"), DisableModuleHash(false),
         ImplicitModuleMaps(false), ModuleMapFileHomeIsCwd(false),
@@ -239,7 +243,7 @@ public:
         ValidateASTInputFilesContent(false),
         ForceCheckCXX20ModulesInputFiles(false), UseDebugInfo(false),
         ModulesValidateDiagnosticOptions(true), ModulesHashContent(false),
-        ModulesStrictContextHash(false) {}
+        ModulesStrictContextHash(false), CacheVFSStatus(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
@@ -233,6 +233,10 @@ public:
     AddDeclRef(D);
   }
 
+  /// Emit a reference to a declaration of a template specialization, followed
+  /// by what the reader needs to load it only when it is looked up.
+  void AddLazySpecializationRef(const Decl *D);
+
   /// Emit a declaration name.
   void AddDeclarationName(DeclarationName Name) {
     writeDeclarationName(Name);
@@ -18,6 +18,7 @@
 #include "llvm/Support/VirtualFileSystem.h"
 #include <mutex>
 #include <optional>
+#include <vector>
 
 namespace clang {
 namespace tooling {
@@ -202,6 +203,13 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// Returns the filenames whose cached entries no longer match the state of
+  /// \p UnderlyingFS, i.e. files that were created, removed, replaced or
+  /// modified since they were cached. A client that keeps the cache alive
+  /// between scans can use this to decide whether the cache may be reused.
+  std::vector<StringRef>
+  getOutOfDateEntries(llvm::vfs::FileSystem &UnderlyingFS) const;
+
 private:
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
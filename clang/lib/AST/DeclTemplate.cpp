@@ -331,19 +331,116 @@ RedeclarableTemplateDecl::CommonBase *RedeclarableTemplateDecl::getCommonPtr() c
   return Common;
 }
 
-void RedeclarableTemplateDecl::loadLazySpecializationsImpl() const {
+static void addDeclNameToArgsHash(llvm::FoldingSetNodeID &ID,
+                                  DeclarationName Name) {
+  // Only the spelling of a name is the same in every AST file.
+  if (const IdentifierInfo *II = Name.getAsIdentifierInfo())
+    ID.AddString(II->getName());
+  else
+    ID.AddInteger(Name.getNameKind());
+}
+
+static void addTypeToArgsHash(llvm::FoldingSetNodeID &ID, QualType T) {
+  // The hash only needs to tell apart the types a lookup commonly has to
+  // choose between, anything else may collide.
+  for (T = T.getCanonicalType(); !T.isNull(); T = T->getPointeeType()) {
+    ID.AddInteger(T.getCVRQualifiers());
+    const Type *Ty = T.getTypePtr();
+    ID.AddInteger(Ty->getTypeClass());
+    if (const auto *BT = dyn_cast<BuiltinType>(Ty))
+      ID.AddInteger(BT->getKind());
+    else if (const auto *TT = dyn_cast<TagType>(Ty))
+      addDeclNameToArgsHash(ID, TT->getDecl()->getDeclName());
+  }
+}
+
+static void addTemplateArgumentToArgsHash(llvm::FoldingSetNodeID &ID,
+                                          const TemplateArgument &Arg) {
+  ID.AddInteger(Arg.getKind());
+  switch (Arg.getKind()) {
+  case TemplateArgument::Null:
+  case TemplateArgument::NullPtr:
+  case TemplateArgument::Expression:
+    break;
+  case TemplateArgument::Type:
+    addTypeToArgsHash(ID, Arg.getAsType());
+    break;
+  case TemplateArgument::Declaration:
+    addDeclNameToArgsHash(ID, Arg.getAsDecl()->getDeclName());
+    break;
+  case TemplateArgument::Integral:
+    ID.AddInteger(Arg.getAsIntegral().getLimitedValue());
+    break;
+  case TemplateArgument::Template:
+  case TemplateArgument::TemplateExpansion: {
+    // Canonical template template parameters have no name.
+    TemplateDecl *Template =
+        Arg.getAsTemplateOrTemplatePattern().getAsTemplateDecl();
+    if (Template && !isa<TemplateTemplateParmDecl>(Template))
+      addDeclNameToArgsHash(ID, Template->getDeclName());
+    break;
+  }
+  case TemplateArgument::Pack:
+    ID.AddInteger(Arg.pack_size());
+    for (const TemplateArgument &Elt : Arg.pack_elements())
+      addTemplateArgumentToArgsHash(ID, Elt);
+    break;
+  }
+}
+
+unsigned RedeclarableTemplateDecl::getSpecializationArgsHash(
+    ArrayRef<TemplateArgument> Args) {
+  llvm::FoldingSetNodeID ID;
+  ID.AddInteger(Args.size());
+  for (const TemplateArgument &Arg : Args)
+    addTemplateArgumentToArgsHash(ID, Arg);
+  return ID.ComputeHash();
+}
+
+unsigned RedeclarableTemplateDecl::getSpecializationArgsHash(const Decl *Spec) {
+  if (const auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(Spec))
+    return getSpecializationArgsHash(CTSD->getTemplateArgs().asArray());
+  if (const auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(Spec))
+    return getSpecializationArgsHash(VTSD->getTemplateArgs().asArray());
+  const auto *FD = cast<FunctionDecl>(Spec);
+  return getSpecializationArgsHash(
+      FD->getTemplateSpecializationArgs()->asArray());
+}
+
+void RedeclarableTemplateDecl::loadLazySpecializationsImpl(
+    bool OnlyPartial) const {
   // Grab the most recent declaration to ensure we've loaded any lazy
   // redeclarations of this template.
   CommonBase *CommonBasePtr = getMostRecentDecl()->getCommonPtr();
-  if (CommonBasePtr->LazySpecializations) {
-    ASTContext &Context = getASTContext();
-    uint32_t *Specs = CommonBasePtr->LazySpecializations;
-    CommonBasePtr->LazySpecializations = nullptr;
-    for (uint32_t I = 0, N = *Specs++; I != N; ++I)
-      (void)Context.getExternalSource()->GetExternalDecl(Specs[I]);
+  if (LazySpecializationInfo *Specs = CommonBasePtr->LazySpecializations) {
+    if (!OnlyPartial)
+      CommonBasePtr->LazySpecializations = nullptr;
+    for (uint32_t I = 1, N = Specs[0].DeclID; I <= N; ++I)
+      if (Specs[I].DeclID && (!OnlyPartial || Specs[I].IsPartial))
+        loadLazySpecializationImpl(Specs[I]);
+  }
+}
+
+void RedeclarableTemplateDecl::loadLazySpecializationsImpl(
+    ArrayRef<TemplateArgument> Args) const {
+  CommonBase *CommonBasePtr = getMostRecentDecl()->getCommonPtr();
+  if (LazySpecializationInfo *Specs = CommonBasePtr->LazySpecializations) {
+    unsigned Hash = getSpecializationArgsHash(Args);
+    for (uint32_t I = 1, N = Specs[0].DeclID; I <= N; ++I)
+      if (Specs[I].DeclID && !Specs[I].IsPartial && Specs[I].ArgsHash == Hash)
+        loadLazySpecializationImpl(Specs[I]);
   }
 }
 
+void RedeclarableTemplateDecl::loadLazySpecializationImpl(
+    LazySpecializationInfo &Info) const {
+  uint32_t ID = Info.DeclID;
+  // Mark the specialization as loaded first, loading it may look up other
+  // specializations of this template.
+  Info.DeclID = 0;
+  (void)getASTContext().getExternalSource()->GetExternalDecl(ID);
+}
+
 template<class EntryType, typename... ProfileArguments>
 typename RedeclarableTemplateDecl::SpecEntryTraits<EntryType>::DeclType *
 RedeclarableTemplateDecl::findSpecializationImpl(
@@ -364,6 +461,11 @@ void RedeclarableTemplateDecl::addSpecializationImpl(
     void *InsertPos) {
   using SETraits = SpecEntryTraits<EntryType>;
 
+  // Loading a lazy specialization since InsertPos was computed may have
+  // invalidated it.
+  if (getMostRecentDecl()->getCommonPtr()->LazySpecializations)
+    InsertPos = nullptr;
+
   if (InsertPos) {
 #ifndef NDEBUG
     void *CorrectInsertPos;
@@ -434,6 +536,11 @@ void FunctionTemplateDecl::LoadLazySpecializations() const {
   loadLazySpecializationsImpl();
 }
 
+void FunctionTemplateDecl::LoadLazySpecializations(
+    ArrayRef<TemplateArgument> Args) const {
+  loadLazySpecializationsImpl(Args);
+}
+
 llvm::FoldingSetVector<FunctionTemplateSpecializationInfo> &
 FunctionTemplateDecl::getSpecializations() const {
   LoadLazySpecializations();
@@ -443,13 +550,15 @@ FunctionTemplateDecl::getSpecializations() const {
 FunctionDecl *
 FunctionTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                          void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), InsertPos, Args);
+  LoadLazySpecializations(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, InsertPos,
+                                Args);
 }
 
 void FunctionTemplateDecl::addSpecialization(
       FunctionTemplateSpecializationInfo *Info, void *InsertPos) {
-  addSpecializationImpl<FunctionTemplateDecl>(getSpecializations(), Info,
-                                              InsertPos);
+  addSpecializationImpl<FunctionTemplateDecl>(getCommonPtr()->Specializations,
+                                              Info, InsertPos);
 }
 
 void FunctionTemplateDecl::mergePrevDecl(FunctionTemplateDecl *Prev) {
@@ -508,8 +617,13 @@ ClassTemplateDecl *ClassTemplateDecl::CreateDeserialized(ASTContext &C,
                                        DeclarationName(), nullptr, nullptr);
 }
 
-void ClassTemplateDecl::LoadLazySpecializations() const {
-  loadLazySpecializationsImpl();
+void ClassTemplateDecl::LoadLazySpecializations(bool OnlyPartial) const {
+  loadLazySpecializationsImpl(OnlyPartial);
+}
+
+void ClassTemplateDecl::LoadLazySpecializations(
+    ArrayRef<TemplateArgument> Args) const {
+  loadLazySpecializationsImpl(Args);
 }
 
 llvm::FoldingSetVector<ClassTemplateSpecializationDecl> &
@@ -520,7 +634,7 @@ ClassTemplateDecl::getSpecializations() const {
 
 llvm::FoldingSetVector<ClassTemplatePartialSpecializationDecl> &
 ClassTemplateDecl::getPartialSpecializations() const {
-  LoadLazySpecializations();
+  LoadLazySpecializations(/*OnlyPartial=*/true);
   return getCommonPtr()->PartialSpecializations;
 }
 
@@ -534,12 +648,15 @@ ClassTemplateDecl::newCommon(ASTContext &C) const {
 ClassTemplateSpecializationDecl *
 ClassTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                       void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), InsertPos, Args);
+  LoadLazySpecializations(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, InsertPos,
+                                Args);
 }
 
 void ClassTemplateDecl::AddSpecialization(ClassTemplateSpecializationDecl *D,
                                           void *InsertPos) {
-  addSpecializationImpl<ClassTemplateDecl>(getSpecializations(), D, InsertPos);
+  addSpecializationImpl<ClassTemplateDecl>(getCommonPtr()->Specializations, D,
+                                           InsertPos);
 }
 
 ClassTemplatePartialSpecializationDecl *
@@ -1239,8 +1356,13 @@ VarTemplateDecl *VarTemplateDecl::CreateDeserialized(ASTContext &C,
                                      DeclarationName(), nullptr, nullptr);
 }
 
-void VarTemplateDecl::LoadLazySpecializations() const {
-  loadLazySpecializationsImpl();
+void VarTemplateDecl::LoadLazySpecializations(bool OnlyPartial) const {
+  loadLazySpecializationsImpl(OnlyPartial);
+}
+
+void VarTemplateDecl::LoadLazySpecializations(
+    ArrayRef<TemplateArgument> Args) const {
+  loadLazySpecializationsImpl(Args);
 }
 
 llvm::FoldingSetVector<VarTemplateSpecializationDecl> &
@@ -1251,7 +1373,7 @@ VarTemplateDecl::getSpecializations() const {
 
 llvm::FoldingSetVector<VarTemplatePartialSpecializationDecl> &
 VarTemplateDecl::getPartialSpecializations() const {
-  LoadLazySpecializations();
+  LoadLazySpecializations(/*OnlyPartial=*/true);
   return getCommonPtr()->PartialSpecializations;
 }
 
@@ -1265,12 +1387,15 @@ VarTemplateDecl::newCommon(ASTContext &C) const {
 VarTemplateSpecializationDecl *
 VarTemplateDecl::findSpecialization(ArrayRef<TemplateArgument> Args,
                                     void *&InsertPos) {
-  return findSpecializationImpl(getSpecializations(), InsertPos, Args);
+  LoadLazySpecializations(Args);
+  return findSpecializationImpl(getCommonPtr()->Specializations, InsertPos,
+                                Args);
 }
 
 void VarTemplateDecl::AddSpecialization(VarTemplateSpecializationDecl *D,
                                         void *InsertPos) {
-  addSpecializationImpl<VarTemplateDecl>(getSpecializations(), D, InsertPos);
+  addSpecializationImpl<VarTemplateDecl>(getCommonPtr()->Specializations, D,
+                                         InsertPos);
 }
 
 VarTemplatePartialSpecializationDecl *
@@ -1036,19 +1036,27 @@ private:
     const bool EnableCheckProfiling = Options.CheckProfiling.has_value();
     TimeBucketRegion Timer;
     auto &Matchers = this->Matchers->DeclOrStmt;
+    // Only expressions can be skipped by matchers ignoring nodes not spelled
+    // in source. Whether this one is skipped is computed at most once, rather
+    // than once per applicable matcher.
+    const auto *E = DynNode.get<Expr>();
+    std::optional<bool> IsNotSpelledInSource;
+    TraversalKind DefaultTK =
+        getASTContext().getParentMapContext().getTraversalKind();
     for (unsigned short I : Filter) {
       auto &MP = Matchers[I];
+      if (E && MP.first.getTraversalKind().value_or(DefaultTK) ==
+                   TK_IgnoreUnlessSpelledInSource) {
+        if (!IsNotSpelledInSource)
+          IsNotSpelledInSource = E->IgnoreUnlessSpelledInSource() != E;
+        if (*IsNotSpelledInSource)
+          continue;
+      }
+
       if (EnableCheckProfiling)
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
       BoundNodesTreeBuilder Builder;
 
-      {
-        TraversalKindScope RAII(getASTContext(), MP.first.getTraversalKind());
-        if (getASTContext().getParentMapContext().traverseIgnored(DynNode) !=
-            DynNode)
-          continue;
-      }
-
       CurMatchRAII RAII(*this, MP.second, DynNode);
       if (MP.first.matches(DynNode, this, &Builder)) {
         MatchVisitor Visitor(*this, ActiveASTContext, MP.second);
@@ -15,17 +15,24 @@
 #include "clang/Driver/Options.h"
 #include "clang/Driver/ToolChain.h"
 #include "clang/Driver/Util.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptSpecifier.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/SimpleTable.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 #include <cassert>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -198,6 +205,7 @@ bool Compilation::CleanupFileMap(const ArgStringMap &Files,
 int Compilation::ExecuteCommand(const Command &C,
                                 const Command *&FailingCommand,
                                 bool LogOnly) const {
+  std::unique_lock<std::mutex> Lock(ExecuteMutex);
   if ((getDriver().CCPrintOptions ||
        getArgs().hasArg(options::OPT_v)) && !getDriver().CCGenDiagnostics) {
     raw_ostream *OS = &llvm::errs();
@@ -231,7 +239,9 @@ int Compilation::ExecuteCommand(const Command &C,
 
   std::string Error;
   bool ExecutionFailed;
+  Lock.unlock();
   int Res = C.Execute(Redirects, &Error, &ExecutionFailed);
+  Lock.lock();
   if (PostCallback)
     PostCallback(C, Res);
   if (!Error.empty()) {
@@ -287,9 +297,131 @@ static bool InputsOk(const Command &C,
   return !ActionFailed(&C.getSource(), FailingCommands);
 }
 
+// Collects the actions which the job of action A depends on.
+static void collectInputActions(const Action *A,
+                                llvm::SmallPtrSetImpl<const Action *> &Seen) {
+  for (const Action *Input : A->inputs())
+    if (Seen.insert(Input).second)
+      collectInputActions(Input, Seen);
+}
+
+// Computes for each job the earlier jobs which have to finish before it can
+// start. A job depends on an earlier one if the action of the earlier job is
+// an input of its action, or if the earlier job writes a file the job reads or
+// writes, or reads a file the job writes.
+static std::vector<SmallVector<size_t, 4>>
+computeJobDependencies(const JobList &Jobs) {
+  std::vector<SmallVector<size_t, 4>> Deps(Jobs.size());
+  llvm::DenseMap<const Action *, SmallVector<size_t, 2>> JobsOfAction;
+  llvm::StringMap<SmallVector<size_t, 2>> Readers;
+  llvm::StringMap<SmallVector<size_t, 2>> Writers;
+  size_t I = 0;
+  for (const Command &Job : Jobs) {
+    SmallVector<size_t, 4> &JobDeps = Deps[I];
+    llvm::SmallPtrSet<const Action *, 16> Inputs;
+    Inputs.insert(&Job.getSource());
+    collectInputActions(&Job.getSource(), Inputs);
+    for (const Action *Input : Inputs) {
+      auto It = JobsOfAction.find(Input);
+      if (It != JobsOfAction.end())
+        JobDeps.append(It->second.begin(), It->second.end());
+    }
+    for (const InputInfo &Input : Job.getInputInfos()) {
+      if (!Input.isFilename())
+        continue;
+      auto It = Writers.find(Input.getFilename());
+      if (It != Writers.end())
+        JobDeps.append(It->second.begin(), It->second.end());
+      Readers[Input.getFilename()].push_back(I);
+    }
+    for (const std::string &Output : Job.getOutputFilenames()) {
+      for (const auto *Accesses : {&Readers, &Writers}) {
+        auto It = Accesses->find(Output);
+        if (It != Accesses->end())
+          JobDeps.append(It->second.begin(), It->second.end());
+      }
+      Writers[Output].push_back(I);
+    }
+    llvm::sort(JobDeps);
+    JobDeps.erase(std::unique(JobDeps.begin(), JobDeps.end()), JobDeps.end());
+    // A job reading its own output doesn't depend on itself.
+    if (!JobDeps.empty() && JobDeps.back() == I)
+      JobDeps.pop_back();
+    JobsOfAction[&Job.getSource()].push_back(I);
+    ++I;
+  }
+  return Deps;
+}
+
+// Executes the jobs with up to NumJobs of them running at the same time,
+// starting each job once the jobs it depends on have finished. The results
+// are the same as of executing the jobs in order, except that a job may run
+// even though an unrelated earlier job of an offloading compilation fails.
+static void executeJobsInParallel(const Compilation &C, const JobList &Jobs,
+                                  FailingCommandList &FailingCommands,
+                                  unsigned NumJobs) {
+  std::vector<SmallVector<size_t, 4>> Deps = computeJobDependencies(Jobs);
+  std::vector<const Command *> Commands;
+  for (const Command &Job : Jobs)
+    Commands.push_back(&Job);
+
+  enum class JobState { Waiting, Running, Finished };
+  std::vector<JobState> States(Commands.size(), JobState::Waiting);
+  std::mutex Mutex;
+  std::condition_variable Finished;
+  unsigned NumRunning = 0;
+  bool Bail = false;
+
+  llvm::ThreadPool Pool(llvm::hardware_concurrency(NumJobs));
+  std::unique_lock<std::mutex> Lock(Mutex);
+  for (;;) {
+    bool AllFinished = true;
+    for (size_t I = 0, E = Commands.size(); I != E; ++I) {
+      if (States[I] != JobState::Waiting)
+        continue;
+      AllFinished = false;
+      if (Bail || NumRunning == NumJobs ||
+          llvm::any_of(Deps[I], [&](size_t J) {
+            return States[J] != JobState::Finished;
+          }))
+        continue;
+      if (!InputsOk(*Commands[I], FailingCommands)) {
+        States[I] = JobState::Finished;
+        continue;
+      }
+      States[I] = JobState::Running;
+      ++NumRunning;
+      Pool.async([&, I] {
+        const Command *FailingCommand = nullptr;
+        int Res = C.ExecuteCommand(*Commands[I], FailingCommand);
+        std::lock_guard<std::mutex> Guard(Mutex);
+        if (Res) {
+          FailingCommands.push_back(std::make_pair(Res, FailingCommand));
+          // Bail as soon as one command fails in cl driver mode.
+          if (C.getDriver().IsCLMode() &&
+              FailingCommand->getWillExitForErrorCode(Res))
+            Bail = true;
+        }
+        States[I] = JobState::Finished;
+        --NumRunning;
+        Finished.notify_one();
+      });
+    }
+    if (NumRunning == 0 && (AllFinished || Bail))
+      break;
+    if (NumRunning != 0)
+      Finished.wait(Lock);
+  }
+}
+
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands,
                               bool LogOnly) const {
+  if (!LogOnly && NumParallelJobs > 1 && Jobs.size() > 1) {
+    executeJobsInParallel(*this, Jobs, FailingCommands, NumParallelJobs);
+    return;
+  }
+
   // According to UNIX standard, driver need to continue compiling all the
   // inputs on the command line even one of them failed.
   // In all but CLMode, execute all the jobs unless the necessary inputs for the
@@ -1148,7 +1148,8 @@ void Driver::CreateOffloadingDeviceToolChains(Compilation &C,
       C.getInputArgs().getLastArg(options::OPT_fsycl_device_code_split_EQ);
   checkSingleArgValidity(SYCLLink, {"early", "image"});
   checkSingleArgValidity(DeviceCodeSplit,
-                         {"per_kernel", "per_source", "auto", "off"});
+                         {"per_kernel", "per_source", "auto", "off",
+                          "by_cost"});
 
   Arg *SYCLForceTarget =
       getArgRequiringSYCLRuntime(options::OPT_fsycl_force_target_EQ);
@@ -1813,6 +1814,16 @@ Compilation *Driver::BuildCompilation(ArrayRef<const char *> ArgList) {
   Compilation *C = new Compilation(*this, TC, UArgs.release(), TranslatedArgs,
                                    ContainsError);
 
+  if (const Arg *A = C->getArgs().getLastArg(options::OPT_parallel_jobs_EQ)) {
+    unsigned NumJobs;
+    StringRef Value = A->getValue();
+    if (Value.getAsInteger(10, NumJobs) || NumJobs == 0)
+      Diag(diag::err_drv_invalid_int_value)
+          << A->getAsString(C->getArgs()) << Value;
+    else
+      C->setNumParallelJobs(NumJobs);
+  }
+
   if (!HandleImmediateArgs(*C))
     return C;
 
@@ -5631,7 +5642,7 @@ class OffloadingActionBuilder final {
         //   r - relocatable device code is requested
         //   f - link object output type is TY_Tempfilelist (fat archive)
         //   e - Embedded IR for fusion (-fsycl-embed-ir) was requested
-        //       and target is NVPTX.
+        //       and target is NVPTX/AMDGCN.
         //   * - "all other cases"
         //     - no condition means output/input is "always" present
         // First symbol indicates output/input type
@@ -5827,12 +5838,13 @@ class OffloadingActionBuilder final {
             DA.add(*DeviceWrappingAction, *TC, BoundArch, Action::OFK_SYCL);
             continue;
           }
-          if (isNVPTX && Args.hasArg(options::OPT_fsycl_embed_ir)) {
-            // When compiling for Nvidia/CUDA devices and the user requested the
-            // IR to be embedded in the application (via option), run the output
-            // of sycl-post-link (filetable referencing LLVM Bitcode + symbols)
-            // through the offload wrapper and link the resulting object to the
-            // application.
+          if ((isNVPTX || isAMDGCN) &&
+              Args.hasArg(options::OPT_fsycl_embed_ir)) {
+            // When compiling for Nvidia/CUDA or AMD/HIP devices and the user
+            // requested the IR to be embedded in the application (via option),
+            // run the output of sycl-post-link (filetable referencing LLVM
+            // Bitcode + symbols) through the offload wrapper and link the
+            // resulting object to the application.
             auto *WrapBitcodeAction = C.MakeAction<OffloadWrapperJobAction>(
                 PostLinkAction, types::TY_Object, true);
             DA.add(*WrapBitcodeAction, *TC, BoundArch, Action::OFK_SYCL);
@@ -8705,13 +8717,26 @@ InputInfoList Driver::BuildJobsForActionNoCache(
                            TargetDeviceOffloadKind, CachedResults, FEA);
       const Tool *Creator = &Cmd->getCreator();
       StringRef ParallelJobs;
-      if (TargetDeviceOffloadKind == Action::OFK_SYCL)
+      StringRef CacheDir;
+      if (TargetDeviceOffloadKind == Action::OFK_SYCL) {
         ParallelJobs = C.getArgs().getLastArgValue(
             options::OPT_fsycl_max_parallel_jobs_EQ);
+        // Outputs are only cached for commands which read no inputs besides
+        // the iterated ones, such as the SPIR-V translation, or ptxas and
+        // fatbinary for NVPTX targets.
+        bool IsNVPTXImageAction =
+            TC->getTriple().isNVPTX() &&
+            (isa<AssembleJobAction>(SourceAction) ||
+             isa<LinkJobAction>(SourceAction));
+        if (isa<SPIRVTranslatorJobAction>(SourceAction) || IsNVPTXImageAction)
+          CacheDir = C.getArgs().getLastArgValue(
+              options::OPT_fsycl_device_code_cache_dir_EQ);
+      }
 
       tools::SYCL::constructLLVMForeachCommand(
           C, *SourceAction, std::move(Cmd), InputInfos, ActionResult, Creator,
-          "", types::getTypeTempSuffix(ActionResult.getType()), ParallelJobs);
+          "", types::getTypeTempSuffix(ActionResult.getType()), ParallelJobs,
+          CacheDir);
     }
     return { ActionResult };
   }
@@ -7887,6 +7887,10 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     A->claim();
   }
 
+  // Forward -fvfs-stat-cache to -cc1.
+  Args.addOptInFlag(CmdArgs, options::OPT_fvfs_stat_cache,
+                    options::OPT_fno_vfs_stat_cache);
+
   Args.addOptInFlag(CmdArgs, options::OPT_fsafe_buffer_usage_suggestions,
                     options::OPT_fno_safe_buffer_usage_suggestions);
 
@@ -9557,6 +9561,14 @@ void OffloadWrapper::ConstructJob(Compilation &C, const JobAction &JA,
     // together with supporting AOT in the driver. If format is not set, the
     // default is "none" which means runtime must try to determine it
     // automatically.
+    if (TCArgs.hasFlag(options::OPT_offload_compress,
+                       options::OPT_no_offload_compress, false)) {
+      WrapperArgs.push_back(C.getArgs().MakeArgString("-offload-compress"));
+      if (Arg *A = TCArgs.getLastArg(options::OPT_offload_compression_level_EQ))
+        WrapperArgs.push_back(C.getArgs().MakeArgString(
+            Twine("-offload-compression-level=") + A->getValue()));
+    }
+
     StringRef Kind = Action::GetOffloadKindName(OffloadingKind);
     WrapperArgs.push_back(
         C.getArgs().MakeArgString(Twine("-kind=") + Twine(Kind)));
@@ -9830,9 +9842,44 @@ void SPIRVTranslator::ConstructJob(Compilation &C, const JobAction &JA,
   ArgStringList ForeachArgs;
   ArgStringList TranslatorArgs;
 
-  TranslatorArgs.push_back("-o");
-  TranslatorArgs.push_back(Output.getFilename());
-  if (JA.isDeviceOffloading(Action::OFK_SYCL)) {
+  // With -fsycl-use-spirv-backend-for-spirv-gen the SPIR-V module is emitted
+  // by the in-tree SPIR-V backend through llc, which reads the bitcode
+  // directly:
+  // llc -filetype=obj -mtriple=spirv64-unknown-unknown -o <file>.spv <file>.bc
+  bool UseSPIRVBackend =
+      JA.isDeviceOffloading(Action::OFK_SYCL) &&
+      TCArgs.hasFlag(options::OPT_fsycl_use_spirv_backend_for_spirv_gen,
+                     options::OPT_fno_sycl_use_spirv_backend_for_spirv_gen,
+                     false);
+
+  // A list of modules is translated by llvm-foreach running llvm-spirv for
+  // each of them, or by a single llvm-spirv process reading the list. Cached
+  // outputs are managed by llvm-foreach.
+  bool BatchTranslation =
+      !UseSPIRVBackend &&
+      TCArgs.hasFlag(options::OPT_fsycl_batch_spirv_translation,
+                     options::OPT_fno_sycl_batch_spirv_translation, false) &&
+      !TCArgs.hasArg(options::OPT_fsycl_device_code_cache_dir_EQ) &&
+      llvm::any_of(Inputs, [](const InputInfo &I) {
+        return I.getType() == types::TY_Tempfilelist;
+      });
+
+  if (!BatchTranslation) {
+    TranslatorArgs.push_back("-o");
+    TranslatorArgs.push_back(Output.getFilename());
+  }
+  if (UseSPIRVBackend) {
+    TranslatorArgs.push_back("-filetype=obj");
+    TranslatorArgs.push_back(getToolChain().getTriple().isArch32Bit()
+                                 ? "-mtriple=spirv32-unknown-unknown"
+                                 : "-mtriple=spirv64-unknown-unknown");
+    // Only extensions the backend knows how to emit can be enabled; anything
+    // the kernels need beyond these is reported by the backend.
+    TranslatorArgs.push_back(
+        "-spirv-extensions=SPV_INTEL_arbitrary_precision_integers");
+    TranslatorArgs.push_back(
+        "-spirv-extensions=SPV_KHR_no_integer_wrap_decoration");
+  } else if (JA.isDeviceOffloading(Action::OFK_SYCL)) {
     TranslatorArgs.push_back("-spirv-max-version=1.4");
     TranslatorArgs.push_back("-spirv-debug-info-version=ocl-100");
     // Prevent crash in the translator if input IR contains DIExpression
@@ -9908,6 +9955,21 @@ void SPIRVTranslator::ConstructJob(Compilation &C, const JobAction &JA,
   }
   for (auto I : Inputs) {
     std::string Filename(I.getFilename());
+    if (I.getType() == types::TY_Tempfilelist && BatchTranslation) {
+      TranslatorArgs.push_back(
+          C.getArgs().MakeArgString("--in-file-list=" + Filename));
+      TranslatorArgs.push_back(C.getArgs().MakeArgString(
+          "--out-file-list=" + StringRef(Output.getFilename())));
+      // The SPIR-V files are named after the modules from sycl-post-link, not
+      // after the output. Register the list like the other file lists, so
+      // that the files named in it are removed with it.
+      if (!C.getDriver().isSaveTempsEnabled() &&
+          llvm::none_of(C.getTempFiles(), [&](const auto &File) {
+            return StringRef(File.first) == Output.getFilename();
+          }))
+        C.addTempFile(Output.getFilename(), types::TY_Tempfilelist);
+      continue;
+    }
     if (I.getType() == types::TY_Tempfilelist) {
       ForeachArgs.push_back(
           C.getArgs().MakeArgString("--in-file-list=" + Filename));
@@ -9919,8 +9981,10 @@ void SPIRVTranslator::ConstructJob(Compilation &C, const JobAction &JA,
     TranslatorArgs.push_back(C.getArgs().MakeArgString(Filename));
   }
 
-  auto Cmd = std::make_unique<Command>(JA, *this, ResponseFileSupport::None(),
-      TCArgs.MakeArgString(getToolChain().GetProgramPath(getShortName())),
+  auto Cmd = std::make_unique<Command>(
+      JA, *this, ResponseFileSupport::None(),
+      TCArgs.MakeArgString(getToolChain().GetProgramPath(
+          UseSPIRVBackend ? "llc" : getShortName())),
       TranslatorArgs, std::nullopt);
 
   if (!ForeachArgs.empty()) {
@@ -9937,6 +10001,13 @@ void SPIRVTranslator::ConstructJob(Compilation &C, const JobAction &JA,
         TCArgs.getLastArgValue(options::OPT_fsycl_max_parallel_jobs_EQ);
     if (!ParallelJobs.empty())
       ForeachArgs.push_back(TCArgs.MakeArgString("--jobs=" + ParallelJobs));
+    StringRef CacheDir =
+        TCArgs.getLastArgValue(options::OPT_fsycl_device_code_cache_dir_EQ);
+    if (!CacheDir.empty()) {
+      ForeachArgs.push_back(TCArgs.MakeArgString("--cache-dir=" + CacheDir));
+      ForeachArgs.push_back(
+          TCArgs.MakeArgString("--cache-key=" + getClangFullVersion()));
+    }
 
     ForeachArgs.push_back(TCArgs.MakeArgString("--"));
     ForeachArgs.push_back(TCArgs.MakeArgString(Cmd->getExecutable()));
@@ -10012,7 +10083,17 @@ void SYCLPostLink::ConstructJob(Compilation &C, const JobAction &JA,
       addArgs(CmdArgs, TCArgs, {"-split=source"});
     else if (CodeSplitValue == "auto")
       addArgs(CmdArgs, TCArgs, {"-split=auto"});
-    else { // Device code split is off
+    else if (CodeSplitValue == "by_cost") {
+      addArgs(CmdArgs, TCArgs, {"-split=cost"});
+      if (Arg *A = TCArgs.getLastArg(
+              options::OPT_fsycl_device_code_split_size_budget_EQ))
+        CmdArgs.push_back(TCArgs.MakeArgString(Twine("-split-size-budget=") +
+                                               A->getValue()));
+      if (Arg *A =
+              TCArgs.getLastArg(options::OPT_fsycl_device_code_split_profile_EQ))
+        CmdArgs.push_back(
+            TCArgs.MakeArgString(Twine("-split-profile=") + A->getValue()));
+    } else { // Device code split is off
     }
   } else if (getToolChain().getTriple().getArchName() != "spir64_fpga") {
     // for FPGA targets, off is the default split mode,
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 #include "SYCL.h"
 #include "CommonArgs.h"
+#include "clang/Basic/Version.h"
 #include "clang/Driver/Action.h"
 #include "clang/Driver/Compilation.h"
 #include "clang/Driver/Driver.h"
@@ -65,7 +66,8 @@ void SYCL::constructLLVMForeachCommand(Compilation &C, const JobAction &JA,
                                        const InputInfoList &InputFiles,
                                        const InputInfo &Output, const Tool *T,
                                        StringRef Increment, StringRef Ext,
-                                       StringRef ParallelJobs) {
+                                       StringRef ParallelJobs,
+                                       StringRef CacheDir) {
   // Construct llvm-foreach command.
   // The llvm-foreach command looks like this:
   // llvm-foreach --in-file-list=a.list --in-replace='{}' -- echo '{}'
@@ -89,6 +91,11 @@ void SYCL::constructLLVMForeachCommand(Compilation &C, const JobAction &JA,
         C.getArgs().MakeArgString("--out-increment=" + Increment));
   if (!ParallelJobs.empty())
     ForeachArgs.push_back(C.getArgs().MakeArgString("--jobs=" + ParallelJobs));
+  if (!CacheDir.empty()) {
+    ForeachArgs.push_back(C.getArgs().MakeArgString("--cache-dir=" + CacheDir));
+    ForeachArgs.push_back(
+        C.getArgs().MakeArgString("--cache-key=" + getClangFullVersion()));
+  }
 
   if (C.getDriver().isSaveTempsEnabled()) {
     SmallString<128> OutputDirName;
@@ -643,8 +650,10 @@ void SYCL::gen::BackendCompiler::ConstructJob(Compilation &C,
   if (!ForeachInputs.empty()) {
     StringRef ParallelJobs =
         Args.getLastArgValue(options::OPT_fsycl_max_parallel_jobs_EQ);
+    StringRef CacheDir =
+        Args.getLastArgValue(options::OPT_fsycl_device_code_cache_dir_EQ);
     constructLLVMForeachCommand(C, JA, std::move(Cmd), ForeachInputs, Output,
-                                this, "", "out", ParallelJobs);
+                                this, "", "out", ParallelJobs, CacheDir);
   } else
     C.addCommand(std::move(Cmd));
 }
@@ -812,8 +821,10 @@ void SYCL::x86_64::BackendCompiler::ConstructJob(
   if (!ForeachInputs.empty()) {
     StringRef ParallelJobs =
         Args.getLastArgValue(options::OPT_fsycl_max_parallel_jobs_EQ);
+    StringRef CacheDir =
+        Args.getLastArgValue(options::OPT_fsycl_device_code_cache_dir_EQ);
     constructLLVMForeachCommand(C, JA, std::move(Cmd), ForeachInputs, Output,
-                                this, "", "out", ParallelJobs);
+                                this, "", "out", ParallelJobs, CacheDir);
   } else
     C.addCommand(std::move(Cmd));
 }
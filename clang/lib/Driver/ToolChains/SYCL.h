@@ -38,7 +38,8 @@ void constructLLVMForeachCommand(Compilation &C, const JobAction &JA,
                                  const InputInfoList &InputFiles,
                                  const InputInfo &Output, const Tool *T,
                                  StringRef Increment, StringRef Ext = "out",
-                                 StringRef ParallelJobs = "");
+                                 StringRef ParallelJobs = "",
+                                 StringRef CacheDir = "");
 bool shouldDoPerObjectFileLinking(const Compilation &C);
 // Runs llvm-spirv to convert spirv to bc, llvm-link, which links multiple LLVM
 // bitcode. Converts generated bc back to spirv using llvm-spirv, wraps with
@@ -4942,6 +4942,18 @@ IntrusiveRefCntPtr<llvm::vfs::FileSystem>
 clang::createVFSFromCompilerInvocation(
     const CompilerInvocation &CI, DiagnosticsEngine &Diags,
     IntrusiveRefCntPtr<llvm::vfs::FileSystem> BaseFS) {
+  if (CI.getHeaderSearchOpts().CacheVFSStatus) {
+    auto CachingFS =
+        llvm::makeIntrusiveRefCnt<llvm::vfs::StatCachingFileSystem>(BaseFS);
+    // Files written during the compilation must be seen by later lookups, and
+    // modules in the cache may be rebuilt and validated again.
+    for (StringRef Path : {StringRef(CI.getHeaderSearchOpts().ModuleCachePath),
+                           StringRef(CI.getFrontendOpts().OutputFile),
+                           StringRef(CI.getDependencyOutputOpts().OutputFile)})
+      if (!Path.empty() && Path != "-")
+        CachingFS->excludePath(Path);
+    BaseFS = std::move(CachingFS);
+  }
   return createVFSFromOverlayFiles(CI.getHeaderSearchOpts().VFSOverlayFiles,
                                    Diags, std::move(BaseFS));
 }
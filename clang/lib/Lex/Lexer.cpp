@@ -47,6 +47,13 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
 using namespace clang;
 
 //===----------------------------------------------------------------------===//
@@ -1847,19 +1854,48 @@ bool Lexer::LexUnicodeIdentifierStart(Token &Result, uint32_t C,
   return true;
 }
 
+/// Skips over the characters [_A-Za-z0-9] starting at \p CurPtr and returns a
+/// pointer to the first other character.
+static const char *
+fastParseASCIIIdentifier(const char *CurPtr,
+                         [[maybe_unused]] const char *BufferEnd) {
+#ifdef __SSE4_2__
+  alignas(16) static constexpr char AsciiIdentifierRange[16] = {
+      '_', '_', 'A', 'Z', 'a', 'z', '0', '9',
+  };
+  constexpr ptrdiff_t BytesPerRegister = 16;
+
+  __m128i AsciiIdentifierRangeV =
+      _mm_load_si128((const __m128i *)AsciiIdentifierRange);
+
+  while (LLVM_LIKELY(BufferEnd - CurPtr >= BytesPerRegister)) {
+    __m128i Cv = _mm_loadu_si128((const __m128i *)CurPtr);
+
+    // The index of the first character outside of the ranges, or 16.
+    int Consumed = _mm_cmpistri(AsciiIdentifierRangeV, Cv,
+                                _SIDD_LEAST_SIGNIFICANT | _SIDD_CMP_RANGES |
+                                    _SIDD_UBYTE_OPS | _SIDD_NEGATIVE_POLARITY);
+    CurPtr += Consumed;
+    if (Consumed != BytesPerRegister)
+      return CurPtr;
+  }
+#endif
+
+  unsigned char C = *CurPtr;
+  while (isAsciiIdentifierContinue(C))
+    C = *++CurPtr;
+  return CurPtr;
+}
+
 bool Lexer::LexIdentifierContinue(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched an identifier start.
   while (true) {
-    unsigned char C = *CurPtr;
     // Fast path.
-    if (isAsciiIdentifierContinue(C)) {
-      ++CurPtr;
-      continue;
-    }
+    CurPtr = fastParseASCIIIdentifier(CurPtr, BufferEnd);
 
     unsigned Size;
     // Slow path: handle trigraph, unicode codepoints, UCNs.
-    C = getCharAndSize(CurPtr, Size);
+    unsigned char C = getCharAndSize(CurPtr, Size);
     if (isAsciiIdentifierContinue(C)) {
       CurPtr = ConsumeChar(CurPtr, Size, Result);
       continue;
@@ -2489,6 +2525,29 @@ bool Lexer::SkipLineComment(Token &Result, const char *CurPtr,
 
   char C;
   while (true) {
+#ifdef __SSE2__
+    // Skip over runs of 16 plain ASCII characters at once.
+    while (BufferEnd - CurPtr >= 16) {
+      __m128i Chars = _mm_loadu_si128((const __m128i *)CurPtr);
+      __m128i Newlines =
+          _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8('\n')),
+                       _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\r')));
+      __m128i Nuls = _mm_cmpeq_epi8(Chars, _mm_setzero_si128());
+      // The sign bit is set for the non-ASCII characters and the matches.
+      int Mask = _mm_movemask_epi8(
+          _mm_or_si128(Chars, _mm_or_si128(Newlines, Nuls)));
+      if (Mask != 0) {
+        unsigned Skipped = llvm::countr_zero<unsigned>(Mask);
+        if (Skipped != 0)
+          UnicodeDecodingAlreadyDiagnosed = false;
+        CurPtr += Skipped;
+        break;
+      }
+      CurPtr += 16;
+      UnicodeDecodingAlreadyDiagnosed = false;
+    }
+#endif
+
     C = *CurPtr;
     // Skip over characters in the fast loop.
     while (isASCII(C) && C != 0 &&   // Potentially EOF.
@@ -2727,9 +2786,7 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr, Lexer *L,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
+#if !defined(__SSE2__) && __ALTIVEC__
 #include <altivec.h>
 #undef bool
 #endif
@@ -7451,13 +7451,28 @@ void ASTReader::CompleteRedeclChain(const Decl *D) {
     }
   }
 
-  if (auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(D))
-    CTSD->getSpecializedTemplate()->LoadLazySpecializations();
-  if (auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(D))
-    VTSD->getSpecializedTemplate()->LoadLazySpecializations();
+  // Other declarations of a specialization have the same template arguments,
+  // only the specializations which might have them need to be loaded.
+  if (auto *CTSD = dyn_cast<ClassTemplateSpecializationDecl>(D)) {
+    if (isa<ClassTemplatePartialSpecializationDecl>(CTSD))
+      CTSD->getSpecializedTemplate()->LoadLazySpecializations(
+          /*OnlyPartial=*/true);
+    else
+      CTSD->getSpecializedTemplate()->LoadLazySpecializations(
+          CTSD->getTemplateArgs().asArray());
+  }
+  if (auto *VTSD = dyn_cast<VarTemplateSpecializationDecl>(D)) {
+    if (isa<VarTemplatePartialSpecializationDecl>(VTSD))
+      VTSD->getSpecializedTemplate()->LoadLazySpecializations(
+          /*OnlyPartial=*/true);
+    else
+      VTSD->getSpecializedTemplate()->LoadLazySpecializations(
+          VTSD->getTemplateArgs().asArray());
+  }
   if (auto *FD = dyn_cast<FunctionDecl>(D)) {
     if (auto *Template = FD->getPrimaryTemplate())
-      Template->LoadLazySpecializations();
+      Template->LoadLazySpecializations(
+          FD->getTemplateSpecializationArgs()->asArray());
   }
 }
 
@@ -88,6 +88,8 @@ namespace clang {
     const SourceLocation ThisDeclLoc;
 
     using RecordData = ASTReader::RecordData;
+    using LazySpecializationInfo =
+        RedeclarableTemplateDecl::LazySpecializationInfo;
 
     TypeID DeferredTypeID = 0;
     unsigned AnonymousDeclNumber = 0;
@@ -139,6 +141,20 @@ namespace clang {
         IDs.push_back(readDeclID());
     }
 
+    void readLazySpecializations(
+        SmallVectorImpl<LazySpecializationInfo> &Specs) {
+      for (unsigned I = 0, Size = Record.readInt(); I != Size; ++I)
+        Specs.push_back(readLazySpecialization());
+    }
+
+    LazySpecializationInfo readLazySpecialization() {
+      LazySpecializationInfo Info;
+      Info.DeclID = readDeclID();
+      Info.ArgsHash = Record.readInt();
+      Info.IsPartial = Record.readInt();
+      return Info;
+    }
+
     Decl *readDecl() {
       return Record.readDecl();
     }
@@ -265,10 +281,11 @@ namespace clang {
         : Reader(Reader), Record(Record), Loc(Loc), ThisDeclID(thisDeclID),
           ThisDeclLoc(ThisDeclLoc) {}
 
-    template <typename T> static
-    void AddLazySpecializations(T *D,
-                                SmallVectorImpl<serialization::DeclID>& IDs) {
-      if (IDs.empty())
+    template <typename T>
+    static void
+    AddLazySpecializations(T *D,
+                           SmallVectorImpl<LazySpecializationInfo> &Specs) {
+      if (Specs.empty())
         return;
 
       // FIXME: We should avoid this pattern of getting the ASTContext.
@@ -277,14 +294,26 @@ namespace clang {
       auto *&LazySpecializations = D->getCommonPtr()->LazySpecializations;
 
       if (auto &Old = LazySpecializations) {
-        IDs.insert(IDs.end(), Old + 1, Old + 1 + Old[0]);
-        llvm::sort(IDs);
-        IDs.erase(std::unique(IDs.begin(), IDs.end()), IDs.end());
+        // Drop the specializations which were loaded already.
+        for (const LazySpecializationInfo &Info :
+             llvm::ArrayRef(Old + 1, Old[0].DeclID))
+          if (Info.DeclID)
+            Specs.push_back(Info);
+        llvm::sort(Specs, [](const LazySpecializationInfo &LHS,
+                             const LazySpecializationInfo &RHS) {
+          return LHS.DeclID < RHS.DeclID;
+        });
+        Specs.erase(std::unique(Specs.begin(), Specs.end(),
+                                [](const LazySpecializationInfo &LHS,
+                                   const LazySpecializationInfo &RHS) {
+                                  return LHS.DeclID == RHS.DeclID;
+                                }),
+                    Specs.end());
       }
 
-      auto *Result = new (C) serialization::DeclID[1 + IDs.size()];
-      *Result = IDs.size();
-      std::copy(IDs.begin(), IDs.end(), Result + 1);
+      auto *Result = new (C) LazySpecializationInfo[1 + Specs.size()];
+      Result[0].DeclID = Specs.size();
+      std::copy(Specs.begin(), Specs.end(), Result + 1);
 
       LazySpecializations = Result;
     }
@@ -320,7 +349,7 @@ namespace clang {
     void ReadFunctionDefinition(FunctionDecl *FD);
     void Visit(Decl *D);
 
-    void UpdateDecl(Decl *D, SmallVectorImpl<serialization::DeclID> &);
+    void UpdateDecl(Decl *D, SmallVectorImpl<LazySpecializationInfo> &);
 
     static void setNextObjCCategory(ObjCCategoryDecl *Cat,
                                     ObjCCategoryDecl *Next) {
@@ -2396,9 +2425,9 @@ void ASTDeclReader::VisitClassTemplateDecl(ClassTemplateDecl *D) {
   if (ThisDeclID == Redecl.getFirstID()) {
     // This ClassTemplateDecl owns a CommonPtr; read it to keep track of all of
     // the specializations.
-    SmallVector<serialization::DeclID, 32> SpecIDs;
-    readDeclIDList(SpecIDs);
-    ASTDeclReader::AddLazySpecializations(D, SpecIDs);
+    SmallVector<LazySpecializationInfo, 32> Specs;
+    readLazySpecializations(Specs);
+    ASTDeclReader::AddLazySpecializations(D, Specs);
   }
 
   if (D->getTemplatedDecl()->TemplateOrInstantiation) {
@@ -2424,9 +2453,9 @@ void ASTDeclReader::VisitVarTemplateDecl(VarTemplateDecl *D) {
   if (ThisDeclID == Redecl.getFirstID()) {
     // This VarTemplateDecl owns a CommonPtr; read it to keep track of all of
     // the specializations.
-    SmallVector<serialization::DeclID, 32> SpecIDs;
-    readDeclIDList(SpecIDs);
-    ASTDeclReader::AddLazySpecializations(D, SpecIDs);
+    SmallVector<LazySpecializationInfo, 32> Specs;
+    readLazySpecializations(Specs);
+    ASTDeclReader::AddLazySpecializations(D, Specs);
   }
 }
 
@@ -2534,9 +2563,9 @@ void ASTDeclReader::VisitFunctionTemplateDecl(FunctionTemplateDecl *D) {
 
   if (ThisDeclID == Redecl.getFirstID()) {
     // This FunctionTemplateDecl owns a CommonPtr; read it.
-    SmallVector<serialization::DeclID, 32> SpecIDs;
-    readDeclIDList(SpecIDs);
-    ASTDeclReader::AddLazySpecializations(D, SpecIDs);
+    SmallVector<LazySpecializationInfo, 32> Specs;
+    readLazySpecializations(Specs);
+    ASTDeclReader::AddLazySpecializations(D, Specs);
   }
 }
 
@@ -4143,7 +4172,8 @@ void ASTReader::loadDeclUpdateRecords(PendingUpdateRecord &Record) {
   ProcessingUpdatesRAIIObj ProcessingUpdates(*this);
   DeclUpdateOffsetsMap::iterator UpdI = DeclUpdateOffsets.find(ID);
 
-  SmallVector<serialization::DeclID, 8> PendingLazySpecializationIDs;
+  SmallVector<RedeclarableTemplateDecl::LazySpecializationInfo, 8>
+      PendingLazySpecializationIDs;
 
   if (UpdI != DeclUpdateOffsets.end()) {
     auto UpdateOffsets = std::move(UpdI->second);
@@ -4412,8 +4442,9 @@ static void forAllLaterRedecls(DeclT *D, Fn F) {
   }
 }
 
-void ASTDeclReader::UpdateDecl(Decl *D,
-   llvm::SmallVectorImpl<serialization::DeclID> &PendingLazySpecializationIDs) {
+void ASTDeclReader::UpdateDecl(
+    Decl *D,
+    SmallVectorImpl<LazySpecializationInfo> &PendingLazySpecializationIDs) {
   while (Record.getIdx() < Record.size()) {
     switch ((DeclUpdateKind)Record.readInt()) {
     case UPD_CXX_ADDED_IMPLICIT_MEMBER: {
@@ -4426,7 +4457,7 @@ void ASTDeclReader::UpdateDecl(Decl *D,
 
     case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION:
       // It will be added to the template's lazy specialization set.
-      PendingLazySpecializationIDs.push_back(readDeclID());
+      PendingLazySpecializationIDs.push_back(readLazySpecialization());
       break;
 
     case UPD_CXX_ADDED_ANONYMOUS_NAMESPACE: {
@@ -5278,12 +5278,16 @@ void ASTWriter::WriteDeclUpdatesBlocks(RecordDataImpl &OffsetsRecord) {
 
       switch (Kind) {
       case UPD_CXX_ADDED_IMPLICIT_MEMBER:
-      case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION:
       case UPD_CXX_ADDED_ANONYMOUS_NAMESPACE:
         assert(Update.getDecl() && "no decl to add?");
         Record.push_back(GetDeclRef(Update.getDecl()));
         break;
 
+      case UPD_CXX_ADDED_TEMPLATE_SPECIALIZATION:
+        assert(Update.getDecl() && "no decl to add?");
+        Record.AddLazySpecializationRef(Update.getDecl());
+        break;
+
       case UPD_CXX_ADDED_FUNCTION_DEFINITION:
       case UPD_CXX_ADDED_VAR_DEFINITION:
         break;
@@ -5582,6 +5586,16 @@ void ASTRecordWriter::AddCXXTemporary(const CXXTemporary *Temp) {
   AddDeclRef(Temp->getDestructor());
 }
 
+void ASTRecordWriter::AddLazySpecializationRef(const Decl *D) {
+  AddDeclRef(D);
+  // The canonical declaration is the one which is known to have its template
+  // arguments.
+  const Decl *Spec = D->getCanonicalDecl();
+  push_back(RedeclarableTemplateDecl::getSpecializationArgsHash(Spec));
+  push_back(isa<ClassTemplatePartialSpecializationDecl,
+                VarTemplatePartialSpecializationDecl>(Spec));
+}
+
 void ASTRecordWriter::AddTemplateArgumentLocInfo(
     TemplateArgument::ArgKind Kind, const TemplateArgumentLocInfo &Arg) {
   switch (Kind) {
@@ -180,7 +180,12 @@ namespace clang {
     /// Add to the record the first declaration from each module file that
     /// provides a declaration of D. The intent is to provide a sufficient
     /// set such that reloading this set will load all current redeclarations.
-    void AddFirstDeclFromEachModule(const Decl *D, bool IncludeLocal) {
+    ///
+    /// If \p IsSpecialization is true, D is a template specialization and the
+    /// declarations are written with AddLazySpecializationRef().
+    /// Returns the number of declarations written.
+    unsigned AddFirstDeclFromEachModule(const Decl *D, bool IncludeLocal,
+                                        bool IsSpecialization = false) {
       llvm::MapVector<ModuleFile*, const Decl*> Firsts;
       // FIXME: We can skip entries that we know are implied by others.
       for (const Decl *R = D->getMostRecentDecl(); R; R = R->getPreviousDecl()) {
@@ -189,8 +194,13 @@ namespace clang {
         else if (IncludeLocal)
           Firsts[nullptr] = R;
       }
-      for (const auto &F : Firsts)
-        Record.AddDeclRef(F.second);
+      for (const auto &F : Firsts) {
+        if (IsSpecialization)
+          Record.AddLazySpecializationRef(F.second);
+        else
+          Record.AddDeclRef(F.second);
+      }
+      return Firsts.size();
     }
 
     /// Get the specialization decl from an entry in the specialization list.
@@ -222,13 +232,15 @@ namespace clang {
         assert(!Common->LazySpecializations);
       }
 
-      ArrayRef<DeclID> LazySpecializations;
+      ArrayRef<RedeclarableTemplateDecl::LazySpecializationInfo>
+          LazySpecializations;
       if (auto *LS = Common->LazySpecializations)
-        LazySpecializations = llvm::ArrayRef(LS + 1, LS[0]);
+        LazySpecializations = llvm::ArrayRef(LS + 1, LS[0].DeclID);
 
       // Add a slot to the record for the number of specializations.
       unsigned I = Record.size();
       Record.push_back(0);
+      unsigned NumSpecs = 0;
 
       // AddFirstDeclFromEachModule might trigger deserialization, invalidating
       // *Specializations iterators.
@@ -240,12 +252,21 @@ namespace clang {
 
       for (auto *D : Specs) {
         assert(D->isCanonicalDecl() && "non-canonical decl in set");
-        AddFirstDeclFromEachModule(D, /*IncludeLocal*/true);
+        NumSpecs += AddFirstDeclFromEachModule(D, /*IncludeLocal*/ true,
+                                               /*IsSpecialization*/ true);
+      }
+      // Loaded specializations are in the sets above already.
+      for (const auto &Info : LazySpecializations) {
+        if (!Info.DeclID)
+          continue;
+        Record.push_back(Info.DeclID);
+        Record.push_back(Info.ArgsHash);
+        Record.push_back(Info.IsPartial);
+        ++NumSpecs;
       }
-      Record.append(LazySpecializations.begin(), LazySpecializations.end());
 
       // Update the size entry we added earlier.
-      Record[I] = Record.size() - I - 1;
+      Record[I] = NumSpecs;
     }
 
     /// Ensure that this template specialization is associated with the specified
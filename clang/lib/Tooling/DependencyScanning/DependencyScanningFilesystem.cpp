@@ -106,6 +106,43 @@ DependencyScanningFilesystemSharedCache::getShardForUID(
   return CacheShards[Hash % NumShards];
 }
 
+std::vector<StringRef>
+DependencyScanningFilesystemSharedCache::getOutOfDateEntries(
+    llvm::vfs::FileSystem &UnderlyingFS) const {
+  std::vector<StringRef> OutOfDate;
+  for (unsigned I = 0; I < NumShards; ++I) {
+    const CacheShard &Shard = CacheShards[I];
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    for (const auto &Entry : Shard.EntriesByFilename) {
+      StringRef Filename = Entry.getKey();
+      const CachedFileSystemEntry *Cached = Entry.getValue();
+      llvm::ErrorOr<llvm::vfs::Status> Stat = UnderlyingFS.status(Filename);
+      if (Cached->isError()) {
+        // Only negative stats are cached as errors, see
+        // shouldCacheStatFailures().
+        if (Stat)
+          OutOfDate.push_back(Filename);
+        continue;
+      }
+      if (!Stat || Stat->getUniqueID() != Cached->getUniqueID() ||
+          Stat->isDirectory() != Cached->isDirectory()) {
+        OutOfDate.push_back(Filename);
+        continue;
+      }
+      // The modification time of a directory changes when its entries do,
+      // which doesn't affect what was cached for the directory itself.
+      if (Cached->isDirectory())
+        continue;
+      llvm::vfs::Status CachedStat = Cached->getStatus();
+      if (Stat->getSize() != CachedStat.getSize() ||
+          Stat->getLastModificationTime() !=
+              CachedStat.getLastModificationTime())
+        OutOfDate.push_back(Filename);
+    }
+  }
+  return OutOfDate;
+}
+
 const CachedFileSystemEntry *
 DependencyScanningFilesystemSharedCache::CacheShard::findEntryByFilename(
     StringRef Filename) const {
@@ -0,0 +1,30 @@
+// Check that the jobs of a compilation can run in parallel with
+// -parallel-jobs= and that the option value is checked.
+
+// RUN: %clang -parallel-jobs=2 -fsyntax-only %s %s %s 2>&1 \
+// RUN:   | FileCheck -allow-empty -check-prefix=PARALLEL %s
+// PARALLEL-NOT: error
+
+// With -save-temps every job reads the file written by the previous one, so
+// they still have to run one after another.
+// REQUIRES: x86-registered-target
+// RUN: rm -rf %t && mkdir %t
+// RUN: %clang --target=x86_64-unknown-linux-gnu -parallel-jobs=4 -v \
+// RUN:   -save-temps=obj -c %s -o %t/parallel-jobs.o 2>&1 \
+// RUN:   | FileCheck -check-prefix=CHAIN %s
+// RUN: test -f %t/parallel-jobs.o
+// CHAIN: "-cc1" {{.*}}"-E"{{.*}} "-o" "{{.*}}parallel-jobs.i"
+// CHAIN: "-cc1" {{.*}}"-emit-llvm-bc"{{.*}} "-o" "{{.*}}parallel-jobs.bc"
+// CHAIN-SAME: "{{.*}}parallel-jobs.i"
+// CHAIN: "-cc1" {{.*}}"-S"{{.*}} "-o" "{{.*}}parallel-jobs.s"
+// CHAIN-SAME: "{{.*}}parallel-jobs.bc"
+// CHAIN: "-cc1as" {{.*}}"-o" "{{.*}}parallel-jobs.o" "{{.*}}parallel-jobs.s"
+
+// RUN: not %clang -parallel-jobs=0 -fsyntax-only %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=INVALID %s
+// RUN: not %clang -parallel-jobs=x -fsyntax-only %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=INVALID-X %s
+// INVALID: error: invalid integral value '0' in '-parallel-jobs=0'
+// INVALID-X: error: invalid integral value 'x' in '-parallel-jobs=x'
+
+int main(void) { return 0; }
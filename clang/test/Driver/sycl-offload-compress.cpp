@@ -0,0 +1,17 @@
+/// Check that device image compression options are passed to the offload
+/// wrapper.
+// RUN: %clangxx -fsycl --offload-compress %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix COMPRESS %s
+// COMPRESS: clang-offload-wrapper{{.*}} "-offload-compress"
+// COMPRESS-NOT: "-offload-compression-level
+
+// RUN: %clangxx -fsycl --offload-compress --offload-compression-level=19 %s \
+// RUN:   -### 2>&1 | FileCheck -check-prefix COMPRESS_LEVEL %s
+// COMPRESS_LEVEL: clang-offload-wrapper{{.*}} "-offload-compress" "-offload-compression-level=19"
+
+// RUN: %clangxx -fsycl --offload-compress --no-offload-compress %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix NO_COMPRESS %s
+// RUN: %clangxx -fsycl --offload-compression-level=19 %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix NO_COMPRESS %s
+// NO_COMPRESS-NOT: "-offload-compress"
+// NO_COMPRESS-NOT: "-offload-compression-level
@@ -33,6 +33,17 @@
 // CHK-ACTIONS-WIN-NOT: "-mllvm -sycl-opt"
 // CHK-ACTIONS-WIN: clang-offload-wrapper"{{.*}} "-host=x86_64-pc-windows-msvc" "-target=nvptx64" "-kind=sycl"{{.*}}
 
+/// Check that ptxas and fatbinary outputs are cached, the PTX generation
+/// isn't since it links in bitcode libraries besides the iterated input.
+// RUN: %clangxx -### -std=c++11 -target x86_64-unknown-linux-gnu -fsycl \
+// RUN: -fsycl-targets=nvptx64-nvidia-cuda --cuda-path=%S/Inputs/CUDA/usr/local/cuda \
+// RUN: -fsycl-libspirv-path=%S/Inputs/SYCL/libspirv.bc \
+// RUN: -fsycl-device-code-cache-dir=cache %s 2>&1 \
+// RUN: | FileCheck -check-prefix=CHK-CACHE %s
+// CHK-CACHE-NOT: llvm-foreach"{{.*}} "--cache-dir=cache" "--cache-key={{[^"]+}}" "--" "{{.*}}clang-{{[0-9]+}}"
+// CHK-CACHE: llvm-foreach"{{.*}} "--cache-dir=cache" "--cache-key={{[^"]+}}" "--" "{{.*}}ptxas"
+// CHK-CACHE: llvm-foreach"{{.*}} "--cache-dir=cache" "--cache-key={{[^"]+}}" "--" "{{.*}}fatbinary"
+
 /// Check phases w/out specifying a compute capability.
 // RUN: %clangxx -ccc-print-phases --sysroot=%S/Inputs/SYCL -std=c++11 \
 // RUN: -target x86_64-unknown-linux-gnu -fsycl \
@@ -237,6 +237,38 @@
 
 /// ###########################################################################
 
+/// Check caching of SPIR-V translation and AOT compilation outputs
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-device-code-cache-dir=cache -fsycl-targets=spir64-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-CACHE
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-device-code-cache-dir=cache -fsycl-targets=spir64_gen-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-CACHE,CHK-CACHE-AOT -DBE_COMPILER=ocloc
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-device-code-cache-dir=cache -fsycl-targets=spir64_x86_64-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-CACHE,CHK-CACHE-AOT -DBE_COMPILER=opencl-aot
+// CHK-CACHE: llvm-foreach{{.*}} "--cache-dir=cache" "--cache-key={{[^"]+}}" "--" "{{.*}}llvm-spirv{{.*}}"
+// CHK-CACHE-AOT: llvm-foreach{{.*}} "--cache-dir=cache" "--cache-key={{[^"]+}}" "--" "{{.*}}[[BE_COMPILER]]{{.*}}
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-targets=spir64-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-NO-CACHE
+// CHK-NO-CACHE-NOT: "--cache-dir
+
+/// ###########################################################################
+
+/// Check translation of all split modules by a single llvm-spirv process
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-batch-spirv-translation -fsycl-targets=spir64-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-BATCH
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-batch-spirv-translation -fsycl-targets=spir64_gen-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-BATCH
+// CHK-BATCH-NOT: llvm-foreach{{.*}}llvm-spirv
+// CHK-BATCH: file-table-tform{{.*}} "-extract=Code" "-drop_titles" "-o" "[[LIST:.+\.txt]]"
+// CHK-BATCH-NOT: llvm-foreach{{.*}}llvm-spirv
+// CHK-BATCH: llvm-spirv{{.*}} "--in-file-list=[[LIST]]" "--out-file-list={{.+\.txt}}"
+// CHK-BATCH-NOT: llvm-foreach{{.*}}llvm-spirv
+// RUN: %clang -target x86_64-unknown-linux-gnu -fsycl -fsycl-batch-spirv-translation -fsycl-device-code-cache-dir=cache -fsycl-targets=spir64-unknown-unknown %s -### 2>&1 \
+// RUN:  | FileCheck %s -check-prefixes=CHK-BATCH-CACHE
+// CHK-BATCH-CACHE: llvm-foreach{{.*}} "--cache-dir=cache" "--cache-key={{[^"]+}}" "--" "{{.*}}llvm-spirv{{.*}}"
+// CHK-BATCH-CACHE-NOT: "--in-file-list=
+
+/// ###########################################################################
+
 /// offload with multiple targets, including AOT
 // RUN:  %clang -target x86_64-unknown-linux-gnu -fsycl -fno-sycl-instrument-device-code -fno-sycl-device-lib=all -fsycl-device-code-split -fsycl-targets=spir64-unknown-unknown,spir64_fpga-unknown-unknown,spir64_gen-unknown-unknown -ccc-print-phases %s 2>&1 \
 // RUN:   | FileCheck -check-prefix=CHK-PHASE-MULTI-TARG %s
@@ -306,6 +338,17 @@
 // RUN:   %clang_cl -### -fsycl %s 2>&1 | FileCheck %s -check-prefixes=CHK-AUTO
 // CHK-AUTO: sycl-post-link{{.*}} "-split=auto"{{.*}} "-o"{{.*}}
 
+// Check the cost based device code split mode.
+// RUN:   %clang -### -fsycl -fsycl-device-code-split=by_cost %s 2>&1 \
+// RUN:    | FileCheck %s -check-prefixes=CHK-BY-COST
+// CHK-BY-COST: sycl-post-link{{.*}} "-split=cost"{{.*}} "-o"{{.*}}
+// CHK-BY-COST-NOT: "-split-size-budget
+// RUN:   %clang -### -fsycl -fsycl-device-code-split=by_cost \
+// RUN:     -fsycl-device-code-split-size-budget=5000 \
+// RUN:     -fsycl-device-code-split-profile=kernels.txt %s 2>&1 \
+// RUN:    | FileCheck %s -check-prefixes=CHK-BY-COST-OPTS
+// CHK-BY-COST-OPTS: sycl-post-link{{.*}} "-split=cost" "-split-size-budget=5000" "-split-profile=kernels.txt"
+
 // Check no device code split mode.
 // RUN:   %clang -### -fsycl -fsycl-device-code-split -fsycl-device-code-split=off %s 2>&1 \
 // RUN:    | FileCheck %s -check-prefixes=CHK-NO-SPLIT
@@ -0,0 +1,20 @@
+///
+/// Tests for -fsycl-use-spirv-backend-for-spirv-gen
+///
+
+// RUN: %clangxx -fsycl -fsycl-use-spirv-backend-for-spirv-gen -### %s 2>&1 | \
+// RUN:  FileCheck %s -check-prefix CHECK-BACKEND --implicit-check-not llvm-spirv
+// CHECK-BACKEND: llc{{.*}} "-filetype=obj" "-mtriple=spirv64-unknown-unknown"
+// CHECK-BACKEND-SAME: "-spirv-extensions=SPV_INTEL_arbitrary_precision_integers"
+// CHECK-BACKEND-SAME: "-spirv-extensions=SPV_KHR_no_integer_wrap_decoration"
+
+/// Split modules are still handed to llc one at a time by llvm-foreach, also
+/// when batch translation is requested.
+// RUN: %clangxx -fsycl -fsycl-use-spirv-backend-for-spirv-gen -fsycl-batch-spirv-translation \
+// RUN:  -fsycl-device-code-split=per_kernel -### %s 2>&1 | \
+// RUN:  FileCheck %s -check-prefix CHECK-FOREACH
+// CHECK-FOREACH: llvm-foreach{{.*}} "--out-ext=spv"{{.*}} "--" "{{.*}}llc{{.*}}" "-filetype=obj"
+
+// RUN: %clangxx -fsycl -fsycl-use-spirv-backend-for-spirv-gen -fno-sycl-use-spirv-backend-for-spirv-gen -### %s 2>&1 | \
+// RUN:  FileCheck %s -check-prefix CHECK-TRANSLATOR
+// CHECK-TRANSLATOR: llvm-spirv{{.*}} "-spirv-max-version=1.4"
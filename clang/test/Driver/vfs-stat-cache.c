@@ -0,0 +1,10 @@
+// RUN: %clang -### -fvfs-stat-cache %s 2>&1 | FileCheck %s
+// RUN: %clang -### -fno-vfs-stat-cache -fvfs-stat-cache %s 2>&1 \
+// RUN:   | FileCheck %s
+// CHECK: "-cc1"
+// CHECK-SAME: "-fvfs-stat-cache"
+
+// RUN: %clang -### %s 2>&1 | FileCheck %s --check-prefix=NO-CACHE
+// RUN: %clang -### -fvfs-stat-cache -fno-vfs-stat-cache %s 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=NO-CACHE
+// NO-CACHE-NOT: "-fvfs-stat-cache"
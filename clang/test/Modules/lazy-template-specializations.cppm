@@ -0,0 +1,65 @@
+// Check that specializations of templates from modules are found when they
+// are loaded on demand by their template arguments.
+//
+// RUN: rm -rf %t
+// RUN: mkdir %t
+// RUN: split-file %s %t
+//
+// RUN: %clang_cc1 -std=c++20 -emit-module-interface %t/A.cppm -o %t/A.pcm
+// RUN: %clang_cc1 -std=c++20 -emit-module-interface -fprebuilt-module-path=%t %t/B.cppm -o %t/B.pcm
+// RUN: %clang_cc1 -std=c++20 -fprebuilt-module-path=%t %t/Use.cpp -fsyntax-only -verify
+
+//--- A.cppm
+export module A;
+
+export namespace ns1 { struct S {}; }
+export namespace ns2 { struct S {}; }
+
+export template <typename T> struct Cls { static constexpr int Value = 0; };
+export template <> struct Cls<int> { static constexpr int Value = 1; };
+export template <> struct Cls<ns1::S> { static constexpr int Value = 2; };
+export template <typename T> struct Cls<T *> { static constexpr int Value = 3; };
+export template <> struct Cls<const int *> { static constexpr int Value = 4; };
+
+export template <typename T> constexpr int Var = 0;
+export template <> constexpr int Var<long> = 1;
+export template <typename T> constexpr int Var<T &> = 2;
+
+export template <typename T> constexpr int fn() { return 0; }
+export template <> constexpr int fn<char>() { return 1; }
+
+export template <int N> struct Int { static constexpr int Value = N; };
+export template <> struct Int<-1> { static constexpr int Value = 42; };
+
+//--- B.cppm
+export module B;
+import A;
+
+// Specializations of templates from A are recorded as updates of A.
+export template <> struct Cls<ns2::S> { static constexpr int Value = 5; };
+export constexpr int UseInB = Cls<double>::Value + Var<char> + fn<int>();
+
+//--- Use.cpp
+// expected-no-diagnostics
+import A;
+import B;
+
+static_assert(Cls<int>::Value == 1);
+static_assert(Cls<ns1::S>::Value == 2);
+static_assert(Cls<ns2::S>::Value == 5);
+static_assert(Cls<long *>::Value == 3);
+static_assert(Cls<const int *>::Value == 4);
+static_assert(Cls<double>::Value == 0);
+static_assert(Cls<unsigned>::Value == 0);
+
+static_assert(Var<long> == 1);
+static_assert(Var<int &> == 2);
+static_assert(Var<char> == 0);
+
+static_assert(fn<char>() == 1);
+static_assert(fn<int>() == 0);
+
+static_assert(Int<-1>::Value == 42);
+static_assert(Int<1>::Value == 1);
+
+static_assert(UseInB == 0);
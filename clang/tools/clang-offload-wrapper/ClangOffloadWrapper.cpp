@@ -38,6 +38,7 @@
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/SYCLLowerIR/SYCLUtils.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
@@ -137,8 +138,11 @@ enum BinaryImageFormat {
   none,   // image kind is not determined
   native, // image kind is native
   // portable image kinds go next
-  spirv, // SPIR-V
-  llvmbc // LLVM bitcode
+  spirv,  // SPIR-V
+  llvmbc, // LLVM bitcode
+  // set by the tool for images it compressed, the runtime determines the
+  // actual kind after decompression
+  compressed_none
 };
 
 /// Sets offload kind.
@@ -219,6 +223,23 @@ static cl::opt<bool> BatchMode(
              "a_1.bin|||"),
     cl::cat(ClangOffloadWrapperCategory));
 
+/// Compression of SYCL device images.
+static cl::opt<bool> OffloadCompressDevImgs(
+    "offload-compress", cl::init(false), cl::Optional,
+    cl::desc("Compress SYCL device images with zstd, the runtime decompresses\n"
+             "an image when a kernel from it is first needed"),
+    cl::cat(ClangOffloadWrapperCategory));
+
+static cl::opt<int> OffloadCompressLevel(
+    "offload-compression-level", cl::init(10), cl::Optional,
+    cl::desc("zstd compression level used with -offload-compress"),
+    cl::cat(ClangOffloadWrapperCategory));
+
+static cl::opt<unsigned> OffloadCompressThreshold(
+    "offload-compression-threshold", cl::init(512), cl::Optional,
+    cl::desc("Images smaller than this number of bytes are not compressed"),
+    cl::cat(ClangOffloadWrapperCategory));
+
 static StringRef offloadKindToString(OffloadKind Kind) {
   switch (Kind) {
   case OffloadKind::Unknown:
@@ -247,6 +268,8 @@ static StringRef formatToString(BinaryImageFormat Fmt) {
     return "llvmbc";
   case BinaryImageFormat::native:
     return "native";
+  case BinaryImageFormat::compressed_none:
+    return "compressed_none";
   }
   llvm_unreachable("bad format");
 
@@ -337,6 +360,7 @@ public:
   }
 
   std::string ToolName;
+  bool ZstdWarningEmitted = false;
   std::string ObjcopyPath;
   // Temporary file names that may be created during adding notes
   // to ELF offload images. Use -save-temps to keep them and also
@@ -993,7 +1017,7 @@ private:
       auto *Fver =
           ConstantInt::get(Type::getInt16Ty(C), DeviceImageStructVersion);
       auto *Fknd = ConstantInt::get(Type::getInt8Ty(C), Kind);
-      auto *Ffmt = ConstantInt::get(Type::getInt8Ty(C), Img.Fmt);
+      BinaryImageFormat Fmt = Img.Fmt;
       auto *Ftgt = addStringToModule(
           Img.Tgt, Twine(OffloadKindTag) + Twine("target.") + Twine(ImgId));
       auto *Foptcompile = addStringToModule(
@@ -1034,6 +1058,34 @@ private:
         // Adding ELF notes for STDIN is not supported yet.
         Bin = addELFNotes(Bin, Img.File);
       }
+      ArrayRef<char> ImgData(Bin->getBufferStart(), Bin->getBufferSize());
+      SmallVector<uint8_t, 0> CompressedData;
+      // Embedded LLVM IR is read by the kernel fusion JIT as is, so it is
+      // not compressed.
+      if (Kind == OffloadKind::SYCL && OffloadCompressDevImgs &&
+          Img.Tgt != "native_cpu" && !StringRef(Img.Tgt).starts_with("llvm_") &&
+          ImgData.size() >= OffloadCompressThreshold) {
+        if (compression::zstd::isAvailable()) {
+          compression::zstd::compress(
+              ArrayRef<uint8_t>(
+                  reinterpret_cast<const uint8_t *>(ImgData.data()),
+                  ImgData.size()),
+              CompressedData, OffloadCompressLevel);
+          if (Verbose)
+            errs() << "  compressed image: " << ImgData.size() << " -> "
+                   << CompressedData.size() << " bytes\n";
+          ImgData = ArrayRef<char>(
+              reinterpret_cast<const char *>(CompressedData.data()),
+              CompressedData.size());
+          Fmt = BinaryImageFormat::compressed_none;
+        } else if (!ZstdWarningEmitted) {
+          WithColor::warning(errs(), ToolName)
+              << "zstd is not available, device images are not compressed\n";
+          ZstdWarningEmitted = true;
+        }
+      }
+      auto *Ffmt = ConstantInt::get(Type::getInt8Ty(C), Fmt);
+
       std::pair<Constant *, Constant *> Fbin;
       if (Img.Tgt == "native_cpu") {
         auto FBinOrErr = addDeclarationsForNativeCPU(Img.EntriesFile);
@@ -1042,9 +1094,8 @@ private:
         Fbin = *FBinOrErr;
       } else {
         Fbin = addDeviceImageToModule(
-            ArrayRef<char>(Bin->getBufferStart(), Bin->getBufferSize()),
-            Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"), Kind,
-            Img.Tgt);
+            ImgData, Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"),
+            Kind, Img.Tgt);
       }
 
       if (Kind == OffloadKind::SYCL) {
@@ -1073,7 +1124,7 @@ private:
         auto *ImgInfoArr = ConstantArray::get(
             ArrayType::get(IntPtrTy, 2),
             {ConstantExpr::getPointerCast(Fbin.first, IntPtrTy),
-             ConstantInt::get(IntPtrTy, Bin->getBufferSize())});
+             ConstantInt::get(IntPtrTy, ImgData.size())});
         auto *ImgInfoVar = new GlobalVariable(
             M, ImgInfoArr->getType(), /*isConstant*/ true,
             GlobalVariable::InternalLinkage, ImgInfoArr,
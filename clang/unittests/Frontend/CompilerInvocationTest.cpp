@@ -12,6 +12,7 @@
 #include "clang/Frontend/TextDiagnosticBuffer.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Serialization/ModuleFileExtension.h"
+#include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/TargetParser/Host.h"
 
 #include "gmock/gmock.h"
@@ -905,6 +906,55 @@ TEST_F(CommandLineTest, DigraphsEnabled) {
   ASSERT_THAT(GeneratedArgs, Contains(StrEq("-fdigraphs")));
 }
 
+TEST_F(CommandLineTest, VFSStatCacheNotPresent) {
+  const char *Args[] = {""};
+
+  ASSERT_TRUE(CompilerInvocation::CreateFromArgs(Invocation, Args, *Diags));
+  ASSERT_FALSE(Invocation.getHeaderSearchOpts().CacheVFSStatus);
+
+  auto BaseFS = makeIntrusiveRefCnt<vfs::InMemoryFileSystem>();
+  auto FS = createVFSFromCompilerInvocation(Invocation, *Diags, BaseFS);
+  ASSERT_FALSE(FS->exists("/a.h"));
+  BaseFS->addFile("/a.h", 0, MemoryBuffer::getMemBuffer(""));
+  ASSERT_TRUE(FS->exists("/a.h"));
+
+  Invocation.generateCC1CommandLine(GeneratedArgs, *this);
+  ASSERT_THAT(GeneratedArgs, Not(Contains(StrEq("-fvfs-stat-cache"))));
+}
+
+TEST_F(CommandLineTest, VFSStatCachePresent) {
+  const char *Args[] = {"-fvfs-stat-cache"};
+
+  ASSERT_TRUE(CompilerInvocation::CreateFromArgs(Invocation, Args, *Diags));
+  ASSERT_TRUE(Invocation.getHeaderSearchOpts().CacheVFSStatus);
+
+  // The failed lookup is remembered.
+  auto BaseFS = makeIntrusiveRefCnt<vfs::InMemoryFileSystem>();
+  auto FS = createVFSFromCompilerInvocation(Invocation, *Diags, BaseFS);
+  ASSERT_FALSE(FS->exists("/a.h"));
+  BaseFS->addFile("/a.h", 0, MemoryBuffer::getMemBuffer(""));
+  ASSERT_FALSE(FS->exists("/a.h"));
+
+  Invocation.generateCC1CommandLine(GeneratedArgs, *this);
+  ASSERT_THAT(GeneratedArgs, Contains(StrEq("-fvfs-stat-cache")));
+}
+
+TEST_F(CommandLineTest, VFSStatCacheExcludesWrittenPaths) {
+  const char *Args[] = {"-fvfs-stat-cache", "-fmodules-cache-path=/cache",
+                        "-o", "/out/a.o"};
+
+  ASSERT_TRUE(CompilerInvocation::CreateFromArgs(Invocation, Args, *Diags));
+
+  auto BaseFS = makeIntrusiveRefCnt<vfs::InMemoryFileSystem>();
+  auto FS = createVFSFromCompilerInvocation(Invocation, *Diags, BaseFS);
+  ASSERT_FALSE(FS->exists("/cache/m.pcm"));
+  ASSERT_FALSE(FS->exists("/out/a.o"));
+  BaseFS->addFile("/cache/m.pcm", 0, MemoryBuffer::getMemBuffer(""));
+  BaseFS->addFile("/out/a.o", 0, MemoryBuffer::getMemBuffer(""));
+  ASSERT_TRUE(FS->exists("/cache/m.pcm"));
+  ASSERT_TRUE(FS->exists("/out/a.o"));
+}
+
 struct DummyModuleFileExtension
     : public llvm::RTTIExtends<DummyModuleFileExtension, ModuleFileExtension> {
   static char ID;
@@ -14,6 +14,7 @@
 #include "clang/Frontend/FrontendAction.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Tooling/CompilationDatabase.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningTool.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/ADT/STLExtras.h"
@@ -301,3 +302,33 @@ TEST(DependencyScanner, ScanDepsWithModuleLookup) {
               InterceptFS->StatPaths.end());
   EXPECT_EQ(InterceptFS->ReadFiles, std::vector<std::string>{"test.m"});
 }
+
+TEST(DependencyScanner, OutOfDateEntries) {
+  auto Sept = llvm::sys::path::get_separator();
+  std::string SamePath = std::string(llvm::formatv("{0}root{0}same.h", Sept));
+  std::string ChangedPath =
+      std::string(llvm::formatv("{0}root{0}changed.h", Sept));
+  std::string CreatedPath =
+      std::string(llvm::formatv("{0}root{0}created.h", Sept));
+
+  auto OldFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  OldFS->addFile(SamePath, 0, llvm::MemoryBuffer::getMemBuffer("\n"));
+  OldFS->addFile(ChangedPath, 0, llvm::MemoryBuffer::getMemBuffer("\n"));
+
+  DependencyScanningFilesystemSharedCache SharedCache;
+  DependencyScanningWorkerFilesystem DepFS(SharedCache, OldFS);
+  EXPECT_TRUE(DepFS.status(SamePath));
+  EXPECT_TRUE(DepFS.status(ChangedPath));
+  EXPECT_FALSE(DepFS.status(CreatedPath));
+  EXPECT_TRUE(SharedCache.getOutOfDateEntries(*OldFS).empty());
+
+  auto NewFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  NewFS->addFile(SamePath, 0, llvm::MemoryBuffer::getMemBuffer("\n"));
+  NewFS->addFile(ChangedPath, 0,
+                 llvm::MemoryBuffer::getMemBuffer("int x;\n"));
+  NewFS->addFile(CreatedPath, 0, llvm::MemoryBuffer::getMemBuffer("\n"));
+
+  std::vector<StringRef> OutOfDate = SharedCache.getOutOfDateEntries(*NewFS);
+  llvm::sort(OutOfDate);
+  EXPECT_EQ(OutOfDate, (std::vector<StringRef>{ChangedPath, CreatedPath}));
+}
@@ -686,17 +686,31 @@ struct Allocator {
     AsanThread *t = GetCurrentThread();
     m->SetFreeContext(t ? t->tid() : 0, StackDepotPut(*stack));
 
+    // Chunks above quarantine_max_chunk_size_mb would push most of the other
+    // chunks out of the quarantine while keeping a large mapping and its
+    // shadow resident, so they are released right away instead.
+    const int max_chunk_size_mb = flags()->quarantine_max_chunk_size_mb;
+    const bool bypass_quarantine =
+        max_chunk_size_mb >= 0 &&
+        m->UsedSize() > (static_cast<uptr>(max_chunk_size_mb) << 20);
+
     // Push into quarantine.
     if (t) {
       AsanThreadLocalMallocStorage *ms = &t->malloc_storage();
       AllocatorCache *ac = GetAllocatorCache(ms);
-      quarantine.Put(GetQuarantineCache(ms), QuarantineCallback(ac, stack), m,
-                     m->UsedSize());
+      if (UNLIKELY(bypass_quarantine))
+        QuarantineCallback(ac, stack).RecyclePassThrough(m);
+      else
+        quarantine.Put(GetQuarantineCache(ms), QuarantineCallback(ac, stack),
+                       m, m->UsedSize());
     } else {
       SpinMutexLock l(&fallback_mutex);
       AllocatorCache *ac = &fallback_allocator_cache;
-      quarantine.Put(&fallback_quarantine_cache, QuarantineCallback(ac, stack),
-                     m, m->UsedSize());
+      if (UNLIKELY(bypass_quarantine))
+        QuarantineCallback(ac, stack).RecyclePassThrough(m);
+      else
+        quarantine.Put(&fallback_quarantine_cache,
+                       QuarantineCallback(ac, stack), m, m->UsedSize());
     }
   }
 
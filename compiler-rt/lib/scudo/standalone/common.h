@@ -144,6 +144,9 @@ inline uptr getPageSizeCached() {
 // Returns 0 if the number of CPUs could not be determined.
 u32 getNumberOfCPUs();
 
+// Returns the CPU the calling thread is running on, or -1 if it is not known.
+s32 getCurrentCPU();
+
 const char *getEnv(const char *Name);
 
 u64 getMonotonicTime();
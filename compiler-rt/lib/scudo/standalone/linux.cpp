@@ -166,6 +166,8 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+s32 getCurrentCPU() { return static_cast<s32>(sched_getcpu()); }
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
@@ -72,4 +72,13 @@ TEST(ScudoCommonTest, Zeros) {
   MemMap.unmap(MemMap.getBase(), Size);
 }
 
+TEST(ScudoCommonTest, CurrentCPU) {
+  const s32 CPU = getCurrentCPU();
+#if SCUDO_LINUX
+  EXPECT_GE(CPU, 0);
+#else
+  EXPECT_GE(CPU, -1);
+#endif
+}
+
 } // namespace scudo
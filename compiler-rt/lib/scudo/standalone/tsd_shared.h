@@ -118,6 +118,9 @@ struct TSDRegistrySharedT {
 
     Str->append("Stats: SharedTSDs: %u available; total %u\n", NumberOfTSDs,
                 TSDsArraySize);
+    Str->append("  Contended lookups: %zu; resolved with the CPU's TSD: %zu\n",
+                atomic_load_relaxed(&SlowPathCount),
+                atomic_load_relaxed(&CPUHitCount));
     for (uptr I = 0; I < NumberOfTSDs; ++I) {
       TSDs[I].lock();
       Str->append("  Shared TSD[%zu]:\n", I);
@@ -180,8 +183,13 @@ private:
 
   NOINLINE void initThread(Allocator *Instance) NO_THREAD_SAFETY_ANALYSIS {
     initOnceMaybe(Instance);
-    // Initial context assignment is done in a plain round-robin fashion.
-    const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
+    // Start with the context of the CPU we are running on if it is known, so
+    // that threads sharing a CPU, which rarely run at the same time, share a
+    // context. Otherwise assign contexts in a plain round-robin fashion.
+    const s32 CPU = getCurrentCPU();
+    const u32 Index =
+        CPU >= 0 ? static_cast<u32>(CPU)
+                 : atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
     setCurrentTSD(&TSDs[Index % NumberOfTSDs]);
     Instance->callPostInitCallback();
   }
@@ -201,7 +209,19 @@ private:
       DCHECK_NE(NumberOfCoPrimes, 0U);
       Inc = CoPrimes[R % NumberOfCoPrimes];
     }
+    atomic_fetch_add(&SlowPathCount, 1U, memory_order_relaxed);
     if (N > 1U) {
+      // The thread may have migrated since it last picked a context. The
+      // context of the CPU it now runs on is the least likely to be in use.
+      const s32 CPU = getCurrentCPU();
+      if (CPU >= 0) {
+        TSD<Allocator> *CPUTSD = &TSDs[static_cast<u32>(CPU) % N];
+        if (CPUTSD != CurrentTSD && CPUTSD->tryLock()) {
+          atomic_fetch_add(&CPUHitCount, 1U, memory_order_relaxed);
+          setCurrentTSD(CPUTSD);
+          return CPUTSD;
+        }
+      }
       u32 Index = R % N;
       uptr LowestPrecedence = UINTPTR_MAX;
       TSD<Allocator> *CandidateTSD = nullptr;
@@ -233,6 +253,8 @@ private:
   }
 
   atomic_u32 CurrentIndex = {};
+  atomic_uptr SlowPathCount = {};
+  atomic_uptr CPUHitCount = {};
   u32 NumberOfTSDs GUARDED_BY(MutexTSDs) = 0;
   u32 NumberOfCoPrimes GUARDED_BY(MutexTSDs) = 0;
   u32 CoPrimes[TSDsArraySize] GUARDED_BY(MutexTSDs) = {};
@@ -117,6 +117,11 @@ void InitializeFlags(Flags *f, const char *env, const char *env_option_name) {
            " (must be [0..2])\n");
     Die();
   }
+  if (f->access_sample_rate < 1) {
+    Printf("ThreadSanitizer: incorrect value for access_sample_rate"
+           " (must be >= 1)\n");
+    Die();
+  }
 }
 
 }  // namespace __tsan
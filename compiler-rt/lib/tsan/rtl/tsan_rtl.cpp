@@ -424,6 +424,8 @@ ThreadState::ThreadState(Tid tid)
 #endif
   shadow_stack_pos = shadow_stack;
   shadow_stack_end = shadow_stack + kInitStackSize;
+  access_sample_rate = flags()->access_sample_rate;
+  access_sample_countdown = 1;
 }
 
 #if !SANITIZER_GO
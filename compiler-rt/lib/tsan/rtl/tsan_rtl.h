@@ -182,6 +182,10 @@ struct ThreadState {
   // for better performance.
   int ignore_reads_and_writes;
   int suppress_reports;
+  // Only every access_sample_rate-th memory access that misses the shadow
+  // fast path is traced and checked for races (see access_sample_rate flag).
+  u32 access_sample_rate;
+  u32 access_sample_countdown;
   // Go does not support ignores.
 #if !SANITIZER_GO
   IgnoreSet mop_ignore_set;
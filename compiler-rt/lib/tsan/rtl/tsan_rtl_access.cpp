@@ -400,6 +400,18 @@ char* DumpShadow(char* buf, RawShadow raw) {
   return buf;
 }
 
+// Returns true if the current access should be dropped because of access
+// sampling. Skipping an access only loses races, it never produces false
+// positives: shadow keeps holding real accesses and clocks are unaffected.
+ALWAYS_INLINE bool SkipSampledAccess(ThreadState* thr) {
+  if (LIKELY(thr->access_sample_rate == 1))
+    return false;
+  if (--thr->access_sample_countdown)
+    return true;
+  thr->access_sample_countdown = thr->access_sample_rate;
+  return false;
+}
+
 // TryTrace* and TraceRestart* functions allow to turn memory access and func
 // entry/exit callbacks into leaf functions with all associated performance
 // benefits. These hottest callbacks do only 2 slow path calls: report a race
@@ -437,6 +449,8 @@ ALWAYS_INLINE USED void MemoryAccess(ThreadState* thr, uptr pc, uptr addr,
     return;
   if (UNLIKELY(fast_state.GetIgnoreBit()))
     return;
+  if (UNLIKELY(SkipSampledAccess(thr)))
+    return;
   if (!TryTraceMemoryAccess(thr, pc, addr, size, typ))
     return TraceRestartMemoryAccess(thr, pc, addr, size, typ);
   CheckRaces(thr, shadow_mem, cur, shadow, access, typ);
@@ -464,6 +478,8 @@ ALWAYS_INLINE USED void MemoryAccess16(ThreadState* thr, uptr pc, uptr addr,
     LOAD_CURRENT_SHADOW(cur, shadow_mem);
     if (LIKELY(ContainsSameAccess(shadow_mem, cur, shadow, access, typ)))
       goto SECOND;
+    if (UNLIKELY(SkipSampledAccess(thr)))
+      return;
     if (!TryTraceMemoryAccessRange(thr, pc, addr, size, typ))
       return RestartMemoryAccess16(thr, pc, addr, typ);
     traced = true;
@@ -475,8 +491,12 @@ SECOND:
   LOAD_CURRENT_SHADOW(cur, shadow_mem);
   if (LIKELY(ContainsSameAccess(shadow_mem, cur, shadow, access, typ)))
     return;
-  if (!traced && !TryTraceMemoryAccessRange(thr, pc, addr, size, typ))
-    return RestartMemoryAccess16(thr, pc, addr, typ);
+  if (!traced) {
+    if (UNLIKELY(SkipSampledAccess(thr)))
+      return;
+    if (!TryTraceMemoryAccessRange(thr, pc, addr, size, typ))
+      return RestartMemoryAccess16(thr, pc, addr, typ);
+  }
   CheckRaces(thr, shadow_mem, cur, shadow, access, typ);
 }
 
@@ -502,6 +522,8 @@ ALWAYS_INLINE USED void UnalignedMemoryAccess(ThreadState* thr, uptr pc,
     LOAD_CURRENT_SHADOW(cur, shadow_mem);
     if (LIKELY(ContainsSameAccess(shadow_mem, cur, shadow, access, typ)))
       goto SECOND;
+    if (UNLIKELY(SkipSampledAccess(thr)))
+      return;
     if (!TryTraceMemoryAccessRange(thr, pc, addr, size, typ))
       return RestartUnalignedMemoryAccess(thr, pc, addr, size, typ);
     traced = true;
@@ -517,8 +539,12 @@ SECOND:
   LOAD_CURRENT_SHADOW(cur, shadow_mem);
   if (LIKELY(ContainsSameAccess(shadow_mem, cur, shadow, access, typ)))
     return;
-  if (!traced && !TryTraceMemoryAccessRange(thr, pc, addr, size, typ))
-    return RestartUnalignedMemoryAccess(thr, pc, addr, size, typ);
+  if (!traced) {
+    if (UNLIKELY(SkipSampledAccess(thr)))
+      return;
+    if (!TryTraceMemoryAccessRange(thr, pc, addr, size, typ))
+      return RestartUnalignedMemoryAccess(thr, pc, addr, size, typ);
+  }
   CheckRaces(thr, shadow_mem, cur, shadow, access, typ);
 }
 
@@ -0,0 +1,29 @@
+// Test quarantine_max_chunk_size_mb runtime option.
+
+// RUN: %clangxx_asan -O0 %s -o %t
+// RUN: %run %t 2>&1 | FileCheck %s --check-prefix=QUARANTINE
+// RUN: %env_asan_opts=quarantine_max_chunk_size_mb=1 %run %t 2>&1 | FileCheck %s --check-prefix=BYPASS
+
+#include <sanitizer/asan_interface.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int main() {
+  char *small = (char *)malloc(1 << 10);
+  char *large = (char *)malloc(4 << 20);
+  small[0] = large[0] = 1;
+  free(small);
+  free(large);
+
+  // Small chunks are always quarantined and stay poisoned.
+  fprintf(stderr, "small: %d\n", __asan_address_is_poisoned(small));
+  // QUARANTINE: small: 1
+  // BYPASS: small: 1
+
+  // A quarantined large chunk is poisoned, a released one is unmapped and its
+  // shadow cleared.
+  fprintf(stderr, "large: %d\n", __asan_address_is_poisoned(large));
+  // QUARANTINE: large: 1
+  // BYPASS: large: 0
+  return 0;
+}
@@ -0,0 +1,39 @@
+// RUN: %clangxx_tsan -O1 %s -o %t
+// RUN: %deflake %run %t 2>&1 | FileCheck %s
+// RUN: %env_tsan_opts=access_sample_rate=16 %deflake %run %t 2>&1 | FileCheck %s
+// RUN: %env_tsan_opts=access_sample_rate=0 not %run %t 2>&1 | FileCheck %s --check-prefix=BAD
+
+// Races that repeat over many accesses are still found when only a fraction
+// of the accesses is checked.
+
+#include "test.h"
+
+const int kSize = 1024;
+volatile int Data[kSize];
+
+void *Thread1(void *x) {
+  barrier_wait(&barrier);
+  for (int i = 0; i < kSize; i++)
+    Data[i]++;
+  return NULL;
+}
+
+void *Thread2(void *x) {
+  for (int i = 0; i < kSize; i++)
+    Data[i]--;
+  barrier_wait(&barrier);
+  return NULL;
+}
+
+int main() {
+  barrier_init(&barrier, 2);
+  pthread_t t[2];
+  pthread_create(&t[0], NULL, Thread1, NULL);
+  pthread_create(&t[1], NULL, Thread2, NULL);
+  pthread_join(t[0], NULL);
+  pthread_join(t[1], NULL);
+  return 0;
+}
+
+// CHECK: WARNING: ThreadSanitizer: data race
+// BAD: ThreadSanitizer: incorrect value for access_sample_rate
@@ -144,7 +144,11 @@ private:
     if (bytes > size_) {
       char *old{buffer_};
       auto oldSize{size_};
-      size_ = std::max<std::int64_t>(bytes, size_ + minBuffer);
+      // Grow geometrically: a frame that grows a little at a time, like a
+      // long sequential unformatted record written one item at a time, must
+      // not be copied over again on every slight extension.
+      size_ = std::max<std::int64_t>(
+          bytes, size_ + std::max<std::int64_t>(size_, minBuffer));
       buffer_ =
           reinterpret_cast<char *>(AllocateMemoryOrCrash(terminator, size_));
       auto chunk{std::min<std::int64_t>(length_, oldSize - start_)};
@@ -15,6 +15,8 @@
 #include "environment.h"
 #include "tools.h"
 #include "utf.h"
+#include <algorithm>
+#include <cstring>
 
 namespace Fortran::runtime::io {
 
@@ -90,20 +92,23 @@ bool EmitRepeated(CONTEXT &to, char ch, std::size_t n) {
     return true;
   }
   ConnectionState &connection{to.GetConnectionState()};
-  if (connection.internalIoCharKind <= 1 &&
-      connection.access != Access::Stream) {
-    // faster path, no encoding needed
-    while (n-- > 0) {
-      if (!to.Emit(&ch, 1)) {
-        return false;
-      }
-    }
-  } else {
-    while (n-- > 0) {
-      if (!EmitEncoded(to, &ch, 1)) {
+  // Emit the repeated character in chunks rather than one at a time; wide
+  // fields of blanks or zeroes are common in formatted output.
+  char chunk[64];
+  std::memset(chunk, ch, std::min<std::size_t>(n, sizeof chunk));
+  bool noEncoding{connection.internalIoCharKind <= 1 &&
+      connection.access != Access::Stream};
+  while (n > 0) {
+    std::size_t bytes{std::min<std::size_t>(n, sizeof chunk)};
+    if (noEncoding) {
+      // faster path, no encoding needed
+      if (!to.Emit(chunk, bytes)) {
         return false;
       }
+    } else if (!EmitEncoded(to, chunk, bytes)) {
+      return false;
     }
+    n -= bytes;
   }
   return true;
 }
@@ -120,3 +120,30 @@ TEST(BufferTests, TestFrameBufferReadAndWrite) {
     ++j;
   }
 }
+
+TEST(BufferTests, TestFrameBufferGrowth) {
+  Terminator terminator{__FILE__, __LINE__};
+  IoErrorHandler handler{terminator};
+  Store store;
+  store.set_enforceSequence(true);
+  const auto bytes{static_cast<FileOffset>(store.bytes())};
+  // Extend a single frame one byte at a time, as a long record that is
+  // written an item at a time does; its contents must survive every
+  // reallocation of the buffer.
+  for (FileOffset at{0}; at < bytes; ++at) {
+    store.WriteFrame(0, at + 1, handler);
+    store.Frame()[at] = ValueFor(at);
+  }
+  store.Flush(handler);
+  // Validate
+  store.set_expect(0);
+  std::size_t frame{store.ReadFrame(0, bytes, handler)};
+  ASSERT_GE(frame, static_cast<std::size_t>(bytes));
+  const char *from{store.Frame()};
+  for (FileOffset at{0}; at < bytes; ++at) {
+    auto expect{static_cast<char>(ValueFor(at))};
+    ASSERT_EQ(from[at], expect) << "At " << at << ", read " << (from[at] & 0xff)
+                                << ", expected " << static_cast<int>(expect)
+                                << '\n';
+  }
+}
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "GenerateInput.h"
+#include "test_macros.h"
+
+// Lookup-heavy benchmarks for std::unordered_map. The sizes go well past the
+// cache sizes, where following the node chain of a bucket dominates lookups.
+
+namespace {
+
+template <class Key>
+std::unordered_map<Key, std::size_t> makeMap(const std::vector<Key>& keys) {
+  std::unordered_map<Key, std::size_t> m;
+  m.reserve(keys.size());
+  for (std::size_t i = 0; i != keys.size(); ++i)
+    m.emplace(keys[i], i);
+  return m;
+}
+
+template <class GenInputs>
+void BM_FindHit(benchmark::State& st, GenInputs gen) {
+  const auto keys = gen(st.range(0));
+  const auto m    = makeMap(keys);
+  for (auto _ : st) {
+    for (const auto& k : keys)
+      benchmark::DoNotOptimize(m.find(k));
+  }
+  st.SetItemsProcessed(st.iterations() * keys.size());
+}
+
+template <class GenInputs>
+void BM_FindMiss(benchmark::State& st, GenInputs gen) {
+  // Only the first half of the keys is inserted; the second half is looked up.
+  const auto keys = gen(2 * st.range(0));
+  const std::vector present(keys.begin(), keys.begin() + keys.size() / 2);
+  const std::vector missing(keys.begin() + keys.size() / 2, keys.end());
+  const auto m = makeMap(present);
+  for (auto _ : st) {
+    for (const auto& k : missing)
+      benchmark::DoNotOptimize(m.find(k));
+  }
+  st.SetItemsProcessed(st.iterations() * missing.size());
+}
+
+template <class GenInputs>
+void BM_InsertSubscript(benchmark::State& st, GenInputs gen) {
+  const auto keys = gen(st.range(0));
+  std::unordered_map<typename decltype(keys)::value_type, std::size_t> m;
+  for (auto _ : st) {
+    st.PauseTiming();
+    m.clear();
+    st.ResumeTiming();
+    for (const auto& k : keys)
+      benchmark::DoNotOptimize(m[k]);
+  }
+  st.SetItemsProcessed(st.iterations() * keys.size());
+}
+
+template <class GenInputs>
+void BM_EraseKey(benchmark::State& st, GenInputs gen) {
+  const auto keys = gen(st.range(0));
+  const auto m    = makeMap(keys);
+  for (auto _ : st) {
+    st.PauseTiming();
+    auto copy = m;
+    st.ResumeTiming();
+    for (const auto& k : keys)
+      benchmark::DoNotOptimize(copy.erase(k));
+    st.PauseTiming();
+    // Destroy the (now empty) copy outside of the timed region.
+    copy = {};
+    st.ResumeTiming();
+  }
+  st.SetItemsProcessed(st.iterations() * keys.size());
+}
+
+} // namespace
+
+#define UNORDERED_MAP_BENCHMARKS(Name, Gen)                                                                            \
+  BENCHMARK_CAPTURE(BM_FindHit, Name, Gen)->RangeMultiplier(8)->Range(512, 1 << 20);                                   \
+  BENCHMARK_CAPTURE(BM_FindMiss, Name, Gen)->RangeMultiplier(8)->Range(512, 1 << 20);                                  \
+  BENCHMARK_CAPTURE(BM_InsertSubscript, Name, Gen)->RangeMultiplier(8)->Range(512, 1 << 20);                           \
+  BENCHMARK_CAPTURE(BM_EraseKey, Name, Gen)->RangeMultiplier(8)->Range(512, 1 << 20)
+
+UNORDERED_MAP_BENCHMARKS(uint64_random, getRandomIntegerInputs<uint64_t>);
+UNORDERED_MAP_BENCHMARKS(string_random, getRandomStringInputs);
+
+BENCHMARK_MAIN();
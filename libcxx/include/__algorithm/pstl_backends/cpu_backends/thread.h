@@ -9,10 +9,24 @@
 #ifndef _LIBCPP___ALGORITHM_PSTL_BACKENDS_CPU_BACKENDS_THREAD_H
 #define _LIBCPP___ALGORITHM_PSTL_BACKENDS_CPU_BACKENDS_THREAD_H
 
+#include <__algorithm/max.h>
+#include <__algorithm/min.h>
+#include <__algorithm/pstl_backends/cpu_backends/chunked_algorithms.h>
 #include <__assert>
+#include <__atomic/atomic.h>
+#include <__atomic/memory_order.h>
 #include <__config>
+#include <__memory/unique_ptr.h>
 #include <__utility/move.h>
 #include <cstddef>
+#include <new>
+
+#ifndef _LIBCPP_HAS_NO_THREADS
+#  include <__condition_variable/condition_variable.h>
+#  include <__mutex/mutex.h>
+#  include <__mutex/unique_lock.h>
+#  include <__thread/thread.h>
+#endif
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -23,55 +37,217 @@ _LIBCPP_PUSH_MACROS
 
 #if !defined(_LIBCPP_HAS_NO_INCOMPLETE_PSTL) && _LIBCPP_STD_VER >= 17
 
-// This backend implementation is for testing purposes only and not meant for production use. This will be replaced
-// by a proper implementation once the PSTL implementation is somewhat stable.
-
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 namespace __par_backend {
 inline namespace __thread_cpu_backend {
 
-template <class _RandomAccessIterator, class _Fp>
-_LIBCPP_HIDE_FROM_ABI void __parallel_for(_RandomAccessIterator __first, _RandomAccessIterator __last, _Fp __f) {
-  __f(__first, __last);
-}
+// This backend runs the algorithms of chunked_algorithms.h on std::threads. Each parallel algorithm starts its threads
+// the first time it has more than one chunk to run and joins them before returning, so an algorithm which runs several
+// passes, like stable_sort, starts them only once. Chunks are handed out through a shared counter, so threads that
+// finish early pick up the remaining work.
 
-template <class _Index, class _UnaryOp, class _Tp, class _BinaryOp, class _Reduce>
-_LIBCPP_HIDE_FROM_ABI _Tp
-__parallel_transform_reduce(_Index __first, _Index __last, _UnaryOp, _Tp __init, _BinaryOp, _Reduce __reduce) {
-  return __reduce(std::move(__first), std::move(__last), std::move(__init));
-}
+// Below this many elements per chunk, starting a thread costs more than it saves.
+inline constexpr ptrdiff_t __min_chunk_size = 1024;
 
-template <class _RandomAccessIterator, class _Compare, class _LeafSort>
-_LIBCPP_HIDE_FROM_ABI void __parallel_stable_sort(
-    _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp, _LeafSort __leaf_sort) {
-  __leaf_sort(__first, __last, __comp);
+_LIBCPP_HIDE_FROM_ABI inline size_t __worker_count() noexcept {
+#  ifndef _LIBCPP_HAS_NO_THREADS
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+#  else
+  return 1;
+#  endif
 }
 
-_LIBCPP_HIDE_FROM_ABI inline void __cancel_execution() {}
+struct __chunk_partitions {
+  ptrdiff_t __chunk_count_; // includes the first chunk
+  ptrdiff_t __chunk_size_;
+  ptrdiff_t __first_chunk_size_;
+};
+
+// The dispatcher of the algorithms in chunked_algorithms.h. It owns the helper threads of one parallel algorithm,
+// which wait for the chunks of the next __dispatch_apply between the passes of the algorithm.
+class __dispatcher {
+public:
+  _LIBCPP_HIDE_FROM_ABI __dispatcher() = default;
+  __dispatcher(const __dispatcher&)            = delete;
+  __dispatcher& operator=(const __dispatcher&) = delete;
+
+  _LIBCPP_HIDE_FROM_ABI ~__dispatcher() {
+#  ifndef _LIBCPP_HAS_NO_THREADS
+    if (__helper_count_ == 0)
+      return;
+    {
+      unique_lock<mutex> __lock(__mutex_);
+      __stop_ = true;
+    }
+    __job_posted_.notify_all();
+    for (size_t __i = 0; __i != __helper_count_; ++__i)
+      __helpers_[__i].join();
+#  endif
+  }
+
+  // Splits __size elements into chunks of equal size, except for the first one which also takes the remainder. There
+  // are a few chunks per worker, so that threads that finish early can balance the load.
+  _LIBCPP_HIDE_FROM_ABI static __chunk_partitions __partition_chunks(ptrdiff_t __size) noexcept {
+    __chunk_partitions __partitions;
+    __partitions.__chunk_count_ = std::max<ptrdiff_t>(
+        1, std::min<ptrdiff_t>(__size / __min_chunk_size, 4 * static_cast<ptrdiff_t>(__worker_count())));
+    __partitions.__chunk_size_       = __size / __partitions.__chunk_count_;
+    __partitions.__first_chunk_size_ = __size - (__partitions.__chunk_count_ - 1) * __partitions.__chunk_size_;
+    return __partitions;
+  }
+
+  // Runs __func(__chunk) for every __chunk in [0, __chunk_count). The calling thread takes part in the work.
+  // Exceptions are not propagated out of the helper threads, and neither do we let them escape here.
+  template <class _Func>
+  _LIBCPP_HIDE_FROM_ABI void __dispatch_apply(size_t __chunk_count, _Func __func) noexcept {
+#  ifndef _LIBCPP_HAS_NO_THREADS
+    if (__chunk_count > 1)
+      __start_helpers(std::min(__chunk_count, __worker_count()) - 1);
+    __job __j{
+        &__func, [](void* __context, size_t __chunk) { (*static_cast<_Func*>(__context))(__chunk); }, __chunk_count};
+    if (__chunk_count <= 1 || __helper_count_ == 0)
+      return __j.__run();
+
+    {
+      unique_lock<mutex> __lock(__mutex_);
+      __job_     = &__j;
+      __running_ = __helper_count_;
+      ++__generation_;
+    }
+    __job_posted_.notify_all();
+    __j.__run();
+    // __j must outlive the helpers' use of it.
+    unique_lock<mutex> __lock(__mutex_);
+    __job_done_.wait(__lock, [this] { return __running_ == 0; });
+#  else
+    for (size_t __chunk = 0; __chunk != __chunk_count; ++__chunk)
+      __func(__chunk);
+#  endif
+  }
+
+private:
+#  ifndef _LIBCPP_HAS_NO_THREADS
+  struct __job {
+    void* __context_;
+    void (*__func_)(void* __context, size_t __chunk);
+    size_t __chunk_count_;
+    atomic<size_t> __next_chunk_{0};
+
+    _LIBCPP_HIDE_FROM_ABI void __run() {
+      for (size_t __chunk; (__chunk = __next_chunk_.fetch_add(1, memory_order_relaxed)) < __chunk_count_;)
+        __func_(__context_, __chunk);
+    }
+  };
+
+  // Starts up to __count helpers unless they are running already. Failing to start a helper only costs parallelism:
+  // the threads that did start, including the calling one, pick up the remaining chunks.
+  _LIBCPP_HIDE_FROM_ABI void __start_helpers(size_t __count) noexcept {
+    if (__helpers_ || __count == 0)
+      return;
+#    ifndef _LIBCPP_HAS_NO_EXCEPTIONS
+    try {
+#    endif
+      __helpers_.reset(new std::thread[__count]);
+      for (; __helper_count_ != __count; ++__helper_count_)
+        __helpers_[__helper_count_] = std::thread([this] { __helper_loop(); });
+#    ifndef _LIBCPP_HAS_NO_EXCEPTIONS
+    } catch (...) {
+    }
+#    endif
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __helper_loop() {
+    size_t __seen_generation = 0;
+    unique_lock<mutex> __lock(__mutex_);
+    while (true) {
+      __job_posted_.wait(__lock, [&] { return __stop_ || __generation_ != __seen_generation; });
+      if (__stop_)
+        return;
+      __seen_generation = __generation_;
+      __job* __j        = __job_;
+      __lock.unlock();
+      __j->__run();
+      __lock.lock();
+      if (--__running_ == 0)
+        __job_done_.notify_one();
+    }
+  }
+
+  unique_ptr<std::thread[]> __helpers_;
+  size_t __helper_count_ = 0;
+  mutex __mutex_;
+  condition_variable __job_posted_;
+  condition_variable __job_done_;
+  // The members below are guarded by __mutex_.
+  __job* __job_        = nullptr;
+  size_t __running_    = 0;
+  size_t __generation_ = 0;
+  bool __stop_         = false;
+#  endif
+};
+
+template <class _RandomAccessIterator, class _Functor>
+_LIBCPP_HIDE_FROM_ABI void
+__parallel_for(_RandomAccessIterator __first, _RandomAccessIterator __last, _Functor __func) {
+  __chunked::__parallel_for<__dispatcher>(std::move(__first), std::move(__last), std::move(__func));
+}
 
-template <class _RandomAccessIterator1,
-          class _RandomAccessIterator2,
-          class _RandomAccessIterator3,
-          class _Compare,
-          class _LeafMerge>
+template <typename _RandomAccessIterator1,
+          typename _RandomAccessIterator2,
+          typename _RandomAccessIterator3,
+          typename _Compare,
+          typename _LeafMerge>
 _LIBCPP_HIDE_FROM_ABI void __parallel_merge(
     _RandomAccessIterator1 __first1,
     _RandomAccessIterator1 __last1,
     _RandomAccessIterator2 __first2,
     _RandomAccessIterator2 __last2,
-    _RandomAccessIterator3 __outit,
+    _RandomAccessIterator3 __result,
     _Compare __comp,
     _LeafMerge __leaf_merge) {
-  __leaf_merge(__first1, __last1, __first2, __last2, __outit, __comp);
+  __chunked::__parallel_merge<__dispatcher>(
+      std::move(__first1),
+      std::move(__last1),
+      std::move(__first2),
+      std::move(__last2),
+      std::move(__result),
+      std::move(__comp),
+      std::move(__leaf_merge));
 }
 
+template <class _RandomAccessIterator, class _Transform, class _Value, class _Combiner, class _Reduction>
+_LIBCPP_HIDE_FROM_ABI _Value __parallel_transform_reduce(
+    _RandomAccessIterator __first,
+    _RandomAccessIterator __last,
+    _Transform __transform,
+    _Value __init,
+    _Combiner __combiner,
+    _Reduction __reduction) {
+  return __chunked::__parallel_transform_reduce<__dispatcher>(
+      std::move(__first),
+      std::move(__last),
+      std::move(__transform),
+      std::move(__init),
+      std::move(__combiner),
+      std::move(__reduction));
+}
+
+template <class _RandomAccessIterator, class _Comp, class _LeafSort>
+_LIBCPP_HIDE_FROM_ABI void __parallel_stable_sort(
+    _RandomAccessIterator __first, _RandomAccessIterator __last, _Comp __comp, _LeafSort __leaf_sort) {
+  __chunked::__parallel_stable_sort<__dispatcher>(
+      std::move(__first), std::move(__last), std::move(__comp), std::move(__leaf_sort));
+}
+
+_LIBCPP_HIDE_FROM_ABI inline void __cancel_execution() {}
+
 } // namespace __thread_cpu_backend
 } // namespace __par_backend
 
 _LIBCPP_END_NAMESPACE_STD
 
-#endif // !defined(_LIBCPP_HAS_NO_INCOMPLETE_PSTL) && && _LIBCPP_STD_VER >= 17
+#endif // !defined(_LIBCPP_HAS_NO_INCOMPLETE_PSTL) && _LIBCPP_STD_VER >= 17
 
 _LIBCPP_POP_MACROS
 
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// UNSUPPORTED: libcpp-has-no-incomplete-pstl
+
+// Make sure that the parallel algorithms give the same results as their serial counterparts on inputs that are large
+// enough to be split into several chunks by the CPU backends.
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+int main(int, char**) {
+  constexpr int N = 100000;
+
+  std::vector<int> in(N);
+  for (int i = 0; i != N; ++i)
+    in[i] = (i * 7919) % N;
+
+  { // for_each
+    std::vector<int> v = in;
+    std::for_each(std::execution::par, v.begin(), v.end(), [](int& x) { x *= 2; });
+    for (int i = 0; i != N; ++i)
+      assert(v[i] == in[i] * 2);
+  }
+
+  { // transform
+    std::vector<int> out(N);
+    std::transform(std::execution::par, in.begin(), in.end(), out.begin(), [](int x) { return x + 1; });
+    for (int i = 0; i != N; ++i)
+      assert(out[i] == in[i] + 1);
+  }
+
+  { // transform_reduce
+    long long sum = std::transform_reduce(
+        std::execution::par, in.begin(), in.end(), 0LL, std::plus<>(), [](int x) { return static_cast<long long>(x); });
+    assert(sum == static_cast<long long>(N) * (N - 1) / 2);
+  }
+
+  { // merge
+    std::vector<int> a(in.begin(), in.begin() + N / 2);
+    std::vector<int> b(in.begin() + N / 2, in.end());
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    std::vector<int> out(N);
+    std::merge(std::execution::par, a.begin(), a.end(), b.begin(), b.end(), out.begin());
+    std::vector<int> expected(N);
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+    assert(out == expected);
+  }
+
+  { // stable_sort
+    std::vector<std::pair<int, int>> v(N);
+    for (int i = 0; i != N; ++i)
+      v[i] = {in[i] % 64, i};
+    std::stable_sort(std::execution::par, v.begin(), v.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    for (int i = 1; i != N; ++i)
+      assert(v[i - 1].first < v[i].first || (v[i - 1].first == v[i].first && v[i - 1].second < v[i].second));
+  }
+
+  return 0;
+}
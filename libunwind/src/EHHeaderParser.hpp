@@ -116,20 +116,41 @@ bool EHHeaderParser<A>::findFDE(A &addressSpace, pint_t pc, pint_t ehHdrStart,
   pint_t tableEntry;
 
   size_t low = 0;
-  for (size_t len = hdrInfo.fde_count; len > 1;) {
-    size_t mid = low + (len / 2);
-    tableEntry = hdrInfo.table + mid * tableEntrySize;
-    pint_t start = addressSpace.getEncodedP(tableEntry, ehHdrEnd,
-                                            hdrInfo.table_enc, ehHdrStart);
-
-    if (start == pc) {
-      low = mid;
-      break;
-    } else if (start < pc) {
-      low = mid;
-      len -= (len / 2);
-    } else {
-      len /= 2;
+  if (hdrInfo.table_enc == (DW_EH_PE_datarel | DW_EH_PE_sdata4)) {
+    // This is the encoding emitted by all common linkers. Compare the raw
+    // section relative offsets instead of decoding every probed entry.
+    const int64_t target = (int64_t)pc - (int64_t)ehHdrStart;
+    for (size_t len = hdrInfo.fde_count; len > 1;) {
+      size_t mid = low + (len / 2);
+      int64_t start =
+          (int32_t)addressSpace.get32(hdrInfo.table + mid * tableEntrySize);
+
+      if (start == target) {
+        low = mid;
+        break;
+      } else if (start < target) {
+        low = mid;
+        len -= (len / 2);
+      } else {
+        len /= 2;
+      }
+    }
+  } else {
+    for (size_t len = hdrInfo.fde_count; len > 1;) {
+      size_t mid = low + (len / 2);
+      tableEntry = hdrInfo.table + mid * tableEntrySize;
+      pint_t start = addressSpace.getEncodedP(tableEntry, ehHdrEnd,
+                                              hdrInfo.table_enc, ehHdrStart);
+
+      if (start == pc) {
+        low = mid;
+        break;
+      } else if (start < pc) {
+        low = mid;
+        len -= (len / 2);
+      } else {
+        len /= 2;
+      }
     }
   }
 
@@ -733,12 +733,16 @@ void TpiSource::remapTpiWithGHashes(GHashState *g) {
   tpiMap = indexMapStorage;
   ipiMap = indexMapStorage;
   mergeUniqueTypeRecords(file->debugTypes);
-  // TODO: Free all unneeded ghash resources now that we have a full index map.
 
   if (ctx.config.showSummary) {
     nbTypeRecords = ghashes.size();
     nbTypeRecordsBytes = file->debugTypes.size();
   }
+
+  // The index map is complete, so the ghashes are no longer needed. Free them
+  // now rather than after all sources have been merged to lower peak memory
+  // usage.
+  clearGHashes();
 }
 
 // PDBs do not actually store global hashes, so when merging a type server
@@ -1210,13 +1214,17 @@ static TypeIndex loadPdbTypeIndexFromCell(GHashState *g,
 
 /// Free heap allocated ghashes.
 void TypeMerger::clearGHashes() {
-  for (TpiSource *src : ctx.tpiSourceList) {
-    if (src->ownedGHashes)
-      delete[] src->ghashes.data();
-    src->ghashes = {};
-    src->isItemIndex.clear();
-    src->uniqueTypes.clear();
-  }
+  for (TpiSource *src : ctx.tpiSourceList)
+    src->clearGHashes();
+}
+
+void TpiSource::clearGHashes() {
+  if (ownedGHashes)
+    delete[] ghashes.data();
+  ghashes = {};
+  ownedGHashes = true;
+  BitVector().swap(isItemIndex);
+  std::vector<uint32_t>().swap(uniqueTypes);
 }
 
 // Fill in a TPI or IPI index map using ghashes. For each source type, use its
@@ -94,6 +94,9 @@ protected:
   COFFLinkerContext &ctx;
 
 public:
+  // Free the ghashes and the other ghash merging state of this source.
+  void clearGHashes();
+
   bool remapTypesInSymbolRecord(MutableArrayRef<uint8_t> rec);
 
   void remapTypesInTypeRecord(MutableArrayRef<uint8_t> rec);
@@ -38,6 +38,9 @@
 ///   * If not, then combine the clusters.
 /// * Sort non-empty clusters by density
 ///
+/// With --call-graph-profile-sort=cdsort, the sections are instead ordered by
+/// the Cache-Directed Sort algorithm of llvm/Transforms/Utils/CodeLayout.h.
+///
 //===----------------------------------------------------------------------===//
 
 #include "CallGraphSort.h"
@@ -45,6 +48,7 @@
 #include "InputSection.h"
 #include "Symbols.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Transforms/Utils/CodeLayout.h"
 
 #include <numeric>
 
@@ -268,3 +272,60 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
 DenseMap<const InputSectionBase *, int> elf::computeCallGraphProfileOrder() {
   return CallGraphSort().run();
 }
+
+// Sort sections by the profile data using the Cache-Directed Sort algorithm.
+// The placement is done by optimizing the locality by co-locating frequently
+// executed code sections together.
+DenseMap<const InputSectionBase *, int> elf::computeCacheDirectedSortOrder() {
+  std::vector<uint64_t> funcSizes;
+  std::vector<uint64_t> funcCounts;
+  std::vector<EdgeCountT> callCounts;
+  std::vector<uint64_t> callOffsets;
+  std::vector<const InputSectionBase *> sections;
+  DenseMap<const InputSectionBase *, size_t> secToTargetId;
+
+  auto getOrCreateNode = [&](const InputSectionBase *isec) -> size_t {
+    auto res = secToTargetId.try_emplace(isec, sections.size());
+    if (res.second) {
+      sections.push_back(isec);
+      funcSizes.push_back(isec->getSize());
+      funcCounts.push_back(0);
+    }
+    return res.first->second;
+  };
+
+  // Create the graph.
+  for (std::pair<SectionPair, uint64_t> &c : config->callGraphProfile) {
+    const auto *fromSB = cast<InputSectionBase>(c.first.first);
+    const auto *toSB = cast<InputSectionBase>(c.first.second);
+    // Ignore edges between input sections belonging to different output
+    // sections, as in CallGraphSort.
+    if (fromSB->getOutputSection() != toSB->getOutputSection())
+      continue;
+
+    uint64_t weight = c.second;
+    if (weight == 0)
+      continue;
+
+    size_t from = getOrCreateNode(fromSB);
+    size_t to = getOrCreateNode(toSB);
+    // Ignore self-edges (recursive calls).
+    if (from == to)
+      continue;
+
+    callCounts.push_back({{from, to}, weight});
+    // The profile doesn't have the offsets of the calls, so assume that they
+    // are in the middle of the caller.
+    callOffsets.push_back((funcSizes[from] + 1) / 2);
+    funcCounts[to] += weight;
+  }
+
+  std::vector<uint64_t> sortedSections =
+      applyCDSLayout(funcSizes, funcCounts, callCounts, callOffsets);
+
+  DenseMap<const InputSectionBase *, int> orderMap;
+  int curOrder = 1;
+  for (uint64_t secIdx : sortedSections)
+    orderMap[sections[secIdx]] = curOrder++;
+  return orderMap;
+}
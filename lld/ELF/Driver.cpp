@@ -754,6 +754,17 @@ static bool isOutputFormatBinary(opt::InputArgList &args) {
   return false;
 }
 
+static CGProfileSortKind getCGProfileSortKind(opt::InputArgList &args) {
+  StringRef s = args.getLastArgValue(OPT_call_graph_profile_sort, "hfsort");
+  if (s == "hfsort")
+    return CGProfileSortKind::Hfsort;
+  if (s == "cdsort")
+    return CGProfileSortKind::Cdsort;
+  if (s != "none")
+    error("unknown --call-graph-profile-sort= value: " + s);
+  return CGProfileSortKind::None;
+}
+
 static DiscardPolicy getDiscard(opt::InputArgList &args) {
   auto *arg =
       args.getLastArg(OPT_discard_all, OPT_discard_locals, OPT_discard_none);
@@ -1175,8 +1186,7 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasFlag(OPT_eh_frame_hdr, OPT_no_eh_frame_hdr, false);
   config->emitLLVM = args.hasArg(OPT_plugin_opt_emit_llvm, false);
   config->emitRelocs = args.hasArg(OPT_emit_relocs);
-  config->callGraphProfileSort = args.hasFlag(
-      OPT_call_graph_profile_sort, OPT_no_call_graph_profile_sort, true);
+  config->callGraphProfileSort = getCGProfileSortKind(args);
   config->enableNewDtags =
       args.hasFlag(OPT_enable_new_dtags, OPT_disable_new_dtags, true);
   config->entry = args.getLastArgValue(OPT_entry);
@@ -1589,7 +1599,7 @@ static void readConfigs(opt::InputArgList &args) {
       config->symbolOrderingFile = getSymbolOrderingFile(*buffer);
       // Also need to disable CallGraphProfileSort to prevent
       // LLD order symbols with CGProfile
-      config->callGraphProfileSort = false;
+      config->callGraphProfileSort = CGProfileSortKind::None;
     }
   }
 
@@ -2412,6 +2422,40 @@ static std::vector<WrappedSymbol> addWrappedSymbols(opt::InputArgList &args) {
   return v;
 }
 
+template <class ELFT> static size_t countStrongDefinitions(ELFFileBase *f) {
+  return llvm::count_if(
+      f->getGlobalELFSyms<ELFT>(), [](const typename ELFT::Sym &sym) {
+        return sym.getBinding() == STB_GLOBAL && sym.st_shndx != SHN_UNDEF &&
+               sym.st_shndx != SHN_COMMON;
+      });
+}
+
+// Returns the number of non-weak, non-common symbols defined by the object
+// files which are not lazy. They are all inserted into the symbol table when
+// the files are parsed and (short of duplicate definitions) have distinct
+// names, so this doesn't overestimate the final size of the table even when
+// the same inline functions are defined by many files.
+static size_t estimateNumSymbols(ArrayRef<InputFile *> files) {
+  return parallelTransformReduce(
+      files, size_t(0), std::plus<size_t>(), [](InputFile *file) -> size_t {
+        if (file->kind() != InputFile::ObjKind || file->lazy)
+          return 0;
+        auto *f = cast<ELFFileBase>(file);
+        switch (f->ekind) {
+        case ELF32LEKind:
+          return countStrongDefinitions<ELF32LE>(f);
+        case ELF32BEKind:
+          return countStrongDefinitions<ELF32BE>(f);
+        case ELF64LEKind:
+          return countStrongDefinitions<ELF64LE>(f);
+        case ELF64BEKind:
+          return countStrongDefinitions<ELF64BE>(f);
+        default:
+          return 0;
+        }
+      });
+}
+
 static void combineVersionedSymbol(Symbol &sym,
                                    DenseMap<Symbol *, Symbol *> &map) {
   const char *suffix1 = sym.getVersionSuffix();
@@ -2660,6 +2704,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
   // appended to the Files vector.
   {
     llvm::TimeTraceScope timeScope("Parse input files");
+    symtab.reserve(symtab.getSymbols().size() + estimateNumSymbols(files));
     for (size_t i = 0; i < files.size(); ++i) {
       llvm::TimeTraceScope timeScope("Parse input files", files[i]->getName());
       parseFile(files[i]);
@@ -2981,7 +3026,7 @@ void LinkerDriver::link(opt::InputArgList &args) {
   }
 
   // Read the callgraph now that we know what was gced or icfed
-  if (config->callGraphProfileSort) {
+  if (config->callGraphProfileSort != CGProfileSortKind::None) {
     if (auto *arg = args.getLastArg(OPT_call_graph_ordering_file))
       if (std::optional<MemoryBufferRef> buffer = readFile(arg->getValue()))
         readCallGraph(*buffer);
@@ -516,6 +516,22 @@ template <class ELFT> void ICF<ELFT>::run() {
     return a->eqClass[0] < b->eqClass[0];
   });
 
+  // Identical sections have equal hashes, so a section whose hash is unique
+  // cannot be folded. Leave such sections out of the refinement below, which
+  // would otherwise visit all of them on every iteration. Their classes must
+  // stay the same in both slots because other sections may refer to them.
+  size_t numCandidates = sections.size();
+  SmallVector<InputSection *, 0> candidates;
+  forEachClassRange(0, sections.size(), [&](size_t begin, size_t end) {
+    if (end - begin == 1)
+      sections[begin]->eqClass[1] = sections[begin]->eqClass[0];
+    else
+      candidates.append(sections.begin() + begin, sections.begin() + end);
+  });
+  sections = std::move(candidates);
+  log("ICF: " + Twine(sections.size()) + " of " + Twine(numCandidates) +
+      " sections have non-unique hashes");
+
   // Compare static contents and assign unique equivalence class IDs for each
   // static content. Use a base offset for these IDs to ensure no overlap with
   // the unique IDs already assigned.
@@ -1289,7 +1289,9 @@ void MergeInputSection::splitStrings(StringRef s, size_t entSize) {
   if (!std::all_of(end - entSize, end, [](char c) { return c == 0; }))
     fatal(toString(this) + ": string is not null terminated");
   if (entSize == 1) {
-    // Optimize the common case.
+    // Optimize the common case. Each null byte terminates a string, so count
+    // them to allocate all pieces at once instead of growing the vector.
+    pieces.reserve(std::count(s.begin(), s.end(), '\0'));
     do {
       size_t size = strlen(p);
       pieces.emplace_back(p - s.begin(), xxh3_64bits(StringRef(p, size)), live);
@@ -1126,9 +1126,16 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
     } else if (rel != 0) {
       if (config->emachine == EM_MIPS && rel == target->symbolicRel)
         rel = target->relativeRel;
-      std::lock_guard<std::mutex> lock(relocMutex);
-      sec->getPartition().relaDyn->addSymbolReloc(rel, *sec, offset, sym,
-                                                  addend, type);
+      // With -z combreloc, dynamic relocations are sorted before they are
+      // written, so they can be added to the per-thread vectors without
+      // taking the lock. Otherwise scanning is serial and the order of
+      // the relocations is kept.
+      RelocationBaseSection &relaDyn = *sec->getPartition().relaDyn;
+      if (config->zCombreloc)
+        relaDyn.addReloc<true>(DynamicReloc::AgainstSymbol, rel, *sec, offset,
+                               sym, addend, R_ADDEND, type);
+      else
+        relaDyn.addSymbolReloc(rel, *sec, offset, sym, addend, type);
 
       // MIPS ABI turns using of GOT and dynamic relocations inside out.
       // While regular ABI uses dynamic relocations to fill up GOT entries
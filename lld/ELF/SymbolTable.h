@@ -39,6 +39,13 @@ public:
 
   Symbol *insert(StringRef name);
 
+  // Makes room for n symbols, so that the table isn't grown over and over
+  // while the input files are parsed.
+  void reserve(size_t n) {
+    symMap.reserve(n);
+    symVector.reserve(n);
+  }
+
   template <typename T> Symbol *addSymbol(const T &newSym) {
     Symbol *sym = insert(newSym.getName());
     sym->resolve(newSym);
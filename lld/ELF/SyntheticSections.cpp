@@ -2781,7 +2781,7 @@ readPubNamesAndTypes(const LLDDwarfObj<ELFT> &obj,
 // by uniquifying them by name.
 static std::pair<SmallVector<GdbIndexSection::GdbSymbol, 0>, size_t>
 createSymbols(
-    ArrayRef<SmallVector<GdbIndexSection::NameAttrEntry, 0>> nameAttrs,
+    MutableArrayRef<SmallVector<GdbIndexSection::NameAttrEntry, 0>> nameAttrs,
     const SmallVector<GdbIndexSection::GdbChunk, 0> &chunks) {
   using GdbSymbol = GdbIndexSection::GdbSymbol;
   using NameAttrEntry = GdbIndexSection::NameAttrEntry;
@@ -2831,6 +2831,12 @@ createSymbols(
     }
   });
 
+  // The names are referenced by the symbols now. Free the entries and the
+  // maps before the symbols are flattened to keep the peak memory usage low.
+  for (SmallVector<NameAttrEntry, 0> &entries : nameAttrs)
+    SmallVector<NameAttrEntry, 0>().swap(entries);
+  map.reset();
+
   size_t numSymbols = 0;
   for (ArrayRef<GdbSymbol> v : ArrayRef(symbols.get(), numShards))
     numSymbols += v.size();
@@ -2840,9 +2846,11 @@ createSymbols(
   SmallVector<GdbSymbol, 0> ret;
   ret.reserve(numSymbols);
   for (SmallVector<GdbSymbol, 0> &vec :
-       MutableArrayRef(symbols.get(), numShards))
+       MutableArrayRef(symbols.get(), numShards)) {
     for (GdbSymbol &sym : vec)
       ret.push_back(std::move(sym));
+    SmallVector<GdbSymbol, 0>().swap(vec);
+  }
 
   // CU vectors and symbol names are adjacent in the output file.
   // We can compute their offsets in the output file now.
@@ -2860,7 +2868,7 @@ createSymbols(
     errorOrWarn("--gdb-index: constant pool size (" + Twine(off) +
                 ") exceeds UINT32_MAX");
 
-  return {ret, off};
+  return {std::move(ret), off};
 }
 
 // Returns a newly-created .gdb_index section.
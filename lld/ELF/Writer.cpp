@@ -1227,8 +1227,11 @@ static void maybeShuffle(DenseMap<const InputSectionBase *, int> &order) {
 static DenseMap<const InputSectionBase *, int> buildSectionOrder() {
   DenseMap<const InputSectionBase *, int> sectionOrder;
   // Use the rarely used option --call-graph-ordering-file to sort sections.
-  if (!config->callGraphProfile.empty())
+  if (!config->callGraphProfile.empty()) {
+    if (config->callGraphProfileSort == CGProfileSortKind::Cdsort)
+      return computeCacheDirectedSortOrder();
     return computeCallGraphProfileOrder();
+  }
 
   if (config->symbolOrderingFile.empty())
     return sectionOrder;
@@ -22,6 +22,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/BinaryFormat/MachO.h"
 #include "llvm/Support/Parallel.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include "mach-o/compact_unwind_encoding.h"
 
@@ -439,6 +440,7 @@ static bool canFoldEncoding(compact_unwind_encoding_t encoding) {
 void UnwindInfoSectionImpl::finalize() {
   if (symbols.empty())
     return;
+  TimeTraceScope timeScope("Finalize unwind info");
 
   // At this point, the address space for __TEXT,__text has been
   // assigned, so we can relocate the __LD,__compact_unwind entries
@@ -458,7 +460,7 @@ void UnwindInfoSectionImpl::finalize() {
   // vector of indices to entries and sort & fold that instead.
   cuIndices.resize(cuEntries.size());
   std::iota(cuIndices.begin(), cuIndices.end(), 0);
-  llvm::sort(cuIndices, [&](size_t a, size_t b) {
+  parallelSort(cuIndices, [&](size_t a, size_t b) {
     return cuEntries[a].functionAddress < cuEntries[b].functionAddress;
   });
 
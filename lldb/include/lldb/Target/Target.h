@@ -97,6 +97,8 @@ public:
 
   void SetPreloadSymbols(bool b);
 
+  bool GetParallelModuleLoad() const;
+
   bool GetDisableASLR() const;
 
   void SetDisableASLR(bool b);
@@ -599,6 +601,25 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Create the Modules of several binaries in parallel, without adding them
+  /// to the Target.
+  ///
+  /// Creating a Module parses its object file and preloads its symbols,
+  /// which is what takes time when loading many binaries. The Modules are
+  /// kept in the shared module cache, so that adding them to the Target
+  /// afterwards with GetOrCreateModule is quick and can be done in order,
+  /// notifying the listeners as if they had been created one at a time.
+  ///
+  /// \param[in] module_specs
+  ///     The criteria that must be matched for each binary.
+  ///
+  /// \return
+  ///     The Modules found for each of the \a module_specs, an empty
+  ///     ModuleSP for the ones which weren't found. The Modules are only
+  ///     guaranteed to stay in the shared module cache while they are kept.
+  std::vector<lldb::ModuleSP>
+  PrepareModules(llvm::ArrayRef<ModuleSpec> module_specs);
+
   // Settings accessors
 
   static TargetProperties &GetGlobalProperties();
@@ -1612,6 +1633,16 @@ private:
   // Helper function.
   bool ProcessIsValid();
 
+  /// Find or create the Module of a binary in the shared module cache, trying
+  /// the image search paths, the global module list and the platform in the
+  /// order GetOrCreateModule does. The target's own module list and the
+  /// locate module callback are not consulted.
+  Status GetSharedModule(const ModuleSpec &module_spec,
+                         lldb::ModuleSP &module_sp,
+                         const FileSpecList &search_paths,
+                         llvm::SmallVectorImpl<lldb::ModuleSP> *old_modules,
+                         bool *did_create_module);
+
   // Copy breakpoints, stop hooks and so forth from the dummy target:
   void PrimeFromDummyTarget(Target &target);
 
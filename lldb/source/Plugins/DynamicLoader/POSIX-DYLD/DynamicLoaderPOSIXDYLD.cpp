@@ -644,6 +644,21 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
+  // Creating the modules, which includes preloading their symbols, dominates
+  // the time it takes to attach to a process or to load a core file with many
+  // shared libraries. The modules don't depend on each other, so create them
+  // in parallel first. They are still added to the target and their sections
+  // loaded below in the order of the link map, so that the target's module
+  // list and its notifications are the same as when loading them serially.
+  std::vector<ModuleSP> prepared_modules;
+  Target &target = m_process->GetTarget();
+  if (target.GetParallelModuleLoad()) {
+    std::vector<ModuleSpec> module_specs;
+    for (const FileSpec &module_name : module_names)
+      module_specs.emplace_back(module_name, target.GetArchitecture());
+    prepared_modules = target.PrepareModules(module_specs);
+  }
+
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
         LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
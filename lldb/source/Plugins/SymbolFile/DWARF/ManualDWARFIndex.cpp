@@ -79,18 +79,27 @@ void ManualDWARFIndex::Index() {
       total_progress);
 
   std::vector<IndexSet> sets(units_to_index.size());
+  // Units whose index was loaded from the cache of their .dwo file don't need
+  // to be extracted or indexed again.
+  std::vector<uint8_t> loaded_from_cache(units_to_index.size(), false);
 
   // Keep memory down by clearing DIEs for any units if indexing
   // caused us to load the unit's DIEs.
   std::vector<std::optional<DWARFUnit::ScopedExtractDIEs>> clear_cu_dies(
       units_to_index.size());
   auto parser_fn = [&](size_t cu_idx) {
-    IndexUnit(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]);
+    if (!loaded_from_cache[cu_idx]) {
+      IndexUnit(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]);
+      SaveDwoToCache(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]);
+    }
     progress.Increment();
   };
 
   auto extract_fn = [&](size_t cu_idx) {
-    clear_cu_dies[cu_idx] = units_to_index[cu_idx]->ExtractDIEsScoped();
+    if (LoadDwoFromCache(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]))
+      loaded_from_cache[cu_idx] = true;
+    else
+      clear_cu_dies[cu_idx] = units_to_index[cu_idx]->ExtractDIEsScoped();
     progress.Increment();
   };
 
@@ -735,3 +744,97 @@ void ManualDWARFIndex::SaveToCache() {
       m_dwarf->SetDebugInfoIndexWasSavedToCache();
   }
 }
+
+// Returns the .dwo file holding the split unit of the given skeleton unit, or
+// null if the unit isn't a skeleton unit or its split unit lives in the .dwp
+// file, which is indexed as part of the main file.
+static SymbolFileDWARFDwo *GetSeparateDwo(DWARFUnit &unit,
+                                          SymbolFileDWARFDwo *dwp) {
+  if (!unit.GetDWOId())
+    return nullptr;
+  SymbolFileDWARFDwo *dwo = unit.GetDwoSymbolFile();
+  if (!dwo || dwo == dwp)
+    return nullptr;
+  return dwo;
+}
+
+std::string ManualDWARFIndex::GetDwoCacheKey(SymbolFileDWARFDwo &dwo) {
+  std::string key;
+  llvm::raw_string_ostream strm(key);
+  ObjectFile *objfile = dwo.GetObjectFile();
+  strm << m_dwarf->GetObjectFile()->GetModule()->GetCacheKey()
+       << "-dwarf-index-dwo-" << llvm::format_hex(objfile->GetCacheHash(), 10);
+  return strm.str();
+}
+
+bool ManualDWARFIndex::LoadDwoFromCache(DWARFUnit &unit,
+                                        SymbolFileDWARFDwo *dwp,
+                                        IndexSet &set) {
+  DataFileCache *cache = Module::GetIndexCache();
+  if (!cache)
+    return false;
+  SymbolFileDWARFDwo *dwo = GetSeparateDwo(unit, dwp);
+  if (!dwo || !dwo->GetObjectFile())
+    return false;
+  const std::string key = GetDwoCacheKey(*dwo);
+  std::unique_ptr<llvm::MemoryBuffer> mem_buffer_up =
+      cache->GetCachedData(key);
+  if (!mem_buffer_up)
+    return false;
+  ObjectFile *objfile = dwo->GetObjectFile();
+  DataExtractor data(mem_buffer_up->getBufferStart(),
+                     mem_buffer_up->getBufferSize(),
+                     endian::InlHostByteOrder(),
+                     objfile->GetAddressByteSize());
+  bool stale = false;
+  if (DecodeDwoIndex(data, CacheSignature(objfile), unit.GetID(), set, stale))
+    return true;
+  if (stale)
+    cache->RemoveCacheFile(key);
+  return false;
+}
+
+void ManualDWARFIndex::SaveDwoToCache(DWARFUnit &unit,
+                                      SymbolFileDWARFDwo *dwp,
+                                      const IndexSet &set) {
+  DataFileCache *cache = Module::GetIndexCache();
+  if (!cache)
+    return; // Caching is not enabled.
+  SymbolFileDWARFDwo *dwo = GetSeparateDwo(unit, dwp);
+  if (!dwo || !dwo->GetObjectFile())
+    return;
+  ObjectFile *objfile = dwo->GetObjectFile();
+  DataEncoder file(endian::InlHostByteOrder(), objfile->GetAddressByteSize());
+  if (EncodeDwoIndex(file, CacheSignature(objfile), unit.GetID(), set))
+    cache->SetCachedData(GetDwoCacheKey(*dwo), file.GetData());
+}
+
+bool ManualDWARFIndex::EncodeDwoIndex(DataEncoder &encoder,
+                                      const CacheSignature &signature,
+                                      uint64_t skeleton_id,
+                                      const IndexSet &set) {
+  if (!signature.Encode(encoder))
+    return false;
+  encoder.AppendU64(skeleton_id);
+  set.Encode(encoder);
+  return true;
+}
+
+bool ManualDWARFIndex::DecodeDwoIndex(const DataExtractor &data,
+                                      const CacheSignature &signature,
+                                      uint64_t skeleton_id, IndexSet &set,
+                                      bool &stale) {
+  stale = false;
+  lldb::offset_t offset = 0;
+  CacheSignature cached_signature;
+  if (!cached_signature.Decode(data, &offset))
+    return false;
+  // The DIERefs in the index refer to the .dwo file by the index of its
+  // skeleton unit, so the entry is stale if either the .dwo file changed or
+  // the skeleton unit moved.
+  if (cached_signature != signature || data.GetU64(&offset) != skeleton_id) {
+    stale = true;
+    return false;
+  }
+  return set.Decode(data, &offset);
+}
@@ -17,6 +17,8 @@ class DWARFDebugInfo;
 class SymbolFileDWARFDwo;
 
 namespace lldb_private {
+struct CacheSignature;
+
 class ManualDWARFIndex : public DWARFIndex {
 public:
   ManualDWARFIndex(Module &module, SymbolFileDWARF &dwarf,
@@ -78,6 +80,33 @@ public:
     }
   };
 
+  /// Encode the cached index of a single .dwo file.
+  ///
+  /// \param signature
+  ///   The signature of the .dwo file.
+  ///
+  /// \param skeleton_id
+  ///   The ID of the skeleton unit of the .dwo file. The DIERefs in the index
+  ///   refer to the .dwo file by it.
+  ///
+  /// \return
+  ///   True if the signature is valid and the entry was encoded.
+  static bool EncodeDwoIndex(DataEncoder &encoder,
+                             const CacheSignature &signature,
+                             uint64_t skeleton_id, const IndexSet &set);
+
+  /// Decode the cached index of a single .dwo file, see EncodeDwoIndex().
+  ///
+  /// \param stale
+  ///   Set if the entry doesn't match the given signature and skeleton ID,
+  ///   i.e. if the .dwo file changed or its skeleton unit moved.
+  ///
+  /// \return
+  ///   True if the entry is up to date and was decoded into \a set.
+  static bool DecodeDwoIndex(const DataExtractor &data,
+                             const CacheSignature &signature,
+                             uint64_t skeleton_id, IndexSet &set, bool &stale);
+
 private:
   void Index();
 
@@ -159,6 +188,29 @@ private:
   ///   false if the symbol table wasn't cached or was out of date.
   bool LoadFromCache();
 
+  /// Get the cache key for the index of a single .dwo file.
+  ///
+  /// Split DWARF builds relink the executable whenever any of its compile
+  /// units changes, which invalidates the cached index of the whole module.
+  /// The index of each .dwo file is cached on its own as well, so that only
+  /// the .dwo files which changed since have to be indexed again.
+  std::string GetDwoCacheKey(SymbolFileDWARFDwo &dwo);
+
+  /// Load the index of the .dwo file of the given skeleton unit from the index
+  /// cache.
+  ///
+  /// \return
+  ///   True if the unit's split unit lives in a separate .dwo file whose
+  ///   index was cached and is up to date, false otherwise.
+  bool LoadDwoFromCache(DWARFUnit &unit, SymbolFileDWARFDwo *dwp,
+                        IndexSet &set);
+
+  /// Save the index of the .dwo file of the given skeleton unit to the index
+  /// cache. Does nothing if caching is disabled or if the unit's split unit
+  /// doesn't live in a separate .dwo file.
+  void SaveDwoToCache(DWARFUnit &unit, SymbolFileDWARFDwo *dwp,
+                      const IndexSet &set);
+
   void IndexUnit(DWARFUnit &unit, SymbolFileDWARFDwo *dwp, IndexSet &set);
 
   static void IndexUnitImpl(DWARFUnit &unit,
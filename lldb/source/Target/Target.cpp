@@ -65,6 +65,7 @@
 
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/ThreadPool.h"
 
 #include <memory>
 #include <mutex>
@@ -2110,6 +2111,56 @@ bool Target::ReadPointerFromMemory(const Address &addr, Status &error,
   return false;
 }
 
+Status Target::GetSharedModule(
+    const ModuleSpec &module_spec, ModuleSP &module_sp,
+    const FileSpecList &search_paths,
+    llvm::SmallVectorImpl<ModuleSP> *old_modules, bool *did_create_module) {
+  Status error;
+  // If there are image search path entries, try to use them to acquire a
+  // suitable image.
+  if (m_image_search_paths.GetSize()) {
+    ModuleSpec transformed_spec(module_spec);
+    ConstString transformed_dir;
+    if (m_image_search_paths.RemapPath(
+            module_spec.GetFileSpec().GetDirectory(), transformed_dir)) {
+      transformed_spec.GetFileSpec().SetDirectory(transformed_dir);
+      transformed_spec.GetFileSpec().SetFilename(
+          module_spec.GetFileSpec().GetFilename());
+      error = ModuleList::GetSharedModule(transformed_spec, module_sp,
+                                          &search_paths, old_modules,
+                                          did_create_module);
+    }
+  }
+  if (module_sp)
+    return error;
+
+  // If we have a UUID, we can check our global shared module list in case
+  // we already have it. If we don't have a valid UUID, then we can't since
+  // the path in "module_spec" will be a platform path, and we will need to
+  // let the platform find that file. For example, we could be asking for
+  // "/usr/lib/dyld" and if we do not have a UUID, we don't want to pick
+  // the local copy of "/usr/lib/dyld" since our platform could be a remote
+  // platform that has its own "/usr/lib/dyld" in an SDK or in a local file
+  // cache.
+  if (module_spec.GetUUID().IsValid()) {
+    // We have a UUID, it is OK to check the global module list...
+    error = ModuleList::GetSharedModule(module_spec, module_sp, &search_paths,
+                                        old_modules, did_create_module);
+  }
+  if (module_sp)
+    return error;
+
+  // The platform is responsible for finding and caching an appropriate
+  // module in the shared module cache.
+  if (m_platform_sp)
+    error = m_platform_sp->GetSharedModule(module_spec, m_process_sp.get(),
+                                           module_sp, &search_paths,
+                                           old_modules, did_create_module);
+  else
+    error.SetErrorString("no platform is currently set");
+  return error;
+}
+
 ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr) {
   ModuleSP module_sp;
@@ -2156,52 +2207,9 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
     //      or something went wrong. We continue to find a module file for this
     //      module_spec.
 
-    if (!module_sp) {
-      // If there are image search path entries, try to use them to acquire a
-      // suitable image.
-      if (m_image_search_paths.GetSize()) {
-        ModuleSpec transformed_spec(module_spec);
-        ConstString transformed_dir;
-        if (m_image_search_paths.RemapPath(
-                module_spec.GetFileSpec().GetDirectory(), transformed_dir)) {
-          transformed_spec.GetFileSpec().SetDirectory(transformed_dir);
-          transformed_spec.GetFileSpec().SetFilename(
-                module_spec.GetFileSpec().GetFilename());
-          error = ModuleList::GetSharedModule(transformed_spec, module_sp,
-                                              &search_paths, &old_modules,
-                                              &did_create_module);
-        }
-      }
-    }
-
-    if (!module_sp) {
-      // If we have a UUID, we can check our global shared module list in case
-      // we already have it. If we don't have a valid UUID, then we can't since
-      // the path in "module_spec" will be a platform path, and we will need to
-      // let the platform find that file. For example, we could be asking for
-      // "/usr/lib/dyld" and if we do not have a UUID, we don't want to pick
-      // the local copy of "/usr/lib/dyld" since our platform could be a remote
-      // platform that has its own "/usr/lib/dyld" in an SDK or in a local file
-      // cache.
-      if (module_spec.GetUUID().IsValid()) {
-        // We have a UUID, it is OK to check the global module list...
-        error =
-            ModuleList::GetSharedModule(module_spec, module_sp, &search_paths,
-                                        &old_modules, &did_create_module);
-      }
-
-      if (!module_sp) {
-        // The platform is responsible for finding and caching an appropriate
-        // module in the shared module cache.
-        if (m_platform_sp) {
-          error = m_platform_sp->GetSharedModule(
-              module_spec, m_process_sp.get(), module_sp, &search_paths,
-              &old_modules, &did_create_module);
-        } else {
-          error.SetErrorString("no platform is currently set");
-        }
-      }
-    }
+    if (!module_sp)
+      error = GetSharedModule(module_spec, module_sp, search_paths,
+                              &old_modules, &did_create_module);
 
     // We found a module that wasn't in our target list.  Let's make sure that
     // there wasn't an equivalent module in the list already, and if there was,
@@ -2340,6 +2348,41 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
   return module_sp;
 }
 
+std::vector<ModuleSP>
+Target::PrepareModules(llvm::ArrayRef<ModuleSpec> module_specs) {
+  std::vector<ModuleSP> modules(module_specs.size());
+  // The locate module callback is user code, which expects to be called for
+  // one module at a time, in the order they are added.
+  if (!m_platform_sp || m_platform_sp->GetLocateModuleCallback())
+    return modules;
+
+  const FileSpecList search_paths = GetExecutableSearchPaths();
+  const bool preload_symbols = GetPreloadSymbols();
+  auto prepare_module = [&](size_t idx) {
+    const ModuleSpec &module_spec = module_specs[idx];
+    ModuleSP module_sp;
+    if (module_spec.GetUUID().IsValid())
+      module_sp = m_images.FindFirstModule(module_spec);
+    if (module_sp) {
+      modules[idx] = std::move(module_sp);
+      return;
+    }
+    // Look the module up the way GetOrCreateModule will, so that it finds
+    // the prepared module in the shared module cache.
+    GetSharedModule(module_spec, module_sp, search_paths,
+                    /*old_modules=*/nullptr, /*did_create_module=*/nullptr);
+    if (module_sp && preload_symbols)
+      module_sp->PreloadSymbols();
+    modules[idx] = std::move(module_sp);
+  };
+
+  llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+  for (size_t idx = 0; idx < module_specs.size(); ++idx)
+    task_group.async(prepare_module, idx);
+  task_group.wait();
+  return modules;
+}
+
 TargetSP Target::CalculateTarget() { return shared_from_this(); }
 
 ProcessSP Target::CalculateProcess() { return m_process_sp; }
@@ -4251,6 +4294,12 @@ void TargetProperties::SetPreloadSymbols(bool b) {
   SetPropertyAtIndex(idx, b);
 }
 
+bool TargetProperties::GetParallelModuleLoad() const {
+  const uint32_t idx = ePropertyParallelModuleLoad;
+  return GetPropertyAtIndexAs<bool>(
+      idx, g_target_properties[idx].default_uint_value != 0);
+}
+
 bool TargetProperties::GetDisableASLR() const {
   const uint32_t idx = ePropertyDisableASLR;
   return GetPropertyAtIndexAs<bool>(
@@ -289,3 +289,61 @@ TEST(DWARFIndexCachingTest, CacheSignatureTests) {
   EXPECT_FALSE(sig.Decode(data, &data_offset));
 
 }
+
+static bool DecodeDwoIndex(const DataEncoder &encoder,
+                           const CacheSignature &sig, uint64_t skeleton_id,
+                           ManualDWARFIndex::IndexSet &set, bool &stale) {
+  llvm::ArrayRef<uint8_t> bytes = encoder.GetData();
+  DataExtractor data(bytes.data(), bytes.size(), eByteOrderLittle,
+                     /*addr_size=*/8);
+  return ManualDWARFIndex::DecodeDwoIndex(data, sig, skeleton_id, set, stale);
+}
+
+TEST(DWARFIndexCachingTest, ManualDWARFIndexDwoIndexEncodeDecode) {
+  ManualDWARFIndex::IndexSet set;
+  set.function_basenames.Insert(
+      ConstString("a"), DIERef(7, DIERef::Section::DebugInfo, 0x11223344));
+  set.types.Insert(ConstString("b"),
+                   DIERef(7, DIERef::Section::DebugInfo, 0x55667788));
+  const uint64_t skeleton_id = 7;
+
+  CacheSignature sig;
+  sig.m_uuid = UUID("@\x00\x11\x22\x33\x44\x55\x66\x77", 8);
+  sig.m_mod_time = 0x12345678;
+
+  // Entries can't be created without a valid signature of the .dwo file.
+  DataEncoder invalid_encoder(eByteOrderLittle, /*addr_size=*/8);
+  EXPECT_FALSE(ManualDWARFIndex::EncodeDwoIndex(
+      invalid_encoder, CacheSignature(), skeleton_id, set));
+
+  DataEncoder encoder(eByteOrderLittle, /*addr_size=*/8);
+  ASSERT_TRUE(
+      ManualDWARFIndex::EncodeDwoIndex(encoder, sig, skeleton_id, set));
+
+  // An up to date entry is a cache hit.
+  ManualDWARFIndex::IndexSet decoded;
+  bool stale = true;
+  EXPECT_TRUE(DecodeDwoIndex(encoder, sig, skeleton_id, decoded, stale));
+  EXPECT_FALSE(stale);
+  EXPECT_EQ(set, decoded);
+
+  // The entry is stale once the .dwo file changed...
+  CacheSignature modified_sig = sig;
+  modified_sig.m_mod_time = 0x12345679;
+  ManualDWARFIndex::IndexSet unused;
+  EXPECT_FALSE(DecodeDwoIndex(encoder, modified_sig, skeleton_id, unused,
+                              stale));
+  EXPECT_TRUE(stale);
+
+  // ...or once its skeleton unit moved, the DIERefs would be wrong.
+  stale = false;
+  EXPECT_FALSE(DecodeDwoIndex(encoder, sig, skeleton_id + 1, unused, stale));
+  EXPECT_TRUE(stale);
+
+  // A corrupted entry is a miss, but not stale.
+  DataEncoder corrupted(eByteOrderLittle, /*addr_size=*/8);
+  corrupted.AppendU8(255); // eSignatureEnd
+  stale = true;
+  EXPECT_FALSE(DecodeDwoIndex(corrupted, sig, skeleton_id, unused, stale));
+  EXPECT_FALSE(stale);
+}
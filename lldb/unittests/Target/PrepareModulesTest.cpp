@@ -0,0 +1,133 @@
+//===-- PrepareModulesTest.cpp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "Plugins/SymbolFile/Symtab/SymbolFileSymtab.h"
+#include "TestingSupport/SubsystemRAII.h"
+#include "TestingSupport/TestUtilities.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Target.h"
+#include "llvm/Support/FileSystem.h"
+#include "gtest/gtest.h"
+
+#include <mutex>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::platform_linux;
+
+namespace {
+
+constexpr llvm::StringLiteral k_module_file("TestModule.so");
+constexpr size_t k_num_modules = 4;
+
+std::once_flag debugger_initialize_flag;
+
+class PrepareModulesTest : public testing::Test {
+  SubsystemRAII<FileSystem, HostInfo, ObjectFileELF, PlatformLinux,
+                SymbolFileSymtab>
+      subsystems;
+
+public:
+  void SetUp() override {
+    std::call_once(debugger_initialize_flag,
+                   []() { Debugger::Initialize(nullptr); });
+
+    FileSpec module_file(GetInputFilePath(k_module_file));
+    ModuleSpecList specs;
+    ASSERT_GE(ObjectFile::GetModuleSpecifications(module_file, 0, 0, specs),
+              1u);
+    ModuleSpec spec;
+    ASSERT_TRUE(specs.GetModuleSpecAtIndex(0, spec));
+    m_arch = spec.GetArchitecture();
+
+    // Copies of the same binary at different paths are different modules.
+    const auto *info = testing::UnitTest::GetInstance()->current_test_info();
+    FileSpec test_dir = HostInfo::GetProcessTempDir();
+    test_dir.AppendPathComponent(std::string(info->test_case_name()) + "-" +
+                                 info->name());
+    ASSERT_FALSE(llvm::sys::fs::create_directory(test_dir.GetPath()));
+    for (size_t i = 0; i < k_num_modules; ++i) {
+      FileSpec copy(test_dir);
+      copy.AppendPathComponent("lib" + std::to_string(i) + ".so");
+      ASSERT_FALSE(
+          llvm::sys::fs::copy_file(module_file.GetPath(), copy.GetPath()));
+      m_module_specs.emplace_back(copy, m_arch);
+    }
+
+    Platform::SetHostPlatform(PlatformLinux::CreateInstance(true, &m_arch));
+    m_debugger_sp = Debugger::CreateInstance();
+    ASSERT_TRUE(m_debugger_sp);
+    PlatformSP platform_sp = Platform::GetHostPlatform();
+    m_debugger_sp->GetTargetList().CreateTarget(
+        *m_debugger_sp, "", m_arch, eLoadDependentsNo, platform_sp,
+        m_target_sp);
+    ASSERT_TRUE(m_target_sp);
+  }
+
+  void TearDown() override {
+    for (ModuleSP &module_sp : m_modules)
+      if (module_sp)
+        ModuleList::RemoveSharedModule(module_sp);
+    if (m_debugger_sp)
+      Debugger::Destroy(m_debugger_sp);
+  }
+
+protected:
+  ArchSpec m_arch;
+  std::vector<ModuleSpec> m_module_specs;
+  std::vector<ModuleSP> m_modules;
+  DebuggerSP m_debugger_sp;
+  TargetSP m_target_sp;
+};
+
+} // namespace
+
+TEST_F(PrepareModulesTest, AddsPreparedModulesInOrder) {
+  std::vector<ModuleSpec> specs = m_module_specs;
+  FileSpec missing = specs.front().GetFileSpec();
+  missing.SetFilename("missing.so");
+  specs.emplace_back(missing, m_arch);
+
+  m_modules = m_target_sp->PrepareModules(specs);
+  ASSERT_EQ(m_modules.size(), specs.size());
+  // Nothing is added to the target, nor are its listeners notified.
+  EXPECT_EQ(m_target_sp->GetImages().GetSize(), 0u);
+  for (size_t i = 0; i < k_num_modules; ++i) {
+    ASSERT_TRUE(m_modules[i]);
+    EXPECT_EQ(m_modules[i]->GetFileSpec(), specs[i].GetFileSpec());
+  }
+  EXPECT_FALSE(m_modules.back());
+
+  // Adding the modules finds the prepared ones, and the module list of the
+  // target follows the order they are added in.
+  for (size_t i = k_num_modules; i-- > 0;)
+    EXPECT_EQ(m_target_sp->GetOrCreateModule(specs[i], /*notify=*/false),
+              m_modules[i]);
+  const ModuleList &images = m_target_sp->GetImages();
+  ASSERT_EQ(images.GetSize(), k_num_modules);
+  for (size_t i = 0; i < k_num_modules; ++i)
+    EXPECT_EQ(images.GetModuleAtIndex(i), m_modules[k_num_modules - 1 - i]);
+}
+
+TEST_F(PrepareModulesTest, ReturnsModulesOfTheTarget) {
+  ModuleSP added_sp =
+      m_target_sp->GetOrCreateModule(m_module_specs[1], /*notify=*/false);
+  ASSERT_TRUE(added_sp);
+
+  m_modules = m_target_sp->PrepareModules(m_module_specs);
+  ASSERT_EQ(m_modules.size(), k_num_modules);
+  EXPECT_EQ(m_modules[1], added_sp);
+  EXPECT_EQ(m_target_sp->GetImages().GetSize(), 1u);
+}
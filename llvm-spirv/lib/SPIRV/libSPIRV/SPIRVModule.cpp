@@ -1910,7 +1910,25 @@ spv_ostream &operator<<(spv_ostream &O, const TopologicalSort &S) {
   return O;
 }
 
+/// \return true if a binary module is read from or written to \p Buf, which
+/// must be done through a SPIRVBinaryBuffer.
+static bool needsBinaryBuffer(std::streambuf *Buf) {
+#ifdef _SPIRV_SUPPORT_TEXT_FMT
+  if (SPIRVUseTextFormat)
+    return false;
+#endif
+  return !dynamic_cast<SPIRVBinaryBuffer *>(Buf);
+}
+
 spv_ostream &operator<<(spv_ostream &O, SPIRVModule &M) {
+  if (needsBinaryBuffer(O.rdbuf())) {
+    SPIRVBinaryBuffer Buf;
+    spv_ostream BufOS(&Buf);
+    BufOS << M;
+    Buf.writeTo(O);
+    return O;
+  }
+
   SPIRVModuleImpl &MI = *static_cast<SPIRVModuleImpl *>(&M);
   // Start tracking of the current line with no line
   MI.CurrentLine.reset();
@@ -2089,6 +2107,15 @@ static std::string to_string(VersionNumber Version) {
 }
 
 std::istream &operator>>(std::istream &I, SPIRVModule &M) {
+  if (needsBinaryBuffer(I.rdbuf())) {
+    SPIRVBinaryBuffer Buf;
+    Buf.readFrom(I);
+    std::istream BufIS(&Buf);
+    BufIS >> M;
+    I.setstate(BufIS.rdstate());
+    return I;
+  }
+
   SPIRVDecoder Decoder(I, M);
   SPIRVModuleImpl &MI = *static_cast<SPIRVModuleImpl *>(&M);
   // Disable automatic capability filling.
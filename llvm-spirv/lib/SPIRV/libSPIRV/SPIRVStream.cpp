@@ -43,6 +43,7 @@
 #include "SPIRVNameMapEnum.h"
 #include "SPIRVOpCode.h"
 
+#include <algorithm>
 #include <limits> // std::numeric_limits
 
 namespace SPIRV {
@@ -158,16 +159,26 @@ const SPIRVDecoder &operator>>(const SPIRVDecoder &I, std::string &Str) {
   }
 #endif
 
+  if (!I.IS.good()) {
+    I.IS.setstate(std::ios_base::failbit);
+    return I;
+  }
+  std::streambuf *Buf = I.IS.rdbuf();
+  using Traits = std::streambuf::traits_type;
   uint64_t Count = 0;
-  char Ch;
-  while (I.IS.get(Ch) && Ch != '\0') {
-    Str += Ch;
+  Traits::int_type Ch;
+  while ((Ch = Buf->sbumpc()) != Traits::eof() && Ch != '\0') {
+    Str += Traits::to_char_type(Ch);
     ++Count;
   }
+  if (Ch == Traits::eof()) {
+    I.IS.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+    return I;
+  }
   Count = (Count + 1) % 4;
   Count = Count ? 4 - Count : 0;
   for (; Count; --Count) {
-    I.IS >> Ch;
+    Ch = Buf->sbumpc();
     assert(Ch == '\0' && "Invalid string in SPIRV");
   }
   SPIRVDBG(spvdbgs() << "Read string: \"" << Str << "\"\n");
@@ -186,12 +197,67 @@ const SPIRVEncoder &operator<<(const SPIRVEncoder &O, const std::string &Str) {
 #endif
 
   size_t L = Str.length();
-  O.OS.write(Str.c_str(), L);
+  std::streambuf *Buf = O.OS.rdbuf();
   char Zeros[4] = {0, 0, 0, 0};
-  O.OS.write(Zeros, 4 - L % 4);
+  std::streamsize PadSize = 4 - L % 4;
+  if (Buf->sputn(Str.c_str(), L) != static_cast<std::streamsize>(L) ||
+      Buf->sputn(Zeros, PadSize) != PadSize)
+    O.OS.setstate(std::ios_base::badbit);
   return O;
 }
 
+void SPIRVBinaryBuffer::readFrom(std::istream &IS) {
+  std::streambuf *Src = IS.rdbuf();
+  size_t Size = 0;
+  std::streamsize Read;
+  do {
+    Data.resize(std::max<size_t>(Data.size() * 2, 1 << 16));
+    std::streamsize Capacity = Data.size() - Size;
+    Read = Src->sgetn(Data.data() + Size, Capacity);
+    Size += Read;
+  } while (Size == Data.size());
+  Data.resize(Size);
+  setg(Data.data(), Data.data(), Data.data() + Size);
+  IS.setstate(std::ios_base::eofbit);
+}
+
+void SPIRVBinaryBuffer::writeTo(spv_ostream &OS) const {
+  OS.write(Data.data(), Data.size());
+}
+
+SPIRVBinaryBuffer::int_type SPIRVBinaryBuffer::overflow(int_type C) {
+  if (!traits_type::eq_int_type(C, traits_type::eof()))
+    Data.push_back(traits_type::to_char_type(C));
+  return traits_type::not_eof(C);
+}
+
+std::streamsize SPIRVBinaryBuffer::xsputn(const char *S, std::streamsize N) {
+  Data.insert(Data.end(), S, S + N);
+  return N;
+}
+
+SPIRVBinaryBuffer::pos_type
+SPIRVBinaryBuffer::seekoff(off_type Off, std::ios_base::seekdir Dir,
+                           std::ios_base::openmode Which) {
+  // Only decoding seeks, to look ahead for continued instructions.
+  if (!(Which & std::ios_base::in))
+    return pos_type(off_type(-1));
+  off_type Pos = Off;
+  if (Dir == std::ios_base::cur)
+    Pos += gptr() - eback();
+  else if (Dir == std::ios_base::end)
+    Pos += egptr() - eback();
+  if (Pos < 0 || Pos > egptr() - eback())
+    return pos_type(off_type(-1));
+  setg(eback(), eback() + Pos, egptr());
+  return pos_type(Pos);
+}
+
+SPIRVBinaryBuffer::pos_type
+SPIRVBinaryBuffer::seekpos(pos_type Pos, std::ios_base::openmode Which) {
+  return seekoff(off_type(Pos), std::ios_base::beg, Which);
+}
+
 bool SPIRVDecoder::getWordCountAndOpCode() {
   if (IS.eof()) {
     WordCount = 0;
@@ -46,7 +46,9 @@
 #include <cctype>
 #include <cstdint>
 #include <iostream>
+#include <streambuf>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace SPIRV {
@@ -93,15 +95,60 @@ public:
   spv_ostream &OS;
 };
 
+/// Contiguous memory backing of a SPIR-V binary.
+///
+/// A module is encoded into the buffer and written to the output stream at
+/// once, and a binary is read from the input stream at once and decoded from
+/// the buffer. Encoding and decoding then work on a word array instead of
+/// going through the formatted stream and its underlying stream buffer for
+/// each word.
+class SPIRVBinaryBuffer : public std::streambuf {
+public:
+  /// Reads the rest of \p IS to decode it from the buffer.
+  void readFrom(std::istream &IS);
+  /// Writes everything encoded into the buffer to \p OS.
+  void writeTo(spv_ostream &OS) const;
+
+protected:
+  int_type overflow(int_type C) override;
+  std::streamsize xsputn(const char *S, std::streamsize N) override;
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override;
+  pos_type seekpos(pos_type Pos, std::ios_base::openmode Which) override;
+
+private:
+  std::vector<char> Data;
+};
+
 /// Output a new line in text mode. Do nothing in binary mode.
 class SPIRVNL {
   friend spv_ostream &operator<<(spv_ostream &O, const SPIRVNL &E);
 };
 
+/// Read \p N words of a binary. The stream buffer is used directly, since the
+/// checks done by std::istream::read for each word are noticeable on large
+/// modules.
+inline void readWords(const SPIRVDecoder &I, SPIRVWord *W, size_t N) {
+  if (!I.IS.good()) {
+    I.IS.setstate(std::ios_base::failbit);
+    return;
+  }
+  std::streamsize Size = N * sizeof(SPIRVWord);
+  if (I.IS.rdbuf()->sgetn(reinterpret_cast<char *>(W), Size) != Size)
+    I.IS.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+}
+
+/// Write \p N words of a binary, see readWords().
+inline void writeWords(const SPIRVEncoder &O, const SPIRVWord *W, size_t N) {
+  std::streamsize Size = N * sizeof(SPIRVWord);
+  if (O.OS.rdbuf()->sputn(reinterpret_cast<const char *>(W), Size) != Size)
+    O.OS.setstate(std::ios_base::badbit);
+}
+
 template <typename T>
 const SPIRVDecoder &decodeBinary(const SPIRVDecoder &I, T &V) {
   uint32_t W;
-  I.IS.read(reinterpret_cast<char *>(&W), sizeof(W));
+  readWords(I, &W, 1);
   V = static_cast<T>(W);
   SPIRVDBG(spvdbgs() << "Read word: W = " << W << " V = " << V << '\n');
   return I;
@@ -165,6 +212,15 @@ const SPIRVDecoder &operator>>(const SPIRVDecoder &Decoder,
 
 template <typename T>
 const SPIRVDecoder &operator>>(const SPIRVDecoder &I, std::vector<T> &V) {
+  if constexpr (std::is_same<T, SPIRVWord>::value) {
+#ifdef _SPIRV_SUPPORT_TEXT_FMT
+    if (!SPIRVUseTextFormat)
+#endif
+    {
+      readWords(I, V.data(), V.size());
+      return I;
+    }
+  }
   for (size_t J = 0, E = V.size(); J != E; ++J)
     I >> V[J];
   return I;
@@ -186,7 +242,7 @@ const SPIRVEncoder &operator<<(const SPIRVEncoder &O, T V) {
   }
 #endif
   uint32_t W = static_cast<uint32_t>(V);
-  O.OS.write(reinterpret_cast<char *>(&W), sizeof(W));
+  writeWords(O, &W, 1);
   return O;
 }
 
@@ -198,6 +254,15 @@ template <> const SPIRVEncoder &operator<<(const SPIRVEncoder &O, SPIRVType *P);
 
 template <typename T>
 const SPIRVEncoder &operator<<(const SPIRVEncoder &O, const std::vector<T> &V) {
+  if constexpr (std::is_same<T, SPIRVWord>::value) {
+#ifdef _SPIRV_SUPPORT_TEXT_FMT
+    if (!SPIRVUseTextFormat)
+#endif
+    {
+      writeWords(O, V.data(), V.size());
+      return O;
+    }
+  }
   for (size_t I = 0, E = V.size(); I != E; ++I)
     O << V[I];
   return O;
@@ -55,6 +55,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
@@ -95,6 +96,18 @@ static cl::opt<std::string> OutputFile("o",
                                        cl::desc("Override output filename"),
                                        cl::value_desc("filename"));
 
+static cl::opt<std::string> InFileList(
+    "in-file-list",
+    cl::desc("Translate each LLVM bitcode file listed in <file>, one per "
+             "line, to SPIR-V within a single process"),
+    cl::value_desc("file"));
+
+static cl::opt<std::string> OutFileList(
+    "out-file-list",
+    cl::desc("Write the names of the files translated from --in-file-list to "
+             "<file>, in the same order"),
+    cl::value_desc("file"));
+
 static cl::opt<bool>
     IsReverse("r", cl::desc("Reverse translation (SPIR-V to LLVM)"));
 
@@ -373,6 +386,36 @@ static bool isFileEmpty(const std::string &FileName) {
   return File && File.peek() == EOF;
 }
 
+// Translate every file of --in-file-list as if llvm-spirv was run on it, so
+// that translating the modules of a split device image doesn't need a process
+// for each of them. The output of each file is named after its input.
+static int convertLLVMToSPIRVFileList(const SPIRV::TranslatorOpts &Opts) {
+  std::unique_ptr<MemoryBuffer> List =
+      ExitOnErr(errorOrToExpected(MemoryBuffer::getFile(InFileList)));
+  std::string OutputNames;
+  for (line_iterator LI(*List); !LI.is_at_eof(); ++LI) {
+    InputFile = LI->str();
+    if (isFileEmpty(InputFile)) {
+      errs() << "Can't translate, file is empty: " << InputFile << '\n';
+      return -1;
+    }
+    OutputFile =
+        removeExt(InputFile) +
+        (SPIRV::SPIRVUseTextFormat ? kExt::SpirvText : kExt::SpirvBinary);
+    if (int Ret = convertLLVMToSPIRV(Opts))
+      return Ret;
+    OutputNames += OutputFile + '\n';
+  }
+
+  std::ofstream OutList(OutFileList);
+  OutList << OutputNames;
+  if (!OutList) {
+    errs() << "Can't write file list " << OutFileList << '\n';
+    return -1;
+  }
+  return 0;
+}
+
 static int convertSPIRVToLLVM(const SPIRV::TranslatorOpts &Opts) {
   LLVMContext Context;
   
@@ -687,7 +730,13 @@ int main(int Ac, char **Av) {
 
   cl::ParseCommandLineOptions(Ac, Av, "LLVM/SPIR-V translator");
 
-  if (InputFile != "-" && isFileEmpty(InputFile)) {
+  if (!InFileList.empty()) {
+    if (OutFileList.empty() || InputFile != "-" || !OutputFile.empty()) {
+      errs() << "--in-file-list requires --out-file-list and can't be used "
+                "with an input file or -o\n";
+      return -1;
+    }
+  } else if (InputFile != "-" && isFileEmpty(InputFile)) {
     errs() << "Can't translate, file is empty\n";
     return -1;
   }
@@ -782,6 +831,19 @@ int main(int Ac, char **Av) {
   if (PreserveOCLKernelArgTypeMetadataThroughString.getNumOccurrences() != 0)
     Opts.setPreserveOCLKernelArgTypeMetadataThroughString(true);
 
+  if (!InFileList.empty()) {
+    bool IsUnsupportedMode = IsReverse || IsRegularization || SpecConstInfo;
+#ifdef _SPIRV_SUPPORT_TEXT_FMT
+    IsUnsupportedMode |= ToBinary || ToText;
+#endif
+    if (IsUnsupportedMode) {
+      errs() << "--in-file-list only supports translation from LLVM IR to "
+                "SPIR-V\n";
+      return -1;
+    }
+    return convertLLVMToSPIRVFileList(Opts);
+  }
+
 #ifdef _SPIRV_SUPPORT_TEXT_FMT
   if (ToText && (ToBinary || IsReverse || IsRegularization)) {
     errs() << "Cannot use -to-text with -to-binary, -r, -s\n";
@@ -0,0 +1,145 @@
+//===- MemorySSA.cpp - MemorySSA benchmarks on large functions ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures MemorySSA construction and clobber queries on functions with many
+// memory operations, in straight-line code and in a chain of diamonds.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BasicAliasAnalysis.h"
+#include "llvm/Analysis/MemorySSA.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+
+namespace {
+
+/// Build a function that stores to and loads from NumAccesses / 2 distinct
+/// offsets of two pointer arguments that may alias. With \p Diamonds each
+/// store/load pair is placed in its own arm of a diamond, which gives the
+/// walker MemoryPhis to look through.
+Function *buildFunction(Module &M, unsigned NumAccesses, bool Diamonds) {
+  LLVMContext &C = M.getContext();
+  IRBuilder<> B(C);
+  auto *FTy = FunctionType::get(
+      B.getVoidTy(), {B.getPtrTy(), B.getPtrTy(), B.getInt1Ty()}, false);
+  Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage, "f", &M);
+  Value *P = F->getArg(0), *Q = F->getArg(1), *Cond = F->getArg(2);
+  BasicBlock *BB = BasicBlock::Create(C, "entry", F);
+  B.SetInsertPoint(BB);
+  for (unsigned I = 0; I != NumAccesses / 2; ++I) {
+    if (Diamonds) {
+      BasicBlock *Then = BasicBlock::Create(C, "then", F);
+      BasicBlock *Else = BasicBlock::Create(C, "else", F);
+      BasicBlock *Join = BasicBlock::Create(C, "join", F);
+      B.CreateCondBr(Cond, Then, Else);
+      B.SetInsertPoint(Then);
+      B.CreateStore(B.getInt32(I), B.CreateConstGEP1_64(B.getInt32Ty(), P, I));
+      B.CreateBr(Join);
+      B.SetInsertPoint(Else);
+      B.CreateLoad(B.getInt32Ty(), B.CreateConstGEP1_64(B.getInt32Ty(), Q, I));
+      B.CreateBr(Join);
+      B.SetInsertPoint(Join);
+    } else {
+      B.CreateStore(B.getInt32(I), B.CreateConstGEP1_64(B.getInt32Ty(), P, I));
+      B.CreateLoad(B.getInt32Ty(), B.CreateConstGEP1_64(B.getInt32Ty(), Q, I));
+    }
+  }
+  B.CreateRetVoid();
+  return F;
+}
+
+/// The analyses MemorySSA depends on, set up the same way as in the MemorySSA
+/// unit tests.
+struct Analyses {
+  TargetLibraryInfoImpl TLII;
+  TargetLibraryInfo TLI;
+  DominatorTree DT;
+  AssumptionCache AC;
+  AAResults AA;
+  BasicAAResult BAA;
+
+  Analyses(Function &F)
+      : TLI(TLII), DT(F), AC(F), AA(TLI),
+        BAA(F.getParent()->getDataLayout(), F, TLI, AC, &DT) {
+    AA.addAAResult(BAA);
+  }
+};
+
+void BM_MemorySSABuild(benchmark::State &State, bool Diamonds) {
+  LLVMContext C;
+  Module M("bench", C);
+  Function *F = buildFunction(M, State.range(0), Diamonds);
+  Analyses A(*F);
+  for (auto _ : State) {
+    MemorySSA MSSA(*F, &A.AA, &A.DT);
+    benchmark::DoNotOptimize(&MSSA);
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_MemorySSAOptimizeUses(benchmark::State &State, bool Diamonds) {
+  LLVMContext C;
+  Module M("bench", C);
+  Function *F = buildFunction(M, State.range(0), Diamonds);
+  Analyses A(*F);
+  for (auto _ : State) {
+    MemorySSA MSSA(*F, &A.AA, &A.DT);
+    MSSA.ensureOptimizedUses();
+    benchmark::DoNotOptimize(&MSSA);
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_MemorySSAClobberQueries(benchmark::State &State, bool Diamonds) {
+  LLVMContext C;
+  Module M("bench", C);
+  Function *F = buildFunction(M, State.range(0), Diamonds);
+  Analyses A(*F);
+  for (auto _ : State) {
+    State.PauseTiming();
+    MemorySSA MSSA(*F, &A.AA, &A.DT);
+    State.ResumeTiming();
+    MemorySSAWalker *Walker = MSSA.getWalker();
+    for (BasicBlock &BB : *F)
+      for (Instruction &I : BB)
+        if (isa<LoadInst>(I) || isa<StoreInst>(I))
+          benchmark::DoNotOptimize(Walker->getClobberingMemoryAccess(&I));
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_MemorySSABuild, straight_line, false)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_MemorySSABuild, diamonds, true)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_MemorySSAOptimizeUses, straight_line, false)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_MemorySSAOptimizeUses, diamonds, true)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_MemorySSAClobberQueries, straight_line, false)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_MemorySSAClobberQueries, diamonds, true)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+BENCHMARK_MAIN();
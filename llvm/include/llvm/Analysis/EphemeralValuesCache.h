@@ -0,0 +1,68 @@
+//===- llvm/Analysis/EphemeralValuesCache.h ---------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass caches ephemeral values, i.e., values that are only used by
+// @llvm.assume intrinsics, so that repeated queries for the same function do
+// not have to walk it again.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_EPHEMERALVALUESCACHE_H
+#define LLVM_ANALYSIS_EPHEMERALVALUESCACHE_H
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class AssumptionCache;
+class Function;
+class Value;
+
+/// A lazily populated cache of the ephemeral values of a function. The values
+/// are collected on the first query and reused until the analysis result is
+/// invalidated.
+class EphemeralValuesCache {
+  SmallPtrSet<const Value *, 32> EphValues;
+  Function &F;
+  AssumptionCache &AC;
+  bool Collected = false;
+
+  void collectEphemeralValues();
+
+public:
+  EphemeralValuesCache(Function &F, AssumptionCache &AC) : F(F), AC(AC) {}
+
+  /// Drop the cached values; they are recollected on the next query.
+  void clear() {
+    EphValues.clear();
+    Collected = false;
+  }
+
+  /// Return the ephemeral values of the function, collecting them first if
+  /// needed.
+  const SmallPtrSetImpl<const Value *> &ephValues() {
+    if (!Collected)
+      collectEphemeralValues();
+    return EphValues;
+  }
+};
+
+class EphemeralValuesAnalysis
+    : public AnalysisInfoMixin<EphemeralValuesAnalysis> {
+  friend AnalysisInfoMixin<EphemeralValuesAnalysis>;
+  static AnalysisKey Key;
+
+public:
+  using Result = EphemeralValuesCache;
+  Result run(Function &F, FunctionAnalysisManager &FAM);
+};
+
+} // namespace llvm
+
+#endif // LLVM_ANALYSIS_EPHEMERALVALUESCACHE_H
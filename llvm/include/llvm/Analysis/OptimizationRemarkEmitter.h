@@ -101,10 +101,7 @@ public:
   static bool allowExtraAnalysis(const Function &F, StringRef PassName) {
     return allowExtraAnalysis(F.getContext(), PassName);
   }
-  static bool allowExtraAnalysis(LLVMContext &Ctx, StringRef PassName) {
-    return Ctx.getLLVMRemarkStreamer() ||
-           Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
-  }
+  static bool allowExtraAnalysis(LLVMContext &Ctx, StringRef PassName);
 
 private:
   const Function *F;
@@ -515,6 +515,10 @@ protected:
     /// emitter, it corresponds to the order in which names appear in argument
     /// list. Currently such predicates don't have more then 3 arguments.
     std::array<const MachineOperand *, 3> RecordedOperands;
+    /// Resume points of the open try-blocks of executeMatchTable(). Kept here
+    /// so that its storage is reused rather than allocated again for every
+    /// instruction once the nesting of the table exceeds the inline size.
+    SmallVector<uint64_t, 8> OnFailResumeAt;
 
     MatcherState(unsigned MaxRenderers);
   };
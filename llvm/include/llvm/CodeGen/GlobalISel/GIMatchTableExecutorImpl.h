@@ -51,7 +51,8 @@ bool GIMatchTableExecutor::executeMatchTable(
     CodeGenCoverage *CoverageInfo, GISelChangeObserver *Observer) const {
 
   uint64_t CurrentIdx = 0;
-  SmallVector<uint64_t, 4> OnFailResumeAt;
+  SmallVectorImpl<uint64_t> &OnFailResumeAt = State.OnFailResumeAt;
+  OnFailResumeAt.clear();
 
   // Bypass the flag check on the instruction, and only look at the MCInstrDesc.
   bool NoFPException = !State.MIs[0]->getDesc().mayRaiseFPException();
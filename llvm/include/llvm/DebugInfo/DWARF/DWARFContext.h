@@ -176,6 +176,12 @@ public:
     return State->getNormalUnits();
   }
 
+  /// Extract the DIEs of all the units of .debug_info and .debug_types on up
+  /// to \p NumThreads threads, or on all the hardware threads if it is zero,
+  /// so that later traversals of the units find them already extracted.
+  /// Extraction errors are reported in the order of the units.
+  void extractNormalUnitsInParallel(unsigned NumThreads = 0);
+
   /// Get units from .debug_types in this context.
   unit_iterator_range types_section_units() {
     DWARFUnitVector &NormalUnits = State->getNormalUnits();
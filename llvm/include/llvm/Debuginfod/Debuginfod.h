@@ -74,7 +74,9 @@ Expected<std::string> getCachedOrDownloadArtifact(StringRef UniqueKey,
 
 /// Fetches any debuginfod artifact using the specified local cache directory,
 /// server URLs, and request timeout (in milliseconds). If the artifact is
-/// found, uses the UniqueKey for the local cache file.
+/// found, uses the UniqueKey for the local cache file. If all of the servers
+/// report it as not found, they are not queried for it again for a few
+/// minutes by this process.
 Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout);
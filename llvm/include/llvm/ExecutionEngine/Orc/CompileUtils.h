@@ -13,16 +13,19 @@
 #ifndef LLVM_EXECUTIONENGINE_ORC_COMPILEUTILS_H
 #define LLVM_EXECUTIONENGINE_ORC_COMPILEUTILS_H
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/Support/Caching.h"
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 
 class MemoryBuffer;
 class Module;
-class ObjectCache;
 class TargetMachine;
 
 namespace orc {
@@ -93,6 +96,45 @@ private:
   ObjectCache *ObjCache = nullptr;
 };
 
+/// An ObjectCache keeping the objects in a FileCache, so that they outlive the
+/// JIT session, in the same way that the LTO caches keep the objects of the
+/// modules they compile.
+///
+/// Objects are keyed by a hash of the module's bitcode and of the
+/// configuration of the TargetMachine given at construction: the triple, CPU,
+/// features, optimization level, relocation model and code model. Clients
+/// compiling with different TargetOptions should use distinct caches.
+///
+/// This class is thread safe, and can be shared by the compilers created by
+/// ConcurrentIRCompiler.
+class FileObjectCache : public ObjectCache {
+public:
+  /// Create a cache keeping the objects compiled by \p TM in the directory
+  /// \p CacheDir, which is created lazily.
+  static Expected<std::unique_ptr<FileObjectCache>>
+  Create(const Twine &CacheDir, const TargetMachine &TM);
+
+  /// Create a cache keeping the objects compiled by \p TM in \p Store.
+  static std::unique_ptr<FileObjectCache>
+  Create(std::shared_ptr<CacheStore> Store, const TargetMachine &TM);
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+private:
+  FileObjectCache(const TargetMachine &TM);
+
+  void addBuffer(unsigned Task, std::unique_ptr<MemoryBuffer> MB);
+
+  std::string TargetKey;
+  FileCache Cache;
+
+  std::mutex CacheMutex;
+  unsigned NextTask = 0;
+  DenseMap<unsigned, std::unique_ptr<MemoryBuffer>> Buffers;
+  DenseMap<const Module *, std::pair<unsigned, AddStreamFn>> PendingObjects;
+};
+
 } // end namespace orc
 
 } // end namespace llvm
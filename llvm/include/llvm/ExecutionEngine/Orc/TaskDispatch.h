@@ -19,10 +19,12 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <cassert>
+#include <optional>
 #include <string>
 
 #if LLVM_ENABLE_THREADS
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
 #endif
@@ -112,8 +114,21 @@ public:
 
 #if LLVM_ENABLE_THREADS
 
+/// Runs each task on a new thread.
+///
+/// If MaxMaterializationThreads is set, at most that many MaterializationTasks
+/// run at any time, and the remaining ones are queued. All other tasks, e.g.
+/// the LookupTasks that a blocking lookup may be waiting on, are never queued
+/// behind the materialization tasks.
 class DynamicThreadPoolTaskDispatcher : public TaskDispatcher {
 public:
+  DynamicThreadPoolTaskDispatcher(
+      std::optional<size_t> MaxMaterializationThreads = std::nullopt)
+      : MaxMaterializationThreads(MaxMaterializationThreads) {
+    assert((!MaxMaterializationThreads || *MaxMaterializationThreads > 0) &&
+           "MaxMaterializationThreads must be non-zero");
+  }
+
   void dispatch(std::unique_ptr<Task> T) override;
   void shutdown() override;
 private:
@@ -121,6 +136,10 @@ private:
   bool Running = true;
   size_t Outstanding = 0;
   std::condition_variable OutstandingCV;
+
+  std::optional<size_t> MaxMaterializationThreads;
+  size_t NumMaterializationThreads = 0;
+  std::deque<std::unique_ptr<Task>> MaterializationTaskQueue;
 };
 
 #endif // LLVM_ENABLE_THREADS
@@ -42,6 +42,9 @@ public:
   LLVMRemarkStreamer(remarks::RemarkStreamer &RS) : RS(RS) {}
   /// Emit a diagnostic through the streamer.
   void emit(const DiagnosticInfoOptimizationBase &Diag);
+  /// Check whether the remarks of the pass \p PassName are emitted, so that
+  /// the pass can skip building the ones which would be dropped.
+  bool isEnabled(StringRef PassName);
 };
 
 template <typename ThisError>
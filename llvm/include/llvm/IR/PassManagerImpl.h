@@ -92,11 +92,17 @@ inline void AnalysisManager<IRUnitT, ExtraArgTs...>::invalidate(
   if (PA.allAnalysesInSetPreserved<AllAnalysesOn<IRUnitT>>())
     return;
 
+  // We're also done if nothing is cached for this IR unit, which is common
+  // for the functions a module-to-function adaptor runs a pass over.
+  auto ResultsListI = AnalysisResultLists.find(&IR);
+  if (ResultsListI == AnalysisResultLists.end())
+    return;
+
   // Track whether each analysis's result is invalidated in
   // IsResultInvalidated.
   SmallDenseMap<AnalysisKey *, bool, 8> IsResultInvalidated;
   Invalidator Inv(IsResultInvalidated, AnalysisResults);
-  AnalysisResultListT &ResultsList = AnalysisResultLists[&IR];
+  AnalysisResultListT &ResultsList = ResultsListI->second;
   for (auto &AnalysisResultPair : ResultsList) {
     // This is basically the same thing as Invalidator::invalidate, but we
     // can't call it here because we're operating on the type-erased result.
@@ -196,9 +196,10 @@ private:
   bool fragmentNeedsRelaxation(const MCRelaxableFragment *IF,
                                const MCAsmLayout &Layout) const;
 
-  /// Perform one layout iteration and return true if any offsets
-  /// were adjusted.
-  bool layoutOnce(MCAsmLayout &Layout);
+  /// Perform layout iterations of the given section until none of its
+  /// fragments needs relaxing, invalidating the layout of the other sections
+  /// after each change. Returns true if any offsets were adjusted.
+  bool layoutSectionUntilStable(MCAsmLayout &Layout, MCSection &Sec);
 
   /// Perform one layout iteration of the given section and return true
   /// if any offsets were adjusted.
@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <system_error>
 #include <tuple>
@@ -396,6 +397,9 @@ class FunctionRecordIterator
   ArrayRef<FunctionRecord> Records;
   ArrayRef<FunctionRecord>::iterator Current;
   StringRef Filename;
+  /// When set, only the records at these (increasing) indices are visited.
+  std::optional<ArrayRef<unsigned>> RecordIndices;
+  ArrayRef<unsigned>::iterator CurrentIndex = nullptr;
 
   /// Skip records whose primary file is not \c Filename.
   void skipOtherFiles();
@@ -407,6 +411,15 @@ public:
     skipOtherFiles();
   }
 
+  /// Iterate over the records at \p RecordIndices_ whose primary file is
+  /// \p Filename, without visiting every record.
+  FunctionRecordIterator(ArrayRef<FunctionRecord> Records_,
+                         ArrayRef<unsigned> RecordIndices_, StringRef Filename)
+      : Records(Records_), Current(Records.begin()), Filename(Filename),
+        RecordIndices(RecordIndices_), CurrentIndex(RecordIndices_.begin()) {
+    skipOtherFiles();
+  }
+
   FunctionRecordIterator() : Current(Records.begin()) {}
 
   bool operator==(const FunctionRecordIterator &RHS) const {
@@ -417,7 +430,10 @@ public:
 
   FunctionRecordIterator &operator++() {
     assert(Current != Records.end() && "incremented past end");
-    ++Current;
+    if (RecordIndices)
+      ++CurrentIndex;
+    else
+      ++Current;
     skipOtherFiles();
     return *this;
   }
@@ -668,8 +684,13 @@ public:
   /// Gets all of the functions in a particular file.
   iterator_range<FunctionRecordIterator>
   getCoveredFunctions(StringRef Filename) const {
-    return make_range(FunctionRecordIterator(Functions, Filename),
-                      FunctionRecordIterator());
+    if (Filename.empty())
+      return getCoveredFunctions();
+    return make_range(
+        FunctionRecordIterator(Functions,
+                               getImpreciseRecordIndicesForFilename(Filename),
+                               Filename),
+        FunctionRecordIterator());
   }
 
   /// Get the list of function instantiation groups in a particular file.
@@ -484,7 +484,9 @@ public:
   InstrProfLookupTrait(IndexedInstrProf::HashT HashType, unsigned FormatVersion)
       : HashType(HashType), FormatVersion(FormatVersion) {}
 
-  using data_type = ArrayRef<NamedInstrProfRecord>;
+  // The records point into a buffer of the trait which is overwritten by the
+  // next lookup, so callers may move them out.
+  using data_type = MutableArrayRef<NamedInstrProfRecord>;
 
   using internal_key_type = StringRef;
   using external_key_type = StringRef;
@@ -527,9 +529,10 @@ struct InstrProfReaderIndexBase {
   // iterator.
   virtual Error getRecords(ArrayRef<NamedInstrProfRecord> &Data) = 0;
 
-  // Read all the profile records with the key equal to FuncName
+  // Read all the profile records with the key equal to FuncName. The records
+  // are only valid until the next lookup and may be moved from.
   virtual Error getRecords(StringRef FuncName,
-                                     ArrayRef<NamedInstrProfRecord> &Data) = 0;
+                           MutableArrayRef<NamedInstrProfRecord> &Data) = 0;
   virtual void advanceToNextKey() = 0;
   virtual bool atEnd() const = 0;
   virtual void setValueProfDataEndianness(support::endianness Endianness) = 0;
@@ -574,7 +577,7 @@ public:
 
   Error getRecords(ArrayRef<NamedInstrProfRecord> &Data) override;
   Error getRecords(StringRef FuncName,
-                   ArrayRef<NamedInstrProfRecord> &Data) override;
+                   MutableArrayRef<NamedInstrProfRecord> &Data) override;
   void advanceToNextKey() override { RecordIterator++; }
 
   bool atEnd() const override {
@@ -628,7 +631,7 @@ public:
   virtual ~InstrProfReaderRemapper() = default;
   virtual Error populateRemappings() { return Error::success(); }
   virtual Error getRecords(StringRef FuncName,
-                           ArrayRef<NamedInstrProfRecord> &Data) = 0;
+                           MutableArrayRef<NamedInstrProfRecord> &Data) = 0;
 };
 
 /// Reader for the indexed binary instrprof format.
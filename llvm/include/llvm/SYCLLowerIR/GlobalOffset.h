@@ -21,7 +21,8 @@ class PassRegistry;
 /// This pass operates on SYCL kernels that target AMDGPU or NVVM. It looks for
 /// uses of the `llvm.{amdgcn|nvvm}.implicit.offset` intrinsic and replaces it
 /// with an offset parameter which will be threaded through from the kernel
-/// entry point.
+/// entry point. With -sycl-assume-no-global-offset the intrinsic is replaced
+/// with a zero offset instead and kernel signatures are left unchanged.
 class GlobalOffsetPass : public PassInfoMixin<GlobalOffsetPass> {
 private:
   using KernelPayload = TargetHelpers::KernelPayload;
@@ -45,6 +46,12 @@ private:
   /// \param Func Kernel to be processed.
   void processKernelEntryPoint(Function *Func);
 
+  /// Adds an alloca of 3 zeros to the entry block of \p Func.
+  ///
+  /// \returns A pointer to the first zero, of the type returned by the
+  /// implicit offset intrinsic.
+  Value *createZeroImplicitOffset(Function *Func);
+
   /// This function adds an implicit parameter to the function containing a
   /// call instruction to the implicit offset intrinsic or another function
   /// (which eventually calls the instrinsic). If the call instruction is to
@@ -25,6 +25,12 @@
 //         [128 x i8], [128 x i8] addrspace(3)* @WGLocalMem, i32 0, i32 0)
 //         to i32 addrspace(3)*
 //   }
+//
+// Then, with -sycl-share-wg-local-memory, the allocations of a kernel whose
+// accesses are all separated by a work-group barrier, e.g. scratch memory of
+// two phases of an algorithm, share the largest of their globals. Allocations
+// whose pointer escapes into an unknown call or into memory, or which are
+// accessed from a function other than a kernel, keep their own global.
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_SYCLLOWERIR_LOWERWGLOCALMEMORY_H
@@ -8,7 +8,9 @@
 //
 // This file defines the CachedFileStream and the localCache function, which
 // simplifies caching files on the local filesystem in a directory whose
-// contents are managed by a CachePruningPolicy.
+// contents are managed by a CachePruningPolicy. It also defines the CacheStore
+// interface and the storeCache function, which cache files in a store provided
+// by the client, e.g. a remote content-addressed storage.
 //
 //===----------------------------------------------------------------------===//
 
@@ -16,6 +18,9 @@
 #define LLVM_SUPPORT_CACHING_H
 
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBufferRef.h"
+
+#include <memory>
 
 namespace llvm {
 
@@ -74,6 +79,36 @@ Expected<FileCache> localCache(
     const Twine &CacheDirectoryPathRef,
     AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
                                std::unique_ptr<MemoryBuffer> MB) {});
+
+/// A store holding the contents of cache entries by key. Implementations can
+/// keep them anywhere, e.g. in a content-addressed storage shared by the
+/// machines of a build farm, so that they all benefit from each other's cache
+/// misses.
+///
+/// Store methods must be thread safe.
+class CacheStore {
+public:
+  virtual ~CacheStore() = default;
+
+  /// Returns the contents of the entry for \p Key, or nullptr if the store
+  /// has no such entry.
+  virtual Expected<std::unique_ptr<MemoryBuffer>> get(StringRef Key) = 0;
+
+  /// Adds \p Contents as the entry for \p Key. An entry which already exists
+  /// for the key is semantically equivalent and may be kept instead.
+  virtual Error put(StringRef Key, MemoryBufferRef Contents) = 0;
+};
+
+/// Create a cache which keeps its entries in \p Store and uses the given
+/// cache name and file callback. The cache name appears in error messages for
+/// errors during caching. Content produced on a miss is written to memory,
+/// then added to the store and passed to \p AddBuffer. A failure to add it to
+/// the store only loses the entry, since the content is still available to
+/// the link.
+FileCache storeCache(
+    const Twine &CacheNameRef, std::shared_ptr<CacheStore> Store,
+    AddBufferFn AddBuffer = [](size_t Task, const Twine &ModuleName,
+                               std::unique_ptr<MemoryBuffer> MB) {});
 } // namespace llvm
 
 #endif
@@ -73,10 +73,18 @@ public:
     ++Count;
   }
 
-  void dec() {
+  /// \returns true if this call brought the count to zero.
+  bool dec() {
     std::lock_guard<std::mutex> lock(Mutex);
-    if (--Count == 0)
-      Cond.notify_all();
+    if (--Count != 0)
+      return false;
+    Cond.notify_all();
+    return true;
+  }
+
+  bool isZero() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
   }
 
   void sync() const {
@@ -89,6 +97,9 @@ public:
 class TaskGroup {
   detail::Latch L;
   bool Parallel;
+  // Whether the group was created on a thread of the default executor, i.e.
+  // from within a task of another group.
+  bool Nested;
 
 public:
   TaskGroup();
@@ -101,7 +112,10 @@ public:
   // threads, but strictly in sequential order.
   void spawn(std::function<void()> f, bool Sequential = false);
 
-  void sync() const { L.sync(); }
+  // Wait for all the spawned tasks to finish. A nested group runs its own
+  // queued tasks on the waiting thread meanwhile, so these must not use the
+  // per-thread state (see getThreadIndex()) the spawning task holds.
+  void sync() const;
 
   bool isParallel() const { return Parallel; }
 };
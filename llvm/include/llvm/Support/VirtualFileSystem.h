@@ -16,6 +16,7 @@
 
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/Support/Chrono.h"
@@ -28,6 +29,7 @@
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <stack>
 #include <string>
@@ -458,6 +460,47 @@ private:
   virtual void anchor();
 };
 
+/// A proxy file system that remembers the result of \c status() calls, both
+/// successful and failed ones, so that repeated queries for the same path do
+/// not reach the underlying file system. \c openFileForRead() on a path that
+/// is known not to exist fails without consulting the underlying file system.
+///
+/// Entries are keyed by the path exactly as given; the cache is dropped when
+/// the working directory changes, since relative paths may then resolve
+/// differently. Changes made to the underlying file system behind the cache's
+/// back are not observed until \c clear() is called, so paths that are
+/// written while the file system is in use should be excluded from caching
+/// with \c excludePath(). All members are safe to call from multiple threads
+/// as long as the underlying file system is.
+class StatCachingFileSystem : public ProxyFileSystem {
+public:
+  explicit StatCachingFileSystem(IntrusiveRefCntPtr<FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+  std::error_code setCurrentWorkingDirectory(const Twine &Path) override;
+
+  /// Forget all cached entries.
+  void clear();
+
+  /// Never cache lookups of \p Path or of any path below it. Relative paths
+  /// are resolved against the current working directory. Entries cached
+  /// before the call are kept, so this should be called before the file
+  /// system is used.
+  void excludePath(const Twine &Path);
+
+private:
+  /// \returns true if lookups of \p Path must not be cached.
+  bool isExcluded(StringRef Path) const;
+
+  mutable std::mutex CacheMutex;
+  StringMap<llvm::ErrorOr<Status>> Cache;
+  /// Absolute paths passed to excludePath(). Guarded by CacheMutex.
+  std::vector<std::string> ExcludedPaths;
+};
+
 namespace detail {
 
 class InMemoryDirectory;
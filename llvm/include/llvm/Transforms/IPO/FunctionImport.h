@@ -141,7 +141,9 @@ public:
 ///
 /// \p isPrevailing is a callback that will be called with a global value's GUID
 /// and summary and should return whether the module corresponding to the
-/// summary contains the linker-prevailing copy of that value.
+/// summary contains the linker-prevailing copy of that value. The import lists
+/// of the modules are computed in parallel, so \p isPrevailing must be thread
+/// safe.
 ///
 /// \p ImportLists will be populated with an entry for every Module we are
 /// importing into. This entry is itself a map that can be passed to
@@ -0,0 +1,34 @@
+//===- EphemeralValuesCache.cpp - Cache collecting ephemeral values -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/EphemeralValuesCache.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/CodeMetrics.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "ephemerals"
+
+STATISTIC(NumEphValuesCollected,
+          "Number of functions whose ephemeral values were collected");
+
+void EphemeralValuesCache::collectEphemeralValues() {
+  EphValues.clear();
+  CodeMetrics::collectEphemeralValues(&F, &AC, EphValues);
+  Collected = true;
+  ++NumEphValuesCollected;
+}
+
+AnalysisKey EphemeralValuesAnalysis::Key;
+
+EphemeralValuesCache
+EphemeralValuesAnalysis::run(Function &F, FunctionAnalysisManager &FAM) {
+  auto &AC = FAM.getResult<AssumptionAnalysis>(F);
+  return EphemeralValuesCache(F, AC);
+}
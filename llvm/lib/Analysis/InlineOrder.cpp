@@ -9,6 +9,7 @@
 #include "llvm/Analysis/InlineOrder.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/EphemeralValuesCache.h"
 #include "llvm/Analysis/GlobalsModRef.h"
 #include "llvm/Analysis/InlineAdvisor.h"
 #include "llvm/Analysis/InlineCost.h"
@@ -61,6 +62,9 @@ llvm::InlineCost getInlineCostWrapper(CallBase &CB,
   auto GetTLI = [&](Function &F) -> const TargetLibraryInfo & {
     return FAM.getResult<TargetLibraryAnalysis>(F);
   };
+  auto GetEphValuesCache = [&](Function &F) -> EphemeralValuesCache & {
+    return FAM.getResult<EphemeralValuesAnalysis>(F);
+  };
 
   Function &Callee = *CB.getCalledFunction();
   auto &CalleeTTI = FAM.getResult<TargetIRAnalysis>(Callee);
@@ -68,7 +72,8 @@ llvm::InlineCost getInlineCostWrapper(CallBase &CB,
       Callee.getContext().getDiagHandlerPtr()->isMissedOptRemarkEnabled(
           DEBUG_TYPE);
   return getInlineCost(CB, Params, CalleeTTI, GetAssumptionCache, GetTLI,
-                       GetBFI, PSI, RemarksEnabled ? &ORE : nullptr);
+                       GetBFI, PSI, RemarksEnabled ? &ORE : nullptr,
+                       GetEphValuesCache);
 }
 
 class SizePriority {
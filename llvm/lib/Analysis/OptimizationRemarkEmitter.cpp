@@ -19,6 +19,7 @@
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/InitializePasses.h"
 #include <optional>
 
@@ -76,6 +77,16 @@ void OptimizationRemarkEmitter::computeHotness(
     OptDiag.setHotness(computeHotness(V));
 }
 
+bool OptimizationRemarkEmitter::allowExtraAnalysis(LLVMContext &Ctx,
+                                                   StringRef PassName) {
+  // The remark streamer drops the remarks of the passes not matching its
+  // filter, there is no point in analyzing more for them.
+  if (LLVMRemarkStreamer *RS = Ctx.getLLVMRemarkStreamer())
+    if (RS->isEnabled(PassName))
+      return true;
+  return Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
+}
+
 void OptimizationRemarkEmitter::emit(
     DiagnosticInfoOptimizationBase &OptDiagBase) {
   auto &OptDiag = cast<DiagnosticInfoIROptimization>(OptDiagBase);
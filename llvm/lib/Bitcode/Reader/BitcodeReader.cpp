@@ -4496,7 +4496,8 @@ Error BitcodeReader::parseBitcodeInto(Module *M, bool ShouldLazyLoadMetadata,
     return getContainedTypeID(I, J);
   };
   MDCallbacks.MDType = Callbacks.MDType;
-  MDLoader = MetadataLoader(Stream, *M, ValueList, IsImporting, MDCallbacks);
+  MDLoader = MetadataLoader(Stream, *M, ValueList, IsImporting,
+                            ShouldLazyLoadMetadata, MDCallbacks);
   return parseModule(0, ShouldLazyLoadMetadata, Callbacks);
 }
 
@@ -6990,8 +6991,15 @@ std::vector<FunctionSummary::EdgeTy>
 ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
                                               bool IsOldProfileFormat,
                                               bool HasProfile, bool HasRelBF) {
+  // Each edge is the callee followed by its profile fields, if any. The call
+  // lists are kept in the combined index, so don't reserve a slot per field.
+  unsigned FieldsPerEdge = 1;
+  if (IsOldProfileFormat)
+    FieldsPerEdge += HasProfile ? 2 : 1;
+  else if (HasProfile || HasRelBF)
+    FieldsPerEdge += 1;
   std::vector<FunctionSummary::EdgeTy> Ret;
-  Ret.reserve(Record.size());
+  Ret.reserve(Record.size() / FieldsPerEdge);
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     uint64_t RelBF = 0;
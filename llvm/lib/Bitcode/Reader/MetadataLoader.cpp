@@ -84,6 +84,13 @@ static cl::opt<bool> DisableLazyLoading(
     cl::desc("Force disable the lazy-loading on-demand of metadata when "
              "loading bitcode for importing."));
 
+static cl::opt<bool> LazyModuleOnDemandLoading(
+    "ondemand-mds-loading-for-lazy-modules", cl::init(false), cl::Hidden,
+    cl::desc("Load the module-level metadata on-demand, as when importing, "
+             "for modules read with lazy metadata loading, so that consumers "
+             "materializing a few functions only parse the metadata they "
+             "reference."));
+
 namespace {
 
 static int64_t unrotateSign(uint64_t U) { return (U & 1) ? ~(U >> 1) : U >> 1; }
@@ -471,6 +478,9 @@ class MetadataLoader::MetadataLoaderImpl {
   /// True if metadata is being parsed for a module being ThinLTO imported.
   bool IsImporting = false;
 
+  /// True if module-level metadata is loaded on demand via an index.
+  bool LoadOnDemand = false;
+
   Error parseOneMetadata(SmallVectorImpl<uint64_t> &Record, unsigned Code,
                          PlaceholderQueue &Placeholders, StringRef Blob,
                          unsigned &NextMetadataNo);
@@ -716,11 +726,14 @@ class MetadataLoader::MetadataLoaderImpl {
 public:
   MetadataLoaderImpl(BitstreamCursor &Stream, Module &TheModule,
                      BitcodeReaderValueList &ValueList,
-                     MetadataLoaderCallbacks Callbacks, bool IsImporting)
+                     MetadataLoaderCallbacks Callbacks, bool IsImporting,
+                     bool IsLazy)
       : MetadataList(TheModule.getContext(), Stream.SizeInBytes()),
         ValueList(ValueList), Stream(Stream), Context(TheModule.getContext()),
         TheModule(TheModule), Callbacks(std::move(Callbacks)),
-        IsImporting(IsImporting) {}
+        IsImporting(IsImporting),
+        LoadOnDemand(!DisableLazyLoading &&
+                     (IsImporting || (IsLazy && LazyModuleOnDemandLoading))) {}
 
   Error parseMetadata(bool ModuleLevel);
 
@@ -1063,8 +1076,7 @@ Error MetadataLoader::MetadataLoaderImpl::parseMetadata(bool ModuleLevel) {
 
   // We lazy-load module-level metadata: we build an index for each record, and
   // then load individual record as needed, starting with the named metadata.
-  if (ModuleLevel && IsImporting && MetadataList.empty() &&
-      !DisableLazyLoading) {
+  if (ModuleLevel && LoadOnDemand && MetadataList.empty()) {
     auto SuccessOrErr = lazyLoadModuleMetadataBlock();
     if (!SuccessOrErr)
       return SuccessOrErr.takeError();
@@ -2454,10 +2466,11 @@ MetadataLoader::MetadataLoader(MetadataLoader &&RHS)
 MetadataLoader::~MetadataLoader() = default;
 MetadataLoader::MetadataLoader(BitstreamCursor &Stream, Module &TheModule,
                                BitcodeReaderValueList &ValueList,
-                               bool IsImporting,
+                               bool IsImporting, bool IsLazy,
                                MetadataLoaderCallbacks Callbacks)
-    : Pimpl(std::make_unique<MetadataLoaderImpl>(
-          Stream, TheModule, ValueList, std::move(Callbacks), IsImporting)) {}
+    : Pimpl(std::make_unique<MetadataLoaderImpl>(Stream, TheModule, ValueList,
+                                                 std::move(Callbacks),
+                                                 IsImporting, IsLazy)) {}
 
 Error MetadataLoader::parseMetadata(bool ModuleLevel) {
   return Pimpl->parseMetadata(ModuleLevel);
@@ -51,9 +51,12 @@ class MetadataLoader {
 
 public:
   ~MetadataLoader();
+  /// If \p IsImporting or \p IsLazy is true, module-level metadata may be
+  /// loaded on demand as it is referenced, rather than all at once.
+  /// \p IsImporting also imports composite types as declarations.
   MetadataLoader(BitstreamCursor &Stream, Module &TheModule,
                  BitcodeReaderValueList &ValueList, bool IsImporting,
-                 MetadataLoaderCallbacks Callbacks);
+                 bool IsLazy, MetadataLoaderCallbacks Callbacks);
   MetadataLoader &operator=(MetadataLoader &&);
   MetadataLoader(MetadataLoader &&);
 
@@ -17,6 +17,7 @@
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/InitializePasses.h"
 #include <optional>
 
@@ -46,6 +47,17 @@ void MachineOptimizationRemarkEmitter::computeHotness(
     Remark.setHotness(computeHotness(*MBB));
 }
 
+bool MachineOptimizationRemarkEmitter::allowExtraAnalysis(
+    StringRef PassName) const {
+  LLVMContext &Ctx = MF.getFunction().getContext();
+  // The remark streamer drops the remarks of the passes not matching its
+  // filter, there is no point in analyzing more for them.
+  if (LLVMRemarkStreamer *RS = Ctx.getLLVMRemarkStreamer())
+    if (RS->isEnabled(PassName))
+      return true;
+  return Ctx.getDiagHandlerPtr()->isAnyRemarkEnabled(PassName);
+}
+
 void MachineOptimizationRemarkEmitter::emit(
     DiagnosticInfoOptimizationBase &OptDiagCommon) {
   auto &OptDiag = cast<DiagnosticInfoMIROptimization>(OptDiagCommon);
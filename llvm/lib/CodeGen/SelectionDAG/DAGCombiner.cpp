@@ -86,6 +86,9 @@ STATISTIC(OpsNarrowed     , "Number of load/op/store narrowed");
 STATISTIC(LdStFP2Int      , "Number of fp load/store pairs transformed to int");
 STATISTIC(SlicedLoads, "Number of load sliced");
 STATISTIC(NumFPLogicOpsConv, "Number of logic ops converted to fp ops");
+STATISTIC(NodesVisited, "Number of dag nodes visited");
+STATISTIC(NodesOverVisitLimit,
+          "Number of dag node visits skipped due to the visit limit");
 
 static cl::opt<bool>
 CombinerGlobalAA("combiner-global-alias-analysis", cl::Hidden,
@@ -137,6 +140,11 @@ static cl::opt<bool> EnableShrinkLoadReplaceStoreWithStore(
     cl::desc("DAG combiner enable load/<replace bytes>/store with "
              "a narrower store"));
 
+static cl::opt<unsigned> MaxVisitsPerNode(
+    "combiner-max-visits-per-node", cl::Hidden, cl::init(0),
+    cl::desc("Limit the number of times a node is combined in one run of the "
+             "DAG combiner (0 = no limit)"));
+
 static cl::opt<bool> EnableVectorFCopySignExtendRound(
     "combiner-vector-fcopysign-extend-round", cl::Hidden, cl::init(false),
     cl::desc(
@@ -191,6 +199,12 @@ namespace {
     /// candidate again.
     DenseMap<SDNode *, std::pair<SDNode *, unsigned>> StoreRootCountMap;
 
+    /// Number of times each node has been combined in this run, only tracked
+    /// if -combiner-max-visits-per-node is set. Nodes that keep being added
+    /// back to the worklist, e.g. as users of nodes that are combined over and
+    /// over in huge DAGs, stop being combined once they reach the limit.
+    DenseMap<SDNode *, unsigned> VisitCounts;
+
     // AA - Used for DAG load/store alias analysis.
     AliasAnalysis *AA;
 
@@ -286,6 +300,7 @@ namespace {
       CombinedNodes.erase(N);
       PruningList.remove(N);
       StoreRootCountMap.erase(N);
+      VisitCounts.erase(N);
 
       auto It = WorklistMap.find(N);
       if (It == WorklistMap.end())
@@ -1843,6 +1858,13 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
         continue;
     }
 
+    ++NodesVisited;
+    if (MaxVisitsPerNode && ++VisitCounts[N] > MaxVisitsPerNode) {
+      ++NodesOverVisitLimit;
+      LLVM_DEBUG(dbgs() << "\nVisit limit reached: "; N->dump(&DAG));
+      continue;
+    }
+
     LLVM_DEBUG(dbgs() << "\nCombining: "; N->dump(&DAG));
 
     // Add any operands of the new node which have not yet been combined to the
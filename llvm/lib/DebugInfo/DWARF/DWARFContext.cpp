@@ -51,6 +51,7 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstdint>
@@ -1390,6 +1391,31 @@ bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
   return Success;
 }
 
+void DWARFContext::extractNormalUnitsInParallel(unsigned NumThreads) {
+  DWARFUnitVector &Units = State->getNormalUnits();
+  if (Units.size() < 2)
+    return;
+
+  // Abbreviation sets are cached by the context, so parse them on this thread
+  // first. Extracting the DIEs of a unit then only updates the unit itself.
+  for (const std::unique_ptr<DWARFUnit> &U : Units)
+    U->getAbbreviations();
+
+  std::vector<std::optional<Error>> Errors(Units.size());
+  {
+    ThreadPool Pool(hardware_concurrency(NumThreads));
+    for (size_t I = 0, E = Units.size(); I != E; ++I)
+      Pool.async([&, I]() {
+        Errors[I] = Units[I]->tryExtractDIEsIfNeeded(/*CUDieOnly=*/false);
+      });
+    Pool.wait();
+  }
+
+  for (std::optional<Error> &Err : Errors)
+    if (*Err)
+      getRecoverableErrorHandler()(std::move(*Err));
+}
+
 const DWARFUnitIndex &DWARFContext::getCUIndex() {
   return State->getCUIndex();
 }
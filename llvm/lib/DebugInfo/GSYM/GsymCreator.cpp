@@ -10,6 +10,7 @@
 #include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -225,12 +226,16 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
   if (!IsSegment) {
     if (NumBefore > 1) {
       // Sort function infos so we can emit sorted functions.
-      llvm::sort(Funcs);
-      std::vector<FunctionInfo> FinalizedFuncs;
-      FinalizedFuncs.reserve(Funcs.size());
-      FinalizedFuncs.emplace_back(std::move(Funcs.front()));
+      llvm::parallelSort(Funcs.begin(), Funcs.end());
+      // Unique the function infos in place, the kept ones being moved to the
+      // front of Funcs, so that they are never held twice in memory.
+      size_t Last = 0;
+      auto Keep = [&](size_t Idx) {
+        if (++Last != Idx)
+          Funcs[Last] = std::move(Funcs[Idx]);
+      };
       for (size_t Idx=1; Idx < NumBefore; ++Idx) {
-        FunctionInfo &Prev = FinalizedFuncs.back();
+        FunctionInfo &Prev = Funcs[Last];
         FunctionInfo &Curr = Funcs[Idx];
         // Empty ranges won't intersect, but we still need to
         // catch the case where we have multiple symbols at the
@@ -266,7 +271,7 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
                 << Prev << "\n"
                 << Curr << "\n";
             }
-            FinalizedFuncs.emplace_back(std::move(Curr));
+            Keep(Idx);
           }
         } else {
           if (Prev.Range.size() == 0 && Curr.Range.contains(Prev.Range.start())) {
@@ -275,11 +280,11 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
             // symbol function info with the current one.
             std::swap(Prev, Curr);
           } else {
-            FinalizedFuncs.emplace_back(std::move(Curr));
+            Keep(Idx);
           }
         }
       }
-      std::swap(Funcs, FinalizedFuncs);
+      Funcs.erase(Funcs.begin() + Last + 1, Funcs.end());
     }
     // If our last function info entry doesn't have a size and if we have valid
     // text ranges, we should set the size of the last entry since any search for
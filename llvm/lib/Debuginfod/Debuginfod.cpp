@@ -24,6 +24,7 @@
 #include "llvm/Debuginfod/Debuginfod.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/BinaryFormat/Magic.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
@@ -211,6 +212,65 @@ static SmallVector<std::string, 0> getHeaders() {
   return Headers;
 }
 
+namespace {
+
+/// The artifacts which every debuginfod server reported as not found. They are
+/// remembered only for a while, as they may be uploaded later.
+class MissingArtifacts {
+public:
+  bool contains(StringRef Key) {
+    std::lock_guard<std::mutex> Guard(Mutex);
+    auto It = Keys.find(Key);
+    if (It == Keys.end())
+      return false;
+    if (It->second > std::chrono::steady_clock::now())
+      return true;
+    Keys.erase(It);
+    return false;
+  }
+
+  void insert(StringRef Key) {
+    std::lock_guard<std::mutex> Guard(Mutex);
+    auto Now = std::chrono::steady_clock::now();
+    if (Keys.size() >= MaxSize) {
+      for (auto It = Keys.begin(), End = Keys.end(); It != End;) {
+        auto Cur = It++;
+        if (Cur->second <= Now)
+          Keys.erase(Cur);
+      }
+      // Don't let the set grow without bounds when many artifacts are missing
+      // at once; forgetting them only costs another query.
+      if (Keys.size() >= MaxSize)
+        Keys.clear();
+    }
+    Keys[Key] = Now + TimeToLive;
+  }
+
+private:
+  static constexpr size_t MaxSize = 4096;
+  static constexpr std::chrono::minutes TimeToLive{5};
+
+  std::mutex Mutex;
+  /// Maps the keys to the time their entries expire.
+  StringMap<std::chrono::steady_clock::time_point> Keys;
+};
+
+} // namespace
+
+static MissingArtifacts &getMissingArtifacts() {
+  static MissingArtifacts Missing;
+  return Missing;
+}
+
+static std::string missingArtifactKey(StringRef UniqueKey,
+                                      StringRef CacheDirectoryPath,
+                                      ArrayRef<StringRef> DebuginfodUrls) {
+  std::string Key = (CacheDirectoryPath + "\n" + UniqueKey).str();
+  for (StringRef ServerUrl : DebuginfodUrls)
+    Key += ("\n" + ServerUrl).str();
+  return Key;
+}
+
 Expected<std::string> getCachedOrDownloadArtifact(
     StringRef UniqueKey, StringRef UrlPath, StringRef CacheDirectoryPath,
     ArrayRef<StringRef> DebuginfodUrls, std::chrono::milliseconds Timeout) {
@@ -232,8 +292,15 @@ Expected<std::string> getCachedOrDownloadArtifact(
   AddStreamFn &CacheAddStream = *CacheAddStreamOrErr;
   if (!CacheAddStream)
     return std::string(AbsCachedArtifactPath);
-  // The artifact was not found in the local cache, query the debuginfod
-  // servers.
+  // The artifact was not found in the local cache. Don't query the debuginfod
+  // servers again if all of them reported it as not found a moment ago.
+  std::string MissingKey =
+      missingArtifactKey(UniqueKey, CacheDirectoryPath, DebuginfodUrls);
+  if (getMissingArtifacts().contains(MissingKey))
+    return createStringError(errc::argument_out_of_domain,
+                             "build id not found");
+
+  // Query the debuginfod servers.
   if (!HTTPClient::isAvailable())
     return createStringError(errc::io_error,
                              "No working HTTP client is available.");
@@ -247,6 +314,9 @@ Expected<std::string> getCachedOrDownloadArtifact(
 
   HTTPClient Client;
   Client.setTimeout(Timeout);
+  // Only a definite answer from every server is remembered. Server errors and
+  // rate limiting are usually transient.
+  bool AllNotFound = !DebuginfodUrls.empty();
   for (StringRef ServerUrl : DebuginfodUrls) {
     SmallString<64> ArtifactUrl;
     sys::path::append(ArtifactUrl, sys::path::Style::posix, ServerUrl, UrlPath);
@@ -263,6 +333,8 @@ Expected<std::string> getCachedOrDownloadArtifact(
         return std::move(Err);
 
       unsigned Code = Client.responseCode();
+      if (Code != 404)
+        AllNotFound = false;
       if (Code && Code != 200)
         continue;
     }
@@ -277,6 +349,8 @@ Expected<std::string> getCachedOrDownloadArtifact(
     return std::string(AbsCachedArtifactPath);
   }
 
+  if (AllNotFound)
+    getMissingArtifacts().insert(MissingKey);
   return createStringError(errc::argument_out_of_domain, "build id not found");
 }
 
@@ -9,7 +9,8 @@
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 
 #include "llvm/ADT/SmallVector.h"
-#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
 #include "llvm/MC/MCContext.h"
@@ -17,6 +18,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Target/TargetMachine.h"
 
@@ -92,5 +94,114 @@ ConcurrentIRCompiler::operator()(Module &M) {
   return C(M);
 }
 
+Expected<std::unique_ptr<FileObjectCache>>
+FileObjectCache::Create(const Twine &CacheDir, const TargetMachine &TM) {
+  std::unique_ptr<FileObjectCache> C(new FileObjectCache(TM));
+  auto CacheOrErr = localCache(
+      "ObjectCache", "llvm-orc-object", CacheDir,
+      [C = C.get()](unsigned Task, const Twine &ModuleName,
+                    std::unique_ptr<MemoryBuffer> MB) {
+        C->addBuffer(Task, std::move(MB));
+      });
+  if (!CacheOrErr)
+    return CacheOrErr.takeError();
+  C->Cache = std::move(*CacheOrErr);
+  return std::move(C);
+}
+
+std::unique_ptr<FileObjectCache>
+FileObjectCache::Create(std::shared_ptr<CacheStore> Store,
+                        const TargetMachine &TM) {
+  std::unique_ptr<FileObjectCache> C(new FileObjectCache(TM));
+  C->Cache = storeCache("ObjectCache", std::move(Store),
+                        [C = C.get()](unsigned Task, const Twine &ModuleName,
+                                      std::unique_ptr<MemoryBuffer> MB) {
+                          C->addBuffer(Task, std::move(MB));
+                        });
+  return C;
+}
+
+FileObjectCache::FileObjectCache(const TargetMachine &TM) {
+  raw_string_ostream OS(TargetKey);
+  OS << TM.getTargetTriple().str() << '\0' << TM.getTargetCPU() << '\0'
+     << TM.getTargetFeatureString() << '\0'
+     << static_cast<int>(TM.getOptLevel()) << '\0'
+     << static_cast<int>(TM.getRelocationModel()) << '\0'
+     << static_cast<int>(TM.getCodeModel());
+}
+
+void FileObjectCache::addBuffer(unsigned Task,
+                                std::unique_ptr<MemoryBuffer> MB) {
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  Buffers[Task] = std::move(MB);
+}
+
+std::unique_ptr<MemoryBuffer> FileObjectCache::getObject(const Module *M) {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(*M, OS);
+  }
+  SHA1 Hasher;
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+  std::string Key = toHex(Hasher.result());
+
+  unsigned Task;
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    Task = NextTask++;
+  }
+
+  // The cache calls addBuffer before returning on a hit, so it must not be
+  // called with the lock held. Errors accessing the cache make it miss.
+  auto AddStream = Cache(Task, Key, M->getModuleIdentifier());
+  if (!AddStream) {
+    consumeError(AddStream.takeError());
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  if (*AddStream) {
+    // The key is computed before compiling M, which may modify it, so the
+    // stream is kept until the object is compiled.
+    PendingObjects[M] = {Task, std::move(*AddStream)};
+    return nullptr;
+  }
+
+  auto I = Buffers.find(Task);
+  if (I == Buffers.end())
+    return nullptr;
+  auto Obj = std::move(I->second);
+  Buffers.erase(I);
+  return Obj;
+}
+
+void FileObjectCache::notifyObjectCompiled(const Module *M,
+                                           MemoryBufferRef Obj) {
+  unsigned Task;
+  AddStreamFn AddStream;
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto I = PendingObjects.find(M);
+    if (I == PendingObjects.end())
+      return;
+    std::tie(Task, AddStream) = std::move(I->second);
+    PendingObjects.erase(I);
+  }
+
+  auto Stream = AddStream(Task, M->getModuleIdentifier());
+  if (!Stream) {
+    consumeError(Stream.takeError());
+    return;
+  }
+  *(*Stream)->OS << Obj.getBuffer();
+  // Destroying the stream commits the entry, and passes it back to addBuffer.
+  Stream->reset();
+
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  Buffers.erase(Task);
+}
+
 } // end namespace orc
 } // end namespace llvm
@@ -64,6 +64,25 @@ void InProcessMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
   ExecutorAddr MinAddr(~0ULL);
   ExecutorAddr MaxAddr(0);
 
+  // Segments are laid out contiguously, and segments with the same
+  // protections (e.g. with standard and finalize lifetimes) are adjacent.
+  // Protect each run of adjacent segments with the same protections at once,
+  // rather than making a syscall per segment.
+  ExecutorAddr RunStart, RunEnd;
+  MemProt RunProt = MemProt::None;
+  auto ProtectRun = [&]() -> Error {
+    if (RunStart == RunEnd)
+      return Error::success();
+    if (auto EC = sys::Memory::protectMappedMemory(
+            {RunStart.toPtr<void *>(), RunEnd - RunStart},
+            toSysMemoryProtectionFlags(RunProt)))
+      return errorCodeToError(EC);
+    if ((RunProt & MemProt::Exec) == MemProt::Exec)
+      sys::Memory::InvalidateInstructionCache(RunStart.toPtr<void *>(),
+                                              RunEnd - RunStart);
+    return Error::success();
+  };
+
   // FIXME: Release finalize lifetime segments.
   for (auto &Segment : AI.Segments) {
     auto Base = AI.MappingBase + Segment.Offset;
@@ -78,14 +97,23 @@ void InProcessMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
     std::memset((Base + Segment.ContentSize).toPtr<void *>(), 0,
                 Segment.ZeroFillSize);
 
-    if (auto EC = sys::Memory::protectMappedMemory(
-            {Base.toPtr<void *>(), Size},
-            toSysMemoryProtectionFlags(Segment.AG.getMemProt()))) {
-      return OnInitialized(errorCodeToError(EC));
+    // Extend the current run if this segment starts on the page the run ends
+    // on, or on the page right after it.
+    auto Prot = Segment.AG.getMemProt();
+    if (RunStart != RunEnd && Prot == RunProt && Base >= RunStart &&
+        Base.getValue() <= alignTo(RunEnd.getValue(), PageSize)) {
+      RunEnd = std::max(RunEnd, Base + Size);
+      continue;
     }
-    if ((Segment.AG.getMemProt() & MemProt::Exec) == MemProt::Exec)
-      sys::Memory::InvalidateInstructionCache(Base.toPtr<void *>(), Size);
+
+    if (auto Err = ProtectRun())
+      return OnInitialized(std::move(Err));
+    RunStart = Base;
+    RunEnd = Base + Size;
+    RunProt = Prot;
   }
+  if (auto Err = ProtectRun())
+    return OnInitialized(std::move(Err));
 
   auto DeinitializeActions = shared::runFinalizeActions(AI.Actions);
   if (!DeinitializeActions)
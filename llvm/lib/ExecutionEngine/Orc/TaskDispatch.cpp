@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ExecutionEngine/Orc/TaskDispatch.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
 
 namespace llvm {
 namespace orc {
@@ -24,16 +25,48 @@ void InPlaceTaskDispatcher::shutdown() {}
 
 #if LLVM_ENABLE_THREADS
 void DynamicThreadPoolTaskDispatcher::dispatch(std::unique_ptr<Task> T) {
+  bool IsMaterializationTask = isa<MaterializationTask>(*T);
+
   {
     std::lock_guard<std::mutex> Lock(DispatchMutex);
+
+    if (IsMaterializationTask) {
+      // If there are already too many materialization tasks running then
+      // queue this one up, it will be picked up by one of the running
+      // materialization threads.
+      if (MaxMaterializationThreads &&
+          NumMaterializationThreads == *MaxMaterializationThreads) {
+        MaterializationTaskQueue.push_back(std::move(T));
+        return;
+      }
+      ++NumMaterializationThreads;
+    }
+
     ++Outstanding;
   }
 
-  std::thread([this, T = std::move(T)]() mutable {
-    T->run();
-    std::lock_guard<std::mutex> Lock(DispatchMutex);
-    --Outstanding;
-    OutstandingCV.notify_all();
+  std::thread([this, T = std::move(T), IsMaterializationTask]() mutable {
+    while (true) {
+      T->run();
+      // Destroy the task before taking the lock: its destructor may run
+      // arbitrary code.
+      T.reset();
+
+      std::lock_guard<std::mutex> Lock(DispatchMutex);
+
+      // Run any queued materialization tasks on this thread.
+      if (IsMaterializationTask && !MaterializationTaskQueue.empty()) {
+        T = std::move(MaterializationTaskQueue.front());
+        MaterializationTaskQueue.pop_front();
+        continue;
+      }
+
+      if (IsMaterializationTask)
+        --NumMaterializationThreads;
+      --Outstanding;
+      OutstandingCV.notify_all();
+      return;
+    }
   }).detach();
 }
 
@@ -88,6 +88,10 @@ void LLVMRemarkStreamer::emit(const DiagnosticInfoOptimizationBase &Diag) {
   RS.getSerializer().emit(R);
 }
 
+bool LLVMRemarkStreamer::isEnabled(StringRef PassName) {
+  return RS.matchesFilter(PassName);
+}
+
 char LLVMRemarkSetupFileError::ID = 0;
 char LLVMRemarkSetupPatternError::ID = 0;
 char LLVMRemarkSetupFormatError::ID = 0;
@@ -876,7 +876,11 @@ void ELFWriter::writeSectionData(const MCAssembler &Asm, MCSection &Sec,
     return;
   }
 
+  // Debug sections are often the largest ones in the object. Size the buffer
+  // up front rather than growing it by doubling, which may temporarily take
+  // twice the memory of the section and copies its contents each time.
   SmallVector<char, 128> UncompressedData;
+  UncompressedData.reserve(Layout.getSectionFileSize(&Section));
   raw_svector_ostream VecOS(UncompressedData);
   Asm.writeSectionData(VecOS, &Section, Layout);
   ArrayRef<uint8_t> Uncompressed =
@@ -839,15 +839,22 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
       Frag.setLayoutOrder(FragmentIndex++);
   }
 
-  // Layout until everything fits.
-  while (layoutOnce(Layout)) {
+  // Layout until everything fits. Size of fragments in one section can depend
+  // on the size of fragments in another, so when a section is relaxed all the
+  // other sections have to be laid out (and possibly further relaxed) again.
+  // Visit the sections round-robin until each of them has been checked once
+  // since the last change, which doesn't recheck the sections that have been
+  // checked after that change already.
+  unsigned NumStable = 0;
+  for (unsigned I = 0; NumStable != Sections.size();
+       I = (I + 1) % Sections.size()) {
+    if (!layoutSectionUntilStable(Layout, *Sections[I])) {
+      ++NumStable;
+      continue;
+    }
     if (getContext().hadError())
       return;
-    // Size of fragments in one section can depend on the size of fragments in
-    // another. If any fragment has changed size, we have to re-layout (and
-    // as a result possibly further relax) all.
-    for (MCSection &Sec : *this)
-      Layout.invalidateFragmentsFrom(&*Sec.begin());
+    NumStable = 1;
   }
 
   DEBUG_WITH_TYPE("mc-dump", {
@@ -1216,13 +1223,16 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
   return false;
 }
 
-bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
+bool MCAssembler::layoutSectionUntilStable(MCAsmLayout &Layout,
+                                           MCSection &Sec) {
   ++stats::RelaxationSteps;
 
   bool WasRelaxed = false;
-  for (MCSection &Sec : *this) {
-    while (layoutSectionOnce(Layout, Sec))
-      WasRelaxed = true;
+  while (layoutSectionOnce(Layout, Sec)) {
+    WasRelaxed = true;
+    for (MCSection &Other : *this)
+      if (&Other != &Sec)
+        Layout.invalidateFragmentsFrom(&*Other.begin());
   }
 
   return WasRelaxed;
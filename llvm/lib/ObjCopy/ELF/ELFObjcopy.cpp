@@ -31,6 +31,7 @@
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -522,13 +523,20 @@ static Error replaceAndRemoveSections(const CommonConfig &Config,
     return E;
 
   if (Config.CompressionType != DebugCompressionType::None) {
+    SmallVector<CompressedSection *, 0> ToCompress;
     if (Error Err = replaceDebugSections(
             Obj, isCompressable,
-            [&Config, &Obj](const SectionBase *S) -> Expected<SectionBase *> {
-              return &Obj.addSection<CompressedSection>(
+            [&Config, &Obj,
+             &ToCompress](const SectionBase *S) -> Expected<SectionBase *> {
+              CompressedSection &CS = Obj.addSection<CompressedSection>(
                   CompressedSection(*S, Config.CompressionType, Obj.Is64Bits));
+              ToCompress.push_back(&CS);
+              return &CS;
             }))
       return Err;
+    // Compressing dominates the run time for large debug sections, and each
+    // section is compressed independently.
+    parallelForEach(ToCompress, [](CompressedSection *CS) { CS->compress(); });
   } else if (Config.DecompressDebugSections) {
     if (Error Err = replaceDebugSections(
             Obj,
@@ -543,16 +543,21 @@ CompressedSection::CompressedSection(const SectionBase &Sec,
                                      bool Is64Bits)
     : SectionBase(Sec), CompressionType(CompressionType),
       DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
-  compression::compress(compression::Params(CompressionType), OriginalData,
-                        CompressedData);
-
   Flags |= ELF::SHF_COMPRESSED;
-  size_t ChdrSize = Is64Bits ? sizeof(object::Elf_Chdr_Impl<object::ELF64LE>)
-                             : sizeof(object::Elf_Chdr_Impl<object::ELF32LE>);
-  Size = ChdrSize + CompressedData.size();
+  // Only the header for now, compress() adds the size of the compressed data.
+  Size = Is64Bits ? sizeof(object::Elf_Chdr_Impl<object::ELF64LE>)
+                  : sizeof(object::Elf_Chdr_Impl<object::ELF32LE>);
   Align = 8;
 }
 
+void CompressedSection::compress() {
+  assert(CompressionType != DebugCompressionType::None &&
+         CompressedData.empty() && "section is already compressed");
+  compression::compress(compression::Params(CompressionType), OriginalData,
+                        CompressedData);
+  Size += CompressedData.size();
+}
+
 CompressedSection::CompressedSection(ArrayRef<uint8_t> CompressedData,
                                      uint32_t ChType, uint64_t DecompressedSize,
                                      uint64_t DecompressedAlign)
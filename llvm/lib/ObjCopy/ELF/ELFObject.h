@@ -547,11 +547,19 @@ class CompressedSection : public SectionBase {
   SmallVector<uint8_t, 128> CompressedData;
 
 public:
+  /// Create a section that holds \p Sec compressed with \p CompressionType.
+  /// The data is only compressed by a later call to compress(), which lets
+  /// several sections be compressed concurrently.
   CompressedSection(const SectionBase &Sec,
     DebugCompressionType CompressionType, bool Is64Bits);
   CompressedSection(ArrayRef<uint8_t> CompressedData, uint32_t ChType,
                     uint64_t DecompressedSize, uint64_t DecompressedAlign);
 
+  /// Compress the original section data and update the section size. Only
+  /// touches this section, so it is safe to call for different sections from
+  /// different threads.
+  void compress();
+
   uint64_t getDecompressedSize() const { return DecompressedSize; }
   uint64_t getDecompressedAlign() const { return DecompressedAlign; }
   uint64_t getChType() const { return ChType; }
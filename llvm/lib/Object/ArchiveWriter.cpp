@@ -15,11 +15,13 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/Error.h"
 #include "llvm/Object/IRObjectFile.h"
+#include "llvm/Object/IRSymtab.h"
 #include "llvm/Object/MachO.h"
 #include "llvm/Object/ObjectFile.h"
 #include "llvm/Object/SymbolicFile.h"
@@ -709,6 +711,61 @@ static Expected<std::vector<unsigned>> getSymbols(SymbolicFile *Obj,
   return Ret;
 }
 
+// Bitcode members would otherwise be opened as IRObjectFiles, which lazily
+// parses every module into the shared LLVMContext. Outside of AIX big archives
+// only the symbol names are needed, and the irsymtab stored in the bitcode
+// provides them without parsing any module.
+static bool useIRSymtab(object::Archive::Kind Kind, MemoryBufferRef Buf) {
+  return !isAIXBigArchive(Kind) &&
+         identify_magic(Buf.getBuffer()) == file_magic::bitcode;
+}
+
+static Expected<std::vector<unsigned>> getIRSymbols(MemoryBufferRef Buf,
+                                                    uint16_t Index,
+                                                    raw_ostream &SymNames,
+                                                    SymMap *SymMap) {
+  Expected<BitcodeFileContents> BFCOrErr = getBitcodeFileContents(Buf);
+  if (!BFCOrErr)
+    return BFCOrErr.takeError();
+  Expected<irsymtab::FileContents> FCOrErr = irsymtab::readBitcode(*BFCOrErr);
+  if (!FCOrErr)
+    return FCOrErr.takeError();
+  irsymtab::Reader R({FCOrErr->Symtab.data(), FCOrErr->Symtab.size()},
+                     {FCOrErr->Strtab.data(), FCOrErr->Strtab.size()});
+
+  std::map<std::string, uint16_t> *Map = nullptr;
+  if (SymMap) {
+    bool IsEC = false;
+    if (SymMap->UseECMap) {
+      Triple T(R.getTargetTriple());
+      IsEC = T.isWindowsArm64EC() || T.getArch() == Triple::x86_64;
+    }
+    Map = IsEC ? &SymMap->ECMap : &SymMap->Map;
+  }
+
+  // Keep the same symbols, in the same order, as isArchiveSymbol does for the
+  // IRObjectFile of this member.
+  std::vector<unsigned> Ret;
+  for (const irsymtab::Reader::SymbolRef &S : R.symbols()) {
+    if (S.isFormatSpecific() || !S.isGlobal() || S.isUndefined())
+      continue;
+    StringRef Name = S.getName();
+    if (Map) {
+      if (Map->find(std::string(Name)) != Map->end())
+        continue; // ignore duplicated symbol
+      (*Map)[std::string(Name)] = Index;
+      if (Map == &SymMap->Map) {
+        Ret.push_back(SymNames.tell());
+        SymNames << Name << '\0';
+      }
+    } else {
+      Ret.push_back(SymNames.tell());
+      SymNames << Name << '\0';
+    }
+  }
+  return Ret;
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
@@ -820,9 +877,14 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
     }
 
     if (NeedSymbols != SymtabWritingMode::NoSymtab || isAIXBigArchive(Kind)) {
-      auto SetNextSymFile = [&NextSymFile,
-                             &Context](MemoryBufferRef Buf,
-                                       StringRef MemberName) -> Error {
+      auto SetNextSymFile = [&NextSymFile, &Context,
+                             Kind](MemoryBufferRef Buf,
+                                   StringRef MemberName) -> Error {
+        if (useIRSymtab(Kind, Buf)) {
+          // The symbols are read from the irsymtab instead, see getIRSymbols.
+          NextSymFile = nullptr;
+          return Error::success();
+        }
         Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr =
             getSymbolicFile(Buf, Context);
         if (!SymFileOrErr)
@@ -883,12 +945,14 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
 
     std::vector<unsigned> Symbols;
     if (NeedSymbols != SymtabWritingMode::NoSymtab) {
+      bool IsIR = useIRSymtab(Kind, Buf);
       Expected<std::vector<unsigned>> SymbolsOrErr =
-          getSymbols(CurSymFile.get(), Index, SymNames, SymMap);
+          IsIR ? getIRSymbols(Buf, Index, SymNames, SymMap)
+               : getSymbols(CurSymFile.get(), Index, SymNames, SymMap);
       if (!SymbolsOrErr)
         return createFileError(M->MemberName, SymbolsOrErr.takeError());
       Symbols = std::move(*SymbolsOrErr);
-      if (CurSymFile)
+      if (CurSymFile || IsIR)
         HasObject = true;
     }
 
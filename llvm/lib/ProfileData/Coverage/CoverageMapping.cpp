@@ -207,6 +207,16 @@ unsigned CounterMappingContext::getMaxCounterID(const Counter &C) const {
 }
 
 void FunctionRecordIterator::skipOtherFiles() {
+  if (RecordIndices) {
+    while (CurrentIndex != RecordIndices->end() &&
+           Filename != Records[*CurrentIndex].Filenames[0])
+      ++CurrentIndex;
+    if (CurrentIndex == RecordIndices->end())
+      *this = FunctionRecordIterator();
+    else
+      Current = Records.begin() + *CurrentIndex;
+    return;
+  }
   while (Current != Records.end() && !Filename.empty() &&
          Filename != Current->Filenames[0])
     ++Current;
@@ -833,7 +833,7 @@ data_type InstrProfLookupTrait::ReadData(StringRef K, const unsigned char *D,
 
 template <typename HashTableImpl>
 Error InstrProfReaderIndex<HashTableImpl>::getRecords(
-    StringRef FuncName, ArrayRef<NamedInstrProfRecord> &Data) {
+    StringRef FuncName, MutableArrayRef<NamedInstrProfRecord> &Data) {
   auto Iter = HashTable->find(FuncName);
   if (Iter == HashTable->end())
     return make_error<InstrProfError>(instrprof_error::unknown_function);
@@ -888,7 +888,7 @@ public:
       : Underlying(Underlying) {}
 
   Error getRecords(StringRef FuncName,
-                   ArrayRef<NamedInstrProfRecord> &Data) override {
+                   MutableArrayRef<NamedInstrProfRecord> &Data) override {
     return Underlying.getRecords(FuncName, Data);
   }
 };
@@ -947,7 +947,7 @@ public:
   }
 
   Error getRecords(StringRef FuncName,
-                   ArrayRef<NamedInstrProfRecord> &Data) override {
+                   MutableArrayRef<NamedInstrProfRecord> &Data) override {
     StringRef RealName = extractName(FuncName);
     if (auto Key = Remappings.lookup(RealName)) {
       StringRef Remapped = MappedNames.lookup(Key);
@@ -1216,7 +1216,7 @@ InstrProfSymtab &IndexedInstrProfReader::getSymtab() {
 Expected<InstrProfRecord> IndexedInstrProfReader::getInstrProfRecord(
     StringRef FuncName, uint64_t FuncHash, StringRef DeprecatedFuncName,
     uint64_t *MismatchedFuncSum) {
-  ArrayRef<NamedInstrProfRecord> Data;
+  MutableArrayRef<NamedInstrProfRecord> Data;
   uint64_t FuncSum = 0;
   auto Err = Remapper->getRecords(FuncName, Data);
   if (Err) {
@@ -1251,8 +1251,10 @@ Expected<InstrProfRecord> IndexedInstrProfReader::getInstrProfRecord(
     return ValueSum;
   };
 
-  for (const NamedInstrProfRecord &I : Data) {
-    // Check for a match and fill the vector if there is one.
+  for (NamedInstrProfRecord &I : Data) {
+    // Check for a match and fill the vector if there is one. The record lives
+    // in the lookup buffer, so move it out rather than copying its counters
+    // and value profile data.
     if (I.Hash == FuncHash)
       return std::move(I);
     if (NamedInstrProfRecord::hasCSFlagInHash(I.Hash) ==
@@ -1315,7 +1317,7 @@ Error IndexedInstrProfReader::getFunctionCounts(StringRef FuncName,
   if (Error E = Record.takeError())
     return error(std::move(E));
 
-  Counts = Record.get().Counts;
+  Counts = std::move(Record.get().Counts);
   return success();
 }
 
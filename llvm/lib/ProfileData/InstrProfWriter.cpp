@@ -348,9 +348,13 @@ void InstrProfWriter::addTemporalProfileTraces(
 
 void InstrProfWriter::mergeRecordsFromWriter(InstrProfWriter &&IPW,
                                              function_ref<void(Error)> Warn) {
-  for (auto &I : IPW.FunctionData)
+  for (auto &I : IPW.FunctionData) {
     for (auto &Func : I.getValue())
       addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
+    // Records merged into existing ones are left intact, so free them as we go
+    // rather than holding both writers' counters until IPW is destroyed.
+    I.getValue().clear();
+  }
 
   BinaryIds.reserve(BinaryIds.size() + IPW.BinaryIds.size());
   for (auto &I : IPW.BinaryIds)
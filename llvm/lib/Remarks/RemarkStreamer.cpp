@@ -38,14 +38,18 @@ Error RemarkStreamer::setFilter(StringRef Filter) {
     return createStringError(std::make_error_code(std::errc::invalid_argument),
                              RegexError.data());
   PassFilter = std::move(R);
+  PassFilterCache.clear();
   return Error::success();
 }
 
 bool RemarkStreamer::matchesFilter(StringRef Str) {
-  if (PassFilter)
-    return PassFilter->match(Str);
   // No filter means all strings pass.
-  return true;
+  if (!PassFilter)
+    return true;
+  auto [It, Inserted] = PassFilterCache.try_emplace(Str, false);
+  if (Inserted)
+    It->second = PassFilter->match(Str);
+  return It->second;
 }
 
 bool RemarkStreamer::needsSection() const {
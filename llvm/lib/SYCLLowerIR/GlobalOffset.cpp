@@ -26,6 +26,10 @@ using namespace llvm;
 static cl::opt<bool>
     EnableGlobalOffset("enable-global-offset", cl::Hidden, cl::init(true),
                        cl::desc("Enable SYCL global offset pass"));
+static cl::opt<bool> AssumeNoGlobalOffset(
+    "sycl-assume-no-global-offset", cl::Hidden, cl::init(false),
+    cl::desc("Assume SYCL kernels are never launched with a global offset "
+             "and use a zero offset instead of an implicit offset argument"));
 namespace llvm {
 ModulePass *createGlobalOffsetPass();
 void initializeGlobalOffsetPass(PassRegistry &);
@@ -85,6 +89,23 @@ PreservedAnalyses GlobalOffsetPass::run(Module &M, ModuleAnalysisManager &) {
   assert((ImplicitOffsetIntrinsic->getReturnType() == ImplicitOffsetPtrType) &&
          "Implicit offset intrinsic does not return the expected type");
 
+  // Without offsets there is no need for the implicit argument nor for the
+  // `_with_offset` clones of the kernels, every use of the offset reads zeros.
+  if (AssumeNoGlobalOffset) {
+    SmallVector<User *, 8> Users{ImplicitOffsetIntrinsic->users()};
+    for (User *U : Users) {
+      auto *Call = cast<CallInst>(U);
+      Function *Caller = Call->getFunction();
+      Value *&ZeroOffset = ProcessedFunctions[Caller];
+      if (!ZeroOffset)
+        ZeroOffset = createZeroImplicitOffset(Caller);
+      Call->replaceAllUsesWith(ZeroOffset);
+      Call->eraseFromParent();
+    }
+    ImplicitOffsetIntrinsic->eraseFromParent();
+    return PreservedAnalyses::none();
+  }
+
   SmallVector<KernelPayload, 4> KernelPayloads;
   TargetHelpers::populateKernels(M, KernelPayloads, AT);
 
@@ -140,6 +161,11 @@ void GlobalOffsetPass::processKernelEntryPoint(Function *Func) {
   KernelMetadata->addOperand(MDNode::get(Ctx, NewMetadata));
 
   // Create alloca of zeros for the implicit offset in the original func.
+  ProcessedFunctions[Func] = createZeroImplicitOffset(Func);
+}
+
+Value *GlobalOffsetPass::createZeroImplicitOffset(Function *Func) {
+  Module &M = *Func->getParent();
   BasicBlock *EntryBlock = &Func->getEntryBlock();
   IRBuilder<> Builder(EntryBlock, EntryBlock->getFirstInsertionPt());
   Type *ImplicitOffsetType =
@@ -153,8 +179,8 @@ void GlobalOffsetPass::processKernelEntryPoint(Function *Func) {
                            ImplicitOffset->getAlign());
   MemsetCall->addParamAttr(0, Attribute::NonNull);
   MemsetCall->addDereferenceableParamAttr(0, AllocByteSize);
-  ProcessedFunctions[Func] = Builder.CreateConstInBoundsGEP2_32(
-      ImplicitOffsetType, ImplicitOffset, 0, 0);
+  return Builder.CreateConstInBoundsGEP2_32(ImplicitOffsetType, ImplicitOffset,
+                                            0, 0);
 }
 
 void GlobalOffsetPass::addImplicitParameterToCallers(
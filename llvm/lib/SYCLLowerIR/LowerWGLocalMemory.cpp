@@ -9,10 +9,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/SYCLLowerIR/LowerWGLocalMemory.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Analysis/CFG.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace llvm;
 
@@ -20,6 +25,12 @@ using namespace llvm;
 
 static constexpr char SYCL_ALLOCLOCALMEM_CALL[] = "__sycl_allocateLocalMemory";
 static constexpr char LOCALMEMORY_GV_PREF[] = "WGLocalMem";
+static constexpr char SPIRV_CONTROL_BARRIER[] = "__spirv_ControlBarrier";
+
+static cl::opt<bool> ShareWGLocalMemory(
+    "sycl-share-wg-local-memory", cl::Hidden, cl::init(false),
+    cl::desc("Let local memory allocations of a kernel which are separated by "
+             "a work-group barrier share the same memory"));
 
 namespace {
 class SYCLLowerWGLocalMemoryLegacy : public ModulePass {
@@ -60,7 +71,7 @@ ModulePass *llvm::createSYCLLowerWGLocalMemoryLegacyPass() {
 // to make it consistent with OpenCL restriction.
 // But LLVM pass is not the best place to diagnose these cases.
 // Error checking should be done in the front-end compiler.
-static void lowerAllocaLocalMemCall(CallInst *CI, Module &M) {
+static GlobalVariable *lowerAllocaLocalMemCall(CallInst *CI, Module &M) {
   assert(CI);
 
   Value *ArgSize = CI->getArgOperand(0);
@@ -88,6 +99,149 @@ static void lowerAllocaLocalMemCall(CallInst *CI, Module &M) {
   Value *GVPtr =
       Builder.CreatePointerCast(LocalMemArrayGV, Builder.getInt8PtrTy(LocalAS));
   CI->replaceAllUsesWith(GVPtr);
+  return LocalMemArrayGV;
+}
+
+namespace {
+/// Local memory lowered from an allocation call, with the instructions
+/// accessing it.
+struct LocalMemAlloc {
+  GlobalVariable *GV;
+  SmallVector<Instruction *, 8> Accesses;
+};
+} // namespace
+
+/// Collects the instructions accessing memory through \p V, a pointer derived
+/// from a local memory global.
+///
+/// \returns false if the pointer may escape or be compared, i.e. if sharing
+/// the memory with another allocation could be observed other than through
+/// the memory accesses.
+static bool collectAccesses(Value *V,
+                            SmallVectorImpl<Instruction *> &Accesses) {
+  for (User *U : V->users()) {
+    if (auto *CE = dyn_cast<ConstantExpr>(U)) {
+      if (!collectAccesses(CE, Accesses))
+        return false;
+      continue;
+    }
+    auto *I = dyn_cast<Instruction>(U);
+    if (!I)
+      return false;
+    if (isa<GetElementPtrInst>(I) || isa<BitCastInst>(I) ||
+        isa<AddrSpaceCastInst>(I)) {
+      if (!collectAccesses(I, Accesses))
+        return false;
+    } else if (auto *Store = dyn_cast<StoreInst>(I)) {
+      if (Store->getValueOperand() == V)
+        return false;
+      Accesses.push_back(I);
+    } else if (isa<LoadInst>(I) || isa<AtomicRMWInst>(I) ||
+               isa<MemIntrinsic>(I) || I->isLifetimeStartOrEnd()) {
+      Accesses.push_back(I);
+    } else if (auto *CmpXchg = dyn_cast<AtomicCmpXchgInst>(I)) {
+      if (CmpXchg->getPointerOperand() != V)
+        return false;
+      Accesses.push_back(I);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \returns true if \p CI is a work-group barrier which orders the accesses
+/// to work-group local memory.
+static bool isWGLocalMemoryBarrier(const CallInst *CI) {
+  const Function *Callee = CI->getCalledFunction();
+  if (!Callee || !Callee->getName().contains(SPIRV_CONTROL_BARRIER) ||
+      CI->arg_size() != 3)
+    return false;
+  // Workgroup execution scope, a memory scope of Workgroup or wider, i.e.
+  // Workgroup, Device or CrossDevice, and WorkgroupMemory semantics. With a
+  // narrower memory scope the accesses of other work-items aren't visible.
+  constexpr uint64_t ScopeWorkgroup = 2;
+  constexpr uint64_t WorkgroupMemory = 0x100;
+  auto *Execution = dyn_cast<ConstantInt>(CI->getArgOperand(0));
+  auto *Memory = dyn_cast<ConstantInt>(CI->getArgOperand(1));
+  auto *Semantics = dyn_cast<ConstantInt>(CI->getArgOperand(2));
+  return Execution && Memory && Semantics &&
+         Execution->getZExtValue() == ScopeWorkgroup &&
+         Memory->getZExtValue() <= ScopeWorkgroup &&
+         (Semantics->getZExtValue() & WorkgroupMemory);
+}
+
+/// \returns true if all the accesses in \p Before are done, by all the
+/// work-items of the group, before any access in \p After is made. This is
+/// the case if one of the \p Barriers dominates all the accesses in \p After
+/// and none of the accesses in \p Before can be reached from it.
+static bool isSeparatedByBarrier(ArrayRef<Instruction *> Before,
+                                 ArrayRef<Instruction *> After,
+                                 ArrayRef<CallInst *> Barriers,
+                                 const DominatorTree &DT) {
+  return any_of(Barriers, [&](CallInst *Barrier) {
+    return all_of(After,
+                  [&](Instruction *I) { return DT.dominates(Barrier, I); }) &&
+           none_of(Before, [&](Instruction *I) {
+             return isPotentiallyReachable(Barrier, I, nullptr, &DT);
+           });
+  });
+}
+
+/// Lets the local memory allocations of kernel \p F with disjoint lifetimes
+/// share the same global, so that the memory used by a work-group is the
+/// largest allocation of each set of allocations instead of their sum.
+static void shareLocalMemory(Function &F, ArrayRef<LocalMemAlloc> Allocs) {
+  SmallVector<CallInst *, 8> Barriers;
+  for (Instruction &I : instructions(F))
+    if (auto *CI = dyn_cast<CallInst>(&I))
+      if (isWGLocalMemoryBarrier(CI))
+        Barriers.push_back(CI);
+  if (Barriers.empty())
+    return;
+
+  DominatorTree DT(F);
+  auto CanShare = [&](const LocalMemAlloc &A, const LocalMemAlloc &B) {
+    return isSeparatedByBarrier(A.Accesses, B.Accesses, Barriers, DT) ||
+           isSeparatedByBarrier(B.Accesses, A.Accesses, Barriers, DT);
+  };
+  const DataLayout &DL = F.getParent()->getDataLayout();
+  auto SizeOf = [&](const LocalMemAlloc *A) {
+    return DL.getTypeAllocSize(A->GV->getValueType());
+  };
+
+  // Largest allocations first, so that each one is shared by a set of
+  // allocations which are at most as large.
+  SmallVector<const LocalMemAlloc *, 8> Sorted;
+  for (const LocalMemAlloc &A : Allocs)
+    Sorted.push_back(&A);
+  llvm::stable_sort(Sorted,
+                    [&](const LocalMemAlloc *A, const LocalMemAlloc *B) {
+                      return SizeOf(A) > SizeOf(B);
+                    });
+
+  SmallVector<SmallVector<const LocalMemAlloc *, 4>, 8> Groups;
+  for (const LocalMemAlloc *A : Sorted) {
+    auto *Group = find_if(Groups, [&](const auto &G) {
+      return all_of(G,
+                    [&](const LocalMemAlloc *M) { return CanShare(*M, *A); });
+    });
+    if (Group == Groups.end())
+      Groups.push_back({A});
+    else
+      Group->push_back(A);
+  }
+
+  for (const auto &Group : Groups) {
+    GlobalVariable *Shared = Group.front()->GV;
+    for (const LocalMemAlloc *A : drop_begin(Group)) {
+      if (A->GV->getAlign().valueOrOne() > Shared->getAlign().valueOrOne())
+        Shared->setAlignment(A->GV->getAlign());
+      A->GV->replaceAllUsesWith(
+          ConstantExpr::getPointerCast(Shared, A->GV->getType()));
+      A->GV->eraseFromParent();
+    }
+  }
 }
 
 static bool allocaWGLocalMemory(Module &M) {
@@ -98,9 +252,10 @@ static bool allocaWGLocalMemory(Module &M) {
   assert(ALMFunc->isDeclaration() && "should have declaration only");
 
   SmallVector<CallInst *, 4> DelCalls;
+  SmallVector<GlobalVariable *, 4> LocalMemGVs;
   for (User *U : ALMFunc->users()) {
     auto *CI = cast<CallInst>(U);
-    lowerAllocaLocalMemCall(CI, M);
+    LocalMemGVs.push_back(lowerAllocaLocalMemCall(CI, M));
     DelCalls.push_back(CI);
   }
 
@@ -109,6 +264,30 @@ static bool allocaWGLocalMemory(Module &M) {
     CI->eraseFromParent();
   }
 
+  if (ShareWGLocalMemory) {
+    // Group the allocations by the kernel accessing them. A function other
+    // than a kernel may be called several times by a work-item, so that
+    // barriers in it don't separate the accesses of different calls.
+    MapVector<Function *, SmallVector<LocalMemAlloc, 4>> AllocsByKernel;
+    for (GlobalVariable *GV : LocalMemGVs) {
+      LocalMemAlloc A{GV, {}};
+      if (!collectAccesses(GV, A.Accesses) || A.Accesses.empty())
+        continue;
+      Function *F = A.Accesses.front()->getFunction();
+      if (any_of(A.Accesses,
+                 [&](Instruction *I) { return I->getFunction() != F; }))
+        continue;
+      CallingConv::ID CC = F->getCallingConv();
+      if (CC != CallingConv::SPIR_KERNEL && CC != CallingConv::AMDGPU_KERNEL &&
+          CC != CallingConv::PTX_Kernel)
+        continue;
+      AllocsByKernel[F].push_back(std::move(A));
+    }
+    for (auto &KernelAndAllocs : AllocsByKernel)
+      if (KernelAndAllocs.second.size() > 1)
+        shareLocalMemory(*KernelAndAllocs.first, KernelAndAllocs.second);
+  }
+
   // Remove __sycl_allocateLocalMemory declaration.
   assert(ALMFunc->use_empty() && "__sycl_allocateLocalMemory is still in use");
   ALMFunc->eraseFromParent();
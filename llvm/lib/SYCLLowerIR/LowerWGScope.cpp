@@ -90,6 +90,7 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
@@ -111,6 +112,8 @@ using namespace llvm;
 #define DEBUG_TYPE "lowerwgcode"
 
 STATISTIC(LocalMemUsed, "amount of additional local memory used for sharing");
+STATISTIC(BarriersRemoved, "number of redundant work group barriers removed");
+STATISTIC(ValuesRecomputed, "number of uniform values recomputed by workers");
 
 static constexpr char WG_SCOPE_MD[] = "work_group_scope";
 static constexpr char WI_SCOPE_MD[] = "work_item_scope";
@@ -288,6 +291,23 @@ static void guardBlockWithIsLeaderCheck(BasicBlock *IfBB, BasicBlock *TrueBB,
   assert(TrueBB->getSingleSuccessor() == MergeBB && "CFG tform error");
 }
 
+// Checks if the value of I, computed in the leader scope, can be computed
+// again by every WI instead of being shared via local memory: I must not
+// access memory, nor trap, and its operands must be available to all WIs.
+// Pointers are always shared, as a pointer to the leader's private memory must
+// stay the same in all WIs.
+static bool
+canRecomputeOutsideScope(const Instruction &I,
+                         SmallPtrSetImpl<Instruction *> &LeaderScope) {
+  if (isa<PHINode>(I) || isa<CallBase>(I) || I.mayReadOrWriteMemory() ||
+      I.getType()->isPointerTy() || !isSafeToSpeculativelyExecute(&I))
+    return false;
+  return none_of(I.operands(), [&](const Use &Op) {
+    auto *OpI = dyn_cast<Instruction>(Op.get());
+    return OpI && LeaderScope.contains(OpI);
+  });
+}
+
 static void
 shareOutputViaLocalMem(Instruction &I, BasicBlock &BBa, BasicBlock &BBb,
                        SmallPtrSetImpl<Instruction *> &LeaderScope) {
@@ -304,6 +324,17 @@ shareOutputViaLocalMem(Instruction &I, BasicBlock &BBa, BasicBlock &BBb,
   // Skip instruction w/o uses or if all its uses lie within the scope
   if (Users.size() == 0)
     return;
+  if (canRecomputeOutsideScope(I, LeaderScope)) {
+    // The operands are uniform, so is the value computed by each WI - keep it
+    // in a register rather than going through local memory and a barrier.
+    Instruction *Copy = I.clone();
+    Copy->setName("wi_val_" + Twine(I.getName()));
+    Copy->insertBefore(&BBb.front());
+    for (auto *U : Users)
+      U->replaceUsesOfWith(&I, Copy);
+    ++ValuesRecomputed;
+    return;
+  }
   LLVMContext &Ctx = I.getContext();
   Type *T = I.getType();
   // 1) Create WG local variable
@@ -493,10 +524,30 @@ static void materializeLocalsInWIScopeBlocksImpl(
   }
 }
 
-// Checks if there is a need to materialize value of given local in given work
-// item-scope basic block.
-static bool localMustBeMaterialized(const AllocaInst *L, const BasicBlock &BB) {
-  // TODO this is overly conservative - see speculations below.
+// Collects the basic blocks where WI scope instructions use pointer V, derived
+// from a local. Workers access locals only in such instructions, as all the
+// other accesses are in the leader scope. Returns false if the pointer or a
+// pointer derived from it escapes, so that it may be accessed anywhere.
+static bool collectWIScopeUseBlocks(const Value *V,
+                                    SmallPtrSetImpl<const BasicBlock *> &BBs) {
+  for (const User *U : V->users()) {
+    const auto *I = dyn_cast<Instruction>(U);
+    if (!I)
+      return false;
+    if (isa<GetElementPtrInst>(I) || isa<BitCastInst>(I) ||
+        isa<AddrSpaceCastInst>(I)) {
+      if (!collectWIScopeUseBlocks(I, BBs))
+        return false;
+    } else if (const auto *Store = dyn_cast<StoreInst>(I)) {
+      if (Store->getValueOperand() == V)
+        return false;
+    } else if (isa<CallInst>(I) && isWIScopeInst(I)) {
+      BBs.insert(I->getParent());
+    } else if (!isa<LoadInst>(I) && !isa<MemIntrinsic>(I) &&
+               !I->isLifetimeStartOrEnd() && !I->isDebugOrPseudoInst()) {
+      return false;
+    }
+  }
   return true;
 }
 
@@ -536,13 +587,9 @@ static bool localMustBeMaterialized(const AllocaInst *L, const BasicBlock &BB) {
 // basic_block10: // WI scope
 //   use2(p1);
 //
-// TODO. This implementation is quite ineffective. Currently it materializes
-// all locals in all WI scope basic blocks.
-// Will be improved incrementally:
-// - For each alloca: determine all derived (via GEPs) pointers and make sure
-//   they don't escape. Then check if there are reads in current WI scope BB
-//   through either of those. If none of them escape and there are no reads then
-//   materialization of this alloca in this BB is not needed.
+// A local is materialized only in the WI scope basic blocks using it, unless a
+// pointer to it escapes - then it is materialized in all WI scope blocks.
+// Further improvements:
 // - Materialization is not needed if there is dominating BB with materialized
 //   value, and there are no WG scope writes to this alloca on any path from
 //   that BB to current.
@@ -565,8 +612,11 @@ void materializeLocalsInWIScopeBlocks(SmallPtrSetImpl<AllocaInst *> &Locals,
 
   // Fill the local-to-shadow and basic block-to-locals maps:
   for (auto L : Locals) {
+    SmallPtrSet<const BasicBlock *, 8> UseBBs;
+    bool UsesKnown = collectWIScopeUseBlocks(L, UseBBs);
+
     for (auto *BB : WIScopeBBs) {
-      if (!localMustBeMaterialized(L, *BB))
+      if (UsesKnown && !UseBBs.contains(BB))
         continue;
       if (Local2Shadow.find(L) == Local2Shadow.end()) {
         // lazily create a "shadow" for current local:
@@ -749,6 +799,79 @@ static void shareByValParams(Function &F, const Triple &TT) {
   spirv::genWGBarrier(MergeBB->front(), TT);
 }
 
+// Checks if the given instruction is a barrier generated by genWGBarrier.
+static bool isWGBarrier(const Instruction &I) {
+  const auto *Call = dyn_cast<CallInst>(&I);
+  const Function *F = Call ? Call->getCalledFunction() : nullptr;
+  return F && F->getName() == "_Z22__spirv_ControlBarrierjjj" &&
+         all_of(Call->args(),
+                [](const Use &Arg) { return isa<Constant>(Arg.get()); });
+}
+
+// Checks if the memory accesses of I can't be observed by other WIs, nor
+// observe theirs, before the next barrier: it only writes private memory and
+// only reads private memory, constants or shadows of the leader's values.
+// All the writes of the shadows are done by the leader after a barrier.
+static bool
+isInvisibleToOtherWIs(const Instruction &I,
+                      const SmallPtrSetImpl<GlobalVariable *> &Shadows) {
+  auto IsPrivate = [](const Value *Ptr) {
+    const Value *Obj = getUnderlyingObject(Ptr);
+    const auto *Arg = dyn_cast<Argument>(Obj);
+    return isa<AllocaInst>(Obj) || (Arg && Arg->hasByValAttr());
+  };
+  auto IsReadOnlyForWorker = [&](const Value *Ptr) {
+    auto *GV = dyn_cast<GlobalVariable>(getUnderlyingObject(Ptr));
+    return IsPrivate(Ptr) || (GV && (GV->isConstant() || Shadows.contains(GV)));
+  };
+  if (!I.mayReadOrWriteMemory() || I.isDebugOrPseudoInst() ||
+      I.isLifetimeStartOrEnd())
+    return true;
+  if (const auto *Load = dyn_cast<LoadInst>(&I))
+    return Load->isSimple() && IsReadOnlyForWorker(Load->getPointerOperand());
+  if (const auto *Store = dyn_cast<StoreInst>(&I))
+    return Store->isSimple() && IsPrivate(Store->getPointerOperand());
+  if (const auto *Copy = dyn_cast<MemTransferInst>(&I))
+    return !Copy->isVolatile() && IsPrivate(Copy->getRawDest()) &&
+           IsReadOnlyForWorker(Copy->getRawSource());
+  return false;
+}
+
+// Removes a barrier if it follows another one in the same block and the
+// instructions in between only access memory which is not shared with other
+// WIs - the previous barrier already orders all the shared memory accesses.
+// E.g. materialization of locals and byval parameters reads the shadows right
+// after the barrier, and is followed by the barrier of the next leader scope.
+static void
+removeRedundantBarriers(Function &F,
+                        const SmallPtrSetImpl<GlobalVariable *> &Shadows) {
+  SmallVector<Instruction *, 8> Redundant;
+
+  for (auto &BB : F) {
+    const CallInst *Prev = nullptr;
+
+    for (auto &I : BB) {
+      if (isWGBarrier(I)) {
+        const auto *Call = cast<CallInst>(&I);
+        if (Prev && Prev->getCalledFunction() == Call->getCalledFunction() &&
+            std::equal(Prev->arg_begin(), Prev->arg_end(), Call->arg_begin(),
+                       Call->arg_end(), [](const Use &A, const Use &B) {
+                         return A.get() == B.get();
+                       }))
+          Redundant.push_back(&I);
+        else
+          Prev = Call;
+        continue;
+      }
+      if (Prev && !isInvisibleToOtherWIs(I, Shadows))
+        Prev = nullptr;
+    }
+  }
+  for (auto *I : Redundant)
+    I->eraseFromParent();
+  BarriersRemoved += Redundant.size();
+}
+
 PreservedAnalyses SYCLLowerWGScopePass::run(Function &F,
                                             FunctionAnalysisManager &FAM) {
   if (!F.getMetadata(WG_SCOPE_MD))
@@ -830,6 +953,13 @@ PreservedAnalyses SYCLLowerWGScopePass::run(Function &F,
   }
 #endif // NDEBUG
 
+  // Remember the globals existing before the transformation, so that the
+  // shadows created by it can be told apart from the user's WG-shared locals.
+  SmallPtrSet<GlobalVariable *, 16> OldGlobals;
+  if (HaveChanges)
+    for (auto &GV : F.getParent()->globals())
+      OldGlobals.insert(&GV);
+
   // Perform the transformation
   for (auto &R : Ranges)
     tformRange(R, TT);
@@ -857,6 +987,14 @@ PreservedAnalyses SYCLLowerWGScopePass::run(Function &F,
   // Finally, create shadows for and replace usages of byval pointer params.
   shareByValParams(F, TT);
 
+  if (HaveChanges) {
+    SmallPtrSet<GlobalVariable *, 16> Shadows;
+    for (auto &GV : F.getParent()->globals())
+      if (!OldGlobals.contains(&GV))
+        Shadows.insert(&GV);
+    removeRedundantBarriers(F, Shadows);
+  }
+
 #ifndef NDEBUG
   if (HaveChanges && Debug > 0)
     verifyModule(*F.getParent(), &llvm::errs());
@@ -103,8 +103,8 @@ SmallVector<unsigned> getUsedIndexes(const Function *F) {
   return Res;
 }
 
-void emitSubkernelForKernel(Function *F, Type *NativeCPUArgDescType,
-                            Type *StatePtrType) {
+Function *emitSubkernelForKernel(Function *F, Type *NativeCPUArgDescType,
+                                 Type *StatePtrType) {
   LLVMContext &Ctx = F->getContext();
   Type *NativeCPUArgDescPtrType = PointerType::getUnqual(NativeCPUArgDescType);
 
@@ -166,6 +166,7 @@ void emitSubkernelForKernel(Function *F, Type *NativeCPUArgDescType,
     Attribute MId = F->getFnAttribute(sycl::utils::ATTR_SYCL_MODULE_ID);
     SubhF->addFnAttr("sycl-module-id", MId.getValueAsString());
   }
+  return SubhF;
 }
 
 // Clones the function and returns a new function with a new argument on type T
@@ -242,6 +243,17 @@ Function *getReplaceFunc(const Module &M, StringRef Name) {
   return F;
 }
 
+// The state is owned by the Native CPU runtime and only read by kernels.
+// Without this, the loads of the work-item ids it holds can't be moved across
+// stores to global memory, which blocks the optimization of loops in kernels.
+void addStateParamAttrs(Function *F, unsigned ArgNo, uint64_t StateSize) {
+  F->addParamAttr(ArgNo, Attribute::NoAlias);
+  F->addParamAttr(ArgNo, Attribute::NoCapture);
+  F->addParamAttr(ArgNo, Attribute::ReadOnly);
+  F->addParamAttr(ArgNo, Attribute::NonNull);
+  F->addDereferenceableParamAttr(ArgNo, StateSize);
+}
+
 Value *getStateArg(const Function *F) {
   auto *FT = F->getFunctionType();
   return F->getArg(FT->getNumParams() - 1);
@@ -268,9 +280,11 @@ PreservedAnalyses PrepareSYCLNativeCPUPass::run(Module &M,
   if (!StateType)
     return PreservedAnalyses::all();
   Type *StatePtrType = PointerType::get(StateType, 1);
+  const uint64_t StateSize = M.getDataLayout().getTypeAllocSize(StateType);
   SmallVector<Function *> NewKernels;
   for (auto &OldF : OldKernels) {
     auto *NewF = cloneFunctionAndAddParam(OldF, StatePtrType);
+    addStateParamAttrs(NewF, NewF->arg_size() - 1, StateSize);
     NewF->takeName(OldF);
     OldF->eraseFromParent();
     NewKernels.push_back(NewF);
@@ -280,7 +294,9 @@ PreservedAnalyses PrepareSYCLNativeCPUPass::run(Module &M,
   StructType *NativeCPUArgDescType =
       StructType::create({PointerType::getUnqual(M.getContext())});
   for (auto &NewK : NewKernels) {
-    emitSubkernelForKernel(NewK, NativeCPUArgDescType, StatePtrType);
+    Function *SubhF =
+        emitSubkernelForKernel(NewK, NativeCPUArgDescType, StatePtrType);
+    addStateParamAttrs(SubhF, 1, StateSize);
   }
 
   const bool VisualStudioMangling = IsForVisualStudio(M.getTargetTriple());
@@ -9,6 +9,8 @@
 // This file implements the localCache function, which simplifies creating,
 // adding to, and querying a local file system cache. localCache takes care of
 // periodically pruning older files from the cache using a CachePruningPolicy.
+// It also implements the storeCache function, which caches files in a
+// client-provided CacheStore.
 //
 //===----------------------------------------------------------------------===//
 
@@ -17,6 +19,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -166,3 +169,60 @@ Expected<FileCache> llvm::localCache(const Twine &CacheNameRef,
     };
   };
 }
+
+FileCache llvm::storeCache(const Twine &CacheNameRef,
+                           std::shared_ptr<CacheStore> Store,
+                           AddBufferFn AddBuffer) {
+  std::string CacheName = CacheNameRef.str();
+
+  return [=](unsigned Task, StringRef Key,
+             const Twine &ModuleName) -> Expected<AddStreamFn> {
+    Expected<std::unique_ptr<MemoryBuffer>> MBOrErr = Store->get(Key);
+    if (!MBOrErr)
+      return createStringError(errc::io_error,
+                               Twine("Failed to get cache entry ") + Key +
+                                   ": " + CacheName + ": " +
+                                   toString(MBOrErr.takeError()) + "\n");
+    if (*MBOrErr) {
+      AddBuffer(Task, ModuleName, std::move(*MBOrErr));
+      return AddStreamFn();
+    }
+
+    // This stream is responsible for adding the content written to it to the
+    // store and calling AddBuffer to add it to the link.
+    struct StoreStream : CachedFileStream {
+      std::shared_ptr<CacheStore> Store;
+      AddBufferFn AddBuffer;
+      std::string Key;
+      std::string ModuleName;
+      unsigned Task;
+      SmallString<0> Contents;
+
+      StoreStream(std::shared_ptr<CacheStore> Store, AddBufferFn AddBuffer,
+                  std::string Key, std::string ModuleName, unsigned Task)
+          : CachedFileStream(nullptr), Store(std::move(Store)),
+            AddBuffer(std::move(AddBuffer)), Key(std::move(Key)),
+            ModuleName(std::move(ModuleName)), Task(Task) {
+        OS = std::make_unique<raw_svector_ostream>(Contents);
+      }
+
+      ~StoreStream() {
+        // Make sure the stream is flushed before publishing its contents.
+        OS.reset();
+
+        // Not being able to add the entry only costs a future cache miss.
+        consumeError(Store->put(Key, MemoryBufferRef(Contents, ModuleName)));
+
+        AddBuffer(Task, ModuleName,
+                  MemoryBuffer::getMemBufferCopy(Contents, ModuleName));
+      }
+    };
+
+    std::string EntryKey = Key.str();
+    return [=](size_t Task, const Twine &ModuleName)
+               -> Expected<std::unique_ptr<CachedFileStream>> {
+      return std::make_unique<StoreStream>(Store, AddBuffer, EntryKey,
+                                           ModuleName.str(), Task);
+    };
+  };
+}
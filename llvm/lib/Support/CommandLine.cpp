@@ -158,6 +158,17 @@ public:
   // ParseCommandLineOptions actually runs.
   SmallVector<Option*, 4> DefaultOptions;
 
+  // This collects Options whose constructors have run but which have not been
+  // entered into their SubCommands yet. Most cl::opts are static globals, and
+  // many processes that load LLVM never parse a command line or look up an
+  // option, so filling the OptionsMaps is postponed until something actually
+  // needs them. See registerPendingOptions().
+  SmallVector<Option *, 0> PendingOptions;
+  // Set once the pending options have been registered by parsing or looking
+  // up options. Options constructed afterwards, e.g. by plugins loaded while
+  // parsing the command line, are registered right away.
+  bool PendingOptionsRegistered = false;
+
   // This collects the different option categories that have been registered.
   SmallPtrSet<OptionCategory *, 16> RegisteredOptionCategories;
 
@@ -250,6 +261,27 @@ public:
     }
   }
 
+  void addPendingOption(Option *O) {
+    if (PendingOptionsRegistered)
+      addOption(O);
+    else
+      PendingOptions.push_back(O);
+  }
+
+  // Enter all options constructed so far into their SubCommands. This must run
+  // before anything reads the OptionsMaps, PositionalOpts, SinkOpts or
+  // ConsumeAfterOpt of a SubCommand, i.e. when parsing, looking up or printing
+  // options. Registering options, categories and SubCommands must not call it,
+  // or the registration of static cl::opts is no longer deferred.
+  void registerPendingOptions() {
+    PendingOptionsRegistered = true;
+    if (PendingOptions.empty())
+      return;
+    for (Option *O : PendingOptions)
+      addOption(O);
+    PendingOptions.clear();
+  }
+
   void addOption(Option *O, bool ProcessDefaultOption = false) {
     if (!ProcessDefaultOption && O->isDefaultOption()) {
       DefaultOptions.push_back(O);
@@ -298,6 +330,10 @@ public:
   }
 
   void removeOption(Option *O) {
+    if (!PendingOptionsRegistered) {
+      erase_value(PendingOptions, O);
+      return;
+    }
     if (O->Subs.empty())
       removeOption(O, &SubCommand::getTopLevel());
     else {
@@ -337,6 +373,9 @@ public:
   }
 
   void updateArgStr(Option *O, StringRef NewName) {
+    // A pending option is entered under the name it has when it is registered.
+    if (!PendingOptionsRegistered)
+      return;
     if (O->Subs.empty())
       updateArgStr(O, NewName, &SubCommand::getTopLevel());
     else {
@@ -372,7 +411,8 @@ public:
     RegisteredSubCommands.insert(sub);
 
     // For all options that have been registered for all subcommands, add the
-    // option to this subcommand now.
+    // option to this subcommand now. Pending options are added to all
+    // registered subcommands once they are registered themselves.
     if (sub != &SubCommand::getAll()) {
       for (auto &E : SubCommand::getAll().OptionsMap) {
         Option *O = E.second;
@@ -412,6 +452,7 @@ public:
     registerSubCommand(&SubCommand::getAll());
 
     DefaultOptions.clear();
+    PendingOptionsRegistered = false;
   }
 
 private:
@@ -441,7 +482,7 @@ extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
 }
 
 void Option::addArgument() {
-  GlobalParser->addOption(this);
+  GlobalParser->addPendingOption(this);
   FullyInitialized = true;
 }
 
@@ -525,6 +566,7 @@ Option *CommandLineParser::LookupOption(SubCommand &Sub, StringRef &Arg,
   if (Arg.empty())
     return nullptr;
   assert(&Sub != &SubCommand::getAll());
+  registerPendingOptions();
 
   size_t EqualPos = Arg.find('=');
 
@@ -1475,6 +1517,7 @@ void CommandLineParser::ResetAllOptionOccurrences() {
   // Reset all option values to look like they have never been seen before.
   // Options might be reset twice (they can be reference in both OptionsMap
   // and one of the other members), but that does not harm.
+  registerPendingOptions();
   for (auto *SC : RegisteredSubCommands) {
     for (auto &O : SC->OptionsMap)
       O.second->reset();
@@ -1492,6 +1535,7 @@ bool CommandLineParser::ParseCommandLineOptions(int argc,
                                                 StringRef Overview,
                                                 raw_ostream *Errs,
                                                 bool LongOptionsUseDoubleDash) {
+  registerPendingOptions();
   assert(hasOptions() && "No options specified!");
 
   ProgramOverview = Overview;
@@ -2716,6 +2760,8 @@ void CommandLineParser::printOptionValues() {
   if (!CommonOptions->PrintOptions && !CommonOptions->PrintAllOptions)
     return;
 
+  registerPendingOptions();
+
   SmallVector<std::pair<const char *, Option *>, 128> Opts;
   sortOpts(ActiveSubCommand->OptionsMap, Opts, /*ShowHidden*/ true);
 
@@ -2730,6 +2776,7 @@ void CommandLineParser::printOptionValues() {
 
 // Utility function for printing the help message.
 void cl::PrintHelpMessage(bool Hidden, bool Categorized) {
+  GlobalParser->registerPendingOptions();
   if (!Hidden && !Categorized)
     CommonOptions->UncategorizedNormalPrinter.printHelp();
   else if (!Hidden && Categorized)
@@ -2755,6 +2802,7 @@ void cl::AddExtraVersionPrinter(VersionPrinterTy func) {
 
 StringMap<Option *> &cl::getRegisteredOptions(SubCommand &Sub) {
   initCommonOptions();
+  GlobalParser->registerPendingOptions();
   auto &Subs = GlobalParser->RegisteredSubCommands;
   (void)Subs;
   assert(Subs.contains(&Sub));
@@ -2763,11 +2811,13 @@ StringMap<Option *> &cl::getRegisteredOptions(SubCommand &Sub) {
 
 iterator_range<typename SmallPtrSet<SubCommand *, 4>::iterator>
 cl::getRegisteredSubcommands() {
+  GlobalParser->registerPendingOptions();
   return GlobalParser->getRegisteredSubcommands();
 }
 
 void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
   initCommonOptions();
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     bool Unrelated = true;
     for (auto &Cat : I.second->Categories) {
@@ -2782,6 +2832,7 @@ void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
 void cl::HideUnrelatedOptions(ArrayRef<const cl::OptionCategory *> Categories,
                               SubCommand &Sub) {
   initCommonOptions();
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     bool Unrelated = true;
     for (auto &Cat : I.second->Categories) {
@@ -11,6 +11,7 @@
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <future>
@@ -39,9 +40,18 @@ namespace {
 class Executor {
 public:
   virtual ~Executor() = default;
-  virtual void add(std::function<void()> func, bool Sequential = false) = 0;
+  /// Queues \p func. Non-sequential tasks may be tagged with the \p Group
+  /// they belong to, which lets a thread waiting for that group run them.
+  virtual void add(std::function<void()> func, bool Sequential = false,
+                   const void *Group = nullptr) = 0;
   virtual size_t getThreadCount() const = 0;
 
+  /// Runs queued tasks tagged with \p Group on the calling thread until
+  /// \p IsDone returns true. Whoever makes \p IsDone true must call
+  /// notifyWaiters() afterwards.
+  virtual void helpUntil(const void *Group, function_ref<bool()> IsDone) = 0;
+  virtual void notifyWaiters() = 0;
+
   static Executor *getDefaultExecutor();
 };
 
@@ -98,19 +108,60 @@ public:
     static void call(void *Ptr) { ((ThreadPoolExecutor *)Ptr)->stop(); }
   };
 
-  void add(std::function<void()> F, bool Sequential = false) override {
+  void add(std::function<void()> F, bool Sequential = false,
+           const void *Group = nullptr) override {
+    assert(!(Sequential && Group) && "sequential tasks can't be tagged");
+    bool HasHelpers;
     {
       std::lock_guard<std::mutex> Lock(Mutex);
       if (Sequential)
         WorkQueueSequential.emplace_front(std::move(F));
       else
-        WorkQueue.emplace_back(std::move(F));
+        WorkQueue.emplace_back(Group, std::move(F));
+      HasHelpers = NumHelpers != 0;
     }
-    Cond.notify_one();
+    // Threads waiting in helpUntil() only run the tasks of the group they wait
+    // for, so make sure that the wakeup doesn't go to one of them only.
+    if (Sequential || Group || HasHelpers)
+      Cond.notify_all();
+    else
+      Cond.notify_one();
   }
 
   size_t getThreadCount() const override { return ThreadCount; }
 
+  void helpUntil(const void *Group, function_ref<bool()> IsDone) override {
+    while (true) {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      auto It = WorkQueue.rend();
+      ++NumHelpers;
+      Cond.wait(Lock, [&] {
+        if (Stop || IsDone())
+          return true;
+        It = findTask(Group);
+        return It != WorkQueue.rend();
+      });
+      --NumHelpers;
+      if (Stop || IsDone())
+        return;
+      // Only the tasks of the awaited group are run here. Any other task could
+      // take arbitrarily long, nest arbitrarily deep, or clobber per-thread
+      // state the waiting task still holds. Sequential tasks are left to the
+      // work() loop: they must not run out of order.
+      auto Task = std::move(It->second);
+      WorkQueue.erase(std::next(It).base());
+      Lock.unlock();
+      Task();
+    }
+  }
+
+  void notifyWaiters() override {
+    // Taking the lock orders this against a waiter that has evaluated its
+    // IsDone() but hasn't started waiting yet.
+    { std::lock_guard<std::mutex> Lock(Mutex); }
+    Cond.notify_all();
+  }
+
 private:
   bool hasSequentialTasks() const {
     return !WorkQueueSequential.empty() && !SequentialQueueIsLocked;
@@ -118,6 +169,13 @@ private:
 
   bool hasGeneralTasks() const { return !WorkQueue.empty(); }
 
+  /// Returns the most recently queued task tagged with \p Group.
+  std::deque<std::pair<const void *, std::function<void()>>>::reverse_iterator
+  findTask(const void *Group) {
+    return std::find_if(WorkQueue.rbegin(), WorkQueue.rend(),
+                        [&](const auto &Task) { return Task.first == Group; });
+  }
+
   void work(ThreadPoolStrategy S, unsigned ThreadID) {
     threadIndex = ThreadID;
     S.apply_thread_strategy(ThreadID);
@@ -134,9 +192,14 @@ private:
       else
         assert(hasGeneralTasks());
 
-      auto &Queue = Sequential ? WorkQueueSequential : WorkQueue;
-      auto Task = std::move(Queue.back());
-      Queue.pop_back();
+      std::function<void()> Task;
+      if (Sequential) {
+        Task = std::move(WorkQueueSequential.back());
+        WorkQueueSequential.pop_back();
+      } else {
+        Task = std::move(WorkQueue.back().second);
+        WorkQueue.pop_back();
+      }
       Lock.unlock();
       Task();
       if (Sequential)
@@ -146,7 +209,9 @@ private:
 
   std::atomic<bool> Stop{false};
   std::atomic<bool> SequentialQueueIsLocked{false};
-  std::deque<std::function<void()>> WorkQueue;
+  // The number of threads waiting in helpUntil(). Guarded by Mutex.
+  unsigned NumHelpers = 0;
+  std::deque<std::pair<const void *, std::function<void()>>> WorkQueue;
   std::deque<std::function<void()>> WorkQueueSequential;
   std::mutex Mutex;
   std::condition_variable Cond;
@@ -188,39 +253,57 @@ size_t getThreadCount() {
 }
 #endif
 
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the root TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
+// A nested TaskGroup, i.e. one created by a task running on a thread of the
+// default executor, would dead lock if its thread simply blocked in sync() and
+// all the threads of the executor ended up doing so. Instead, the thread keeps
+// running the queued tasks of the nested group until they have all finished,
+// so nested parallel_for_each() calls run in parallel too.
 TaskGroup::TaskGroup()
 #if LLVM_ENABLE_THREADS
-    : Parallel((parallel::strategy.ThreadsRequested != 1) &&
-               (threadIndex == UINT_MAX)) {}
+    : Parallel(parallel::strategy.ThreadsRequested != 1),
+      Nested(threadIndex != UINT_MAX) {}
 #else
-    : Parallel(false) {}
+    : Parallel(false), Nested(false) {}
 #endif
 TaskGroup::~TaskGroup() {
   // We must ensure that all the workloads have finished before decrementing the
   // instances count.
-  L.sync();
+  sync();
 }
 
 void TaskGroup::spawn(std::function<void()> F, bool Sequential) {
 #if LLVM_ENABLE_THREADS
-  if (Parallel) {
+  // Sequential tasks of a nested group run inline: the thread spawning them
+  // may be running a sequential task itself, which holds the sequential queue
+  // until it returns.
+  if (Parallel && !(Nested && Sequential)) {
     L.inc();
-    detail::Executor::getDefaultExecutor()->add(
-        [&, F = std::move(F)] {
+    detail::Executor *Exec = detail::Executor::getDefaultExecutor();
+    // The group may be destroyed as soon as its count drops to zero, so don't
+    // touch its members after that.
+    bool NotifyWaiters = Nested;
+    Exec->add(
+        [&, Exec, NotifyWaiters, F = std::move(F)] {
           F();
-          L.dec();
+          if (L.dec() && NotifyWaiters)
+            Exec->notifyWaiters();
         },
-        Sequential);
+        Sequential, Nested ? this : nullptr);
     return;
   }
 #endif
   F();
 }
 
+void TaskGroup::sync() const {
+#if LLVM_ENABLE_THREADS
+  if (Parallel && Nested)
+    detail::Executor::getDefaultExecutor()->helpUntil(
+        this, [&] { return L.isZero(); });
+#endif
+  L.sync();
+}
+
 } // namespace parallel
 } // namespace llvm
 
@@ -68,8 +68,8 @@ using NameAndCountAndDurationType =
 struct TimeTraceProfilerEntry {
   const TimePointType Start;
   TimePointType End;
-  const std::string Name;
-  const std::string Detail;
+  std::string Name;
+  std::string Detail;
 
   TimeTraceProfilerEntry(TimePointType &&S, TimePointType &&E, std::string &&N,
                          std::string &&Dt)
@@ -122,10 +122,6 @@ struct llvm::TimeTraceProfiler {
     // Calculate duration at full precision for overall counts.
     DurationType Duration = E.End - E.Start;
 
-    // Only include sections longer or equal to TimeTraceGranularity msec.
-    if (duration_cast<microseconds>(Duration).count() >= TimeTraceGranularity)
-      Entries.emplace_back(E);
-
     // Track total time taken by each "name", but only the topmost levels of
     // them; e.g. if there's a template instantiation that instantiates other
     // templates from within, we only want to add the topmost one. "topmost"
@@ -140,6 +136,12 @@ struct llvm::TimeTraceProfiler {
       CountAndTotal.second += Duration;
     }
 
+    // Only include sections longer or equal to TimeTraceGranularity msec. The
+    // entry is about to be popped, so move its strings instead of copying them
+    // on this hot path.
+    if (duration_cast<microseconds>(Duration).count() >= TimeTraceGranularity)
+      Entries.emplace_back(std::move(E));
+
     Stack.pop_back();
   }
 
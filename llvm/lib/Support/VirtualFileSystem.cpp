@@ -587,6 +587,78 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
 
 void ProxyFileSystem::anchor() {}
 
+llvm::ErrorOr<Status> StatCachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Storage;
+  StringRef Key = Path.toStringRef(Storage);
+  if (isExcluded(Key))
+    return getUnderlyingFS().status(Key);
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto It = Cache.find(Key);
+    if (It != Cache.end())
+      return It->second;
+  }
+
+  // Query without holding the lock so that concurrent lookups of other paths
+  // are not serialized behind a slow underlying file system. Two threads may
+  // race to fill the same entry; the first one wins.
+  llvm::ErrorOr<Status> Result = getUnderlyingFS().status(Key);
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  return Cache.try_emplace(Key, std::move(Result)).first->second;
+}
+
+llvm::ErrorOr<std::unique_ptr<File>>
+StatCachingFileSystem::openFileForRead(const Twine &Path) {
+  SmallString<256> Storage;
+  StringRef Key = Path.toStringRef(Storage);
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    auto It = Cache.find(Key);
+    if (It != Cache.end() && !It->second)
+      return It->second.getError();
+  }
+  return getUnderlyingFS().openFileForRead(Key);
+}
+
+std::error_code
+StatCachingFileSystem::setCurrentWorkingDirectory(const Twine &Path) {
+  std::error_code EC = getUnderlyingFS().setCurrentWorkingDirectory(Path);
+  clear();
+  return EC;
+}
+
+void StatCachingFileSystem::clear() {
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  Cache.clear();
+}
+
+void StatCachingFileSystem::excludePath(const Twine &Path) {
+  SmallString<256> AbsPath;
+  Path.toVector(AbsPath);
+  getUnderlyingFS().makeAbsolute(AbsPath);
+  llvm::sys::path::remove_dots(AbsPath, /*remove_dot_dot=*/true);
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  ExcludedPaths.push_back(std::string(AbsPath));
+}
+
+bool StatCachingFileSystem::isExcluded(StringRef Path) const {
+  {
+    std::lock_guard<std::mutex> Lock(CacheMutex);
+    if (ExcludedPaths.empty())
+      return false;
+  }
+  SmallString<256> AbsPath(Path);
+  if (getUnderlyingFS().makeAbsolute(AbsPath))
+    return true;
+  llvm::sys::path::remove_dots(AbsPath, /*remove_dot_dot=*/true);
+  std::lock_guard<std::mutex> Lock(CacheMutex);
+  return llvm::any_of(ExcludedPaths, [&](StringRef Excluded) {
+    return AbsPath.startswith(Excluded) &&
+           (AbsPath.size() == Excluded.size() ||
+            llvm::sys::path::is_separator(AbsPath[Excluded.size()]));
+  });
+}
+
 namespace llvm {
 namespace vfs {
 
@@ -721,17 +721,22 @@ Record *ListInit::getElementAsRecord(unsigned i) const {
 }
 
 Init *ListInit::resolveReferences(Resolver &R) const {
+  // Most lists resolve to themselves, so only copy the elements once one of
+  // them has changed.
+  ArrayRef<Init *> Values = getValues();
   SmallVector<Init*, 8> Resolved;
-  Resolved.reserve(size());
-  bool Changed = false;
-
-  for (Init *CurElt : getValues()) {
-    Init *E = CurElt->resolveReferences(R);
-    Changed |= E != CurElt;
-    Resolved.push_back(E);
+  for (size_t I = 0, E = Values.size(); I != E; ++I) {
+    Init *Elt = Values[I]->resolveReferences(R);
+    if (Resolved.empty() && Elt == Values[I])
+      continue;
+    if (Resolved.empty()) {
+      Resolved.reserve(E);
+      Resolved.append(Values.begin(), Values.begin() + I);
+    }
+    Resolved.push_back(Elt);
   }
 
-  if (Changed)
+  if (!Resolved.empty())
     return ListInit::get(Resolved, getElementType());
   return const_cast<ListInit *>(this);
 }
@@ -2558,18 +2563,25 @@ std::optional<unsigned> DagInit::getArgNo(StringRef Name) const {
 }
 
 Init *DagInit::resolveReferences(Resolver &R) const {
+  // As for lists, only copy the arguments once one of them has changed.
+  ArrayRef<Init *> Args = getArgs();
   SmallVector<Init*, 8> NewArgs;
-  NewArgs.reserve(arg_size());
-  bool ArgsChanged = false;
-  for (const Init *Arg : getArgs()) {
-    Init *NewArg = Arg->resolveReferences(R);
+  for (size_t I = 0, E = Args.size(); I != E; ++I) {
+    Init *NewArg = Args[I]->resolveReferences(R);
+    if (NewArgs.empty() && NewArg == Args[I])
+      continue;
+    if (NewArgs.empty()) {
+      NewArgs.reserve(E);
+      NewArgs.append(Args.begin(), Args.begin() + I);
+    }
     NewArgs.push_back(NewArg);
-    ArgsChanged |= NewArg != Arg;
   }
 
   Init *Op = Val->resolveReferences(R);
-  if (Op != Val || ArgsChanged)
-    return DagInit::get(Op, ValName, NewArgs, getArgNames());
+  if (Op != Val || !NewArgs.empty())
+    return DagInit::get(Op, ValName,
+                        NewArgs.empty() ? Args : ArrayRef<Init *>(NewArgs),
+                        getArgNames());
 
   return const_cast<DagInit *>(this);
 }
@@ -611,7 +611,8 @@ public:
   /// Add a field to this structure for the storage of an `alloca`
   /// instruction.
   [[nodiscard]] FieldIDType addFieldForAlloca(AllocaInst *AI,
-                                              bool IsHeader = false) {
+                                              bool IsHeader = false,
+                                              MaybeAlign Alignment = {}) {
     Type *Ty = AI->getAllocatedType();
 
     // Make an array type if this is a static array allocation.
@@ -622,7 +623,7 @@ public:
         report_fatal_error("Coroutines cannot handle non static allocas yet");
     }
 
-    return addField(Ty, AI->getAlign(), IsHeader);
+    return addField(Ty, Alignment.value_or(AI->getAlign()), IsHeader);
   }
 
   /// We want to put the allocas whose lifetime-ranges are not overlapped
@@ -763,7 +764,12 @@ void FrameTypeBuilder::addFieldForAllocas(const Function &F,
   auto AddFieldForAllocasAtExit = make_scope_exit([&]() {
     for (auto AllocaList : NonOverlapedAllocas) {
       auto *LargestAI = *AllocaList.begin();
-      FieldIDType Id = addFieldForAlloca(LargestAI);
+      // The slot must satisfy the alignment of every alloca sharing it.
+      Align SlotAlign = LargestAI->getAlign();
+      for (auto *Alloca : AllocaList)
+        SlotAlign = std::max(SlotAlign, Alloca->getAlign());
+      FieldIDType Id =
+          addFieldForAlloca(LargestAI, /*IsHeader=*/false, SlotAlign);
       for (auto *Alloca : AllocaList)
         FrameData.setFieldIndex(Alloca, Id);
     }
@@ -838,16 +844,26 @@ void FrameTypeBuilder::addFieldForAllocas(const Function &F,
       bool NoInference = none_of(AllocaSet, [&](auto Iter) {
         return IsAllocaInferenre(Alloca, Iter);
       });
-      // If the alignment of A is multiple of the alignment of B, the address
-      // of A should satisfy the requirement for aligning for B.
+      // If the alignment of the slot is multiple of the alignment of Alloca,
+      // the address of the slot satisfies the alignment of Alloca. Otherwise
+      // the slot's alignment is raised to that of Alloca, which costs less
+      // padding than a separate slot saves as long as Alloca is at least as
+      // large as its alignment. The alignment is not raised beyond
+      // MaxFrameAlignment, since such a slot is aligned dynamically and that
+      // is done for the alignment of a single alloca only.
       //
       // There may be other more fine-grained strategies to handle the alignment
       // infomation during the merging process. But it seems hard to handle
       // these strategies and benefit little.
       bool Alignable = [&]() -> bool {
-        auto *LargestAlloca = *AllocaSet.begin();
-        return LargestAlloca->getAlign().value() % Alloca->getAlign().value() ==
-               0;
+        Align SlotAlign;
+        for (auto *SetAlloca : AllocaSet)
+          SlotAlign = std::max(SlotAlign, SetAlloca->getAlign());
+        if (SlotAlign.value() % Alloca->getAlign().value() == 0)
+          return true;
+        if (MaxFrameAlignment && Alloca->getAlign() > *MaxFrameAlignment)
+          return false;
+        return GetAllocaSize(A) >= Alloca->getAlign().value();
       }();
       bool CouldMerge = NoInference && Alignable;
       if (!CouldMerge)
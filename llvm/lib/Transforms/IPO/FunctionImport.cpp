@@ -38,12 +38,14 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/ValueMapper.h"
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <set>
@@ -429,7 +431,8 @@ static void computeImportForFunction(
     DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists,
     FunctionImporter::ImportThresholdsTy &ImportThresholds) {
   GVImporter.onImportingSummary(Summary);
-  static int ImportCount = 0;
+  // Modules may be processed in parallel, see ComputeCrossModuleImport.
+  static std::atomic<int> ImportCount = 0;
   for (const auto &Edge : Summary.calls()) {
     ValueInfo VI = Edge.first;
     LLVM_DEBUG(dbgs() << " edge -> " << VI << " Threshold:" << Threshold
@@ -733,15 +736,47 @@ void llvm::ComputeCrossModuleImport(
         isPrevailing,
     DenseMap<StringRef, FunctionImporter::ImportMapTy> &ImportLists,
     DenseMap<StringRef, FunctionImporter::ExportSetTy> &ExportLists) {
-  ModuleImportsManager MIS(isPrevailing, Index, &ExportLists);
-  // For each module that has function defined, compute the import/export lists.
-  for (const auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first];
-    LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first << "'\n");
-    MIS.computeImportForModule(DefinedGVSummaries.second,
-                               DefinedGVSummaries.first, ImportList);
-  }
+  // For each module that has function defined, compute the import list. The
+  // modules only read the index, so this is done in parallel, each module
+  // writing its own import list. The export lists are then built from the
+  // import lists in the order of the modules, which keeps them deterministic.
+  struct ModuleImports {
+    StringRef ModName;
+    const GVSummaryMapTy *DefinedGVSummaries;
+    FunctionImporter::ImportMapTy *ImportList;
+  };
+  // Create the import lists of all the modules before taking their addresses,
+  // as inserting into ImportLists may move the lists created before.
+  for (const auto &DefinedGVSummaries : ModuleToDefinedGVSummaries)
+    ImportLists[DefinedGVSummaries.first];
+  std::vector<ModuleImports> Modules;
+  Modules.reserve(ModuleToDefinedGVSummaries.size());
+  for (const auto &DefinedGVSummaries : ModuleToDefinedGVSummaries)
+    Modules.push_back({DefinedGVSummaries.first, &DefinedGVSummaries.second,
+                       &ImportLists.find(DefinedGVSummaries.first)->second});
+
+  ModuleImportsManager MIS(isPrevailing, Index);
+  auto ComputeImportForModule = [&](size_t I) {
+    LLVM_DEBUG(dbgs() << "Computing import for Module '" << Modules[I].ModName
+                      << "'\n");
+    MIS.computeImportForModule(*Modules[I].DefinedGVSummaries,
+                               Modules[I].ModName, *Modules[I].ImportList);
+  };
+  // The import cutoff counts the imports of all the modules, and the debugging
+  // output of the modules must not be interleaved.
+  if (ImportCutoff >= 0 || PrintImportFailures || DebugFlag)
+    for (size_t I = 0; I < Modules.size(); ++I)
+      ComputeImportForModule(I);
+  else
+    parallelFor(0, Modules.size(), ComputeImportForModule);
+
+  // Everything imported from a module is exported by it.
+  for (const ModuleImports &Module : Modules)
+    for (const auto &ImportsFromModule : *Module.ImportList) {
+      auto &Exports = ExportLists[ImportsFromModule.first];
+      for (GlobalValue::GUID GUID : ImportsFromModule.second)
+        Exports.insert(Index.getValueInfo(GUID));
+    }
 
   // When computing imports we only added the variables and functions being
   // imported to the export list. We also need to mark any references and calls
@@ -0,0 +1,87 @@
+; Tests that an alloca whose alignment exceeds the alignment of the async
+; context does not share a frame slot with an alloca of smaller alignment.
+; Raising the alignment of the shared slot would make it dynamically aligned,
+; which is only supported for a single alloca per slot.
+; RUN: opt < %s -passes='cgscc(coro-split<reuse-storage>),simplifycfg,early-cse' -S | FileCheck %s
+
+%async.ctxt = type { ptr, ptr }
+
+@my_async_function_fp = constant <{ i32, i32 }>
+  <{ i32 trunc (
+       i64 sub (
+         i64 ptrtoint (ptr @my_async_function to i64),
+         i64 ptrtoint (ptr getelementptr inbounds (<{ i32, i32 }>, ptr @my_async_function_fp, i32 0, i32 1) to i64)
+       )
+     to i32),
+     i32 32
+}>
+
+declare void @opaque(ptr)
+declare ptr @llvm.coro.async.context.alloc(ptr, ptr)
+declare void @llvm.coro.async.context.dealloc(ptr)
+declare ptr @llvm.coro.async.resume()
+declare token @llvm.coro.id.async(i32, i32, i32, ptr)
+declare ptr @llvm.coro.begin(token, ptr)
+declare i1 @llvm.coro.end.async(ptr, i1, ...)
+declare {ptr} @llvm.coro.suspend.async(i32, ptr, ptr, ...)
+declare swiftcc void @asyncReturn(ptr)
+declare swiftcc void @asyncSuspend(ptr)
+declare void @llvm.lifetime.start.p0(i64, ptr nocapture)
+declare void @llvm.lifetime.end.p0(i64, ptr nocapture)
+
+define swiftcc void @my_async_function.apply(ptr %fnPtr, ptr %async.ctxt) {
+  tail call swiftcc void %fnPtr(ptr %async.ctxt)
+  ret void
+}
+
+define ptr @__swift_async_resume_project_context(ptr %ctxt) {
+entry:
+  %resume_ctxt = load ptr, ptr %ctxt, align 8
+  ret ptr %resume_ctxt
+}
+
+; %x and %y have their own slots, %y's slot is aligned dynamically.
+; CHECK: %my_async_function.Frame = type {{.*(\[128 x i8\].*\[64 x i8\]|\[64 x i8\].*\[128 x i8\])}}
+; CHECK-LABEL: define swiftcc void @my_async_function(
+; CHECK-LABEL: define {{.*}} @my_async_function.resume.0(
+; CHECK: and i64 %{{.*}}, -64
+
+define swiftcc void @my_async_function(ptr swiftasync %async.ctxt) presplitcoroutine {
+entry:
+  %x = alloca [128 x i8], align 8
+  %y = alloca [64 x i8], align 64
+  %id = call token @llvm.coro.id.async(i32 32, i32 16, i32 0,
+          ptr @my_async_function_fp)
+  %hdl = call ptr @llvm.coro.begin(token %id, ptr null)
+  %callee_context = call ptr @llvm.coro.async.context.alloc(ptr null, ptr null)
+  %callee_context.return_to_caller.addr = getelementptr inbounds %async.ctxt, ptr %callee_context, i32 0, i32 1
+
+  call void @llvm.lifetime.start.p0(i64 128, ptr %x)
+  call void @opaque(ptr %x)
+  %resume.func_ptr = call ptr @llvm.coro.async.resume()
+  store ptr %resume.func_ptr, ptr %callee_context.return_to_caller.addr
+  %res = call {ptr} (i32, ptr, ptr, ...) @llvm.coro.suspend.async(i32 0,
+                                                  ptr %resume.func_ptr,
+                                                  ptr @__swift_async_resume_project_context,
+                                                  ptr @my_async_function.apply,
+                                                  ptr @asyncSuspend, ptr %callee_context)
+  call void @opaque(ptr %x)
+  call void @llvm.lifetime.end.p0(i64 128, ptr %x)
+
+  call void @llvm.lifetime.start.p0(i64 64, ptr %y)
+  call void @opaque(ptr %y)
+  %resume.func_ptr2 = call ptr @llvm.coro.async.resume()
+  store ptr %resume.func_ptr2, ptr %callee_context.return_to_caller.addr
+  %res2 = call {ptr} (i32, ptr, ptr, ...) @llvm.coro.suspend.async(i32 0,
+                                                  ptr %resume.func_ptr2,
+                                                  ptr @__swift_async_resume_project_context,
+                                                  ptr @my_async_function.apply,
+                                                  ptr @asyncSuspend, ptr %callee_context)
+  call void @opaque(ptr %y)
+  call void @llvm.lifetime.end.p0(i64 64, ptr %y)
+
+  call void @llvm.coro.async.context.dealloc(ptr %callee_context)
+  tail call swiftcc void @asyncReturn(ptr %async.ctxt)
+  call i1 (ptr, i1, ...) @llvm.coro.end.async(ptr %hdl, i1 0)
+  unreachable
+}
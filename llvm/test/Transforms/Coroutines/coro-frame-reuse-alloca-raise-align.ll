@@ -0,0 +1,83 @@
+; Tests that allocas with non-overlapping lifetimes share a frame slot even if
+; the alignment of the smaller one is not a divisor of the larger one's. The
+; slot is then aligned for both.
+; RUN: opt < %s -passes='cgscc(coro-split<reuse-storage>),simplifycfg,early-cse' -S | FileCheck %s
+%"struct.task::promise_type" = type { i8 }
+%struct.big_structure = type { [500 x i8] }
+%struct.big_structure.2 = type { [300 x i8] }
+declare ptr @malloc(i64)
+declare void @free(ptr)
+declare void @consume(ptr)
+declare void @consume.2(ptr)
+
+define void @a(i1 zeroext %cond) presplitcoroutine {
+entry:
+  %__promise = alloca %"struct.task::promise_type", align 1
+  %a = alloca %struct.big_structure, align 1
+  %b = alloca %struct.big_structure.2, align 32
+  %id = call token @llvm.coro.id(i32 16, ptr nonnull %__promise, ptr @a, ptr null)
+  %size = call i64 @llvm.coro.size.i64()
+  %mem = call ptr @malloc(i64 %size)
+  %hdl = call noalias nonnull ptr @llvm.coro.begin(token %id, ptr %mem)
+  br i1 %cond, label %if.then, label %if.else
+
+if.then:
+  call void @llvm.lifetime.start.p0(i64 500, ptr nonnull %a)
+  call void @consume(ptr nonnull %a)
+  %save = call token @llvm.coro.save(ptr null)
+  %suspend = call i8 @llvm.coro.suspend(token %save, i1 false)
+  switch i8 %suspend, label %coro.ret [
+    i8 0, label %await.ready
+    i8 1, label %cleanup1
+  ]
+
+await.ready:
+  call void @consume(ptr nonnull %a)
+  call void @llvm.lifetime.end.p0(i64 500, ptr nonnull %a)
+  br label %cleanup
+
+if.else:
+  call void @llvm.lifetime.start.p0(i64 300, ptr nonnull %b)
+  call void @consume.2(ptr nonnull %b)
+  %save2 = call token @llvm.coro.save(ptr null)
+  %suspend2 = call i8 @llvm.coro.suspend(token %save2, i1 false)
+  switch i8 %suspend2, label %coro.ret [
+    i8 0, label %await2.ready
+    i8 1, label %cleanup2
+  ]
+
+await2.ready:
+  call void @consume.2(ptr nonnull %b)
+  call void @llvm.lifetime.end.p0(i64 300, ptr nonnull %b)
+  br label %cleanup
+
+cleanup1:
+  call void @llvm.lifetime.end.p0(i64 500, ptr nonnull %a)
+  br label %cleanup
+
+cleanup2:
+  call void @llvm.lifetime.end.p0(i64 300, ptr nonnull %b)
+  br label %cleanup
+
+cleanup:
+  %free.mem = call ptr @llvm.coro.free(token %id, ptr %hdl)
+  call void @free(ptr %free.mem)
+  br label %coro.ret
+
+coro.ret:
+  call i1 @llvm.coro.end(ptr null, i1 false)
+  ret void
+}
+
+; %b shares the slot of %a, which is aligned to 32 for it.
+; CHECK: %a.Frame = type { ptr, ptr, %"struct.task::promise_type", i1, [14 x i8], %struct.big_structure }
+
+declare token @llvm.coro.id(i32, ptr readnone, ptr nocapture readonly, ptr)
+declare i64 @llvm.coro.size.i64()
+declare ptr @llvm.coro.begin(token, ptr writeonly)
+declare token @llvm.coro.save(ptr)
+declare i8 @llvm.coro.suspend(token, i1)
+declare ptr @llvm.coro.free(token, ptr nocapture readonly)
+declare i1 @llvm.coro.end(ptr, i1)
+declare void @llvm.lifetime.start.p0(i64, ptr nocapture)
+declare void @llvm.lifetime.end.p0(i64, ptr nocapture)
@@ -271,6 +271,12 @@ static opt<bool> Verify("verify", desc("Verify the DWARF debug info."),
                         cat(DwarfDumpCategory));
 static opt<bool> Quiet("quiet", desc("Use with -verify to not emit to STDOUT."),
                        cat(DwarfDumpCategory));
+static opt<unsigned>
+    NumThreads("threads",
+               desc("Number of threads used to extract the units before "
+                    "--verify or --statistics process them, 0 for all the "
+                    "hardware threads. Defaults to 1."),
+               cat(DwarfDumpCategory), init(1), value_desc("N"));
 static opt<bool> DumpUUID("uuid", desc("Show the UUID for each architecture."),
                           cat(DwarfDumpCategory));
 static alias DumpUUIDAlias("u", desc("Alias for --uuid."), aliasopt(DumpUUID),
@@ -355,6 +361,17 @@ static bool filterArch(ObjectFile &Obj) {
 using HandlerFn = std::function<bool(ObjectFile &, DWARFContext &DICtx,
                                      const Twine &, raw_ostream &)>;
 
+/// Extract the units of the DWARF in parallel first if --threads asks for it.
+static HandlerFn extractUnitsFirst(HandlerFn HandleObj) {
+  if (NumThreads == 1)
+    return HandleObj;
+  return [=](ObjectFile &Obj, DWARFContext &DICtx, const Twine &Filename,
+             raw_ostream &OS) {
+    DICtx.extractNormalUnitsInParallel(NumThreads);
+    return HandleObj(Obj, DICtx, Filename, OS);
+  };
+}
+
 /// Print only DIEs that have a certain name.
 static bool filterByName(
     const StringSet<> &Names, DWARFDie Die, StringRef NameRef, raw_ostream &OS,
@@ -849,10 +866,13 @@ int main(int argc, char **argv) {
   bool Success = true;
   if (Verify) {
     for (auto Object : Objects)
-      Success &= handleFile(Object, verifyObjectFile, OutputFile.os());
+      Success &= handleFile(Object, extractUnitsFirst(verifyObjectFile),
+                            OutputFile.os());
   } else if (Statistics) {
     for (auto Object : Objects)
-      Success &= handleFile(Object, collectStatsForObjectFile, OutputFile.os());
+      Success &= handleFile(Object,
+                            extractUnitsFirst(collectStatsForObjectFile),
+                            OutputFile.os());
   } else if (ShowSectionSizes) {
     for (auto Object : Objects)
       Success &= handleFile(Object, collectObjectSectionSizes, OutputFile.os());
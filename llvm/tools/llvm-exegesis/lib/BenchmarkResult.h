@@ -107,7 +107,7 @@ struct Benchmark {
   std::string Info;
   std::vector<uint8_t> AssembledSnippet;
   // How to aggregate measurements.
-  enum ResultAggregationModeE { Min, Max, Mean, MinVariance };
+  enum ResultAggregationModeE { Min, Max, Mean, Median, MinVariance };
 
   Benchmark() = default;
   Benchmark(Benchmark &&) = default;
@@ -63,6 +63,19 @@ static int64_t findMean(const llvm::SmallVector<int64_t, 4> &Values) {
          static_cast<double>(Values.size());
 }
 
+// The median is robust against the occasional reading that was disturbed by
+// an interrupt or a context switch, which skews the mean.
+int64_t findMedian(llvm::SmallVector<int64_t, 4> Values) {
+  if (Values.empty())
+    return 0;
+  auto Mid = Values.begin() + Values.size() / 2;
+  std::nth_element(Values.begin(), Mid, Values.end());
+  if (Values.size() % 2)
+    return *Mid;
+  const int64_t Lower = *std::max_element(Values.begin(), Mid);
+  return Lower + (*Mid - Lower) / 2;
+}
+
 Expected<std::vector<BenchmarkMeasure>> LatencyBenchmarkRunner::runMeasurements(
     const FunctionExecutor &Executor) const {
   // Cycle measurements include some overhead from the kernel. Repeat the
@@ -132,6 +145,12 @@ Expected<std::vector<BenchmarkMeasure>> LatencyBenchmarkRunner::runMeasurements(
         BenchmarkMeasure::Create(ModeName, findMean(AccumulatedValues)));
     return std::move(Result);
   }
+  case Benchmark::Median: {
+    std::vector<BenchmarkMeasure> Result;
+    Result.push_back(
+        BenchmarkMeasure::Create(ModeName, findMedian(AccumulatedValues)));
+    return std::move(Result);
+  }
   }
   return llvm::make_error<Failure>(llvm::Twine("Unexpected benchmark mode(")
                                        .concat(std::to_string(Mode))
@@ -33,6 +33,10 @@ private:
 
   Benchmark::ResultAggregationModeE ResultAggMode;
 };
+
+// Returns the median of Values, 0 if it is empty. For an even count, this is
+// the midpoint of the two middle values, rounded towards the lower one.
+int64_t findMedian(llvm::SmallVector<int64_t, 4> Values);
 } // namespace exegesis
 } // namespace llvm
 
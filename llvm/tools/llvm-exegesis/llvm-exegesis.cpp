@@ -45,6 +45,10 @@
 #include <algorithm>
 #include <string>
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 namespace llvm {
 namespace exegesis {
 
@@ -95,6 +99,9 @@ static cl::opt<exegesis::Benchmark::ResultAggregationModeE>
                               "Keep max reading"),
                    clEnumValN(exegesis::Benchmark::Mean, "mean",
                               "Compute mean of all readings"),
+                   clEnumValN(exegesis::Benchmark::Median, "median",
+                              "Compute median of all readings, discarding "
+                              "outliers"),
                    clEnumValN(exegesis::Benchmark::MinVariance,
                               "min-variance",
                               "Keep readings set with min-variance")),
@@ -262,6 +269,13 @@ static cl::opt<BenchmarkRunner::ExecutionModeE> ExecutionMode(
                           "allows for the use of memory annotations")),
     cl::init(BenchmarkRunner::ExecutionModeE::InProcess));
 
+static cl::opt<int> BenchmarkProcessCPU(
+    "benchmark-process-cpu",
+    cl::desc("The CPU number that the benchmarking process (and any "
+             "subprocess it spawns) should be pinned to. Pinning to an "
+             "isolated core reduces measurement noise"),
+    cl::cat(BenchmarkOptions), cl::init(-1));
+
 static ExitOnError ExitOnErr("llvm-exegesis error: ");
 
 // Helper function that logs the error(s) and exits.
@@ -450,6 +464,24 @@ static void runBenchmarkConfigurations(
   }
 }
 
+// Pins the current process to CPU. The affinity mask is inherited across
+// fork(), so this also applies to the subprocess execution mode.
+static void pinToCPU(int CPU) {
+#ifdef __linux__
+  if (CPU >= CPU_SETSIZE)
+    ExitWithError("cannot pin the benchmarking process to CPU " + Twine(CPU) +
+                  ": CPU numbers must be less than " + Twine(CPU_SETSIZE));
+  cpu_set_t CPUMask;
+  CPU_ZERO(&CPUMask);
+  CPU_SET(CPU, &CPUMask);
+  if (sched_setaffinity(0, sizeof(CPUMask), &CPUMask) != 0)
+    ExitWithError("cannot pin the benchmarking process to CPU " +
+                  Twine(CPU) + ": " + Twine(strerror(errno)));
+#else
+  ExitWithError("--benchmark-process-cpu is only supported on Linux");
+#endif
+}
+
 void benchmarkMain() {
   if (BenchmarkPhaseSelector == BenchmarkPhaseSelectorE::Measure &&
       !UseDummyPerfCounters) {
@@ -482,6 +514,9 @@ void benchmarkMain() {
     ExitWithError("Dummy perf counters are not supported in the subprocess "
                   "execution mode.");
 
+  if (BenchmarkProcessCPU >= 0)
+    pinToCPU(BenchmarkProcessCPU);
+
   const std::unique_ptr<BenchmarkRunner> Runner =
       ExitOnErr(State.getExegesisTarget().createBenchmarkRunner(
           BenchmarkMode, State, BenchmarkPhaseSelector, ExecutionMode,
@@ -11,18 +11,31 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SystemUtils.h"
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <list>
 #include <vector>
 
+#ifdef LLVM_ON_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace llvm;
 
 static cl::list<std::string> InputFileLists{
@@ -79,6 +92,29 @@ static cl::opt<unsigned int> JobsInParallel{
              "parallel mode"),
 };
 
+static cl::opt<std::string> CacheDirectory{
+    "cache-dir",
+    cl::desc("Specify directory for caching outputs of the command. The "
+             "command is not run for the inputs which have an output in the "
+             "cache, the cached output is copied instead."),
+    cl::init(""), cl::value_desc("R")};
+
+static cl::opt<std::string> CacheKey{
+    "cache-key",
+    cl::desc("Specify a string identifying the version of the toolchain the "
+             "command runs, e.g. of the program, the libraries it loads and "
+             "the drivers it uses. It is part of the key of the cached "
+             "outputs, and required with --cache-dir."),
+    cl::init(""), cl::value_desc("key")};
+
+static cl::opt<bool> UseJobserver{
+    "jobserver",
+    cl::desc("Take part in the GNU make jobserver protocol when a jobserver "
+             "is passed in MAKEFLAGS. Every command beyond the first one run "
+             "in parallel then needs a job slot of the jobserver, --jobs is "
+             "still the upper limit."),
+    cl::init(false)};
+
 static cl::alias JobsInParallelShort{"j", cl::desc("Alias for --jobs"),
                                      cl::aliasopt(JobsInParallel)};
 
@@ -92,15 +128,270 @@ static void error(std::error_code EC, const Twine &Prefix) {
     error(Prefix + ": " + EC.message());
 }
 
+// Client of the jobserver of GNU make, or of another build tool using the
+// same protocol. The jobserver hands out job slots as single bytes read from a
+// pipe or fifo, the bytes are written back when the job finishes. The process
+// itself always owns one implicit slot.
+class Jobserver {
+public:
+  // Connects to the jobserver passed in MAKEFLAGS, returns nullptr if there
+  // is none or it can't be used.
+  static std::unique_ptr<Jobserver> connect();
+
+  ~Jobserver();
+
+  // Tries to take a job slot, waiting for at most TimeoutMs milliseconds.
+  bool tryAcquire(int TimeoutMs);
+  // Gives back one of the job slots taken.
+  void release();
+  size_t getNumAcquired() const { return Tokens.size(); }
+
+private:
+  Jobserver(int ReadFD, int WriteFD, bool OwnsWriteFD)
+      : ReadFD(ReadFD), WriteFD(WriteFD), OwnsWriteFD(OwnsWriteFD) {}
+
+  // Opened with O_NONBLOCK, since another client may take the byte between
+  // polling and reading the descriptor.
+  int ReadFD;
+  int WriteFD;
+  bool OwnsWriteFD;
+  // The bytes read, make may rely on getting the same ones back.
+  std::vector<char> Tokens;
+};
+
+std::unique_ptr<Jobserver> Jobserver::connect() {
+#ifdef LLVM_ON_UNIX
+  std::optional<std::string> MakeFlags = sys::Process::GetEnv("MAKEFLAGS");
+  if (!MakeFlags)
+    return nullptr;
+  // The last option wins, older versions of make use --jobserver-fds.
+  StringRef Auth;
+  for (StringRef Flag : split(*MakeFlags, ' '))
+    if (Flag.consume_front("--jobserver-auth=") ||
+        Flag.consume_front("--jobserver-fds="))
+      Auth = Flag;
+  if (Auth.empty())
+    return nullptr;
+
+  // The descriptors named in MAKEFLAGS are not necessarily inherited, e.g. when
+  // make didn't consider the command recursive. They may then refer to any
+  // other file, which must not be read from or written to.
+  auto IsFifo = [](int FD) {
+    struct stat Stat;
+    return fstat(FD, &Stat) == 0 && S_ISFIFO(Stat.st_mode);
+  };
+
+  if (Auth.consume_front("fifo:")) {
+    int FD = open(Auth.str().c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (FD < 0)
+      return nullptr;
+    if (!IsFifo(FD)) {
+      close(FD);
+      return nullptr;
+    }
+    return std::unique_ptr<Jobserver>(new Jobserver(FD, FD, true));
+  }
+
+  auto [ReadStr, WriteStr] = Auth.split(',');
+  int InheritedReadFD, WriteFD;
+  if (ReadStr.getAsInteger(10, InheritedReadFD) ||
+      WriteStr.getAsInteger(10, WriteFD) || !IsFifo(InheritedReadFD) ||
+      !IsFifo(WriteFD))
+    return nullptr;
+  // The pipe is shared with make and the other clients, so O_NONBLOCK can't
+  // be set on the inherited descriptor. Reopening it gives a descriptor of
+  // our own.
+  std::string ReadPath = ("/proc/self/fd/" + Twine(InheritedReadFD)).str();
+  int ReadFD = open(ReadPath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (ReadFD < 0)
+    return nullptr;
+  return std::unique_ptr<Jobserver>(new Jobserver(ReadFD, WriteFD, false));
+#else
+  return nullptr;
+#endif
+}
+
+Jobserver::~Jobserver() {
+#ifdef LLVM_ON_UNIX
+  while (!Tokens.empty())
+    release();
+  close(ReadFD);
+  if (OwnsWriteFD && WriteFD != ReadFD)
+    close(WriteFD);
+#endif
+}
+
+bool Jobserver::tryAcquire(int TimeoutMs) {
+#ifdef LLVM_ON_UNIX
+  pollfd PFD{ReadFD, POLLIN, 0};
+  if (poll(&PFD, 1, TimeoutMs) <= 0)
+    return false;
+  char Token;
+  if (read(ReadFD, &Token, 1) != 1)
+    return false;
+  Tokens.push_back(Token);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Jobserver::release() {
+#ifdef LLVM_ON_UNIX
+  assert(!Tokens.empty() && "No job slot to release");
+  char Token = Tokens.back();
+  Tokens.pop_back();
+  while (write(WriteFD, &Token, 1) < 0 && errno == EINTR)
+    ;
+#endif
+}
+
+struct Job {
+  sys::ProcessInfo Process;
+  // Output file of the command.
+  std::string Output;
+  // Path to store the output at in the cache, empty if it is not cached.
+  std::string CachedOutput;
+};
+
+// A command which is not started yet.
+struct PendingJob {
+  std::vector<std::string> Args;
+  std::string Output;
+  std::string CachedOutput;
+  // Total size of the input files, jobs with larger inputs are started first.
+  uint64_t InputSize = 0;
+};
+
+// Returns Str with all occurrences of From replaced with To.
+static std::string replaceAll(StringRef Str, StringRef From, StringRef To) {
+  if (From.empty())
+    return Str.str();
+  std::string Res;
+  size_t Pos = 0;
+  for (size_t Next; (Next = Str.find(From, Pos)) != StringRef::npos;
+       Pos = Next + From.size())
+    Res += (Str.slice(Pos, Next) + To).str();
+  return Res + Str.substr(Pos).str();
+}
+
+// Adds the size and contents of the file to the hash. Returns false if the
+// file isn't readable.
+static bool hashFile(MD5 &Hash, const Twine &Path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
+      MemoryBuffer::getFile(Path, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (!MB)
+    return false;
+  Hash.update(utostr((*MB)->getBufferSize()));
+  Hash.update((*MB)->getBuffer());
+  return true;
+}
+
+// Returns the names of the files an argument of the command may refer to: the
+// argument itself, a response file (@file) and the value of an option
+// (-opt=file).
+static SmallVector<StringRef, 3> getReferencedFiles(StringRef Arg) {
+  SmallVector<StringRef, 3> Files;
+  auto AddIfFile = [&](StringRef Path) {
+    if (!Path.empty() && sys::fs::is_regular_file(Path))
+      Files.push_back(Path);
+  };
+  AddIfFile(Arg);
+  if (Arg.starts_with("@"))
+    AddIfFile(Arg.drop_front());
+  if (size_t Eq = Arg.find('='); Eq != StringRef::npos)
+    AddIfFile(Arg.drop_front(Eq + 1));
+  return Files;
+}
+
+// Computes the name of the command's output in the cache. The key covers:
+// - the contents of the input files;
+// - the command line, without the replace strings, which are usually
+//   temporary file names;
+// - the contents of the other files named in the command line, e.g. response
+//   and configuration files;
+// - the modification time and size of the program, and --cache-key.
+// Files read by the program without being named in the command line, and the
+// environment, are not covered. Returns an empty string if any of the files
+// isn't readable.
+static std::string computeCacheKey(StringRef Prog,
+                                   ArrayRef<std::string> InputFiles) {
+  sys::fs::file_status ProgStatus;
+  if (sys::fs::status(Prog, ProgStatus))
+    return "";
+
+  std::string CommandLine;
+  raw_string_ostream CommandOS(CommandLine);
+  CommandOS << CacheKey << '\0' << Prog << '\0'
+            << sys::toTimeT(ProgStatus.getLastModificationTime()) << '\0'
+            << ProgStatus.getSize() << '\0';
+  std::vector<StringRef> ReferencedFiles;
+  for (const std::string &Arg : InputCommandArgs) {
+    std::string NormalizedArg = Arg;
+    for (size_t I = 0; I < Replaces.size(); ++I)
+      NormalizedArg = replaceAll(NormalizedArg, Replaces[I],
+                                 ("{in" + Twine(I) + "}").str());
+    NormalizedArg = replaceAll(NormalizedArg, OutReplace, "{out}");
+    // The input files are hashed below, the output file is not an input.
+    if (NormalizedArg == Arg)
+      llvm::append_range(ReferencedFiles, getReferencedFiles(Arg));
+    CommandOS << NormalizedArg << '\0';
+  }
+
+  MD5 Hash;
+  Hash.update(CommandOS.str());
+  for (const std::string &InputFile : InputFiles)
+    if (!hashFile(Hash, InputFile))
+      return "";
+  for (StringRef File : ReferencedFiles) {
+    Hash.update(File);
+    if (!hashFile(Hash, File))
+      return "";
+  }
+
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  return std::string(Result.digest());
+}
+
+// Copies the output of a finished command to the cache. The output is copied
+// to a temporary file first, so that other processes using the same cache
+// never see a partially written output.
+static void storeInCache(const Job &J) {
+  SmallString<128> TempPath(J.CachedOutput);
+  TempPath += "-%%%%%%.tmp";
+  int FD;
+  if (sys::fs::createUniqueFile(TempPath, FD, TempPath))
+    return;
+  sys::Process::SafelyCloseFileDescriptor(FD);
+  if (sys::fs::copy_file(J.Output, TempPath) ||
+      sys::fs::rename(TempPath, J.CachedOutput))
+    sys::fs::remove(TempPath);
+}
+
+// Handles the result of a finished job, returns its exit code.
+static int finishJob(const Job &Finished, const sys::ProcessInfo &WaitResult,
+                     const std::string &ErrMsg) {
+  if (WaitResult.ReturnCode != 0) {
+    errs() << "llvm-foreach: " << ErrMsg << '\n';
+    return WaitResult.ReturnCode;
+  }
+  if (!Finished.CachedOutput.empty())
+    storeInCache(Finished);
+  return 0;
+}
+
 // With BlockingWait=false this function just goes through the all
 // submitted jobs to check if some of them have finished.
-int checkIfJobsAreFinished(std::list<sys::ProcessInfo> &JobsSubmitted,
+int checkIfJobsAreFinished(std::list<Job> &JobsSubmitted,
                            bool BlockingWait = true) {
   std::string ErrMsg;
   auto It = JobsSubmitted.begin();
   while (It != JobsSubmitted.end()) {
     sys::ProcessInfo WaitResult = sys::Wait(
-        *It, /*SecondsToWait*/ BlockingWait ? std::nullopt : std::optional(0),
+        It->Process,
+        /*SecondsToWait*/ BlockingWait ? std::nullopt : std::optional(0),
         &ErrMsg);
 
     // Check if the job has finished (PID will be 0 if it's not).
@@ -109,16 +400,25 @@ int checkIfJobsAreFinished(std::list<sys::ProcessInfo> &JobsSubmitted,
       continue;
     }
     assert(BlockingWait || WaitResult.Pid);
+    Job Finished = std::move(*It);
     It = JobsSubmitted.erase(It);
-
-    if (WaitResult.ReturnCode != 0) {
-      errs() << "llvm-foreach: " << ErrMsg << '\n';
-      return WaitResult.ReturnCode;
-    }
+    if (int Result = finishJob(Finished, WaitResult, ErrMsg))
+      return Result;
   }
   return 0;
 }
 
+// Blocks until the first submitted job has finished.
+static int waitForFirstJob(std::list<Job> &JobsSubmitted) {
+  std::string ErrMsg;
+  sys::ProcessInfo WaitResult = sys::Wait(JobsSubmitted.front().Process,
+                                          /*SecondsToWait*/ std::nullopt,
+                                          &ErrMsg);
+  Job Finished = std::move(JobsSubmitted.front());
+  JobsSubmitted.pop_front();
+  return finishJob(Finished, WaitResult, ErrMsg);
+}
+
 int main(int argc, char **argv) {
   cl::ParseCommandLineOptions(
       argc, argv,
@@ -210,6 +510,15 @@ int main(int argc, char **argv) {
            << MaxSafeNumThreads << " (max safe available).\n";
   }
 
+  // Outputs of the commands are only cached if the output file is known.
+  if (!CacheDirectory.empty() && CacheKey.empty())
+    error("--cache-dir requires --cache-key.");
+  bool UseCache = !CacheDirectory.empty() && !OutReplace.empty() &&
+                  OutIncrement.empty();
+  if (UseCache)
+    error(sys::fs::create_directories(CacheDirectory),
+          "Could not create the cache directory '" + CacheDirectory + "'");
+
   std::error_code EC;
   raw_fd_ostream OS{OutputFileList, EC, sys::fs::OpenFlags::OF_None};
   if (!OutputFileList.empty())
@@ -219,8 +528,7 @@ int main(int argc, char **argv) {
   std::string ResOutArg;
   std::string IncOutArg;
   std::vector<std::string> ResInArgs(InReplaceArgs.size());
-  std::string ResFileList = "";
-  std::list<sys::ProcessInfo> JobsSubmitted;
+  std::vector<PendingJob> PendingJobs;
   for (size_t j = 0; j != FileLists[0].size(); ++j) {
     for (size_t i = 0; i < InReplaceArgs.size(); ++i) {
       ArgumentReplace CurReplace = InReplaceArgs[i];
@@ -272,23 +580,84 @@ int main(int argc, char **argv) {
       Args[OutIncrementArg.ArgNum] = IncOutArg;
     }
 
-    // Do not start execution of a new job until previous one(s) are finished,
-    // if the maximum number of parallel workers is reached.
-    while (JobsSubmitted.size() == JobsInParallel)
+    std::vector<std::string> InputFiles;
+    for (const std::vector<std::string> &FileList : FileLists)
+      InputFiles.push_back(FileList[j]);
+
+    std::string CachedOutput;
+    if (UseCache) {
+      std::string Key = computeCacheKey(Prog, InputFiles);
+      if (!Key.empty()) {
+        SmallString<128> CachePath(CacheDirectory);
+        sys::path::append(CachePath, Key + "." + OutFilesExt);
+        // Reuse the cached output, the command is run if it can't be copied.
+        if (sys::fs::exists(CachePath) && !sys::fs::copy_file(CachePath, Path))
+          continue;
+        CachedOutput = std::string(CachePath);
+      }
+    }
+
+    uint64_t InputSize = 0;
+    for (const std::string &InputFile : InputFiles) {
+      uint64_t Size;
+      if (!sys::fs::file_size(InputFile, Size))
+        InputSize += Size;
+    }
+    PendingJobs.push_back({std::vector<std::string>(Args.begin(), Args.end()),
+                           std::string(Path), std::move(CachedOutput),
+                           InputSize});
+  }
+
+  // A large job started last would prolong the whole run. The output file
+  // list is already written, so it keeps the order of the inputs.
+  if (JobsInParallel > 1)
+    llvm::stable_sort(PendingJobs,
+                      [](const PendingJob &LHS, const PendingJob &RHS) {
+                        return LHS.InputSize > RHS.InputSize;
+                      });
+
+  std::unique_ptr<Jobserver> JS;
+  if (UseJobserver && JobsInParallel > 1)
+    JS = Jobserver::connect();
+
+  std::list<Job> JobsSubmitted;
+  // Every job but the first one needs a job slot from the jobserver.
+  auto CanStartJob = [&]() {
+    if (JobsSubmitted.size() >= JobsInParallel)
+      return false;
+    if (!JS || JobsSubmitted.size() <= JS->getNumAcquired())
+      return true;
+    return JS->tryAcquire(/*TimeoutMs=*/10);
+  };
+  // Gives back the job slots the running jobs don't need anymore.
+  auto ReleaseJobSlots = [&]() {
+    while (JS && JS->getNumAcquired() &&
+           JS->getNumAcquired() >= JobsSubmitted.size())
+      JS->release();
+  };
+
+  for (PendingJob &PJ : PendingJobs) {
+    // Do not start execution of a new job until previous one(s) are
+    // finished, if the maximum number of parallel workers is reached.
+    while (!CanStartJob())
       if (int Result =
               checkIfJobsAreFinished(JobsSubmitted, /*BlockingWait*/ false))
         Res = Result;
 
-    JobsSubmitted.emplace_back(
-        sys::ExecuteNoWait(Prog, Args, /*Env=*/std::nullopt,
-                           /*Redirects=*/std::nullopt, /*MemoryLimit=*/0));
+    SmallVector<StringRef, 8> JobArgs(PJ.Args.begin(), PJ.Args.end());
+    JobsSubmitted.push_back(
+        {sys::ExecuteNoWait(Prog, JobArgs, /*Env=*/std::nullopt,
+                            /*Redirects=*/std::nullopt, /*MemoryLimit=*/0),
+         std::move(PJ.Output), std::move(PJ.CachedOutput)});
   }
 
-  // Wait for all commands to be executed.
-  while (!JobsSubmitted.empty())
-    if (int Result =
-            checkIfJobsAreFinished(JobsSubmitted, /*BlockingWait*/ true))
+  // Wait for all commands to be executed. Job slots are given back as the
+  // jobs are reaped, so that other jobs of the build can use them.
+  while (!JobsSubmitted.empty()) {
+    if (int Result = waitForFirstJob(JobsSubmitted))
       Res = Result;
+    ReleaseJobSlots();
+  }
 
   if (!OutputFileList.empty()) {
     OS.close();
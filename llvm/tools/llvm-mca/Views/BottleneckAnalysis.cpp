@@ -640,5 +640,59 @@ void BottleneckAnalysis::printView(raw_ostream &OS) const {
   printCriticalSequence(OS);
 }
 
+json::Value BottleneckAnalysis::toJSON() const {
+  json::Array Resources;
+  ArrayRef<unsigned> Distribution = Tracker.getResourcePressureDistribution();
+  const MCSchedModel &SM = getSubTargetInfo().getSchedModel();
+  for (unsigned I = 0, E = Distribution.size(); I < E; ++I) {
+    if (!Distribution[I])
+      continue;
+    Resources.push_back(
+        json::Object({{"Resource", SM.getProcResource(I)->Name},
+                      {"Cycles", Distribution[I]}}));
+  }
+
+  // The critical sequence is only meaningful if the simulation saw
+  // bottlenecks; see printCriticalSequence().
+  json::Array CriticalSequence;
+  if (SeenStallCycles && BPI.PressureIncreaseCycles) {
+    SmallVector<const DependencyEdge *, 16> Seq;
+    DG.getCriticalSequence(Seq);
+    ArrayRef<llvm::MCInst> Source = getSource();
+    for (const DependencyEdge *DE : Seq) {
+      const DependencyEdge::Dependency &Dep = DE->Dep;
+      json::Object Edge({{"FromInstructionIndex", DE->FromIID % Source.size()},
+                         {"ToInstructionIndex", DE->ToIID % Source.size()},
+                         {"Cost", Dep.Cost}});
+      if (Dep.Type == DependencyEdge::DT_REGISTER) {
+        std::string Buffer;
+        raw_string_ostream TempStream(Buffer);
+        getInstPrinter().printRegName(TempStream, Dep.ResourceOrRegID);
+        Edge["Type"] = "Register";
+        Edge["Register"] = TempStream.str();
+      } else if (Dep.Type == DependencyEdge::DT_MEMORY) {
+        Edge["Type"] = "Memory";
+      } else {
+        assert(Dep.Type == DependencyEdge::DT_RESOURCE &&
+               "Unsupported dependency type!");
+        Edge["Type"] = "Resource";
+        Edge["Resource"] = Tracker.resolveResourceName(Dep.ResourceOrRegID);
+        Edge["Probability"] = (DE->Frequency * 100) / Iterations;
+      }
+      CriticalSequence.push_back(std::move(Edge));
+    }
+  }
+
+  json::Object JO({{"TotalCycles", TotalCycles},
+                   {"PressureIncreaseCycles", BPI.PressureIncreaseCycles},
+                   {"ResourcePressureCycles", BPI.ResourcePressureCycles},
+                   {"DataDependencyCycles", BPI.DataDependencyCycles},
+                   {"RegisterDependencyCycles", BPI.RegisterDependencyCycles},
+                   {"MemoryDependencyCycles", BPI.MemoryDependencyCycles},
+                   {"ResourcePressureDistribution", std::move(Resources)},
+                   {"CriticalSequence", std::move(CriticalSequence)}});
+  return JO;
+}
+
 } // namespace mca.
 } // namespace llvm
@@ -470,6 +470,9 @@ mergeInstrProfile(const WeightedFileVector &Inputs, StringRef DebugInfoFilename,
                    Contexts[End - 1].get());
         Pool.wait();
       }
+      // The contexts merged in this step hold no errors anymore, release the
+      // rest of their data before the next step.
+      Contexts.truncate(Mid);
       End = Mid;
       Mid /= 2;
     } while (Mid > 0);
@@ -557,14 +557,17 @@ bool PerfScriptReader::extractLBRStack(TraceStream &TraceIt,
     if (Token.size() == 0)
       continue;
 
-    SmallVector<StringRef, 8> Addresses;
-    Token.split(Addresses, "/");
+    // Only the source and the target are used, so don't split the remaining
+    // fields of the record; this runs for every LBR entry of every sample.
+    auto [SrcStr, Rest] = Token.split('/');
+    StringRef DstStr = Rest.split('/').first;
     uint64_t Src;
     uint64_t Dst;
 
     // Stop at broken LBR records.
-    if (Addresses.size() < 2 || Addresses[0].substr(2).getAsInteger(16, Src) ||
-        Addresses[1].substr(2).getAsInteger(16, Dst)) {
+    if (SrcStr.size() == Token.size() ||
+        SrcStr.substr(2).getAsInteger(16, Src) ||
+        DstStr.substr(2).getAsInteger(16, Dst)) {
       WarnInvalidLBR(TraceIt);
       break;
     }
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cassert>
 #include <numeric>
+#include <optional>
 #include <system_error>
 #include <utility>
 
@@ -29,9 +30,9 @@ using namespace llvm;
 using namespace llvm::xray;
 
 static cl::SubCommand Account("account", "Function call accounting");
-static cl::opt<std::string> AccountInput(cl::Positional,
-                                         cl::desc("<xray log file>"),
-                                         cl::Required, cl::sub(Account));
+static cl::list<std::string> AccountInputs(cl::Positional,
+                                           cl::desc("<xray log file>"),
+                                           cl::OneOrMore, cl::sub(Account));
 static cl::opt<bool>
     AccountKeepGoing("keep-going", cl::desc("Keep going on errors encountered"),
                      cl::sub(Account), cl::init(false));
@@ -472,48 +473,56 @@ static CommandRegistration Unused(&Account, []() -> Error {
                                                   FunctionAddresses);
   xray::LatencyAccountant FCA(FuncIdHelper, AccountRecursiveCallsOnly,
                               AccountDeduceSiblingCalls);
-  auto TraceOrErr = loadTraceFile(AccountInput);
-  if (!TraceOrErr)
-    return joinErrors(
-        make_error<StringError>(
-            Twine("Failed loading input file '") + AccountInput + "'",
-            std::make_error_code(std::errc::executable_format_error)),
-        TraceOrErr.takeError());
-
-  auto &T = *TraceOrErr;
-  for (const auto &Record : T) {
-    if (FCA.accountRecord(Record))
-      continue;
-    errs()
-        << "Error processing record: "
-        << llvm::formatv(
-               R"({{type: {0}; cpu: {1}; record-type: {2}; function-id: {3}; tsc: {4}; thread-id: {5}; process-id: {6}}})",
-               Record.RecordType, Record.CPU, Record.Type, Record.FuncId,
-               Record.TSC, Record.TId, Record.PId)
-        << '\n';
-    for (const auto &ThreadStack : FCA.getPerThreadFunctionStack()) {
-      errs() << "Thread ID: " << ThreadStack.first << "\n";
-      if (ThreadStack.second.Stack.empty()) {
-        errs() << "  (empty stack)\n";
+  // Multiple inputs are accounted as one trace, in order. This lets the
+  // logs written by successive flushes of a long running process (which
+  // each get their own file) be reported together.
+  std::optional<XRayFileHeader> Header;
+  for (const auto &AccountInput : AccountInputs) {
+    auto TraceOrErr = loadTraceFile(AccountInput);
+    if (!TraceOrErr)
+      return joinErrors(
+          make_error<StringError>(
+              Twine("Failed loading input file '") + AccountInput + "'",
+              std::make_error_code(std::errc::executable_format_error)),
+          TraceOrErr.takeError());
+
+    auto &T = *TraceOrErr;
+    if (!Header)
+      Header = T.getFileHeader();
+    for (const auto &Record : T) {
+      if (FCA.accountRecord(Record))
         continue;
+      errs()
+          << "Error processing record: "
+          << llvm::formatv(
+                 R"({{type: {0}; cpu: {1}; record-type: {2}; function-id: {3}; tsc: {4}; thread-id: {5}; process-id: {6}}})",
+                 Record.RecordType, Record.CPU, Record.Type, Record.FuncId,
+                 Record.TSC, Record.TId, Record.PId)
+          << '\n';
+      for (const auto &ThreadStack : FCA.getPerThreadFunctionStack()) {
+        errs() << "Thread ID: " << ThreadStack.first << "\n";
+        if (ThreadStack.second.Stack.empty()) {
+          errs() << "  (empty stack)\n";
+          continue;
+        }
+        auto Level = ThreadStack.second.Stack.size();
+        for (const auto &Entry : llvm::reverse(ThreadStack.second.Stack))
+          errs() << "  #" << Level-- << "\t"
+                 << FuncIdHelper.SymbolOrNumber(Entry.first) << '\n';
       }
-      auto Level = ThreadStack.second.Stack.size();
-      for (const auto &Entry : llvm::reverse(ThreadStack.second.Stack))
-        errs() << "  #" << Level-- << "\t"
-               << FuncIdHelper.SymbolOrNumber(Entry.first) << '\n';
+      if (!AccountKeepGoing)
+        return make_error<StringError>(
+            Twine("Failed accounting function calls in file '") +
+                AccountInput + "'.",
+            std::make_error_code(std::errc::executable_format_error));
     }
-    if (!AccountKeepGoing)
-      return make_error<StringError>(
-          Twine("Failed accounting function calls in file '") + AccountInput +
-              "'.",
-          std::make_error_code(std::errc::executable_format_error));
   }
   switch (AccountOutputFormat) {
   case AccountOutputFormats::TEXT:
-    FCA.exportStatsAsText(OS, T.getFileHeader());
+    FCA.exportStatsAsText(OS, *Header);
     break;
   case AccountOutputFormats::CSV:
-    FCA.exportStatsAsCSV(OS, T.getFileHeader());
+    FCA.exportStatsAsCSV(OS, *Header);
     break;
   }
 
@@ -11,9 +11,11 @@
 #include "ModuleSplitter.h"
 #include "Support.h"
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/InstIterator.h"
@@ -28,6 +30,7 @@
 #include "llvm/Transforms/IPO/StripDeadPrototypes.h"
 #include "llvm/Transforms/IPO/StripSymbols.h"
 #include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
 
 #include <algorithm>
 #include <map>
@@ -49,6 +52,7 @@ EntryPointsGroupScope selectDeviceCodeGroupScope(const Module &M,
                                                  bool AutoSplitIsGlobalScope) {
   switch (Mode) {
   case SPLIT_PER_TU:
+  case SPLIT_BY_COST:
     return Scope_PerModule;
 
   case SPLIT_PER_KERNEL:
@@ -205,6 +209,10 @@ public:
     for (const auto &GV : M.globals())
       for (const Value *U : GV.users())
         addUserToGraphRecursively(cast<const User>(U), &GV);
+
+    unsigned Position = 0;
+    for (const GlobalValue &GV : M.global_values())
+      Positions[&GV] = Position++;
   }
 
   iterator_range<GlobalSet::const_iterator>
@@ -215,6 +223,12 @@ public:
                : make_range(It->second.begin(), It->second.end());
   }
 
+  // Returns the position of a global value in the module.
+  unsigned getPosition(const GlobalValue *Val) const {
+    assert(Positions.count(Val) && "not a global value of the module");
+    return Positions.lookup(Val);
+  }
+
 private:
   void addUserToGraphRecursively(const User *Root, const GlobalValue *V) {
 
@@ -242,6 +256,8 @@ private:
 
   DenseMap<const GlobalValue *, GlobalSet> Graph;
   SmallPtrSet<const GlobalValue *, 1> EmptySet;
+  // Used to keep the order of globals in the split modules.
+  DenseMap<const GlobalValue *, unsigned> Positions;
 };
 
 void collectFunctionsAndGlobalVariablesToExtract(
@@ -281,16 +297,223 @@ void collectFunctionsAndGlobalVariablesToExtract(
   }
 }
 
-ModuleDesc extractSubModule(const ModuleDesc &MD,
-                            const SetVector<const GlobalValue *> GVs,
-                            EntryPointGroup &&ModuleEntryPoints) {
-  const Module &M = MD.getModule();
-  // For each group of entry points collect all dependencies.
+void copyComdat(GlobalObject *Dst, const GlobalObject *Src) {
+  const Comdat *SC = Src->getComdat();
+  if (!SC)
+    return;
+  Comdat *DC = Dst->getParent()->getOrInsertComdat(SC->getName());
+  DC->setSelectionKind(SC->getSelectionKind());
+  Dst->setComdat(DC);
+}
+
+// Creates an external declaration in place of an alias. An alias cannot act
+// as an external reference, so it is a function or a global variable
+// depending on the value type.
+GlobalValue *declareAlias(const GlobalAlias &GA, Module &M) {
+  if (GA.getValueType()->isFunctionTy())
+    return Function::Create(cast<FunctionType>(GA.getValueType()),
+                            GlobalValue::ExternalLinkage, GA.getAddressSpace(),
+                            GA.getName(), &M);
+  return new GlobalVariable(M, GA.getValueType(), false,
+                            GlobalValue::ExternalLinkage, nullptr,
+                            GA.getName(), nullptr, GA.getThreadLocalMode(),
+                            GA.getType()->getAddressSpace());
+}
+
+// Declares globals of the input module in a split module when the globals
+// copied to the split module refer to them. Declaring every global of the
+// input module, the way CloneModule does, would make the cost of each split
+// proportional to the size of the input module.
+class DeclarationMaterializer final : public ValueMaterializer {
+public:
+  DeclarationMaterializer(const Module &Src, Module &Dst)
+      : Src(Src), Dst(Dst) {}
+
+  Value *materialize(Value *V) override {
+    auto *GV = dyn_cast<GlobalValue>(V);
+    if (!GV || GV->getParent() != &Src)
+      return nullptr;
+    GlobalValue *Decl = declare(*GV);
+    Declared.emplace_back(GV, Decl);
+    return Decl;
+  }
+
+  // Returns the declarations created since the previous call along with the
+  // globals they declare.
+  SmallVector<std::pair<const GlobalValue *, GlobalValue *>, 0> takeDeclared() {
+    return std::exchange(Declared, {});
+  }
+
+private:
+  GlobalValue *declare(const GlobalValue &GV) {
+    assert(!isa<GlobalIFunc>(GV) && "ifuncs are copied along with definitions");
+    // Definitions which are not copied become external declarations.
+    if (const auto *Var = dyn_cast<GlobalVariable>(&GV)) {
+      auto *NewVar = new GlobalVariable(
+          Dst, Var->getValueType(), Var->isConstant(),
+          Var->isDeclaration() ? Var->getLinkage()
+                               : GlobalValue::ExternalLinkage,
+          nullptr, Var->getName(), nullptr, Var->getThreadLocalMode(),
+          Var->getType()->getAddressSpace());
+      NewVar->copyAttributesFrom(Var);
+      return NewVar;
+    }
+    if (const auto *F = dyn_cast<Function>(&GV)) {
+      Function *NewF = Function::Create(
+          F->getFunctionType(),
+          F->isDeclaration() ? F->getLinkage() : GlobalValue::ExternalLinkage,
+          F->getAddressSpace(), F->getName(), &Dst);
+      NewF->copyAttributesFrom(F);
+      // Personality function is not valid on a declaration.
+      NewF->setPersonalityFn(nullptr);
+      return NewF;
+    }
+    return declareAlias(cast<GlobalAlias>(GV), Dst);
+  }
+
+  const Module &Src;
+  Module &Dst;
+  SmallVector<std::pair<const GlobalValue *, GlobalValue *>, 0> Declared;
+};
+
+// Copies the globals listed in GVs to a new module. Other globals of M are
+// only declared in the new module if the copied ones refer to them. The result
+// is the same as of CloneModule with GVs as the set of definitions to clone,
+// after unused declarations are removed.
+std::unique_ptr<Module>
+cloneModuleSubset(const Module &M, const SetVector<const GlobalValue *> &GVs,
+                  const DependencyGraph &CG, ValueToValueMapTy &VMap) {
+  auto New = std::make_unique<Module>(M.getModuleIdentifier(), M.getContext());
+  New->setSourceFileName(M.getSourceFileName());
+  New->setDataLayout(M.getDataLayout());
+  New->setTargetTriple(M.getTargetTriple());
+  New->setModuleInlineAsm(M.getModuleInlineAsm());
+
+  DeclarationMaterializer Materializer(M, *New);
+  auto MapMD = [&](const MDNode *MD) {
+    return MapMetadata(MD, VMap, RF_None, nullptr, &Materializer);
+  };
+  auto CopyMetadata = [&](GlobalObject *Dst, const GlobalObject *Src) {
+    SmallVector<std::pair<unsigned, MDNode *>, 1> MDs;
+    Src->getAllMetadata(MDs);
+    for (auto MD : MDs)
+      Dst->addMetadata(MD.first, *MapMD(MD.second));
+  };
+  // Positions of the created globals in M.
+  SmallVector<std::pair<unsigned, GlobalValue *>, 0> Created;
+
+  // Create all the globals to copy before any references are mapped, so that
+  // the materializer doesn't declare them.
+  for (const GlobalValue *GV : GVs) {
+    GlobalValue *NewGV = nullptr;
+    if (const auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      auto *NewVar = new GlobalVariable(
+          *New, Var->getValueType(), Var->isConstant(), Var->getLinkage(),
+          nullptr, Var->getName(), nullptr, Var->getThreadLocalMode(),
+          Var->getType()->getAddressSpace());
+      NewVar->copyAttributesFrom(Var);
+      NewGV = NewVar;
+    } else {
+      const auto *F = cast<Function>(GV);
+      Function *NewF =
+          Function::Create(F->getFunctionType(), F->getLinkage(),
+                           F->getAddressSpace(), F->getName(), New.get());
+      NewF->copyAttributesFrom(F);
+      NewGV = NewF;
+    }
+    VMap[GV] = NewGV;
+    Created.emplace_back(CG.getPosition(GV), NewGV);
+  }
+
+  // Same as CloneModule, ifuncs are copied regardless of their uses.
+  for (const GlobalIFunc &I : M.ifuncs()) {
+    auto *GI =
+        GlobalIFunc::create(I.getValueType(), I.getAddressSpace(),
+                            I.getLinkage(), I.getName(), nullptr, New.get());
+    GI->copyAttributesFrom(&I);
+    VMap[&I] = GI;
+  }
+
+  for (const GlobalValue *GV : GVs) {
+    if (const auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      auto *NewVar = cast<GlobalVariable>(VMap[Var]);
+      CopyMetadata(NewVar, Var);
+      if (Var->hasInitializer())
+        NewVar->setInitializer(MapValue(Var->getInitializer(), VMap, RF_None,
+                                        nullptr, &Materializer));
+      if (!Var->isDeclaration())
+        copyComdat(NewVar, Var);
+      continue;
+    }
+
+    const auto *F = cast<Function>(GV);
+    auto *NewF = cast<Function>(VMap[F]);
+    if (F->isDeclaration()) {
+      CopyMetadata(NewF, F);
+      continue;
+    }
+    Function::arg_iterator DestI = NewF->arg_begin();
+    for (const Argument &J : F->args()) {
+      DestI->setName(J.getName());
+      VMap[&J] = &*DestI++;
+    }
+    SmallVector<ReturnInst *, 8> Returns; // Ignore returns cloned.
+    CloneFunctionInto(NewF, F, VMap, CloneFunctionChangeType::ClonedModule,
+                      Returns, "", nullptr, nullptr, &Materializer);
+    if (F->hasPersonalityFn())
+      NewF->setPersonalityFn(MapValue(F->getPersonalityFn(), VMap, RF_None,
+                                      nullptr, &Materializer));
+    copyComdat(NewF, F);
+  }
+
+  for (const GlobalIFunc &I : M.ifuncs()) {
+    GlobalIFunc *GI = cast<GlobalIFunc>(VMap[&I]);
+    if (const Constant *Resolver = I.getResolver())
+      GI->setResolver(
+          MapValue(Resolver, VMap, RF_None, nullptr, &Materializer));
+  }
+
+  for (const NamedMDNode &NMD : M.named_metadata()) {
+    NamedMDNode *NewNMD = New->getOrInsertNamedMetadata(NMD.getName());
+    for (unsigned I = 0, E = NMD.getNumOperands(); I != E; ++I)
+      NewNMD->addOperand(MapMD(NMD.getOperand(I)));
+  }
+
+  // Metadata of the declarations may refer to more globals to declare.
+  for (auto Declared = Materializer.takeDeclared(); !Declared.empty();
+       Declared = Materializer.takeDeclared()) {
+    for (auto [GV, Decl] : Declared) {
+      Created.emplace_back(CG.getPosition(GV), Decl);
+      // Metadata of definitions which are not copied is dropped.
+      if (isa<GlobalVariable>(GV) || (isa<Function>(GV) && GV->isDeclaration()))
+        CopyMetadata(cast<GlobalObject>(Decl), cast<GlobalObject>(GV));
+    }
+  }
+
+  // The globals have been created in the order they were reached in, restore
+  // the order of M to keep the output stable.
+  llvm::sort(Created, less_first());
+  for (auto [Position, GV] : Created) {
+    if (auto *Var = dyn_cast<GlobalVariable>(GV)) {
+      New->removeGlobalVariable(Var);
+      New->insertGlobalVariable(Var);
+    } else {
+      auto *F = cast<Function>(GV);
+      F->removeFromParent();
+      New->getFunctionList().push_back(F);
+    }
+  }
+  return New;
+}
+
+// Produces a split module with copies of the globals in GVs.
+ModuleDesc copySubModule(const ModuleDesc &MD,
+                         const SetVector<const GlobalValue *> &GVs,
+                         EntryPointGroup &&ModuleEntryPoints,
+                         const DependencyGraph &CG) {
   ValueToValueMapTy VMap;
-  // Clone definitions only for needed globals. Others will be added as
-  // declarations and removed later.
-  std::unique_ptr<Module> SubM = CloneModule(
-      M, VMap, [&](const GlobalValue *GV) { return GVs.count(GV); });
+  std::unique_ptr<Module> SubM =
+      cloneModuleSubset(MD.getModule(), GVs, CG, VMap);
   // Replace entry points with cloned ones.
   EntryPointSet NewEPs;
   const EntryPointSet &EPs = ModuleEntryPoints.Functions;
@@ -301,30 +524,71 @@ ModuleDesc extractSubModule(const ModuleDesc &MD,
   return ModuleDesc{std::move(SubM), std::move(ModuleEntryPoints), MD.Props};
 }
 
+// Same as copySubModule, but turns the module of MD into the split module
+// instead of copying the globals. Used for the last split of a module, which
+// is not needed afterwards.
+ModuleDesc extractSubModuleInPlace(ModuleDesc &&MD,
+                                   const SetVector<const GlobalValue *> &GVs,
+                                   EntryPointGroup &&ModuleEntryPoints) {
+  std::unique_ptr<Module> M = MD.releaseModulePtr();
+  // Definitions which are not in GVs become external declarations.
+  for (Function &F : *M) {
+    if (F.isDeclaration() || GVs.count(&F))
+      continue;
+    F.deleteBody();
+    F.setComdat(nullptr);
+  }
+  for (GlobalVariable &GV : M->globals()) {
+    if (GV.isDeclaration() || GVs.count(&GV))
+      continue;
+    GV.setInitializer(nullptr);
+    GV.setLinkage(GlobalValue::ExternalLinkage);
+    GV.setComdat(nullptr);
+  }
+  for (GlobalAlias &GA : make_early_inc_range(M->aliases())) {
+    GlobalValue *Decl = declareAlias(GA, *M);
+    Decl->takeName(&GA);
+    GA.replaceAllUsesWith(Decl);
+    GA.eraseFromParent();
+  }
+  return ModuleDesc{std::move(M), std::move(ModuleEntryPoints), MD.Props};
+}
+
+ModuleDesc extractSubModule(ModuleDesc &MD,
+                            const SetVector<const GlobalValue *> &GVs,
+                            EntryPointGroup &&ModuleEntryPoints,
+                            const DependencyGraph &CG, bool ReuseInput) {
+  ModuleDesc SplitM =
+      ReuseInput
+          ? extractSubModuleInPlace(std::move(MD), GVs,
+                                    std::move(ModuleEntryPoints))
+          : copySubModule(MD, GVs, std::move(ModuleEntryPoints), CG);
+  SplitM.cleanup();
+  return SplitM;
+}
+
 // The function produces a copy of input LLVM IR module M with only those
 // functions and globals that can be called from entry points that are specified
-// in ModuleEntryPoints vector, in addition to the entry point functions.
-ModuleDesc extractCallGraph(const ModuleDesc &MD,
-                            EntryPointGroup &&ModuleEntryPoints,
-                            const DependencyGraph &CG,
+// in ModuleEntryPoints vector, in addition to the entry point functions. If
+// ReuseInput is set the module of MD is turned into the result instead.
+ModuleDesc extractCallGraph(ModuleDesc &MD, EntryPointGroup &&ModuleEntryPoints,
+                            const DependencyGraph &CG, bool ReuseInput,
                             const std::function<bool(const Function *)>
                                 &IncludeFunctionPredicate = nullptr) {
   SetVector<const GlobalValue *> GVs;
   collectFunctionsAndGlobalVariablesToExtract(
       GVs, MD.getModule(), ModuleEntryPoints, CG, IncludeFunctionPredicate);
 
-  ModuleDesc SplitM = extractSubModule(MD, GVs, std::move(ModuleEntryPoints));
-  SplitM.cleanup();
-
-  return SplitM;
+  return extractSubModule(MD, GVs, std::move(ModuleEntryPoints), CG,
+                          ReuseInput);
 }
 
 // The function is similar to 'extractCallGraph', but it produces a copy of
 // input LLVM IR module M with _all_ ESIMD functions and kernels included,
 // regardless of whether or not they are listed in ModuleEntryPoints.
-ModuleDesc extractESIMDSubModule(const ModuleDesc &MD,
+ModuleDesc extractESIMDSubModule(ModuleDesc &MD,
                                  EntryPointGroup &&ModuleEntryPoints,
-                                 const DependencyGraph &CG,
+                                 const DependencyGraph &CG, bool ReuseInput,
                                  const std::function<bool(const Function *)>
                                      &IncludeFunctionPredicate = nullptr) {
   SetVector<const GlobalValue *> GVs;
@@ -335,10 +599,8 @@ ModuleDesc extractESIMDSubModule(const ModuleDesc &MD,
   collectFunctionsAndGlobalVariablesToExtract(
       GVs, MD.getModule(), ModuleEntryPoints, CG, IncludeFunctionPredicate);
 
-  ModuleDesc SplitM = extractSubModule(MD, GVs, std::move(ModuleEntryPoints));
-  SplitM.cleanup();
-
-  return SplitM;
+  return extractSubModule(MD, GVs, std::move(ModuleEntryPoints), CG,
+                          ReuseInput);
 }
 
 class ModuleCopier : public ModuleSplitterBase {
@@ -361,12 +623,101 @@ public:
         CG(Input.getModule()) {}
 
   ModuleDesc nextSplit() override {
-    return extractCallGraph(Input, nextGroup(), CG);
+    EntryPointGroup Group = nextGroup();
+    // The input module is not needed after the last split, so it is reused.
+    return extractCallGraph(Input, std::move(Group), CG, !hasMoreSplits());
   }
 
 private:
   DependencyGraph CG;
 };
+
+// Divides the entry points of each group for the SPLIT_BY_COST mode. The
+// entry points are clustered greedily, largest first: each one is added to the
+// group it shares the most code with among the groups which stay within the
+// size budget. Groups only get entry points of the same kernel group of the
+// profile, entry points not listed in the profile form a group of their own.
+EntryPointGroupVec groupEntryPointsByCost(const Module &M,
+                                          EntryPointGroupVec &&Groups,
+                                          const CostSplitOptions &Opts) {
+  DependencyGraph CG(M);
+  // The position of the kernel group in the profile, plus one. Kernels which
+  // are listed several times belong to the first group listing them.
+  StringMap<unsigned> ProfileGroups;
+  for (size_t I = 0; I < Opts.KernelGroups.size(); ++I)
+    for (const std::string &Name : Opts.KernelGroups[I])
+      ProfileGroups.try_emplace(Name, I + 1);
+
+  // Functions reachable from an entry point and their total size.
+  struct EntryPointCode {
+    Function *EntryPoint;
+    SmallVector<std::pair<const Function *, uint64_t>, 0> Functions;
+    uint64_t Size = 0;
+  };
+  struct Cluster {
+    EntryPointSet EntryPoints;
+    DenseSet<const Function *> Functions;
+    uint64_t Size = 0;
+  };
+
+  EntryPointGroupVec Result;
+  for (EntryPointGroup &Group : Groups) {
+    std::map<unsigned, std::vector<EntryPointCode>> Partitions;
+    for (Function *F : Group.Functions) {
+      EntryPointGroup Single;
+      Single.Functions.insert(F);
+      SetVector<const GlobalValue *> GVs;
+      collectFunctionsAndGlobalVariablesToExtract(GVs, M, Single, CG);
+      EntryPointCode Code{F};
+      for (const GlobalValue *GV : GVs) {
+        const auto *Func = dyn_cast<Function>(GV);
+        if (!Func || Func->isDeclaration())
+          continue;
+        Code.Functions.emplace_back(Func, Func->getInstructionCount());
+        Code.Size += Code.Functions.back().second;
+      }
+      Partitions[ProfileGroups.lookup(F->getName())].push_back(
+          std::move(Code));
+    }
+
+    unsigned NumClusters = 0;
+    for (auto &[ProfileGroup, Codes] : Partitions) {
+      llvm::stable_sort(Codes, [](const EntryPointCode &LHS,
+                                  const EntryPointCode &RHS) {
+        return LHS.Size > RHS.Size;
+      });
+      std::vector<Cluster> Clusters;
+      for (EntryPointCode &Code : Codes) {
+        Cluster *Best = nullptr;
+        uint64_t BestShared = 0;
+        for (Cluster &C : Clusters) {
+          uint64_t Shared = 0;
+          for (auto [Func, Size] : Code.Functions)
+            if (C.Functions.contains(Func))
+              Shared += Size;
+          if (C.Size + Code.Size - Shared > Opts.SizeBudget)
+            continue;
+          if (!Best || Shared > BestShared) {
+            Best = &C;
+            BestShared = Shared;
+          }
+        }
+        if (!Best)
+          Best = &Clusters.emplace_back();
+        Best->EntryPoints.insert(Code.EntryPoint);
+        for (auto [Func, Size] : Code.Functions)
+          if (Best->Functions.insert(Func).second)
+            Best->Size += Size;
+      }
+
+      for (Cluster &C : Clusters)
+        Result.emplace_back((Group.GroupId + "." + Twine(NumClusters++)).str(),
+                            std::move(C.EntryPoints), Group.Props);
+    }
+  }
+  return Result;
+}
+
 } // namespace
 namespace llvm {
 namespace module_split {
@@ -850,7 +1201,8 @@ std::string FunctionsCategorizer::computeCategoryFor(Function *F) const {
 
 std::unique_ptr<ModuleSplitterBase>
 getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
-                      bool EmitOnlyKernelsAsEntryPoints) {
+                      bool EmitOnlyKernelsAsEntryPoints,
+                      const CostSplitOptions &CostOpts) {
   FunctionsCategorizer Categorizer;
 
   EntryPointsGroupScope Scope =
@@ -872,9 +1224,11 @@ getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
     // The most complex case, because we should account for many other features
     // like aspects used in a kernel, large-grf mode, reqd-work-group-size, etc.
 
-    // This is core of per-source device code split
-    Categorizer.registerSimpleStringAttributeRule(
-        sycl::utils::ATTR_SYCL_MODULE_ID);
+    // This is core of per-source device code split. Kernels of different
+    // sources may share a module when they are grouped by cost.
+    if (Mode != SPLIT_BY_COST)
+      Categorizer.registerSimpleStringAttributeRule(
+          sycl::utils::ATTR_SYCL_MODULE_ID);
 
     // Optional features
     // Note: Add more rules at the end of the list to avoid chaning orders of
@@ -914,6 +1268,9 @@ getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
     EntryPointGroup::Properties MDProps = MD.getEntryPointGroup().Props;
     for (auto &[Key, EntryPoints] : EntryPointsMap)
       Groups.emplace_back(Key, std::move(EntryPoints), MDProps);
+    if (Mode == SPLIT_BY_COST)
+      Groups = groupEntryPointsByCost(MD.getModule(), std::move(Groups),
+                                      CostOpts);
   }
 
   bool DoSplit = (Mode != SPLIT_NONE &&
@@ -990,11 +1347,13 @@ SmallVector<ModuleDesc, 2> splitByESIMD(ModuleDesc &&MD,
 
   DependencyGraph CG(MD.getModule());
   for (auto &Group : EntryPointGroups) {
+    // The input module is not needed after the last split, so it is reused.
+    bool ReuseInput = &Group == &EntryPointGroups.back();
     if (Group.isEsimd()) {
       // For ESIMD module, we use full call graph of all entry points and all
       // ESIMD functions.
       Result.emplace_back(
-          std::move(extractESIMDSubModule(MD, std::move(Group), CG)));
+          extractESIMDSubModule(MD, std::move(Group), CG, ReuseInput));
     } else {
       // For non-ESIMD module we only use non-ESIMD functions. Additional filter
       // is needed, because there could be uses of ESIMD functions from
@@ -1002,9 +1361,9 @@ SmallVector<ModuleDesc, 2> splitByESIMD(ModuleDesc &&MD,
       // modules are expected to be linked back together after ESIMD functions
       // were processed and therefore it is fine to return an "incomplete"
       // module here.
-      Result.emplace_back(std::move(extractCallGraph(
-          MD, std::move(Group), CG,
-          [=](const Function *F) -> bool { return !isESIMDFunction(*F); })));
+      Result.emplace_back(extractCallGraph(
+          MD, std::move(Group), CG, ReuseInput,
+          [=](const Function *F) -> bool { return !isESIMDFunction(*F); }));
     }
   }
 
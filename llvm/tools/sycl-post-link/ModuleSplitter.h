@@ -17,7 +17,9 @@
 #include "llvm/IR/Function.h"
 #include "llvm/Support/Error.h"
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace llvm {
@@ -31,9 +33,21 @@ enum IRSplitMode {
   SPLIT_PER_TU,     // one module per translation unit
   SPLIT_PER_KERNEL, // one module per kernel
   SPLIT_AUTO,       // automatically select split mode
+  SPLIT_BY_COST,    // group kernels sharing code within a size budget
   SPLIT_NONE        // no splitting
 };
 
+// Parameters of the SPLIT_BY_COST mode.
+struct CostSplitOptions {
+  // Size budget of a split module, in LLVM IR instructions. Kernels which
+  // don't fit into the budget alone get a module of their own.
+  uint64_t SizeBudget = 0;
+  // Names of the kernels used together by an application, e.g. collected by
+  // profiling it. The kernels of each group are only put into the same modules
+  // with each other.
+  std::vector<std::vector<std::string>> KernelGroups;
+};
+
 // A vector that contains all entry point functions in a split module.
 using EntryPointSet = SetVector<Function *>;
 
@@ -251,7 +265,8 @@ SmallVector<ModuleDesc, 2> splitByESIMD(ModuleDesc &&MD,
 
 std::unique_ptr<ModuleSplitterBase>
 getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
-                      bool EmitOnlyKernelsAsEntryPoints);
+                      bool EmitOnlyKernelsAsEntryPoints,
+                      const CostSplitOptions &CostOpts = {});
 
 #ifndef NDEBUG
 void dumpEntryPoints(const EntryPointSet &C, const char *msg = "", int Tab = 0);
@@ -664,3 +664,16 @@ uint32_t llvm::getSYCLDeviceLibReqMask(const Module &M) {
   }
   return ReqMask;
 }
+
+// Uses the same criteria as getSYCLDeviceLibReqMask, but doesn't filter by
+// SDLMap: a name no fallback library defines is harmless, a missing one makes
+// the runtime drop a function the module needs.
+std::vector<StringRef> llvm::getSYCLDeviceLibFuncs(const Module &M) {
+  std::vector<StringRef> Funcs;
+  if (!Triple(M.getTargetTriple()).isSPIR())
+    return Funcs;
+  for (const Function &SF : M)
+    if (SF.getName().startswith(DEVICELIB_FUNC_PREFIX) && SF.isDeclaration())
+      Funcs.push_back(SF.getName());
+  return Funcs;
+}
@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include "llvm/ADT/StringRef.h"
+
 #include <cstdint>
+#include <vector>
 
 namespace llvm {
 
@@ -40,4 +43,9 @@ enum class DeviceLibExt : std::uint32_t {
 
 uint32_t getSYCLDeviceLibReqMask(const Module &M);
 
+// Returns the names of the devicelib functions declared in M, which are
+// implemented by the fallback libraries. The SYCL runtime uses them to link
+// only the parts of the fallback libraries the module needs.
+std::vector<StringRef> getSYCLDeviceLibFuncs(const Module &M);
+
 } // namespace llvm
@@ -20,11 +20,14 @@
 #include "SpecConstants.h"
 #include "Support.h"
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/Bitcode/BitcodeWriterPass.h"
 #include "llvm/GenXIntrinsics/GenXSPIRVWriterAdaptor.h"
 #include "llvm/IR/Dominators.h"
@@ -44,11 +47,14 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/PropertySetIO.h"
 #include "llvm/Support/SimpleTable.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/SystemUtils.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
 #include "llvm/Transforms/IPO/StripDeadPrototypes.h"
@@ -168,9 +174,26 @@ cl::opt<module_split::IRSplitMode> SplitMode(
                clEnumValN(module_split::SPLIT_PER_KERNEL, "kernel",
                           "1 output module per kernel"),
                clEnumValN(module_split::SPLIT_AUTO, "auto",
-                          "Choose split mode automatically")),
+                          "Choose split mode automatically"),
+               clEnumValN(module_split::SPLIT_BY_COST, "cost",
+                          "Group kernels sharing code into modules within a "
+                          "size budget")),
     cl::cat(PostLinkCat));
 
+cl::opt<unsigned> SplitSizeBudget{
+    "split-size-budget",
+    cl::desc("Size budget of a module produced by -split=cost, in LLVM IR "
+             "instructions"),
+    cl::init(100000), cl::cat(PostLinkCat)};
+
+cl::opt<std::string> SplitProfile{
+    "split-profile",
+    cl::desc("File listing groups of kernels used together for -split=cost. "
+             "Each line lists the names of the kernels of a group separated "
+             "by whitespace, lines starting with '#' are ignored. Kernels of "
+             "a group are only put into the same modules with each other"),
+    cl::value_desc("filename"), cl::cat(PostLinkCat)};
+
 cl::opt<bool> DoSymGen{"symbols", cl::desc("generate exported symbol files"),
                        cl::cat(PostLinkCat)};
 
@@ -220,6 +243,13 @@ cl::opt<bool> GenerateDeviceImageWithDefaultSpecConsts{
              "replaced with default values from specialization id(s)."),
     cl::cat(PostLinkCat)};
 
+cl::opt<unsigned> NumThreads{
+    "threads",
+    cl::desc("Number of threads processing the modules produced by device code "
+             "split, 0 uses all available hardware threads. Every thread keeps "
+             "a split module in memory, so memory use grows with it"),
+    cl::init(1), cl::cat(PostLinkCat)};
+
 struct GlobalBinImageProps {
   bool EmitKernelParamInfo;
   bool EmitProgramMetadata;
@@ -376,6 +406,13 @@ std::string saveModuleProperties(module_split::ModuleDesc &MD,
     std::map<StringRef, uint32_t> RMEntry = {{"DeviceLibReqMask", MRMask}};
     PropSet.add(PropSetRegTy::SYCL_DEVICELIB_REQ_MASK, RMEntry);
   }
+  {
+    std::map<StringRef, uint32_t> Funcs;
+    for (StringRef Name : getSYCLDeviceLibFuncs(M))
+      Funcs[Name] = 1;
+    if (!Funcs.empty())
+      PropSet.add(PropSetRegTy::SYCL_DEVICELIB_FUNCS, Funcs);
+  }
   {
     std::map<StringRef, llvm::util::PropertyValue> Requirements;
     getSYCLDeviceRequirements(MD, Requirements);
@@ -927,6 +964,165 @@ handleESIMD(module_split::ModuleDesc &&MDesc, bool &Modified,
   return Result;
 }
 
+// Modules produced from one module of the device code split.
+struct ProcessedSplit {
+  // Owns the modules below if they have been processed in their own context.
+  // Must be destroyed after them.
+  std::unique_ptr<LLVMContext> Context;
+  SmallVector<module_split::ModuleDesc, 2> MMs;
+  SmallVector<module_split::ModuleDesc, 2> MMsWithDefaultSpecConsts;
+
+  // Number of IDs used in the output file names of this split.
+  int getNumIDs() const { return MMsWithDefaultSpecConsts.empty() ? 1 : 2; }
+};
+
+ProcessedSplit processSplit(module_split::ModuleDesc &&MDesc, bool &Modified,
+                            bool &SplitOccurred) {
+  ProcessedSplit Res;
+  MDesc.fixupLinkageOfDirectInvokeSimdTargets();
+
+  Res.MMs = handleESIMD(std::move(MDesc), Modified, SplitOccurred);
+  assert(Res.MMs.size() && "at least one module is expected after ESIMD split");
+
+  for (size_t I = 0; I != Res.MMs.size(); ++I) {
+    if (GenerateDeviceImageWithDefaultSpecConsts) {
+      std::optional<module_split::ModuleDesc> NewMD =
+          processSpecConstantsWithDefaultValues(Res.MMs[I]);
+      if (NewMD)
+        Res.MMsWithDefaultSpecConsts.push_back(std::move(*NewMD));
+    }
+
+    Modified |= processSpecConstants(Res.MMs[I]);
+  }
+  return Res;
+}
+
+// Saves the modules of the split, \p ID is the first ID the split uses in the
+// output file names. Returns the rows of the file table.
+SmallVector<IrPropSymFilenameTriple, 2>
+saveSplit(ProcessedSplit &Split, int ID, StringRef OutIRFileName) {
+  SmallVector<IrPropSymFilenameTriple, 2> Rows;
+  for (module_split::ModuleDesc &IrMD : Split.MMs)
+    Rows.push_back(saveModule(IrMD, ID, OutIRFileName));
+  for (module_split::ModuleDesc &IrMD : Split.MMsWithDefaultSpecConsts)
+    Rows.push_back(saveModule(IrMD, ID + 1, OutIRFileName));
+  return Rows;
+}
+
+// A module of the device code split serialized to bitcode. All the modules
+// produced by the splitter share the context of the input module, which must
+// not be used by several threads at a time. Each split is thus moved to a
+// context of its own to be processed on a worker thread.
+struct SerializedSplit {
+  SmallVector<char, 0> Bitcode;
+  std::string Name;
+  std::string GroupId;
+  module_split::EntryPointGroup::Properties GroupProps;
+  module_split::ModuleDesc::Properties Props;
+  string_vector EntryPointNames;
+
+  explicit SerializedSplit(module_split::ModuleDesc &&MD)
+      : Name(MD.Name), GroupId(MD.getEntryPointGroup().GroupId),
+        GroupProps(MD.getEntryPointGroup().Props), Props(MD.Props) {
+    MD.saveEntryPointNames(EntryPointNames);
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(MD.getModule(), OS);
+  }
+
+  module_split::ModuleDesc deserialize(LLVMContext &Ctx) const {
+    Expected<std::unique_ptr<Module>> ME = parseBitcodeFile(
+        MemoryBufferRef(StringRef(Bitcode.data(), Bitcode.size()), Name), Ctx);
+    CHECK_AND_EXIT(ME.takeError());
+    module_split::ModuleDesc MD{std::move(*ME),
+                                module_split::EntryPointGroup{GroupId, {},
+                                                              GroupProps},
+                                Props};
+    MD.Name = Name;
+    MD.rebuildEntryPoints(EntryPointNames);
+    return MD;
+  }
+};
+
+// Processes the remaining modules of the device code split on \p MaxThreads
+// threads and adds them to \p Table in the order they are produced by the
+// splitter. Only as many splits as there are threads are kept in memory at the
+// same time.
+void processSplitsConcurrently(
+    module_split::ModuleSplitterBase &Splitter, unsigned MaxThreads,
+    util::SimpleTable &Table, bool &Modified, bool &SplitOccurred,
+    function_ref<std::string()> GetOutIRFileName) {
+  ThreadPool Pool(heavyweight_hardware_concurrency(MaxThreads));
+  int ID = 0;
+
+  struct Task {
+    SerializedSplit Input;
+    ProcessedSplit Output;
+    bool Modified = false;
+    bool SplitOccurred = false;
+    int ID = 0;
+    SmallVector<IrPropSymFilenameTriple, 2> Rows;
+  };
+
+  while (Splitter.hasMoreSplits()) {
+    std::vector<std::unique_ptr<Task>> Tasks;
+    while (Tasks.size() < MaxThreads && Splitter.hasMoreSplits()) {
+      module_split::ModuleDesc MDesc = Splitter.nextSplit();
+      DUMP_ENTRY_POINTS(MDesc.entries(), MDesc.Name.c_str(), 1);
+      Tasks.emplace_back(new Task{SerializedSplit{std::move(MDesc)}});
+    }
+
+    for (std::unique_ptr<Task> &T : Tasks) {
+      T->SplitOccurred = SplitOccurred;
+      Pool.async([&Job = *T] {
+        auto Ctx = std::make_unique<LLVMContext>();
+        module_split::ModuleDesc MDesc = Job.Input.deserialize(*Ctx);
+        Job.Input.Bitcode = SmallVector<char, 0>{};
+        Job.Output =
+            processSplit(std::move(MDesc), Job.Modified, Job.SplitOccurred);
+        Job.Output.Context = std::move(Ctx);
+      });
+    }
+    Pool.wait();
+
+    // Output file names are numbered in the order of the splits, regardless of
+    // the order the threads finish in.
+    for (std::unique_ptr<Task> &T : Tasks) {
+      Modified |= T->Modified;
+      SplitOccurred |= T->SplitOccurred;
+      T->ID = ID;
+      ID += T->Output.getNumIDs();
+    }
+    std::string OutIRFileName = GetOutIRFileName();
+    for (std::unique_ptr<Task> &T : Tasks)
+      Pool.async([&Job = *T, &OutIRFileName] {
+        Job.Rows = saveSplit(Job.Output, Job.ID, OutIRFileName);
+      });
+    Pool.wait();
+
+    for (std::unique_ptr<Task> &T : Tasks)
+      for (const IrPropSymFilenameTriple &Row : T->Rows)
+        addTableRow(Table, Row);
+  }
+}
+
+module_split::CostSplitOptions getCostSplitOptions() {
+  module_split::CostSplitOptions Opts;
+  Opts.SizeBudget = SplitSizeBudget;
+  if (SplitProfile.empty())
+    return Opts;
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
+      MemoryBuffer::getFile(SplitProfile);
+  checkError(MB.getError(), "error reading file '" + SplitProfile + "'");
+  for (line_iterator LI(**MB, /*SkipBlanks=*/true, '#'); !LI.is_at_eof();
+       ++LI) {
+    SmallVector<StringRef, 8> Names;
+    SplitString(*LI, Names);
+    Opts.KernelGroups.emplace_back(Names.begin(), Names.end());
+  }
+  return Opts;
+}
+
 std::unique_ptr<util::SimpleTable>
 processInputModule(std::unique_ptr<Module> M) {
   // Construct the resulting table which will accumulate all the outputs.
@@ -992,7 +1188,7 @@ processInputModule(std::unique_ptr<Module> M) {
   std::unique_ptr<module_split::ModuleSplitterBase> Splitter =
       module_split::getDeviceCodeSplitter(
           module_split::ModuleDesc{std::move(M)}, SplitMode, IROutputOnly,
-          EmitOnlyKernelsAsEntryPoints);
+          EmitOnlyKernelsAsEntryPoints, getCostSplitOptions());
   bool SplitOccurred = Splitter->remainingSplits() > 1;
   Modified |= SplitOccurred;
 
@@ -1000,6 +1196,25 @@ processInputModule(std::unique_ptr<Module> M) {
   if (DeviceGlobals)
     Splitter->verifyNoCrossModuleDeviceGlobalUsage();
 
+  // Empty IR file name directs saveModule to generate one and save IR to it.
+  auto GetOutIRFileName = [&]() -> std::string {
+    if (!Modified && (OutputFilename.getNumOccurrences() == 0)) {
+      assert(!SplitOccurred);
+      errs() << "sycl-post-link NOTE: no modifications to the input LLVM IR "
+                "have been made\n";
+      return InputFilename; // ... non-empty means "skip IR writing"
+    }
+    return "";
+  };
+
+  unsigned MaxThreads =
+      heavyweight_hardware_concurrency(NumThreads).compute_thread_count();
+  if (!IROutputOnly && MaxThreads > 1 && Splitter->remainingSplits() > 1) {
+    processSplitsConcurrently(*Splitter, MaxThreads, *Table, Modified,
+                              SplitOccurred, GetOutIRFileName);
+    return Table;
+  }
+
   // It is important that we *DO NOT* preserve all the splits in memory at the
   // same time, because it leads to a huge RAM consumption by the tool on bigger
   // inputs.
@@ -1007,58 +1222,22 @@ processInputModule(std::unique_ptr<Module> M) {
     module_split::ModuleDesc MDesc = Splitter->nextSplit();
     DUMP_ENTRY_POINTS(MDesc.entries(), MDesc.Name.c_str(), 1);
 
-    MDesc.fixupLinkageOfDirectInvokeSimdTargets();
-
-    SmallVector<module_split::ModuleDesc, 2> MMs =
-        handleESIMD(std::move(MDesc), Modified, SplitOccurred);
-    assert(MMs.size() && "at least one module is expected after ESIMD split");
-
-    SmallVector<module_split::ModuleDesc, 2> MMsWithDefaultSpecConsts;
-    for (size_t I = 0; I != MMs.size(); ++I) {
-      if (GenerateDeviceImageWithDefaultSpecConsts) {
-        std::optional<module_split::ModuleDesc> NewMD =
-            processSpecConstantsWithDefaultValues(MMs[I]);
-        if (NewMD)
-          MMsWithDefaultSpecConsts.push_back(std::move(*NewMD));
-      }
-
-      Modified |= processSpecConstants(MMs[I]);
-    }
+    ProcessedSplit Split =
+        processSplit(std::move(MDesc), Modified, SplitOccurred);
 
     if (IROutputOnly) {
       if (SplitOccurred) {
         error("some modules had to be split, '-" + IROutputOnly.ArgStr +
               "' can't be used");
       }
-      saveModuleIR(MMs.front().getModule(), OutputFilename);
+      saveModuleIR(Split.MMs.front().getModule(), OutputFilename);
       return Table;
     }
-    // Empty IR file name directs saveModule to generate one and save IR to
-    // it:
-    std::string OutIRFileName = "";
 
-    if (!Modified && (OutputFilename.getNumOccurrences() == 0)) {
-      assert(!SplitOccurred);
-      OutIRFileName = InputFilename; // ... non-empty means "skip IR writing"
-      errs() << "sycl-post-link NOTE: no modifications to the input LLVM IR "
-                "have been made\n";
-    }
-    for (module_split::ModuleDesc &IrMD : MMs) {
-      IrPropSymFilenameTriple T = saveModule(IrMD, ID, OutIRFileName);
+    std::string OutIRFileName = GetOutIRFileName();
+    for (const IrPropSymFilenameTriple &T : saveSplit(Split, ID, OutIRFileName))
       addTableRow(*Table, T);
-    }
-
-    ++ID;
-
-    if (!MMsWithDefaultSpecConsts.empty()) {
-      for (size_t i = 0; i != MMsWithDefaultSpecConsts.size(); ++i) {
-        module_split::ModuleDesc &IrMD = MMsWithDefaultSpecConsts[i];
-        IrPropSymFilenameTriple T = saveModule(IrMD, ID, OutIRFileName);
-        addTableRow(*Table, T);
-      }
-
-      ++ID;
-    }
+    ID += Split.getNumIDs();
   }
   return Table;
 }
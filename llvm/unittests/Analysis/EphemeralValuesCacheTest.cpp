@@ -0,0 +1,71 @@
+//===- EphemeralValuesCacheTest.cpp - EphemeralValuesCache unit tests -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/EphemeralValuesCache.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+std::unique_ptr<Module> parseIR(LLVMContext &C, const char *IR) {
+  SMDiagnostic Err;
+  std::unique_ptr<Module> Mod = parseAssemblyString(IR, Err, C);
+  if (!Mod)
+    Err.print("EphemeralValuesCacheTest", errs());
+  return Mod;
+}
+
+TEST(EphemeralValuesCacheTest, Basic) {
+  LLVMContext C;
+  std::unique_ptr<Module> M = parseIR(C, R"IR(
+declare void @llvm.assume(i1)
+
+define void @foo(i8 %arg0, i8 %arg1) {
+  %c0 = icmp eq i8 %arg0, 0
+  call void @llvm.assume(i1 %c0)
+  call void @foo(i8 %arg0, i8 %arg1)
+  %c1 = icmp eq i8 %arg1, 0
+  call void @llvm.assume(i1 %c1)
+  ret void
+}
+)IR");
+  Function *F = M->getFunction("foo");
+  auto *BB = &*F->begin();
+  AssumptionCache AC(*F);
+  EphemeralValuesCache EVC(*F, AC);
+  auto It = BB->begin();
+  auto *C0 = &*It++;
+  auto *Assume0 = &*It++;
+  [[maybe_unused]] auto *NotEph = &*It++;
+  auto *C1 = &*It++;
+  auto *Assume1 = &*It++;
+  [[maybe_unused]] auto *Ret = &*It++;
+
+  // Check the ephemeral values.
+  EXPECT_EQ(EVC.ephValues().size(), 4u);
+  EXPECT_TRUE(EVC.ephValues().contains(C0));
+  EXPECT_TRUE(EVC.ephValues().contains(Assume0));
+  EXPECT_TRUE(EVC.ephValues().contains(C1));
+  EXPECT_TRUE(EVC.ephValues().contains(Assume1));
+
+  // Clearing the cache makes the next query collect the values again.
+  Assume1->eraseFromParent();
+  C1->eraseFromParent();
+  EVC.clear();
+  EXPECT_EQ(EVC.ephValues().size(), 2u);
+  EXPECT_TRUE(EVC.ephValues().contains(C0));
+  EXPECT_TRUE(EVC.ephValues().contains(Assume0));
+}
+
+} // namespace
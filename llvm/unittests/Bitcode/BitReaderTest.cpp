@@ -10,6 +10,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
@@ -18,6 +19,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -434,4 +436,63 @@ TEST(BitReaderTest, AccessMetadataTypeInfo) {
             "!{0, i32}}}}");
 }
 
+// Tests that with -ondemand-mds-loading-for-lazy-modules, materializing a
+// function of a module read with lazy metadata loading only loads the
+// module-level metadata the function references.
+TEST(BitReaderTest, MaterializeMetadataOnDemand) {
+  std::string Assembly = "define void @f() {\n"
+                         "  ret void, !foo !0\n"
+                         "}\n"
+                         "define void @g() {\n"
+                         "  ret void, !foo !1\n"
+                         "}\n"
+                         "define void @h() {\n"
+                         "  call void @f(), !foo !0\n"
+                         "  ret void, !foo !1\n"
+                         "}\n"
+                         "!0 = !{!\"used\"}\n"
+                         "!1 = !{!\"unrelated\"}\n";
+  // Metadata used by a single function is written in its function block,
+  // hence @h. The index needed to load metadata on demand is only written for
+  // modules with enough metadata.
+  std::string Named = "!named = !{";
+  for (unsigned I = 2; I < 34; ++I) {
+    Assembly += "!" + utostr(I) + " = !{i32 " + utostr(I) + "}\n";
+    Named += (I == 2 ? "!" : ", !") + utostr(I);
+  }
+  Assembly += Named + "}\n";
+
+  // Parse in another context, so that the nodes checked below only exist in
+  // Context if they were loaded from the bitcode.
+  SmallString<1024> Mem;
+  {
+    LLVMContext WriteContext;
+    writeModuleToBuffer(parseAssembly(WriteContext, Assembly.c_str()), Mem);
+  }
+
+  auto *OnDemand = static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions().lookup(
+          "ondemand-mds-loading-for-lazy-modules"));
+  ASSERT_NE(OnDemand, nullptr);
+  OnDemand->setValue(true);
+  LLVMContext Context;
+  Expected<std::unique_ptr<Module>> ModuleOrErr =
+      getLazyBitcodeModule(MemoryBufferRef(Mem.str(), "test"), Context,
+                           /*ShouldLazyLoadMetadata=*/true);
+  OnDemand->setValue(false);
+  if (!ModuleOrErr)
+    report_fatal_error("Could not parse bitcode module");
+  std::unique_ptr<Module> M = std::move(ModuleOrErr.get());
+
+  auto IsLoaded = [&](StringRef Str) {
+    return MDTuple::getIfExists(Context, {MDString::get(Context, Str)});
+  };
+  ASSERT_FALSE(M->getFunction("f")->materialize());
+  EXPECT_TRUE(IsLoaded("used"));
+  EXPECT_FALSE(IsLoaded("unrelated"));
+
+  ASSERT_FALSE(M->getFunction("g")->materialize());
+  EXPECT_TRUE(IsLoaded("unrelated"));
+}
+
 } // end namespace
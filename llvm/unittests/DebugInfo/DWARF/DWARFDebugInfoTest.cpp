@@ -2193,4 +2193,124 @@ TEST(DWARFDebugInfo, TestDWARF64UnitLength) {
   });
 }
 
+TEST(DWARFDebugInfo, TestExtractNormalUnitsInParallel) {
+  // Units 1 and 3 have an invalid DW_AT_str_offsets_base, for which the
+  // extraction reports different errors.
+  const char *yamldata = R"(
+    debug_abbrev:
+      - Table:
+          - Code:            0x00000001
+            Tag:             DW_TAG_compile_unit
+            Children:        DW_CHILDREN_yes
+            Attributes:
+              - Attribute:       DW_AT_language
+                Form:            DW_FORM_data2
+          - Code:            0x00000002
+            Tag:             DW_TAG_compile_unit
+            Children:        DW_CHILDREN_yes
+            Attributes:
+              - Attribute:       DW_AT_str_offsets_base
+                Form:            DW_FORM_sec_offset
+          - Code:            0x00000003
+            Tag:             DW_TAG_variable
+            Children:        DW_CHILDREN_no
+            Attributes:
+              - Attribute:       DW_AT_decl_line
+                Form:            DW_FORM_data1
+    debug_info:
+      - Version:         5
+        UnitType:        DW_UT_compile
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000003
+            Values:
+              - Value:           0x0000000000000001
+          - AbbrCode:        0x00000003
+            Values:
+              - Value:           0x0000000000000002
+          - AbbrCode:        0x00000000
+      - Version:         5
+        UnitType:        DW_UT_compile
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x0000000000000004
+          - AbbrCode:        0x00000003
+            Values:
+              - Value:           0x0000000000000003
+          - AbbrCode:        0x00000000
+      - Version:         5
+        UnitType:        DW_UT_compile
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+              - Value:           0x0000000000000002
+          - AbbrCode:        0x00000003
+            Values:
+              - Value:           0x0000000000000004
+          - AbbrCode:        0x00000000
+      - Version:         5
+        UnitType:        DW_UT_compile
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000002
+            Values:
+              - Value:           0x0000000000000100
+          - AbbrCode:        0x00000003
+            Values:
+              - Value:           0x0000000000000005
+          - AbbrCode:        0x00000000
+  )";
+  Expected<StringMap<std::unique_ptr<MemoryBuffer>>> Sections =
+      DWARFYAML::emitDebugSections(StringRef(yamldata));
+  ASSERT_THAT_EXPECTED(Sections, Succeeded());
+
+  std::vector<std::string> SerialErrors;
+  std::unique_ptr<DWARFContext> Serial = DWARFContext::create(
+      *Sections, 8, /*isLittleEndian=*/true, [&](Error E) {
+        SerialErrors.push_back(toString(std::move(E)));
+      });
+  for (const std::unique_ptr<DWARFUnit> &U : Serial->getNormalUnitsVector())
+    if (Error E = U->tryExtractDIEsIfNeeded(/*CUDieOnly=*/false))
+      SerialErrors.push_back(toString(std::move(E)));
+
+  std::vector<std::string> ParallelErrors;
+  std::unique_ptr<DWARFContext> Parallel = DWARFContext::create(
+      *Sections, 8, /*isLittleEndian=*/true, [&](Error E) {
+        ParallelErrors.push_back(toString(std::move(E)));
+      });
+  Parallel->extractNormalUnitsInParallel(/*NumThreads=*/4);
+
+  // The errors are reported in the order of the units.
+  ASSERT_EQ(ParallelErrors.size(), 2u);
+  EXPECT_THAT(ParallelErrors[0], HasSubstr("insufficient space"));
+  EXPECT_THAT(ParallelErrors[1], HasSubstr("exceeds section size"));
+  EXPECT_EQ(SerialErrors, ParallelErrors);
+
+  const DWARFUnitVector &SerialUnits = Serial->getNormalUnitsVector();
+  const DWARFUnitVector &ParallelUnits = Parallel->getNormalUnitsVector();
+  ASSERT_EQ(ParallelUnits.size(), 4u);
+  ASSERT_EQ(SerialUnits.size(), ParallelUnits.size());
+  for (size_t I = 0; I < ParallelUnits.size(); ++I) {
+    DWARFUnit &SerialUnit = *SerialUnits[I];
+    DWARFUnit &ParallelUnit = *ParallelUnits[I];
+    // The unit DIE, the variables and the terminating null entry.
+    EXPECT_GT(ParallelUnit.getNumDIEs(), 2u);
+    ASSERT_EQ(SerialUnit.getNumDIEs(), ParallelUnit.getNumDIEs());
+    for (unsigned J = 0; J < ParallelUnit.getNumDIEs(); ++J) {
+      DWARFDie SerialDie = SerialUnit.getDIEAtIndex(J);
+      DWARFDie ParallelDie = ParallelUnit.getDIEAtIndex(J);
+      EXPECT_EQ(SerialDie.getOffset(), ParallelDie.getOffset());
+      EXPECT_EQ(SerialDie.getTag(), ParallelDie.getTag());
+      EXPECT_EQ(toUnsigned(SerialDie.find(DW_AT_decl_line)),
+                toUnsigned(ParallelDie.find(DW_AT_decl_line)));
+    }
+  }
+}
+
 } // end anonymous namespace
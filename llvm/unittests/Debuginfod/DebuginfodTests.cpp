@@ -7,11 +7,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Debuginfod/Debuginfod.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Debuginfod/HTTPClient.h"
+#include "llvm/Debuginfod/HTTPServer.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
+#include <atomic>
 
 #ifdef _WIN32
 #define setenv(name, var, ignore) _putenv_s(name, var)
@@ -67,3 +72,50 @@ TEST(DebuginfodClient, CacheMiss) {
   // A cache miss with no possible URLs should not create the cache directory.
   EXPECT_FALSE(sys::fs::exists(CacheDir));
 }
+
+#if defined(LLVM_ENABLE_HTTPLIB) && defined(LLVM_ENABLE_CURL)
+
+// Looks up an artifact from a server which answers with \p Code and returns
+// how many requests the server received for it after two lookups.
+static unsigned countRequestsForMissingArtifact(unsigned Code,
+                                                StringRef UniqueKey) {
+  std::atomic<unsigned> NumRequests{0};
+  HTTPServer Server;
+  EXPECT_THAT_ERROR(Server.get(R"(/(.*))",
+                               [&](HTTPServerRequest &Request) {
+                                 ++NumRequests;
+                                 Request.setResponse({Code, "text/plain", ""});
+                               }),
+                    Succeeded());
+  Expected<unsigned> PortOrErr = Server.bind();
+  EXPECT_THAT_EXPECTED(PortOrErr, Succeeded());
+  ThreadPool Pool(hardware_concurrency(1));
+  Pool.async([&]() { EXPECT_THAT_ERROR(Server.listen(), Succeeded()); });
+
+  SmallString<32> CacheDir;
+  EXPECT_FALSE(
+      sys::fs::createUniqueDirectory("debuginfod-unittest", CacheDir));
+  std::string Url = "http://localhost:" + utostr(*PortOrErr);
+  HTTPClient::initialize();
+  for (int I = 0; I < 2; ++I)
+    EXPECT_THAT_EXPECTED(
+        getCachedOrDownloadArtifact(UniqueKey, "/null", CacheDir, {Url},
+                                    std::chrono::milliseconds(10000)),
+        Failed<StringError>());
+  HTTPClient::cleanup();
+  Server.stop();
+  return NumRequests;
+}
+
+// Check that artifacts the servers don't have are not requested again.
+TEST(DebuginfodClient, NotFoundIsRemembered) {
+  EXPECT_EQ(1u, countRequestsForMissingArtifact(404, "not-found-key"));
+}
+
+// Check that failures which may be transient are not remembered.
+TEST(DebuginfodClient, ServerErrorIsNotRemembered) {
+  EXPECT_EQ(2u, countRequestsForMissingArtifact(500, "server-error-key"));
+  EXPECT_EQ(2u, countRequestsForMissingArtifact(429, "rate-limited-key"));
+}
+
+#endif
@@ -0,0 +1,78 @@
+//===------- FileObjectCacheTest.cpp - Unit tests for FileObjectCache -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OrcTestCommon.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class InMemoryStore : public CacheStore {
+public:
+  Expected<std::unique_ptr<MemoryBuffer>> get(StringRef Key) override {
+    auto I = Entries.find(Key);
+    if (I == Entries.end())
+      return nullptr;
+    return MemoryBuffer::getMemBufferCopy(I->second);
+  }
+
+  Error put(StringRef Key, MemoryBufferRef Contents) override {
+    Entries[Key] = Contents.getBuffer().str();
+    return Error::success();
+  }
+
+  StringMap<std::string> Entries;
+};
+
+static std::unique_ptr<Module> createModule(LLVMContext &Context,
+                                            StringRef Value) {
+  auto M = std::make_unique<Module>("", Context);
+  M->setTargetTriple("x86_64-unknown-linux-gnu");
+  Constant *StrConstant = ConstantDataArray::getString(Context, Value);
+  new GlobalVariable(*M, StrConstant->getType(), true,
+                     GlobalValue::ExternalLinkage, StrConstant, "foo");
+  return M;
+}
+
+TEST(FileObjectCacheTest, ReusesObjectsOfIdenticalModules) {
+  LLVMContext Context;
+  auto M = createModule(Context, "forty-two");
+
+  OrcNativeTarget::initialize();
+  std::unique_ptr<TargetMachine> TM(EngineBuilder().selectTarget(
+      Triple(M->getTargetTriple()), "", "", SmallVector<std::string, 1>()));
+  if (!TM)
+    GTEST_SKIP();
+
+  auto Store = std::make_shared<InMemoryStore>();
+  auto Obj = cantFail(
+      SimpleCompiler(*TM, FileObjectCache::Create(Store, *TM).get())(*M));
+  EXPECT_EQ(Store->Entries.size(), 1u);
+
+  // A new cache sharing the store finds the object of an identical module.
+  auto Cache = FileObjectCache::Create(Store, *TM);
+  auto SameM = createModule(Context, "forty-two");
+  auto CachedObj = Cache->getObject(SameM.get());
+  ASSERT_TRUE(CachedObj);
+  EXPECT_EQ(CachedObj->getBuffer(), Obj->getBuffer());
+
+  auto OtherM = createModule(Context, "forty-three");
+  EXPECT_FALSE(Cache->getObject(OtherM.get()));
+  cantFail(SimpleCompiler(*TM, Cache.get())(*OtherM));
+  EXPECT_EQ(Store->Entries.size(), 2u);
+}
+
+} // namespace
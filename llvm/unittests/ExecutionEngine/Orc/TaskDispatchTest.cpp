@@ -32,4 +32,20 @@ TEST(DynamicThreadPoolDispatchTest, GenericNamedTask) {
   EXPECT_TRUE(F.get());
   D->shutdown();
 }
+
+TEST(DynamicThreadPoolDispatchTest, GenericTasksAreNotLimited) {
+  // Only materialization tasks are limited, so the first task can wait on the
+  // second one here.
+  auto D = std::make_unique<DynamicThreadPoolTaskDispatcher>(1);
+  std::promise<void> First, Second;
+  auto FirstDone = First.get_future();
+  auto SecondDone = Second.get_future().share();
+  D->dispatch(makeGenericNamedTask([&, SecondDone]() {
+    SecondDone.wait();
+    First.set_value();
+  }));
+  D->dispatch(makeGenericNamedTask([&]() { Second.set_value(); }));
+  FirstDone.wait();
+  D->shutdown();
+}
 #endif
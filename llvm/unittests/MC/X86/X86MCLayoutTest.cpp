@@ -0,0 +1,176 @@
+//===- X86MCLayoutTest.cpp - Tests for relaxation across sections ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// Each section ends with a jump over a fill as large as the jump at the start
+// of the next section, plus 123 bytes. The jump in .text.c is always relaxed,
+// which makes the others need relaxing in turn, from the last section to the
+// first one.
+constexpr char SectionA[] = R"(
+  .section .text.a,"ax",@progbits
+a_start:
+  jmp a_end
+  .space 123
+  .space b_jmp_end - b_start
+a_end:
+  ret
+)";
+
+constexpr char SectionB[] = R"(
+  .section .text.b,"ax",@progbits
+b_start:
+  jmp b_end
+b_jmp_end:
+  .space 123
+  .space c_jmp_end - c_start
+b_end:
+  ret
+)";
+
+constexpr char SectionC[] = R"(
+  .section .text.c,"ax",@progbits
+c_start:
+  jmp c_end
+c_jmp_end:
+  .space 200
+c_end:
+  ret
+)";
+
+class X86MCLayoutTest : public ::testing::Test {
+protected:
+  static void SetUpTestCase() {
+    LLVMInitializeX86TargetInfo();
+    LLVMInitializeX86TargetMC();
+    LLVMInitializeX86AsmParser();
+  }
+
+  X86MCLayoutTest() {
+    std::string Error;
+    TheTarget = TargetRegistry::lookupTarget(TripleName, Error);
+    if (!TheTarget)
+      return;
+    MRI.reset(TheTarget->createMCRegInfo(TripleName));
+    MAI.reset(TheTarget->createMCAsmInfo(*MRI, TripleName, MCOptions));
+    MII.reset(TheTarget->createMCInstrInfo());
+    STI.reset(TheTarget->createMCSubtargetInfo(TripleName, "", ""));
+  }
+
+  /// Assembles \p Asm to an ELF object and returns the offsets of its symbols
+  /// within their sections.
+  StringMap<uint64_t> assemble(StringRef Asm) {
+    SourceMgr SrcMgr;
+    SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm), SMLoc());
+    MCContext Ctx(Triple(TripleName), MAI.get(), MRI.get(), STI.get(),
+                  &SrcMgr, &MCOptions);
+    std::unique_ptr<MCObjectFileInfo> MOFI(
+        TheTarget->createMCObjectFileInfo(Ctx, /*PIC=*/false));
+    Ctx.setObjectFileInfo(MOFI.get());
+
+    SmallString<0> Object;
+    raw_svector_ostream OS(Object);
+    MCAsmBackend *MAB = TheTarget->createMCAsmBackend(*STI, *MRI, MCOptions);
+    std::unique_ptr<MCStreamer> Str(TheTarget->createMCObjectStreamer(
+        Triple(TripleName), Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+        MAB->createObjectWriter(OS),
+        std::unique_ptr<MCCodeEmitter>(
+            TheTarget->createMCCodeEmitter(*MII, Ctx)),
+        *STI, /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+        /*DWARFMustBeAtTheEnd=*/false));
+    std::unique_ptr<MCAsmParser> Parser(
+        createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+    std::unique_ptr<MCTargetAsmParser> TargetParser(
+        TheTarget->createMCAsmParser(*STI, *Parser, *MII, MCOptions));
+    Parser->setTargetParser(*TargetParser);
+    EXPECT_FALSE(Parser->Run(/*NoInitialTextSection=*/false));
+    EXPECT_FALSE(Ctx.hadError());
+
+    StringMap<uint64_t> Offsets;
+    std::unique_ptr<object::ObjectFile> Obj = cantFail(
+        object::ObjectFile::createObjectFile(MemoryBufferRef(Object, "")));
+    for (const object::SymbolRef &Sym : Obj->symbols()) {
+      StringRef Name = cantFail(Sym.getName());
+      if (!Name.empty())
+        Offsets[Name] = cantFail(Sym.getValue());
+    }
+    return Offsets;
+  }
+
+  const char *TripleName = "x86_64-unknown-linux";
+  const Target *TheTarget = nullptr;
+  const MCTargetOptions MCOptions;
+  std::unique_ptr<MCRegisterInfo> MRI;
+  std::unique_ptr<MCAsmInfo> MAI;
+  std::unique_ptr<const MCInstrInfo> MII;
+  std::unique_ptr<MCSubtargetInfo> STI;
+};
+
+TEST_F(X86MCLayoutTest, RelaxesAcrossSections) {
+  if (!TheTarget)
+    GTEST_SKIP();
+
+  // The sections are visited in order, so relaxing .text.c makes the layout
+  // of .text.b change, and then the one of .text.a.
+  StringMap<uint64_t> Forward =
+      assemble((Twine(SectionA) + SectionB + SectionC).str());
+  // All jumps are relaxed to 5 bytes.
+  EXPECT_EQ(Forward.lookup("b_jmp_end"), 5u);
+  EXPECT_EQ(Forward.lookup("c_jmp_end"), 5u);
+  EXPECT_EQ(Forward.lookup("a_end"), 133u);
+  EXPECT_EQ(Forward.lookup("b_end"), 133u);
+  EXPECT_EQ(Forward.lookup("c_end"), 205u);
+
+  // The layout doesn't depend on the order the sections are relaxed in.
+  StringMap<uint64_t> Backward =
+      assemble((Twine(SectionC) + SectionB + SectionA).str());
+  ASSERT_EQ(Forward.size(), Backward.size());
+  for (const auto &Sym : Forward)
+    EXPECT_EQ(Sym.getValue(), Backward.lookup(Sym.getKey())) << Sym.getKey();
+}
+
+TEST_F(X86MCLayoutTest, KeepsShortJumpsAcrossSections) {
+  if (!TheTarget)
+    GTEST_SKIP();
+
+  // With a short jump in .text.c, the others don't need relaxing either.
+  std::string ShortC = StringRef(SectionC).str();
+  ShortC.replace(ShortC.find(".space 200"), 10, ".space 100");
+  StringMap<uint64_t> Offsets =
+      assemble((Twine(SectionA) + SectionB + ShortC).str());
+  EXPECT_EQ(Offsets.lookup("b_jmp_end"), 2u);
+  EXPECT_EQ(Offsets.lookup("c_jmp_end"), 2u);
+  EXPECT_EQ(Offsets.lookup("a_end"), 127u);
+  EXPECT_EQ(Offsets.lookup("b_end"), 127u);
+  EXPECT_EQ(Offsets.lookup("c_end"), 102u);
+}
+
+} // namespace
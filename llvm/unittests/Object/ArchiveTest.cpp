@@ -7,8 +7,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Object/Archive.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Object/ArchiveWriter.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/TargetParser/Triple.h"
 #include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
 #include "gtest/gtest.h"
+#include <set>
 
 using namespace llvm;
 using namespace object;
@@ -91,3 +101,152 @@ TEST_F(ArchiveTestsFixture, ArchiveChildGetBuffer) {
   EXPECT_EQ(MemberSize, Buffer->size());
   EXPECT_EQ(ArchiveWithMember + sizeof(ArchiveWithMember) - 1, Buffer->data());
 }
+
+namespace {
+// Pairs of a symbol name and the name of the member defining it.
+using SymbolList = std::vector<std::pair<std::string, std::string>>;
+
+struct BitcodeArchiveFixture : Test {
+  // Adds a bitcode member compiled from Assembly.
+  void addMember(StringRef Name, StringRef Assembly) {
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(Assembly, Err, Context);
+    ASSERT_TRUE(M) << Err.getMessage().str();
+    Bitcode.emplace_back();
+    raw_svector_ostream OS(Bitcode.back());
+    WriteBitcodeToFile(*M, OS);
+    Members.emplace_back(MemoryBufferRef(Bitcode.back(), Name));
+  }
+
+  // Returns the symbols the archive writer selects when it opens the members
+  // as IRObjectFiles: the global, defined symbols that are not format
+  // specific. COFF archives only list the first definition of a symbol, in
+  // the EC map for ARM64EC and x86_64 members.
+  void getIRObjectFileSymbols(bool IsCOFF, bool IsEC, SymbolList &Map,
+                              SymbolList &ECMap) {
+    LLVMContext IRContext;
+    std::set<std::string> Seen, SeenEC;
+    for (const NewArchiveMember &Member : Members) {
+      MemoryBufferRef Buf = Member.Buf->getMemBufferRef();
+      Expected<std::unique_ptr<SymbolicFile>> ObjOrErr =
+          SymbolicFile::createSymbolicFile(Buf, file_magic::bitcode,
+                                           &IRContext);
+      ASSERT_THAT_EXPECTED(ObjOrErr, Succeeded());
+      Triple T(cantFail(getBitcodeTargetTriple(Buf)));
+      bool InEC =
+          IsEC && (T.isWindowsArm64EC() || T.getArch() == Triple::x86_64);
+      for (const BasicSymbolRef &S : (*ObjOrErr)->symbols()) {
+        uint32_t Flags = cantFail(S.getFlags());
+        if ((Flags & SymbolRef::SF_FormatSpecific) ||
+            !(Flags & SymbolRef::SF_Global) ||
+            (Flags & SymbolRef::SF_Undefined))
+          continue;
+        std::string Name;
+        raw_string_ostream NameOS(Name);
+        ASSERT_THAT_ERROR(S.printName(NameOS), Succeeded());
+        if (IsCOFF && !(InEC ? SeenEC : Seen).insert(Name).second)
+          continue;
+        (InEC ? ECMap : Map).emplace_back(Name, Member.MemberName.str());
+      }
+    }
+    llvm::sort(Map);
+    llvm::sort(ECMap);
+  }
+
+  static void getArchiveSymbols(iterator_range<Archive::symbol_iterator> Syms,
+                                SymbolList &Ret) {
+    for (const Archive::Symbol &S : Syms) {
+      Expected<Archive::Child> C = S.getMember();
+      ASSERT_THAT_EXPECTED(C, Succeeded());
+      Expected<StringRef> MemberName = C->getName();
+      ASSERT_THAT_EXPECTED(MemberName, Succeeded());
+      Ret.emplace_back(S.getName().str(), MemberName->str());
+    }
+    llvm::sort(Ret);
+  }
+
+  LLVMContext Context;
+  std::vector<SmallString<0>> Bitcode;
+  std::vector<NewArchiveMember> Members;
+};
+} // namespace
+
+TEST_F(BitcodeArchiveFixture, SymbolTableMatchesIRObjectFile) {
+  addMember("a.o", "target triple = \"x86_64-unknown-linux-gnu\"\n"
+                   "@a_var = global i32 0\n"
+                   "@internal_var = internal global i32 0\n"
+                   "@dup = weak global i32 0\n"
+                   "declare void @undef()\n"
+                   "define void @a_func() {\n"
+                   "  call void @undef()\n"
+                   "  ret void\n"
+                   "}\n");
+  addMember("b.o", "target triple = \"x86_64-unknown-linux-gnu\"\n"
+                   "@dup = weak global i32 1\n"
+                   "define void @b_func() {\n"
+                   "  ret void\n"
+                   "}\n");
+
+  // Duplicate definitions are all listed in a GNU archive.
+  SymbolList IRSymbols, IRECSymbols;
+  getIRObjectFileSymbols(/*IsCOFF=*/false, /*IsEC=*/false, IRSymbols,
+                         IRECSymbols);
+  EXPECT_EQ(llvm::count_if(IRSymbols,
+                           [](const auto &S) { return S.first == "dup"; }),
+            2);
+  EXPECT_TRUE(IRECSymbols.empty());
+
+  Expected<std::unique_ptr<MemoryBuffer>> BufOrErr =
+      writeArchiveToBuffer(Members, SymtabWritingMode::NormalSymtab,
+                           Archive::K_GNU, /*Deterministic=*/true,
+                           /*Thin=*/false);
+  ASSERT_THAT_EXPECTED(BufOrErr, Succeeded());
+  Expected<std::unique_ptr<Archive>> ArchiveOrErr =
+      Archive::create((*BufOrErr)->getMemBufferRef());
+  ASSERT_THAT_EXPECTED(ArchiveOrErr, Succeeded());
+
+  SymbolList Symbols;
+  getArchiveSymbols((*ArchiveOrErr)->symbols(), Symbols);
+  EXPECT_EQ(IRSymbols, Symbols);
+}
+
+TEST_F(BitcodeArchiveFixture, COFFSymbolTableMatchesIRObjectFile) {
+  addMember("native.o", "target triple = \"aarch64-pc-windows-msvc\"\n"
+                        "@native_var = global i32 0\n"
+                        "@dup = weak global i32 0\n");
+  addMember("ec.o", "target triple = \"arm64ec-pc-windows-msvc\"\n"
+                    "@ec_var = global i32 0\n"
+                    "@dup = weak global i32 1\n");
+  addMember("x64.o", "target triple = \"x86_64-pc-windows-msvc\"\n"
+                     "@x64_var = global i32 0\n"
+                     "@dup = weak global i32 2\n");
+
+  // Only the first definition of dup is listed in either map.
+  SymbolList IRSymbols, IRECSymbols;
+  getIRObjectFileSymbols(/*IsCOFF=*/true, /*IsEC=*/true, IRSymbols,
+                         IRECSymbols);
+  EXPECT_FALSE(IRSymbols.empty());
+  EXPECT_FALSE(IRECSymbols.empty());
+
+  unittest::TempDir Dir("bitcode-archive", /*Unique=*/true);
+  SmallString<128> Path = Dir.path("test.lib");
+  ASSERT_THAT_ERROR(writeArchive(Path, Members, SymtabWritingMode::NormalSymtab,
+                                 Archive::K_COFF, /*Deterministic=*/true,
+                                 /*Thin=*/false, /*OldArchiveBuf=*/nullptr,
+                                 /*IsEC=*/true),
+                    Succeeded());
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr = MemoryBuffer::getFile(Path);
+  ASSERT_TRUE(BufOrErr);
+  Expected<std::unique_ptr<Archive>> ArchiveOrErr =
+      Archive::create((*BufOrErr)->getMemBufferRef());
+  ASSERT_THAT_EXPECTED(ArchiveOrErr, Succeeded());
+
+  SymbolList Symbols, ECSymbols;
+  getArchiveSymbols((*ArchiveOrErr)->symbols(), Symbols);
+  Expected<iterator_range<Archive::symbol_iterator>> ECSymbolsOrErr =
+      (*ArchiveOrErr)->ec_symbols();
+  ASSERT_THAT_EXPECTED(ECSymbolsOrErr, Succeeded());
+  getArchiveSymbols(*ECSymbolsOrErr, ECSymbols);
+  EXPECT_EQ(IRSymbols, Symbols);
+  EXPECT_EQ(IRECSymbols, ECSymbols);
+}
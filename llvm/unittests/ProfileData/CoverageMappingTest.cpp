@@ -378,6 +378,39 @@ TEST_P(CoverageMappingTest, load_coverage_for_several_functions) {
   }
 }
 
+TEST_P(CoverageMappingTest, covered_functions_in_file) {
+  ProfileWriter.addRecord({"func1", 0x1234, {10}}, Err);
+  ProfileWriter.addRecord({"func2", 0x2345, {20}}, Err);
+  ProfileWriter.addRecord({"func3", 0x3456, {30}}, Err);
+
+  startFunction("func1", 0x1234);
+  addCMR(Counter::getCounter(0), "foo", 1, 1, 5, 5);
+
+  // func2 starts in bar and only expands code from foo.
+  startFunction("func2", 0x2345);
+  addCMR(Counter::getCounter(0), "bar", 2, 2, 6, 6);
+  addExpansionCMR("bar", "foo", 3, 3, 3, 3);
+  addCMR(Counter::getCounter(0), "foo", 7, 7, 8, 8);
+
+  startFunction("func3", 0x3456);
+  addCMR(Counter::getCounter(0), "foo", 10, 1, 12, 1);
+
+  EXPECT_THAT_ERROR(loadCoverageMapping(), Succeeded());
+
+  std::vector<StringRef> Names;
+  for (const auto &Function : LoadedCoverage->getCoveredFunctions("foo"))
+    Names.push_back(Function.Name);
+  EXPECT_EQ((std::vector<StringRef>{"func1", "func3"}), Names);
+
+  Names.clear();
+  for (const auto &Function : LoadedCoverage->getCoveredFunctions("bar"))
+    Names.push_back(Function.Name);
+  EXPECT_EQ((std::vector<StringRef>{"func2"}), Names);
+
+  const auto None = LoadedCoverage->getCoveredFunctions("baz");
+  EXPECT_EQ(0, std::distance(None.begin(), None.end()));
+}
+
 TEST_P(CoverageMappingTest, create_combined_regions) {
   ProfileWriter.addRecord({"func1", 0x1234, {1, 2, 3}}, Err);
   startFunction("func1", 0x1234);
@@ -7,7 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Remarks/RemarkStreamer.h"
 #include "llvm/Remarks/RemarkStringTable.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -121,3 +124,29 @@ TEST(RemarksAPI, StringTableInternalize) {
   EXPECT_EQ(StrTab.add(R.Args.back().Loc->SourceFilePath).second.data(),
             R2.Args.back().Loc->SourceFilePath.data());
 }
+
+TEST(RemarksAPI, StreamerPassFilter) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> Serializer =
+      remarks::createRemarkSerializer(remarks::Format::YAML,
+                                      remarks::SerializerMode::Separate, OS);
+  ASSERT_TRUE(static_cast<bool>(Serializer));
+  remarks::RemarkStreamer RS(std::move(*Serializer));
+
+  // Without a filter everything passes.
+  EXPECT_TRUE(RS.matchesFilter("inline"));
+
+  ASSERT_FALSE(errorToBool(RS.setFilter("inline|licm")));
+  // The results are cached, ask twice.
+  for (int I = 0; I < 2; ++I) {
+    EXPECT_TRUE(RS.matchesFilter("inline"));
+    EXPECT_TRUE(RS.matchesFilter("licm"));
+    EXPECT_FALSE(RS.matchesFilter("gvn"));
+  }
+
+  // A new filter drops the cached results.
+  ASSERT_FALSE(errorToBool(RS.setFilter("gvn")));
+  EXPECT_FALSE(RS.matchesFilter("inline"));
+  EXPECT_TRUE(RS.matchesFilter("gvn"));
+}
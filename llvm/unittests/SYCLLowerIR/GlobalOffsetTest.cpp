@@ -0,0 +1,163 @@
+//===- GlobalOffsetTest.cpp - Tests for GlobalOffsetPass ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/SYCLLowerIR/GlobalOffset.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// A kernel reading the offset through a callee, and a kernel that doesn't use
+// the offset at all.
+constexpr char Source[] = R"(
+target triple = "nvptx64-nvidia-cuda"
+
+declare ptr @llvm.nvvm.implicit.offset()
+
+define i32 @get_offset(i32 %dim) {
+entry:
+  %offset = call ptr @llvm.nvvm.implicit.offset()
+  %idx = getelementptr inbounds i32, ptr %offset, i32 %dim
+  %val = load i32, ptr %idx, align 4
+  ret i32 %val
+}
+
+define void @kernel(ptr %out) {
+entry:
+  %offset = call ptr @llvm.nvvm.implicit.offset()
+  %x = load i32, ptr %offset, align 4
+  %y = call i32 @get_offset(i32 1)
+  %sum = add i32 %x, %y
+  store i32 %sum, ptr %out, align 4
+  ret void
+}
+
+define void @other_kernel(ptr %out) {
+entry:
+  store i32 0, ptr %out, align 4
+  ret void
+}
+
+!nvvm.annotations = !{!0, !1}
+
+!0 = !{ptr @kernel, !"kernel", i32 1}
+!1 = !{ptr @other_kernel, !"kernel", i32 1}
+)";
+
+class GlobalOffsetTest : public testing::Test {
+protected:
+  void TearDown() override { setAssumeNoGlobalOffset(false); }
+
+  static void setAssumeNoGlobalOffset(bool Value) {
+    auto *Opt = static_cast<cl::opt<bool> *>(
+        cl::getRegisteredOptions().lookup("sycl-assume-no-global-offset"));
+    ASSERT_NE(Opt, nullptr);
+    Opt->setValue(Value);
+  }
+
+  void runPass() {
+    SMDiagnostic Err;
+    M = parseAssemblyString(Source, Err, Ctx);
+    if (!M)
+      Err.print("GlobalOffsetTest", errs());
+    ASSERT_TRUE(M);
+    ModuleAnalysisManager MAM;
+    GlobalOffsetPass().run(*M, MAM);
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+    EXPECT_EQ(M->getFunction("llvm.nvvm.implicit.offset"), nullptr);
+  }
+
+  unsigned getNumOffsetClones() {
+    unsigned NumClones = 0;
+    for (Function &F : *M)
+      if (F.getName().ends_with("_with_offset"))
+        ++NumClones;
+    return NumClones;
+  }
+
+  // Returns the alloca of three zeros the offset is read from in \p F.
+  AllocaInst *getZeroOffset(Function &F) {
+    AllocaInst *ZeroOffset = nullptr;
+    for (Instruction &I : F.getEntryBlock()) {
+      auto *AI = dyn_cast<AllocaInst>(&I);
+      if (!AI || AI->getAllocatedType() !=
+                     ArrayType::get(Type::getInt32Ty(Ctx), 3))
+        continue;
+      EXPECT_EQ(ZeroOffset, nullptr);
+      ZeroOffset = AI;
+    }
+    if (!ZeroOffset)
+      return nullptr;
+    // The alloca is zeroed before any use of the offset.
+    bool IsZeroed = false;
+    for (User *U : ZeroOffset->users())
+      if (auto *MS = dyn_cast<MemSetInst>(U))
+        if (auto *Val = dyn_cast<ConstantInt>(MS->getValue()))
+          IsZeroed |= Val->isZero();
+    EXPECT_TRUE(IsZeroed);
+    return ZeroOffset;
+  }
+
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M;
+};
+
+TEST_F(GlobalOffsetTest, AddsOffsetArgumentToClones) {
+  runPass();
+  // The kernel using the offset gets a clone taking it, the original kernel
+  // passes zeros to the callee, which reads the offset from a new argument.
+  EXPECT_EQ(getNumOffsetClones(), 1u);
+  Function *Callee = M->getFunction("get_offset");
+  Function *Kernel = M->getFunction("kernel");
+  ASSERT_NE(Callee, nullptr);
+  ASSERT_NE(Kernel, nullptr);
+  EXPECT_NE(M->getFunction("kernel_with_offset"), nullptr);
+  EXPECT_EQ(Callee->arg_size(), 2u);
+  EXPECT_EQ(getZeroOffset(*Callee), nullptr);
+  EXPECT_NE(getZeroOffset(*Kernel), nullptr);
+}
+
+TEST_F(GlobalOffsetTest, AssumeNoGlobalOffset) {
+  setAssumeNoGlobalOffset(true);
+  runPass();
+  EXPECT_EQ(getNumOffsetClones(), 0u);
+  // No signature is changed.
+  Function *Callee = M->getFunction("get_offset");
+  Function *Kernel = M->getFunction("kernel");
+  Function *OtherKernel = M->getFunction("other_kernel");
+  ASSERT_NE(Callee, nullptr);
+  ASSERT_NE(Kernel, nullptr);
+  ASSERT_NE(OtherKernel, nullptr);
+  EXPECT_EQ(Callee->arg_size(), 1u);
+  EXPECT_EQ(Kernel->arg_size(), 1u);
+  EXPECT_EQ(OtherKernel->arg_size(), 1u);
+  EXPECT_EQ(M->getNamedMetadata("nvvm.annotations")->getNumOperands(), 2u);
+
+  // Each function that called the intrinsic reads from a zeroed alloca.
+  for (Function *F : {Callee, Kernel}) {
+    AllocaInst *ZeroOffset = getZeroOffset(*F);
+    ASSERT_NE(ZeroOffset, nullptr) << F->getName();
+    bool HasOffsetRead = false;
+    for (User *U : ZeroOffset->users())
+      if (isa<GetElementPtrInst>(U) && !U->use_empty())
+        HasOffsetRead = true;
+    EXPECT_TRUE(HasOffsetRead) << F->getName();
+  }
+  EXPECT_EQ(getZeroOffset(*OtherKernel), nullptr);
+}
+
+} // namespace
@@ -0,0 +1,196 @@
+//===- LowerWGLocalMemoryTest.cpp - Tests for SYCLLowerWGLocalMemoryPass --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/SYCLLowerIR/LowerWGLocalMemory.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// Declarations shared by all the tests. The barriers have Workgroup execution
+// and memory scope, 272 is WorkgroupMemory | SequentiallyConsistent.
+constexpr char Prologue[] = R"(
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v128:128-v256:256-v512:512-v1024:1024-n8:16:32:64"
+target triple = "spir64-unknown-unknown"
+
+declare spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64, i64)
+declare spir_func void @_Z22__spirv_ControlBarrierjjj(i32, i32, i32)
+declare spir_func void @use(ptr addrspace(3))
+)";
+
+class LowerWGLocalMemoryTest : public testing::Test {
+protected:
+  // Sharing is off by default.
+  void SetUp() override { setShareLocalMemory(true); }
+  void TearDown() override { setShareLocalMemory(false); }
+
+  static void setShareLocalMemory(bool Value) {
+    auto *Opt = static_cast<cl::opt<bool> *>(
+        cl::getRegisteredOptions().lookup("sycl-share-wg-local-memory"));
+    ASSERT_NE(Opt, nullptr);
+    Opt->setValue(Value);
+  }
+
+  void runPass(StringRef Kernel) {
+    SMDiagnostic Err;
+    M = parseAssemblyString((Twine(Prologue) + Kernel).str(), Err, Ctx);
+    if (!M)
+      Err.print("LowerWGLocalMemoryTest", errs());
+    ASSERT_TRUE(M);
+    ModuleAnalysisManager MAM;
+    SYCLLowerWGLocalMemoryPass().run(*M, MAM);
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+    EXPECT_EQ(M->getFunction("__sycl_allocateLocalMemory"), nullptr);
+  }
+
+  SmallVector<GlobalVariable *, 2> getLocalMemGlobals() {
+    SmallVector<GlobalVariable *, 2> GVs;
+    for (GlobalVariable &GV : M->globals())
+      if (GV.getName().starts_with("WGLocalMem"))
+        GVs.push_back(&GV);
+    return GVs;
+  }
+
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M;
+};
+
+TEST_F(LowerWGLocalMemoryTest, SharesAllocationsSeparatedByBarrier) {
+  runPass(R"(
+define spir_kernel void @kernel() {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 2, i32 272)
+  store i32 2, ptr addrspace(3) %b
+  ret void
+}
+)");
+  auto GVs = getLocalMemGlobals();
+  ASSERT_EQ(GVs.size(), 1u);
+  // The largest allocation is kept, with the strictest alignment.
+  const DataLayout &DL = M->getDataLayout();
+  EXPECT_EQ(DL.getTypeAllocSize(GVs[0]->getValueType()), 128u);
+  EXPECT_EQ(GVs[0]->getAlign(), MaybeAlign(8));
+  EXPECT_EQ(GVs[0]->getNumUses(), 2u);
+}
+
+TEST_F(LowerWGLocalMemoryTest, KeepsAllocationsWithoutLocalMemoryBarrier) {
+  runPass(R"(
+define spir_kernel void @kernel() {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 2, i32 0)
+  store i32 2, ptr addrspace(3) %b
+  ret void
+}
+)");
+  // The barrier doesn't order the accesses to work-group memory.
+  EXPECT_EQ(getLocalMemGlobals().size(), 2u);
+}
+
+TEST_F(LowerWGLocalMemoryTest, KeepsAllocationsWithoutSharing) {
+  setShareLocalMemory(false);
+  runPass(R"(
+define spir_kernel void @kernel() {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 2, i32 272)
+  store i32 2, ptr addrspace(3) %b
+  ret void
+}
+)");
+  EXPECT_EQ(getLocalMemGlobals().size(), 2u);
+}
+
+TEST_F(LowerWGLocalMemoryTest, KeepsAllocationsWithNarrowMemoryScope) {
+  runPass(R"(
+define spir_kernel void @kernel() {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  %c = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 32, i64 8)
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 3, i32 272)
+  store i32 2, ptr addrspace(3) %b
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 4, i32 272)
+  store i32 3, ptr addrspace(3) %c
+  ret void
+}
+)");
+  // Subgroup and Invocation memory scopes don't make the accesses of the
+  // other work-items of the group visible.
+  EXPECT_EQ(getLocalMemGlobals().size(), 3u);
+}
+
+TEST_F(LowerWGLocalMemoryTest, SharesAllocationsSeparatedByDeviceScopeBarrier) {
+  runPass(R"(
+define spir_kernel void @kernel() {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 1, i32 272)
+  store i32 2, ptr addrspace(3) %b
+  ret void
+}
+)");
+  EXPECT_EQ(getLocalMemGlobals().size(), 1u);
+}
+
+TEST_F(LowerWGLocalMemoryTest, KeepsEscapingAllocations) {
+  runPass(R"(
+define spir_kernel void @kernel() {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 2, i32 272)
+  call spir_func void @use(ptr addrspace(3) %b)
+  ret void
+}
+)");
+  // The callee may access %b anywhere, e.g. keep it for a later call.
+  EXPECT_EQ(getLocalMemGlobals().size(), 2u);
+}
+
+TEST_F(LowerWGLocalMemoryTest, KeepsAllocationsReachableAcrossBarrier) {
+  runPass(R"(
+define spir_kernel void @kernel(i1 %c) {
+entry:
+  %a = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 128, i64 4)
+  %b = call spir_func ptr addrspace(3) @__sycl_allocateLocalMemory(i64 64, i64 8)
+  br label %loop
+
+loop:
+  store i32 1, ptr addrspace(3) %a
+  call spir_func void @_Z22__spirv_ControlBarrierjjj(i32 2, i32 2, i32 272)
+  store i32 2, ptr addrspace(3) %b
+  br i1 %c, label %loop, label %exit
+
+exit:
+  ret void
+}
+)");
+  // The next iteration writes %a while %b may still be in use.
+  EXPECT_EQ(getLocalMemGlobals().size(), 2u);
+}
+
+} // namespace
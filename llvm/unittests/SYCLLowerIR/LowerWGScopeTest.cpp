@@ -0,0 +1,140 @@
+//===- LowerWGScopeTest.cpp - Tests for SYCLLowerWGScopePass --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/SYCLLowerIR/LowerWGScope.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// A parallel_for_work_group lambda calling parallel_for_work_item twice.
+// %a is passed to the work item scope calls, %b is only accessed by the
+// leader, unless a pointer to it escapes. %x can be computed by every work
+// item, %y must be shared by the leader.
+constexpr char PFWGHead[] = R"(
+target datalayout = "e-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v128:128-v256:256-v512:512-v1024:1024-n8:16:32:64"
+target triple = "spir64-unknown-unknown"
+
+@Out = external addrspace(1) global i32
+@Ptr = external addrspace(1) global ptr
+
+declare spir_func void @pfwi(ptr) !work_item_scope !0 !parallel_for_work_item !0
+
+define internal spir_func void @pfwg(i32 %n) !work_group_scope !0 {
+entry:
+  %a = alloca i32
+  %b = alloca i32
+  store i32 1, ptr %a
+  store i32 2, ptr %b
+  %x = add i32 %n, 1
+  %y = load i32, ptr addrspace(1) @Out
+)";
+
+constexpr char EscapeB[] = R"(
+  store ptr %b, ptr addrspace(1) @Ptr
+)";
+
+constexpr char PFWGTail[] = R"(
+  call spir_func void @pfwi(ptr %a)
+  %z = add i32 %x, %y
+  store i32 %z, ptr addrspace(1) @Out
+  call spir_func void @pfwi(ptr %a)
+  ret void
+}
+
+!0 = !{}
+)";
+
+class LowerWGScopeTest : public testing::Test {
+protected:
+  void runPass(bool Escape) {
+    SMDiagnostic Err;
+    std::string IR =
+        (Twine(PFWGHead) + (Escape ? EscapeB : "") + PFWGTail).str();
+    M = parseAssemblyString(IR, Err, Ctx);
+    if (!M)
+      Err.print("LowerWGScopeTest", errs());
+    ASSERT_TRUE(M);
+    F = M->getFunction("pfwg");
+    FunctionAnalysisManager FAM;
+    SYCLLowerWGScopePass().run(*F, FAM);
+    EXPECT_FALSE(verifyModule(*M, &errs()));
+  }
+
+  unsigned countGlobals(StringRef Prefix) {
+    return count_if(M->globals(), [&](const GlobalVariable &GV) {
+      return GV.getName().starts_with(Prefix);
+    });
+  }
+
+  Instruction *getInstruction(StringRef Name) {
+    for (Instruction &I : instructions(*F))
+      if (I.getName() == Name)
+        return &I;
+    return nullptr;
+  }
+
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M;
+  Function *F = nullptr;
+};
+
+TEST_F(LowerWGScopeTest, MaterializesLocalsUsedByWorkItems) {
+  runPass(/*Escape=*/false);
+  // Only %a gets a shadow, materialized before each of the two calls.
+  EXPECT_EQ(countGlobals("WGCopy"), 1u);
+  Instruction *B = getInstruction("b");
+  ASSERT_NE(B, nullptr);
+  EXPECT_EQ(B->getNumUses(), 1u);
+}
+
+TEST_F(LowerWGScopeTest, MaterializesEscapingLocals) {
+  runPass(/*Escape=*/true);
+  // A pointer to %b escapes, so it could be accessed by the work items.
+  EXPECT_EQ(countGlobals("WGCopy"), 2u);
+}
+
+TEST_F(LowerWGScopeTest, RecomputesUniformValues) {
+  runPass(/*Escape=*/false);
+  EXPECT_NE(getInstruction("wi_val_x"), nullptr);
+  EXPECT_EQ(countGlobals("pfwgWG_x"), 0u);
+  // The load may see different values in different work items.
+  EXPECT_EQ(getInstruction("wi_val_y"), nullptr);
+  EXPECT_EQ(countGlobals("pfwgWG_y"), 1u);
+}
+
+TEST_F(LowerWGScopeTest, RemovesRedundantBarriers) {
+  runPass(/*Escape=*/false);
+  // Between two barriers of a block there is a call which may access shared
+  // memory, the pass's own copies between them don't need another barrier.
+  unsigned NumBarriers = 0;
+  for (BasicBlock &BB : *F) {
+    bool AfterBarrier = false;
+    for (Instruction &I : BB) {
+      auto *Call = dyn_cast<CallInst>(&I);
+      if (!Call)
+        continue;
+      bool IsBarrier = Call->getCalledFunction()->getName() ==
+                       "_Z22__spirv_ControlBarrierjjj";
+      EXPECT_FALSE(IsBarrier && AfterBarrier) << BB.getName().str();
+      AfterBarrier = IsBarrier;
+      NumBarriers += IsBarrier;
+    }
+  }
+  EXPECT_GT(NumBarriers, 0u);
+}
+
+} // namespace
@@ -0,0 +1,109 @@
+//===- CachingTest.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Caching.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+#include <mutex>
+
+using namespace llvm;
+
+namespace {
+
+class MemoryStore : public CacheStore {
+public:
+  Expected<std::unique_ptr<MemoryBuffer>> get(StringRef Key) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = Entries.find(Key);
+    if (It == Entries.end())
+      return nullptr;
+    return MemoryBuffer::getMemBufferCopy(It->second);
+  }
+
+  Error put(StringRef Key, MemoryBufferRef Contents) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ++Puts;
+    if (FailPuts)
+      return createStringError(inconvertibleErrorCode(), "store is down");
+    Entries[Key] = Contents.getBuffer().str();
+    return Error::success();
+  }
+
+  std::mutex Mutex;
+  StringMap<std::string> Entries;
+  unsigned Puts = 0;
+  bool FailPuts = false;
+};
+
+} // namespace
+
+TEST(StoreCache, MissIsAddedToStoreAndLink) {
+  auto Store = std::make_shared<MemoryStore>();
+  std::string Added;
+  FileCache Cache = storeCache(
+      "Test", Store,
+      [&](size_t Task, const Twine &, std::unique_ptr<MemoryBuffer> MB) {
+        EXPECT_EQ(3u, Task);
+        Added = MB->getBuffer().str();
+      });
+
+  Expected<AddStreamFn> AddStream = Cache(3, "key", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  ASSERT_TRUE(bool(*AddStream));
+  {
+    auto Stream = (*AddStream)(3, "module");
+    ASSERT_THAT_EXPECTED(Stream, Succeeded());
+    *(*Stream)->OS << "object";
+  }
+  EXPECT_EQ("object", Added);
+  EXPECT_EQ("object", Store->Entries.lookup("key"));
+}
+
+TEST(StoreCache, HitIsAddedToLink) {
+  auto Store = std::make_shared<MemoryStore>();
+  Store->Entries["key"] = "cached";
+  std::string Added;
+  FileCache Cache = storeCache(
+      "Test", Store,
+      [&](size_t, const Twine &, std::unique_ptr<MemoryBuffer> MB) {
+        Added = MB->getBuffer().str();
+      });
+
+  Expected<AddStreamFn> AddStream = Cache(0, "key", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  EXPECT_FALSE(bool(*AddStream));
+  EXPECT_EQ("cached", Added);
+  EXPECT_EQ(0u, Store->Puts);
+}
+
+TEST(StoreCache, FailedPutStillAddsToLink) {
+  auto Store = std::make_shared<MemoryStore>();
+  Store->FailPuts = true;
+  std::string Added;
+  FileCache Cache = storeCache(
+      "Test", Store,
+      [&](size_t, const Twine &, std::unique_ptr<MemoryBuffer> MB) {
+        Added = MB->getBuffer().str();
+      });
+
+  Expected<AddStreamFn> AddStream = Cache(0, "key", "module");
+  ASSERT_THAT_EXPECTED(AddStream, Succeeded());
+  ASSERT_TRUE(bool(*AddStream));
+  {
+    auto Stream = (*AddStream)(0, "module");
+    ASSERT_THAT_EXPECTED(Stream, Succeeded());
+    *(*Stream)->OS << "object";
+  }
+  EXPECT_EQ(1u, Store->Puts);
+  EXPECT_EQ("object", Added);
+  EXPECT_TRUE(Store->Entries.empty());
+}
@@ -452,6 +452,62 @@ TEST(CommandLineTest, HideUnrelatedOptionsMulti) {
       << "Hid default option that should be visable.";
 }
 
+TEST(CommandLineTest, RenameOptionBeforeFirstLookup) {
+  cl::ResetCommandLineParser();
+
+  // The option is entered into the OptionsMap lazily; renaming it before
+  // anything looks at the map must leave only the new name behind.
+  StackOption<int> Option("lazy-old-name");
+  Option.setArgStr("lazy-new-name");
+
+  StringMap<cl::Option *> &Map =
+      cl::getRegisteredOptions(cl::SubCommand::getTopLevel());
+  EXPECT_EQ(0u, Map.count("lazy-old-name"));
+  ASSERT_EQ(1u, Map.count("lazy-new-name"));
+  EXPECT_EQ(&Option, Map["lazy-new-name"]);
+
+  const char *args[] = {"prog", "-lazy-new-name=3"};
+  EXPECT_TRUE(cl::ParseCommandLineOptions(std::size(args), args, StringRef(),
+                                          &llvm::nulls()));
+  EXPECT_EQ(3, Option);
+}
+
+TEST(CommandLineTest, OptionsRegisteredOnFirstLookup) {
+  cl::ResetCommandLineParser();
+
+  // Neither constructing options nor registering a subcommand enters the
+  // options into the OptionsMap.
+  StackOption<int> Option("lazy-option");
+  StackSubCommand SC("lazy-sc", "Subcommand");
+  StackOption<int> SubOption("lazy-sub-option", cl::sub(SC));
+  EXPECT_TRUE(cl::SubCommand::getTopLevel().OptionsMap.empty());
+  EXPECT_TRUE(SC.OptionsMap.empty());
+
+  StringMap<cl::Option *> &Map =
+      cl::getRegisteredOptions(cl::SubCommand::getTopLevel());
+  EXPECT_EQ(1u, Map.count("lazy-option"));
+  EXPECT_EQ(1u, SC.OptionsMap.count("lazy-sub-option"));
+}
+
+TEST(CommandLineTest, OptionConstructedWhileParsing) {
+  cl::ResetCommandLineParser();
+
+  // Options can be constructed while the command line is parsed, e.g. by a
+  // plugin loaded from an option's callback. They must be known to the rest
+  // of the command line.
+  std::unique_ptr<StackOption<int>> Late;
+  StackOption<bool> Load("load-late-option", cl::callback([&](const bool &) {
+                           Late = std::make_unique<StackOption<int>>(
+                               "late-option");
+                         }));
+
+  const char *args[] = {"prog", "-load-late-option", "-late-option=7"};
+  EXPECT_TRUE(cl::ParseCommandLineOptions(std::size(args), args, StringRef(),
+                                          &llvm::nulls()));
+  ASSERT_TRUE(Late);
+  EXPECT_EQ(7, *Late);
+}
+
 TEST(CommandLineTest, SetMultiValues) {
   StackOption<int> Option("option");
   const char *args[] = {"prog", "-option=1", "-option=2"};
@@ -105,9 +105,8 @@ TEST(Parallel, TaskGroupSequentialFor) {
 
 #if LLVM_ENABLE_THREADS
 TEST(Parallel, NestedTaskGroup) {
-  // This test checks:
-  // 1. Root TaskGroup is in Parallel mode.
-  // 2. Nested TaskGroup is not in Parallel mode.
+  // This test checks that both the root TaskGroup and a nested TaskGroup are
+  // in Parallel mode.
   parallel::TaskGroup tg;
 
   tg.spawn([&]() {
@@ -116,17 +115,70 @@ TEST(Parallel, NestedTaskGroup) {
 
   tg.spawn([&]() {
     parallel::TaskGroup nestedTG;
-    EXPECT_FALSE(nestedTG.isParallel());
+    EXPECT_TRUE(nestedTG.isParallel() ||
+                (parallel::strategy.ThreadsRequested == 1));
 
     nestedTG.spawn([&]() {
       // Check that root TaskGroup is in Parallel mode.
       EXPECT_TRUE(tg.isParallel() ||
                   (parallel::strategy.ThreadsRequested == 1));
+    });
+  });
+}
 
-      // Check that nested TaskGroup is not in Parallel mode.
-      EXPECT_FALSE(nestedTG.isParallel());
+TEST(Parallel, NestedParallelFor) {
+  // Nested loops must not dead lock even if every thread of the executor ends
+  // up waiting for a nested group.
+  std::atomic<size_t> Count{0};
+  parallelFor(0, 64, [&](size_t) {
+    parallelFor(0, 64, [&](size_t) {
+      parallelFor(0, 8, [&](size_t) { ++Count; });
     });
   });
+  EXPECT_EQ(Count, 64ul * 64ul * 8ul);
+}
+
+TEST(Parallel, NestedGroupKeepsPerThreadState) {
+  // A thread waiting for a nested group must only run the tasks of that group,
+  // not the outer tasks queued after them, which would reuse the per-thread
+  // state still held by the waiting task.
+  if (parallel::strategy.ThreadsRequested == 1)
+    GTEST_SKIP() << "tasks run inline";
+  std::vector<int> Busy(parallel::getThreadCount());
+  std::atomic<size_t> Count{0};
+  {
+    parallel::TaskGroup tg;
+    for (size_t Idx = 0; Idx < 64; Idx++)
+      tg.spawn([&]() {
+        int &Slot = Busy[parallel::getThreadIndex()];
+        Slot = 1;
+        {
+          parallel::TaskGroup nestedTG;
+          nestedTG.spawn([&]() { ++Count; });
+          tg.spawn([&]() {
+            EXPECT_EQ(Busy[parallel::getThreadIndex()], 0);
+            ++Count;
+          });
+        }
+        Slot = 0;
+      });
+  }
+  EXPECT_EQ(Count, 128ul);
+}
+
+TEST(Parallel, NestedTaskGroupSequentialFor) {
+  std::atomic<size_t> Groups{0};
+  parallelFor(0, 16, [&](size_t) {
+    size_t Count = 0;
+    {
+      parallel::TaskGroup tg;
+      for (size_t Idx = 0; Idx < 100; Idx++)
+        tg.spawn([&Count, Idx]() { EXPECT_EQ(Count++, Idx); }, true);
+    }
+    EXPECT_EQ(Count, 100ul);
+    ++Groups;
+  });
+  EXPECT_EQ(Groups, 16ul);
 }
 
 TEST(Parallel, ParallelNestedTaskGroup) {
@@ -143,9 +195,10 @@ TEST(Parallel, ParallelNestedTaskGroup) {
         EXPECT_TRUE(tg.isParallel() ||
                     (parallel::strategy.ThreadsRequested == 1));
 
-        // Check that nested TaskGroup is not in Parallel mode.
+        // Check that nested TaskGroup is in Parallel mode.
         parallel::TaskGroup nestedTG;
-        EXPECT_FALSE(nestedTG.isParallel());
+        EXPECT_TRUE(nestedTG.isParallel() ||
+                    (parallel::strategy.ThreadsRequested == 1));
         ++Count;
 
         nestedTG.spawn([&]() {
@@ -153,8 +206,9 @@ TEST(Parallel, ParallelNestedTaskGroup) {
           EXPECT_TRUE(tg.isParallel() ||
                       (parallel::strategy.ThreadsRequested == 1));
 
-          // Check that nested TaskGroup is not in Parallel mode.
-          EXPECT_FALSE(nestedTG.isParallel());
+          // Check that nested TaskGroup is in Parallel mode.
+          EXPECT_TRUE(nestedTG.isParallel() ||
+                      (parallel::strategy.ThreadsRequested == 1));
           ++Count;
         });
       });
@@ -962,6 +962,117 @@ TEST(ProxyFileSystemTest, Basic) {
   EXPECT_FALSE(Local);
 }
 
+namespace {
+class CountingFileSystem : public vfs::ProxyFileSystem {
+public:
+  using ProxyFileSystem::ProxyFileSystem;
+
+  unsigned NumStatusCalls = 0;
+  unsigned NumOpenCalls = 0;
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++NumStatusCalls;
+    return ProxyFileSystem::status(Path);
+  }
+  ErrorOr<std::unique_ptr<vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    ++NumOpenCalls;
+    return ProxyFileSystem::openFileForRead(Path);
+  }
+};
+} // namespace
+
+TEST(StatCachingFileSystemTest, Basic) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  IntrusiveRefCntPtr<CountingFileSystem> Counting(new CountingFileSystem(Base));
+  vfs::StatCachingFileSystem CFS(Counting);
+
+  Base->addFile("/a", 0, MemoryBuffer::getMemBuffer("test"));
+
+  // Positive entries are cached.
+  auto Stat = CFS.status("/a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ(4u, Stat->getSize());
+  Stat = CFS.status("/a");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ(1u, Counting->NumStatusCalls);
+
+  // Negative entries are cached too.
+  EXPECT_EQ(errc::no_such_file_or_directory, CFS.status("/b").getError());
+  EXPECT_EQ(errc::no_such_file_or_directory, CFS.status("/b").getError());
+  EXPECT_TRUE(CFS.exists("/a"));
+  EXPECT_FALSE(CFS.exists("/b"));
+  EXPECT_EQ(2u, Counting->NumStatusCalls);
+
+  // Opening a path known to be missing does not reach the underlying FS.
+  EXPECT_EQ(errc::no_such_file_or_directory,
+            CFS.openFileForRead("/b").getError());
+  EXPECT_EQ(0u, Counting->NumOpenCalls);
+
+  auto File = CFS.openFileForRead("/a");
+  ASSERT_FALSE(File.getError());
+  EXPECT_EQ("test", (*(*File)->getBuffer("ignored"))->getBuffer());
+  EXPECT_EQ(1u, Counting->NumOpenCalls);
+
+  // Files added behind the cache's back are seen once it is cleared.
+  Base->addFile("/b", 0, MemoryBuffer::getMemBuffer("b"));
+  EXPECT_FALSE(CFS.exists("/b"));
+  CFS.clear();
+  EXPECT_TRUE(CFS.exists("/b"));
+  EXPECT_EQ(3u, Counting->NumStatusCalls);
+}
+
+TEST(StatCachingFileSystemTest, WorkingDirectoryChangeClearsCache) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  vfs::StatCachingFileSystem CFS(Base);
+
+  Base->addFile("/x/a", 0, MemoryBuffer::getMemBuffer("x"));
+  Base->addFile("/y/b", 0, MemoryBuffer::getMemBuffer("y"));
+
+  ASSERT_FALSE(CFS.setCurrentWorkingDirectory("/x"));
+  EXPECT_TRUE(CFS.exists("a"));
+  EXPECT_FALSE(CFS.exists("b"));
+
+  // The same relative paths resolve somewhere else now.
+  ASSERT_FALSE(CFS.setCurrentWorkingDirectory("/y"));
+  EXPECT_FALSE(CFS.exists("a"));
+  EXPECT_TRUE(CFS.exists("b"));
+}
+
+TEST(StatCachingFileSystemTest, ExcludedPaths) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  IntrusiveRefCntPtr<CountingFileSystem> Counting(new CountingFileSystem(Base));
+  vfs::StatCachingFileSystem CFS(Counting);
+  ASSERT_FALSE(CFS.setCurrentWorkingDirectory("/work"));
+  CFS.excludePath("cache");
+  CFS.excludePath("/out/a.o");
+
+  // Neither missing nor existing entries are cached below an excluded path.
+  EXPECT_FALSE(CFS.exists("/work/cache/m.pcm"));
+  Base->addFile("/work/cache/m.pcm", 0, MemoryBuffer::getMemBuffer("old"));
+  EXPECT_TRUE(CFS.exists("cache/m.pcm"));
+  EXPECT_FALSE(CFS.exists("/out/a.o"));
+  Base->addFile("/out/a.o", 0, MemoryBuffer::getMemBuffer(""));
+  EXPECT_TRUE(CFS.exists("/out/a.o"));
+  EXPECT_EQ(4u, Counting->NumStatusCalls);
+
+  // Paths that only share a prefix with an excluded path are still cached.
+  EXPECT_FALSE(CFS.exists("/work/cache2/m.pcm"));
+  EXPECT_FALSE(CFS.exists("/work/cache2/m.pcm"));
+  EXPECT_FALSE(CFS.exists("/out/a.out"));
+  EXPECT_FALSE(CFS.exists("/out/a.out"));
+  EXPECT_EQ(6u, Counting->NumStatusCalls);
+
+  // A file that was missing before can be opened once it is written.
+  EXPECT_FALSE(CFS.exists("/work/cache/n.pcm"));
+  Base->addFile("/work/cache/n.pcm", 0, MemoryBuffer::getMemBuffer("n"));
+  EXPECT_FALSE(CFS.openFileForRead("/work/cache/n.pcm").getError());
+  EXPECT_EQ(1u, Counting->NumOpenCalls);
+}
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
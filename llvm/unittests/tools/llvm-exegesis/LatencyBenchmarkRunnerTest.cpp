@@ -0,0 +1,36 @@
+//===-- LatencyBenchmarkRunnerTest.cpp --------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LatencyBenchmarkRunner.h"
+#include "gtest/gtest.h"
+
+namespace llvm {
+namespace exegesis {
+
+namespace {
+
+TEST(LatencyBenchmarkRunnerTest, MedianOfOddCount) {
+  EXPECT_EQ(findMedian({7}), 7);
+  EXPECT_EQ(findMedian({30, 10, 20}), 20);
+  EXPECT_EQ(findMedian({5, 100, 1, 3, 4}), 4);
+}
+
+TEST(LatencyBenchmarkRunnerTest, MedianOfEvenCount) {
+  EXPECT_EQ(findMedian({20, 10}), 15);
+  EXPECT_EQ(findMedian({4, 1, 3, 2}), 2);
+  EXPECT_EQ(findMedian({1000, 3, 1, 5}), 4);
+  EXPECT_EQ(findMedian({-3, -1}), -2);
+}
+
+TEST(LatencyBenchmarkRunnerTest, MedianOfNoValues) {
+  EXPECT_EQ(findMedian({}), 0);
+}
+
+} // namespace
+} // namespace exegesis
+} // namespace llvm
@@ -0,0 +1,80 @@
+#include "Views/BottleneckAnalysis.h"
+#include "Views/SummaryView.h"
+#include "X86TestBase.h"
+#include "llvm/Support/JSON.h"
+
+using namespace llvm;
+using namespace mca;
+
+TEST_F(X86TestBase, TestBottleneckAnalysisJSON) {
+  SmallVector<MCInst> MCIs;
+  getSimpleInsts(MCIs, /*Repeats=*/100);
+
+  auto PO = getDefaultPipelineOptions();
+  PO.EnableBottleneckAnalysis = true;
+  SummaryView SV(STI->getSchedModel(), MCIs, PO.DispatchWidth);
+  BottleneckAnalysis BA(*STI, *IP, MCIs, /*Iterations=*/1);
+  json::Object Result;
+  auto E = runBaselineMCA(Result, MCIs, {&SV, &BA}, &PO);
+  ASSERT_FALSE(bool(E)) << "Failed to run baseline";
+
+  auto *BAObj = Result.getObject(BA.getNameAsString());
+  ASSERT_TRUE(BAObj) << "Does not contain BottleneckAnalysis result";
+  auto *SVObj = Result.getObject(SV.getNameAsString());
+  ASSERT_TRUE(SVObj) << "Does not contain SummaryView result";
+
+  // Both views count the cycles of the same simulation.
+  auto TotalCycles = BAObj->getInteger("TotalCycles");
+  auto SVTotalCycles = SVObj->getInteger("TotalCycles");
+  ASSERT_TRUE(TotalCycles && SVTotalCycles);
+  EXPECT_EQ(*SVTotalCycles, *TotalCycles);
+
+  auto Increase = BAObj->getInteger("PressureIncreaseCycles");
+  auto Resource = BAObj->getInteger("ResourcePressureCycles");
+  auto Data = BAObj->getInteger("DataDependencyCycles");
+  auto Register = BAObj->getInteger("RegisterDependencyCycles");
+  auto Memory = BAObj->getInteger("MemoryDependencyCycles");
+  ASSERT_TRUE(Increase && Resource && Data && Register && Memory);
+  EXPECT_LE(*Increase, *TotalCycles);
+  EXPECT_LE(*Resource, *Increase);
+  EXPECT_LE(*Data, *Increase);
+  // The sequence has no memory operations, so all data dependencies are
+  // register dependencies.
+  EXPECT_EQ(*Memory, 0);
+  EXPECT_EQ(*Register, *Data);
+
+  auto *Distribution = BAObj->getArray("ResourcePressureDistribution");
+  ASSERT_TRUE(Distribution);
+  for (const json::Value &V : *Distribution) {
+    auto *Entry = V.getAsObject();
+    ASSERT_TRUE(Entry);
+    auto Name = Entry->getString("Resource");
+    ASSERT_TRUE(Name);
+    EXPECT_FALSE(Name->empty());
+    auto Cycles = Entry->getInteger("Cycles");
+    ASSERT_TRUE(Cycles);
+    EXPECT_GT(*Cycles, 0);
+  }
+
+  auto *Sequence = BAObj->getArray("CriticalSequence");
+  ASSERT_TRUE(Sequence);
+  for (const json::Value &V : *Sequence) {
+    auto *Edge = V.getAsObject();
+    ASSERT_TRUE(Edge);
+    auto From = Edge->getInteger("FromInstructionIndex");
+    auto To = Edge->getInteger("ToInstructionIndex");
+    ASSERT_TRUE(From && To && Edge->getInteger("Cost"));
+    EXPECT_LT(*From, (int64_t)MCIs.size());
+    EXPECT_LT(*To, (int64_t)MCIs.size());
+    auto Type = Edge->getString("Type");
+    ASSERT_TRUE(Type);
+    if (*Type == "Register") {
+      EXPECT_TRUE(Edge->getString("Register"));
+    } else if (*Type == "Resource") {
+      EXPECT_TRUE(Edge->getString("Resource"));
+      EXPECT_TRUE(Edge->getInteger("Probability"));
+    } else {
+      EXPECT_EQ(*Type, "Memory");
+    }
+  }
+}
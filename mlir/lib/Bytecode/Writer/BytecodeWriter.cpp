@@ -14,6 +14,7 @@
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/CachedHashString.h"
@@ -608,6 +609,11 @@ private:
   LogicalResult writeRegion(EncodingEmitter &emitter, Region *region);
   LogicalResult writeIRSection(EncodingEmitter &emitter, Operation *op);
 
+  /// Encode, in parallel, the regions of the isolated from above operations
+  /// nested directly within `op`. The regions are emitted by `writeOp` when
+  /// the operations are reached.
+  LogicalResult encodeIsolatedRegions(Operation *op);
+
   LogicalResult writeRegions(EncodingEmitter &emitter,
                              MutableArrayRef<Region> regions) {
     return success(llvm::all_of(regions, [&](Region &region) {
@@ -636,6 +642,10 @@ private:
   void writeUseListOrders(EncodingEmitter &emitter, uint8_t &opEncodingMask,
                           ValueRange range);
 
+  /// Emit the properties of every operation nested within `rootOp` in the
+  /// order the IR section visits them.
+  void emitProperties(Operation *rootOp);
+
   //===--------------------------------------------------------------------===//
   // Fields
 
@@ -650,6 +660,14 @@ private:
 
   /// Storage for the properties section
   PropertiesSectionBuilder propertiesSection;
+
+  /// The index within the properties section of the properties of each
+  /// operation, if any were emitted.
+  DenseMap<Operation *, ssize_t> propertiesIDs;
+
+  /// The encoded regions of isolated from above operations that were encoded
+  /// ahead of the operation itself.
+  DenseMap<Operation *, std::unique_ptr<EncodingEmitter>> encodedRegions;
 };
 } // namespace
 
@@ -679,6 +697,11 @@ LogicalResult BytecodeWriter::write(Operation *rootOp, raw_ostream &os) {
   // Emit the attributes and types section.
   writeAttrTypeSection(emitter);
 
+  // Emit the properties ahead of the IR section, such that the IR doesn't
+  // modify any of the shared writer state and can be encoded in parallel.
+  if (config.bytecodeVersion >= bytecode::kNativePropertiesEncoding)
+    emitProperties(rootOp);
+
   // Emit the IR section.
   if (failed(writeIRSection(emitter, rootOp)))
     return failure();
@@ -932,10 +955,10 @@ LogicalResult BytecodeWriter::writeOp(EncodingEmitter &emitter, Operation *op) {
   // Emit the properties of this operation, for now we still support deployment
   // to version <kNativePropertiesEncoding.
   if (config.bytecodeVersion >= bytecode::kNativePropertiesEncoding) {
-    std::optional<ssize_t> propertiesId = propertiesSection.emit(op);
-    if (propertiesId.has_value()) {
+    auto it = propertiesIDs.find(op);
+    if (it != propertiesIDs.end()) {
       opEncodingMask |= bytecode::OpEncodingMask::kHasProperties;
-      emitter.emitVarInt(*propertiesId);
+      emitter.emitVarInt(it->second);
     }
   }
 
@@ -988,6 +1011,13 @@ LogicalResult BytecodeWriter::writeOp(EncodingEmitter &emitter, Operation *op) {
     // targeting version <kLazyLoading, we don't use a section.
     if (isIsolatedFromAbove &&
         config.bytecodeVersion >= bytecode::kLazyLoading) {
+      // Check to see if the regions were already encoded.
+      auto it = encodedRegions.find(op);
+      if (it != encodedRegions.end()) {
+        emitter.emitSection(bytecode::Section::kIR, std::move(*it->second));
+        return success();
+      }
+
       EncodingEmitter regionEmitter;
       if (failed(writeRegions(regionEmitter, op->getRegions())))
         return failure();
@@ -1000,6 +1030,15 @@ LogicalResult BytecodeWriter::writeOp(EncodingEmitter &emitter, Operation *op) {
   return success();
 }
 
+void BytecodeWriter::emitProperties(Operation *rootOp) {
+  // The IR section visits operations in pre-order, so emitting them in the
+  // same order keeps the section identical to emitting them on the fly.
+  rootOp->walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (std::optional<ssize_t> propertiesID = propertiesSection.emit(op))
+      propertiesIDs.try_emplace(op, *propertiesID);
+  });
+}
+
 void BytecodeWriter::writeUseListOrders(EncodingEmitter &emitter,
                                         uint8_t &opEncodingMask,
                                         ValueRange range) {
@@ -1119,6 +1158,11 @@ LogicalResult BytecodeWriter::writeIRSection(EncodingEmitter &emitter,
   // block has arguments, which in this case is always false.
   irEmitter.emitVarIntWithFlag(/*numOps*/ 1, /*hasArgs*/ false);
 
+  // Encode the regions of isolated operations in parallel, they are then
+  // emitted in order when the operations are reached.
+  if (failed(encodeIsolatedRegions(op)))
+    return failure();
+
   // Emit the operations.
   if (failed(writeOp(irEmitter, op)))
     return failure();
@@ -1127,6 +1171,39 @@ LogicalResult BytecodeWriter::writeIRSection(EncodingEmitter &emitter,
   return success();
 }
 
+LogicalResult BytecodeWriter::encodeIsolatedRegions(Operation *op) {
+  // Isolated regions are only encoded as separate sections starting with lazy
+  // loading support.
+  MLIRContext *ctx = op->getContext();
+  if (config.bytecodeVersion < bytecode::kLazyLoading ||
+      !ctx->isMultithreadingEnabled())
+    return success();
+
+  SmallVector<Operation *> isolatedOps;
+  for (Region &region : op->getRegions())
+    for (Operation &nestedOp : region.getOps())
+      if (nestedOp.getNumRegions() &&
+          numberingState.isIsolatedFromAbove(&nestedOp))
+        isolatedOps.push_back(&nestedOp);
+  if (isolatedOps.size() < 2)
+    return success();
+
+  // Encoding the IR only reads the numbering state, given that the properties
+  // were already emitted.
+  SmallVector<std::unique_ptr<EncodingEmitter>> emitters;
+  for (size_t i = 0, e = isolatedOps.size(); i != e; ++i)
+    emitters.push_back(std::make_unique<EncodingEmitter>());
+  auto encodeFn = [&](size_t i) {
+    return writeRegions(*emitters[i], isolatedOps[i]->getRegions());
+  };
+  if (failed(failableParallelForEachN(ctx, 0, isolatedOps.size(), encodeFn)))
+    return failure();
+
+  for (auto [isolatedOp, regionEmitter] : llvm::zip(isolatedOps, emitters))
+    encodedRegions.try_emplace(isolatedOp, std::move(regionEmitter));
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Resources
 
@@ -160,52 +160,53 @@ public:
   auto getOpNames() { return llvm::make_pointee_range(orderedOpNames); }
   auto getTypes() { return llvm::make_pointee_range(orderedTypes); }
 
-  /// Return the number for the given IR unit.
+  /// Return the number for the given IR unit. These don't modify the
+  /// numbering, and may be called concurrently.
   unsigned getNumber(Attribute attr) {
     assert(attrs.count(attr) && "attribute not numbered");
-    return attrs[attr]->number;
+    return attrs.lookup(attr)->number;
   }
   unsigned getNumber(Block *block) {
     assert(blockIDs.count(block) && "block not numbered");
-    return blockIDs[block];
+    return blockIDs.lookup(block);
   }
   unsigned getNumber(Operation *op) {
     assert(operations.count(op) && "operation not numbered");
-    return operations[op]->number;
+    return operations.lookup(op)->number;
   }
   unsigned getNumber(OperationName opName) {
     assert(opNames.count(opName) && "opName not numbered");
-    return opNames[opName]->number;
+    return opNames.lookup(opName)->number;
   }
   unsigned getNumber(Type type) {
     assert(types.count(type) && "type not numbered");
-    return types[type]->number;
+    return types.lookup(type)->number;
   }
   unsigned getNumber(Value value) {
     assert(valueIDs.count(value) && "value not numbered");
-    return valueIDs[value];
+    return valueIDs.lookup(value);
   }
   unsigned getNumber(const AsmDialectResourceHandle &resource) {
     assert(dialectResources.count(resource) && "resource not numbered");
-    return dialectResources[resource]->number;
+    return dialectResources.lookup(resource)->number;
   }
 
   /// Return the block and value counts of the given region.
   std::pair<unsigned, unsigned> getBlockValueCount(Region *region) {
     assert(regionBlockValueCounts.count(region) && "value not numbered");
-    return regionBlockValueCounts[region];
+    return regionBlockValueCounts.lookup(region);
   }
 
   /// Return the number of operations in the given block.
   unsigned getOperationCount(Block *block) {
     assert(blockOperationCounts.count(block) && "block not numbered");
-    return blockOperationCounts[block];
+    return blockOperationCounts.lookup(block);
   }
 
   /// Return if the given operation is isolated from above.
   bool isIsolatedFromAbove(Operation *op) {
     assert(operations.count(op) && "operation not numbered");
-    return operations[op]->isIsolatedFromAbove.value_or(false);
+    return operations.lookup(op)->isIsolatedFromAbove.value_or(false);
   }
 
   /// Get the set desired bytecode version to emit.
@@ -795,8 +795,58 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
     return pipelineResult;
   };
 
+  // Operations are pulled from a shared queue by the threads of the pool, so
+  // an operation that is much larger than the others leaves the remaining
+  // threads idle if it is started last. Schedule the operations by decreasing
+  // number of nested operations, which keeps the threads busy until the end.
+  SmallVector<unsigned> schedule =
+      llvm::to_vector(llvm::seq<unsigned>(0, opInfos.size()));
+  llvm::ThreadPool &threadPool = context->getThreadPool();
+  if (opInfos.size() > threadPool.getThreadCount()) {
+    SmallVector<size_t> opSizes;
+    opSizes.reserve(opInfos.size());
+    for (OpPMInfo &opInfo : opInfos) {
+      size_t numOps = 0;
+      opInfo.op->walk([&](Operation *) { ++numOps; });
+      opSizes.push_back(numOps);
+    }
+    llvm::stable_sort(schedule, [&](unsigned lhs, unsigned rhs) {
+      return opSizes[lhs] > opSizes[rhs];
+    });
+  }
+
+  // Process the operations in the order of the schedule. Diagnostics are still
+  // ordered by the position of the operations within the IR.
+  ParallelDiagnosticHandler diagHandler(context);
+  std::atomic<unsigned> curIndex(0);
+  std::atomic<bool> processingFailed(false);
+  auto scheduleFn = [&] {
+    while (!processingFailed) {
+      unsigned index = curIndex++;
+      if (index >= schedule.size())
+        break;
+      unsigned opIndex = schedule[index];
+      diagHandler.setOrderIDForThread(opIndex);
+      if (failed(processFn(opInfos[opIndex])))
+        processingFailed = true;
+      diagHandler.eraseOrderIDForThread();
+    }
+  };
+  size_t numActions =
+      std::min<size_t>(opInfos.size(), threadPool.getThreadCount());
+  if (numActions <= 1) {
+    scheduleFn();
+  } else {
+    // If the current thread is a worker thread from the pool, waiting for the
+    // task group lets it participate in processing the operations.
+    llvm::ThreadPoolTaskGroup tasksGroup(threadPool);
+    for (size_t i = 0; i < numActions; ++i)
+      tasksGroup.async(scheduleFn);
+    tasksGroup.wait();
+  }
+
   // Signal a failure if any of the executors failed.
-  if (failed(failableParallelForEach(context, opInfos, processFn)))
+  if (processingFailed)
     signalPassFailure();
 }
 
@@ -170,6 +170,10 @@ public:
   void reverse();
 
 protected:
+  /// Remove all trailing nullptr from `list`. This is done eagerly, such that
+  /// the last element of a non-empty list is always a valid operation.
+  void removeTrailingNullptr();
+
   /// The worklist of operations.
   std::vector<Operation *> list;
 
@@ -185,31 +189,26 @@ void Worklist::clear() {
 }
 
 bool Worklist::empty() const {
-  // Skip all nullptr.
-  return !llvm::any_of(list,
-                       [](Operation *op) { return static_cast<bool>(op); });
+  // Trailing nullptr are removed eagerly, so there is a valid operation on the
+  // worklist if the list is non-empty.
+  return list.empty();
 }
 
 void Worklist::push(Operation *op) {
   assert(op && "cannot push nullptr to worklist");
   // Check to see if the worklist already contains this op.
-  if (map.count(op))
+  if (!map.try_emplace(op, list.size()).second)
     return;
-  map[op] = list.size();
   list.push_back(op);
 }
 
 Operation *Worklist::pop() {
   assert(!empty() && "cannot pop from empty worklist");
-  // Skip and remove all trailing nullptr.
-  while (!list.back())
-    list.pop_back();
   Operation *op = list.back();
+  assert(op && "expected trailing nullptr to be removed");
   list.pop_back();
   map.erase(op);
-  // Cleanup: Remove all trailing nullptr.
-  while (!list.empty() && !list.back())
-    list.pop_back();
+  removeTrailingNullptr();
   return op;
 }
 
@@ -220,13 +219,21 @@ void Worklist::remove(Operation *op) {
     assert(list[it->second] == op && "malformed worklist data structure");
     list[it->second] = nullptr;
     map.erase(it);
+    removeTrailingNullptr();
   }
 }
 
 void Worklist::reverse() {
   std::reverse(list.begin(), list.end());
+  removeTrailingNullptr();
   for (size_t i = 0, e = list.size(); i != e; ++i)
-    map[list[i]] = i;
+    if (list[i])
+      map[list[i]] = i;
+}
+
+void Worklist::removeTrailingNullptr() {
+  while (!list.empty() && !list.back())
+    list.pop_back();
 }
 
 #ifdef MLIR_GREEDY_REWRITE_RANDOMIZER_SEED
@@ -249,9 +256,11 @@ public:
       op = list[pos];
       list.erase(list.begin() + pos);
       for (int64_t i = pos, e = list.size(); i < e; ++i)
-        map[list[i]] = i;
+        if (list[i])
+          map[list[i]] = i;
       map.erase(op);
     } while (!op);
+    removeTrailingNullptr();
     return op;
   }
 
@@ -80,3 +80,42 @@ TEST(Bytecode, MultiModuleWithResource) {
   checkResourceAttribute(*module);
   checkResourceAttribute(*roundTripModule);
 }
+
+StringLiteral IRWithIsolatedRegions = R"(
+module {
+  module @first attributes {test.value = 1 : i32} {
+    module @nested {}
+  }
+  module @second attributes {test.value = "second"} {}
+  module @third attributes {test.value = 1 : i32} {
+    module @nested attributes {test.value = 3.0 : f32} {}
+  }
+}
+)";
+
+TEST(Bytecode, ParallelEncodingIsDeterministic) {
+  // Write the module with the given multithreading setting, isolated regions
+  // are encoded in parallel when it is enabled.
+  auto writeModule = [](bool enableThreading, std::string &buffer) {
+    MLIRContext context;
+    context.disableMultithreading(!enableThreading);
+    ParserConfig parseConfig(&context);
+    OwningOpRef<Operation *> module =
+        parseSourceString<Operation *>(IRWithIsolatedRegions, parseConfig);
+    ASSERT_TRUE(module);
+
+    llvm::raw_string_ostream ostream(buffer);
+    ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), ostream)));
+    ostream.flush();
+
+    // Check that the bytecode can be read back.
+    OwningOpRef<Operation *> roundTripModule =
+        parseSourceString<Operation *>(buffer, parseConfig);
+    ASSERT_TRUE(roundTripModule);
+  };
+
+  std::string serialBuffer, parallelBuffer;
+  writeModule(/*enableThreading=*/false, serialBuffer);
+  writeModule(/*enableThreading=*/true, parallelBuffer);
+  EXPECT_EQ(serialBuffer, parallelBuffer);
+}
@@ -1367,6 +1367,16 @@ static void __kmp_stg_print_task_stealing(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_task_stealing_constraint);
 } // __kmp_stg_print_task_stealing
 
+static void __kmp_stg_parse_task_steal_locality(char const *name,
+                                                char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_task_steal_locality);
+} // __kmp_stg_parse_task_steal_locality
+
+static void __kmp_stg_print_task_steal_locality(kmp_str_buf_t *buffer,
+                                                char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_task_steal_locality);
+} // __kmp_stg_print_task_steal_locality
+
 static void __kmp_stg_parse_max_active_levels(char const *name,
                                               char const *value, void *data) {
   kmp_uint64 tmp_dflt = 0;
@@ -5531,6 +5541,8 @@ static kmp_setting_t __kmp_stg_table[] = {
      0},
     {"KMP_TASK_STEALING_CONSTRAINT", __kmp_stg_parse_task_stealing,
      __kmp_stg_print_task_stealing, NULL, 0, 0},
+    {"KMP_TASK_STEAL_LOCALITY", __kmp_stg_parse_task_steal_locality,
+     __kmp_stg_print_task_steal_locality, NULL, 0, 0},
     {"OMP_MAX_ACTIVE_LEVELS", __kmp_stg_parse_max_active_levels,
      __kmp_stg_print_max_active_levels, NULL, 0, 0},
     {"OMP_DEFAULT_DEVICE", __kmp_stg_parse_default_device,
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "kmp.h"
+#include "kmp_affinity.h"
 #include "kmp_i18n.h"
 #include "kmp_itt.h"
 #include "kmp_stats.h"
@@ -3204,6 +3205,66 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
+#if KMP_AFFINITY_SUPPORTED
+// __kmp_threads_share_hw_unit: check whether both threads are bound inside the
+// same topology unit of the given type. Topology sub ids are relative to the
+// parent unit, so every level down to the requested one has to match.
+static bool __kmp_threads_share_hw_unit(const kmp_info_t *thr1,
+                                        const kmp_info_t *thr2, kmp_hw_t type) {
+  int level = __kmp_topology->get_level(type);
+  if (level < 0)
+    return false;
+  for (int i = 0; i <= level; ++i) {
+    kmp_hw_t t = __kmp_topology->get_type(i);
+    int id = thr1->th.th_topology_ids[t];
+    if (id < 0 || id != thr2->th.th_topology_ids[t])
+      return false;
+  }
+  return true;
+}
+#endif
+
+// Number of random candidates looked at when picking a steal victim with
+// KMP_TASK_STEAL_LOCALITY enabled.
+#define KMP_STEAL_LOCALITY_DRAWS 4
+
+// __kmp_get_random_victim: pick a random thread other than tid to steal from.
+// When stealing is locality aware and the machine topology is known, a few
+// candidates are drawn and the first one sharing the last level cache is
+// taken, else the first one sharing the NUMA node, else the first draw. This
+// keeps remote steals as a fallback without scanning the whole team.
+static kmp_int32 __kmp_get_random_victim(kmp_info_t *thread, kmp_int32 tid,
+                                         kmp_int32 nthreads,
+                                         kmp_thread_data_t *threads_data) {
+  kmp_int32 victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+  if (victim_tid >= tid) {
+    ++victim_tid; // Adjusts random distribution to exclude self
+  }
+#if KMP_AFFINITY_SUPPORTED
+  if (!__kmp_task_steal_locality || !KMP_AFFINITY_CAPABLE() ||
+      __kmp_topology == NULL || nthreads <= 2)
+    return victim_tid;
+  kmp_int32 candidate = victim_tid;
+  kmp_int32 numa_tid = -1;
+  for (int i = 0; i < KMP_STEAL_LOCALITY_DRAWS; ++i) {
+    if (i > 0) {
+      candidate = __kmp_get_random(thread) % (nthreads - 1);
+      if (candidate >= tid)
+        ++candidate;
+    }
+    const kmp_info_t *other = threads_data[candidate].td.td_thr;
+    if (__kmp_threads_share_hw_unit(thread, other, KMP_HW_LLC))
+      return candidate;
+    if (numa_tid == -1 &&
+        __kmp_threads_share_hw_unit(thread, other, KMP_HW_NUMA))
+      numa_tid = candidate;
+  }
+  if (numa_tid != -1)
+    return numa_tid;
+#endif
+  return victim_tid;
+}
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -3407,10 +3468,8 @@ static inline int __kmp_execute_tasks_template(
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
             // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
-            if (victim_tid >= tid) {
-              ++victim_tid; // Adjusts random distribution to exclude self
-            }
+            victim_tid =
+                __kmp_get_random_victim(thread, tid, nthreads, threads_data);
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
             // There is a slight chance that __kmp_enable_tasking() did not wake
@@ -3445,6 +3504,11 @@ static inline int __kmp_execute_tasks_template(
                                   is_constrained);
         }
         if (task != NULL) { // set last stolen to victim
+#if KMP_STATS_ENABLED && KMP_AFFINITY_SUPPORTED
+          if (KMP_AFFINITY_CAPABLE() && __kmp_topology &&
+              __kmp_threads_share_hw_unit(thread, other_thread, KMP_HW_NUMA))
+            KMP_COUNT_BLOCK(TASK_stolen_local);
+#endif
           if (threads_data[tid].td.td_deque_last_stolen != victim_tid) {
             threads_data[tid].td.td_deque_last_stolen = victim_tid;
             // The pre-refactored code did not try more than 1 successful new
@@ -0,0 +1,40 @@
+// RUN: %libomp-compile
+// RUN: env KMP_TASK_STEAL_LOCALITY=0 %libomp-run
+// RUN: env KMP_TASK_STEAL_LOCALITY=1 OMP_PROC_BIND=close OMP_PLACES=cores \
+// RUN:   %libomp-run
+// RUN: env KMP_TASK_STEAL_LOCALITY=1 OMP_PROC_BIND=spread %libomp-run
+
+#include <stdio.h>
+#include <omp.h>
+
+/**
+ * Check that every task runs exactly once whether or not victims for task
+ * stealing are picked by topological locality.
+ */
+
+#define NUM_TASKS 10000
+
+int main() {
+  static int executed[NUM_TASKS];
+  int i, errors = 0;
+
+#pragma omp parallel
+#pragma omp single
+  for (i = 0; i < NUM_TASKS; ++i) {
+#pragma omp task firstprivate(i)
+    {
+#pragma omp atomic
+      executed[i]++;
+    }
+  }
+
+  for (i = 0; i < NUM_TASKS; ++i)
+    if (executed[i] != 1)
+      errors++;
+  if (errors) {
+    printf("failed: %d tasks not executed exactly once\n", errors);
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
@@ -52,6 +52,8 @@
 #include "polly/MatmulOptimizer.h"
 #include "polly/Options.h"
 #include "polly/ScheduleTreeTransform.h"
+#include "polly/ScopDetectionDiagnostic.h"
+#include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLOStream.h"
 #include "polly/Support/ISLTools.h"
 #include "llvm/ADT/Sequence.h"
@@ -183,6 +185,12 @@ static cl::opt<bool>
                             "tiling (requires -polly-reschedule)"),
                    cl::init(true), cl::cat(PollyCategory));
 
+static cl::opt<unsigned> ScheduleComputeOut(
+    "polly-schedule-computeout",
+    cl::desc("Bound the scheduler by a maximal amount of computational steps "
+             "(0 means no bound)"),
+    cl::Hidden, cl::init(300000), cl::cat(PollyCategory));
+
 static cl::opt<bool> OptimizedScops(
     "polly-optimized-scops",
     cl::desc("Polly - Dump polyhedral description of Scops optimized with "
@@ -192,6 +200,8 @@ static cl::opt<bool> OptimizedScops(
 
 STATISTIC(ScopsProcessed, "Number of scops processed");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
+STATISTIC(ScopsRescheduleOutOfQuota,
+          "Number of scops the scheduler gave up on due to the computeout");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
 
 STATISTIC(NumAffineLoopsOptimized, "Number of affine loops optimized");
@@ -706,6 +716,21 @@ static void walkScheduleTreeForStatistics(isl::schedule Schedule, int Version) {
       &Version);
 }
 
+/// Report that optimizing @p S was abandoned because @p Phase ran out of the
+/// operations budget set by @p Option.
+static void emitOutOfQuotaRemark(Scop &S, OptimizationRemarkEmitter *ORE,
+                                 StringRef Phase, StringRef Option) {
+  if (!ORE)
+    return;
+  DebugLoc Begin, End;
+  getDebugLocations(getBBPairForRegion(&S.getRegion()), Begin, End);
+  ORE->emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "OutOfQuota", Begin,
+                                       S.getEntry())
+            << "SCoP not optimized: maximal number of operations exceeded "
+               "during "
+            << Phase << " (see " << Option << ")");
+}
+
 static void runIslScheduleOptimizer(
     Scop &S,
     function_ref<const Dependences &(Dependences::AnalysisLevel)> GetDeps,
@@ -760,6 +785,10 @@ static void runIslScheduleOptimizer(
   }
   if (!D.hasValidDependences()) {
     LLVM_DEBUG(dbgs() << "Dependency information not available\n");
+    // Invalid dependences are due to the dependence analysis reaching its
+    // operations limit.
+    emitOutOfQuotaRemark(S, ORE, "dependence analysis",
+                         "-polly-dependences-computeout");
     return;
   }
 
@@ -860,10 +889,24 @@ static void runIslScheduleOptimizer(
     SC = SC.set_proximity(Proximity);
     SC = SC.set_validity(Validity);
     SC = SC.set_coincidence(Validity);
-    Schedule = SC.compute_schedule();
+
+    {
+      IslMaxOperationsGuard MaxOpGuard(Ctx, ScheduleComputeOut);
+      Schedule = SC.compute_schedule();
+
+      if (MaxOpGuard.hasQuotaExceeded()) {
+        ScopsRescheduleOutOfQuota++;
+        LLVM_DEBUG(dbgs() << "Schedule optimizer calculation exceeds ISL "
+                             "quota\n");
+        emitOutOfQuotaRemark(S, ORE, "scheduling",
+                             "-polly-schedule-computeout");
+      }
+    }
+
     isl_options_set_on_error(Ctx, OnErrorStatus);
 
-    ScopsRescheduled++;
+    if (!Schedule.is_null())
+      ScopsRescheduled++;
     LLVM_DEBUG(printSchedule(dbgs(), Schedule, "After rescheduling"));
   }
 
@@ -0,0 +1,41 @@
+; RUN: opt %loadNPMPolly -passes=polly-opt-isl -polly-schedule-computeout=1 \
+; RUN:   -pass-remarks-analysis=polly-opt-isl -disable-output < %s 2>&1 \
+; RUN:   | FileCheck %s
+;
+; Give up on scheduling the SCoP once the operations limit of the scheduler
+; is exceeded, and tell the user which option controls the limit.
+;
+;    for (long i = 0; i < 1024; i++)
+;      for (long j = 0; j < 1024; j++)
+;        A[i][j] += 1.0;
+;
+; CHECK: remark: {{.*}}SCoP not optimized: maximal number of operations exceeded during scheduling (see -polly-schedule-computeout)
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+define void @computeout(ptr noalias %A) {
+entry:
+  br label %for.i
+
+for.i:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.i.latch ]
+  br label %for.j
+
+for.j:
+  %j = phi i64 [ 0, %for.i ], [ %j.next, %for.j ]
+  %arrayidx = getelementptr inbounds [1024 x double], ptr %A, i64 %i, i64 %j
+  %val = load double, ptr %arrayidx, align 8
+  %add = fadd double %val, 1.000000e+00
+  store double %add, ptr %arrayidx, align 8
+  %j.next = add nuw nsw i64 %j, 1
+  %j.cond = icmp slt i64 %j.next, 1024
+  br i1 %j.cond, label %for.j, label %for.i.latch
+
+for.i.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %i.cond = icmp slt i64 %i.next, 1024
+  br i1 %i.cond, label %for.i, label %exit
+
+exit:
+  ret void
+}
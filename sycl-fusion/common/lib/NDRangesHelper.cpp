@@ -55,11 +55,9 @@ static bool compatibleRanges(const NDRange &LHS, const NDRange &RHS) {
                                          const Indices &RHS) {
     return std::equal(LHS.begin(), LHS.begin() + Dimensions, RHS.begin());
   };
-  return (!LHS.hasSpecificLocalSize() || !RHS.hasSpecificLocalSize() ||
-          EqualIndices(LHS.getLocalSize(), RHS.getLocalSize())) &&
-         EqualIndices(LHS.getOffset(), RHS.getOffset()) &&
-         (!requireIDRemapping(LHS, RHS) ||
-          LHS.getOffset() == NDRange::AllZeros);
+  // Global offsets are handled by the remapping of the IDs.
+  return !LHS.hasSpecificLocalSize() || !RHS.hasSpecificLocalSize() ||
+         EqualIndices(LHS.getLocalSize(), RHS.getLocalSize());
 }
 
 NDRange jit_compiler::combineNDRanges(ArrayRef<NDRange> NDRanges) {
@@ -102,9 +100,10 @@ bool jit_compiler::isValidCombination(llvm::ArrayRef<NDRange> NDRanges) {
 
 bool jit_compiler::requireIDRemapping(const NDRange &LHS, const NDRange &RHS) {
   // No need to remap when all but the dimensions and the left-most components
-  // of the global size range are equal.
+  // of the global size range are equal and the offsets are equal.
   const auto &GS0 = LHS.getGlobalSize();
   const auto &GS1 = RHS.getGlobalSize();
   return LHS.getDimensions() != RHS.getDimensions() ||
-         !std::equal(GS0.begin() + 1, GS0.end(), GS1.begin() + 1);
+         !std::equal(GS0.begin() + 1, GS0.end(), GS1.begin() + 1) ||
+         LHS.getOffset() != RHS.getOffset();
 }
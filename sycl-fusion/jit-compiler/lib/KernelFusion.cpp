@@ -58,6 +58,13 @@ static bool isTargetFormatSupported(BinaryFormat TargetFormat) {
 #else  // FUSION_JIT_SUPPORT_PTX
     return false;
 #endif // FUSION_JIT_SUPPORT_PTX
+  }
+  case BinaryFormat::AMDGCN: {
+#ifdef FUSION_JIT_SUPPORT_AMDGCN
+    return true;
+#else  // FUSION_JIT_SUPPORT_AMDGCN
+    return false;
+#endif // FUSION_JIT_SUPPORT_AMDGCN
   }
   default:
     return false;
@@ -80,8 +87,7 @@ FusionResult KernelFusion::fuseKernels(
 
   if (!isValidCombination(NDRanges)) {
     return FusionResult{
-        "Cannot fuse kernels with different offsets or local sizes or "
-        "different global sizes in dimensions [2, N) and non-zero offsets"};
+        "Cannot fuse kernels with different local sizes"};
   }
 
   bool IsHeterogeneousList = jit_compiler::isHeterogeneousList(NDRanges);
@@ -97,6 +103,10 @@ FusionResult KernelFusion::fuseKernels(
     return FusionResult{"Heterogeneous ND ranges not supported for CUDA"};
   }
 
+  if (TargetFormat == BinaryFormat::AMDGCN && IsHeterogeneousList) {
+    return FusionResult{"Heterogeneous ND ranges not supported for HIP"};
+  }
+
   bool CachingEnabled = ConfigHelper::get<option::JITEnableCaching>();
   CacheKeyT CacheKey{KernelsToFuse,
                      Identities,
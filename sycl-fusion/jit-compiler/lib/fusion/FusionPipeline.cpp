@@ -40,7 +40,7 @@ static unsigned getFlatAddressSpace(Module &Mod) {
   // Ideally, we could get this information from the TargetTransformInfo, but
   // the SPIR-V backend does not yet seem to have an implementation for that.
   llvm::Triple Tri(Mod.getTargetTriple());
-  if (Tri.isNVPTX()) {
+  if (Tri.isNVPTX() || Tri.isAMDGCN()) {
     return 0;
   }
   if (Tri.isSPIRV() || Tri.isSPIR()) {
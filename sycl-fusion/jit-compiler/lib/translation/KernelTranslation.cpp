@@ -10,15 +10,25 @@
 
 #include "SPIRVLLVMTranslation.h"
 #include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 
+#if defined(FUSION_JIT_SUPPORT_AMDGCN) && !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
 using namespace jit_compiler;
 using namespace jit_compiler::translation;
 using namespace llvm;
@@ -60,12 +70,63 @@ static void restoreKernelAttributes(Module *Mod, SYCLKernelInfo &Info) {
   }
 }
 
+DenseMap<KernelTranslator::BinaryBlob, KernelTranslator::TranslatedBinary>
+KernelTranslator::translateSPIRVBinaries(std::vector<SYCLKernelInfo> &Kernels) {
+  DenseMap<BinaryBlob, TranslatedBinary> Result;
+  // Kernels stored in the same binary share the translation.
+  SmallVector<SYCLKernelInfo *> BinaryKernels;
+  DenseSet<BinaryBlob> Binaries;
+  for (auto &Kernel : Kernels) {
+    SYCLKernelBinaryInfo &BinInfo = Kernel.BinaryInfo;
+    if (BinInfo.Format == BinaryFormat::SPIRV &&
+        Binaries.insert({BinInfo.BinaryStart, BinInfo.BinarySize}).second)
+      BinaryKernels.push_back(&Kernel);
+  }
+  if (BinaryKernels.size() < 2)
+    return Result;
+
+  std::vector<TranslatedBinary> Translated(BinaryKernels.size());
+  {
+    unsigned NumThreads = std::min<unsigned>(
+        BinaryKernels.size(),
+        heavyweight_hardware_concurrency().compute_thread_count());
+    ThreadPool Pool(heavyweight_hardware_concurrency(NumThreads));
+    for (size_t I = 0; I < BinaryKernels.size(); ++I) {
+      Pool.async([&, I] {
+        // LLVM contexts must not be shared between threads.
+        LLVMContext Ctx;
+        auto ModOrError = loadSPIRVKernel(Ctx, *BinaryKernels[I]);
+        if (auto Err = ModOrError.takeError()) {
+          Translated[I].ErrMsg = toString(std::move(Err));
+          return;
+        }
+        BitcodeWriter Writer(Translated[I].Bitcode);
+        Writer.writeModule(**ModOrError);
+        Writer.writeSymtab();
+        Writer.writeStrtab();
+      });
+    }
+    Pool.wait();
+  }
+
+  for (size_t I = 0; I < BinaryKernels.size(); ++I) {
+    SYCLKernelBinaryInfo &BinInfo = BinaryKernels[I]->BinaryInfo;
+    Result[{BinInfo.BinaryStart, BinInfo.BinarySize}] =
+        std::move(Translated[I]);
+  }
+  return Result;
+}
+
 llvm::Expected<std::unique_ptr<llvm::Module>>
 KernelTranslator::loadKernels(llvm::LLVMContext &LLVMCtx,
                               std::vector<SYCLKernelInfo> &Kernels) {
   std::unique_ptr<Module> Result{nullptr};
   bool First = true;
   DenseSet<BinaryBlob> ParsedBinaries;
+  // Translating the SPIR-V binaries is the most expensive part of loading
+  // the kernels. The modules are still linked in the order of the kernels, so
+  // the result doesn't depend on the order the translations finish in.
+  auto TranslatedBinaries = translateSPIRVBinaries(Kernels);
   size_t AddressBits = 0;
   for (auto &Kernel : Kernels) {
     // FIXME: Currently, we use the front of the list.
@@ -96,6 +157,23 @@ KernelTranslator::loadKernels(llvm::LLVMContext &LLVMCtx,
         break;
       }
       case BinaryFormat::SPIRV: {
+        auto Translated = TranslatedBinaries.find(BinBlob);
+        if (Translated != TranslatedBinaries.end()) {
+          if (!Translated->second.ErrMsg.empty()) {
+            return make_error<StringError>(Translated->second.ErrMsg,
+                                           inconvertibleErrorCode());
+          }
+          auto &Bitcode = Translated->second.Bitcode;
+          auto ModOrError = parseBitcodeFile(
+              MemoryBufferRef(StringRef(Bitcode.data(), Bitcode.size()),
+                              Kernel.Name),
+              LLVMCtx);
+          if (auto Err = ModOrError.takeError()) {
+            return std::move(Err);
+          }
+          NewMod = std::move(*ModOrError);
+          break;
+        }
         auto ModOrError = loadSPIRVKernel(LLVMCtx, Kernel);
         if (auto Err = ModOrError.takeError()) {
           return std::move(Err);
@@ -191,6 +269,15 @@ llvm::Error KernelTranslator::translateKernel(SYCLKernelInfo &Kernel,
     KernelBin = *BinaryOrError;
     break;
   }
+  case BinaryFormat::AMDGCN: {
+    llvm::Expected<KernelBinary *> BinaryOrError =
+        translateToAMDGCN(Kernel, Mod, JITCtx);
+    if (auto Error = BinaryOrError.takeError()) {
+      return Error;
+    }
+    KernelBin = *BinaryOrError;
+    break;
+  }
   default: {
     return createStringError(
         inconvertibleErrorCode(),
@@ -287,3 +374,161 @@ KernelTranslator::translateToPTX(SYCLKernelInfo &KernelInfo, llvm::Module &Mod,
   return &JITCtx.emplaceKernelBinary(std::move(PTXASM), BinaryFormat::PTX);
 #endif // FUSION_JIT_SUPPORT_PTX
 }
+
+#ifdef FUSION_JIT_SUPPORT_AMDGCN
+///
+/// Find the ld.lld of the toolchain this library was installed with, i.e. in
+/// the bin directory next to the lib directory holding the library. The one
+/// on the PATH might be too old to link code objects built by this library.
+static llvm::Expected<std::string> findToolchainLLD() {
+  SmallString<256> LibDir;
+#ifndef _WIN32
+  Dl_info Info;
+  if (dladdr(reinterpret_cast<const void *>(&findToolchainLLD), &Info) &&
+      Info.dli_fname) {
+    LibDir = sys::path::parent_path(Info.dli_fname);
+  }
+#endif // _WIN32
+  if (LibDir.empty()) {
+    return createStringError(inconvertibleErrorCode(),
+                             "Failed to locate the kernel fusion library");
+  }
+  SmallString<256> BinDir{LibDir};
+  sys::path::remove_filename(BinDir);
+  sys::path::append(BinDir, "bin");
+  auto LLDOrErr = sys::findProgramByName("ld.lld", {BinDir, LibDir});
+  if (!LLDOrErr) {
+    return createStringError(LLDOrErr.getError(),
+                             "Failed to find ld.lld in %s to link the code "
+                             "object",
+                             BinDir.c_str());
+  }
+  return *LLDOrErr;
+}
+
+///
+/// The HIP runtime only loads linked code objects, so the relocatable object
+/// emitted by the backend is linked into a shared object with ld.lld, in the
+/// same way as the clang driver does it for AMDGPU.
+static llvm::Expected<std::string> linkAMDGCNCodeObject(StringRef Object) {
+  auto LLDOrErr = findToolchainLLD();
+  if (!LLDOrErr) {
+    return LLDOrErr.takeError();
+  }
+
+  SmallString<128> ObjectPath;
+  SmallString<128> CodeObjectPath;
+  int ObjectFD = -1;
+  if (auto EC = sys::fs::createTemporaryFile("fused_kernel", "o", ObjectFD,
+                                             ObjectPath)) {
+    return createStringError(EC, "Failed to create a temporary file");
+  }
+  FileRemover RemoveObject{ObjectPath};
+  {
+    raw_fd_ostream ObjectStream{ObjectFD, /*shouldClose=*/true};
+    ObjectStream << Object;
+  }
+  if (auto EC = sys::fs::createTemporaryFile("fused_kernel", "hsaco",
+                                             CodeObjectPath)) {
+    return createStringError(EC, "Failed to create a temporary file");
+  }
+  FileRemover RemoveCodeObject{CodeObjectPath};
+
+  std::string ErrorMessage;
+  StringRef Args[] = {*LLDOrErr, "-shared", ObjectPath, "-o", CodeObjectPath};
+  if (sys::ExecuteAndWait(*LLDOrErr, Args, std::nullopt, {}, 0, 0,
+                          &ErrorMessage) != 0) {
+    return createStringError(inconvertibleErrorCode(),
+                             "Failed to link the code object: %s",
+                             ErrorMessage.c_str());
+  }
+
+  auto BufferOrErr = MemoryBuffer::getFile(CodeObjectPath);
+  if (!BufferOrErr) {
+    return createStringError(BufferOrErr.getError(),
+                             "Failed to read the linked code object");
+  }
+  return (*BufferOrErr)->getBuffer().str();
+}
+#endif // FUSION_JIT_SUPPORT_AMDGCN
+
+llvm::Expected<KernelBinary *>
+KernelTranslator::translateToAMDGCN(SYCLKernelInfo &KernelInfo,
+                                    llvm::Module &Mod, JITContext &JITCtx) {
+#ifndef FUSION_JIT_SUPPORT_AMDGCN
+  (void)KernelInfo;
+  (void)Mod;
+  (void)JITCtx;
+  return createStringError(inconvertibleErrorCode(),
+                           "AMDGPU translation not supported in this build");
+#else  // FUSION_JIT_SUPPORT_AMDGCN
+  LLVMInitializeAMDGPUTargetInfo();
+  LLVMInitializeAMDGPUTarget();
+  LLVMInitializeAMDGPUAsmPrinter();
+  LLVMInitializeAMDGPUTargetMC();
+
+  static const char *TARGET_CPU_ATTRIBUTE = "target-cpu";
+  static const char *TARGET_FEATURE_ATTRIBUTE = "target-features";
+
+  std::string TargetTriple{"amdgcn-amd-amdhsa"};
+
+  std::string ErrorMessage;
+  const auto *Target =
+      llvm::TargetRegistry::lookupTarget(TargetTriple, ErrorMessage);
+
+  if (!Target) {
+    return createStringError(
+        inconvertibleErrorCode(),
+        "Failed to load and translate AMDGPU LLVM IR module with error %s",
+        ErrorMessage.c_str());
+  }
+
+  // The input kernels are compiled for a specific GPU architecture, which is
+  // recorded in their attributes. Code objects for any other architecture
+  // can't be loaded, so don't guess one.
+  auto *KernelFunc = Mod.getFunction(KernelInfo.Name);
+  if (!KernelFunc || !KernelFunc->hasFnAttribute(TARGET_CPU_ATTRIBUTE)) {
+    return createStringError(
+        inconvertibleErrorCode(),
+        "Fused kernel %s has no AMDGPU target architecture",
+        KernelInfo.Name.c_str());
+  }
+  llvm::StringRef TargetCPU =
+      KernelFunc->getFnAttribute(TARGET_CPU_ATTRIBUTE).getValueAsString();
+  llvm::StringRef TargetFeatures{""};
+  if (KernelFunc->hasFnAttribute(TARGET_FEATURE_ATTRIBUTE)) {
+    TargetFeatures =
+        KernelFunc->getFnAttribute(TARGET_FEATURE_ATTRIBUTE).getValueAsString();
+  }
+
+  auto *TargetMachine = Target->createTargetMachine(
+      TargetTriple, TargetCPU, TargetFeatures, {}, llvm::Reloc::PIC_,
+      std::nullopt, llvm::CodeGenOpt::Default);
+
+  llvm::legacy::PassManager PM;
+
+  std::string AMDObj;
+
+  {
+    llvm::raw_string_ostream ObjStream{AMDObj};
+    llvm::buffer_ostream BufferedObj{ObjStream};
+
+    if (TargetMachine->addPassesToEmitFile(PM, BufferedObj, nullptr,
+                                           llvm::CGFT_ObjectFile)) {
+      return createStringError(
+          inconvertibleErrorCode(),
+          "Failed to construct pass pipeline to emit output");
+    }
+
+    PM.run(Mod);
+    ObjStream.flush();
+  }
+
+  auto CodeObjectOrErr = linkAMDGCNCodeObject(AMDObj);
+  if (auto Error = CodeObjectOrErr.takeError()) {
+    return std::move(Error);
+  }
+  return &JITCtx.emplaceKernelBinary(std::move(*CodeObjectOrErr),
+                                     BinaryFormat::AMDGCN);
+#endif // FUSION_JIT_SUPPORT_AMDGCN
+}
@@ -10,9 +10,12 @@
 
 #include "JITContext.h"
 #include "Kernel.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/Error.h"
+#include <string>
 #include <vector>
 
 namespace jit_compiler {
@@ -32,6 +35,21 @@ private:
   /// Pair of address and size to represent a binary blob.
   using BinaryBlob = std::pair<BinaryAddress, size_t>;
 
+  ///
+  /// A SPIR-V binary translated to LLVM IR in a context of its own and
+  /// serialized as bitcode, or the error the translation failed with.
+  struct TranslatedBinary {
+    llvm::SmallVector<char, 0> Bitcode;
+    std::string ErrMsg;
+  };
+
+  ///
+  /// Translate the distinct SPIR-V binaries of Kernels concurrently, if there
+  /// is more than one. The translations of the binaries are independent, only
+  /// linking the modules has to happen in a single context.
+  static llvm::DenseMap<BinaryBlob, TranslatedBinary>
+  translateSPIRVBinaries(std::vector<SYCLKernelInfo> &Kernels);
+
   static llvm::Expected<std::unique_ptr<llvm::Module>>
   loadLLVMKernel(llvm::LLVMContext &LLVMCtx, SYCLKernelInfo &Kernel);
 
@@ -43,6 +61,10 @@ private:
 
   static llvm::Expected<KernelBinary *>
   translateToPTX(SYCLKernelInfo &Kernel, llvm::Module &Mod, JITContext &JITCtx);
+
+  static llvm::Expected<KernelBinary *>
+  translateToAMDGCN(SYCLKernelInfo &Kernel, llvm::Module &Mod,
+                    JITContext &JITCtx);
 };
 } // namespace translation
 } // namespace jit_compiler
@@ -75,7 +75,7 @@ static raw_ostream &operator<<(raw_ostream &Os, const Indices &I) {
 
 static raw_ostream &operator<<(raw_ostream &Os, const NDRange &ND) {
   return Os << ND.getDimensions() << "_" << ND.getGlobalSize() << "_"
-            << ND.getLocalSize();
+            << ND.getLocalSize() << "_" << ND.getOffset();
 }
 
 /// Will generate a unique function name so that it can be reused in further
@@ -203,9 +203,11 @@ static Value *generateNumWorkGroupsCase(IRBuilderBase &Builder,
   return Builder.getInt64(SrcNDRange.getGlobalSize()[Index] /
                           SrcNDRange.getLocalSize()[Index]);
 }
-static Value *remapGetGlobalID(IRBuilderBase &Builder,
-                               const NDRange &SrcNDRange,
-                               const NDRange &FusedNDRange, uint32_t Index) {
+/// \return the global ID in the source range without the global offset.
+static Value *remapGetGlobalIDWithoutOffset(IRBuilderBase &Builder,
+                                            const NDRange &SrcNDRange,
+                                            const NDRange &FusedNDRange,
+                                            uint32_t Index) {
   auto *GlobalLinearID = getGlobalLinearID(Builder, FusedNDRange);
   const auto getGS = [&Indices = SrcNDRange.getGlobalSize(),
                       Dimensions = SrcNDRange.getDimensions()](auto I) {
@@ -226,33 +228,44 @@ static Value *remapGetGlobalID(IRBuilderBase &Builder,
   }
 }
 
-/// global_id(0) = global_linear_id(x) / (global_size(1) * global_size(2))
-/// global_id(1) = (global_linear_id(x) / global_size(2)) % global_size(1)
-/// global_id(2) = global_linear_id(x) % global_size(2)
+/// global_id(0) = global_linear_id(x) / (global_size(1) * global_size(2)) +
+///                global_offset(0)
+/// global_id(1) = (global_linear_id(x) / global_size(2)) % global_size(1) +
+///                global_offset(1)
+/// global_id(2) = global_linear_id(x) % global_size(2) + global_offset(2)
 static Value *generateGetGlobalIDCase(IRBuilderBase &Builder,
                                       const NDRange &SrcNDRange,
                                       const NDRange &FusedNDRange,
                                       uint32_t Index) {
-  return remapGetGlobalID(Builder, SrcNDRange, FusedNDRange, Index);
+  auto *GlobalID =
+      remapGetGlobalIDWithoutOffset(Builder, SrcNDRange, FusedNDRange, Index);
+  const auto Offset =
+      SrcNDRange.getOffset()[mirror(SrcNDRange.getDimensions(), Index)];
+  if (Offset == 0) {
+    return GlobalID;
+  }
+  return Builder.CreateAdd(GlobalID, Builder.getInt64(Offset));
 }
 
-/// local_id(x) = global_id(x) % local_size(x)
+/// local_id(x) = (global_id(x) - global_offset(x)) % local_size(x)
 static Value *generateGetLocalIDCase(IRBuilderBase &Builder,
                                      const NDRange &SrcNDRange,
                                      const NDRange &FusedNDRange,
                                      uint32_t Index) {
-  auto *GlobalID = remapGetGlobalID(Builder, SrcNDRange, FusedNDRange, Index);
+  auto *GlobalID =
+      remapGetGlobalIDWithoutOffset(Builder, SrcNDRange, FusedNDRange, Index);
   return Builder.CreateURem(GlobalID,
                             Builder.getInt64(SrcNDRange.getLocalSize()[mirror(
                                 SrcNDRange.getDimensions(), Index)]));
 }
 
-/// group_id(x) = global_id(x) / local_size(x)
+/// group_id(x) = (global_id(x) - global_offset(x)) / local_size(x)
 static Value *generateGetGroupIDCase(IRBuilderBase &Builder,
                                      const NDRange &SrcNDRange,
                                      const NDRange &FusedNDRange,
                                      uint32_t Index) {
-  auto *GlobalID = remapGetGlobalID(Builder, SrcNDRange, FusedNDRange, Index);
+  auto *GlobalID =
+      remapGetGlobalIDWithoutOffset(Builder, SrcNDRange, FusedNDRange, Index);
   return Builder.CreateUDiv(GlobalID,
                             Builder.getInt64(SrcNDRange.getLocalSize()[mirror(
                                 SrcNDRange.getDimensions(), Index)]));
@@ -449,9 +462,12 @@ getOrCreateGetGlobalLinearIDFunction(Module *M, const NDRange &FusedNDRange) {
     const auto GetGS = [&FusedNDRange](std::size_t I) {
       return FusedNDRange.getGlobalSize()[I];
     };
-    const auto GetID = [&Builder, Dimensions](uint32_t I) {
-      return createSPIRVCall(Builder, GetGlobalIDName,
-                             Builder.getInt32(mirror(Dimensions, I)));
+    // The linear ID doesn't include the global offset of the fused kernel.
+    const auto GetID = [&Builder, &FusedNDRange, Dimensions](uint32_t I) {
+      auto *ID = createSPIRVCall(Builder, GetGlobalIDName,
+                                 Builder.getInt32(mirror(Dimensions, I)));
+      const auto Offset = FusedNDRange.getOffset()[I];
+      return Offset == 0 ? ID : Builder.CreateSub(ID, Builder.getInt64(Offset));
     };
     switch (Dimensions) {
     case 1:
@@ -11,6 +11,7 @@
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicsAMDGPU.h"
 #include "llvm/IR/IntrinsicsNVPTX.h"
 #include "llvm/TargetParser/Triple.h"
 
@@ -284,6 +285,53 @@ public:
 };
 #endif // FUSION_JIT_SUPPORT_PTX
 
+//
+// AMDGCNTargetFusionInfo
+//
+#ifdef FUSION_JIT_SUPPORT_AMDGCN
+class AMDGCNTargetFusionInfo : public TargetFusionInfoImpl {
+public:
+  using TargetFusionInfoImpl::TargetFusionInfoImpl;
+
+  void addKernelFunction(Function *KernelFunc) const override {
+    KernelFunc->setCallingConv(CallingConv::AMDGPU_KERNEL);
+  }
+
+  ArrayRef<StringRef> getKernelMetadataKeys() const override {
+    static SmallVector<StringRef> Keys{{"kernel_arg_buffer_location",
+                                        "kernel_arg_runtime_aligned",
+                                        "kernel_arg_exclusive_ptr"}};
+    return Keys;
+  }
+
+  ArrayRef<StringRef> getUniformKernelAttributes() const override {
+    static SmallVector<StringRef> Keys{
+        {"target-cpu", "target-features", "uniform-work-group-size"}};
+    return Keys;
+  }
+
+  void createBarrierCall(IRBuilderBase &Builder,
+                         int BarrierFlags) const override {
+    if (BarrierFlags == -1) {
+      return;
+    }
+    // Emit the same sequence as HIP's __syncthreads(): the work-group scoped
+    // fences order the memory accesses around the llvm.amdgcn.s.barrier.
+    auto WorkGroupScope =
+        LLVMMod->getContext().getOrInsertSyncScopeID("workgroup");
+    Builder.CreateFence(AtomicOrdering::Release, WorkGroupScope);
+    Builder.CreateIntrinsic(Intrinsic::AMDGCNIntrinsics::amdgcn_s_barrier, {},
+                            {});
+    Builder.CreateFence(AtomicOrdering::Acquire, WorkGroupScope);
+  }
+
+  // Corresponds to the definitions in the LLVM AMDGPU backend user guide:
+  // https://llvm.org/docs/AMDGPUUsage.html#address-spaces
+  unsigned getPrivateAddressSpace() const override { return 5; }
+  unsigned getLocalAddressSpace() const override { return 3; }
+};
+#endif // FUSION_JIT_SUPPORT_AMDGCN
+
 } // anonymous namespace
 
 //
@@ -298,6 +346,12 @@ TargetFusionInfo::TargetFusionInfo(llvm::Module *Mod) {
     return;
   }
 #endif // FUSION_JIT_SUPPORT_PTX
+#ifdef FUSION_JIT_SUPPORT_AMDGCN
+  if (Tri.isAMDGCN()) {
+    Impl = std::make_shared<AMDGCNTargetFusionInfo>(Mod);
+    return;
+  }
+#endif // FUSION_JIT_SUPPORT_AMDGCN
   if (Tri.isSPIRV() || Tri.isSPIR()) {
     Impl = std::make_shared<SPIRVTargetFusionInfo>(Mod);
     return;
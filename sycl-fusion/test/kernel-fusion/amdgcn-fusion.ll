@@ -0,0 +1,48 @@
+; REQUIRES: hip_amd
+; RUN: opt -load-pass-plugin %shlibdir/SYCLKernelFusion%shlibext \
+; RUN:   -passes=sycl-kernel-fusion -sycl-info-path %S/Inputs/amdgcn-kernels.yaml \
+; RUN:   -S %s | FileCheck %s
+
+; Check that the kernels fused for AMDGCN use the amdgpu_kernel calling
+; convention, keep the uniform target attributes of the input kernels and are
+; separated by the work-group barrier sequence of __syncthreads().
+
+target datalayout = "e-p:64:64-p1:64:64-p2:32:32-p3:32:32-p4:64:64-p5:32:32-p6:32:32-p7:160:256:256:32-p8:128:128-i64:64-v16:16-v24:32-v32:32-v48:64-v96:128-v192:256-v256:256-v512:512-v1024:1024-v2048:2048-n32:64-S32-A5-G1-ni:7:8"
+target triple = "amdgcn-amd-amdhsa"
+
+define amdgpu_kernel void @KernelOne(ptr addrspace(1) %out) #0 {
+entry:
+  store i32 1, ptr addrspace(1) %out
+  ret void
+}
+
+define amdgpu_kernel void @KernelTwo(ptr addrspace(1) %out) #0 {
+entry:
+  store i32 2, ptr addrspace(1) %out
+  ret void
+}
+
+declare void @fused_kernel() !sycl.kernel.fused !0 !sycl.kernel.nd-range !2 !sycl.kernel.nd-ranges !5
+
+attributes #0 = { "target-cpu"="gfx90a" "uniform-work-group-size"="true" }
+
+!0 = !{!"fused_0", !1}
+!1 = !{!"KernelOne", !"KernelTwo"}
+!2 = !{i32 1, !3, !4, !4}
+!3 = !{i64 64, i64 1, i64 1}
+!4 = !{i64 0, i64 0, i64 0}
+!5 = !{!2, !2}
+
+; CHECK-LABEL: define amdgpu_kernel void @fused_0(
+; CHECK-SAME: ptr addrspace(1) %KernelOne_out, ptr addrspace(1) %KernelTwo_out
+; CHECK-SAME: #[[ATTRS:[0-9]+]]
+; CHECK:        store i32 1, ptr addrspace(1) %KernelOne_out
+; CHECK-NEXT:   fence syncscope("workgroup") release
+; CHECK-NEXT:   call void @llvm.amdgcn.s.barrier()
+; CHECK-NEXT:   fence syncscope("workgroup") acquire
+; CHECK-NEXT:   store i32 2, ptr addrspace(1) %KernelTwo_out
+; CHECK-NEXT:   ret void
+
+; CHECK-NOT: @fused_kernel
+
+; CHECK: attributes #[[ATTRS]] = {{.*}}"target-cpu"="gfx90a"{{.*}}"uniform-work-group-size"="true"
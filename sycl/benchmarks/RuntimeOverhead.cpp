@@ -0,0 +1,242 @@
+//==------- RuntimeOverhead.cpp --- SYCL runtime overhead benchmarks -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// These benchmarks run the runtime on top of the mock plugin used by the unit
+// tests. The mock completes every command immediately, so the measured time is
+// spent in the runtime itself: the handler, the scheduler, the kernel and
+// program caches and the plugin dispatch. Pass --benchmark_format=json to get
+// machine-readable results.
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/global_handler.hpp>
+#include <detail/platform_impl.hpp>
+#include <helpers/PiMock.hpp>
+#include <helpers/TestKernel.hpp>
+#include <sycl/sycl.hpp>
+
+#include "benchmark/benchmark.h"
+
+using namespace sycl;
+
+namespace {
+
+// All benchmarks share one mock platform, which is set up on first use.
+unittest::PiMock &getMock() {
+  static unittest::PiMock Mock;
+  return Mock;
+}
+
+context &getContext() {
+  static context Ctx{getMock().getPlatform()};
+  return Ctx;
+}
+
+queue makeQueue(bool InOrder) {
+  if (InOrder)
+    return queue{getContext(), default_selector_v, property::queue::in_order{}};
+  return queue{getContext(), default_selector_v};
+}
+
+// Waiting after every submission would mostly measure the wait; waiting only
+// once the loop is done lets the number of pending commands grow without
+// bound. Wait once per this many submissions instead.
+constexpr int64_t SubmissionsPerWait = 128;
+
+void BM_SubmitSingleTask(benchmark::State &State) {
+  queue Q = makeQueue(State.range(0));
+  int64_t N = 0;
+  for (auto _ : State) {
+    Q.submit([](handler &CGH) { CGH.single_task<TestKernel<>>([] {}); });
+    if (++N % SubmissionsPerWait == 0)
+      Q.wait();
+  }
+  Q.wait();
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_SubmitSingleTask)->ArgName("in_order")->Arg(0)->Arg(1);
+
+void BM_SubmitUSMParallelFor(benchmark::State &State) {
+  queue Q = makeQueue(State.range(0));
+  int *Ptr = malloc_device<int>(1024, Q);
+  int64_t N = 0;
+  for (auto _ : State) {
+    Q.submit([&](handler &CGH) {
+      auto Kernel = [=](id<1> I) { Ptr[I] = 0; };
+      CGH.parallel_for<TestKernel<sizeof(Kernel)>>(range<1>{1024}, Kernel);
+    });
+    if (++N % SubmissionsPerWait == 0)
+      Q.wait();
+  }
+  Q.wait();
+  free(Ptr, Q);
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_SubmitUSMParallelFor)->ArgName("in_order")->Arg(0)->Arg(1);
+
+void BM_SubmitBufferAccessor(benchmark::State &State) {
+  queue Q = makeQueue(/*InOrder=*/false);
+  // Independent buffers, so that the commands don't depend on each other.
+  std::vector<buffer<int, 1>> Buffers;
+  for (int64_t I = 0; I < SubmissionsPerWait; ++I)
+    Buffers.emplace_back(range<1>{16});
+  int64_t N = 0;
+  for (auto _ : State) {
+    buffer<int, 1> &Buf = Buffers[N % SubmissionsPerWait];
+    Q.submit([&](handler &CGH) {
+      accessor Acc{Buf, CGH, write_only};
+      auto Kernel = [=] { (void)Acc; };
+      CGH.single_task<TestKernel<sizeof(Kernel)>>(Kernel);
+    });
+    if (++N % SubmissionsPerWait == 0)
+      Q.wait();
+  }
+  Q.wait();
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_SubmitBufferAccessor);
+
+void BM_SubmitHostTask(benchmark::State &State) {
+  queue Q = makeQueue(State.range(0));
+  int64_t N = 0;
+  for (auto _ : State) {
+    Q.submit([](handler &CGH) { CGH.host_task([] {}); });
+    if (++N % SubmissionsPerWait == 0)
+      Q.wait();
+  }
+  Q.wait();
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_SubmitHostTask)->ArgName("in_order")->Arg(0)->Arg(1);
+
+// Submits a chain of commands which all access the same buffer, so that the
+// scheduler has to build and walk a dependency graph of the given depth.
+void BM_SchedulerDependencyChain(benchmark::State &State) {
+  queue Q = makeQueue(/*InOrder=*/false);
+  buffer<int, 1> Buf{range<1>{16}};
+  const int64_t Depth = State.range(0);
+  for (auto _ : State) {
+    for (int64_t I = 0; I < Depth; ++I)
+      Q.submit([&](handler &CGH) {
+        accessor Acc{Buf, CGH, read_write};
+        auto Kernel = [=] { (void)Acc; };
+        CGH.single_task<TestKernel<sizeof(Kernel)>>(Kernel);
+      });
+    Q.wait();
+  }
+  State.SetItemsProcessed(State.iterations() * Depth);
+}
+BENCHMARK(BM_SchedulerDependencyChain)
+    ->ArgName("depth")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+
+// Adds command groups to a graph of the given depth which isn't waited on, so
+// the graph isn't cleaned up while it's measured. The command groups alternate
+// between the two halves of a buffer, which makes the dependency search walk
+// past the commands using the other half.
+void BM_AddCGToSubBufferGraph(benchmark::State &State) {
+  queue Q = makeQueue(/*InOrder=*/false);
+  const int64_t Depth = State.range(0);
+  constexpr int64_t Measured = 64;
+  for (auto _ : State) {
+    State.PauseTiming();
+    {
+      buffer<int, 1> Buf{range<1>{64}};
+      buffer<int, 1> Halves[] = {{Buf, id<1>{0}, range<1>{32}},
+                                 {Buf, id<1>{32}, range<1>{32}}};
+      auto Submit = [&](int64_t I) {
+        Q.submit([&](handler &CGH) {
+          accessor Acc{Halves[I % 2], CGH, read_write};
+          CGH.fill(Acc, static_cast<int>(I));
+        });
+      };
+      for (int64_t I = 0; I < Depth; ++I)
+        Submit(I);
+
+      State.ResumeTiming();
+      for (int64_t I = 0; I < Measured; ++I)
+        Submit(I);
+      State.PauseTiming();
+
+      Q.wait();
+    }
+    State.ResumeTiming();
+  }
+  State.SetItemsProcessed(State.iterations() * Measured);
+}
+BENCHMARK(BM_AddCGToSubBufferGraph)
+    ->ArgName("depth")
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(1024);
+
+// Every thread submits the same kernel to a queue of its own in a shared
+// context, so all of them look the kernel up in the same caches.
+void BM_KernelCacheLookup(benchmark::State &State) {
+  queue Q = makeQueue(/*InOrder=*/true);
+  int64_t N = 0;
+  for (auto _ : State) {
+    Q.submit([](handler &CGH) { CGH.single_task<TestKernel<>>([] {}); });
+    if (++N % SubmissionsPerWait == 0)
+      Q.wait();
+  }
+  Q.wait();
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_KernelCacheLookup)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_GraphReplay(benchmark::State &State) {
+  namespace exp_ext = ext::oneapi::experimental;
+  queue Q = makeQueue(/*InOrder=*/false);
+  exp_ext::command_graph Graph{Q.get_context(), Q.get_device()};
+  for (int64_t I = 0; I < State.range(0); ++I)
+    Graph.add([](handler &CGH) { CGH.single_task<TestKernel<>>([] {}); });
+  auto Exec = Graph.finalize();
+  for (auto _ : State) {
+    Q.ext_oneapi_graph(Exec);
+    Q.wait();
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+BENCHMARK(BM_GraphReplay)->ArgName("nodes")->RangeMultiplier(4)->Range(1, 64);
+
+// Swaps the platform cache of the runtime with Platforms under its lock.
+void swapPlatformCache(std::vector<detail::PlatformImplPtr> &Platforms) {
+  detail::GlobalHandler &GH = detail::GlobalHandler::instance();
+  const std::lock_guard<std::mutex> Guard(GH.getPlatformMapMutex());
+  GH.getPlatformCache().swap(Platforms);
+}
+
+// Platform and device discovery, which dominates the startup of short-lived
+// processes. Platforms and their devices are cached after the first query, so
+// start every iteration from an empty cache to measure discovery rather than
+// a lookup. The cache is put back afterwards so that the context and queues
+// of the other benchmarks keep matching the platform of the runtime.
+void BM_GetPlatformsAndDevices(benchmark::State &State) {
+  getMock();
+  std::vector<detail::PlatformImplPtr> Saved;
+  swapPlatformCache(Saved);
+  for (auto _ : State) {
+    for (const platform &P : platform::get_platforms())
+      benchmark::DoNotOptimize(P.get_devices());
+
+    State.PauseTiming();
+    {
+      std::vector<detail::PlatformImplPtr> Discovered;
+      swapPlatformCache(Discovered);
+    }
+    State.ResumeTiming();
+  }
+  swapPlatformCache(Saved);
+}
+BENCHMARK(BM_GetPlatformsAndDevices);
+
+} // namespace
+
+BENCHMARK_MAIN();
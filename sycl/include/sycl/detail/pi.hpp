@@ -63,6 +63,11 @@ enum TraceLevel {
 // Return true if we want to trace PI related activities.
 bool trace(TraceLevel level);
 
+// Return true if platforms should be served by the Unified Runtime plugin
+// where it supports them (SYCL_PREFER_UR=1). The plugin is not loaded at all
+// otherwise.
+bool preferUR();
+
 #ifdef __SYCL_RT_OS_WINDOWS
 // these same constants are used by pi_win_proxy_loader.dll
 // if a plugin is added here, add it there as well.
@@ -236,6 +241,10 @@ uint64_t emitFunctionBeginTrace(const char *FName);
 /// \param FName The name of the PI API call
 void emitFunctionEndTrace(uint64_t CorrelationID, const char *FName);
 
+/// \return true if subscribers listen to PI function calls with their
+/// arguments, the arguments don't need to be packed otherwise.
+bool isFunctionWithArgsTraceEnabled();
+
 /// Notifies XPTI subscribers about PI function calls and packs call arguments.
 ///
 /// \param FuncID is the API hash ID from PiApiID type trait.
@@ -0,0 +1,125 @@
+//==---------- memory_pool.hpp --- SYCL USM memory pool extension ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>       // for context
+#include <sycl/detail/export.hpp> // for __SYCL_EXPORT
+#include <sycl/device.hpp>        // for device
+#include <sycl/usm/usm_enums.hpp> // for alloc
+
+#include <cstddef> // for size_t
+#include <memory>  // for shared_ptr
+
+namespace sycl {
+inline namespace _V1 {
+
+class queue;
+
+namespace detail {
+class memory_pool_impl;
+}
+
+namespace ext::oneapi::experimental {
+
+/// A pool of USM allocations of one kind for one device of a context.
+///
+/// Memory released back to the pool is kept for later allocations of a
+/// similar size instead of being returned to the backend, which makes
+/// frequent allocations of short lived memory cheap. Allocations are rounded
+/// up to size classes, four per power of two.
+///
+/// Destroying the last copy of the pool releases all of its memory, including
+/// allocations which weren't freed yet.
+class __SYCL_EXPORT memory_pool {
+public:
+  /// The default upper bound of the memory kept in a pool for reuse.
+  static constexpr size_t DefaultMaxCachedSize = size_t{256} << 20;
+
+  /// Constructs a pool of USM allocations.
+  ///
+  /// \param SyclContext is the context the memory is allocated in.
+  /// \param SyclDevice is the device the memory is allocated for.
+  /// \param Kind is the kind of the allocations, either usm::alloc::device or
+  /// usm::alloc::shared.
+  /// \param MaxCachedSize is the maximum number of bytes kept in the pool for
+  /// reuse, memory freed beyond that is returned to the backend.
+  ///
+  /// \throw sycl::exception with errc::invalid for other kinds of
+  /// allocations.
+  memory_pool(const context &SyclContext, const device &SyclDevice,
+              usm::alloc Kind, size_t MaxCachedSize = DefaultMaxCachedSize);
+
+  /// Constructs a pool of USM allocations for the context and the device of
+  /// the queue.
+  memory_pool(const queue &SyclQueue, usm::alloc Kind,
+              size_t MaxCachedSize = DefaultMaxCachedSize);
+
+  /// Allocates memory from the pool.
+  ///
+  /// \param NumBytes is the size of the allocation.
+  /// \return a pointer to the allocated memory or nullptr if the allocation
+  /// failed.
+  void *malloc(size_t NumBytes);
+
+  template <typename T> T *malloc(size_t Count) {
+    return static_cast<T *>(malloc(Count * sizeof(T)));
+  }
+
+  /// Returns memory to the pool, it may be reused by the next allocation.
+  /// The memory must not be in use by any command which isn't complete.
+  void free(void *Ptr);
+
+  /// Returns memory to the pool once all commands submitted to the queue so
+  /// far are complete. This allows freeing memory which is still used by
+  /// the commands without waiting for them.
+  void free(void *Ptr, queue &SyclQueue);
+
+  /// Returns all the memory kept for reuse to the backend.
+  void trim();
+
+  /// \return the number of bytes allocated from the pool and not freed yet.
+  size_t get_used_size() const;
+
+  /// \return the number of bytes kept in the pool for reuse.
+  size_t get_cached_size() const;
+
+  context get_context() const;
+
+  device get_device() const;
+
+  usm::alloc get_alloc_kind() const;
+
+private:
+  std::shared_ptr<sycl::detail::memory_pool_impl> impl;
+
+  template <class Obj>
+  friend decltype(Obj::impl)
+  sycl::detail::getSyclObjImpl(const Obj &SyclObject);
+};
+
+/// Allocates device memory for commands submitted to the queue. The memory
+/// is taken from a pool owned by the queue, so it may be memory freed by
+/// async_free before, once the commands using it are complete.
+///
+/// \param SyclQueue is the queue whose commands use the memory.
+/// \param NumBytes is the size of the allocation.
+/// \return a pointer to the allocated memory or nullptr if the allocation
+/// failed.
+__SYCL_EXPORT void *async_malloc(const queue &SyclQueue, size_t NumBytes);
+
+/// Frees memory allocated by async_malloc with the same queue without
+/// blocking. The memory is reused only after the commands submitted to the
+/// queue so far are complete.
+///
+/// The memory of the queue's pool is released when the queue is destroyed.
+__SYCL_EXPORT void async_free(const queue &SyclQueue, void *Ptr);
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
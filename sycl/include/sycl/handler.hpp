@@ -318,6 +318,31 @@ checkValueRange(const T &V) {
 #endif
 }
 
+// The parameter descriptors of the kernels described by the integration
+// header can be used in constant expressions.
+template <typename KI, typename = void>
+struct HasConstexprParamDescs : std::false_type {};
+template <typename KI>
+struct HasConstexprParamDescs<
+    KI, std::void_t<std::integral_constant<int, KI::getParamDesc(0).offset>>>
+    : std::true_type {};
+
+// \return true if all parameters of the kernel are known at compile time to
+// be standard layout objects or pointers, which are passed as they are.
+template <typename KI> constexpr bool hasOnlyPlainKernelParams() {
+  if constexpr (!HasConstexprParamDescs<KI>::value) {
+    return false;
+  } else {
+    for (unsigned I = 0; I < KI::getNumParams(); ++I) {
+      kernel_param_kind_t Kind = KI::getParamDesc(I).kind;
+      if (Kind != kernel_param_kind_t::kind_std_layout &&
+          Kind != kernel_param_kind_t::kind_pointer)
+        return false;
+    }
+    return true;
+  }
+}
+
 template <typename TransformedArgType, int Dims, typename KernelType>
 class RoundedRangeKernel {
 public:
@@ -476,6 +501,23 @@ private:
                                const detail::kernel_param_desc_t *KernelArgs,
                                bool IsESIMD);
 
+  /// Sets the arguments of a kernel with only standard layout and pointer
+  /// parameters, see detail::hasOnlyPlainKernelParams, without going through
+  /// the parameter descriptors at run time.
+  template <typename KI, size_t... Is>
+  void setPlainKernelArgs(char *LambdaPtr, std::index_sequence<Is...>) {
+    (void)LambdaPtr;
+    MArgs.reserve(sizeof...(Is));
+    (setPlainKernelArg<KI, Is>(LambdaPtr), ...);
+  }
+
+  template <typename KI, size_t Index>
+  void setPlainKernelArg(char *LambdaPtr) {
+    constexpr detail::kernel_param_desc_t Desc = KI::getParamDesc(Index);
+    MArgs.emplace_back(Desc.kind, LambdaPtr + Desc.offset, Desc.info,
+                       static_cast<int>(Index));
+  }
+
   /// Extracts and prepares kernel arguments set via set_arg(s).
   void extractArgsAndReqs();
 
@@ -823,9 +865,14 @@ private:
     if (KernelHasName) {
       // TODO support ESIMD in no-integration-header case too.
       MArgs.clear();
-      extractArgsAndReqsFromLambda(reinterpret_cast<char *>(KernelPtr),
-                                   KI::getNumParams(), &KI::getParamDesc(0),
-                                   KI::isESIMD());
+      if constexpr (detail::hasOnlyPlainKernelParams<KI>())
+        setPlainKernelArgs<KI>(
+            reinterpret_cast<char *>(KernelPtr),
+            std::make_index_sequence<KI::getNumParams()>{});
+      else
+        extractArgsAndReqsFromLambda(reinterpret_cast<char *>(KernelPtr),
+                                     KI::getNumParams(), &KI::getParamDesc(0),
+                                     KI::isESIMD());
       MKernelName = KI::getName();
     } else {
       // In case w/o the integration header it is necessary to process
@@ -1095,7 +1142,9 @@ private:
 
     // Check if rounding parameters have been set through environment:
     // SYCL_PARALLEL_FOR_RANGE_ROUNDING_PARAMS=MinRound:PreferredRound:MinRange
-    this->GetRangeRoundingSettings(MinFactorX, GoodFactorX, MinRangeX);
+    // Otherwise the preferred factor is derived from the device.
+    this->GetRangeRoundingSettings(NumWorkItems[0], MinFactorX, GoodFactorX,
+                                   MinRangeX);
 
     // Disable the rounding-up optimizations under these conditions:
     // 1. The env var SYCL_DISABLE_PARALLEL_FOR_RANGE_ROUNDING is set.
@@ -3268,6 +3317,14 @@ private:
   void GetRangeRoundingSettings(size_t &MinFactor, size_t &GoodFactor,
                                 size_t &MinRange);
 
+  /// Reads the range rounding parameters of a parallel_for over \p Range
+  /// work-items in its first dimension. Unless they are set with
+  /// SYCL_PARALLEL_FOR_RANGE_ROUNDING_PARAMS, only \p GoodFactor is changed
+  /// and it is derived from the device. The overload above is kept for
+  /// applications built against older headers.
+  void GetRangeRoundingSettings(size_t Range, size_t &MinFactor,
+                                size_t &GoodFactor, size_t &MinRange);
+
   template <typename WrapperT, typename TransformedArgType, int Dims,
             typename KernelType,
             std::enable_if_t<detail::KernelLambdaHasKernelHandlerArgT<
@@ -743,6 +743,35 @@ build(const kernel_bundle<bundle_state::input> &InputBundle,
   return build(InputBundle, InputBundle.get_devices(), PropList);
 }
 
+/////////////////////////
+// prebuild_kernels API
+/////////////////////////
+
+namespace ext::oneapi::experimental {
+
+/// Starts building the programs of all kernels of the application for all
+/// devices of the context Ctx in background threads. Kernel submissions to the
+/// context use the built programs or wait for the builds in progress.
+__SYCL_EXPORT void prebuild_kernels(const context &Ctx);
+
+/// Starts building the programs of the kernels identified by KernelIDs for
+/// all devices of the context Ctx in background threads.
+__SYCL_EXPORT void prebuild_kernels(const context &Ctx,
+                                    const std::vector<kernel_id> &KernelIDs);
+
+template <typename KernelName> void prebuild_kernels(const context &Ctx) {
+  prebuild_kernels(Ctx, {get_kernel_id<KernelName>()});
+}
+
+/// Starts building each of the input kernel bundles for its devices in
+/// background threads. The bundles would typically only differ in the values
+/// of their specialization constants, later builds and kernel submissions
+/// with the same values use the built programs.
+__SYCL_EXPORT void prebuild_kernels(
+    const std::vector<kernel_bundle<bundle_state::input>> &Bundles);
+
+} // namespace ext::oneapi::experimental
+
 } // namespace _V1
 } // namespace sycl
 
@@ -407,6 +407,39 @@ public:
 #endif // __SYCL_USE_FALLBACK_ASSERT
   }
 
+  /// Submits a batch of command group function objects to the queue, in order
+  /// to be scheduled for execution on the device.
+  ///
+  /// The command groups are submitted in order of appearance. Submitting them
+  /// as a batch saves the per-submission overhead of the queue bookkeeping.
+  ///
+  /// \param CGFs is a vector of function objects containing command groups.
+  /// \param CodeLoc is the code location of the submit call (default argument)
+  /// \return a SYCL event object which is complete once all the submitted
+  /// command groups are complete.
+  event ext_oneapi_submit_batch(
+      const std::vector<std::function<void(handler &)>> &CGFs,
+      const detail::code_location &CodeLoc = detail::code_location::current()) {
+    detail::tls_code_loc_t TlsCodeLocCapture(CodeLoc);
+#if __SYCL_USE_FALLBACK_ASSERT
+    SubmitPostProcessF PostProcess = [this, &CodeLoc](bool IsKernel,
+                                                      bool KernelUsesAssert,
+                                                      event &E) {
+      if (IsKernel && !device_has(aspect::ext_oneapi_native_assert) &&
+          KernelUsesAssert && !device_has(aspect::accelerator)) {
+        // Fallback assert isn't supported for FPGA
+        submitAssertCapture(*this, E, /* SecondaryQueue = */ nullptr, CodeLoc);
+      }
+    };
+
+    auto Event = submit_batch_impl(CGFs, CodeLoc, &PostProcess);
+    return discard_or_return(Event);
+#else
+    auto Event = submit_batch_impl(CGFs, CodeLoc, nullptr);
+    return discard_or_return(Event);
+#endif // __SYCL_USE_FALLBACK_ASSERT
+  }
+
   /// Prevents any commands submitted afterward to this queue from executing
   /// until all commands previously submitted to this queue have entered the
   /// complete state.
@@ -2849,6 +2882,16 @@ private:
                                     const detail::code_location &CodeLoc,
                                     const SubmitPostProcessF &PostProcess);
 
+  /// A template-free version of ext_oneapi_submit_batch.
+  /// \param CGFs command group functions
+  /// \param CodeLoc code location
+  /// \param PostProcess is called for each submitted command group, may be
+  /// null
+  event
+  submit_batch_impl(const std::vector<std::function<void(handler &)>> &CGFs,
+                    const detail::code_location &CodeLoc,
+                    const SubmitPostProcessF *PostProcess);
+
   /// parallel_for_impl with a kernel represented as a lambda + range that
   /// specifies global size only.
   ///
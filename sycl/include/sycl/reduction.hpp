@@ -49,12 +49,14 @@
 #include <array>       // for array
 #include <assert.h>    // for assert
 #include <cstddef>     // for size_t
+#include <functional>  // for function
 #include <memory>      // for shared_ptr
 #include <optional>    // for nullopt
 #include <stdint.h>    // for uint32_t
 #include <string>      // for operator+
 #include <tuple>       // for _Swallow_...
 #include <type_traits> // for enable_if_t
+#include <typeinfo>    // for typeid
 #include <utility>     // for index_seq...
 #include <variant>     // for tuple
 
@@ -181,6 +183,14 @@ __SYCL_EXPORT size_t reduComputeWGSize(size_t NWorkItems, size_t MaxWGSize,
 __SYCL_EXPORT size_t reduGetPreferredWGSize(std::shared_ptr<queue_impl> &Queue,
                                             size_t LocalMemBytesPerWorkItem);
 
+/// Allocates \p Size bytes of device memory for the partial results of a
+/// reduction. The memory comes from a pool owned by the queue, so repeated
+/// reductions don't allocate memory for every submission. The memory is
+/// returned to the pool when the last reference to it is dropped, so it must
+/// be registered with the handlers of the commands using it.
+__SYCL_EXPORT std::shared_ptr<void>
+reduGetScratchMem(std::shared_ptr<queue_impl> &Queue, size_t Size);
+
 template <typename T, class BinaryOperation, bool IsOptional>
 class ReducerElement;
 
@@ -926,12 +936,32 @@ public:
     return accessor{*MOutBufPtr, CGH, sycl::read_only};
   }
 
-  template <bool IsOneWG>
+  /// Returns a pointer or an accessor to the partial sums written by the
+  /// previous kernel using getWriteMemForPartialReds.
+  template <bool UseScratchMem>
+  auto getReadMemToPreviousPartialReds(handler &CGH) const {
+    if constexpr (UseScratchMem) {
+      CGH.addReduction(MScratchPtr);
+      return static_cast<const reducer_element_type *>(MScratchPtr.get());
+    } else {
+      return getReadAccToPreviousPartialReds(CGH);
+    }
+  }
+
+  template <bool IsOneWG, bool UseScratchMem>
   auto getWriteMemForPartialReds(size_t Size, handler &CGH) {
-    // If there is only one WG we can avoid creation of temporary buffer with
+    // If there is only one WG we can avoid creation of temporary memory with
     // partial sums and write directly into user's reduction variable.
     if constexpr (IsOneWG) {
       return getUserRedVarAccess(CGH);
+    } else if constexpr (UseScratchMem) {
+      // The partial sums are only passed between the kernels of this
+      // reduction, which are ordered by explicit dependencies, so use
+      // pooled USM instead of a new buffer for every kernel.
+      MScratchPtr =
+          reduGetScratchMem(CGH.MQueue, Size * sizeof(reducer_element_type));
+      CGH.addReduction(MScratchPtr);
+      return static_cast<reducer_element_type *>(MScratchPtr.get());
     } else {
       MOutBufPtr =
           std::make_shared<buffer<reducer_element_type, 1>>(range<1>(Size));
@@ -1076,16 +1106,13 @@ public:
   // extra kernel than copy it from the host.
   auto getGroupsCounterAccDiscrete(handler &CGH) {
     queue q = createSyclObjFromImpl<queue>(CGH.MQueue);
-    device Dev = q.get_device();
-    auto Deleter = [=](auto *Ptr) { free(Ptr, q); };
-
-    std::shared_ptr<int> Counter(malloc_device<int>(1, q), Deleter);
+    std::shared_ptr<void> Counter = reduGetScratchMem(CGH.MQueue, sizeof(int));
     CGH.addReduction(Counter);
 
     auto Event = q.memset(Counter.get(), 0, sizeof(int));
     CGH.depends_on(Event);
 
-    return Counter.get();
+    return static_cast<int *>(Counter.get());
   }
 
   /// Returns the binary operation associated with the reduction.
@@ -1108,6 +1135,9 @@ private:
   // 1-dimensional always.
   std::shared_ptr<buffer<reducer_element_type, 1>> MOutBufPtr;
 
+  // Partial sums of the kernels of the multi strategy.
+  std::shared_ptr<void> MScratchPtr;
+
   BinaryOperation MBinaryOp;
   bool InitializeToIdentity;
 
@@ -2048,14 +2078,18 @@ template <> struct NDRangeReduction<reduction::strategy::basic> {
 };
 
 /// For the given 'Reductions' types pack and indices enumerating them this
-/// function either creates new temporary accessors for partial sums (if IsOneWG
-/// is false) or returns user's accessor/USM-pointer if (IsOneWG is true).
-template <bool IsOneWG, typename... Reductions, size_t... Is>
+/// function either allocates new temporary memory for partial sums (if IsOneWG
+/// is false) or returns user's accessor/USM-pointer if (IsOneWG is true). The
+/// temporary memory is pooled USM if UseScratchMem is true and a new buffer
+/// otherwise.
+template <bool IsOneWG, bool UseScratchMem, typename... Reductions,
+          size_t... Is>
 auto createReduOutAccs(size_t NWorkGroups, handler &CGH,
                        std::tuple<Reductions...> &ReduTuple,
                        std::index_sequence<Is...>) {
   return makeReduTupleT(
-      std::get<Is>(ReduTuple).template getWriteMemForPartialReds<IsOneWG>(
+      std::get<Is>(ReduTuple)
+          .template getWriteMemForPartialReds<IsOneWG, UseScratchMem>(
           NWorkGroups *
               std::tuple_element_t<Is, std::tuple<Reductions...>>::num_elements,
           CGH)...);
@@ -2308,8 +2342,8 @@ void reduCGFuncImplArray(
 namespace reduction::main_krn {
 template <class KernelName, class Accessor> struct NDRangeMulti;
 } // namespace reduction::main_krn
-template <typename KernelName, typename KernelType, int Dims,
-          typename PropertiesT, typename... Reductions, size_t... Is>
+template <typename KernelName, bool UseScratchMem, typename KernelType,
+          int Dims, typename PropertiesT, typename... Reductions, size_t... Is>
 void reduCGFuncMulti(handler &CGH, KernelType KernelFunc,
                      const nd_range<Dims> &Range, PropertiesT Properties,
                      std::tuple<Reductions...> &ReduTuple,
@@ -2347,7 +2381,8 @@ void reduCGFuncMulti(handler &CGH, KernelType KernelFunc,
 
     using Name = __sycl_reduction_kernel<reduction::MainKrn, KernelName,
                                          reduction::strategy::multi,
-                                         decltype(KernelTag)>;
+                                         decltype(KernelTag),
+                                         std::bool_constant<UseScratchMem>>;
 
     CGH.parallel_for<Name>(Range, Properties, [=](nd_item<Dims> NDIt) {
       // We can deduce IsOneWG from the tag type.
@@ -2387,10 +2422,12 @@ void reduCGFuncMulti(handler &CGH, KernelType KernelFunc,
   size_t NWorkGroups = Range.get_group_range().size();
   if (NWorkGroups == 1)
     Rest(KernelOneWGTag{},
-         createReduOutAccs<true>(NWorkGroups, CGH, ReduTuple, ReduIndices));
+         createReduOutAccs<true, UseScratchMem>(NWorkGroups, CGH, ReduTuple,
+                                                ReduIndices));
   else
     Rest(KernelMultipleWGTag{},
-         createReduOutAccs<false>(NWorkGroups, CGH, ReduTuple, ReduIndices));
+         createReduOutAccs<false, UseScratchMem>(NWorkGroups, CGH, ReduTuple,
+                                                 ReduIndices));
 }
 
 // TODO: Is this still needed?
@@ -2508,8 +2545,8 @@ void reduAuxCGFuncImplArray(
 namespace reduction::aux_krn {
 template <class KernelName, class Predicate> struct Multi;
 } // namespace reduction::aux_krn
-template <typename KernelName, typename KernelType, typename... Reductions,
-          size_t... Is>
+template <typename KernelName, typename KernelType, bool UseScratchMem,
+          typename... Reductions, size_t... Is>
 size_t reduAuxCGFunc(handler &CGH, size_t NWorkItems, size_t MaxWGSize,
                      std::tuple<Reductions...> &ReduTuple,
                      std::index_sequence<Is...> ReduIndices) {
@@ -2529,8 +2566,10 @@ size_t reduAuxCGFunc(handler &CGH, size_t NWorkItems, size_t MaxWGSize,
   auto LocalAccsTuple = makeReduTupleT(
       local_accessor<typename Reductions::reducer_element_type, 1>{WGSize,
                                                                    CGH}...);
-  auto InAccsTuple = makeReduTupleT(
-      std::get<Is>(ReduTuple).getReadAccToPreviousPartialReds(CGH)...);
+  auto InAccsTuple =
+      makeReduTupleT(std::get<Is>(ReduTuple)
+                         .template getReadMemToPreviousPartialReds<
+                             UseScratchMem>(CGH)...);
 
   auto IdentitiesTuple =
       makeReduTupleT(std::get<Is>(ReduTuple).getIdentityContainer()...);
@@ -2547,7 +2586,8 @@ size_t reduAuxCGFunc(handler &CGH, size_t NWorkItems, size_t MaxWGSize,
     associateReduAccsWithHandler(CGH, ReduTuple, AccReduIndices);
     using Name = __sycl_reduction_kernel<reduction::AuxKrn, KernelName,
                                          reduction::strategy::multi,
-                                         decltype(Predicate)>;
+                                         decltype(Predicate),
+                                         std::bool_constant<UseScratchMem>>;
     // TODO: Opportunity to parallelize across number of elements
     range<1> GlobalRange = {HasUniformWG ? NWorkItems : NWorkGroups * WGSize};
     nd_range<1> Range{GlobalRange, range<1>(WGSize)};
@@ -2576,10 +2616,12 @@ size_t reduAuxCGFunc(handler &CGH, size_t NWorkItems, size_t MaxWGSize,
   };
   if (NWorkGroups == 1)
     Rest(IsNonUsmReductionPredicate{},
-         createReduOutAccs<true>(NWorkGroups, CGH, ReduTuple, ReduIndices));
+         createReduOutAccs<true, UseScratchMem>(NWorkGroups, CGH, ReduTuple,
+                                                ReduIndices));
   else
     Rest(EmptyReductionPredicate{},
-         createReduOutAccs<false>(NWorkGroups, CGH, ReduTuple, ReduIndices));
+         createReduOutAccs<false, UseScratchMem>(NWorkGroups, CGH, ReduTuple,
+                                                 ReduIndices));
 
   return NWorkGroups;
 }
@@ -2632,17 +2674,27 @@ template <> struct NDRangeReduction<reduction::strategy::multi> {
                             " than " +
                                 std::to_string(MaxWGSize));
 
-    reduCGFuncMulti<KernelName>(CGH, KernelFunc, NDRange, Properties, ReduTuple,
-                                ReduIndices);
-    reduction::finalizeHandler(CGH);
+    // The partial sums are kept in pooled USM device memory. Devices without
+    // USM device allocations get a new buffer for every kernel instead.
+    auto Rest = [&](auto UseScratchMemTag) {
+      constexpr bool UseScratchMem = decltype(UseScratchMemTag)::value;
+      reduCGFuncMulti<KernelName, UseScratchMem>(
+          CGH, KernelFunc, NDRange, Properties, ReduTuple, ReduIndices);
+      reduction::finalizeHandler(CGH);
 
-    size_t NWorkItems = NDRange.get_group_range().size();
-    while (NWorkItems > 1) {
-      reduction::withAuxHandler(CGH, [&](handler &AuxHandler) {
-        NWorkItems = reduAuxCGFunc<KernelName, decltype(KernelFunc)>(
-            AuxHandler, NWorkItems, MaxWGSize, ReduTuple, ReduIndices);
-      });
-    } // end while (NWorkItems > 1)
+      size_t NWorkItems = NDRange.get_group_range().size();
+      while (NWorkItems > 1) {
+        reduction::withAuxHandler(CGH, [&](handler &AuxHandler) {
+          NWorkItems =
+              reduAuxCGFunc<KernelName, decltype(KernelFunc), UseScratchMem>(
+                  AuxHandler, NWorkItems, MaxWGSize, ReduTuple, ReduIndices);
+        });
+      } // end while (NWorkItems > 1)
+    };
+    if (getDeviceFromHandler(CGH).has(aspect::usm_device_allocations))
+      Rest(std::true_type{});
+    else
+      Rest(std::false_type{});
   }
 };
 
@@ -2721,6 +2773,17 @@ void reduction_parallel_for(handler &CGH, nd_range<Dims> NDRange,
 __SYCL_EXPORT uint32_t
 reduGetMaxNumConcurrentWorkGroups(std::shared_ptr<queue_impl> Queue);
 
+/// Submits a reduction over a range with one of \p NumConfigs configurations,
+/// configuration 0 is the default one. The reduction is identified by the
+/// names of its type and binary operation and by the number of work-items.
+/// \p Submit submits the reduction with the given configuration. If
+/// \p IsTrial is set, the configuration is being timed and \p Submit must
+/// return the event of the last command of the reduction.
+__SYCL_EXPORT void reduRunWithTunedConfig(
+    std::shared_ptr<queue_impl> &Queue, const char *TypeName,
+    const char *OpName, size_t NWorkItems, size_t NumConfigs,
+    const std::function<event(size_t Config, bool IsTrial)> &Submit);
+
 template <typename KernelName, reduction::strategy Strategy, int Dims,
           typename PropertiesT, typename... RestT>
 void reduction_parallel_for(handler &CGH, range<Dims> Range,
@@ -2759,55 +2822,68 @@ void reduction_parallel_for(handler &CGH, range<Dims> Range,
   size_t PrefWGSize = reduGetPreferredWGSize(CGH.MQueue, OneElemSize);
 
   size_t NWorkItems = Range.size();
-  size_t WGSize = std::min(NWorkItems, PrefWGSize);
-  size_t NWorkGroups = NWorkItems / WGSize;
-  if (NWorkItems % WGSize)
-    NWorkGroups++;
-  size_t MaxNWorkGroups = NumConcurrentWorkGroups;
-  NWorkGroups = std::min(NWorkGroups, MaxNWorkGroups);
-  size_t NDRItems = NWorkGroups * WGSize;
-  nd_range<1> NDRange{range<1>{NDRItems}, range<1>{WGSize}};
-
-  size_t PerGroup = Range.size() / NWorkGroups;
-  // Iterate through the index space by assigning contiguous chunks to each
-  // work-group, then iterating through each chunk using a stride equal to the
-  // work-group's local range, which gives much better performance than using
-  // stride equal to 1. For each of the index the given the original KernelFunc
-  // is called and the reduction value hold in \p Reducer is accumulated in
-  // those calls.
-  auto UpdatedKernelFunc = [=](auto NDId, auto &...Reducers) {
-    // Divide into contiguous chunks and assign each chunk to a Group
-    // Rely on precomputed division to avoid repeating expensive operations
-    // TODO: Some devices may prefer alternative remainder handling
-    auto Group = NDId.get_group();
-    size_t GroupId = Group.get_group_linear_id();
-    size_t NumGroups = Group.get_group_linear_range();
-    bool LastGroup = (GroupId == NumGroups - 1);
-    size_t GroupStart = GroupId * PerGroup;
-    size_t GroupEnd = LastGroup ? Range.size() : (GroupStart + PerGroup);
-
-    // Loop over the contiguous chunk
-    size_t Start = GroupStart + NDId.get_local_id(0);
-    size_t End = GroupEnd;
-    size_t Stride = NDId.get_local_range(0);
-    auto GetDelinearized = [&](size_t I) {
-      auto Id = getDelinearizedId(Range, I);
-      if constexpr (std::is_invocable_v<decltype(KernelFunc), id<Dims>,
-                                        decltype(Reducers)...>)
-        return Id;
-      else
-        // SYCL doesn't provide parallel_for accepting offset in presence of
-        // reductions, so use with_offset==false.
-        return reduction::getDelinearizedItem(Range, Id);
+  auto RunWithWGSize = [&](size_t MaxWGSize, auto StrategyToUse) {
+    size_t WGSize = std::min(NWorkItems, MaxWGSize);
+    size_t NWorkGroups = NWorkItems / WGSize;
+    if (NWorkItems % WGSize)
+      NWorkGroups++;
+    size_t MaxNWorkGroups = NumConcurrentWorkGroups;
+    NWorkGroups = std::min(NWorkGroups, MaxNWorkGroups);
+    size_t NDRItems = NWorkGroups * WGSize;
+    nd_range<1> NDRange{range<1>{NDRItems}, range<1>{WGSize}};
+
+    size_t PerGroup = Range.size() / NWorkGroups;
+    // Iterate through the index space by assigning contiguous chunks to each
+    // work-group, then iterating through each chunk using a stride equal to
+    // the work-group's local range, which gives much better performance than
+    // using stride equal to 1. For each of the index the given the original
+    // KernelFunc is called and the reduction value hold in \p Reducer is
+    // accumulated in those calls.
+    auto UpdatedKernelFunc = [=](auto NDId, auto &...Reducers) {
+      // Divide into contiguous chunks and assign each chunk to a Group
+      // Rely on precomputed division to avoid repeating expensive operations
+      // TODO: Some devices may prefer alternative remainder handling
+      auto Group = NDId.get_group();
+      size_t GroupId = Group.get_group_linear_id();
+      size_t NumGroups = Group.get_group_linear_range();
+      bool LastGroup = (GroupId == NumGroups - 1);
+      size_t GroupStart = GroupId * PerGroup;
+      size_t GroupEnd = LastGroup ? Range.size() : (GroupStart + PerGroup);
+
+      // Loop over the contiguous chunk
+      size_t Start = GroupStart + NDId.get_local_id(0);
+      size_t End = GroupEnd;
+      size_t Stride = NDId.get_local_range(0);
+      auto GetDelinearized = [&](size_t I) {
+        auto Id = getDelinearizedId(Range, I);
+        if constexpr (std::is_invocable_v<decltype(KernelFunc), id<Dims>,
+                                          decltype(Reducers)...>)
+          return Id;
+        else
+          // SYCL doesn't provide parallel_for accepting offset in presence of
+          // reductions, so use with_offset==false.
+          return reduction::getDelinearizedItem(Range, Id);
+      };
+      for (size_t I = Start; I < End; I += Stride)
+        KernelFunc(GetDelinearized(I), Reducers...);
     };
-    for (size_t I = Start; I < End; I += Stride)
-      KernelFunc(GetDelinearized(I), Reducers...);
+    if constexpr (NumArgs == 2) {
+      auto &Redu = std::get<0>(ReduTuple);
+      reduction_parallel_for<KernelName, decltype(StrategyToUse)::value>(
+          CGH, NDRange, Properties, Redu, UpdatedKernelFunc);
+    } else {
+      return std::apply(
+          [&](auto &...Reds) {
+            return reduction_parallel_for<KernelName, Strategy>(
+                CGH, NDRange, Properties, Reds..., UpdatedKernelFunc);
+          },
+          ReduTuple);
+    }
   };
   if constexpr (NumArgs == 2) {
     using Reduction = std::tuple_element_t<0, decltype(ReduTuple)>;
-    auto &Redu = std::get<0>(ReduTuple);
 
-    constexpr auto StrategyToUse = [&]() {
+    constexpr auto DefaultStrategy = [&]() {
       if constexpr (Strategy != reduction::strategy::auto_select)
         return Strategy;
 
@@ -2830,16 +2906,58 @@ void reduction_parallel_for(handler &CGH, range<Dims> Range,
       else
         return reduction::strategy::range_basic;
     }();
-
-    reduction_parallel_for<KernelName, StrategyToUse>(CGH, NDRange, Properties,
-                                                      Redu, UpdatedKernelFunc);
+    using DefaultStrategyT =
+        std::integral_constant<reduction::strategy, DefaultStrategy>;
+
+    // With SYCL_REDUCTION_AUTO_TUNE set, the runtime picks one of the
+    // configurations below: the preferred work-group size or its half or
+    // quarter, with the default strategy or, if
+    // __SYCL_REDUCTION_TUNE_STRATEGIES is defined, range_basic. The latter is
+    // opt-in, because it doubles the number of kernels compiled for each
+    // reduction.
+    constexpr size_t NumWGSizes = 3;
+#ifdef __SYCL_REDUCTION_TUNE_STRATEGIES
+    constexpr bool TuneStrategy =
+        Strategy == reduction::strategy::auto_select &&
+        DefaultStrategy != reduction::strategy::range_basic;
+#else
+    constexpr bool TuneStrategy = false;
+#endif
+    constexpr size_t NumConfigs = TuneStrategy ? 2 * NumWGSizes : NumWGSizes;
+    const char *TypeName = typeid(typename Reduction::result_type).name();
+    const char *OpName = typeid(typename Reduction::binary_operation).name();
+    reduRunWithTunedConfig(
+        CGH.MQueue, TypeName, OpName, NWorkItems, NumConfigs,
+        [&](size_t Config, bool IsTrial) {
+          size_t WGSizeShift = Config % NumWGSizes;
+          if constexpr (TuneStrategy) {
+            if (Config >= NumWGSizes) {
+              // Unlike the default strategies for fast reductions,
+              // range_basic keeps the partial results in local memory.
+              size_t BasicPrefWGSize = reduGetPreferredWGSize(
+                  CGH.MQueue, sizeof(typename Reduction::result_type));
+              using BasicStrategyT =
+                  std::integral_constant<reduction::strategy,
+                                         reduction::strategy::range_basic>;
+              RunWithWGSize(
+                  std::max<size_t>(BasicPrefWGSize >> WGSizeShift, 1),
+                  BasicStrategyT{});
+            } else {
+              RunWithWGSize(std::max<size_t>(PrefWGSize >> WGSizeShift, 1),
+                            DefaultStrategyT{});
+            }
+          } else {
+            RunWithWGSize(std::max<size_t>(PrefWGSize >> WGSizeShift, 1),
+                          DefaultStrategyT{});
+          }
+          // A trial is submitted right away to get its event.
+          if (IsTrial)
+            reduction::finalizeHandler(CGH);
+          return CGH.MLastEvent;
+        });
   } else {
-    return std::apply(
-        [&](auto &...Reds) {
-          return reduction_parallel_for<KernelName, Strategy>(
-              CGH, NDRange, Properties, Reds..., UpdatedKernelFunc);
-        },
-        ReduTuple);
+    RunWithWGSize(PrefWGSize, std::integral_constant<reduction::strategy,
+                                                     Strategy>{});
   }
 }
 } // namespace detail
@@ -38,6 +38,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -136,7 +137,9 @@ static std::mutex *PiPlatformCacheLock = new std::mutex;
 static std::unordered_map<unsigned int, _pi_mem *> *PiESimdSurfaceMap =
     new std::unordered_map<unsigned int, _pi_mem *>;
 // TODO/FIXME : Memory leak. Handle with 'piTearDown'.
-static std::mutex *PiESimdSurfaceMapLock = new std::mutex;
+// Kernels look surfaces up on every memory access, from all the threads the
+// CM emulator runs work-groups on, so lookups take the lock shared.
+static std::shared_mutex *PiESimdSurfaceMapLock = new std::shared_mutex;
 
 // To be compared with ESIMD_EMULATOR_PLUGIN_OPAQUE_DATA_VERSION in device
 // interface header file
@@ -299,7 +302,7 @@ unsigned int sycl_get_cm_surface_index(void *PtrInput) {
 // index without dependency on '_pi_image' definition
 void sycl_get_cm_buffer_params(unsigned int IndexInput, char **BaseAddr,
                                uint32_t *Width, std::mutex **BufMtxLock) {
-  std::lock_guard<std::mutex> Lock{*PiESimdSurfaceMapLock};
+  std::shared_lock<std::shared_mutex> Lock{*PiESimdSurfaceMapLock};
   auto MemIter = PiESimdSurfaceMap->find(IndexInput);
 
   assert(MemIter != PiESimdSurfaceMap->end() && "Invalid Surface Index");
@@ -317,7 +320,7 @@ void sycl_get_cm_buffer_params(unsigned int IndexInput, char **BaseAddr,
 void sycl_get_cm_image_params(unsigned int IndexInput, char **BaseAddr,
                               uint32_t *Width, uint32_t *Height, uint32_t *Bpp,
                               std::mutex **ImgMtxLock) {
-  std::lock_guard<std::mutex> Lock{*PiESimdSurfaceMapLock};
+  std::shared_lock<std::shared_mutex> Lock{*PiESimdSurfaceMapLock};
   auto MemIter = PiESimdSurfaceMap->find(IndexInput);
   assert(MemIter != PiESimdSurfaceMap->end() && "Invalid Surface Index");
 
@@ -1113,7 +1116,7 @@ pi_result piMemBufferCreate(pi_context Context, pi_mem_flags Flags, size_t Size,
     return PI_ERROR_UNKNOWN;
   }
 
-  std::lock_guard<std::mutex> Lock{*PiESimdSurfaceMapLock};
+  std::lock_guard<std::shared_mutex> Lock{*PiESimdSurfaceMapLock};
   if (PiESimdSurfaceMap->find((*RetMem)->SurfaceIndex) !=
       PiESimdSurfaceMap->end()) {
     PiTrace("Failure from CM-managed buffer creation");
@@ -1144,7 +1147,7 @@ pi_result piMemRelease(pi_mem Mem) {
 
   if (--(Mem->RefCount) == 0) {
     // Removing Surface-map entry
-    std::lock_guard<std::mutex> Lock{*PiESimdSurfaceMapLock};
+    std::lock_guard<std::shared_mutex> Lock{*PiESimdSurfaceMapLock};
     auto MapEntryIt = PiESimdSurfaceMap->find(Mem->SurfaceIndex);
     if (MapEntryIt == PiESimdSurfaceMap->end()) {
       PiTrace("Failure from Buffer/Image deletion");
@@ -1311,7 +1314,7 @@ pi_result piMemImageCreate(pi_context Context, pi_mem_flags Flags,
     return PI_ERROR_UNKNOWN;
   }
 
-  std::lock_guard<std::mutex> Lock{*PiESimdSurfaceMapLock};
+  std::lock_guard<std::shared_mutex> Lock{*PiESimdSurfaceMapLock};
   if (PiESimdSurfaceMap->find((*RetImage)->SurfaceIndex) !=
       PiESimdSurfaceMap->end()) {
     PiTrace("Failure from CM-managed image creation");
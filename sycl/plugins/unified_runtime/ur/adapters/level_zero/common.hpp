@@ -442,7 +442,11 @@ public:
   // Whether user has requested Import/Release for buffers.
   bool Enabled;
 
-  ZeUSMImportExtension() : Supported{false}, Enabled{false} {}
+  // Whether buffers with an imported host ptr are accessed by the devices
+  // in place, instead of being copied to device allocations.
+  bool InPlace;
+
+  ZeUSMImportExtension() : Supported{false}, Enabled{false}, InPlace{false} {}
 
   void setZeUSMImport(ur_platform_handle_t_ *Platform);
   void doZeUSMImport(ze_driver_handle_t DriverHandle, void *HostPtr,
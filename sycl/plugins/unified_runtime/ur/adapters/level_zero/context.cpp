@@ -7,9 +7,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <atomic>
 #include <climits>
 #include <mutex>
 #include <string.h>
+#include <unordered_map>
 
 #include "context.hpp"
 #include "ur_level_zero.hpp"
@@ -389,22 +391,45 @@ ur_platform_handle_t ur_context_handle_t_::getPlatform() const {
   return Devices[0]->Platform;
 }
 
+// Contexts for which some thread has event caches, by their UniqueId. The
+// exiting threads look the contexts up here to find out whether they can still
+// return their events. These are never destroyed since threads may exit after
+// the static objects are destroyed.
+static ur_mutex &getLiveContextsMutex() {
+  static ur_mutex *Mutex = new ur_mutex;
+  return *Mutex;
+}
+
+static std::unordered_map<uint64_t, ur_context_handle_t_ *> &getLiveContexts() {
+  static auto *LiveContexts =
+      new std::unordered_map<uint64_t, ur_context_handle_t_ *>;
+  return *LiveContexts;
+}
+
+static void unregisterLiveContext(uint64_t ContextId) {
+  std::scoped_lock<ur_mutex> Lock(getLiveContextsMutex());
+  getLiveContexts().erase(ContextId);
+}
+
 ur_result_t ur_context_handle_t_::finalize() {
   // This function is called when ur_context_handle_t is deallocated,
   // urContextRelease. There could be some memory that may have not been
   // deallocated. For example, event and event pool caches would be still alive.
 
+  unregisterLiveContext(UniqueId);
   if (!DisableEventsCaching) {
     std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
+    for (auto &Caches : ThreadEventCaches)
+      drainThreadEventCaches(*Caches);
+    ThreadEventCaches.clear();
     for (auto &EventCache : EventCaches) {
-      for (auto &Event : EventCache) {
+      while (ur_event_handle_t Event = EventCache.pop()) {
         auto ZeResult = ZE_CALL_NOCHECK(zeEventDestroy, (Event->ZeEvent));
         // Gracefully handle the case that L0 was already unloaded.
         if (ZeResult && ZeResult != ZE_RESULT_ERROR_UNINITIALIZED)
           return ze2urResult(ZeResult);
         delete Event;
       }
-      EventCache.clear();
     }
   }
   {
@@ -528,27 +553,161 @@ ur_result_t ur_context_handle_t_::getFreeSlotInExistingOrNewPool(
   return UR_RESULT_SUCCESS;
 }
 
+void ur_context_handle_t_::event_freelist::push(ur_event_handle_t Event) {
+  Event->NextCachedEvent = Head;
+  Head = Event;
+  ++Size;
+}
+
+ur_event_handle_t ur_context_handle_t_::event_freelist::pop() {
+  ur_event_handle_t Event = Head;
+  if (!Event)
+    return nullptr;
+  Head = Event->NextCachedEvent;
+  Event->NextCachedEvent = nullptr;
+  --Size;
+  return Event;
+}
+
+void ur_context_handle_t_::event_freelist::takeFrom(event_freelist &Other,
+                                                    size_t Count) {
+  for (; Count > 0 && Other.Head; --Count)
+    push(Other.pop());
+}
+
+// Number of events moved at once between the event caches of a thread and the
+// caches of the context. A thread keeps up to twice as many events of each
+// kind. With 0, the default, all threads use the caches of the context
+// directly; the per-thread caches are experimental.
+static const size_t EventCacheBatchSize = [] {
+  const char *BatchSizeEnv = std::getenv("UR_L0_EVENTS_CACHE_BATCH_SIZE");
+  if (!BatchSizeEnv)
+    return size_t{0};
+  int Result = std::atoi(BatchSizeEnv);
+  return Result > 0 ? static_cast<size_t>(Result) : size_t{0};
+}();
+
+uint64_t ur_context_handle_t_::getNextUniqueId() {
+  static std::atomic<uint64_t> NextUniqueId{0};
+  return NextUniqueId++;
+}
+
+namespace {
+// The event caches the thread owns in the contexts it used.
+struct thread_event_caches_map {
+  std::vector<std::pair<uint64_t, ur_context_handle_t_::thread_event_caches *>>
+      Entries;
+
+  ~thread_event_caches_map() {
+    for (auto &[ContextId, Caches] : Entries)
+      ur_context_handle_t_::releaseThreadEventCaches(ContextId, Caches);
+  }
+};
+} // namespace
+
+ur_context_handle_t_::thread_event_caches &
+ur_context_handle_t_::getThreadEventCaches() {
+  thread_local thread_event_caches_map CachesMap;
+  for (auto &[ContextId, Caches] : CachesMap.Entries)
+    if (ContextId == UniqueId)
+      return *Caches;
+
+  // Drop the entries of the contexts which were released in the meantime.
+  {
+    std::scoped_lock<ur_mutex> Lock(getLiveContextsMutex());
+    auto &LiveContexts = getLiveContexts();
+    auto &Entries = CachesMap.Entries;
+    Entries.erase(std::remove_if(Entries.begin(), Entries.end(),
+                                 [&](const auto &Entry) {
+                                   return LiveContexts.count(Entry.first) == 0;
+                                 }),
+                  Entries.end());
+    LiveContexts.emplace(UniqueId, this);
+  }
+
+  auto Caches = std::make_unique<thread_event_caches>();
+  thread_event_caches *Result = Caches.get();
+  {
+    std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
+    ThreadEventCaches.push_back(std::move(Caches));
+  }
+  CachesMap.Entries.emplace_back(UniqueId, Result);
+  return *Result;
+}
+
+void ur_context_handle_t_::drainThreadEventCaches(
+    thread_event_caches &Caches) {
+  for (size_t I = 0; I < Caches.Caches.size(); ++I)
+    EventCaches[I].takeFrom(Caches.Caches[I], Caches.Caches[I].Size);
+}
+
+void ur_context_handle_t_::releaseThreadEventCaches(
+    uint64_t ContextId, thread_event_caches *Caches) {
+  // Hold the lock while using the context, so that it isn't finalized
+  // concurrently.
+  std::scoped_lock<ur_mutex> Lock(getLiveContextsMutex());
+  auto &LiveContexts = getLiveContexts();
+  auto It = LiveContexts.find(ContextId);
+  if (It == LiveContexts.end())
+    return;
+
+  ur_context_handle_t_ *Context = It->second;
+  std::scoped_lock<ur_mutex> CacheLock(Context->EventCacheMutex);
+  Context->drainThreadEventCaches(*Caches);
+  auto &Owned = Context->ThreadEventCaches;
+  Owned.erase(std::remove_if(Owned.begin(), Owned.end(),
+                             [&](const auto &Entry) {
+                               return Entry.get() == Caches;
+                             }),
+              Owned.end());
+}
+
 ur_event_handle_t
 ur_context_handle_t_::getEventFromContextCache(bool HostVisible,
                                                bool WithProfiling) {
-  std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
-  auto Cache = getEventCache(HostVisible, WithProfiling);
-  if (Cache->empty())
+  ur_event_handle_t Event = nullptr;
+  if (EventCacheBatchSize == 0) {
+    std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
+    Event = getEventCache(HostVisible, WithProfiling)->pop();
+  } else {
+    event_freelist &ThreadCache =
+        getThreadEventCaches()
+            .Caches[getEventCacheIndex(HostVisible, WithProfiling)];
+    if (!ThreadCache.Head) {
+      std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
+      ThreadCache.takeFrom(*getEventCache(HostVisible, WithProfiling),
+                           EventCacheBatchSize);
+    }
+    Event = ThreadCache.pop();
+  }
+  if (!Event)
     return nullptr;
 
-  auto It = Cache->begin();
-  ur_event_handle_t Event = *It;
-  Cache->erase(It);
   // We have to reset event before using it.
   Event->reset();
   return Event;
 }
 
 void ur_context_handle_t_::addEventToContextCache(ur_event_handle_t Event) {
-  std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
-  auto Cache =
-      getEventCache(Event->isHostVisible(), Event->isProfilingEnabled());
-  Cache->emplace_back(Event);
+  const bool HostVisible = Event->isHostVisible();
+  const bool WithProfiling = Event->isProfilingEnabled();
+  if (EventCacheBatchSize == 0) {
+    std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
+    getEventCache(HostVisible, WithProfiling)->push(Event);
+    return;
+  }
+
+  event_freelist &ThreadCache =
+      getThreadEventCaches()
+          .Caches[getEventCacheIndex(HostVisible, WithProfiling)];
+  ThreadCache.push(Event);
+  // Give a batch back so that the events released by one thread can be
+  // reused by the others.
+  if (ThreadCache.Size > 2 * EventCacheBatchSize) {
+    std::scoped_lock<ur_mutex> Lock(EventCacheMutex);
+    getEventCache(HostVisible, WithProfiling)
+        ->takeFrom(ThreadCache, EventCacheBatchSize);
+  }
 }
 
 ur_result_t
@@ -747,6 +906,8 @@ ur_result_t ur_context_handle_t_::getAvailableCommandList(
     // Make sure this is the command list type needed.
     if (UseCopyEngine != it->second.isCopy(Queue))
       continue;
+    if (ForcedCmdQueue && *ForcedCmdQueue != it->second.ZeQueue)
+      continue;
 
     ze_result_t ZeResult =
         ZE_CALL_NOCHECK(zeFenceQueryStatus, (it->second.ZeFence));
@@ -765,7 +926,8 @@ ur_result_t ur_context_handle_t_::getAvailableCommandList(
 
   // If there are no available command lists nor signalled command lists,
   // then we must create another command list.
-  ur_result = Queue->createCommandList(UseCopyEngine, CommandList);
+  ur_result =
+      Queue->createCommandList(UseCopyEngine, CommandList, ForcedCmdQueue);
   CommandList->second.ZeFenceInUse = true;
   return ur_result;
 }
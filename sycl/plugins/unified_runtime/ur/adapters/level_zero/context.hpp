@@ -7,8 +7,10 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <array>
 #include <list>
 #include <map>
+#include <memory>
 #include <stdarg.h>
 #include <string>
 #include <unordered_map>
@@ -153,11 +155,40 @@ struct ur_context_handle_t_ : _ur_object {
   // holding the current pool usage counts.
   ur_mutex ZeEventPoolCacheMutex;
 
+  // A list of cached events linked through their NextCachedEvent field, so
+  // that moving events between caches doesn't allocate.
+  struct event_freelist {
+    ur_event_handle_t Head = nullptr;
+    size_t Size = 0;
+
+    void push(ur_event_handle_t Event);
+    // Returns nullptr if the list is empty.
+    ur_event_handle_t pop();
+    // Moves up to Count events from the Other list to this one.
+    void takeFrom(event_freelist &Other, size_t Count);
+  };
+
+  // Events cached by a single thread. A thread takes events from its own
+  // caches without locking and only goes to the caches of the context, under
+  // EventCacheMutex, to move a batch of events at once.
+  struct thread_event_caches {
+    std::array<event_freelist, 4> Caches;
+  };
+
+  // Identifies the context in the thread-local lookup of the thread event
+  // caches, unlike the address of the context it is never reused.
+  const uint64_t UniqueId = getNextUniqueId();
+
   // Mutex to control operations on event caches.
   ur_mutex EventCacheMutex;
 
   // Caches for events.
-  std::vector<std::list<ur_event_handle_t>> EventCaches{4};
+  std::vector<event_freelist> EventCaches{4};
+
+  // Event caches of the threads which used this context. They are owned by
+  // the context so that their events are destroyed in finalize(). Guarded by
+  // EventCacheMutex.
+  std::vector<std::unique_ptr<thread_event_caches>> ThreadEventCaches;
 
   // Initialize the PI context.
   ur_result_t initialize();
@@ -192,6 +223,11 @@ struct ur_context_handle_t_ : _ur_object {
   // Add ur_event_handle_t to cache.
   void addEventToContextCache(ur_event_handle_t);
 
+  // Moves the events of a thread which is exiting to the caches of the
+  // context with the given UniqueId, if the context is still alive.
+  static void releaseThreadEventCaches(uint64_t ContextId,
+                                       thread_event_caches *Caches);
+
   auto getZeEventPoolCache(bool HostVisible, bool WithProfiling) {
     if (HostVisible)
       return WithProfiling ? &ZeEventPoolCache[0] : &ZeEventPoolCache[1];
@@ -234,13 +270,27 @@ struct ur_context_handle_t_ : _ur_object {
   bool isValidDevice(ur_device_handle_t Device) const;
 
 private:
-  // Get the cache of events for a provided scope and profiling mode.
-  auto getEventCache(bool HostVisible, bool WithProfiling) {
+  static uint64_t getNextUniqueId();
+
+  // Get the index of the event caches for a provided scope and profiling mode.
+  static size_t getEventCacheIndex(bool HostVisible, bool WithProfiling) {
     if (HostVisible)
-      return WithProfiling ? &EventCaches[0] : &EventCaches[1];
+      return WithProfiling ? 0 : 1;
     else
-      return WithProfiling ? &EventCaches[2] : &EventCaches[3];
+      return WithProfiling ? 2 : 3;
   }
+
+  // Get the cache of events for a provided scope and profiling mode.
+  auto getEventCache(bool HostVisible, bool WithProfiling) {
+    return &EventCaches[getEventCacheIndex(HostVisible, WithProfiling)];
+  }
+
+  // Get the event caches of the calling thread, creating them on first use.
+  thread_event_caches &getThreadEventCaches();
+
+  // Moves the events in the thread caches to the caches of the context.
+  // The caller must hold EventCacheMutex.
+  void drainThreadEventCaches(thread_event_caches &Caches);
 };
 
 // Helper function to release the context, a caller must lock the platform-level
@@ -1076,14 +1076,19 @@ void ZeUSMImportExtension::setZeUSMImport(ur_platform_handle_t_ *Platform) {
     Supported = true;
 
     // Check if env var SYCL_USM_HOSTPTR_IMPORT has been set requesting
-    // host ptr import during buffer creation.
+    // host ptr import during buffer creation. The value 2 also requests
+    // the devices to access the imported memory directly, with no copy to
+    // a device allocation.
     const char *USMHostPtrImportStr = std::getenv("SYCL_USM_HOSTPTR_IMPORT");
-    if (!USMHostPtrImportStr || std::atoi(USMHostPtrImportStr) == 0)
+    const int USMHostPtrImport =
+        USMHostPtrImportStr ? std::atoi(USMHostPtrImportStr) : 0;
+    if (USMHostPtrImport == 0)
       return;
 
     // Hostptr import/release is turned on because it has been requested
     // by the env var, and this platform supports the APIs.
     Enabled = true;
+    InPlace = USMHostPtrImport == 2;
     // Hostptr import is only possible if piMemBufferCreate receives a
     // hostptr as an argument. The SYCL runtime passes a host ptr
     // only when SYCL_HOST_UNIFIED_MEMORY is enabled. Therefore we turn it on.
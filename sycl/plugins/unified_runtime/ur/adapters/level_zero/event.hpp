@@ -206,6 +206,10 @@ struct ur_event_handle_t_ : _ur_object {
 
   bool hasExternalRefs() { return RefCountExternal != 0; }
 
+  // Link to the next released event in a cache of events of the context, see
+  // ur_context_handle_t_::event_freelist.
+  ur_event_handle_t NextCachedEvent = nullptr;
+
   // Reset ur_event_handle_t object.
   ur_result_t reset();
 
@@ -36,6 +36,101 @@ bool IsDevicePointer(ur_context_handle_t Context, const void *Ptr) {
   return (ZeMemoryAllocationProperties.type == ZE_MEMORY_TYPE_DEVICE);
 }
 
+// Copies of at least this many bytes which go to the copy engines are split
+// into chunks executed in parallel by all the copy engines of the queue,
+// the main and the link ones. Setting it to 0, the default, disables the
+// splitting.
+static const size_t SplitCopyThreshold = [] {
+  const char *SplitCopyThresholdStr = std::getenv("UR_L0_SPLIT_COPY_THRESHOLD");
+  if (!SplitCopyThresholdStr)
+    return size_t{0};
+  long long Threshold = std::atoll(SplitCopyThresholdStr);
+  return Threshold > 0 ? static_cast<size_t>(Threshold) : size_t{0};
+}();
+
+// Executes the copy as one chunk per copy engine and signals the event of the
+// copy once all of them are done. The caller must have the same locks as for
+// enqueueMemCopyHelper.
+static ur_result_t
+enqueueSplitMemCopy(ur_command_t CommandType, ur_queue_handle_t Queue,
+                    void *Dst, ur_bool_t BlockingWrite, size_t Size,
+                    const void *Src, uint32_t NumChunks,
+                    uint32_t NumEventsInWaitList,
+                    const ur_event_handle_t *EventWaitList,
+                    ur_event_handle_t *OutEvent) {
+  // Chunks are multiples of the page size, so the engines don't share pages.
+  constexpr size_t ChunkAlignment = 4096;
+  const size_t ChunkSize = ((Size + NumChunks - 1) / NumChunks +
+                            ChunkAlignment - 1) /
+                           ChunkAlignment * ChunkAlignment;
+  NumChunks = static_cast<uint32_t>((Size + ChunkSize - 1) / ChunkSize);
+
+  // All the chunks wait for the same events. Create their wait lists before
+  // any chunk becomes the last command of an in-order queue, so that the
+  // chunks don't wait for each other.
+  std::vector<_ur_ze_event_list_t> ChunkWaitLists(NumChunks);
+  for (auto &ChunkWaitList : ChunkWaitLists)
+    UR_CALL(ChunkWaitList.createAndRetainUrZeEventList(
+        NumEventsInWaitList, EventWaitList, Queue, /* UseCopyEngine */ true));
+
+  auto &QueueGroup = Queue->getQueueGroup(/* UseCopyEngine */ true);
+  std::vector<ur_event_handle_t> ChunkEvents(NumChunks);
+  for (uint32_t I = 0; I < NumChunks; ++I) {
+    const size_t Offset = I * ChunkSize;
+    const size_t Bytes = std::min(ChunkSize, Size - Offset);
+
+    // Send every chunk to the next copy engine. Immediate command lists
+    // already take turns between the engines.
+    ze_command_queue_handle_t *ForcedCmdQueue = nullptr;
+    uint32_t QueueGroupOrdinal;
+    if (!Queue->UsingImmCmdLists)
+      ForcedCmdQueue = &QueueGroup.getZeQueue(&QueueGroupOrdinal);
+
+    ur_command_list_ptr_t CommandList{};
+    UR_CALL(Queue->Context->getAvailableCommandList(
+        Queue, CommandList, /* UseCopyEngine */ true, /* AllowBatching */ false,
+        ForcedCmdQueue));
+    UR_CALL(createEventAndAssociateQueue(Queue, &ChunkEvents[I], CommandType,
+                                         CommandList, /* IsInternal */ true));
+    ChunkEvents[I]->WaitList = ChunkWaitLists[I];
+
+    const auto &WaitList = ChunkEvents[I]->WaitList;
+    ZE2UR_CALL(zeCommandListAppendMemoryCopy,
+               (CommandList->first, static_cast<char *>(Dst) + Offset,
+                static_cast<const char *>(Src) + Offset, Bytes,
+                ChunkEvents[I]->ZeEvent, WaitList.Length,
+                WaitList.ZeEventList));
+    UR_CALL(Queue->executeCommandList(CommandList, false,
+                                      /* OKToBatch */ false));
+  }
+
+  // The event of the copy is signalled by a barrier waiting for all chunks.
+  _ur_ze_event_list_t TmpWaitList;
+  UR_CALL(TmpWaitList.createAndRetainUrZeEventList(
+      NumChunks, ChunkEvents.data(), Queue, /* UseCopyEngine */ true));
+
+  ur_command_list_ptr_t CommandList{};
+  UR_CALL(Queue->Context->getAvailableCommandList(
+      Queue, CommandList, /* UseCopyEngine */ true, /* AllowBatching */ false));
+
+  ur_event_handle_t InternalEvent;
+  bool IsInternal = OutEvent == nullptr;
+  ur_event_handle_t *Event = OutEvent ? OutEvent : &InternalEvent;
+  UR_CALL(createEventAndAssociateQueue(Queue, Event, CommandType, CommandList,
+                                       IsInternal));
+  (*Event)->WaitList = TmpWaitList;
+
+  const auto &WaitList = (*Event)->WaitList;
+  ZE2UR_CALL(zeCommandListAppendBarrier,
+             (CommandList->first, (*Event)->ZeEvent, WaitList.Length,
+              WaitList.ZeEventList));
+
+  UR_CALL(Queue->executeCommandList(CommandList, BlockingWrite,
+                                    /* OKToBatch */ false));
+
+  return UR_RESULT_SUCCESS;
+}
+
 // Shared by all memory read/write/copy PI interfaces.
 // PI interfaces must have queue's and destination buffer's mutexes locked for
 // exclusive use and source buffer's mutex locked for shared use on entry.
@@ -48,6 +143,19 @@ ur_result_t enqueueMemCopyHelper(ur_command_t CommandType,
                                  bool PreferCopyEngine) {
   bool UseCopyEngine = Queue->useCopyEngine(PreferCopyEngine);
 
+  // Large copies are faster when all the copy engines work on them. Queues
+  // which reuse discarded events depend on a strict order of their commands.
+  if (UseCopyEngine && SplitCopyThreshold != 0 &&
+      Size >= SplitCopyThreshold && !Queue->doReuseDiscardedEvents()) {
+    const auto &QueueGroup = Queue->getQueueGroup(/* UseCopyEngine */ true);
+    const uint32_t NumEngines =
+        QueueGroup.UpperIndex - QueueGroup.LowerIndex + 1;
+    if (NumEngines > 1)
+      return enqueueSplitMemCopy(CommandType, Queue, Dst, BlockingWrite, Size,
+                                 Src, NumEngines, NumEventsInWaitList,
+                                 EventWaitList, OutEvent);
+  }
+
   _ur_ze_event_list_t TmpWaitList;
   UR_CALL(TmpWaitList.createAndRetainUrZeEventList(
       NumEventsInWaitList, EventWaitList, Queue, UseCopyEngine));
@@ -2330,6 +2438,12 @@ _ur_buffer::_ur_buffer(ur_context_handle_t Context, size_t Size, char *HostPtr,
       Allocations[nullptr].ZeHandle = HostPtr;
       Allocations[nullptr].Valid = true;
       Allocations[nullptr].ReleaseAction = _ur_buffer::allocation_t::unimport;
+      // The imported memory is USM host memory, which all devices of the
+      // context can access. Keeping the buffer there avoids copying large
+      // inputs to the devices, at the cost of the kernels reading them over
+      // the bus.
+      if (ZeUSMImport.InPlace)
+        OnHost = true;
     }
   }
 
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
 #include <optional>
 #include <string.h>
@@ -16,6 +17,10 @@
 #include "queue.hpp"
 #include "ur_level_zero.hpp"
 
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+#include "xpti/xpti_trace_framework.h"
+#endif
+
 /// @brief Cleanup events in the immediate lists of the queue.
 /// @param Queue Queue where events need to be cleaned up.
 /// @param QueueLocked Indicates if the queue mutex is locked by caller.
@@ -714,10 +719,16 @@ struct zeCommandListBatchConfig {
   uint32_t NumTimesClosedEarlyThreshold{3};
   uint32_t NumTimesClosedFullThreshold{8};
 
+  // If doing dynamic batching, tells to close batches based on the observed
+  // device idle time and command arrival rate, see closeBatchAdaptively().
+  bool Adaptive{false};
+
   // Tells the starting size of a batch.
   uint32_t startSize() const { return Size > 0 ? Size : DynamicSizeStart; }
   // Tells is we are doing dynamic batch size adjustment.
   bool dynamic() const { return Size == 0; }
+  // Tells if we are doing adaptive batching.
+  bool adaptive() const { return dynamic() && Adaptive; }
 };
 
 // Helper function to initialize static variables that holds batch config info
@@ -736,6 +747,13 @@ static const zeCommandListBatchConfig ZeCommandListBatchConfig(bool IsCopy) {
     PiRet = std::getenv("SYCL_PI_LEVEL_ZERO_BATCH_SIZE");
   }
   const char *BatchSizeStr = UrRet ? UrRet : (PiRet ? PiRet : nullptr);
+
+  const char *UrAdaptive = std::getenv("UR_L0_ADAPTIVE_BATCHING");
+  const char *PiAdaptive = std::getenv("SYCL_PI_LEVEL_ZERO_ADAPTIVE_BATCHING");
+  const char *AdaptiveStr =
+      UrAdaptive ? UrAdaptive : (PiAdaptive ? PiAdaptive : nullptr);
+  Config.Adaptive = AdaptiveStr && std::atoi(AdaptiveStr) != 0;
+
   if (BatchSizeStr) {
     int32_t BatchSizeStrVal = std::atoi(BatchSizeStr);
     // Level Zero may only support a limted number of commands per command
@@ -950,6 +968,8 @@ ur_queue_handle_t_::ur_queue_handle_t_(
   // Initialize compute/copy command batches.
   ComputeCommandBatch.OpenCommandList = CommandListMap.end();
   CopyCommandBatch.OpenCommandList = CommandListMap.end();
+  ComputeCommandBatch.LastSubmittedCommandList = CommandListMap.end();
+  CopyCommandBatch.LastSubmittedCommandList = CommandListMap.end();
   ComputeCommandBatch.QueueBatchSize =
       ZeCommandListBatchComputeConfig.startSize();
   CopyCommandBatch.QueueBatchSize = ZeCommandListBatchCopyConfig.startSize();
@@ -988,7 +1008,8 @@ void ur_queue_handle_t_::adjustBatchSizeForPartialBatch(bool IsCopy) {
       IsCopy ? ZeCommandListBatchCopyConfig : ZeCommandListBatchComputeConfig;
   uint32_t &QueueBatchSize = CommandBatch.QueueBatchSize;
   // QueueBatchSize of 0 means never allow batching.
-  if (QueueBatchSize == 0 || !ZeCommandListBatchConfig.dynamic())
+  if (QueueBatchSize == 0 || !ZeCommandListBatchConfig.dynamic() ||
+      ZeCommandListBatchConfig.adaptive())
     return;
   CommandBatch.NumTimesClosedEarly += 1;
 
@@ -1008,6 +1029,103 @@ void ur_queue_handle_t_::adjustBatchSizeForPartialBatch(bool IsCopy) {
   }
 }
 
+// Reports a new batch size chosen by the adaptive batching to the
+// subscribers of the "sycl" stream, e.g. sycl-trace --sycl.
+static void notifyBatchSizeChange(bool IsCopy, uint32_t QueueBatchSize) {
+  urPrint("Adaptive batching: %s batch size set to %d\n",
+          IsCopy ? "copy" : "compute", QueueBatchSize);
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  constexpr uint16_t NotificationTraceType = xpti::trace_diagnostics;
+  if (!xptiTraceEnabled())
+    return;
+  uint8_t StreamID = xptiRegisterStream("sycl");
+  if (!xptiCheckTraceEnabled(StreamID, NotificationTraceType))
+    return;
+  std::string Message = std::string("Level Zero adaptive batching: ") +
+                        (IsCopy ? "copy" : "compute") + " batch size set to " +
+                        std::to_string(QueueBatchSize);
+  xptiNotifySubscribers(StreamID, NotificationTraceType, nullptr, nullptr,
+                        xptiGetUniqueId(), Message.c_str());
+#endif
+}
+
+bool ur_queue_handle_t_::isLastSubmittedBatchDone(
+    const command_batch &CommandBatch) {
+  auto CommandList = CommandBatch.LastSubmittedCommandList;
+  if (CommandList == CommandListMap.end())
+    return true;
+  // A command list is only reset, and then possibly reopened for new
+  // commands, once its fence is signalled.
+  if (!CommandList->second.IsClosed || !CommandList->second.ZeFenceInUse)
+    return true;
+  return ZE_CALL_NOCHECK(zeFenceQueryStatus, (CommandList->second.ZeFence)) ==
+         ZE_RESULT_SUCCESS;
+}
+
+bool ur_queue_handle_t_::closeBatchAdaptively(
+    bool IsCopy, ur_command_list_ptr_t CommandList) {
+  using namespace std::chrono;
+  auto &CommandBatch = IsCopy ? CopyCommandBatch : ComputeCommandBatch;
+  auto &ZeCommandListBatchConfig =
+      IsCopy ? ZeCommandListBatchCopyConfig : ZeCommandListBatchComputeConfig;
+  uint32_t &QueueBatchSize = CommandBatch.QueueBatchSize;
+  const auto Now = steady_clock::now();
+
+  // Track the moving average of the time between two batched commands.
+  if (CommandBatch.LastAppendTime != steady_clock::time_point{}) {
+    const double Gap =
+        duration_cast<nanoseconds>(Now - CommandBatch.LastAppendTime).count();
+    CommandBatch.AvgInterArrivalNs =
+        CommandBatch.AvgInterArrivalNs == 0
+            ? Gap
+            : (CommandBatch.AvgInterArrivalNs * 7 + Gap) / 8;
+  }
+  CommandBatch.LastAppendTime = Now;
+
+  const size_t Size = CommandList->second.size();
+  const double SinceSubmitNs =
+      duration_cast<nanoseconds>(Now - CommandBatch.LastSubmitTime).count();
+
+  if (isLastSubmittedBatchDone(CommandBatch)) {
+    // The device has run out of work from this queue, so every command we
+    // hold back now delays it. Measure how long the device took for the last
+    // batch, at most, and make the batches smaller.
+    if (CommandBatch.LastSubmittedCommandList != CommandListMap.end()) {
+      CommandBatch.AvgBatchDurationNs =
+          CommandBatch.AvgBatchDurationNs == 0
+              ? SinceSubmitNs
+              : (CommandBatch.AvgBatchDurationNs * 3 + SinceSubmitNs) / 4;
+      CommandBatch.LastSubmittedCommandList = CommandListMap.end();
+    }
+    const uint32_t NewSize = std::max<uint32_t>(
+        1, std::min<uint32_t>(QueueBatchSize, static_cast<uint32_t>(Size)));
+    if (NewSize != QueueBatchSize) {
+      QueueBatchSize = NewSize;
+      notifyBatchSizeChange(IsCopy, QueueBatchSize);
+    }
+    return true;
+  }
+
+  if (Size >= QueueBatchSize) {
+    // The device is still busy with the previous batch, so larger batches
+    // save execution overhead without starving it.
+    if (QueueBatchSize < ZeCommandListBatchConfig.DynamicSizeMax) {
+      QueueBatchSize = std::min(ZeCommandListBatchConfig.DynamicSizeMax,
+                                QueueBatchSize +
+                                    ZeCommandListBatchConfig.DynamicSizeStep);
+      notifyBatchSizeChange(IsCopy, QueueBatchSize);
+    }
+    return true;
+  }
+
+  // Submit early if, at the observed rate of commands, filling the batch
+  // would take longer than the device needs to finish its current work.
+  const double FillNs =
+      CommandBatch.AvgInterArrivalNs * (QueueBatchSize - Size);
+  return CommandBatch.AvgBatchDurationNs != 0 &&
+         SinceSubmitNs + FillNs > CommandBatch.AvgBatchDurationNs;
+}
+
 ur_result_t
 ur_queue_handle_t_::executeCommandList(ur_command_list_ptr_t CommandList,
                                        bool IsBlocking, bool OKToBatchCommand) {
@@ -1068,12 +1186,19 @@ ur_queue_handle_t_::executeCommandList(ur_command_list_ptr_t CommandList,
         die("executeCommandList: OpenCommandList should be equal to"
             "null or CommandList");
 
-      if (CommandList->second.size() < CommandBatch.QueueBatchSize) {
-        CommandBatch.OpenCommandList = CommandList;
-        return UR_RESULT_SUCCESS;
-      }
+      if (ZeCommandListBatchConfig.adaptive()) {
+        if (!closeBatchAdaptively(UseCopyEngine, CommandList)) {
+          CommandBatch.OpenCommandList = CommandList;
+          return UR_RESULT_SUCCESS;
+        }
+      } else {
+        if (CommandList->second.size() < CommandBatch.QueueBatchSize) {
+          CommandBatch.OpenCommandList = CommandList;
+          return UR_RESULT_SUCCESS;
+        }
 
-      adjustBatchSizeForFullBatch(UseCopyEngine);
+        adjustBatchSizeForFullBatch(UseCopyEngine);
+      }
       CommandBatch.OpenCommandList = CommandListMap.end();
     }
   }
@@ -1207,6 +1332,10 @@ ur_queue_handle_t_::executeCommandList(ur_command_list_ptr_t CommandList,
       }
       return ze2urResult(ZeResult);
     }
+
+    auto &CommandBatch = UseCopyEngine ? CopyCommandBatch : ComputeCommandBatch;
+    CommandBatch.LastSubmittedCommandList = CommandList;
+    CommandBatch.LastSubmitTime = std::chrono::steady_clock::now();
   }
 
   // Check global control to make every command blocking for debugging.
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
 #include <list>
 #include <map>
 #include <optional>
@@ -254,6 +255,18 @@ struct ur_queue_handle_t_ : _ur_object {
     // a queue specific basis. And by putting it in the queue itself, this
     // is thread safe because of the locking of the queue that occurs.
     uint32_t QueueBatchSize = {0};
+
+    // These members are used by the adaptive batching.
+    // The command list submitted last and when it was submitted.
+    ur_command_list_ptr_t LastSubmittedCommandList{};
+    std::chrono::steady_clock::time_point LastSubmitTime{};
+    // When the last command was added to a batch.
+    std::chrono::steady_clock::time_point LastAppendTime{};
+    // Moving average of the time between two batched commands.
+    double AvgInterArrivalNs = {0};
+    // Moving average of the time from submitting a batch until we saw it
+    // completed, an upper bound of its execution time on the device.
+    double AvgBatchDurationNs = {0};
   };
 
   // ComputeCommandBatch holds data related to batching of non-copy commands.
@@ -354,6 +367,18 @@ struct ur_queue_handle_t_ : _ur_object {
   // For non-copy commands, IsCopy is set to 'false'.
   void adjustBatchSizeForPartialBatch(bool IsCopy);
 
+  // Tells if the command list of the batch which was submitted last has
+  // completed, i.e. the device has no more work from this queue.
+  bool isLastSubmittedBatchDone(const command_batch &CommandBatch);
+
+  // Used instead of the batch size adjustments above by the adaptive
+  // batching. Tells if the open batch with the just added command should be
+  // submitted now. Batches are submitted right away when the device is idle
+  // and early when they wouldn't fill up before the device runs out of work.
+  // The batch size grows while the batches fill up before the device
+  // finishes the previous one.
+  bool closeBatchAdaptively(bool IsCopy, ur_command_list_ptr_t CommandList);
+
   // Attach a command list to this queue.
   // For non-immediate commandlist also close and execute it.
   // Note that this command list cannot be appended to after this.
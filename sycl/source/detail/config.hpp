@@ -198,11 +198,13 @@ template <> class SYCLConfig<SYCL_PARALLEL_FOR_RANGE_ROUNDING_PARAMS> {
 
 private:
 public:
-  static void GetSettings(size_t &MinFactor, size_t &GoodFactor,
+  /// \return true if the parameters are set, the arguments are left
+  /// unchanged otherwise.
+  static bool GetSettings(size_t &MinFactor, size_t &GoodFactor,
                           size_t &MinRange) {
     static const char *RoundParams = BaseT::getRawValue();
     if (RoundParams == nullptr)
-      return;
+      return false;
 
     static bool ProcessedFactors = false;
     static size_t MF;
@@ -228,6 +230,7 @@ public:
     MinFactor = MF;
     GoodFactor = GF;
     MinRange = MR;
+    return true;
   }
 };
 
@@ -614,6 +617,276 @@ private:
   }
 };
 
+// With SYCL_ENABLE_ASYNC_FUSION enabled, complete_fusion enqueues the kernels
+// unfused while the fused kernel is compiled in the background. The fused
+// kernel is used for later identical fusions once it is ready.
+template <> class SYCLConfig<SYCL_ENABLE_ASYNC_FUSION> {
+  using BaseT = SYCLConfigBase<SYCL_ENABLE_ASYNC_FUSION>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// With SYCL_ENABLE_AUTO_FUSION enabled, the scheduler fuses chains of kernels
+// submitted to in-order queues without explicit fusion calls.
+template <> class SYCLConfig<SYCL_ENABLE_AUTO_FUSION> {
+  using BaseT = SYCLConfigBase<SYCL_ENABLE_AUTO_FUSION>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// With SYCL_REDUCTION_AUTO_TUNE enabled, the strategy and the work-group size
+// of reductions over a range are tuned at run time.
+template <> class SYCLConfig<SYCL_REDUCTION_AUTO_TUNE> {
+  using BaseT = SYCLConfigBase<SYCL_REDUCTION_AUTO_TUNE>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_EXECUTION_GRAPH_CLEANUP_BATCH_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_EXECUTION_GRAPH_CLEANUP_BATCH_SIZE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    const char *ValueStr = BaseT::getRawValue();
+    // By default finished commands are cleaned up right after each enqueue.
+    if (!ValueStr)
+      return 1;
+
+    int Result = 0;
+    try {
+      Result = std::stoi(ValueStr);
+    } catch (...) {
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should be a number.");
+    }
+    if (Result < 1)
+      throw INVALID_CONFIG_EXCEPTION(BaseT,
+                                     "Value should be larger than zero.");
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+template <> class SYCLConfig<SYCL_XPTI_SAMPLING_RATE> {
+  using BaseT = SYCLConfigBase<SYCL_XPTI_SAMPLING_RATE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    const char *ValueStr = BaseT::getRawValue();
+    // By default every submission is traced.
+    if (!ValueStr)
+      return 1;
+
+    int Result = 0;
+    try {
+      Result = std::stoi(ValueStr);
+    } catch (...) {
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should be a number.");
+    }
+    if (Result < 1)
+      throw INVALID_CONFIG_EXCEPTION(BaseT,
+                                     "Value should be larger than zero.");
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+// Collects device timestamps for one in N kernels submitted to queues without
+// the enable_profiling property. Zero, the default, disables the sampling.
+template <> class SYCLConfig<SYCL_PROFILING_SAMPLE_RATE> {
+  using BaseT = SYCLConfigBase<SYCL_PROFILING_SAMPLE_RATE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    const char *ValueStr = BaseT::getRawValue();
+    if (!ValueStr)
+      return 0;
+
+    int Result = 0;
+    try {
+      Result = std::stoi(ValueStr);
+    } catch (...) {
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should be a number.");
+    }
+    if (Result < 0)
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should not be negative.");
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+// Upper bound, in bytes, for the total size of programs kept in the in-memory
+// program cache of a context. Zero means that the cache is not bounded.
+template <> class SYCLConfig<SYCL_IN_MEM_CACHE_MAX_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_IN_MEM_CACHE_MAX_SIZE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    const char *ValueStr = BaseT::getRawValue();
+    if (!ValueStr)
+      return 0;
+
+    long long Result = 0;
+    try {
+      Result = std::stoll(ValueStr);
+    } catch (...) {
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should be a number.");
+    }
+    if (Result < 0)
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should not be negative.");
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+// When enabled, building a program for one device of a context starts builds
+// of the same program for the other devices of the context in background.
+template <> class SYCLConfig<SYCL_PARALLEL_DEVICE_BUILD> {
+  using BaseT = SYCLConfigBase<SYCL_PARALLEL_DEVICE_BUILD>;
+
+public:
+  static bool get() { return getCachedValue(); }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static bool parseValue() {
+    const char *ValueStr = BaseT::getRawValue();
+    if (!ValueStr)
+      return false;
+
+    if (strlen(ValueStr) != 1 || (ValueStr[0] != '0' && ValueStr[0] != '1'))
+      throw INVALID_CONFIG_EXCEPTION(BaseT, "Value should be 0 or 1.");
+    return ValueStr[0] == '1';
+  }
+
+  static bool getCachedValue(bool ResetCache = false) {
+    static bool Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
 #undef INVALID_CONFIG_EXCEPTION
 
 } // namespace detail
@@ -294,6 +294,17 @@ void context_impl::addDeviceGlobalInitializer(
   }
 }
 
+void context_impl::removeDeviceGlobalInitializer(
+    sycl::detail::pi::PiProgram Program) {
+  std::lock_guard<std::mutex> Lock(MDeviceGlobalInitializersMutex);
+  auto It = MDeviceGlobalInitializers.lower_bound(
+      std::make_pair(Program, sycl::detail::pi::PiDevice{nullptr}));
+  while (It != MDeviceGlobalInitializers.end() && It->first.first == Program) {
+    It->second.ClearEvents(getPlugin());
+    It = MDeviceGlobalInitializers.erase(It);
+  }
+}
+
 std::vector<sycl::detail::pi::PiEvent> context_impl::initializeDeviceGlobals(
     pi::PiProgram NativePrg, const std::shared_ptr<queue_impl> &QueueImpl) {
   const PluginPtr &Plugin = getPlugin();
@@ -384,6 +395,19 @@ std::vector<sycl::detail::pi::PiEvent> context_impl::initializeDeviceGlobals(
 
       InitEventsRef.push_back(InitEvent);
     }
+
+    // Every launch until the initialization is complete polls the events and
+    // waits on them, so with several device globals they are replaced by a
+    // single marker depending on all of them.
+    if (DeviceGlobalEntries.size() > 1) {
+      sycl::detail::pi::PiEvent MarkerEvent;
+      Plugin->call<PiApiKind::piEnqueueEventsWait>(
+          QueueImpl->getHandleRef(), InitEventsRef.size(),
+          InitEventsRef.data(), &MarkerEvent);
+      for (const sycl::detail::pi::PiEvent &Event : InitEventsRef)
+        Plugin->call<PiApiKind::piEventRelease>(Event);
+      InitEventsRef.assign(1, MarkerEvent);
+    }
     return InitEventsRef;
   }
 }
@@ -23,6 +23,8 @@
 #include <memory>
 #include <optional>
 #include <set>
+#include <string>
+#include <tuple>
 
 namespace sycl {
 inline namespace _V1 {
@@ -141,7 +143,8 @@ public:
   const std::vector<device> &getDevices() const { return MDevices; }
 
   using CachedLibProgramsT =
-      std::map<std::pair<DeviceLibExt, sycl::detail::pi::PiDevice>,
+      std::map<std::tuple<DeviceLibExt, sycl::detail::pi::PiDevice,
+                          std::string>,
                sycl::detail::pi::PiProgram>;
 
   /// In contrast to user programs, which are compiled from user code, library
@@ -152,6 +155,9 @@ public:
   ///  cl_intel_devicelib_complex -> #<pi_program with complex functions>
   ///  etc.
   ///
+  /// and by the functions of the library they were reduced to, separated by
+  /// spaces. The string is empty for programs with the whole library.
+  ///
   /// See `doc/design/DeviceLibExtensions.rst' for
   /// more details.
   ///
@@ -211,6 +217,9 @@ public:
                                   const std::vector<device> &Devs,
                                   const RTDeviceBinaryImage *BinImage);
 
+  /// Removes the device global initializers of a program that is released.
+  void removeDeviceGlobalInitializer(sycl::detail::pi::PiProgram Program);
+
   /// Initializes device globals for a program on the associated queue.
   std::vector<sycl::detail::pi::PiEvent>
   initializeDeviceGlobals(pi::PiProgram NativePrg,
@@ -8,11 +8,16 @@
 
 #include <detail/device_binary_image.hpp>
 #include <sycl/detail/pi.hpp>
+#include <sycl/exception.hpp>
 
 #include <algorithm>
 #include <cstring>
 #include <memory>
 
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+#include <zstd.h>
+#endif
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -169,6 +174,7 @@ void RTDeviceBinaryImage::init(pi_device_binary Bin) {
   SpecConstDefaultValuesMap.init(
       Bin, __SYCL_PI_PROPERTY_SET_SPEC_CONST_DEFAULT_VALUES_MAP);
   DeviceLibReqMask.init(Bin, __SYCL_PI_PROPERTY_SET_DEVICELIB_REQ_MASK);
+  DeviceLibFuncs.init(Bin, __SYCL_PI_PROPERTY_SET_SYCL_DEVICELIB_FUNCS);
   KernelParamOptInfo.init(Bin, __SYCL_PI_PROPERTY_SET_KERNEL_PARAM_OPT_INFO);
   AssertUsed.init(Bin, __SYCL_PI_PROPERTY_SET_SYCL_ASSERT_USED);
   ProgramMetadata.init(Bin, __SYCL_PI_PROPERTY_SET_PROGRAM_METADATA);
@@ -209,6 +215,47 @@ DynRTDeviceBinaryImage::~DynRTDeviceBinaryImage() {
   Bin = nullptr;
 }
 
+CompressedRTDeviceBinaryImage::CompressedRTDeviceBinaryImage(
+    pi_device_binary CompressedBin)
+    : RTDeviceBinaryImage(), BinCopy(*CompressedBin) {
+  // Properties are not compressed, so they are available right away.
+  init(&BinCopy);
+}
+
+void CompressedRTDeviceBinaryImage::decompress() {
+  std::call_once(DecompressFlag, [this]() {
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+    const size_t CompressedSize = getSize();
+    const unsigned long long DecompressedSize =
+        ZSTD_getFrameContentSize(BinCopy.BinaryStart, CompressedSize);
+    if (DecompressedSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+        DecompressedSize == ZSTD_CONTENTSIZE_ERROR)
+      throw sycl::exception(make_error_code(errc::runtime),
+                            "Compressed device image is malformed");
+
+    DecompressedData.reset(new char[DecompressedSize]);
+    const size_t Result =
+        ZSTD_decompress(DecompressedData.get(), DecompressedSize,
+                        BinCopy.BinaryStart, CompressedSize);
+    if (ZSTD_isError(Result) || Result != DecompressedSize)
+      throw sycl::exception(make_error_code(errc::runtime),
+                            "Failed to decompress device image: " +
+                                std::string(ZSTD_getErrorName(Result)));
+
+    BinCopy.BinaryStart =
+        reinterpret_cast<const unsigned char *>(DecompressedData.get());
+    BinCopy.BinaryEnd = BinCopy.BinaryStart + DecompressedSize;
+    // The offload wrapper doesn't know the format of the images it compresses.
+    Format = pi::getBinaryImageFormat(BinCopy.BinaryStart, DecompressedSize);
+    BinCopy.Format = Format;
+#else
+    throw sycl::exception(make_error_code(errc::feature_not_supported),
+                          "Device image is compressed, but the SYCL runtime "
+                          "is built without zstd support");
+#endif
+  });
+}
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
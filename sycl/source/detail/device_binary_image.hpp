@@ -14,6 +14,7 @@
 #include <atomic>
 #include <cstring>
 #include <memory>
+#include <mutex>
 
 namespace sycl {
 inline namespace _V1 {
@@ -206,6 +207,7 @@ public:
     return SpecConstDefaultValuesMap;
   }
   const PropertyRange &getDeviceLibReqMask() const { return DeviceLibReqMask; }
+  const PropertyRange &getDeviceLibFuncs() const { return DeviceLibFuncs; }
   const PropertyRange &getKernelParamOptInfo() const {
     return KernelParamOptInfo;
   }
@@ -233,6 +235,7 @@ protected:
   RTDeviceBinaryImage::PropertyRange SpecConstIDMap;
   RTDeviceBinaryImage::PropertyRange SpecConstDefaultValuesMap;
   RTDeviceBinaryImage::PropertyRange DeviceLibReqMask;
+  RTDeviceBinaryImage::PropertyRange DeviceLibFuncs;
   RTDeviceBinaryImage::PropertyRange KernelParamOptInfo;
   RTDeviceBinaryImage::PropertyRange AssertUsed;
   RTDeviceBinaryImage::PropertyRange ProgramMetadata;
@@ -258,6 +261,30 @@ protected:
   std::unique_ptr<char[]> Data;
 };
 
+// Device binary image compressed by the offload wrapper. The image data is
+// decompressed when it is first needed, decompress() must be called before
+// the data or the format of the image are accessed.
+class CompressedRTDeviceBinaryImage : public RTDeviceBinaryImage {
+public:
+  CompressedRTDeviceBinaryImage(pi_device_binary CompressedBin);
+
+  // Decompresses the image data and detects its format, does nothing if it is
+  // already done. Throws if the runtime is built without zstd support.
+  void decompress();
+
+  void print() const override {
+    RTDeviceBinaryImage::print();
+    std::cerr << "    COMPRESSED\n";
+  }
+
+private:
+  // Copy of the binary descriptor, which is made to point to the
+  // decompressed data. Its address is kept as the image ID.
+  pi_device_binary_struct BinCopy;
+  std::unique_ptr<char[]> DecompressedData;
+  std::once_flag DecompressFlag;
+};
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
@@ -569,6 +569,27 @@ std::string device_impl::getDeviceName() const {
   return MDeviceName;
 }
 
+size_t device_impl::getMaxWorkGroupSize() const {
+  std::call_once(MMaxWorkGroupSizeFlag, [this]() {
+    MMaxWorkGroupSize = get_info<info::device::max_work_group_size>();
+  });
+
+  return MMaxWorkGroupSize;
+}
+
+size_t device_impl::getRangeRoundingFactor(size_t Range,
+                                           size_t GoodFactor) const {
+  // The backend picks the work-group size of the launch among the divisors of
+  // the range, a range which is a multiple of a large power of two lets it
+  // pick full work-groups. Larger factors are only used for larger ranges to
+  // bound the number of padding work-items.
+  size_t MaxWGSize = getMaxWorkGroupSize();
+  size_t Factor = GoodFactor;
+  while (Factor * 2 <= MaxWGSize && Factor * 2 * 16 <= Range)
+    Factor *= 2;
+  return Factor;
+}
+
 ext::oneapi::experimental::architecture device_impl::getDeviceArch() const {
   std::call_once(MDeviceArchFlag, [this]() {
     MDeviceArch =
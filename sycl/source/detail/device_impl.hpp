@@ -234,6 +234,15 @@ public:
 
   std::string getDeviceName() const;
 
+  /// \return the maximum work-group size of the device, queried once.
+  size_t getMaxWorkGroupSize() const;
+
+  /// \return the factor the first dimension of a parallel_for over \p Range
+  /// work-items is rounded up to a multiple of. It is the largest power of two
+  /// times \p GoodFactor up to the maximum work-group size of the device which
+  /// pads the range by at most 1/16, and at least \p GoodFactor.
+  size_t getRangeRoundingFactor(size_t Range, size_t GoodFactor) const;
+
   bool extOneapiArchitectureIs(ext::oneapi::experimental::architecture Arch) {
     return Arch == getDeviceArch();
   }
@@ -272,6 +281,8 @@ private:
   mutable std::once_flag MDeviceNameFlag;
   mutable ext::oneapi::experimental::architecture MDeviceArch{};
   mutable std::once_flag MDeviceArchFlag;
+  mutable size_t MMaxWorkGroupSize = 0;
+  mutable std::once_flag MMaxWorkGroupSizeFlag;
   std::pair<uint64_t, uint64_t> MDeviceHostBaseTime;
 }; // class device_impl
 
@@ -53,6 +53,12 @@ bool event_impl::is_host() {
   return MHostEvent;
 }
 
+EventImplPtr getDiscardedEventImpl() {
+  static const EventImplPtr DiscardedEvent =
+      createEventImpl(event_impl::HES_Discarded);
+  return DiscardedEvent;
+}
+
 event_impl::~event_impl() {
   if (MEvent)
     getPlugin()->call<PiApiKind::piEventRelease>(MEvent);
@@ -250,6 +256,17 @@ void event_impl::wait(std::shared_ptr<sycl::detail::event_impl> Self) {
     waitInternal();
   else if (MCommand)
     detail::Scheduler::getInstance().waitForEvent(Self);
+  else {
+    // The command was replaced, e.g. by a fused kernel. The events are copied
+    // as attachEventToComplete may be called concurrently.
+    std::vector<EventImplPtr> PostCompleteEvents;
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      PostCompleteEvents = MPostCompleteEvents;
+    }
+    for (const EventImplPtr &Event : PostCompleteEvents)
+      Event->wait(Event);
+  }
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   instrumentationEpilog(TelemetryEvent, Name, StreamID, IId);
@@ -486,6 +503,12 @@ void event_impl::setHostEnqueueTime() {
   MHostBaseTime = getTimestamp();
 }
 
+void event_impl::setProfilingSampled() {
+  assert(!MFallbackProfiling && "Sampled profiling needs the device timer");
+  MIsProfilingEnabled = true;
+  setSubmissionTime();
+}
+
 uint64_t event_impl::getSubmissionTime() { return MSubmitTime; }
 
 bool event_impl::isCompleted() {
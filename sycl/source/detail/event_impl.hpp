@@ -9,6 +9,7 @@
 #pragma once
 
 #include <detail/plugin.hpp>
+#include <detail/recycling_allocator.hpp>
 #include <sycl/detail/cl.h>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/host_profiling_info.hpp>
@@ -19,7 +20,9 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <memory>
 #include <optional>
+#include <utility>
 
 namespace sycl {
 inline namespace _V1 {
@@ -232,6 +235,11 @@ public:
   /// profiling base time. See MFallbackProfiling
   void setHostEnqueueTime();
 
+  /// Makes the profiling info of the event available although its queue
+  /// doesn't have the enable_profiling property, because the command was
+  /// sampled for profiling. The submission time is the time of this call.
+  void setProfilingSampled();
+
   /// @return Submission time for command associated with this event
   uint64_t getSubmissionTime();
 
@@ -313,7 +321,9 @@ protected:
   std::unique_ptr<HostProfilingInfo> MHostProfilingInfo;
   void *MCommand = nullptr;
   std::weak_ptr<queue_impl> MQueue;
-  const bool MIsProfilingEnabled = false;
+  /// Set on a kernel sampled for profiling while other threads may query the
+  /// profiling info, see setProfilingSampled().
+  std::atomic<bool> MIsProfilingEnabled{false};
   const bool MFallbackProfiling = false;
 
   std::weak_ptr<queue_impl> MWorkerQueue;
@@ -353,6 +363,18 @@ protected:
                   std::shared_ptr<sycl::detail::context_impl> Context);
 };
 
+/// Creates an event_impl, the memory of the object and the shared pointer
+/// control block is recycled.
+template <typename... ArgsT> EventImplPtr createEventImpl(ArgsT &&...Args) {
+  return std::allocate_shared<event_impl>(RecyclingAllocator<event_impl>{},
+                                          std::forward<ArgsT>(Args)...);
+}
+
+/// Returns the event returned for commands submitted to queues created with
+/// the discard_events property. The event is shared by all such commands as
+/// discarded events have no state.
+EventImplPtr getDiscardedEventImpl();
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
@@ -23,7 +23,10 @@ std::shared_ptr<detail::queue_impl> fusion_wrapper_impl::get_queue() const {
 }
 
 bool fusion_wrapper_impl::is_in_fusion_mode() const {
-  return MQueue->is_in_fusion_mode();
+  // Fusions started by the scheduler are transparent to the user.
+  return MQueue->is_in_fusion_mode() &&
+         !detail::Scheduler::getInstance().isInAutomaticFusion(
+             std::hash<queue_impl *>()(MQueue.get()));
 }
 
 void fusion_wrapper_impl::start_fusion() {
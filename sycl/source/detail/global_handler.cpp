@@ -223,6 +223,17 @@ ThreadPool &GlobalHandler::getHostTaskThreadPool() {
   return TP;
 }
 
+ThreadPool &GlobalHandler::getPersistentCacheWriterThreadPool() {
+  // Cache items are written one at a time, a single thread is enough to keep
+  // the writes off the critical path.
+  return getOrCreate(MPersistentCacheWriterThreadPool, 1);
+}
+
+ThreadPool &GlobalHandler::getProgramBuildThreadPool() {
+  unsigned int Size = std::thread::hardware_concurrency();
+  return getOrCreate(MProgramBuildThreadPool, Size ? Size : 1u);
+}
+
 void GlobalHandler::releaseDefaultContexts() {
   // Release shared-pointers to SYCL objects.
 #ifndef _WIN32
@@ -309,6 +320,18 @@ void shutdown() {
   if (Handler->MHostTaskThreadPool.Inst)
     Handler->MHostTaskThreadPool.Inst->finishAndWait();
 
+  // Background builds which haven't started yet are dropped, the ones in
+  // progress may still submit cache writes.
+  if (Handler->MProgramBuildThreadPool.Inst)
+    Handler->MProgramBuildThreadPool.Inst->finishAndWait();
+
+  // Pending cache writes refer to device images owned by the program manager,
+  // so they must be completed before it is released.
+  if (Handler->MPersistentCacheWriterThreadPool.Inst) {
+    Handler->MPersistentCacheWriterThreadPool.Inst->drain();
+    Handler->MPersistentCacheWriterThreadPool.Inst->finishAndWait();
+  }
+
   // If default contexts are requested after the first default contexts have
   // been released there may be a new default context. These must be released
   // prior to closing the plugins.
@@ -73,6 +73,8 @@ public:
   ods_target_list &getOneapiDeviceSelectorTargets(const std::string &InitValue);
   XPTIRegistry &getXPTIRegistry();
   ThreadPool &getHostTaskThreadPool();
+  ThreadPool &getPersistentCacheWriterThreadPool();
+  ThreadPool &getProgramBuildThreadPool();
 
   static void registerDefaultContextReleaseHandler();
 
@@ -125,6 +127,10 @@ private:
   InstWithLock<XPTIRegistry> MXPTIRegistry;
   // Thread pool for host task and event callbacks execution
   InstWithLock<ThreadPool> MHostTaskThreadPool;
+  // Thread writing built programs to the persistent device code cache
+  InstWithLock<ThreadPool> MPersistentCacheWriterThreadPool;
+  // Threads building programs for other devices of a context in background
+  InstWithLock<ThreadPool> MProgramBuildThreadPool;
 };
 } // namespace detail
 } // namespace _V1
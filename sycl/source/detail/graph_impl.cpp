@@ -437,6 +437,22 @@ void exec_graph_impl::findRealDeps(
   }
 }
 
+void exec_graph_impl::findRealDepEvents(
+    std::vector<sycl::detail::EventImplPtr> &Deps,
+    const std::shared_ptr<node_impl> &CurrentNode) {
+  if (CurrentNode->isEmpty()) {
+    for (auto &N : CurrentNode->MPredecessors)
+      findRealDepEvents(Deps, N.lock());
+    return;
+  }
+
+  auto Event = MNodeEvents.find(CurrentNode);
+  assert(Event != MNodeEvents.end() &&
+         "No event has been set for node dependency.");
+  if (std::find(Deps.begin(), Deps.end(), Event->second) == Deps.end())
+    Deps.push_back(Event->second);
+}
+
 sycl::detail::pi::PiExtSyncPoint exec_graph_impl::enqueueNodeDirect(
     sycl::context Ctx, sycl::detail::DeviceImplPtr DeviceImpl,
     sycl::detail::pi::PiExtCommandBuffer CommandBuffer,
@@ -624,9 +640,37 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
     }
   } else {
     std::vector<std::shared_ptr<sycl::detail::event_impl>> ScheduledEvents;
+    std::vector<sycl::detail::EventImplPtr> DepEvents;
+    std::vector<sycl::detail::pi::PiEvent> RawEvents;
+    MNodeEvents.clear();
     for (auto &NodeImpl : MSchedule) {
-      std::vector<sycl::detail::pi::PiEvent> RawEvents;
+      // Empty nodes are not processed as other nodes, but only their
+      // dependencies are propagated in findRealDepEvents
+      if (NodeImpl->isEmpty())
+        continue;
+
+      // The dependencies of the graph submission are dependencies of its
+      // root nodes, the others depend on them through their predecessors.
+      DepEvents.clear();
+      if (NodeImpl->MPredecessors.empty())
+        DepEvents = CGData.MEvents;
+      for (auto &N : NodeImpl->MPredecessors)
+        findRealDepEvents(DepEvents, N.lock());
+
+      // The native events of the dependencies are enough to enqueue a kernel
+      // directly, provided that they already exist.
+      RawEvents.clear();
+      bool DepsHaveNativeEvents = true;
+      for (const sycl::detail::EventImplPtr &DepEvent : DepEvents) {
+        if (DepEvent->is_host() || !DepEvent->getHandleRef() ||
+            DepEvent->getContextImpl() != Queue->getContextImplPtr()) {
+          DepsHaveNativeEvents = false;
+          break;
+        }
+        RawEvents.push_back(DepEvent->getHandleRef());
+      }
 
+      sycl::detail::EventImplPtr NodeEvent;
       // If the node has no requirements for accessors etc. then we skip the
       // scheduler and enqueue directly.
       if (NodeImpl->MCGType == sycl::detail::CG::Kernel &&
@@ -634,15 +678,16 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
                   static_cast<sycl::detail::CGExecKernel *>(
                       NodeImpl->MCommandGroup.get())
                       ->MStreams.size() ==
-              0) {
+              0 &&
+          DepsHaveNativeEvents) {
         sycl::detail::CGExecKernel *CG =
             static_cast<sycl::detail::CGExecKernel *>(
                 NodeImpl->MCommandGroup.get());
-        auto OutEvent = CreateNewEvent();
+        NodeEvent = CreateNewEvent();
         pi_int32 Res = sycl::detail::enqueueImpKernel(
             Queue, CG->MNDRDesc, CG->MArgs,
             // TODO: Handler KernelBundles
-            nullptr, CG->MSyclKernel, CG->MKernelName, RawEvents, OutEvent,
+            nullptr, CG->MSyclKernel, CG->MKernelName, RawEvents, NodeEvent,
             // TODO: Pass accessor mem allocations
             nullptr,
             // TODO: Extract from handler
@@ -652,17 +697,19 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
               sycl::make_error_code(sycl::errc::kernel),
               "Error during emulated graph command group submission.");
         }
-        ScheduledEvents.push_back(NewEvent);
-      } else if (!NodeImpl->isEmpty()) {
-        // Empty nodes are node processed as other nodes, but only their
-        // dependencies are propagated in findRealDeps
-        sycl::detail::EventImplPtr EventImpl =
-            sycl::detail::Scheduler::getInstance().addCG(NodeImpl->getCGCopy(),
-                                                         Queue);
-
-        ScheduledEvents.push_back(EventImpl);
+      } else {
+        std::unique_ptr<sycl::detail::CG> CommandGroup = NodeImpl->getCGCopy();
+        std::vector<sycl::detail::EventImplPtr> &CGEvents =
+            CommandGroup->getEvents();
+        CGEvents.insert(CGEvents.end(), DepEvents.begin(), DepEvents.end());
+        NodeEvent = sycl::detail::Scheduler::getInstance().addCG(
+            std::move(CommandGroup), Queue);
       }
+
+      MNodeEvents[NodeImpl] = NodeEvent;
+      ScheduledEvents.push_back(std::move(NodeEvent));
     }
+    MNodeEvents.clear();
     // Create an event which has all kernel events as dependencies
     NewEvent = std::make_shared<sycl::detail::event_impl>(Queue);
     NewEvent->setStateIncomplete();
@@ -742,6 +789,8 @@ bool modifiable_command_graph::begin_recording(queue &RecordingQueue) {
                           "differs from the graph device.");
   }
 
+  // Fusions started by the scheduler end with the recording.
+  sycl::detail::Scheduler::getInstance().flushAutomaticFusion(QueueImpl);
   if (QueueImpl->is_in_fusion_mode()) {
     throw sycl::exception(sycl::make_error_code(errc::invalid),
                           "SYCL queue in kernel in fusion mode "
@@ -701,6 +701,13 @@ private:
   void findRealDeps(std::vector<sycl::detail::pi::PiExtSyncPoint> &Deps,
                     std::shared_ptr<node_impl> CurrentNode);
 
+  /// Iterates back through predecessors to find the events of the real
+  /// dependencies when the graph is executed without a command-buffer.
+  /// @param[out] Deps Found dependencies.
+  /// @param[in] CurrentNode Node to find dependencies for.
+  void findRealDepEvents(std::vector<sycl::detail::EventImplPtr> &Deps,
+                         const std::shared_ptr<node_impl> &CurrentNode);
+
   /// Execution schedule of nodes in the graph.
   std::list<std::shared_ptr<node_impl>> MSchedule;
   /// Pointer to the modifiable graph impl associated with this executable
@@ -718,6 +725,10 @@ private:
   std::unordered_map<std::shared_ptr<node_impl>,
                      sycl::detail::pi::PiExtSyncPoint>
       MPiSyncPoints;
+  /// Map of nodes in the exec graph to the events of their latest execution
+  /// when the graph is executed without a command-buffer.
+  std::unordered_map<std::shared_ptr<node_impl>, sycl::detail::EventImplPtr>
+      MNodeEvents;
   /// Context associated with this executable graph.
   sycl::context MContext;
   /// List of requirements for enqueueing this command graph, accumulated from
@@ -12,12 +12,22 @@
 #include <detail/jit_compiler.hpp>
 #include <detail/kernel_bundle_impl.hpp>
 #include <detail/kernel_impl.hpp>
+#include <detail/persistent_device_code_cache.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/sycl_mem_obj_t.hpp>
 #include <sycl/detail/pi.hpp>
 #include <sycl/ext/codeplay/experimental/fusion_properties.hpp>
 #include <sycl/kernel_bundle.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -47,6 +57,8 @@ translateBinaryImageFormat(pi::PiDeviceBinaryType Type) {
     return ::jit_compiler::BinaryFormat::SPIRV;
   case backend::ext_oneapi_cuda:
     return ::jit_compiler::BinaryFormat::PTX;
+  case backend::ext_oneapi_hip:
+    return ::jit_compiler::BinaryFormat::AMDGCN;
   default:
     throw sycl::exception(
         sycl::make_error_code(sycl::errc::feature_not_supported),
@@ -58,18 +70,30 @@ std::pair<const RTDeviceBinaryImage *, sycl::detail::pi::PiProgram>
 retrieveKernelBinary(QueueImplPtr &Queue, CGExecKernel *KernelCG) {
   auto KernelName = KernelCG->getKernelName();
 
-  bool isNvidia =
-      Queue->getDeviceImplPtr()->getBackend() == backend::ext_oneapi_cuda;
-  if (isNvidia) {
+  // For CUDA and HIP, the fusion input is the LLVM IR embedded in the
+  // application with -fsycl-embed-ir, not the device binary.
+  const char *EmbeddedIRTarget = nullptr;
+  switch (Queue->getDeviceImplPtr()->getBackend()) {
+  case backend::ext_oneapi_cuda:
+    EmbeddedIRTarget = "llvm_nvptx64";
+    break;
+  case backend::ext_oneapi_hip:
+    EmbeddedIRTarget = "llvm_amdgcn";
+    break;
+  default:
+    break;
+  }
+  if (EmbeddedIRTarget) {
     auto KernelID = ProgramManager::getInstance().getSYCLKernelID(KernelName);
     std::vector<kernel_id> KernelIds{KernelID};
     auto DeviceImages =
         ProgramManager::getInstance().getRawDeviceImages(KernelIds);
     auto DeviceImage = std::find_if(
-        DeviceImages.begin(), DeviceImages.end(), [](RTDeviceBinaryImage *DI) {
+        DeviceImages.begin(), DeviceImages.end(),
+        [EmbeddedIRTarget](RTDeviceBinaryImage *DI) {
           return DI->getFormat() == PI_DEVICE_BINARY_TYPE_LLVMIR_BITCODE &&
                  DI->getRawData().DeviceTargetSpec ==
-                     std::string("llvm_nvptx64");
+                     std::string(EmbeddedIRTarget);
         });
     if (DeviceImage == DeviceImages.end()) {
       return {nullptr, nullptr};
@@ -620,6 +644,244 @@ updatePromotedArgs(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
   }
 }
 
+// Persistent cache items of fused kernels are serialized in the native byte
+// order, the cache is specific to the device anyway.
+template <typename T>
+static void writeCacheValue(std::string &Out, const T &Value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  Out.append(reinterpret_cast<const char *>(&Value), sizeof(T));
+}
+
+static void writeCacheValue(std::string &Out, const std::string &Value) {
+  writeCacheValue(Out, Value.size());
+  Out.append(Value);
+}
+
+template <typename T>
+static void writeCacheValue(std::string &Out, const std::vector<T> &Values) {
+  writeCacheValue(Out, Values.size());
+  for (const T &Value : Values)
+    writeCacheValue(Out, Value);
+}
+
+static void writeCacheValue(std::string &Out,
+                            const ::jit_compiler::NDRange &NDR) {
+  writeCacheValue(Out, NDR.getDimensions());
+  writeCacheValue(Out, NDR.getGlobalSize());
+  writeCacheValue(Out, NDR.getLocalSize());
+  writeCacheValue(Out, NDR.getOffset());
+}
+
+static void writeCacheValue(std::string &Out,
+                            const ::jit_compiler::Parameter &Param) {
+  writeCacheValue(Out, Param.KernelIdx);
+  writeCacheValue(Out, Param.ParamIdx);
+}
+
+/// Reads the values written by writeCacheValue, all reads fail after the end
+/// of the data has been reached.
+class CacheItemReader {
+public:
+  explicit CacheItemReader(const std::vector<char> &Data)
+      : MCur{Data.data()}, MEnd{Data.data() + Data.size()} {}
+
+  template <typename T> bool read(T &Value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const char *Bytes = readBytes(sizeof(T));
+    if (!Bytes)
+      return false;
+    std::memcpy(&Value, Bytes, sizeof(T));
+    return true;
+  }
+
+  bool read(std::string &Value) {
+    size_t Size = 0;
+    const char *Bytes = read(Size) ? readBytes(Size) : nullptr;
+    if (!Bytes)
+      return false;
+    Value.assign(Bytes, Size);
+    return true;
+  }
+
+  template <typename T> bool read(std::vector<T> &Values) {
+    size_t Size = 0;
+    if (!read(Size) || Size > static_cast<size_t>(MEnd - MCur))
+      return false;
+    Values.resize(Size);
+    return std::all_of(Values.begin(), Values.end(),
+                       [this](T &Value) { return read(Value); });
+  }
+
+  bool read(::jit_compiler::NDRange &NDR) {
+    int Dimensions = 0;
+    ::jit_compiler::Indices GlobalSize, LocalSize, Offset;
+    if (!read(Dimensions) || !read(GlobalSize) || !read(LocalSize) ||
+        !read(Offset))
+      return false;
+    NDR = ::jit_compiler::NDRange{Dimensions, GlobalSize, LocalSize, Offset};
+    return true;
+  }
+
+  bool read(::jit_compiler::SYCLKernelAttribute &Attr) {
+    return read(Attr.AttributeName) && read(Attr.Values);
+  }
+
+  /// \return a pointer to the next Size bytes of the data.
+  const char *readBytes(size_t Size) {
+    if (Size > static_cast<size_t>(MEnd - MCur))
+      return nullptr;
+    const char *Bytes = MCur;
+    MCur += Size;
+    return Bytes;
+  }
+
+  bool atEnd() const { return MCur == MEnd; }
+
+private:
+  const char *MCur;
+  const char *MEnd;
+};
+
+/// Builds the key identifying a fusion in the persistent cache. The input
+/// kernels are identified by the hashes of their binaries, as the binaries may
+/// be large.
+static std::string getFusionCacheKey(
+    ::jit_compiler::BinaryFormat TargetFormat,
+    const std::vector<::jit_compiler::SYCLKernelInfo> &InputKernelInfo,
+    const ::jit_compiler::ParamIdentList &ParamIdentities, int BarrierFlags,
+    const std::vector<::jit_compiler::ParameterInternalization>
+        &InternalizeParams,
+    const std::vector<::jit_compiler::JITConstant> &JITConstants) {
+  std::string Key;
+  writeCacheValue(Key, TargetFormat);
+  writeCacheValue(Key, BarrierFlags);
+  writeCacheValue(Key, InputKernelInfo.size());
+  for (const ::jit_compiler::SYCLKernelInfo &Kernel : InputKernelInfo) {
+    writeCacheValue(Key, Kernel.Name);
+    writeCacheValue(Key, Kernel.Args.Kinds);
+    writeCacheValue(Key, Kernel.Args.UsageMask);
+    writeCacheValue(Key, Kernel.NDR);
+    const ::jit_compiler::SYCLKernelBinaryInfo &Binary = Kernel.BinaryInfo;
+    writeCacheValue(Key, Binary.Format);
+    writeCacheValue(Key, Binary.AddressBits);
+    writeCacheValue(Key, Binary.BinarySize);
+    writeCacheValue(Key, std::hash<std::string_view>{}(std::string_view{
+                             reinterpret_cast<const char *>(Binary.BinaryStart),
+                             Binary.BinarySize}));
+  }
+  writeCacheValue(Key, ParamIdentities.size());
+  for (const ::jit_compiler::ParameterIdentity &Identity : ParamIdentities) {
+    writeCacheValue(Key, Identity.LHS);
+    writeCacheValue(Key, Identity.RHS);
+  }
+  writeCacheValue(Key, InternalizeParams.size());
+  for (const ::jit_compiler::ParameterInternalization &Param :
+       InternalizeParams) {
+    writeCacheValue(Key, Param.Param);
+    writeCacheValue(Key, Param.Intern);
+    writeCacheValue(Key, Param.LocalSize);
+  }
+  writeCacheValue(Key, JITConstants.size());
+  for (const ::jit_compiler::JITConstant &Constant : JITConstants) {
+    writeCacheValue(Key, Constant.Param);
+    writeCacheValue(Key, Constant.Value);
+  }
+  return Key;
+}
+
+static std::vector<char>
+serializeFusedKernel(const ::jit_compiler::SYCLKernelInfo &Kernel) {
+  std::string Data;
+  writeCacheValue(Data, Kernel.Name);
+  writeCacheValue(Data, Kernel.Args.Kinds);
+  writeCacheValue(Data, Kernel.Args.UsageMask);
+  writeCacheValue(Data, Kernel.Attributes.size());
+  for (const ::jit_compiler::SYCLKernelAttribute &Attr : Kernel.Attributes) {
+    writeCacheValue(Data, Attr.AttributeName);
+    writeCacheValue(Data, Attr.Values);
+  }
+  writeCacheValue(Data, Kernel.NDR);
+  writeCacheValue(Data, Kernel.BinaryInfo.Format);
+  writeCacheValue(Data, Kernel.BinaryInfo.AddressBits);
+  writeCacheValue(Data, Kernel.BinaryInfo.BinarySize);
+  Data.append(reinterpret_cast<const char *>(Kernel.BinaryInfo.BinaryStart),
+              Kernel.BinaryInfo.BinarySize);
+  return {Data.begin(), Data.end()};
+}
+
+/// Restores a kernel serialized by serializeFusedKernel, the binary of the
+/// kernel points into the data.
+static std::optional<::jit_compiler::SYCLKernelInfo>
+deserializeFusedKernel(const std::vector<char> &Data) {
+  CacheItemReader Reader{Data};
+  ::jit_compiler::SYCLKernelInfo Kernel;
+  ::jit_compiler::SYCLKernelBinaryInfo &Binary = Kernel.BinaryInfo;
+  if (!Reader.read(Kernel.Name) || !Reader.read(Kernel.Args.Kinds) ||
+      !Reader.read(Kernel.Args.UsageMask) || !Reader.read(Kernel.Attributes) ||
+      !Reader.read(Kernel.NDR) || !Reader.read(Binary.Format) ||
+      !Reader.read(Binary.AddressBits) || !Reader.read(Binary.BinarySize))
+    return std::nullopt;
+  Binary.BinaryStart = reinterpret_cast<::jit_compiler::BinaryAddress>(
+      Reader.readBytes(Binary.BinarySize));
+  if (!Binary.BinaryStart || !Reader.atEnd())
+    return std::nullopt;
+  return Kernel;
+}
+
+/// Inputs of the JIT compiler for one fusion.
+struct jit_compiler::FusionJob {
+  ::jit_compiler::BinaryFormat TargetFormat;
+  std::vector<::jit_compiler::SYCLKernelInfo> InputKernelInfo;
+  std::vector<std::string> InputKernelNames;
+  std::string FusedKernelName;
+  ::jit_compiler::ParamIdentList ParamIdentities;
+  int BarrierFlags;
+  std::vector<::jit_compiler::ParameterInternalization> InternalizeParams;
+  std::vector<::jit_compiler::JITConstant> JITConstants;
+};
+
+/// A fusion compiled in the background. All fields but the job are written
+/// by the compilation and must only be read once it is complete.
+struct jit_compiler::AsyncFusion {
+  FusionJob Job;
+  std::future<void> Compilation;
+  bool Succeeded = false;
+  ::jit_compiler::SYCLKernelInfo KernelInfo;
+  bool Cached = false;
+  // Only accessed by the thread completing the fusion.
+  bool ImageAdded = false;
+};
+
+bool jit_compiler::runFusion(const FusionJob &Job, bool DebugEnabled,
+                             bool CachingEnabled,
+                             ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
+                             bool &Cached) {
+  ::jit_compiler::Config JITConfig;
+  JITConfig.set<::jit_compiler::option::JITEnableVerbose>(DebugEnabled);
+  JITConfig.set<::jit_compiler::option::JITEnableCaching>(CachingEnabled);
+  JITConfig.set<::jit_compiler::option::JITTargetFormat>(Job.TargetFormat);
+
+  // The JIT context uses a single LLVM context, so the fusions are serialized.
+  std::lock_guard<std::mutex> Lock{MFusionMutex};
+  auto FusionResult = ::jit_compiler::KernelFusion::fuseKernels(
+      *MJITContext, std::move(JITConfig), Job.InputKernelInfo,
+      Job.InputKernelNames, Job.FusedKernelName, Job.ParamIdentities,
+      Job.BarrierFlags, Job.InternalizeParams, Job.JITConstants);
+
+  if (FusionResult.failed()) {
+    if (DebugEnabled) {
+      std::cerr
+          << "ERROR: JIT compilation for kernel fusion failed with message:\n"
+          << FusionResult.getErrorMessage() << "\n";
+    }
+    return false;
+  }
+
+  FusedKernelInfo = FusionResult.getKernelInfo();
+  Cached = FusionResult.cached();
+  return true;
+}
+
 std::unique_ptr<detail::CG>
 jit_compiler::fuseKernels(QueueImplPtr Queue,
                           std::vector<ExecCGCommand *> &InputKernels,
@@ -802,34 +1064,111 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
           ? -1
           : 3;
 
-  static size_t FusedKernelNameIndex = 0;
-  std::stringstream FusedKernelName;
-  FusedKernelName << "fused_" << FusedKernelNameIndex++;
-  ::jit_compiler::Config JITConfig;
   bool DebugEnabled =
       detail::SYCLConfig<detail::SYCL_RT_WARNING_LEVEL>::get() > 0;
-  JITConfig.set<::jit_compiler::option::JITEnableVerbose>(DebugEnabled);
-  JITConfig.set<::jit_compiler::option::JITEnableCaching>(
-      detail::SYCLConfig<detail::SYCL_ENABLE_FUSION_CACHING>::get());
-
+  bool CachingEnabled =
+      detail::SYCLConfig<detail::SYCL_ENABLE_FUSION_CACHING>::get();
   ::jit_compiler::BinaryFormat TargetFormat = getTargetFormat(Queue);
-  JITConfig.set<::jit_compiler::option::JITTargetFormat>(TargetFormat);
-
-  auto FusionResult = ::jit_compiler::KernelFusion::fuseKernels(
-      *MJITContext, std::move(JITConfig), InputKernelInfo, InputKernelNames,
-      FusedKernelName.str(), ParamIdentities, BarrierFlags, InternalizeParams,
-      JITConstants);
 
-  if (FusionResult.failed()) {
-    if (DebugEnabled) {
-      std::cerr
-          << "ERROR: JIT compilation for kernel fusion failed with message:\n"
-          << FusionResult.getErrorMessage() << "\n";
+  // With caching enabled, fused kernels are also stored in the persistent
+  // device code cache. Their names are derived from the key of the fusion to
+  // be the same in every process. The key is dropped in the unlikely case of
+  // a name clash with a different fusion.
+  static size_t FusedKernelNameIndex = 0;
+  std::string FusedKernelName;
+  std::string PersistentKey;
+  if (CachingEnabled) {
+    PersistentKey =
+        getFusionCacheKey(TargetFormat, InputKernelInfo, ParamIdentities,
+                          BarrierFlags, InternalizeParams, JITConstants);
+    FusedKernelName =
+        "fused_" + std::to_string(std::hash<std::string>{}(PersistentKey));
+    if (MPersistentFusedKernels.clashes(FusedKernelName, PersistentKey))
+      PersistentKey.clear();
+  }
+  if (PersistentKey.empty())
+    FusedKernelName = "fused_" + std::to_string(FusedKernelNameIndex++);
+
+  std::optional<::jit_compiler::SYCLKernelInfo> PersistedKernelInfo;
+  // Images of the fused kernels known to this process are registered already.
+  bool NewKernelImage = true;
+  if (!PersistentKey.empty()) {
+    bool FromDisc = false;
+    if (const std::vector<char> *Data = MPersistentFusedKernels.find(
+            Queue->get_device(), FusedKernelName, PersistentKey, FromDisc)) {
+      PersistedKernelInfo = deserializeFusedKernel(*Data);
+      NewKernelImage = FromDisc;
+      if (!PersistedKernelInfo ||
+          PersistedKernelInfo->Name != FusedKernelName) {
+        MPersistentFusedKernels.erase(FusedKernelName);
+        PersistedKernelInfo.reset();
+        NewKernelImage = true;
+      }
     }
-    return nullptr;
   }
 
-  auto &FusedKernelInfo = FusionResult.getKernelInfo();
+  ::jit_compiler::SYCLKernelInfo FusedKernelInfo;
+  if (PersistedKernelInfo) {
+    FusedKernelInfo = std::move(*PersistedKernelInfo);
+  } else {
+    FusionJob Job{TargetFormat,
+                  std::move(InputKernelInfo),
+                  std::move(InputKernelNames),
+                  FusedKernelName,
+                  std::move(ParamIdentities),
+                  BarrierFlags,
+                  std::move(InternalizeParams),
+                  std::move(JITConstants)};
+    if (detail::SYCLConfig<detail::SYCL_ENABLE_ASYNC_FUSION>::get()) {
+      // The kernels are executed unfused until the fused kernel compiled in
+      // the background is ready.
+      std::string AsyncKey =
+          PersistentKey.empty()
+              ? getFusionCacheKey(TargetFormat, Job.InputKernelInfo,
+                                  Job.ParamIdentities, BarrierFlags,
+                                  Job.InternalizeParams, Job.JITConstants)
+              : PersistentKey;
+      auto &Async = MAsyncFusions[AsyncKey];
+      if (!Async) {
+        Async = std::make_unique<AsyncFusion>();
+        Async->Job = std::move(Job);
+        AsyncFusion *Pending = Async.get();
+        Async->Compilation =
+            std::async(std::launch::async,
+                       [this, Pending, DebugEnabled, CachingEnabled] {
+                         Pending->Succeeded = runFusion(
+                             Pending->Job, DebugEnabled, CachingEnabled,
+                             Pending->KernelInfo, Pending->Cached);
+                       });
+        printPerformanceWarning(
+            "Fused kernel is compiled in the background, executing the "
+            "kernels unfused");
+        return nullptr;
+      }
+      if (Async->Compilation.valid()) {
+        if (Async->Compilation.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready)
+          return nullptr;
+        Async->Compilation.get();
+      }
+      if (!Async->Succeeded)
+        return nullptr;
+      FusedKernelInfo = Async->KernelInfo;
+      NewKernelImage = !Async->Cached && !Async->ImageAdded;
+      Async->ImageAdded = true;
+    } else {
+      bool Cached = false;
+      if (!runFusion(Job, DebugEnabled, CachingEnabled, FusedKernelInfo,
+                     Cached))
+        return nullptr;
+      NewKernelImage = !Cached;
+    }
+    if (NewKernelImage && !PersistentKey.empty()) {
+      MPersistentFusedKernels.add(Queue->get_device(), FusedKernelName,
+                                  PersistentKey,
+                                  serializeFusedKernel(FusedKernelInfo));
+    }
+  }
 
   std::vector<ArgDesc> FusedArgs;
   int FusedArgIndex = 0;
@@ -854,7 +1193,7 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
   }(FusedKernelInfo.NDR);
   updatePromotedArgs(FusedKernelInfo, NDRDesc, FusedArgs, ArgsStorage);
 
-  if (!FusionResult.cached()) {
+  if (NewKernelImage) {
     auto PIDeviceBinaries = createPIDeviceBinary(FusedKernelInfo, TargetFormat);
     detail::ProgramManager::getInstance().addImages(PIDeviceBinaries);
   } else {
@@ -894,6 +1233,11 @@ pi_device_binaries jit_compiler::createPIDeviceBinary(
     BinFormat = PI_DEVICE_BINARY_TYPE_NONE;
     break;
   }
+  case ::jit_compiler::BinaryFormat::AMDGCN: {
+    TargetSpec = __SYCL_PI_DEVICE_BINARY_TARGET_AMDGCN;
+    BinFormat = PI_DEVICE_BINARY_TYPE_NONE;
+    break;
+  }
   case ::jit_compiler::BinaryFormat::SPIRV: {
     TargetSpec = (FusedKernelInfo.BinaryInfo.AddressBits == 64)
                      ? __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64
@@ -929,7 +1273,8 @@ pi_device_binaries jit_compiler::createPIDeviceBinary(
 
   Binary.addProperty(std::move(ArgMaskPropSet));
 
-  if (Format == ::jit_compiler::BinaryFormat::PTX) {
+  if (Format == ::jit_compiler::BinaryFormat::PTX ||
+      Format == ::jit_compiler::BinaryFormat::AMDGCN) {
     // Add a program metadata property with the reqd_work_group_size attribute.
     // See CUDA PI (pi_cuda.cpp) _pi_program::set_metadata for reference.
     auto ReqdWGS = std::find_if(
@@ -9,10 +9,15 @@
 #pragma once
 
 #include <detail/jit_device_binaries.hpp>
+#include <detail/persistent_fused_kernels.hpp>
 #include <detail/scheduler/commands.hpp>
 #include <detail/scheduler/scheduler.hpp>
 
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace jit_compiler {
 enum class BinaryFormat : uint32_t;
@@ -53,6 +58,15 @@ private:
   createPIDeviceBinary(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
                        ::jit_compiler::BinaryFormat Format);
 
+  struct FusionJob;
+  struct AsyncFusion;
+
+  /// Runs the JIT compiler, this is safe to call from any thread.
+  /// \return false if the fusion failed.
+  bool runFusion(const FusionJob &Job, bool DebugEnabled, bool CachingEnabled,
+                 ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
+                 bool &Cached);
+
   std::vector<uint8_t>
   encodeArgUsageMask(const ::jit_compiler::ArgUsageMask &Mask) const;
 
@@ -63,6 +77,13 @@ private:
   std::vector<DeviceBinariesCollection> JITDeviceBinaries;
 
   std::unique_ptr<::jit_compiler::JITContext> MJITContext;
+
+  PersistentFusedKernels MPersistentFusedKernels;
+
+  std::mutex MFusionMutex;
+  /// Fusions compiled in the background with SYCL_ENABLE_ASYNC_FUSION by the
+  /// key of the fusion. Destroying them waits for pending compilations.
+  std::unordered_map<std::string, std::unique_ptr<AsyncFusion>> MAsyncFusions;
 };
 
 } // namespace detail
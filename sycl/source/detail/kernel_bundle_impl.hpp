@@ -367,6 +367,11 @@ public:
 
     sycl::detail::pi::PiKernel Kernel = nullptr;
     const KernelArgMask *ArgMask = nullptr;
+    // The kernel is retained by kernel_impl, it must not be evicted from the
+    // cache before that.
+    auto CacheGuard = getSyclObjImpl(MContext)
+                          ->getKernelProgramCache()
+                          .acquireEvictionGuard();
     std::tie(Kernel, std::ignore, ArgMask) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             MContext, KernelID.get_name(), /*PropList=*/{},
@@ -0,0 +1,95 @@
+//==------ kernel_launch_state.hpp - State shared by kernel launches -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/pi.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Keeps the values of the arguments last set on a native kernel handle, so
+/// that launches of the same kernel only set the arguments which changed.
+///
+/// Only arguments passed by value are tracked. Memory objects may be resolved
+/// by the plugin at launch time, so they are set on every launch.
+class KernelArgShadow {
+public:
+  /// \return true if the argument was never set or was set to another value.
+  bool needsUpdate(size_t Index, const void *Value, size_t Size) const {
+    if (Index >= MArgs.size())
+      return true;
+    const ArgValue &Arg = MArgs[Index];
+    if (!Arg.IsSet || Arg.Size != Size || Arg.IsNull != (Value == nullptr))
+      return true;
+    return Value && std::memcmp(Arg.Bytes.data(), Value, Size) != 0;
+  }
+
+  /// Records the value the argument has been set to.
+  void update(size_t Index, const void *Value, size_t Size) {
+    if (Index >= MArgs.size())
+      MArgs.resize(Index + 1);
+    ArgValue &Arg = MArgs[Index];
+    Arg.IsSet = true;
+    Arg.IsNull = Value == nullptr;
+    Arg.Size = Size;
+    // A null value only carries the size, e.g. of local memory.
+    if (Value)
+      Arg.Bytes.assign(static_cast<const unsigned char *>(Value),
+                       static_cast<const unsigned char *>(Value) + Size);
+    else
+      Arg.Bytes.clear();
+  }
+
+  /// Forgets all recorded values, the next launch sets every argument.
+  void reset() { MArgs.clear(); }
+
+private:
+  struct ArgValue {
+    bool IsSet = false;
+    bool IsNull = false;
+    size_t Size = 0;
+    std::vector<unsigned char> Bytes;
+  };
+
+  std::vector<ArgValue> MArgs;
+};
+
+/// Another native handle of a cached kernel, created from the same program.
+struct KernelClone {
+  sycl::detail::pi::PiKernel Kernel = nullptr;
+  KernelArgShadow Args;
+};
+
+/// State shared by all launches of a cached native kernel handle.
+struct KernelLaunchState {
+  /// Arguments are a property of the handle, so setting them and enqueueing
+  /// the kernel must not interleave with other launches of it.
+  std::mutex Mutex;
+  /// Must only be used with Mutex held.
+  KernelArgShadow Args;
+
+  /// Launches which find Mutex taken use a clone instead of waiting, each
+  /// clone is used by one launch at a time. Guards Clones and FreeClones.
+  std::mutex ClonesMutex;
+  /// All clones, they are released along with the kernel.
+  std::vector<std::unique_ptr<KernelClone>> Clones;
+  /// Clones not used by any launch.
+  std::vector<KernelClone *> FreeClones;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
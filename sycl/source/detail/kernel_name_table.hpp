@@ -0,0 +1,99 @@
+//==------- kernel_name_table.hpp - Flat table keyed by kernel names -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Table of values keyed by kernel names.
+///
+/// Entries are kept in a flat vector sorted by a 64-bit hash of the name. A
+/// lookup hashes the name once, does a binary search on the hashes and only
+/// compares the names of the entries with the same hash. Mangled kernel names
+/// can be kilobytes long and share long prefixes, so this is much cheaper
+/// than comparing names in a tree.
+///
+/// Names are not copied, the storage they point to must outlive the table.
+template <typename ValueT> class KernelNameTable {
+public:
+  using HashT = std::uint64_t;
+
+  struct Entry {
+    HashT Hash;
+    std::string_view Name;
+    ValueT Value;
+  };
+
+  static HashT hash(std::string_view Name) {
+    return std::hash<std::string_view>{}(Name);
+  }
+
+  /// \return the value of the name, or nullptr if it is not in the table. The
+  /// pointer is invalidated by the next call to commit().
+  const ValueT *find(std::string_view Name) const {
+    return find(Name, hash(Name));
+  }
+
+  /// Same as above, for a hash already computed with hash().
+  const ValueT *find(std::string_view Name, HashT Hash) const {
+    auto End = MEntries.begin() + MNumCommitted;
+    auto It = std::lower_bound(
+        MEntries.begin(), End, Hash,
+        [](const Entry &E, HashT Key) { return E.Hash < Key; });
+    for (; It != End && It->Hash == Hash; ++It)
+      if (It->Name == Name)
+        return &It->Value;
+    return nullptr;
+  }
+
+  /// Adds an entry, which is not found by lookups until commit() is called.
+  /// If a name is added several times lookups find either of the values.
+  void insert(std::string_view Name, HashT Hash, ValueT Value) {
+    MEntries.push_back(Entry{Hash, Name, std::move(Value)});
+  }
+
+  /// Makes the entries inserted since the last call visible to lookups.
+  /// Entries are expected to be inserted in batches, e.g. per device image,
+  /// so that the table isn't sorted again for every entry.
+  void commit() {
+    auto LessByHash = [](const Entry &LHS, const Entry &RHS) {
+      return LHS.Hash < RHS.Hash;
+    };
+    auto Middle = MEntries.begin() + MNumCommitted;
+    std::sort(Middle, MEntries.end(), LessByHash);
+    std::inplace_merge(MEntries.begin(), Middle, MEntries.end(), LessByHash);
+    MNumCommitted = MEntries.size();
+  }
+
+  /// Iteration covers the committed entries only.
+  typename std::vector<Entry>::const_iterator begin() const {
+    return MEntries.begin();
+  }
+  typename std::vector<Entry>::const_iterator end() const {
+    return MEntries.begin() + MNumCommitted;
+  }
+  size_t size() const { return MNumCommitted; }
+
+private:
+  std::vector<Entry> MEntries;
+  /// The number of entries at the front of MEntries which are sorted.
+  size_t MNumCommitted = 0;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -10,6 +10,13 @@
 #include <detail/kernel_program_cache.hpp>
 #include <detail/plugin.hpp>
 
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+#include "xpti/xpti_trace_framework.hpp"
+#include <detail/xpti_registry.hpp>
+#endif
+
+#include <string>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -29,6 +36,7 @@ KernelProgramCache::~KernelProgramCache() {
         KernelArgMaskPairT *KernelArgMaskPair = KernelWithState.Ptr.load();
 
         if (KernelArgMaskPair) {
+          releaseKernelLaunchState(KernelArgMaskPair->first);
           const PluginPtr &Plugin = MParentContext->getPlugin();
           Plugin->call<PiApiKind::piKernelRelease>(KernelArgMaskPair->first);
         }
@@ -40,6 +48,161 @@ KernelProgramCache::~KernelProgramCache() {
     Plugin->call<PiApiKind::piProgramRelease>(*ToBeDeleted);
   }
 }
+
+KernelProgramCache::KernelCloneGuard::KernelCloneGuard(
+    KernelProgramCache &Cache, KernelLaunchState &State,
+    sycl::detail::pi::PiProgram Program, const std::string &KernelName)
+    : MState(State) {
+  {
+    std::lock_guard<std::mutex> Lock(State.ClonesMutex);
+    if (!State.FreeClones.empty()) {
+      MClone = State.FreeClones.back();
+      State.FreeClones.pop_back();
+      return;
+    }
+  }
+
+  // Other launches may go on while the handle is created.
+  auto Clone = std::make_unique<KernelClone>();
+  const PluginPtr &Plugin = Cache.MParentContext->getPlugin();
+  Plugin->call<errc::kernel_not_supported, PiApiKind::piKernelCreate>(
+      Program, KernelName.c_str(), &Clone->Kernel);
+  MClone = Clone.get();
+  {
+    std::lock_guard<std::mutex> Lock(State.ClonesMutex);
+    State.Clones.push_back(std::move(Clone));
+  }
+  // The clone must behave as the kernel it is made of, see
+  // ProgramManager::getOrCreateKernel.
+  Plugin->call<PiApiKind::piKernelSetExecInfo>(
+      MClone->Kernel, PI_USM_INDIRECT_ACCESS, sizeof(pi_bool), &PI_TRUE);
+}
+
+void KernelProgramCache::releaseKernelLaunchState(
+    sycl::detail::pi::PiKernel Kernel) {
+  auto It = MKernelLaunchStates.find(Kernel);
+  if (It == MKernelLaunchStates.end())
+    return;
+  const PluginPtr &Plugin = MParentContext->getPlugin();
+  for (const std::unique_ptr<KernelClone> &Clone : It->second.Clones)
+    Plugin->call_nocheck<PiApiKind::piKernelRelease>(Clone->Kernel);
+  MKernelLaunchStates.erase(It);
+}
+
+void KernelProgramCache::reset() {
+  // The clones are owned by the cache, unlike the cached kernels and programs.
+  if (MParentContext) {
+    const PluginPtr &Plugin = MParentContext->getPlugin();
+    for (const auto &[Kernel, State] : MKernelLaunchStates)
+      for (const std::unique_ptr<KernelClone> &Clone : State.Clones)
+        Plugin->call_nocheck<PiApiKind::piKernelRelease>(Clone->Kernel);
+  }
+
+  MCachedPrograms = ProgramCache{};
+  MKernelsPerProgramCache = KernelCacheT{};
+  MKernelFastCache = KernelFastCacheT{};
+  MKernelLaunchStates.clear();
+  MEvictionList.clear();
+  MEvictionMap.clear();
+  MCachedProgramsSize = 0;
+}
+
+void KernelProgramCache::addEvictableProgram(
+    const ProgramCacheKeyT &CacheKey, sycl::detail::pi::PiProgram Program,
+    size_t Size) {
+  std::lock_guard<std::mutex> Lock(MEvictionListMutex);
+  // Another thread may have registered the program in the meantime.
+  if (MEvictionMap.count(Program))
+    return;
+  MEvictionList.push_front(EvictionEntryT{CacheKey, Program, Size});
+  MEvictionMap.emplace(Program, MEvictionList.begin());
+  MCachedProgramsSize += Size;
+  if (MCachedProgramsSize > MMaxCachedProgramsSize)
+    MEvictionPending.store(true);
+}
+
+void KernelProgramCache::evictIfOverBudget() {
+  size_t NumEvicted = 0;
+  {
+    std::lock_guard<std::mutex> ProgramCacheLock(MProgramCacheMutex);
+    std::lock_guard<std::mutex> KernelsLock(MKernelsPerProgramCacheMutex);
+    std::unique_lock<std::shared_mutex> FastCacheLock(MKernelFastCacheMutex);
+    std::lock_guard<std::mutex> EvictionListLock(MEvictionListMutex);
+
+    // A thread that acquired its guard before the locks above were taken may
+    // still be using handles from the cache. The eviction is then retried by
+    // whoever releases the last guard.
+    if (MActiveUsers.load() != 0)
+      return;
+
+    const PluginPtr &Plugin = MParentContext->getPlugin();
+    while (MCachedProgramsSize > MMaxCachedProgramsSize &&
+           !MEvictionList.empty()) {
+      EvictionEntryT &Victim = MEvictionList.back();
+
+      auto ProgIt = MCachedPrograms.Cache.find(Victim.Key);
+      assert(ProgIt != MCachedPrograms.Cache.end() &&
+             "Evictable program is not in the cache");
+      CommonProgramKeyT CommonKey =
+          std::make_pair(Victim.Key.first.second, Victim.Key.second.first);
+      auto [KeyMapBegin, KeyMapEnd] =
+          MCachedPrograms.KeyMap.equal_range(CommonKey);
+      for (auto It = KeyMapBegin; It != KeyMapEnd; ++It) {
+        if (It->second == Victim.Key) {
+          MCachedPrograms.KeyMap.erase(It);
+          break;
+        }
+      }
+      MCachedPrograms.Cache.erase(ProgIt);
+
+      auto KernIt = MKernelsPerProgramCache.find(Victim.Program);
+      if (KernIt != MKernelsPerProgramCache.end()) {
+        for (auto &p : KernIt->second) {
+          KernelArgMaskPairT *KernelArgMaskPair = p.second.Ptr.load();
+          if (KernelArgMaskPair) {
+            releaseKernelLaunchState(KernelArgMaskPair->first);
+            Plugin->call_nocheck<PiApiKind::piKernelRelease>(
+                KernelArgMaskPair->first);
+          }
+        }
+        MKernelsPerProgramCache.erase(KernIt);
+      }
+
+      ::boost::unordered::erase_if(
+          MKernelFastCache, [&Victim](const auto &FastCacheEntry) {
+            return std::get<3>(FastCacheEntry.second) == Victim.Program;
+          });
+
+      MParentContext->removeDeviceGlobalInitializer(Victim.Program);
+      Plugin->call_nocheck<PiApiKind::piProgramRelease>(Victim.Program);
+
+      MCachedProgramsSize -= Victim.Size;
+      MEvictionMap.erase(Victim.Program);
+      MEvictionList.pop_back();
+      ++NumEvicted;
+    }
+    MEvictionPending.store(false);
+  }
+  MNumEvictedPrograms += NumEvicted;
+  notifyEviction(NumEvicted);
+}
+
+void KernelProgramCache::notifyEviction(size_t NumEvicted) {
+  (void)NumEvicted;
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  constexpr uint16_t NotificationTraceType = xpti::trace_diagnostics;
+  uint8_t StreamID = xptiRegisterStream(SYCL_STREAM_NAME);
+  if (!xptiCheckTraceEnabled(StreamID, NotificationTraceType))
+    return;
+  std::string Message =
+      "In-memory program cache: evicted " + std::to_string(NumEvicted) +
+      " programs (hits: " + std::to_string(MNumProgramCacheHits.load()) +
+      ", misses: " + std::to_string(MNumProgramCacheMisses.load()) +
+      ", evictions: " + std::to_string(MNumEvictedPrograms.load()) + ")";
+  xptiNotifySubscribers(StreamID, NotificationTraceType, nullptr, nullptr,
+                        xptiGetUniqueId(), Message.c_str());
+#endif
+}
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
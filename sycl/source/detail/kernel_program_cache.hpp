@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <detail/config.hpp>
 #include <detail/kernel_arg_mask.hpp>
+#include <detail/kernel_launch_state.hpp>
 #include <detail/platform_impl.hpp>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/locked.hpp>
@@ -18,7 +20,9 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <list>
 #include <mutex>
+#include <shared_mutex>
 #include <type_traits>
 
 #include <boost/unordered/unordered_flat_map.hpp>
@@ -99,7 +103,7 @@ public:
       std::tuple<SerializedObj, sycl::detail::pi::PiDevice, std::string,
                  std::string>;
   using KernelFastCacheValT =
-      std::tuple<sycl::detail::pi::PiKernel, std::mutex *,
+      std::tuple<sycl::detail::pi::PiKernel, KernelLaunchState *,
                  const KernelArgMask *, sycl::detail::pi::PiProgram>;
   // This container is used as a fast path for retrieving cached kernels.
   // unordered_flat_map is used here to reduce lookup overhead.
@@ -109,6 +113,65 @@ public:
   using KernelFastCacheT =
       ::boost::unordered_flat_map<KernelFastCacheKeyT, KernelFastCacheValT>;
 
+  /// Prevents eviction of cached entries for as long as it is alive.
+  ///
+  /// Native handles and mutexes returned by the cache are not retained for
+  /// the caller, so a guard must be held from the moment the cache is queried
+  /// until the handle has either been retained or is no longer used. Eviction
+  /// only happens when no guards are held; if it had to be postponed, it is
+  /// retried when the last guard is released.
+  class EvictionGuard {
+  public:
+    EvictionGuard(const EvictionGuard &) = delete;
+    EvictionGuard &operator=(const EvictionGuard &) = delete;
+
+    ~EvictionGuard() {
+      if (MCache && MCache->MActiveUsers.fetch_sub(1) == 1 &&
+          MCache->MEvictionPending.load())
+        MCache->evictIfOverBudget();
+    }
+
+  private:
+    friend class KernelProgramCache;
+    // The guard is a no-op when the size of the cache is not bounded.
+    EvictionGuard(KernelProgramCache &Cache)
+        : MCache(Cache.MMaxCachedProgramsSize ? &Cache : nullptr) {
+      if (MCache)
+        MCache->MActiveUsers.fetch_add(1);
+    }
+
+    KernelProgramCache *MCache;
+  };
+
+  /// Gives a launch exclusive use of a clone of a cached kernel for as long
+  /// as it is alive. A new clone is created if all existing ones are in use.
+  ///
+  /// The clone is owned by the cache, so the caller must hold an eviction
+  /// guard as well.
+  class KernelCloneGuard {
+  public:
+    KernelCloneGuard(KernelProgramCache &Cache, KernelLaunchState &State,
+                     sycl::detail::pi::PiProgram Program,
+                     const std::string &KernelName);
+    KernelCloneGuard(const KernelCloneGuard &) = delete;
+    KernelCloneGuard &operator=(const KernelCloneGuard &) = delete;
+
+    ~KernelCloneGuard() {
+      std::lock_guard<std::mutex> Lock(MState.ClonesMutex);
+      MState.FreeClones.push_back(MClone);
+    }
+
+    KernelClone &get() const { return *MClone; }
+
+  private:
+    KernelLaunchState &MState;
+    KernelClone *MClone = nullptr;
+  };
+
+  KernelProgramCache()
+      : MMaxCachedProgramsSize(SYCLConfig<SYCL_IN_MEM_CACHE_MAX_SIZE>::get()) {
+  }
+
   ~KernelProgramCache();
 
   void setContextPtr(const ContextPtr &AContext) { MParentContext = AContext; }
@@ -129,12 +192,15 @@ public:
         std::piecewise_construct, std::forward_as_tuple(CacheKey),
         std::forward_as_tuple(nullptr, BS_InProgress));
     if (Inserted.second) {
+      ++MNumProgramCacheMisses;
       // Save reference between the common key and the full key.
       CommonProgramKeyT CommonKey =
           std::make_pair(CacheKey.first.second, CacheKey.second.first);
       ProgCache.KeyMap.emplace(std::piecewise_construct,
                                std::forward_as_tuple(CommonKey),
                                std::forward_as_tuple(CacheKey));
+    } else {
+      ++MNumProgramCacheHits;
     }
     return std::make_pair(&Inserted.first->second, Inserted.second);
   }
@@ -150,6 +216,26 @@ public:
     return std::make_pair(&Inserted.first->second, Inserted.second);
   }
 
+  /// \return the launch state of a cached kernel, it lives for as long as
+  /// the kernel is in the cache.
+  KernelLaunchState *
+  getOrInsertKernelLaunchState(sycl::detail::pi::PiKernel Kernel) {
+    auto LockedCache = acquireKernelsPerProgramCache();
+    auto Inserted = MKernelLaunchStates.emplace(std::piecewise_construct,
+                                                std::forward_as_tuple(Kernel),
+                                                std::forward_as_tuple());
+    return &Inserted.first->second;
+  }
+
+  /// \return the launch state of a cached kernel or nullptr if the kernel
+  /// isn't owned by the cache.
+  KernelLaunchState *
+  findKernelLaunchState(sycl::detail::pi::PiKernel Kernel) {
+    auto LockedCache = acquireKernelsPerProgramCache();
+    auto It = MKernelLaunchStates.find(Kernel);
+    return It == MKernelLaunchStates.end() ? nullptr : &It->second;
+  }
+
   template <typename T, class Predicate>
   void waitUntilBuilt(BuildResult<T> &BR, Predicate Pred) const {
     std::unique_lock<std::mutex> Lock(BR.MBuildResultMutex);
@@ -180,7 +266,8 @@ public:
 
   template <typename KeyT>
   KernelFastCacheValT tryToGetKernelFast(KeyT &&CacheKey) {
-    std::unique_lock<std::mutex> Lock(MKernelFastCacheMutex);
+    // Lookups vastly outnumber insertions, so let them proceed concurrently.
+    std::shared_lock<std::shared_mutex> Lock(MKernelFastCacheMutex);
     auto It = MKernelFastCache.find(CacheKey);
     if (It != MKernelFastCache.end()) {
       return It->second;
@@ -190,31 +277,85 @@ public:
 
   template <typename KeyT, typename ValT>
   void saveKernel(KeyT &&CacheKey, ValT &&CacheVal) {
-    std::unique_lock<std::mutex> Lock(MKernelFastCacheMutex);
+    std::unique_lock<std::shared_mutex> Lock(MKernelFastCacheMutex);
     // if no insertion took place, thus some other thread has already inserted
     // smth in the cache
     MKernelFastCache.emplace(CacheKey, CacheVal);
   }
 
+  EvictionGuard acquireEvictionGuard() { return EvictionGuard{*this}; }
+
+  bool isEvictionEnabled() const { return MMaxCachedProgramsSize != 0; }
+
+  /// Marks an evictable program as the most recently used one. Returns false
+  /// if the program has not been registered with addEvictableProgram yet.
+  /// The caller must hold an eviction guard.
+  bool touchEvictableProgram(sycl::detail::pi::PiProgram Program) {
+    std::lock_guard<std::mutex> Lock(MEvictionListMutex);
+    auto It = MEvictionMap.find(Program);
+    if (It == MEvictionMap.end())
+      return false;
+    MEvictionList.splice(MEvictionList.begin(), MEvictionList, It->second);
+    return true;
+  }
+
+  /// Makes a built program a candidate for eviction. The caller must hold an
+  /// eviction guard.
+  void addEvictableProgram(const ProgramCacheKeyT &CacheKey,
+                           sycl::detail::pi::PiProgram Program, size_t Size);
+
+  /// Evicts least recently used programs along with their kernels until the
+  /// total size of evictable programs fits into SYCL_IN_MEM_CACHE_MAX_SIZE.
+  /// Does nothing if an eviction guard is held by any thread.
+  void evictIfOverBudget();
+
   /// Clears cache state.
   ///
   /// This member function should only be used in unit tests.
-  void reset() {
-    MCachedPrograms = ProgramCache{};
-    MKernelsPerProgramCache = KernelCacheT{};
-    MKernelFastCache = KernelFastCacheT{};
-  }
+  void reset();
 
 private:
+  struct EvictionEntryT {
+    ProgramCacheKeyT Key;
+    sycl::detail::pi::PiProgram Program;
+    size_t Size;
+  };
+
+  void notifyEviction(size_t NumEvicted);
+
+  /// Releases the clones of a kernel and forgets its launch state. The caller
+  /// must hold MKernelsPerProgramCacheMutex.
+  void releaseKernelLaunchState(sycl::detail::pi::PiKernel Kernel);
+
   std::mutex MProgramCacheMutex;
   std::mutex MKernelsPerProgramCacheMutex;
 
   ProgramCache MCachedPrograms;
   KernelCacheT MKernelsPerProgramCache;
+  // Guarded by MKernelsPerProgramCacheMutex. Entries are never moved, the
+  // fast cache keeps pointers to them.
+  ::boost::unordered_map<sycl::detail::pi::PiKernel, KernelLaunchState>
+      MKernelLaunchStates;
   ContextPtr MParentContext;
 
-  std::mutex MKernelFastCacheMutex;
+  std::shared_mutex MKernelFastCacheMutex;
   KernelFastCacheT MKernelFastCache;
+
+  // Programs that may be evicted, most recently used first.
+  std::list<EvictionEntryT> MEvictionList;
+  ::boost::unordered_map<sycl::detail::pi::PiProgram,
+                         std::list<EvictionEntryT>::iterator>
+      MEvictionMap;
+  size_t MCachedProgramsSize = 0;
+  std::mutex MEvictionListMutex;
+
+  const size_t MMaxCachedProgramsSize;
+  std::atomic<size_t> MActiveUsers{0};
+  std::atomic<bool> MEvictionPending{false};
+
+  std::atomic<size_t> MNumProgramCacheHits{0};
+  std::atomic<size_t> MNumProgramCacheMisses{0};
+  std::atomic<size_t> MNumEvictedPrograms{0};
   friend class ::MockKernelProgramCache;
 };
 } // namespace detail
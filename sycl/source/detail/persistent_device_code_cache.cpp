@@ -7,13 +7,23 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/device_impl.hpp>
+#include <detail/global_handler.hpp>
 #include <detail/persistent_device_code_cache.hpp>
 #include <detail/plugin.hpp>
 #include <detail/program_manager/program_manager.hpp>
+#include <detail/thread_pool.hpp>
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <fstream>
+#include <mutex>
 #include <optional>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 #if defined(__SYCL_RT_OS_POSIX_SUPPORT)
 #include <unistd.h>
@@ -82,30 +92,13 @@ bool PersistentDeviceCodeCache::isImageCached(const RTDeviceBinaryImage &Img) {
   return true;
 }
 
-/* Stores built program in persisten cache
+/* Returns device code of the built program for each of its devices
  */
-void PersistentDeviceCodeCache::putItemToDisc(
-    const device &Device, const RTDeviceBinaryImage &Img,
-    const SerializedObj &SpecConsts, const std::string &BuildOptionsString,
-    const sycl::detail::pi::PiProgram &NativePrg) {
-
-  if (!isImageCached(Img))
-    return;
-
-  std::string DirName =
-      getCacheItemPath(Device, Img, SpecConsts, BuildOptionsString);
-
-  if (DirName.empty())
-    return;
-
+static std::vector<std::vector<char>>
+getProgramBinaryData(const device &Device,
+                     const sycl::detail::pi::PiProgram &NativePrg) {
   auto Plugin = detail::getSyclObjImpl(Device)->getPlugin();
 
-  size_t i = 0;
-  std::string FileName;
-  do {
-    FileName = DirName + "/" + std::to_string(i++);
-  } while (OSUtil::isPathPresent(FileName + ".bin"));
-
   unsigned int DeviceNum = 0;
 
   Plugin->call<PiApiKind::piProgramGetInfo>(
@@ -127,22 +120,365 @@ void PersistentDeviceCodeCache::putItemToDisc(
   Plugin->call<PiApiKind::piProgramGetInfo>(NativePrg, PI_PROGRAM_INFO_BINARIES,
                                             sizeof(char *) * Pointers.size(),
                                             Pointers.data(), nullptr);
+  return Result;
+}
+
+/* Returns the contents of the device image
+ */
+static std::string_view getImageData(const RTDeviceBinaryImage &Img) {
+  if (!Img.getRawData().BinaryStart)
+    return {};
+  return {(const char *)Img.getRawData().BinaryStart, Img.getSize()};
+}
+
+/* Stores built program in persisten cache
+ */
+void PersistentDeviceCodeCache::putItemToDisc(
+    const device &Device, const RTDeviceBinaryImage &Img,
+    const SerializedObj &SpecConsts, const std::string &BuildOptionsString,
+    const sycl::detail::pi::PiProgram &NativePrg) {
+
+  if (!isImageCached(Img))
+    return;
+
+  std::string DirName =
+      getCacheItemPath(Device, Img, SpecConsts, BuildOptionsString);
+
+  if (DirName.empty())
+    return;
+
+  writeCacheItem(DirName, getProgramBinaryData(Device, NativePrg),
+                 getDeviceIDString(Device), getImageData(Img), SpecConsts,
+                 BuildOptionsString);
+}
+
+/* Stores built program in persistent cache in background. Only the program
+ * binaries and the device information are queried on the calling thread.
+ */
+void PersistentDeviceCodeCache::putItemToDiscAsync(
+    const device &Device, const RTDeviceBinaryImage &Img,
+    const SerializedObj &SpecConsts, const std::string &BuildOptionsString,
+    const sycl::detail::pi::PiProgram &NativePrg) {
+#ifdef _WIN32
+  // Worker threads may be terminated before the runtime is shut down on
+  // Windows, which would leave partially written cache items behind.
+  putItemToDisc(Device, Img, SpecConsts, BuildOptionsString, NativePrg);
+#else
+  if (!isImageCached(Img))
+    return;
+
+  std::string DirName =
+      getCacheItemPath(Device, Img, SpecConsts, BuildOptionsString);
+
+  if (DirName.empty())
+    return;
+
+  // Items which are being written by this process are not visible to
+  // getItemFromDisc yet, don't let rebuilds of them produce duplicates.
+  static std::mutex PendingItemsMutex;
+  static std::unordered_set<std::string> PendingItems;
+
+  std::vector<std::vector<char>> Binaries =
+      getProgramBinaryData(Device, NativePrg);
+  std::string DeviceString = getDeviceIDString(Device);
+  {
+    std::lock_guard<std::mutex> Lock(PendingItemsMutex);
+    if (!PendingItems.insert(DirName).second)
+      return;
+  }
+
+  // The device image is copied, it is unregistered and its memory may be
+  // unmapped when the library containing it is unloaded.
+  GlobalHandler::instance().getPersistentCacheWriterThreadPool().submit(
+      [DirName = std::move(DirName), Binaries = std::move(Binaries),
+       DeviceString = std::move(DeviceString),
+       ImgData = std::string{getImageData(Img)}, SpecConsts,
+       BuildOptionsString]() {
+        writeCacheItem(DirName, Binaries, DeviceString, ImgData, SpecConsts,
+                       BuildOptionsString);
+        std::lock_guard<std::mutex> Lock(PendingItemsMutex);
+        PendingItems.erase(DirName);
+      });
+#endif
+}
+
+/* Name of the cache index file in the cache root */
+static constexpr char IndexFileName[] = "index";
+
+/* Returns path of the cache item relative to the cache root */
+static std::string getRelativeItemPath(const std::string &Root,
+                                       const std::string &ItemPath) {
+  if (ItemPath.size() > Root.size() &&
+      ItemPath.compare(0, Root.size(), Root) == 0)
+    return ItemPath.substr(Root.size() + 1);
+  return ItemPath;
+}
+
+/* Returns size of the file or 0 if it can't be read */
+static size_t getFileSize(const std::string &FileName) {
+  std::ifstream FileStream{FileName, std::ios::binary | std::ios::ate};
+  auto Size = FileStream.tellg();
+  return FileStream.fail() ? 0 : static_cast<size_t>(Size);
+}
+
+/* Writes binary and source files of a new cache item to the specified cache
+ * item directory.
+ */
+void PersistentDeviceCodeCache::writeCacheItem(
+    const std::string &DirName, const std::vector<std::vector<char>> &Binaries,
+    const std::string &DeviceString, std::string_view ImgData,
+    const SerializedObj &SpecConsts, const std::string &BuildOptionsString) {
+  size_t i = 0;
+  std::string FileName{DirName + "/" + std::to_string(i)};
+  while (OSUtil::isPathPresent(FileName + ".bin")) {
+    // The same item may have been stored by another process in the meantime,
+    // e.g. when many processes build the same program on a cold cache.
+    if (!LockCacheItem::isLocked(FileName) &&
+        std::ifstream{FileName + ".bin"}.good() &&
+        isCacheItemSrcEqual(FileName + ".src", DeviceString, ImgData,
+                            SpecConsts, BuildOptionsString)) {
+      trace("device binary is already cached: " + FileName + ".bin");
+      return;
+    }
+    FileName = DirName + "/" + std::to_string(++i);
+  }
 
   try {
     OSUtil::makeDir(DirName.c_str());
     LockCacheItem Lock{FileName};
     if (Lock.isOwned()) {
       std::string FullFileName = FileName + ".bin";
-      writeBinaryDataToFile(FullFileName, Result);
+      writeBinaryDataToFile(FullFileName, Binaries);
       trace("device binary has been cached: " + FullFileName);
-      writeSourceItem(FileName + ".src", Device, Img, SpecConsts,
+      writeSourceItem(FileName + ".src", DeviceString, ImgData, SpecConsts,
                       BuildOptionsString);
+
+      std::string ItemPath = getRelativeItemPath(getRootDir(), FileName);
+      appendIndexRecord('A', ItemPath,
+                        getFileSize(FullFileName) +
+                            getFileSize(FileName + ".src"));
+      evictItemsIfNeeded(ItemPath);
     }
   } catch (...) {
     // If a problem happens on storing cache item, do nothing
   }
 }
 
+/* Appends a record to the cache index. Format of the record is
+ * "<op> <time> <size> <item path>", where op is one of:
+ *   A - item is added, size is the total size of the item files;
+ *   U - item is used;
+ *   R - item is removed.
+ */
+void PersistentDeviceCodeCache::appendIndexRecord(char Op,
+                                                  const std::string &ItemPath,
+                                                  size_t Size) {
+  if (SYCLConfig<SYCL_CACHE_EVICTION_DISABLE>::get())
+    return;
+
+  std::string FileName{getRootDir() + "/" + IndexFileName};
+  std::string Record = std::string(1, Op) + " " +
+                       std::to_string(std::time(nullptr)) + " " +
+                       std::to_string(Size) + " " + ItemPath + "\n";
+
+  // The record is written with a single call to be appended atomically, so
+  // processes sharing the cache don't need to lock the index.
+  int fd = open(FileName.c_str(), O_WRONLY | O_APPEND | O_CREAT,
+                S_IREAD | S_IWRITE);
+  if (fd == -1) {
+    trace("Failed to open cache index: " + FileName);
+    return;
+  }
+  auto Written = write(fd, Record.data(), Record.size());
+  if (Written < 0 || static_cast<size_t>(Written) != Record.size())
+    trace("Failed to write cache index: " + FileName);
+  close(fd);
+}
+
+/* Use records only order cache items by the time they were last used, so
+ * each process records the use of an item at most once per this many seconds.
+ * Reading from the cache then doesn't write the index on every hit.
+ */
+static constexpr long long UseRecordInterval = 60 * 60;
+
+void PersistentDeviceCodeCache::recordItemUse(const std::string &ItemPath) {
+  if (SYCLConfig<SYCL_CACHE_EVICTION_DISABLE>::get())
+    return;
+
+  static std::mutex RecordedUsesMutex;
+  static std::unordered_map<std::string, long long> RecordedUses;
+  const long long Now = std::time(nullptr);
+  {
+    std::lock_guard<std::mutex> Lock(RecordedUsesMutex);
+    auto [It, Inserted] =
+        RecordedUses.try_emplace(getRootDir() + "/" + ItemPath, Now);
+    if (!Inserted) {
+      if (Now - It->second < UseRecordInterval)
+        return;
+      It->second = Now;
+    }
+  }
+  appendIndexRecord('U', ItemPath, 0);
+}
+
+namespace {
+struct IndexEntry {
+  size_t Size = 0;
+  long long LastUse = 0;
+};
+} // namespace
+
+/* Reads cache index from the stream and returns items listed in it.
+ * Malformed records are skipped. NumRecords is set to the number of records
+ * read.
+ */
+static std::unordered_map<std::string, IndexEntry>
+readCacheIndex(std::istream &FileStream, size_t &NumRecords) {
+  std::unordered_map<std::string, IndexEntry> Entries;
+  std::string Line;
+  NumRecords = 0;
+  while (std::getline(FileStream, Line)) {
+    ++NumRecords;
+    std::istringstream Record{Line};
+    char Op = 0;
+    long long Time = 0;
+    size_t Size = 0;
+    std::string Path, Rest;
+    if (!(Record >> Op >> Time >> Size >> Path) || (Record >> Rest))
+      continue;
+
+    if (Op == 'A') {
+      Entries[Path] = {Size, Time};
+    } else if (Op == 'U') {
+      auto It = Entries.find(Path);
+      if (It != Entries.end())
+        It->second.LastUse = std::max(It->second.LastUse, Time);
+    } else if (Op == 'R') {
+      Entries.erase(Path);
+    }
+  }
+  return Entries;
+}
+
+static std::unordered_map<std::string, IndexEntry>
+readCacheIndex(const std::string &FileName, size_t &NumRecords) {
+  std::ifstream FileStream{FileName};
+  return readCacheIndex(FileStream, NumRecords);
+}
+
+/* Evicts cache items listed in the cache index in least recently used order
+ * until the total size fits SYCL_CACHE_MAX_SIZE, items which were not used
+ * for SYCL_CACHE_THRESHOLD days are evicted as well. The index is compacted
+ * afterwards.
+ */
+void PersistentDeviceCodeCache::evictItemsIfNeeded(
+    const std::string &NewItemPath) {
+  if (SYCLConfig<SYCL_CACHE_EVICTION_DISABLE>::get())
+    return;
+
+  const unsigned long long MaxSize =
+      getNumParam<SYCL_CACHE_MAX_SIZE>(DEFAULT_MAX_CACHE_SIZE_MB) * 1024ull *
+      1024ull;
+  const long long Threshold =
+      getNumParam<SYCL_CACHE_THRESHOLD>(DEFAULT_CACHE_THRESHOLD_DAYS) * 24ll *
+      60ll * 60ll;
+  const long long Now = std::time(nullptr);
+
+  std::string Root{getRootDir()};
+  std::string FileName{Root + "/" + IndexFileName};
+
+  size_t NumRecords = 0;
+  unsigned long long TotalSize = 0;
+  auto IsExpired = [&](const std::string &Path, const IndexEntry &Entry) {
+    return Threshold && Path != NewItemPath && Entry.LastUse + Threshold < Now;
+  };
+  auto IsEvictionNeeded = [&](const auto &Entries) {
+    TotalSize = 0;
+    bool HasExpired = false;
+    for (const auto &[Path, Entry] : Entries) {
+      TotalSize += Entry.Size;
+      HasExpired = HasExpired || IsExpired(Path, Entry);
+    }
+    // Use records are appended on every cache hit, so the index is compacted
+    // once it mostly consists of outdated records.
+    return (MaxSize && TotalSize > MaxSize) || HasExpired ||
+           NumRecords > std::max<size_t>(1024, 2 * Entries.size());
+  };
+
+  if (!IsEvictionNeeded(readCacheIndex(FileName, NumRecords)))
+    return;
+
+  // Only one process evicts items at a time, others don't wait for it.
+  LockCacheItem Lock{Root + "/eviction"};
+  if (!Lock.isOwned())
+    return;
+
+  // The index must be read again as it may have been compacted by another
+  // process in the meantime. The stream is kept open to pick up records
+  // appended by other processes while the index is compacted.
+  std::ifstream IndexStream{FileName};
+  auto Entries = readCacheIndex(IndexStream, NumRecords);
+  if (!IsEvictionNeeded(Entries))
+    return;
+
+  std::vector<std::pair<std::string, IndexEntry>> Items(Entries.begin(),
+                                                        Entries.end());
+  std::sort(Items.begin(), Items.end(), [](const auto &LHS, const auto &RHS) {
+    return LHS.second.LastUse < RHS.second.LastUse;
+  });
+
+  std::string CompactedIndex;
+  std::vector<std::string> EvictedItems;
+  for (const auto &[Path, Entry] : Items) {
+    std::string ItemName{Root + "/" + Path};
+    bool Evict = IsExpired(Path, Entry) ||
+                 (MaxSize && TotalSize > MaxSize && Path != NewItemPath);
+    if (Evict && !LockCacheItem::isLocked(ItemName)) {
+      std::remove((ItemName + ".bin").c_str());
+      std::remove((ItemName + ".src").c_str());
+      TotalSize -= std::min<unsigned long long>(TotalSize, Entry.Size);
+      EvictedItems.push_back(Path);
+      trace("cache item has been evicted: " + ItemName);
+      continue;
+    }
+    CompactedIndex += "A " + std::to_string(Entry.LastUse) + " " +
+                      std::to_string(Entry.Size) + " " + Path + "\n";
+  }
+
+  // The compacted index atomically replaces the old one. Other processes
+  // keep appending to the old index until the rename, the records they have
+  // written since it was read are then moved to the new index. The appends
+  // go through appendIndexRecord, so each record is written at once.
+  std::string TmpFileName{FileName + ".tmp"};
+  {
+    std::ofstream FileStream{TmpFileName, std::ios::trunc};
+    FileStream << CompactedIndex;
+    FileStream.close();
+    if (!FileStream.fail() &&
+        !std::rename(TmpFileName.c_str(), FileName.c_str())) {
+      IndexStream.clear();
+      std::string Line;
+      while (std::getline(IndexStream, Line)) {
+        std::istringstream Record{Line};
+        char Op = 0;
+        long long Time = 0;
+        size_t Size = 0;
+        std::string Path;
+        if (Record >> Op >> Time >> Size >> Path)
+          appendIndexRecord(Op, Path, Size);
+      }
+      return;
+    }
+  }
+
+  // Replacing the index may fail, e.g. on Windows where rename doesn't
+  // overwrite existing files. Fall back to recording removals.
+  trace("Failed to compact cache index: " + FileName);
+  std::remove(TmpFileName.c_str());
+  for (const std::string &Path : EvictedItems)
+    appendIndexRecord('R', Path, 0);
+}
+
 /* Program binaries built for one or more devices are read from persistent
  * cache and returned in form of vector of programs. Each binary program is
  * stored in vector of chars.
@@ -162,18 +498,22 @@ std::vector<std::vector<char>> PersistentDeviceCodeCache::getItemFromDisc(
 
   int i = 0;
 
+  std::string DeviceString{getDeviceIDString(Device)};
   std::string FileName{Path + "/" + std::to_string(i)};
   while (OSUtil::isPathPresent(FileName + ".bin") ||
          OSUtil::isPathPresent(FileName + ".src")) {
 
     if (!LockCacheItem::isLocked(FileName) &&
-        isCacheItemSrcEqual(FileName + ".src", Device, Img, SpecConsts,
+        isCacheItemSrcEqual(FileName + ".src", DeviceString,
+                            getImageData(Img), SpecConsts,
                             BuildOptionsString)) {
       try {
         std::string FullFileName = FileName + ".bin";
         std::vector<std::vector<char>> res =
             readBinaryDataFromFile(FullFileName);
         trace("using cached device binary: " + FullFileName);
+        if (!res.empty())
+          recordItemUse(getRelativeItemPath(getRootDir(), FileName));
         return res; // subject for NRVO
       } catch (...) {
         // If read was unsuccessfull try the next item
@@ -247,12 +587,11 @@ PersistentDeviceCodeCache::readBinaryDataFromFile(const std::string &FileName) {
  * constant values, device code SPIR-V image.
  */
 void PersistentDeviceCodeCache::writeSourceItem(
-    const std::string &FileName, const device &Device,
-    const RTDeviceBinaryImage &Img, const SerializedObj &SpecConsts,
+    const std::string &FileName, const std::string &DeviceString,
+    std::string_view ImgData, const SerializedObj &SpecConsts,
     const std::string &BuildOptionsString) {
   std::ofstream FileStream{FileName, std::ios::binary};
 
-  std::string DeviceString{getDeviceIDString(Device)};
   size_t Size = DeviceString.size();
   FileStream.write((char *)&Size, sizeof(Size));
   FileStream.write(DeviceString.data(), Size);
@@ -265,9 +604,9 @@ void PersistentDeviceCodeCache::writeSourceItem(
   FileStream.write((char *)&Size, sizeof(Size));
   FileStream.write((const char *)SpecConsts.data(), Size);
 
-  Size = Img.getSize();
+  Size = ImgData.size();
   FileStream.write((char *)&Size, sizeof(Size));
-  FileStream.write((const char *)Img.getRawData().BinaryStart, Size);
+  FileStream.write(ImgData.data(), Size);
   FileStream.close();
 
   if (FileStream.fail()) {
@@ -279,45 +618,35 @@ void PersistentDeviceCodeCache::writeSourceItem(
  * If file read operations fail cache item is treated as not equal.
  */
 bool PersistentDeviceCodeCache::isCacheItemSrcEqual(
-    const std::string &FileName, const device &Device,
-    const RTDeviceBinaryImage &Img, const SerializedObj &SpecConsts,
+    const std::string &FileName, const std::string &DeviceString,
+    std::string_view ImgData, const SerializedObj &SpecConsts,
     const std::string &BuildOptionsString) {
   std::ifstream FileStream{FileName, std::ios::binary};
 
-  std::string ImgString{(const char *)Img.getRawData().BinaryStart,
-                        Img.getSize()};
-  std::string SpecConstsString{(const char *)SpecConsts.data(),
-                               SpecConsts.size()};
-
-  size_t Size = 0;
-  FileStream.read((char *)&Size, sizeof(Size));
-  std::string res(Size, '\0');
-  FileStream.read(&res[0], Size);
-  if (getDeviceIDString(Device).compare(res))
+  // Sizes are compared before the values are read, so that a mismatch does
+  // not require reading the rest of the item, which includes the whole
+  // device image.
+  std::vector<char> Value;
+  auto ReadAndCompare = [&FileStream, &Value](const void *Expected,
+                                              size_t ExpectedSize) {
+    size_t Size = 0;
+    FileStream.read((char *)&Size, sizeof(Size));
+    if (FileStream.fail() || Size != ExpectedSize)
+      return false;
+    if (Size == 0)
+      return true;
+    Value.resize(Size);
+    FileStream.read(Value.data(), Size);
+    return !FileStream.fail() && !std::memcmp(Value.data(), Expected, Size);
+  };
+
+  if (!ReadAndCompare(DeviceString.data(), DeviceString.size()) ||
+      !ReadAndCompare(BuildOptionsString.data(), BuildOptionsString.size()) ||
+      !ReadAndCompare(SpecConsts.data(), SpecConsts.size()) ||
+      !ReadAndCompare(ImgData.data(), ImgData.size())) {
+    if (FileStream.fail())
+      trace("Failed to read source file from " + FileName);
     return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (BuildOptionsString.compare(res))
-    return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (SpecConstsString.compare(res))
-    return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (ImgString.compare(res))
-    return false;
-
-  FileStream.close();
-
-  if (FileStream.fail()) {
-    trace("Failed to read source file from " + FileName);
   }
 
   return true;
@@ -335,14 +664,14 @@ std::string PersistentDeviceCodeCache::getCacheItemPath(
     return {};
   }
 
-  std::string ImgString = "";
-  if (Img.getRawData().BinaryStart)
-    ImgString.assign((const char *)Img.getRawData().BinaryStart, Img.getSize());
+  // Views are hashed to avoid copying the device image, the hashes are the
+  // same as for the equivalent std::string values.
+  std::string_view ImgString = getImageData(Img);
 
   std::string DeviceString{getDeviceIDString(Device)};
-  std::string SpecConstsString{(const char *)SpecConsts.data(),
-                               SpecConsts.size()};
-  std::hash<std::string> StringHasher{};
+  std::string_view SpecConstsString{(const char *)SpecConsts.data(),
+                                    SpecConsts.size()};
+  std::hash<std::string_view> StringHasher{};
 
   return cache_root + "/" + std::to_string(StringHasher(DeviceString)) + "/" +
          std::to_string(StringHasher(ImgString)) + "/" +
@@ -350,6 +679,163 @@ std::string PersistentDeviceCodeCache::getCacheItemPath(
          std::to_string(StringHasher(BuildOptionsString));
 }
 
+/* Writing keyed cache item key sources
+ * Format: Two pairs of [size, value] for device and the key of the item.
+ */
+static void writeKeyedItemSourceItem(const std::string &FileName,
+                                     const std::string &DeviceString,
+                                     const std::string &Key) {
+  std::ofstream FileStream{FileName, std::ios::binary};
+  for (const std::string *Value : {&DeviceString, &Key}) {
+    size_t Size = Value->size();
+    FileStream.write((char *)&Size, sizeof(Size));
+    FileStream.write(Value->data(), Size);
+  }
+  FileStream.close();
+
+  if (FileStream.fail()) {
+    PersistentDeviceCodeCache::trace("Failed to write source file to " +
+                                     FileName);
+  }
+}
+
+/* Check that keyed cache item key sources are equal to the current key.
+ */
+static bool isKeyedItemSourceEqual(const std::string &FileName,
+                                   const std::string &DeviceString,
+                                   const std::string &Key) {
+  std::ifstream FileStream{FileName, std::ios::binary};
+  std::string Value;
+  for (const std::string *Expected : {&DeviceString, &Key}) {
+    size_t Size = 0;
+    FileStream.read((char *)&Size, sizeof(Size));
+    if (FileStream.fail() || Size != Expected->size())
+      return false;
+    Value.resize(Size);
+    FileStream.read(Value.data(), Size);
+    if (FileStream.fail() || Value != *Expected)
+      return false;
+  }
+  return true;
+}
+
+std::vector<char> PersistentDeviceCodeCache::getKeyedItemFromDisc(
+    const device &Device, const std::string &Category, const std::string &Key) {
+  if (!isEnabled())
+    return {};
+
+  std::string Path = getKeyedItemPath(Device, Category, Key);
+  if (Path.empty() || !OSUtil::isPathPresent(Path))
+    return {};
+
+  std::string DeviceString{getDeviceIDString(Device)};
+  int i = 0;
+  std::string FileName{Path + "/" + std::to_string(i)};
+  while (OSUtil::isPathPresent(FileName + ".bin") ||
+         OSUtil::isPathPresent(FileName + ".src")) {
+    if (!LockCacheItem::isLocked(FileName) &&
+        isKeyedItemSourceEqual(FileName + ".src", DeviceString, Key)) {
+      try {
+        std::string FullFileName = FileName + ".bin";
+        std::vector<std::vector<char>> Res =
+            readBinaryDataFromFile(FullFileName);
+        if (Res.size() == 1) {
+          trace("using cached " + Category + " item: " + FullFileName);
+          recordItemUse(getRelativeItemPath(getRootDir(), FileName));
+          return std::move(Res[0]);
+        }
+      } catch (...) {
+        // If read was unsuccessfull try the next item
+      }
+    }
+    FileName = Path + "/" + std::to_string(++i);
+  }
+  return {};
+}
+
+void PersistentDeviceCodeCache::putKeyedItemToDisc(
+    const device &Device, const std::string &Category, const std::string &Key,
+    const std::vector<char> &Data) {
+  if (!isEnabled())
+    return;
+
+  std::string DirName = getKeyedItemPath(Device, Category, Key);
+  if (DirName.empty())
+    return;
+
+  std::string DeviceString{getDeviceIDString(Device)};
+  size_t i = 0;
+  std::string FileName{DirName + "/" + std::to_string(i)};
+  while (OSUtil::isPathPresent(FileName + ".bin")) {
+    if (!LockCacheItem::isLocked(FileName) &&
+        isKeyedItemSourceEqual(FileName + ".src", DeviceString, Key)) {
+      trace(Category + " item is already cached: " + FileName + ".bin");
+      return;
+    }
+    FileName = DirName + "/" + std::to_string(++i);
+  }
+
+  try {
+    OSUtil::makeDir(DirName.c_str());
+    LockCacheItem Lock{FileName};
+    if (Lock.isOwned()) {
+      std::string FullFileName = FileName + ".bin";
+      writeBinaryDataToFile(FullFileName, {Data});
+      trace(Category + " item has been cached: " + FullFileName);
+      writeKeyedItemSourceItem(FileName + ".src", DeviceString, Key);
+
+      std::string ItemPath = getRelativeItemPath(getRootDir(), FileName);
+      appendIndexRecord('A', ItemPath,
+                        getFileSize(FullFileName) +
+                            getFileSize(FileName + ".src"));
+      evictItemsIfNeeded(ItemPath);
+    }
+  } catch (...) {
+    // If a problem happens on storing cache item, do nothing
+  }
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getFusedKernelFromDisc(const device &Device,
+                                                  const std::string &Key) {
+  return getKeyedItemFromDisc(Device, "fusion", Key);
+}
+
+void PersistentDeviceCodeCache::putFusedKernelToDisc(
+    const device &Device, const std::string &Key,
+    const std::vector<char> &Data) {
+  putKeyedItemToDisc(Device, "fusion", Key, Data);
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getReductionTuningFromDisc(const device &Device,
+                                                      const std::string &Key) {
+  return getKeyedItemFromDisc(Device, "reduction", Key);
+}
+
+void PersistentDeviceCodeCache::putReductionTuningToDisc(
+    const device &Device, const std::string &Key,
+    const std::vector<char> &Data) {
+  putKeyedItemToDisc(Device, "reduction", Key, Data);
+}
+
+/* Returns directory name to store an item of the category for specified
+ * device and key.
+ */
+std::string PersistentDeviceCodeCache::getKeyedItemPath(
+    const device &Device, const std::string &Category, const std::string &Key) {
+  std::string cache_root{getRootDir()};
+  if (cache_root.empty()) {
+    trace("Disable persistent cache due to unconfigured cache root.");
+    return {};
+  }
+
+  std::hash<std::string> StringHasher{};
+  return cache_root + "/" + Category + "/" +
+         std::to_string(StringHasher(getDeviceIDString(Device))) + "/" +
+         std::to_string(StringHasher(Key));
+}
+
 /* Returns true if persistent cache is enabled.
  */
 bool PersistentDeviceCodeCache::isEnabled() {
@@ -12,6 +12,7 @@
 #include <detail/device_binary_image.hpp>
 #include <fcntl.h>
 #include <string>
+#include <string_view>
 #include <sycl/detail/os_util.hpp>
 #include <sycl/detail/pi.hpp>
 #include <sycl/detail/util.hpp>
@@ -66,6 +67,8 @@ class PersistentDeviceCodeCache {
    *                     <n>.src
    *                     <n>.bin
    *                     .lock
+   *     index
+   *     eviction.lock
    *   <cache_root>                 - root directory storing cache files;
    *   <device_hash>                - hash out of device information used to
    *                                  identify target device;
@@ -87,6 +90,19 @@ class PersistentDeviceCodeCache {
    *   <n>.lock - cache item lock file. It is created when data is saved to
    *              filesystem. On read operation the absence of file is checked
    *              but it is not created to avoid lock.
+   * Two files are stored in the cache root:
+   *   index         - append-only log of cache item additions and uses, every
+   *                   record is written with a single append so that processes
+   *                   sharing the cache do not need to lock it. Total size and
+   *                   last use time of the items are recovered from it, so the
+   *                   cache tree is never scanned. Malformed records, e.g. ones
+   *                   interleaved on network file systems, are ignored.
+   *   eviction.lock - lock file held by the process evicting cache items and
+   *                   compacting the index.
+   * Cache items are evicted in least recently used order once the total size
+   * exceeds SYCL_CACHE_MAX_SIZE megabytes or when the items were not used for
+   * SYCL_CACHE_THRESHOLD days. Items not listed in the index, e.g. ones
+   * created by earlier versions of the runtime, are never evicted.
    * All filesystem operation failures are not treated as SYCL errors and
    * ignored. If such errors happen warning messages are written to std::cerr
    * and:
@@ -110,19 +126,47 @@ private:
    * Format: Four pairs of [size, value] for device, build options,
    * specialization constant values, device code SPIR-V image.
    */
-  static void writeSourceItem(const std::string &FileName, const device &Device,
-                              const RTDeviceBinaryImage &Img,
+  static void writeSourceItem(const std::string &FileName,
+                              const std::string &DeviceString,
+                              std::string_view ImgData,
                               const SerializedObj &SpecConsts,
                               const std::string &BuildOptionsString);
 
+  /* Writing binary and source files of a new cache item in the cache item
+   * directory
+   */
+  static void writeCacheItem(const std::string &DirName,
+                             const std::vector<std::vector<char>> &Binaries,
+                             const std::string &DeviceString,
+                             std::string_view ImgData,
+                             const SerializedObj &SpecConsts,
+                             const std::string &BuildOptionsString);
+
   /* Check that cache item key sources are equal to the current program
    */
   static bool isCacheItemSrcEqual(const std::string &FileName,
-                                  const device &Device,
-                                  const RTDeviceBinaryImage &Img,
+                                  const std::string &DeviceString,
+                                  std::string_view ImgData,
                                   const SerializedObj &SpecConsts,
                                   const std::string &BuildOptionsString);
 
+  /* Appends a record for the cache item to the cache index, the item path is
+   * relative to the cache root.
+   */
+  static void appendIndexRecord(char Op, const std::string &ItemPath,
+                                size_t Size);
+
+  /* Records a use of the cache item in the cache index unless this process
+   * has recorded one recently.
+   */
+  static void recordItemUse(const std::string &ItemPath);
+
+  /* Evicts least recently used and expired cache items listed in the cache
+   * index if the cache limits are exceeded. The item which has just been
+   * added is never evicted.
+   */
+  static void evictItemsIfNeeded(const std::string &NewItemPath);
+
   /* Check if on-disk cache enabled.
    */
   static bool isEnabled();
@@ -130,6 +174,30 @@ private:
   /* Returns the path to directory storing persistent device code cache.*/
   static std::string getRootDir();
 
+  /* Get directory name for storing an item of a category identified by a key
+   */
+  static std::string getKeyedItemPath(const device &Device,
+                                      const std::string &Category,
+                                      const std::string &Key);
+
+  /* Keyed items are stored in <cache_root>/<category>/<device_hash>/<key_hash>
+   * directories with the same layout of cache items as device code images.
+   * The device string and the key are stored as the item source. The cache
+   * item data is returned as is, it is empty in case of a cache miss or if
+   * the cache is disabled.
+   */
+  static std::vector<char> getKeyedItemFromDisc(const device &Device,
+                                                const std::string &Category,
+                                                const std::string &Key);
+
+  /* Stores a keyed item in persistent cache, an existing item with the same
+   * key is kept.
+   */
+  static void putKeyedItemToDisc(const device &Device,
+                                 const std::string &Category,
+                                 const std::string &Key,
+                                 const std::vector<char> &Data);
+
   /* Form string representing device version */
   static std::string getDeviceIDString(const device &Device);
 
@@ -159,6 +227,13 @@ private:
   static constexpr unsigned long DEFAULT_MAX_DEVICE_IMAGE_SIZE =
       1024 * 1024 * 1024;
 
+  /* Default value for maximum total size of cache items in megabytes */
+  static constexpr unsigned long DEFAULT_MAX_CACHE_SIZE_MB = 8192;
+
+  /* Default value for the number of days after which unused cache items are
+   * evicted */
+  static constexpr unsigned long DEFAULT_CACHE_THRESHOLD_DAYS = 7;
+
 public:
   /* Get directory name for storing current cache item
    */
@@ -184,6 +259,39 @@ public:
                             const std::string &BuildOptionsString,
                             const sycl::detail::pi::PiProgram &NativePrg);
 
+  /* Stores build program in persistent cache, the files are written by a
+   * background thread
+   */
+  static void putItemToDiscAsync(const device &Device,
+                                 const RTDeviceBinaryImage &Img,
+                                 const SerializedObj &SpecConsts,
+                                 const std::string &BuildOptionsString,
+                                 const sycl::detail::pi::PiProgram &NativePrg);
+
+  /* Fused kernels are stored as keyed items of the "fusion" category, the key
+   * identifies the fusion.
+   */
+  static std::vector<char> getFusedKernelFromDisc(const device &Device,
+                                                  const std::string &Key);
+
+  /* Stores a fused kernel in persistent cache
+   */
+  static void putFusedKernelToDisc(const device &Device,
+                                   const std::string &Key,
+                                   const std::vector<char> &Data);
+
+  /* Results of the reduction auto-tuner are stored as keyed items of the
+   * "reduction" category, the key identifies the tuned reduction.
+   */
+  static std::vector<char> getReductionTuningFromDisc(const device &Device,
+                                                      const std::string &Key);
+
+  /* Stores a result of the reduction auto-tuner in persistent cache
+   */
+  static void putReductionTuningToDisc(const device &Device,
+                                       const std::string &Key,
+                                       const std::vector<char> &Data);
+
   /* Sends message to std:cerr stream when SYCL_CACHE_TRACE environemnt is set*/
   static void trace(const std::string &msg) {
     static const char *TraceEnabled = SYCLConfig<SYCL_CACHE_TRACE>::get();
@@ -0,0 +1,78 @@
+//==--- persistent_fused_kernels.hpp - Fused kernels in persistent cache ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <detail/persistent_device_code_cache.hpp>
+#include <sycl/device.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Fused kernels stored in or loaded from the persistent device code cache by
+/// their names. The names of persisted fused kernels are derived from the keys
+/// of the fusions, so a name can clash with the one of a different fusion.
+class PersistentFusedKernels {
+public:
+  /// \return true if a fusion other than the one identified by \p Key is
+  /// known under \p Name.
+  bool clashes(const std::string &Name, const std::string &Key) const {
+    auto It = MKernels.find(Name);
+    return It != MKernels.end() && It->second.Key != Key;
+  }
+
+  /// Looks up the serialized fused kernel \p Name of the fusion identified by
+  /// \p Key, first in memory, then in the persistent cache of \p Device.
+  ///
+  /// \param FromDisc is set if the kernel was loaded from the persistent cache,
+  /// i.e. its image isn't known to this process yet.
+  /// \return the serialized kernel, or nullptr if it isn't known.
+  const std::vector<char> *find(const device &Device, const std::string &Name,
+                                const std::string &Key, bool &FromDisc) {
+    FromDisc = false;
+    auto It = MKernels.find(Name);
+    if (It != MKernels.end())
+      return It->second.Key == Key ? &It->second.Data : nullptr;
+    std::vector<char> Data =
+        PersistentDeviceCodeCache::getFusedKernelFromDisc(Device, Key);
+    if (Data.empty())
+      return nullptr;
+    FromDisc = true;
+    Entry &New = MKernels[Name];
+    New = {Key, std::move(Data)};
+    return &New.Data;
+  }
+
+  /// Stores the serialized fused kernel \p Name of the fusion identified by
+  /// \p Key in memory and in the persistent cache of \p Device.
+  void add(const device &Device, const std::string &Name,
+           const std::string &Key, std::vector<char> Data) {
+    PersistentDeviceCodeCache::putFusedKernelToDisc(Device, Key, Data);
+    MKernels[Name] = {Key, std::move(Data)};
+  }
+
+  /// Forgets about the fused kernel \p Name, e.g. if its data is corrupted.
+  void erase(const std::string &Name) { MKernels.erase(Name); }
+
+private:
+  struct Entry {
+    std::string Key;
+    /// Serialized kernel information including the binary of the kernel.
+    std::vector<char> Data;
+  };
+  std::unordered_map<std::string, Entry> MKernels;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <map>
@@ -140,6 +141,16 @@ void emitFunctionEndTrace(uint64_t CorrelationID, const char *FName) {
 #endif // XPTI_ENABLE_INSTRUMENTATION
 }
 
+bool isFunctionWithArgsTraceEnabled() {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  return xptiCheckTraceEnabled(
+      PiDebugCallStreamID,
+      (uint16_t)xpti::trace_point_type_t::function_with_args_begin);
+#else
+  return false;
+#endif
+}
+
 uint64_t emitFunctionWithArgsBeginTrace(uint32_t FuncID, const char *FuncName,
                                         unsigned char *ArgsData,
                                         pi_plugin Plugin) {
@@ -307,7 +318,6 @@ std::vector<std::pair<std::string, backend>> findPlugins() {
                              backend::ext_oneapi_level_zero);
     PluginNames.emplace_back(__SYCL_CUDA_PLUGIN_NAME, backend::ext_oneapi_cuda);
     PluginNames.emplace_back(__SYCL_HIP_PLUGIN_NAME, backend::ext_oneapi_hip);
-    PluginNames.emplace_back(__SYCL_UR_PLUGIN_NAME, backend::all);
     PluginNames.emplace_back(__SYCL_NATIVE_CPU_PLUGIN_NAME,
                              backend::ext_native_cpu);
   } else if (FilterList) {
@@ -353,7 +363,6 @@ std::vector<std::pair<std::string, backend>> findPlugins() {
         PluginNames.emplace_back(__SYCL_NATIVE_CPU_PLUGIN_NAME,
                                  backend::ext_native_cpu);
       }
-      PluginNames.emplace_back(__SYCL_UR_PLUGIN_NAME, backend::all);
     }
   } else {
     ods_target_list &list = *OdsTargetList;
@@ -379,8 +388,11 @@ std::vector<std::pair<std::string, backend>> findPlugins() {
       PluginNames.emplace_back(__SYCL_NATIVE_CPU_PLUGIN_NAME,
                                backend::ext_native_cpu);
     }
-    PluginNames.emplace_back(__SYCL_UR_PLUGIN_NAME, backend::all);
   }
+  // Platforms are only taken from the Unified Runtime plugin when it is
+  // preferred, so don't pay for loading and initializing it otherwise.
+  if (preferUR())
+    PluginNames.emplace_back(__SYCL_UR_PLUGIN_NAME, backend::all);
   return PluginNames;
 }
 
@@ -425,6 +437,14 @@ bool trace(TraceLevel Level) {
   return (TraceLevelMask & Level) == Level;
 }
 
+bool preferUR() {
+  static const bool PreferUR = [] {
+    const char *PreferURStr = std::getenv("SYCL_PREFER_UR");
+    return (PreferURStr && (std::stoi(PreferURStr) != 0));
+  }();
+  return PreferUR;
+}
+
 // Initializes all available Plugins.
 std::vector<PluginPtr> &initialize() {
   static std::once_flag PluginsInitDone;
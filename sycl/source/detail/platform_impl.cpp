@@ -140,11 +140,6 @@ std::vector<platform> platform_impl::get_platforms() {
     return Platforms;
   };
 
-  static const bool PreferUR = [] {
-    const char *PreferURStr = std::getenv("SYCL_PREFER_UR");
-    return (PreferURStr && (std::stoi(PreferURStr) != 0));
-  }();
-
   // See which platform we want to be served by which plugin.
   // There should be just one plugin serving each backend.
   std::vector<PluginPtr> &Plugins = sycl::detail::pi::initialize();
@@ -153,7 +148,7 @@ std::vector<platform> platform_impl::get_platforms() {
   // First check Unified Runtime
   // Keep track of backends covered by UR
   std::unordered_set<backend> BackendsUR;
-  if (PreferUR) {
+  if (sycl::detail::pi::preferUR()) {
     PluginPtr *PluginUR = nullptr;
     for (PluginPtr &Plugin : Plugins) {
       if (Plugin->hasBackend(backend::all)) { // this denotes UR
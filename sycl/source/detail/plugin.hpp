@@ -182,12 +182,13 @@ public:
     unsigned char *ArgsDataPtr = nullptr;
     using PackCallArgumentsTy =
         decltype(packCallArguments<PiApiOffset>(std::forward<ArgsT>(Args)...));
+    // Only pack the arguments if somebody listens to them.
+    const bool TraceArgs =
+        xptiTraceEnabled() && pi::isFunctionWithArgsTraceEnabled();
     auto ArgsData =
-        xptiTraceEnabled()
-            ? packCallArguments<PiApiOffset>(std::forward<ArgsT>(Args)...)
-            : PackCallArgumentsTy{};
-    // TODO check if stream is observed when corresponding API is present.
-    if (xptiTraceEnabled()) {
+        TraceArgs ? packCallArguments<PiApiOffset>(std::forward<ArgsT>(Args)...)
+                  : PackCallArgumentsTy{};
+    if (TraceArgs) {
       ArgsDataPtr = ArgsData.data();
       CorrelationIDWithArgs = pi::emitFunctionWithArgsBeginTrace(
           static_cast<uint32_t>(PiApiOffset), PIFnName, ArgsDataPtr, *MPlugin);
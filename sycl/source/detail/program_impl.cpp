@@ -245,10 +245,12 @@ void program_impl::build_with_kernel_name(std::string KernelName,
   if (!is_host()) {
     MProgramAndKernelCachingAllowed = true;
     MBuildOptions = BuildOptions;
+    ContextImplPtr ContextImpl = detail::getSyclObjImpl(get_context());
+    auto CacheGuard =
+        ContextImpl->getKernelProgramCache().acquireEvictionGuard();
     MProgram = ProgramManager::getInstance().getBuiltPIProgram(
-        detail::getSyclObjImpl(get_context()),
-        detail::getSyclObjImpl(get_devices()[0]), KernelName, this,
-        /*JITCompilationIsRequired=*/(!BuildOptions.empty()));
+        ContextImpl, detail::getSyclObjImpl(get_devices()[0]), KernelName,
+        this, /*JITCompilationIsRequired=*/(!BuildOptions.empty()));
     const PluginPtr &Plugin = getPlugin();
     Plugin->call<PiApiKind::piProgramRetain>(MProgram);
   }
@@ -407,10 +409,13 @@ program_impl::get_pi_kernel_arg_mask_pair(const std::string &KernelName) const {
   std::pair<sycl::detail::pi::PiKernel, const KernelArgMask *> Result;
 
   if (is_cacheable()) {
+    ContextImplPtr ContextImpl = detail::getSyclObjImpl(get_context());
+    auto CacheGuard =
+        ContextImpl->getKernelProgramCache().acquireEvictionGuard();
     std::tie(Result.first, std::ignore, Result.second, std::ignore) =
         ProgramManager::getInstance().getOrCreateKernel(
-            detail::getSyclObjImpl(get_context()),
-            detail::getSyclObjImpl(get_devices()[0]), KernelName, this);
+            ContextImpl, detail::getSyclObjImpl(get_devices()[0]), KernelName,
+            this);
     getPlugin()->call<PiApiKind::piKernelRetain>(Result.first);
   } else {
     const PluginPtr &Plugin = getPlugin();
@@ -18,6 +18,8 @@
 #include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/spec_constant_impl.hpp>
+#include <detail/spirv_pruning.hpp>
+#include <detail/thread_pool.hpp>
 #include <sycl/aspects.hpp>
 #include <sycl/backend_types.hpp>
 #include <sycl/context.hpp>
@@ -36,8 +38,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <variant>
@@ -259,6 +265,8 @@ static const char *getFormatStr(sycl::detail::pi::PiDeviceBinaryType Format) {
     return "SPIR-V";
   case PI_DEVICE_BINARY_TYPE_LLVMIR_BITCODE:
     return "LLVM IR";
+  case PI_DEVICE_BINARY_TYPE_COMPRESSED_NONE:
+    return "compressed";
   }
   assert(false && "Unknown device image format");
   return "unknown";
@@ -559,6 +567,21 @@ ProgramManager::getOrCreatePIProgram(const RTDeviceBinaryImage &Img,
   return {NativePrg, BinProg.size()};
 }
 
+/// Returns the total size of the device binaries of a program.
+static size_t getProgramBinarySize(sycl::detail::pi::PiProgram Program,
+                                   const PluginPtr &Plugin) {
+  unsigned int DeviceNum = 0;
+  Plugin->call<PiApiKind::piProgramGetInfo>(
+      Program, PI_PROGRAM_INFO_NUM_DEVICES, sizeof(DeviceNum), &DeviceNum,
+      nullptr);
+
+  std::vector<size_t> BinarySizes(DeviceNum);
+  Plugin->call<PiApiKind::piProgramGetInfo>(
+      Program, PI_PROGRAM_INFO_BINARY_SIZES,
+      sizeof(size_t) * BinarySizes.size(), BinarySizes.data(), nullptr);
+  return std::accumulate(BinarySizes.begin(), BinarySizes.end(), size_t{0});
+}
+
 /// Emits information about built programs if the appropriate contitions are
 /// met, namely when SYCL_RT_WARNING_LEVEL is greater than or equal to 2.
 static void emitBuiltProgramInfo(const pi_program &Prog,
@@ -570,10 +593,169 @@ static void emitBuiltProgramInfo(const pi_program &Prog,
   }
 }
 
+/// Returns the device a program for DeviceImpl has to be built for. Programs
+/// built for a root device can be used on its sub-devices if the backend
+/// allows it.
+static DeviceImplPtr getBuildDevice(const ContextImplPtr &ContextImpl,
+                                    const DeviceImplPtr &DeviceImpl) {
+  // Check if we can optimize program builds for sub-devices by using a program
+  // built for the root device
+  DeviceImplPtr RootDevImpl = DeviceImpl;
+  while (!RootDevImpl->isRootDevice()) {
+    auto ParentDev = detail::getSyclObjImpl(
+        RootDevImpl->get_info<info::device::parent_device>());
+    // Sharing is allowed within a single context only
+    if (!ContextImpl->hasDevice(ParentDev))
+      break;
+    RootDevImpl = ParentDev;
+  }
+
+  pi_bool MustBuildOnSubdevice = PI_TRUE;
+  ContextImpl->getPlugin()->call<PiApiKind::piDeviceGetInfo>(
+      RootDevImpl->getHandleRef(), PI_DEVICE_INFO_BUILD_ON_SUBDEVICE,
+      sizeof(pi_bool), &MustBuildOnSubdevice, nullptr);
+
+  return (MustBuildOnSubdevice == PI_TRUE) ? DeviceImpl : RootDevImpl;
+}
+
+/// Returns true if device code built for one of the devices can be loaded
+/// on the other one.
+static bool isSameDeviceKind(const DeviceImplPtr &LHS,
+                             const DeviceImplPtr &RHS) {
+  return LHS->getPlatformImpl() == RHS->getPlatformImpl() &&
+         LHS->get_info<info::device::name>() ==
+             RHS->get_info<info::device::name>() &&
+         LHS->get_info<info::device::version>() ==
+             RHS->get_info<info::device::version>() &&
+         LHS->get_info<info::device::driver_version>() ==
+             RHS->get_info<info::device::driver_version>();
+}
+
+/// Returns the device code of a program built for a single device.
+static std::vector<char>
+getProgramBinary(sycl::detail::pi::PiProgram Program,
+                 const PluginPtr &Plugin) {
+  size_t BinarySize = 0;
+  Plugin->call<PiApiKind::piProgramGetInfo>(
+      Program, PI_PROGRAM_INFO_BINARY_SIZES, sizeof(size_t), &BinarySize,
+      nullptr);
+
+  std::vector<char> Binary(BinarySize);
+  char *BinaryPtr = Binary.data();
+  Plugin->call<PiApiKind::piProgramGetInfo>(Program, PI_PROGRAM_INFO_BINARIES,
+                                            sizeof(char *), &BinaryPtr,
+                                            nullptr);
+  return Binary;
+}
+
+void ProgramManager::submitBackgroundBuilds(
+    const ContextImplPtr &ContextImpl, const DeviceImplPtr &BuildDevice,
+    const std::string &KernelName, bool JITCompilationIsRequired,
+    std::shared_ptr<const SharedDeviceCode> SharedCode) {
+  std::unordered_set<sycl::detail::pi::PiDevice> BuildDevices{
+      BuildDevice->getHandleRef()};
+  for (const device &Device : ContextImpl->getDevices()) {
+    DeviceImplPtr DeviceImpl =
+        getBuildDevice(ContextImpl, getSyclObjImpl(Device));
+    if (!BuildDevices.insert(DeviceImpl->getHandleRef()).second ||
+        isSameDeviceKind(DeviceImpl, BuildDevice) != bool(SharedCode))
+      continue;
+
+    // Background builds must not keep the context alive, builds of destroyed
+    // contexts and the ones dropped at shutdown are just skipped.
+    std::weak_ptr<context_impl> WeakContext = ContextImpl;
+    std::weak_ptr<device_impl> WeakDevice = DeviceImpl;
+    GlobalHandler::instance().getProgramBuildThreadPool().submit(
+        [this, WeakContext, WeakDevice, KernelName, JITCompilationIsRequired,
+         SharedCode]() {
+          ContextImplPtr ContextImpl = WeakContext.lock();
+          DeviceImplPtr DeviceImpl = WeakDevice.lock();
+          if (!ContextImpl || !DeviceImpl)
+            return;
+
+          auto CacheGuard =
+              ContextImpl->getKernelProgramCache().acquireEvictionGuard();
+          try {
+            getBuiltPIProgramImpl(ContextImpl, DeviceImpl, KernelName,
+                                  /*Prg=*/nullptr, JITCompilationIsRequired,
+                                  /*IsBackgroundBuild=*/true,
+                                  SharedCode.get());
+          } catch (...) {
+            // Build errors are reported to the threads using the program.
+          }
+        });
+  }
+}
+
+void ProgramManager::prebuildDeviceImages(
+    const std::vector<device_image_plain> &DeviceImages) {
+  ThreadPool &BuildPool = GlobalHandler::instance().getProgramBuildThreadPool();
+  for (const device_image_plain &DeviceImage : DeviceImages)
+    BuildPool.submit([this, DeviceImage]() {
+      try {
+        build(DeviceImage, getSyclObjImpl(DeviceImage)->get_devices(),
+              /*PropList=*/{});
+      } catch (...) {
+        // Build errors are reported when the image is built for use.
+      }
+    });
+}
+
+void ProgramManager::prebuildKernels(const ContextImplPtr &ContextImpl,
+                                     const std::vector<kernel_id> &KernelIDs) {
+  // A program is built per device image, so a single kernel of each image is
+  // enough to build all of them.
+  std::vector<std::string> KernelNames;
+  if (KernelIDs.empty()) {
+    std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
+    for (const auto &ImgIt : m_BinImg2KernelIDs)
+      if (ImgIt.second && !ImgIt.second->empty())
+        KernelNames.push_back(ImgIt.second->front().get_name());
+  } else {
+    for (const kernel_id &KernelID : KernelIDs)
+      KernelNames.push_back(KernelID.get_name());
+  }
+
+  ThreadPool &BuildPool = GlobalHandler::instance().getProgramBuildThreadPool();
+  std::weak_ptr<context_impl> WeakContext = ContextImpl;
+  for (const device &Device : ContextImpl->getDevices()) {
+    std::weak_ptr<device_impl> WeakDevice = getSyclObjImpl(Device);
+    for (std::string &KernelName : KernelNames)
+      BuildPool.submit([this, WeakContext, WeakDevice, KernelName]() {
+        ContextImplPtr ContextImpl = WeakContext.lock();
+        DeviceImplPtr DeviceImpl = WeakDevice.lock();
+        if (!ContextImpl || !DeviceImpl)
+          return;
+
+        auto CacheGuard =
+            ContextImpl->getKernelProgramCache().acquireEvictionGuard();
+        try {
+          getOrCreateKernel(ContextImpl, DeviceImpl, KernelName,
+                            /*Prg=*/nullptr);
+        } catch (...) {
+          // Kernels which can't be built for the device, e.g. because of
+          // unsupported aspects, are skipped. Build errors are reported to the
+          // threads submitting the kernels.
+        }
+      });
+  }
+}
+
 sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgram(
     const ContextImplPtr &ContextImpl, const DeviceImplPtr &DeviceImpl,
     const std::string &KernelName, const program_impl *Prg,
     bool JITCompilationIsRequired) {
+  return getBuiltPIProgramImpl(ContextImpl, DeviceImpl, KernelName, Prg,
+                               JITCompilationIsRequired,
+                               /*IsBackgroundBuild=*/false,
+                               /*SharedCode=*/nullptr);
+}
+
+sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgramImpl(
+    const ContextImplPtr &ContextImpl, const DeviceImplPtr &DeviceImpl,
+    const std::string &KernelName, const program_impl *Prg,
+    bool JITCompilationIsRequired, bool IsBackgroundBuild,
+    const SharedDeviceCode *SharedCode) {
   KernelProgramCache &Cache = ContextImpl->getKernelProgramCache();
 
   std::string CompileOpts;
@@ -588,25 +770,7 @@ sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgram(
   if (Prg)
     Prg->stableSerializeSpecConstRegistry(SpecConsts);
 
-  // Check if we can optimize program builds for sub-devices by using a program
-  // built for the root device
-  DeviceImplPtr RootDevImpl = DeviceImpl;
-  while (!RootDevImpl->isRootDevice()) {
-    auto ParentDev = detail::getSyclObjImpl(
-        RootDevImpl->get_info<info::device::parent_device>());
-    // Sharing is allowed within a single context only
-    if (!ContextImpl->hasDevice(ParentDev))
-      break;
-    RootDevImpl = ParentDev;
-  }
-
-  pi_bool MustBuildOnSubdevice = PI_TRUE;
-  ContextImpl->getPlugin()->call<PiApiKind::piDeviceGetInfo>(
-      RootDevImpl->getHandleRef(), PI_DEVICE_INFO_BUILD_ON_SUBDEVICE,
-      sizeof(pi_bool), &MustBuildOnSubdevice, nullptr);
-
-  DeviceImplPtr Dev =
-      (MustBuildOnSubdevice == PI_TRUE) ? DeviceImpl : RootDevImpl;
+  DeviceImplPtr Dev = getBuildDevice(ContextImpl, DeviceImpl);
   auto Context = createSyclObjFromImpl<context>(ContextImpl);
   auto Device = createSyclObjFromImpl<device>(Dev);
   const RTDeviceBinaryImage &Img =
@@ -616,13 +780,38 @@ sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgram(
   if (auto exception = checkDevSupportDeviceRequirements(Device, Img))
     throw *exception;
 
-  auto BuildF = [this, &Img, &Context, &ContextImpl, &Device, Prg, &CompileOpts,
-                 &LinkOpts, SpecConsts] {
+  // Programs which depend on the state of program_impl are not built in
+  // background.
+  bool BuildOtherDevices = !IsBackgroundBuild && !Prg &&
+                           SYCLConfig<SYCL_PARALLEL_DEVICE_BUILD>::get() &&
+                           ContextImpl->getDevices().size() > 1;
+
+  auto BuildF = [this, &Img, &Context, &ContextImpl, &Device, &Dev, Prg,
+                 &CompileOpts, &LinkOpts, SpecConsts, SharedCode, &KernelName,
+                 JITCompilationIsRequired, BuildOtherDevices] {
     const PluginPtr &Plugin = ContextImpl->getPlugin();
     applyOptionsFromImage(CompileOpts, LinkOpts, Img, {Device}, Plugin);
 
-    auto [NativePrg, DeviceCodeWasInCache] = getOrCreatePIProgram(
-        Img, Context, Device, CompileOpts + LinkOpts, SpecConsts);
+    // Devices of other kinds need their own JIT compilation, which runs
+    // concurrently with this one.
+    if (BuildOtherDevices)
+      submitBackgroundBuilds(ContextImpl, Dev, KernelName,
+                             JITCompilationIsRequired, /*SharedCode=*/nullptr);
+
+    sycl::detail::pi::PiProgram NativePrg;
+    bool DeviceCodeWasInCache = false;
+    if (SharedCode && SharedCode->Img == &Img) {
+      auto ProgMetadata = Img.getProgramMetadata();
+      std::vector<pi_device_binary_property> ProgMetadataVector{
+          ProgMetadata.begin(), ProgMetadata.end()};
+      NativePrg = createBinaryProgram(
+          ContextImpl, Device, (const unsigned char *)SharedCode->Binary.data(),
+          SharedCode->Binary.size(), ProgMetadataVector);
+      DeviceCodeWasInCache = true;
+    } else {
+      std::tie(NativePrg, DeviceCodeWasInCache) = getOrCreatePIProgram(
+          Img, Context, Device, CompileOpts + LinkOpts, SpecConsts);
+    }
 
     if (!DeviceCodeWasInCache) {
       if (Prg)
@@ -641,14 +830,18 @@ sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgram(
     // If device image is not SPIR-V, DeviceLibReqMask will be 0 which means
     // no fallback device library will be linked.
     uint32_t DeviceLibReqMask = 0;
+    std::vector<std::string> DeviceLibFuncs;
     if (!DeviceCodeWasInCache &&
         Img.getFormat() == PI_DEVICE_BINARY_TYPE_SPIRV &&
-        !SYCLConfig<SYCL_DEVICELIB_NO_FALLBACK>::get())
+        !SYCLConfig<SYCL_DEVICELIB_NO_FALLBACK>::get()) {
       DeviceLibReqMask = getDeviceLibReqMask(Img);
+      DeviceLibFuncs = getDeviceLibFuncs(Img);
+    }
 
     ProgramPtr BuiltProgram =
         build(std::move(ProgramManaged), ContextImpl, CompileOpts, LinkOpts,
-              getRawSyclObjImpl(Device)->getHandleRef(), DeviceLibReqMask);
+              getRawSyclObjImpl(Device)->getHandleRef(), DeviceLibReqMask,
+              DeviceLibFuncs);
 
     emitBuiltProgramInfo(BuiltProgram.get(), ContextImpl);
 
@@ -661,8 +854,15 @@ sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgram(
 
     // Save program to persistent cache if it is not there
     if (!DeviceCodeWasInCache)
-      PersistentDeviceCodeCache::putItemToDisc(
+      PersistentDeviceCodeCache::putItemToDiscAsync(
           Device, Img, SpecConsts, CompileOpts + LinkOpts, BuiltProgram.get());
+
+    // Devices of the same kind load the device code built for this one.
+    if (BuildOtherDevices)
+      submitBackgroundBuilds(
+          ContextImpl, Dev, KernelName, JITCompilationIsRequired,
+          std::make_shared<const SharedDeviceCode>(SharedDeviceCode{
+              &Img, getProgramBinary(BuiltProgram.get(), Plugin)}));
     return BuiltProgram.release();
   };
 
@@ -681,11 +881,20 @@ sycl::detail::pi::PiProgram ProgramManager::getBuiltPIProgram(
           Cache, GetCachedBuildF, BuildF);
   // getOrBuild is not supposed to return nullptr
   assert(BuildResult != nullptr && "Invalid build result");
-  return *BuildResult->Ptr.load();
+  sycl::detail::pi::PiProgram Program = *BuildResult->Ptr.load();
+
+  // Device globals and host pipes live in the program, so programs that have
+  // them must stay in the cache for the lifetime of the context.
+  if (Cache.isEvictionEnabled() && Img.getDeviceGlobals().size() == 0 &&
+      Img.getHostPipes().size() == 0 && !Cache.touchEvictableProgram(Program))
+    Cache.addEvictableProgram(
+        CacheKey, Program,
+        getProgramBinarySize(Program, ContextImpl->getPlugin()));
+  return Program;
 }
 
-std::tuple<sycl::detail::pi::PiKernel, std::mutex *, const KernelArgMask *,
-           sycl::detail::pi::PiProgram>
+std::tuple<sycl::detail::pi::PiKernel, KernelLaunchState *,
+           const KernelArgMask *, sycl::detail::pi::PiProgram>
 ProgramManager::getOrCreateKernel(const ContextImplPtr &ContextImpl,
                                   const DeviceImplPtr &DeviceImpl,
                                   const std::string &KernelName,
@@ -711,8 +920,13 @@ ProgramManager::getOrCreateKernel(const ContextImplPtr &ContextImpl,
   auto key = std::make_tuple(std::move(SpecConsts), PiDevice,
                              CompileOpts + LinkOpts, KernelName);
   auto ret_tuple = Cache.tryToGetKernelFast(key);
-  if (std::get<0>(ret_tuple))
+  if (std::get<0>(ret_tuple)) {
+    // Fast cache hits bypass getBuiltPIProgram, so the program has to be
+    // marked as recently used here.
+    if (Cache.isEvictionEnabled())
+      Cache.touchEvictableProgram(std::get<3>(ret_tuple));
     return ret_tuple;
+  }
 
   sycl::detail::pi::PiProgram Program =
       getBuiltPIProgram(ContextImpl, DeviceImpl, KernelName, Prg);
@@ -744,9 +958,10 @@ ProgramManager::getOrCreateKernel(const ContextImplPtr &ContextImpl,
   // getOrBuild is not supposed to return nullptr
   assert(BuildResult != nullptr && "Invalid build result");
   const KernelArgMaskPairT &KernelArgMaskPair = *BuildResult->Ptr.load();
-  auto ret_val = std::make_tuple(KernelArgMaskPair.first,
-                                 &(BuildResult->MBuildResultMutex),
-                                 KernelArgMaskPair.second, Program);
+  auto ret_val = std::make_tuple(
+      KernelArgMaskPair.first,
+      Cache.getOrInsertKernelLaunchState(KernelArgMaskPair.first),
+      KernelArgMaskPair.second, Program);
   Cache.saveKernel(key, ret_val);
   return ret_val;
 }
@@ -807,11 +1022,7 @@ ProgramManager::getProgramBuildLog(const sycl::detail::pi::PiProgram &Program,
   return Log;
 }
 
-// TODO device libraries may use scpecialization constants, manifest files, etc.
-// To support that they need to be delivered in a different container - so that
-// pi_device_binary_struct can be created for each of them.
-static bool loadDeviceLib(const ContextImplPtr Context, const char *Name,
-                          sycl::detail::pi::PiProgram &Prog) {
+static bool readDeviceLib(const char *Name, std::vector<char> &FileContent) {
   std::string LibSyclDir = OSUtil::getCurrentDSODir();
   std::ifstream File(LibSyclDir + OSUtil::DirSep + Name,
                      std::ifstream::in | std::ifstream::binary);
@@ -822,15 +1033,65 @@ static bool loadDeviceLib(const ContextImplPtr Context, const char *Name,
   File.seekg(0, std::ios::end);
   size_t FileSize = File.tellg();
   File.seekg(0, std::ios::beg);
-  std::vector<char> FileContent(FileSize);
+  FileContent.resize(FileSize);
   File.read(&FileContent[0], FileSize);
   File.close();
+  return true;
+}
 
-  Prog =
-      createSpirvProgram(Context, (unsigned char *)&FileContent[0], FileSize);
+// TODO device libraries may use scpecialization constants, manifest files, etc.
+// To support that they need to be delivered in a different container - so that
+// pi_device_binary_struct can be created for each of them.
+static bool loadDeviceLib(const ContextImplPtr Context, const char *Name,
+                          const std::vector<std::string> &Funcs,
+                          sycl::detail::pi::PiProgram &Prog) {
+  std::vector<char> FileContent;
+  if (!readDeviceLib(Name, FileContent))
+    return false;
+
+  // If the library can't be pruned it is used as a whole, which is correct
+  // but takes longer to compile and link.
+  if (!Funcs.empty())
+    pruneSPIRVFunctions(FileContent, Funcs);
+
+  Prog = createSpirvProgram(Context, (unsigned char *)&FileContent[0],
+                            FileContent.size());
   return Prog != nullptr;
 }
 
+// Of the functions required by an image, returns the sorted list of the ones
+// the library exports. An empty list means the whole library is to be linked,
+// which is the case if the image doesn't list the functions it requires or if
+// it requires all of them.
+static std::vector<std::string>
+getDeviceLibFuncsToLink(const char *Name,
+                        const std::vector<std::string> &RequiredFuncs) {
+  std::vector<std::string> Funcs;
+  if (RequiredFuncs.empty())
+    return Funcs;
+
+  // Libraries are read once per process to find out what they export.
+  static std::mutex LibExportsMutex;
+  static std::map<std::string, std::vector<std::string>> LibExports;
+  std::lock_guard<std::mutex> Lock(LibExportsMutex);
+  auto Result = LibExports.try_emplace(Name);
+  std::vector<std::string> &Exports = Result.first->second;
+  if (Result.second) {
+    std::vector<char> FileContent;
+    if (readDeviceLib(Name, FileContent))
+      Exports = getSPIRVExportedFunctions(FileContent);
+    std::sort(Exports.begin(), Exports.end());
+  }
+
+  std::set_intersection(Exports.begin(), Exports.end(), RequiredFuncs.begin(),
+                        RequiredFuncs.end(), std::back_inserter(Funcs));
+  // If none of the exports is required, the image may come from a compiler
+  // which disagrees with the library on the names, keep all of them.
+  if (Funcs.size() == Exports.size() || Funcs.empty())
+    Funcs.clear();
+  return Funcs;
+}
+
 // For each extension, a pair of library names. The first uses native support,
 // the second emulates functionality in software.
 static const std::map<DeviceLibExt, std::pair<const char *, const char *>>
@@ -896,14 +1157,26 @@ static const char *getDeviceLibExtensionStr(DeviceLibExt Extension) {
 static sycl::detail::pi::PiProgram
 loadDeviceLibFallback(const ContextImplPtr Context, DeviceLibExt Extension,
                       const sycl::detail::pi::PiDevice &Device,
-                      bool UseNativeLib) {
+                      bool UseNativeLib,
+                      const std::vector<std::string> &RequiredFuncs) {
 
   auto LibFileName = getDeviceLibFilename(Extension, UseNativeLib);
 
+  // Only the functions of the library the image needs are compiled and
+  // linked, the programs are cached per set of such functions.
+  std::vector<std::string> LibFuncs =
+      getDeviceLibFuncsToLink(LibFileName, RequiredFuncs);
+  std::string LibFuncsKey;
+  for (const std::string &Func : LibFuncs) {
+    if (!LibFuncsKey.empty())
+      LibFuncsKey += ' ';
+    LibFuncsKey += Func;
+  }
+
   auto LockedCache = Context->acquireCachedLibPrograms();
-  auto CachedLibPrograms = LockedCache.get();
+  auto &CachedLibPrograms = LockedCache.get();
   auto CacheResult = CachedLibPrograms.emplace(
-      std::make_pair(std::make_pair(Extension, Device), nullptr));
+      std::make_tuple(Extension, Device, std::move(LibFuncsKey)), nullptr);
   bool Cached = !CacheResult.second;
   auto LibProgIt = CacheResult.first;
   sycl::detail::pi::PiProgram &LibProg = LibProgIt->second;
@@ -911,7 +1184,7 @@ loadDeviceLibFallback(const ContextImplPtr Context, DeviceLibExt Extension,
   if (Cached)
     return LibProg;
 
-  if (!loadDeviceLib(Context, LibFileName, LibProg)) {
+  if (!loadDeviceLib(Context, LibFileName, LibFuncs, LibProg)) {
     CachedLibPrograms.erase(LibProgIt);
     throw compile_program_error(std::string("Failed to load ") + LibFileName,
                                 PI_ERROR_INVALID_VALUE);
@@ -992,6 +1265,13 @@ void CheckJITCompilationForImage(const RTDeviceBinaryImage *const &Image,
   }
 }
 
+// Compressed images are only decompressed once they are selected for a
+// device, images for other targets stay compressed.
+static void decompressImageIfNeeded(RTDeviceBinaryImage *Img) {
+  if (auto *CompressedImg = dynamic_cast<CompressedRTDeviceBinaryImage *>(Img))
+    CompressedImg->decompress();
+}
+
 template <typename StorageKey>
 RTDeviceBinaryImage *getBinImageFromMultiMap(
     const std::unordered_multimap<StorageKey, RTDeviceBinaryImage *> &ImagesSet,
@@ -1040,19 +1320,20 @@ ProgramManager::getDeviceImage(const std::string &KernelName,
   RTDeviceBinaryImage *Img = nullptr;
   {
     std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
-    if (auto KernelId = m_KernelName2KernelIDs.find(KernelName);
-        KernelId != m_KernelName2KernelIDs.end()) {
+    if (const kernel_id *KernelId = m_KernelName2KernelIDs.find(KernelName)) {
       // Kernel ID presence guarantees that we have bin image in the storage.
-      Img = getBinImageFromMultiMap(m_KernelIDs2BinImage, KernelId->second,
-                                    Context, Device);
+      Img = getBinImageFromMultiMap(m_KernelIDs2BinImage, *KernelId, Context,
+                                    Device);
       assert(Img && "No binary image found for kernel id");
     } else {
-      Img = getBinImageFromMultiMap(m_ServiceKernels, KernelName, Context,
+      Img = getBinImageFromMultiMap(m_ServiceKernels,
+                                    std::string_view{KernelName}, Context,
                                     Device);
     }
   }
   if (Img) {
     CheckJITCompilationForImage(Img, JITCompilationIsRequired);
+    decompressImageIfNeeded(Img);
 
     if (DbgProgMgr > 0) {
       std::cerr << "selected device image: " << &Img->getRawData() << "\n";
@@ -1098,6 +1379,7 @@ RTDeviceBinaryImage &ProgramManager::getDeviceImage(
   std::advance(ImageIterator, ImgInd);
 
   CheckJITCompilationForImage(*ImageIterator, JITCompilationIsRequired);
+  decompressImageIfNeeded(*ImageIterator);
 
   if (DbgProgMgr > 0) {
     std::cerr << "selected device image: " << &(*ImageIterator)->getRawData()
@@ -1117,7 +1399,8 @@ static bool isDeviceLibRequired(DeviceLibExt Ext, uint32_t DeviceLibReqMask) {
 static std::vector<sycl::detail::pi::PiProgram>
 getDeviceLibPrograms(const ContextImplPtr Context,
                      const sycl::detail::pi::PiDevice &Device,
-                     uint32_t DeviceLibReqMask) {
+                     uint32_t DeviceLibReqMask,
+                     const std::vector<std::string> &DeviceLibFuncs) {
   std::vector<sycl::detail::pi::PiProgram> Programs;
 
   std::pair<DeviceLibExt, bool> RequiredDeviceLibExt[] = {
@@ -1169,13 +1452,15 @@ getDeviceLibPrograms(const ContextImplPtr Context,
     bool DeviceSupports = DevExtList.npos != DevExtList.find(ExtName);
     if (!DeviceSupports || InhibitNativeImpl) {
       Programs.push_back(
-          loadDeviceLibFallback(Context, Ext, Device, /*UseNativeLib=*/false));
+          loadDeviceLibFallback(Context, Ext, Device, /*UseNativeLib=*/false,
+                                DeviceLibFuncs));
       FallbackIsLoaded = true;
     } else {
       // bfloat16 needs native library if device supports it
       if (Ext == DeviceLibExt::cl_intel_devicelib_bfloat16) {
         Programs.push_back(
-            loadDeviceLibFallback(Context, Ext, Device, /*UseNativeLib=*/true));
+            loadDeviceLibFallback(Context, Ext, Device, /*UseNativeLib=*/true,
+                                  DeviceLibFuncs));
         FallbackIsLoaded = true;
       }
     }
@@ -1186,7 +1471,8 @@ getDeviceLibPrograms(const ContextImplPtr Context,
 ProgramManager::ProgramPtr ProgramManager::build(
     ProgramPtr Program, const ContextImplPtr Context,
     const std::string &CompileOptions, const std::string &LinkOptions,
-    const sycl::detail::pi::PiDevice &Device, uint32_t DeviceLibReqMask) {
+    const sycl::detail::pi::PiDevice &Device, uint32_t DeviceLibReqMask,
+    const std::vector<std::string> &DeviceLibFuncs) {
 
   if (DbgProgMgr > 0) {
     std::cerr << ">>> ProgramManager::build(" << Program.get() << ", "
@@ -1215,7 +1501,8 @@ ProgramManager::ProgramPtr ProgramManager::build(
 
   std::vector<sycl::detail::pi::PiProgram> LinkPrograms;
   if (LinkDeviceLibs) {
-    LinkPrograms = getDeviceLibPrograms(Context, Device, DeviceLibReqMask);
+    LinkPrograms = getDeviceLibPrograms(Context, Device, DeviceLibReqMask,
+                                        DeviceLibFuncs);
   }
 
   static const char *ForceLinkEnv = std::getenv("SYCL_FORCE_LINK");
@@ -1267,13 +1554,16 @@ ProgramManager::ProgramPtr ProgramManager::build(
 void ProgramManager::cacheKernelUsesAssertInfo(RTDeviceBinaryImage &Img) {
   const RTDeviceBinaryImage::PropertyRange &AssertUsedRange =
       Img.getAssertUsed();
-  if (AssertUsedRange.isAvailable())
-    for (const auto &Prop : AssertUsedRange)
-      m_KernelUsesAssert.insert(Prop->Name);
+  if (!AssertUsedRange.isAvailable())
+    return;
+  for (const auto &Prop : AssertUsedRange)
+    m_KernelUsesAssert.insert(
+        Prop->Name, KernelNameTable<bool>::hash(Prop->Name), true);
+  m_KernelUsesAssert.commit();
 }
 
 bool ProgramManager::kernelUsesAssert(const std::string &KernelName) const {
-  return m_KernelUsesAssert.find(KernelName) != m_KernelUsesAssert.end();
+  return m_KernelUsesAssert.find(KernelName) != nullptr;
 }
 
 void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
@@ -1286,19 +1576,17 @@ void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
     if (EntriesB == EntriesE)
       continue;
 
-    auto Img = make_unique_ptr<RTDeviceBinaryImage>(RawImg);
+    std::unique_ptr<RTDeviceBinaryImage> Img;
+    if (RawImg->Format == PI_DEVICE_BINARY_TYPE_COMPRESSED_NONE)
+      Img = std::make_unique<CompressedRTDeviceBinaryImage>(RawImg);
+    else
+      Img = make_unique_ptr<RTDeviceBinaryImage>(RawImg);
     static uint32_t SequenceID = 0;
 
-    // Fill the kernel argument mask map
-    const RTDeviceBinaryImage::PropertyRange &KPOIRange =
-        Img->getKernelParamOptInfo();
-    if (KPOIRange.isAvailable()) {
-      KernelNameToArgMaskMap &ArgMaskMap =
-          m_EliminatedKernelArgMasks[Img.get()];
-      for (const auto &Info : KPOIRange)
-        ArgMaskMap[Info->Name] =
-            createKernelArgMask(DeviceBinaryProperty(Info).asByteArray());
-    }
+    // Kernel argument masks are only parsed once a kernel from the image is
+    // created, register the image as having them.
+    if (Img->getKernelParamOptInfo().isAvailable())
+      m_EliminatedKernelArgMasks[Img.get()];
 
     // Fill maps for kernel bundles
     std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
@@ -1309,6 +1597,8 @@ void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
       m_ExportedSymbols.insert(ExportedSymbol->Name);
 
     if (DumpImages) {
+      // Dumped images are expected to hold the actual device code.
+      decompressImageIfNeeded(Img.get());
       const bool NeedsSequenceID = std::any_of(
           m_BinImg2KernelIDs.begin(), m_BinImg2KernelIDs.end(),
           [&](auto &CurrentImg) {
@@ -1337,19 +1627,25 @@ void ProgramManager::addImages(pi_device_binaries DeviceBinary) {
       if (m_ExportedSymbols.find(EntriesIt->name) != m_ExportedSymbols.end())
         continue;
 
-      // ... and create a unique kernel ID for the entry
-      auto It = m_KernelName2KernelIDs.find(EntriesIt->name);
-      if (It == m_KernelName2KernelIDs.end()) {
+      // ... and create a unique kernel ID for the entry. Names are unique
+      // within an image, so only the entries of the previous images need to
+      // be looked up.
+      const std::string_view Name = EntriesIt->name;
+      const auto NameHash = KernelNameTable<kernel_id>::hash(Name);
+      std::optional<kernel_id> KernelID;
+      if (const kernel_id *Existing =
+              m_KernelName2KernelIDs.find(Name, NameHash)) {
+        KernelID = *Existing;
+      } else {
         std::shared_ptr<detail::kernel_id_impl> KernelIDImpl =
             std::make_shared<detail::kernel_id_impl>(EntriesIt->name);
-        sycl::kernel_id KernelID =
-            detail::createSyclObjFromImpl<sycl::kernel_id>(KernelIDImpl);
-
-        It = m_KernelName2KernelIDs.emplace_hint(It, EntriesIt->name, KernelID);
+        KernelID = detail::createSyclObjFromImpl<sycl::kernel_id>(KernelIDImpl);
+        m_KernelName2KernelIDs.insert(Name, NameHash, *KernelID);
       }
-      m_KernelIDs2BinImage.insert(std::make_pair(It->second, Img.get()));
-      m_BinImg2KernelIDs[Img.get()]->push_back(It->second);
+      m_KernelIDs2BinImage.insert(std::make_pair(*KernelID, Img.get()));
+      m_BinImg2KernelIDs[Img.get()]->push_back(*KernelID);
     }
+    m_KernelName2KernelIDs.commit();
 
     cacheKernelUsesAssertInfo(*Img);
 
@@ -1516,6 +1812,26 @@ uint32_t ProgramManager::getDeviceLibReqMask(const RTDeviceBinaryImage &Img) {
     return 0xFFFFFFFF;
 }
 
+std::vector<std::string>
+ProgramManager::getDeviceLibFuncs(const RTDeviceBinaryImage &Img) {
+  std::vector<std::string> Funcs;
+  for (const auto &Prop : Img.getDeviceLibFuncs())
+    Funcs.push_back(Prop->Name);
+  std::sort(Funcs.begin(), Funcs.end());
+  return Funcs;
+}
+
+const ProgramManager::KernelNameToArgMaskMap &
+ProgramManager::getArgMasks(const RTDeviceBinaryImage *Img,
+                            ImageArgMasks &ArgMasks) {
+  std::call_once(ArgMasks.Parsed, [&]() {
+    for (const auto &Info : Img->getKernelParamOptInfo())
+      ArgMasks.Masks[Info->Name] =
+          createKernelArgMask(DeviceBinaryProperty(Info).asByteArray());
+  });
+  return ArgMasks.Masks;
+}
+
 const KernelArgMask *
 ProgramManager::getEliminatedKernelArgMask(pi::PiProgram NativePrg,
                                            const std::string &KernelName) {
@@ -1529,9 +1845,11 @@ ProgramManager::getEliminatedKernelArgMask(pi::PiProgram NativePrg,
     if (ImgIt != NativePrograms.end()) {
       auto MapIt = m_EliminatedKernelArgMasks.find(ImgIt->second);
       if (MapIt != m_EliminatedKernelArgMasks.end()) {
-        auto ArgMaskMapIt = MapIt->second.find(KernelName);
-        if (ArgMaskMapIt != MapIt->second.end())
-          return &MapIt->second[KernelName];
+        const KernelNameToArgMaskMap &ArgMasks =
+            getArgMasks(MapIt->first, MapIt->second);
+        auto ArgMaskMapIt = ArgMasks.find(KernelName);
+        if (ArgMaskMapIt != ArgMasks.end())
+          return &ArgMaskMapIt->second;
       }
       return nullptr;
     }
@@ -1540,8 +1858,10 @@ ProgramManager::getEliminatedKernelArgMask(pi::PiProgram NativePrg,
   // If the program was not cached iterate over all available images looking for
   // the requested kernel
   for (auto &Elem : m_EliminatedKernelArgMasks) {
-    auto ArgMask = Elem.second.find(KernelName);
-    if (ArgMask != Elem.second.end())
+    const KernelNameToArgMaskMap &ArgMasks =
+        getArgMasks(Elem.first, Elem.second);
+    auto ArgMask = ArgMasks.find(KernelName);
+    if (ArgMask != ArgMasks.end())
       return &ArgMask->second;
   }
 
@@ -1593,12 +1913,12 @@ static bool compatibleWithDevice(RTDeviceBinaryImage *BinImage,
 kernel_id ProgramManager::getSYCLKernelID(const std::string &KernelName) {
   std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
 
-  auto KernelID = m_KernelName2KernelIDs.find(KernelName);
-  if (KernelID == m_KernelName2KernelIDs.end())
+  const kernel_id *KernelID = m_KernelName2KernelIDs.find(KernelName);
+  if (!KernelID)
     throw runtime_error("No kernel found with the specified name",
                         PI_ERROR_INVALID_KERNEL_NAME);
 
-  return KernelID->second;
+  return *KernelID;
 }
 
 bool ProgramManager::hasCompatibleImage(const device &Dev) {
@@ -1616,8 +1936,8 @@ std::vector<kernel_id> ProgramManager::getAllSYCLKernelIDs() {
 
   std::vector<sycl::kernel_id> AllKernelIDs;
   AllKernelIDs.reserve(m_KernelName2KernelIDs.size());
-  for (std::pair<std::string, kernel_id> KernelID : m_KernelName2KernelIDs) {
-    AllKernelIDs.push_back(KernelID.second);
+  for (const auto &KernelID : m_KernelName2KernelIDs) {
+    AllKernelIDs.push_back(KernelID.Value);
   }
   return AllKernelIDs;
 }
@@ -1736,6 +2056,8 @@ device_image_plain ProgramManager::getDeviceImageFromBinaryImage(
     KernelIDs = m_BinImg2KernelIDs[BinImage];
   }
 
+  decompressImageIfNeeded(BinImage);
+
   DeviceImageImplPtr Impl = std::make_shared<detail::device_image_impl>(
       BinImage, Ctx, std::vector<device>{Dev}, ImgState, KernelIDs,
       /*PIProgram=*/nullptr);
@@ -1877,6 +2199,7 @@ ProgramManager::getSYCLDeviceImagesWithCompatibleState(
     if (ImgInfoPair.second.RequirementCounter == 0)
       continue;
 
+    decompressImageIfNeeded(ImgInfoPair.first);
     DeviceImageImplPtr Impl = std::make_shared<detail::device_image_impl>(
         ImgInfoPair.first, Ctx, Devs, ImgInfoPair.second.State,
         ImgInfoPair.second.KernelIDs, /*PIProgram=*/nullptr);
@@ -2206,7 +2529,11 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
   const RTDeviceBinaryImage *ImgPtr = InputImpl->get_bin_image_ref();
   const RTDeviceBinaryImage &Img = *ImgPtr;
 
-  SerializedObj SpecConsts = InputImpl->get_spec_const_blob_ref();
+  // Emulated specialization constants are passed to kernels in a buffer, so
+  // their values don't affect the program and all variants share it.
+  SerializedObj SpecConsts;
+  if (Img.supportsSpecConstants())
+    SpecConsts = InputImpl->get_spec_const_blob_ref();
 
   // TODO: Unify this code with getBuiltPIProgram
   auto BuildF = [this, &Context, &Img, &Devs, &CompileOpts, &LinkOpts,
@@ -2242,13 +2569,17 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
     // If device image is not SPIR-V, DeviceLibReqMask will be 0 which means
     // no fallback device library will be linked.
     uint32_t DeviceLibReqMask = 0;
+    std::vector<std::string> DeviceLibFuncs;
     if (Img.getFormat() == PI_DEVICE_BINARY_TYPE_SPIRV &&
-        !SYCLConfig<SYCL_DEVICELIB_NO_FALLBACK>::get())
+        !SYCLConfig<SYCL_DEVICELIB_NO_FALLBACK>::get()) {
       DeviceLibReqMask = getDeviceLibReqMask(Img);
+      DeviceLibFuncs = getDeviceLibFuncs(Img);
+    }
 
     ProgramPtr BuiltProgram =
         build(std::move(ProgramManaged), ContextImpl, CompileOpts, LinkOpts,
-              getRawSyclObjImpl(Devs[0])->getHandleRef(), DeviceLibReqMask);
+              getRawSyclObjImpl(Devs[0])->getHandleRef(), DeviceLibReqMask,
+              DeviceLibFuncs);
 
     emitBuiltProgramInfo(BuiltProgram.get(), ContextImpl);
 
@@ -2261,7 +2592,7 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
 
     // Save program to persistent cache if it is not there
     if (!DeviceCodeWasInCache)
-      PersistentDeviceCodeCache::putItemToDisc(
+      PersistentDeviceCodeCache::putItemToDiscAsync(
           Devs[0], Img, SpecConsts, CompileOpts + LinkOpts, BuiltProgram.get());
 
     return BuiltProgram.release();
@@ -2280,6 +2611,10 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
     return Cache.getOrInsertProgram(CacheKey);
   };
 
+  // The program is not retained by device_image_impl until the end of the
+  // function, so it must not be evicted earlier.
+  auto CacheGuard = Cache.acquireEvictionGuard();
+
   // TODO: Throw SYCL2020 style exception
   auto BuildResult =
       getOrBuild<sycl::detail::pi::PiProgram, compile_program_error>(
@@ -2326,7 +2661,8 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
   return createSyclObjFromImpl<device_image_plain>(ExecImpl);
 }
 
-std::tuple<sycl::detail::pi::PiKernel, std::mutex *, const KernelArgMask *>
+std::tuple<sycl::detail::pi::PiKernel, KernelLaunchState *,
+           const KernelArgMask *>
 ProgramManager::getOrCreateKernel(const context &Context,
                                   const std::string &KernelName,
                                   const property_list &PropList,
@@ -2365,9 +2701,12 @@ ProgramManager::getOrCreateKernel(const context &Context,
           Cache, GetCachedBuildF, BuildF);
   // getOrBuild is not supposed to return nullptr
   assert(BuildResult != nullptr && "Invalid build result");
-  return std::make_tuple(BuildResult->Ptr.load()->first,
-                         &(BuildResult->MBuildResultMutex),
-                         BuildResult->Ptr.load()->second);
+  const KernelProgramCache::KernelArgMaskPairT &KernelArgMaskPair =
+      *BuildResult->Ptr.load();
+  return std::make_tuple(
+      KernelArgMaskPair.first,
+      Cache.getOrInsertKernelLaunchState(KernelArgMaskPair.first),
+      KernelArgMaskPair.second);
 }
 
 bool doesDevSupportDeviceRequirements(const device &Dev,
@@ -11,6 +11,8 @@
 #include <detail/device_global_map_entry.hpp>
 #include <detail/host_pipe_map_entry.hpp>
 #include <detail/kernel_arg_mask.hpp>
+#include <detail/kernel_launch_state.hpp>
+#include <detail/kernel_name_table.hpp>
 #include <detail/spec_constant_impl.hpp>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/device_global_map.hpp>
@@ -26,7 +28,9 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -139,6 +143,16 @@ public:
   ///        once the function returns.
   /// \param JITCompilationIsRequired If JITCompilationIsRequired is true
   ///        add a check that kernel is compiled, otherwise don't add the check.
+  ///
+  /// The returned program is owned by the context's KernelProgramCache, the
+  /// caller must hold its eviction guard until the program is retained or no
+  /// longer used. The same applies to the handles returned by
+  /// getOrCreateKernel.
+  ///
+  /// If SYCL_PARALLEL_DEVICE_BUILD is enabled, the program is built for the
+  /// other devices of the context in background. Their build results are
+  /// placed into the KernelProgramCache right away, so a later call for one of
+  /// those devices only waits for the build of its own program.
   sycl::detail::pi::PiProgram getBuiltPIProgram(
       const ContextImplPtr &ContextImpl, const DeviceImplPtr &DeviceImpl,
       const std::string &KernelName, const program_impl *Prg = nullptr,
@@ -150,8 +164,22 @@ public:
                     const property_list &PropList,
                     bool JITCompilationIsRequired = false);
 
-  std::tuple<sycl::detail::pi::PiKernel, std::mutex *, const KernelArgMask *,
-             sycl::detail::pi::PiProgram>
+  /// Starts building the programs and kernels for all devices of the context
+  /// in background, so that kernel submissions find them in the context's
+  /// KernelProgramCache or wait for the builds in progress. The kernels are
+  /// identified by KernelIDs, all kernels are built if it is empty.
+  void prebuildKernels(const ContextImplPtr &ContextImpl,
+                       const std::vector<kernel_id> &KernelIDs);
+
+  /// Starts building the device images in background, e.g. the variants of
+  /// an image with different specialization constant values. The builds fill
+  /// the KernelProgramCache of the images' context. The images, and thus
+  /// their context, are kept alive until their builds are done.
+  void
+  prebuildDeviceImages(const std::vector<device_image_plain> &DeviceImages);
+
+  std::tuple<sycl::detail::pi::PiKernel, KernelLaunchState *,
+             const KernelArgMask *, sycl::detail::pi::PiProgram>
   getOrCreateKernel(const ContextImplPtr &ContextImpl,
                     const DeviceImplPtr &DeviceImpl,
                     const std::string &KernelName, const program_impl *Prg);
@@ -181,6 +209,9 @@ public:
                           pi::PiProgram NativePrg = nullptr,
                           const RTDeviceBinaryImage *Img = nullptr);
   uint32_t getDeviceLibReqMask(const RTDeviceBinaryImage &Img);
+  /// \return the sorted names of the fallback library functions the image
+  /// uses, or an empty vector if the image doesn't tell.
+  std::vector<std::string> getDeviceLibFuncs(const RTDeviceBinaryImage &Img);
 
   /// Returns the mask for eliminated kernel arguments for the requested kernel
   /// within the native program.
@@ -286,7 +317,8 @@ public:
                            const std::vector<device> &Devs,
                            const property_list &PropList);
 
-  std::tuple<sycl::detail::pi::PiKernel, std::mutex *, const KernelArgMask *>
+  std::tuple<sycl::detail::pi::PiKernel, KernelLaunchState *,
+             const KernelArgMask *>
   getOrCreateKernel(const context &Context, const std::string &KernelName,
                     const property_list &PropList,
                     sycl::detail::pi::PiProgram Program);
@@ -310,7 +342,37 @@ private:
                    const std::string &CompileOptions,
                    const std::string &LinkOptions,
                    const sycl::detail::pi::PiDevice &Device,
-                   uint32_t DeviceLibReqMask);
+                   uint32_t DeviceLibReqMask,
+                   const std::vector<std::string> &DeviceLibFuncs);
+
+  /// Device code built for one device of a context, which is used to create
+  /// programs for the devices of the same kind without JIT compilation.
+  struct SharedDeviceCode {
+    const RTDeviceBinaryImage *Img;
+    std::vector<char> Binary;
+  };
+
+  /// Implements getBuiltPIProgram. Background builds create the program from
+  /// SharedCode if it is provided and matches the device image selected for
+  /// the device, and don't start other background builds.
+  sycl::detail::pi::PiProgram
+  getBuiltPIProgramImpl(const ContextImplPtr &ContextImpl,
+                        const DeviceImplPtr &DeviceImpl,
+                        const std::string &KernelName, const program_impl *Prg,
+                        bool JITCompilationIsRequired, bool IsBackgroundBuild,
+                        const SharedDeviceCode *SharedCode);
+
+  /// Submits background builds of the kernel's program for the devices of
+  /// the context other than BuildDevice. Devices sharing a program are built
+  /// once. Without SharedCode the devices of a different kind than BuildDevice
+  /// are built, otherwise the devices of the same kind.
+  void
+  submitBackgroundBuilds(const ContextImplPtr &ContextImpl,
+                         const DeviceImplPtr &BuildDevice,
+                         const std::string &KernelName,
+                         bool JITCompilationIsRequired,
+                         std::shared_ptr<const SharedDeviceCode> SharedCode);
+
   /// Dumps image to current directory
   void dumpImage(const RTDeviceBinaryImage &Img, uint32_t SequenceID = 0) const;
 
@@ -319,14 +381,16 @@ private:
 
   /// The three maps below are used during kernel resolution. Any kernel is
   /// identified by its name.
+  /// Names used as keys point to the entries and properties of the registered
+  /// images rather than being copied. Registered images are never unloaded,
+  /// so they outlive the maps.
   using RTDeviceBinaryImageUPtr = std::unique_ptr<RTDeviceBinaryImage>;
 
-  /// Maps names of kernels to their unique kernel IDs.
-  /// TODO: Use std::unordered_set with transparent hash and equality functions
-  ///       when C++20 is enabled for the runtime library.
+  /// Maps names of kernels to their unique kernel IDs. Entries of an image
+  /// are committed once the image is registered.
   /// Access must be guarded by the m_KernelIDsMutex mutex.
   //
-  std::unordered_map<std::string, kernel_id> m_KernelName2KernelIDs;
+  KernelNameTable<kernel_id> m_KernelName2KernelIDs;
 
   // Maps KernelIDs to device binary images. There can be more than one image
   // in case of SPIRV + AOT.
@@ -356,12 +420,13 @@ private:
   /// in the sycl::detail::__sycl_service_kernel__ namespace which is
   /// exclusively used for this purpose.
   /// Access must be guarded by the m_KernelIDsMutex mutex.
-  std::unordered_multimap<std::string, RTDeviceBinaryImage *> m_ServiceKernels;
+  std::unordered_multimap<std::string_view, RTDeviceBinaryImage *>
+      m_ServiceKernels;
 
   /// Caches all exported symbols to allow faster lookup when excluding these
   // from kernel bundles.
   /// Access must be guarded by the m_KernelIDsMutex mutex.
-  std::unordered_set<std::string> m_ExportedSymbols;
+  std::unordered_set<std::string_view> m_ExportedSymbols;
 
   /// Keeps all device images we are refering to during program lifetime. Used
   /// for proper cleanup.
@@ -392,17 +457,31 @@ private:
   /// Protects NativePrograms that can be changed by class' methods.
   std::mutex MNativeProgramsMutex;
 
-  using KernelNameToArgMaskMap = std::unordered_map<std::string, KernelArgMask>;
+  using KernelNameToArgMaskMap =
+      std::unordered_map<std::string_view, KernelArgMask>;
+  /// Kernel argument masks of an image, which are only parsed once a kernel
+  /// from the image is created.
+  struct ImageArgMasks {
+    std::once_flag Parsed;
+    KernelNameToArgMaskMap Masks;
+  };
+  /// Returns the kernel argument masks of the image, parsing them on the
+  /// first call.
+  const KernelNameToArgMaskMap &getArgMasks(const RTDeviceBinaryImage *Img,
+                                            ImageArgMasks &ArgMasks);
   /// Maps binary image and kernel name pairs to kernel argument masks which
   /// specify which arguments were eliminated during device code optimization.
-  std::unordered_map<const RTDeviceBinaryImage *, KernelNameToArgMaskMap>
+  /// Only images with kernel argument masks have an entry. Entries are added
+  /// when images are registered and are not removed.
+  std::unordered_map<const RTDeviceBinaryImage *, ImageArgMasks>
       m_EliminatedKernelArgMasks;
 
   /// True iff a SPIR-V file has been specified with an environment variable
   bool m_UseSpvFile = false;
   RTDeviceBinaryImageUPtr m_SpvFileImage;
 
-  std::set<std::string> m_KernelUsesAssert;
+  /// Names of the kernels which use assert, the values are not used.
+  KernelNameTable<bool> m_KernelUsesAssert;
 
   // Maps between device_global identifiers and associated information.
   std::unordered_map<std::string, std::unique_ptr<DeviceGlobalMapEntry>>
@@ -9,10 +9,12 @@
 #include <detail/event_impl.hpp>
 #include <detail/memory_manager.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/usm/memory_pool_impl.hpp>
 #include <sycl/context.hpp>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/pi.hpp>
 #include <sycl/device.hpp>
+#include <sycl/ext/oneapi/experimental/memory_pool.hpp>
 
 #include <cstring>
 #include <utility>
@@ -46,22 +48,21 @@ template <> device queue_impl::get_info<info::queue::device>() const {
 
 static event prepareSYCLEventAssociatedWithQueue(
     const std::shared_ptr<detail::queue_impl> &QueueImpl) {
-  auto EventImpl = std::make_shared<detail::event_impl>(QueueImpl);
+  auto EventImpl = detail::createEventImpl(QueueImpl);
   EventImpl->setContextImpl(detail::getSyclObjImpl(QueueImpl->get_context()));
   EventImpl->setStateIncomplete();
   return detail::createSyclObjFromImpl<event>(EventImpl);
 }
 
 static event createDiscardedEvent() {
-  EventImplPtr EventImpl =
-      std::make_shared<event_impl>(event_impl::HES_Discarded);
-  return createSyclObjFromImpl<event>(EventImpl);
+  return createSyclObjFromImpl<event>(getDiscardedEventImpl());
 }
 
 event queue_impl::memset(const std::shared_ptr<detail::queue_impl> &Self,
                          void *Ptr, int Value, size_t Count,
                          const std::vector<event> &DepEvents) {
 #if XPTI_ENABLE_INSTRUMENTATION
+  XPTISubmissionSample Sample;
   // We need a code pointer value and we use the object ptr; if code location
   // information is available, we will have function name and source file
   // information
@@ -138,6 +139,7 @@ event queue_impl::memcpy(const std::shared_ptr<detail::queue_impl> &Self,
                          const std::vector<event> &DepEvents,
                          const code_location &CodeLoc) {
 #if XPTI_ENABLE_INSTRUMENTATION
+  XPTISubmissionSample Sample;
   // We need a code pointer value and we duse the object ptr; If code location
   // is available, we use the source file information along with the object
   // pointer.
@@ -365,6 +367,78 @@ void queue_impl::addEvent(const event &Event) {
   }
 }
 
+EventImplPtr queue_impl::getEventForSubmittedCommands(
+    const std::shared_ptr<queue_impl> &Self) {
+  // Discarded events can't be waited for.
+  if (MDiscardEvents) {
+    wait();
+    return nullptr;
+  }
+  if (MIsInorder) {
+    std::lock_guard<std::mutex> Lock{MLastEventMtx};
+    return getSyclObjImpl(MLastEvent);
+  }
+  event Barrier =
+      submit([](handler &CGH) { CGH.ext_oneapi_barrier(); }, Self, {});
+  return getSyclObjImpl(Barrier);
+}
+
+memory_pool_impl &queue_impl::getDefaultMemoryPool() {
+  std::lock_guard<std::mutex> Lock{MMutex};
+  if (!MDefaultMemoryPool)
+    MDefaultMemoryPool = std::make_shared<memory_pool_impl>(
+        MContext, MDevice, sycl::usm::alloc::device,
+        ext::oneapi::experimental::memory_pool::DefaultMaxCachedSize);
+  return *MDefaultMemoryPool;
+}
+
+void queue_impl::addEvents(const std::vector<event> &Events) {
+  // Shared events are cleaned up on insertion, keep using the single event
+  // path for them.
+  if (is_host() || MEmulateOOO) {
+    for (const event &Event : Events)
+      addEvent(Event);
+    return;
+  }
+  std::lock_guard<std::mutex> Lock{MMutex};
+  for (const event &Event : Events) {
+    const EventImplPtr &EImpl = getSyclObjImpl(Event);
+    assert(EImpl && "Event implementation is missing");
+    if (EImpl->getCommand() && EImpl->getHandleRef() == nullptr)
+      MEventsWeak.push_back(EImpl);
+  }
+}
+
+event queue_impl::submitBatch(
+    const std::vector<std::function<void(handler &)>> &CGFs,
+    const std::shared_ptr<queue_impl> &Self, const detail::code_location &Loc,
+    const SubmitPostProcessF *PostProcess) {
+  std::vector<event> Events;
+  Events.reserve(CGFs.size() + 1);
+  try {
+    for (const std::function<void(handler &)> &CGF : CGFs)
+      Events.push_back(
+          submitUntracked(CGF, Self, Self, nullptr, Loc, PostProcess));
+
+    // Command groups of an in-order queue complete in submission order, so
+    // the last event represents the whole batch. Otherwise a barrier is
+    // needed to join the events.
+    if (Events.size() > 1 && !MIsInorder) {
+      std::vector<event> WaitList = Events;
+      Events.push_back(submitUntracked(
+          [&WaitList](handler &CGH) { CGH.ext_oneapi_barrier(WaitList); },
+          Self, Self, nullptr, Loc, nullptr));
+    }
+  } catch (...) {
+    // Whatever has been submitted already still has to be visible to
+    // queue::wait.
+    addEvents(Events);
+    throw;
+  }
+  addEvents(Events);
+  return Events.empty() ? event{} : Events.back();
+}
+
 /// addSharedEvent - queue_impl tracks events with weak pointers
 /// but some events have no other owner. In this case,
 /// addSharedEvent will have the queue track the events via a shared pointer.
@@ -528,6 +602,13 @@ void queue_impl::wait(const detail::code_location &CodeLoc) {
   if (SupportsPiFinish) {
     const PluginPtr &Plugin = getPlugin();
     Plugin->call<detail::PiApiKind::piQueueFinish>(getHandleRef());
+    sycl::detail::pi::PiQueue SampledProfilingQueue = nullptr;
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      SampledProfilingQueue = MSampledProfilingQueue;
+    }
+    if (SampledProfilingQueue)
+      Plugin->call<detail::PiApiKind::piQueueFinish>(SampledProfilingQueue);
     assert(SharedEvents.empty() && "Queues that support calling piQueueFinish "
                                    "shouldn't have shared events");
   } else {
@@ -558,6 +639,141 @@ pi_native_handle queue_impl::getNative(int32_t &NativeHandleDesc) const {
   return Handle;
 }
 
+bool queue_impl::sampleProfiling(const std::string &KernelName) {
+  if (ProfilingRequest::isActive())
+    return canSampleProfiling() && initSampledProfilingQueue();
+  const size_t Rate = SYCLConfig<SYCL_PROFILING_SAMPLE_RATE>::get();
+  if (Rate == 0 || MHostQueue || MIsProfilingEnabled || MIsInorder ||
+      MEmulateOOO || MDiscardEvents)
+    return false;
+  if (const char *Filter = SYCLConfig<SYCL_PROFILING_SAMPLE_KERNEL>::get())
+    if (KernelName.find(Filter) == std::string::npos)
+      return false;
+  const size_t Candidate =
+      MNumProfilingSampleCandidates.fetch_add(1, std::memory_order_relaxed);
+  if (Candidate % Rate != 0)
+    return false;
+  return canSampleProfiling() && initSampledProfilingQueue();
+}
+
+bool queue_impl::canSampleProfiling() const {
+  if (MHostQueue || MIsProfilingEnabled || MIsInorder || MEmulateOOO ||
+      MDiscardEvents || MSampledProfilingFailed)
+    return false;
+  // Without the device timer the timestamps of the event can't be related to
+  // its submission time, see MFallbackProfiling.
+  return MDevice->has(aspect::queue_profiling) &&
+         MDevice->isGetDeviceAndHostTimerSupported();
+}
+
+// The innermost profiling request of the calling thread.
+static thread_local queue_impl::ProfilingRequest *GProfilingRequest = nullptr;
+
+queue_impl::ProfilingRequest::ProfilingRequest()
+    : MPrevious(GProfilingRequest) {
+  GProfilingRequest = this;
+}
+
+queue_impl::ProfilingRequest::~ProfilingRequest() {
+  GProfilingRequest = MPrevious;
+}
+
+bool queue_impl::ProfilingRequest::isActive() {
+  return GProfilingRequest != nullptr;
+}
+
+void queue_impl::ProfilingRequest::addKernelEvent(const EventImplPtr &Event) {
+  if (GProfilingRequest && !GProfilingRequest->MFirstKernelEvent)
+    GProfilingRequest->MFirstKernelEvent = Event;
+}
+
+bool queue_impl::initSampledProfilingQueue() {
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    if (MSampledProfilingQueue)
+      return true;
+  }
+  // The queue is created without the in-order fallback of createQueue(), which
+  // would make this queue emulate out-of-order execution, and outside of
+  // MMutex since queue creation may be slow.
+  sycl::detail::pi::PiQueue Queue = nullptr;
+  if (tryCreateQueue(QueueOrder::OOO, /*EnableProfiling=*/true, Queue) !=
+      PI_SUCCESS) {
+    MSampledProfilingFailed = true;
+    return false;
+  }
+  const PluginPtr &Plugin = getPlugin();
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (MSampledProfilingQueue) {
+    // Another thread created the queue in the meantime.
+    Plugin->call<PiApiKind::piQueueRelease>(Queue);
+    return true;
+  }
+  // Barriers enqueued before must also hold back the kernels of the new queue.
+  // Sampling is off for queues emulating out-of-order execution, so the native
+  // queue is MQueues[0].
+  sycl::detail::pi::PiEvent Barriers[2];
+  Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      MQueues[0], 0, nullptr, &Barriers[0]);
+  Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(Queue, 1, &Barriers[0],
+                                                          &Barriers[1]);
+  for (sycl::detail::pi::PiEvent Barrier : Barriers)
+    Plugin->call<PiApiKind::piEventRelease>(Barrier);
+  MSampledProfilingQueue = Queue;
+  return true;
+}
+
+sycl::detail::pi::PiQueue &queue_impl::getSampledProfilingQueueHandleRef() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  assert(MSampledProfilingQueue &&
+         "The queue is created when a kernel is sampled");
+  return MSampledProfilingQueue;
+}
+
+void queue_impl::enqueueBarrier(
+    const std::vector<sycl::detail::pi::PiEvent> &WaitList,
+    sycl::detail::pi::PiEvent *Event) {
+  const PluginPtr &Plugin = getPlugin();
+  sycl::detail::pi::PiQueue SampledProfilingQueue = nullptr;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    SampledProfilingQueue = MSampledProfilingQueue;
+  }
+  if (!SampledProfilingQueue) {
+    Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+        getHandleRef(), WaitList.size(),
+        WaitList.empty() ? nullptr : &WaitList[0], Event);
+    return;
+  }
+
+  // A barrier only orders the commands of its own native queue. Barriers on
+  // both queues wait for the commands enqueued to either of them before, the
+  // barrier returned waits for both.
+  std::vector<sycl::detail::pi::PiEvent> Barriers;
+  if (WaitList.empty()) {
+    Barriers.resize(2);
+    Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+        getHandleRef(), 0, nullptr, &Barriers[0]);
+    Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+        SampledProfilingQueue, 0, nullptr, &Barriers[1]);
+  }
+  const std::vector<sycl::detail::pi::PiEvent> &MainWaitList =
+      WaitList.empty() ? Barriers : WaitList;
+  sycl::detail::pi::PiEvent MainBarrier = nullptr;
+  Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      getHandleRef(), MainWaitList.size(), &MainWaitList[0], &MainBarrier);
+  // Later kernels of the sampled profiling queue wait for the barrier too.
+  Barriers.emplace_back();
+  Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      SampledProfilingQueue, 1, &MainBarrier, &Barriers.back());
+  if (Event)
+    *Event = MainBarrier;
+  else
+    Barriers.push_back(MainBarrier);
+  for (sycl::detail::pi::PiEvent Barrier : Barriers)
+    Plugin->call<PiApiKind::piEventRelease>(Barrier);
+}
+
 void queue_impl::cleanup_fusion_cmd() {
   detail::Scheduler::getInstance().cleanUpCmdFusion(this);
 }
@@ -581,9 +797,19 @@ bool queue_impl::ext_oneapi_empty() const {
       return false;
   }
 
+  // Sampled kernels are enqueued to a native queue of their own.
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (MSampledProfilingQueue) {
+    pi_bool IsReady = false;
+    getPlugin()->call<PiApiKind::piQueueGetInfo>(
+        MSampledProfilingQueue, PI_EXT_ONEAPI_QUEUE_INFO_EMPTY,
+        sizeof(pi_bool), &IsReady, nullptr);
+    if (!IsReady)
+      return false;
+  }
+
   // We may have events like host tasks which are not submitted to the backend
   // queue so we need to get their status separately.
-  std::lock_guard<std::mutex> Lock(MMutex);
   for (event Event : MEventsShared)
     if (Event.get_info<info::event::command_execution_status>() !=
         info::event_command_status::complete)
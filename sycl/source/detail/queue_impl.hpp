@@ -34,6 +34,7 @@
 
 #include "detail/graph_impl.hpp"
 
+#include <atomic>
 #include <utility>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
@@ -54,6 +55,7 @@ namespace detail {
 
 using ContextImplPtr = std::shared_ptr<detail::context_impl>;
 using DeviceImplPtr = std::shared_ptr<detail::device_impl>;
+class memory_pool_impl;
 
 /// Sets max number of queues supported by FPGA RT.
 static constexpr size_t MaxNumQueues = 256;
@@ -312,9 +314,14 @@ public:
     }
 #endif
     throw_asynchronous();
+    // The pool waits for the pending frees, release it while the queue is
+    // still alive.
+    MDefaultMemoryPool.reset();
     if (!MHostQueue) {
       cleanup_fusion_cmd();
       getPlugin()->call<PiApiKind::piQueueRelease>(MQueues[0]);
+      if (MSampledProfilingQueue)
+        getPlugin()->call<PiApiKind::piQueueRelease>(MSampledProfilingQueue);
     }
   }
 
@@ -399,6 +406,22 @@ public:
     return submit_impl(CGF, Self, Self, nullptr, Loc, PostProcess);
   }
 
+  /// Submits a batch of command group function objects to the queue.
+  ///
+  /// The command groups are submitted in order of appearance, and the queue
+  /// bookkeeping which doesn't depend on a single command group is done only
+  /// once for the whole batch.
+  ///
+  /// \param CGFs is a vector of function objects containing command groups.
+  /// \param Self is a shared_ptr to this queue.
+  /// \param Loc is the code location of the submit call (default argument)
+  /// \return a SYCL event which is complete once all the submitted command
+  /// groups are complete.
+  event submitBatch(const std::vector<std::function<void(handler &)>> &CGFs,
+                    const std::shared_ptr<queue_impl> &Self,
+                    const detail::code_location &Loc,
+                    const SubmitPostProcessF *PostProcess = nullptr);
+
   /// Performs a blocking wait for the completion of all enqueued tasks in the
   /// queue.
   ///
@@ -406,6 +429,19 @@ public:
   /// @param Loc is the code location of the submit call (default argument)
   void wait(const detail::code_location &Loc = {});
 
+  /// Provides an event for the commands submitted to the queue so far. For
+  /// out-of-order queues a barrier is submitted, queues discarding events
+  /// wait for the commands instead.
+  ///
+  /// \param Self is a shared_ptr to this queue.
+  /// \return an event which completes once all the commands submitted to
+  /// the queue so far are complete, or nullptr if they are complete already.
+  EventImplPtr
+  getEventForSubmittedCommands(const std::shared_ptr<queue_impl> &Self);
+
+  /// \return the pool of device allocations ordered with the queue.
+  memory_pool_impl &getDefaultMemoryPool();
+
   /// \return list of asynchronous exceptions occurred during execution.
   exception_list getExceptionList() const { return MExceptions; }
 
@@ -510,23 +546,13 @@ public:
   ///
   /// \param Order specifies whether the queue being constructed as in-order
   /// or out-of-order.
-  sycl::detail::pi::PiQueue createQueue(QueueOrder Order) {
+  /// \param EnableProfiling forces profiling on for the native queue even if
+  /// the SYCL queue doesn't have the enable_profiling property.
+  sycl::detail::pi::PiQueue createQueue(QueueOrder Order,
+                                        bool EnableProfiling = false) {
     sycl::detail::pi::PiQueue Queue{};
-    sycl::detail::pi::PiContext Context = MContext->getHandleRef();
-    sycl::detail::pi::PiDevice Device = MDevice->getHandleRef();
-    const PluginPtr &Plugin = getPlugin();
-
-    sycl::detail::pi::PiQueueProperties Properties[] = {
-        PI_QUEUE_FLAGS, createPiQueueProperties(MPropList, Order), 0, 0, 0};
-    if (has_property<ext::intel::property::queue::compute_index>()) {
-      int Idx = get_property<ext::intel::property::queue::compute_index>()
-                    .get_index();
-      Properties[2] = PI_QUEUE_COMPUTE_INDEX;
-      Properties[3] = static_cast<sycl::detail::pi::PiQueueProperties>(Idx);
-    }
     sycl::detail::pi::PiResult Error =
-        Plugin->call_nocheck<PiApiKind::piextQueueCreate>(Context, Device,
-                                                          Properties, &Queue);
+        tryCreateQueue(Order, EnableProfiling, Queue);
 
     // If creating out-of-order queue failed and this property is not
     // supported (for example, on FPGA), it will return
@@ -535,12 +561,46 @@ public:
       MEmulateOOO = true;
       Queue = createQueue(QueueOrder::Ordered);
     } else {
-      Plugin->checkPiResult(Error);
+      getPlugin()->checkPiResult(Error);
     }
 
     return Queue;
   }
 
+  /// Creates PI queue without falling back to an in-order queue.
+  ///
+  /// \param Order specifies whether the queue being constructed as in-order
+  /// or out-of-order.
+  /// \param EnableProfiling forces profiling on for the native queue even if
+  /// the SYCL queue doesn't have the enable_profiling property.
+  /// \param Queue is set to the new queue.
+  /// \return the result of the queue creation.
+  sycl::detail::pi::PiResult
+  tryCreateQueue(QueueOrder Order, bool EnableProfiling,
+                 sycl::detail::pi::PiQueue &Queue) {
+    sycl::detail::pi::PiContext Context = MContext->getHandleRef();
+    sycl::detail::pi::PiDevice Device = MDevice->getHandleRef();
+    const PluginPtr &Plugin = getPlugin();
+
+    sycl::detail::pi::PiQueueProperties Properties[] = {
+        PI_QUEUE_FLAGS, createPiQueueProperties(MPropList, Order), 0, 0, 0};
+    if (EnableProfiling)
+      Properties[1] |= PI_QUEUE_FLAG_PROFILING_ENABLE;
+    if (has_property<ext::intel::property::queue::compute_index>()) {
+      int Idx = get_property<ext::intel::property::queue::compute_index>()
+                    .get_index();
+      Properties[2] = PI_QUEUE_COMPUTE_INDEX;
+      Properties[3] = static_cast<sycl::detail::pi::PiQueueProperties>(Idx);
+    }
+    return Plugin->call_nocheck<PiApiKind::piextQueueCreate>(
+        Context, Device, Properties, &Queue);
+  }
+
+  /// Creates MSampledProfilingQueue unless it exists already.
+  ///
+  /// \return false if the queue could not be created.
+  bool initSampledProfilingQueue();
+
   /// \return a raw PI handle for a free queue. The returned handle is not
   /// retained. It is caller responsibility to make sure queue is still alive.
   sycl::detail::pi::PiQueue &getExclusiveQueueHandleRef() {
@@ -581,6 +641,61 @@ public:
     return getExclusiveQueueHandleRef();
   }
 
+  /// Decides whether the device timestamps of a kernel are collected although
+  /// the queue doesn't have the enable_profiling property. See
+  /// SYCL_PROFILING_SAMPLE_RATE, SYCL_PROFILING_SAMPLE_KERNEL and
+  /// ProfilingRequest.
+  ///
+  /// \param KernelName is the name of the kernel being enqueued.
+  /// \return true if the kernel should be enqueued to the queue returned by
+  /// getSampledProfilingQueueHandleRef().
+  bool sampleProfiling(const std::string &KernelName);
+
+  /// \return true if the kernels of this queue can be sampled for profiling.
+  bool canSampleProfiling() const;
+
+  /// Requests the device timestamps of the kernels the calling thread enqueues
+  /// while the object is alive, regardless of SYCL_PROFILING_SAMPLE_RATE.
+  /// Kernels enqueued by other threads, e.g. once their dependencies are met,
+  /// aren't covered.
+  class ProfilingRequest {
+  public:
+    ProfilingRequest();
+    ~ProfilingRequest();
+    ProfilingRequest(const ProfilingRequest &) = delete;
+    ProfilingRequest &operator=(const ProfilingRequest &) = delete;
+
+    /// \return true if the calling thread has requested profiling.
+    static bool isActive();
+
+    /// Records the event of a kernel enqueued by the calling thread.
+    static void addKernelEvent(const EventImplPtr &Event);
+
+    /// \return the event of the first kernel enqueued while the request was
+    /// alive, or nullptr.
+    const EventImplPtr &getFirstKernelEvent() const {
+      return MFirstKernelEvent;
+    }
+
+  private:
+    ProfilingRequest *MPrevious;
+    EventImplPtr MFirstKernelEvent;
+  };
+
+  /// \return a raw PI handle for the native queue with profiling enabled. It
+  /// is created by sampleProfiling(), so this may only be called for kernels
+  /// sampleProfiling() returned true for. The returned handle is not retained.
+  sycl::detail::pi::PiQueue &getSampledProfilingQueueHandleRef();
+
+  /// Enqueues a barrier to the native queues of this queue, including the one
+  /// receiving the kernels sampled for profiling.
+  ///
+  /// \param WaitList are the events the barrier waits for. If it is empty the
+  /// barrier waits for all the commands enqueued before.
+  /// \param Event is set to the event of the barrier.
+  void enqueueBarrier(const std::vector<sycl::detail::pi::PiEvent> &WaitList,
+                      sycl::detail::pi::PiEvent *Event);
+
   /// \return true if the queue was constructed with property specified by
   /// PropertyT.
   template <typename propertyT> bool has_property() const noexcept {
@@ -747,6 +862,33 @@ protected:
                     const std::shared_ptr<queue_impl> &SecondaryQueue,
                     const detail::code_location &Loc,
                     const SubmitPostProcessF *PostProcess) {
+    event Event = submitUntracked(CGF, Self, PrimaryQueue, SecondaryQueue, Loc,
+                                  PostProcess);
+    addEvent(Event);
+    return Event;
+  }
+
+  /// Performs command group submission to the queue without storing the
+  /// resulting event in the queue.
+  ///
+  /// \param CGF is a function object containing command group.
+  /// \param Self is a pointer to this queue.
+  /// \param PrimaryQueue is a pointer to the primary queue. This may be the
+  ///        same as Self.
+  /// \param SecondaryQueue is a pointer to the secondary queue. This may be the
+  ///        same as Self.
+  /// \param Loc is the code location of the submit call (default argument)
+  /// \return a SYCL event representing submitted command group.
+  event submitUntracked(const std::function<void(handler &)> &CGF,
+                        const std::shared_ptr<queue_impl> &Self,
+                        const std::shared_ptr<queue_impl> &PrimaryQueue,
+                        const std::shared_ptr<queue_impl> &SecondaryQueue,
+                        const detail::code_location &Loc,
+                        const SubmitPostProcessF *PostProcess) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+    // Decides if the trace points of this submission are emitted.
+    XPTISubmissionSample Sample;
+#endif
     handler Handler(Self, PrimaryQueue, SecondaryQueue, MHostQueue);
     Handler.saveCodeLoc(Loc);
     CGF(Handler);
@@ -755,8 +897,8 @@ protected:
     // Host and interop tasks, however, are not submitted to low-level runtimes
     // and require separate dependency management.
     const CG::CGTYPE Type = Handler.getType();
-    event Event = detail::createSyclObjFromImpl<event>(
-        std::make_shared<detail::event_impl>());
+    // The event is assigned on finalization, don't allocate a placeholder.
+    event Event = detail::createSyclObjFromImpl<event>(EventImplPtr{});
 
     if (PostProcess) {
       bool IsKernel = Type == CG::Kernel;
@@ -774,7 +916,6 @@ protected:
     } else
       finalizeHandler(Handler, Type, Event);
 
-    addEvent(Event);
     return Event;
   }
 
@@ -799,6 +940,11 @@ protected:
   /// \param Event is the event to be stored
   void addEvent(const event &Event);
 
+  /// Stores events that should be associated with the queue
+  ///
+  /// \param Events are the events to be stored
+  void addEvents(const std::vector<event> &Events);
+
   /// Protects all the fields that can be changed by class' methods.
   mutable std::mutex MMutex;
 
@@ -821,6 +967,15 @@ protected:
   /// Iterator through MQueues.
   size_t MNextQueueIdx = 0;
 
+  /// Native queue which receives the kernels sampled for profiling, see
+  /// sampleProfiling(). Access should be guarded with MMutex.
+  sycl::detail::pi::PiQueue MSampledProfilingQueue = nullptr;
+  /// Set if MSampledProfilingQueue could not be created, which turns sampling
+  /// off for this queue.
+  std::atomic<bool> MSampledProfilingFailed{false};
+  /// The number of kernels which were candidates for sampled profiling.
+  std::atomic<size_t> MNumProfilingSampleCandidates{0};
+
   const bool MHostQueue = false;
   /// Indicates that a native out-of-order queue could not be created and we
   /// need to emulate it with multiple native in-order queues.
@@ -842,6 +997,10 @@ protected:
 
   std::vector<EventImplPtr> MStreamsServiceEvents;
 
+  /// Pool of the allocations ordered with the queue, created on first use.
+  /// Access to the pool pointer should be guarded with MMutex.
+  std::shared_ptr<memory_pool_impl> MDefaultMemoryPool;
+
   // All member variable defined here  are needed for the SYCL instrumentation
   // layer. Do not guard these variables below with XPTI_ENABLE_INSTRUMENTATION
   // to ensure we have the same object layout when the macro in the library and
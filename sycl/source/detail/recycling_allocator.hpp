@@ -0,0 +1,100 @@
+//==------- recycling_allocator.hpp - Per-thread recycling allocator -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Allocator keeping the memory of deallocated objects in a per-thread free
+/// list, which is used for later single object allocations on that thread.
+/// It is meant for objects created and destroyed on every submission, like
+/// events and handler implementations, recycling their memory saves a heap
+/// allocation each time.
+template <typename T> class RecyclingAllocator {
+  static_assert(sizeof(T) >= sizeof(void *),
+                "Free list links are stored in the deallocated objects");
+
+  struct FreeList {
+    void *Head = nullptr;
+    size_t Size = 0;
+    // Set once the thread's free list is released, later deallocations on
+    // the thread (e.g. by static destructors) go to the heap directly.
+    bool Released = false;
+  };
+
+  struct FreeListReleaser {
+    ~FreeListReleaser() {
+      FreeList &List = getFreeList();
+      while (List.Head) {
+        void *Next = *static_cast<void **>(List.Head);
+        ::operator delete(List.Head);
+        List.Head = Next;
+      }
+      List.Size = 0;
+      List.Released = true;
+    }
+  };
+
+  // The free list is trivially destructible, so it can be accessed when the
+  // thread's other thread local objects are destroyed.
+  static FreeList &getFreeList() {
+    static thread_local FreeList List;
+    return List;
+  }
+
+  static constexpr size_t MaxFreeListSize = 1024;
+
+public:
+  using value_type = T;
+
+  RecyclingAllocator() = default;
+  template <typename U>
+  RecyclingAllocator(const RecyclingAllocator<U> &) noexcept {}
+
+  T *allocate(size_t N) {
+    FreeList &List = getFreeList();
+    if (N == 1 && List.Head) {
+      void *Ptr = List.Head;
+      List.Head = *static_cast<void **>(Ptr);
+      --List.Size;
+      return static_cast<T *>(Ptr);
+    }
+    return static_cast<T *>(::operator new(N * sizeof(T)));
+  }
+
+  void deallocate(T *Ptr, size_t N) noexcept {
+    FreeList &List = getFreeList();
+    if (N == 1 && !List.Released && List.Size < MaxFreeListSize) {
+      static thread_local FreeListReleaser Releaser;
+      (void)Releaser;
+      *reinterpret_cast<void **>(Ptr) = List.Head;
+      List.Head = Ptr;
+      ++List.Size;
+      return;
+    }
+    ::operator delete(Ptr);
+  }
+
+  template <typename U>
+  bool operator==(const RecyclingAllocator<U> &) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const RecyclingAllocator<U> &) const noexcept {
+    return false;
+  }
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -7,9 +7,20 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/config.hpp>
+#include <detail/persistent_device_code_cache.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/reduction_tuning.hpp>
+#include <detail/usm/memory_pool_impl.hpp>
 #include <sycl/reduction.hpp>
 
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -165,6 +176,172 @@ __SYCL_EXPORT size_t reduGetPreferredWGSize(std::shared_ptr<queue_impl> &Queue,
   return reduGetMaxWGSize(Queue, LocalMemBytesPerWorkItem);
 }
 
+// The scratch memory is only released once the commands it is registered with
+// as an auxiliary resource are complete, so it goes back to the queue's pool
+// right away and is reused by the next reduction submitted to the queue.
+__SYCL_EXPORT std::shared_ptr<void>
+reduGetScratchMem(std::shared_ptr<queue_impl> &Queue, size_t Size) {
+  if (Queue->is_host())
+    return std::shared_ptr<void>(std::malloc(Size), std::free);
+
+  void *Ptr = Queue->getDefaultMemoryPool().allocate(Size);
+  if (!Ptr)
+    throw sycl::exception(make_error_code(errc::memory_allocation),
+                          "Failed to allocate memory for reduction partial "
+                          "results");
+  return std::shared_ptr<void>(Ptr, [Queue](void *Ptr) {
+    Queue->getDefaultMemoryPool().deallocate(Ptr);
+  });
+}
+
+namespace {
+class ReductionTuner {
+public:
+  static ReductionTuner &getInstance() {
+    static ReductionTuner Tuner;
+    return Tuner;
+  }
+
+  size_t getConfig(const std::shared_ptr<queue_impl> &Queue,
+                   const std::string &Key, size_t NumConfigs, bool &IsTrial) {
+    std::unique_lock<std::mutex> Lock{MMutex};
+    const auto MapKey = std::make_pair(Queue->getDeviceImplPtr().get(), Key);
+    auto It = MTunings.find(MapKey);
+    if (It == MTunings.end())
+      It = MTunings.try_emplace(MapKey, NumConfigs, readWinner(Queue, Key))
+               .first;
+    TuningState &State = It->second;
+    if (State.Tuning.isTuned())
+      return State.Tuning.getWinner();
+    // Only one trial is timed at a time, concurrent submissions use the
+    // default configuration meanwhile.
+    if (State.Pending) {
+      if (!State.Pending->Last->isCompleted())
+        return 0;
+      collectTrial(State);
+      if (State.Tuning.isTuned()) {
+        size_t Winner = State.Tuning.getWinner();
+        Lock.unlock();
+        std::string Data = std::to_string(Winner);
+        PersistentDeviceCodeCache::putReductionTuningToDisc(
+            Queue->get_device(), Key, {Data.begin(), Data.end()});
+        return Winner;
+      }
+    }
+    IsTrial = true;
+    return State.Tuning.getNextConfig();
+  }
+
+  void addTrial(const std::shared_ptr<queue_impl> &Queue,
+                const std::string &Key, size_t Config, EventImplPtr First,
+                EventImplPtr Last) {
+    std::lock_guard<std::mutex> Lock{MMutex};
+    TuningState &State = MTunings.at({Queue->getDeviceImplPtr().get(), Key});
+    // A concurrent trial may have been submitted meanwhile.
+    if (State.Tuning.isTuned() || State.Pending)
+      return;
+    State.Pending = PendingTrial{Config, First ? First : Last, Last};
+  }
+
+private:
+  // A submitted trial, timed from the start of its first kernel to the end of
+  // its last command.
+  struct PendingTrial {
+    size_t Config;
+    EventImplPtr First;
+    EventImplPtr Last;
+  };
+
+  struct TuningState {
+    TuningState(size_t NumConfigs, size_t Winner)
+        : Tuning(NumConfigs, Winner) {}
+
+    ReductionTuning Tuning;
+    std::optional<PendingTrial> Pending;
+  };
+
+  // Records the time of the completed pending trial of the tuning.
+  static void collectTrial(TuningState &State) {
+    PendingTrial Trial = std::move(*State.Pending);
+    State.Pending.reset();
+    uint64_t Start = 0, End = 0;
+    try {
+      using namespace info::event_profiling;
+      Start = Trial.First->get_profiling_info<command_start>();
+      End = Trial.Last->get_profiling_info<command_end>();
+    } catch (sycl::exception &) {
+      // The commands weren't profiled, e.g. because another thread enqueued
+      // them once their dependencies were met. The trial is repeated.
+      return;
+    }
+    State.Tuning.addTrial(Trial.Config, End > Start ? End - Start : 0);
+  }
+
+  // Returns the configuration found by an earlier run of the application, or
+  // ReductionTuning::NotTuned if there is none.
+  static size_t readWinner(const std::shared_ptr<queue_impl> &Queue,
+                           const std::string &Key) {
+    std::vector<char> Data =
+        PersistentDeviceCodeCache::getReductionTuningFromDisc(
+            Queue->get_device(), Key);
+    try {
+      if (!Data.empty())
+        return std::stoul(std::string{Data.begin(), Data.end()});
+    } catch (std::exception &) {
+      // A corrupted item is treated as a cache miss.
+    }
+    return ReductionTuning::NotTuned;
+  }
+
+  std::mutex MMutex;
+  std::map<std::pair<const device_impl *, std::string>, TuningState>
+      MTunings;
+};
+
+std::string getReductionTuningKey(const char *TypeName, const char *OpName,
+                                  size_t NWorkItems, size_t NumConfigs) {
+  // Ranges are bucketed by powers of two.
+  size_t RangeBucket = 0;
+  while (NWorkItems >> RangeBucket)
+    ++RangeBucket;
+  return std::string{TypeName} + ";" + OpName + ";" +
+         std::to_string(RangeBucket) + ";" + std::to_string(NumConfigs);
+}
+} // namespace
+
+__SYCL_EXPORT void reduRunWithTunedConfig(
+    std::shared_ptr<queue_impl> &Queue, const char *TypeName,
+    const char *OpName, size_t NWorkItems, size_t NumConfigs,
+    const std::function<event(size_t Config, bool IsTrial)> &Submit) {
+  // Trials are timed with the device timestamps of their commands, so
+  // tuning needs profiling or sampled profiling on the queue.
+  if (!SYCLConfig<SYCL_REDUCTION_AUTO_TUNE>::get() || Queue == nullptr ||
+      Queue->is_host() || Queue->getCommandGraph() ||
+      Queue->is_in_fusion_mode() || NumConfigs <= 1 ||
+      (!Queue->MIsProfilingEnabled && !Queue->canSampleProfiling())) {
+    Submit(0, /*IsTrial=*/false);
+    return;
+  }
+
+  ReductionTuner &Tuner = ReductionTuner::getInstance();
+  const std::string Key =
+      getReductionTuningKey(TypeName, OpName, NWorkItems, NumConfigs);
+  bool IsTrial = false;
+  size_t Config = Tuner.getConfig(Queue, Key, NumConfigs, IsTrial);
+  if (!IsTrial) {
+    Submit(Config, /*IsTrial=*/false);
+    return;
+  }
+
+  // The trial doesn't wait for anything, its time is collected once it is
+  // complete and another submission of the reduction asks for a
+  // configuration. Nothing has to be undone if the submission throws.
+  queue_impl::ProfilingRequest Request;
+  event Last = Submit(Config, /*IsTrial=*/true);
+  Tuner.addTrial(Queue, Key, Config, Request.getFirstKernelEvent(),
+                 getSyclObjImpl(Last));
+}
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
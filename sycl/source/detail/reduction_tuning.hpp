@@ -0,0 +1,79 @@
+//==------- reduction_tuning.hpp - Run-time tuning of SYCL reductions ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Tuning state of one reduction on one device for one bucket of ranges, see
+/// SYCL_REDUCTION_AUTO_TUNE. The configurations are tried in turn until each
+/// was timed NumTrialsPerConfig times, the fastest one then wins.
+class ReductionTuning {
+public:
+  /// Each configuration is tried this many times, the fastest run counts.
+  static constexpr unsigned NumTrialsPerConfig = 2;
+  static constexpr size_t NotTuned = std::numeric_limits<size_t>::max();
+
+  /// \param Winner is the configuration found by an earlier run of the
+  /// application, or NotTuned.
+  ReductionTuning(size_t NumConfigs, size_t Winner = NotTuned)
+      : MBestTimes(NumConfigs, std::numeric_limits<uint64_t>::max()),
+        MNumTrials(NumConfigs, 0),
+        MWinner(Winner < NumConfigs ? Winner : NotTuned) {}
+
+  bool isTuned() const { return MWinner != NotTuned; }
+
+  /// \return the fastest configuration once the tuning is done.
+  size_t getWinner() const {
+    assert(isTuned() && "The reduction is still being tuned");
+    return MWinner;
+  }
+
+  /// \return the configuration to try next.
+  size_t getNextConfig() const { return MNextConfig; }
+
+  /// Records the device time in nanoseconds a trial of \p Config took.
+  ///
+  /// \return true if the trial completed the tuning.
+  bool addTrial(size_t Config, uint64_t Time) {
+    if (isTuned() || Config >= MNumTrials.size())
+      return false;
+    MBestTimes[Config] = std::min(MBestTimes[Config], Time);
+    ++MNumTrials[Config];
+    // Concurrent submissions may have tried the same configuration, move on
+    // to one that still needs trials.
+    for (size_t I = 1; I <= MNumTrials.size(); ++I) {
+      size_t Next = (Config + I) % MNumTrials.size();
+      if (MNumTrials[Next] < NumTrialsPerConfig) {
+        MNextConfig = Next;
+        return false;
+      }
+    }
+    MWinner = std::min_element(MBestTimes.begin(), MBestTimes.end()) -
+              MBestTimes.begin();
+    return true;
+  }
+
+private:
+  std::vector<uint64_t> MBestTimes;
+  std::vector<unsigned> MNumTrials;
+  size_t MNextConfig = 0;
+  size_t MWinner;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -29,6 +29,7 @@
 #include <sycl/detail/kernel_desc.hpp>
 #include <sycl/sampler.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 #include <string>
@@ -105,12 +106,13 @@ void applyFuncOnFilteredArgs(
       Func(Arg, Arg.MIndex);
     }
   } else {
-    // TODO this is not necessary as long as we can guarantee that the
-    // arguments are already sorted (e. g. handle the sorting in handler
-    // if necessary due to set_arg(...) usage).
-    std::sort(Args.begin(), Args.end(), [](const ArgDesc &A, const ArgDesc &B) {
+    // Arguments extracted from a kernel lambda are already in order, only
+    // those set through set_arg(...) may need sorting.
+    auto LessByIndex = [](const ArgDesc &A, const ArgDesc &B) {
       return A.MIndex < B.MIndex;
-    });
+    };
+    if (!std::is_sorted(Args.begin(), Args.end(), LessByIndex))
+      std::sort(Args.begin(), Args.end(), LessByIndex);
     int LastIndex = -1;
     size_t NextTrueIndex = 0;
 
@@ -220,6 +222,12 @@ static std::string commandToName(Command::CommandType Type) {
 
 std::vector<sycl::detail::pi::PiEvent>
 Command::getPiEvents(const std::vector<EventImplPtr> &EventImpls) const {
+  return getPiEvents(EventImpls, getWorkerQueue(), isHostTask());
+}
+
+std::vector<sycl::detail::pi::PiEvent>
+Command::getPiEvents(const std::vector<EventImplPtr> &EventImpls,
+                     const QueueImplPtr &CommandQueue, bool IsHostTaskCommand) {
   std::vector<sycl::detail::pi::PiEvent> RetPiEvents;
   for (auto &EventImpl : EventImpls) {
     if (EventImpl->getHandleRef() == nullptr)
@@ -229,11 +237,10 @@ Command::getPiEvents(const std::vector<EventImplPtr> &EventImpls) const {
     // At this stage dependency is definitely pi task and need to check if
     // current one is a host task. In this case we should not skip pi event due
     // to different sync mechanisms for different task types on in-order queue.
-    const QueueImplPtr &WorkerQueue = getWorkerQueue();
-    // MWorkerQueue in command is always not null. So check if
+    // CommandQueue is always not null. So check if
     // EventImpl->getWorkerQueue != nullptr is implicit.
-    if (EventImpl->getWorkerQueue() == WorkerQueue &&
-        WorkerQueue->isInOrder() && !isHostTask())
+    if (EventImpl->getWorkerQueue() == CommandQueue &&
+        CommandQueue->isInOrder() && !IsHostTaskCommand)
       continue;
 
     RetPiEvents.push_back(EventImpl->getHandleRef());
@@ -492,7 +499,7 @@ Command::Command(
     sycl::detail::pi::PiExtCommandBuffer CommandBuffer,
     const std::vector<sycl::detail::pi::PiExtSyncPoint> &SyncPoints)
     : MQueue(std::move(Queue)),
-      MEvent(std::make_shared<detail::event_impl>(MQueue)),
+      MEvent(detail::createEventImpl(MQueue)),
       MPreparedDepsEvents(MEvent->getPreparedDepsEvents()),
       MPreparedHostDepsEvents(MEvent->getPreparedHostDepsEvents()), MType(Type),
       MCommandBuffer(CommandBuffer), MSyncPointDeps(SyncPoints) {
@@ -507,6 +514,12 @@ Command::Command(
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   if (!xptiTraceEnabled())
     return;
+  // Commands of submissions left out by sampling use the stream ID 0, which
+  // XPTI never reports as subscribed, so all their trace points are skipped.
+  if (!XPTISubmissionSample::isSampled()) {
+    MStreamID = 0;
+    return;
+  }
   // Obtain the stream ID so all commands can emit traces to that stream
   MStreamID = xptiRegisterStream(SYCL_STREAM_NAME);
 #endif
@@ -1906,7 +1919,6 @@ void instrumentationAddExtraKernelMetadata(
   };
   sycl::detail::pi::PiProgram Program = nullptr;
   sycl::detail::pi::PiKernel Kernel = nullptr;
-  std::mutex *KernelMutex = nullptr;
   const KernelArgMask *EliminatedArgMask = nullptr;
 
   std::shared_ptr<kernel_impl> SyclKernelImpl;
@@ -1933,7 +1945,10 @@ void instrumentationAddExtraKernelMetadata(
     if (!SyclKernel->isCreatedFromSource())
       EliminatedArgMask = SyclKernel->getKernelArgMask();
   } else {
-    std::tie(Kernel, KernelMutex, EliminatedArgMask, Program) =
+    auto CacheGuard = Queue->getContextImplPtr()
+                          ->getKernelProgramCache()
+                          .acquireEvictionGuard();
+    std::tie(Kernel, std::ignore, EliminatedArgMask, Program) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             Queue->getContextImplPtr(), Queue->getDeviceImplPtr(), KernelName,
             nullptr);
@@ -2030,6 +2045,10 @@ void emitKernelInstrumentationData(
     const std::shared_ptr<detail::kernel_bundle_impl> &KernelBundleImplPtr,
     std::vector<ArgDesc> &CGArgs) {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
+  // This is called for every kernel bypassing the scheduler, don't look up
+  // the stream unless there is a chance it's traced.
+  if (!xptiTraceEnabled() || !XPTISubmissionSample::isSampled())
+    return;
   constexpr uint16_t NotificationTraceType = xpti::trace_node_create;
   int32_t StreamID = xptiRegisterStream(SYCL_STREAM_NAME);
   if (!xptiCheckTraceEnabled(StreamID, NotificationTraceType))
@@ -2071,6 +2090,72 @@ void emitKernelInstrumentationData(
 #endif
 }
 
+BypassedCGInstrumentation::BypassedCGInstrumentation(
+    CG::CGTYPE Type, const detail::code_location &CodeLoc,
+    const QueueImplPtr &Queue) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (!xptiTraceEnabled() || !XPTISubmissionSample::isSampled())
+    return;
+  constexpr uint16_t NotificationTraceType = xpti::trace_node_create;
+  MStreamID = xptiRegisterStream(SYCL_STREAM_NAME);
+  if (!xptiCheckTraceEnabled(MStreamID, NotificationTraceType))
+    return;
+
+  std::optional<bool> FromSource;
+  xpti_td *CmdTraceEvent = nullptr;
+  std::string FileName =
+      CodeLoc.fileName() ? CodeLoc.fileName() : std::string();
+  instrumentationFillCommonData(cgTypeToString(Type), FileName,
+                                CodeLoc.lineNumber(), CodeLoc.columnNumber(),
+                                /*Address=*/nullptr, Queue, FromSource,
+                                MInstanceID, CmdTraceEvent);
+
+  if (CmdTraceEvent) {
+    MTraceEvent = static_cast<void *>(CmdTraceEvent);
+    xptiNotifySubscribers(
+        MStreamID, NotificationTraceType, detail::GSYCLGraphEvent,
+        CmdTraceEvent, MInstanceID,
+        static_cast<const void *>(
+            commandToNodeType(Command::CommandType::RUN_CG).c_str()));
+  }
+#else
+  std::ignore = Type;
+  std::ignore = CodeLoc;
+  std::ignore = Queue;
+#endif
+}
+
+void BypassedCGInstrumentation::emitTaskBegin() {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  constexpr uint16_t NotificationTraceType = xpti::trace_task_begin;
+  if (!(MTraceEvent && xptiCheckTraceEnabled(MStreamID, NotificationTraceType)))
+    return;
+  xptiNotifySubscribers(MStreamID, NotificationTraceType,
+                        detail::GSYCLGraphEvent,
+                        static_cast<xpti_td *>(MTraceEvent), MInstanceID,
+                        nullptr);
+#endif
+}
+
+void BypassedCGInstrumentation::emitTaskEnd(sycl::detail::pi::PiEvent Event) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (!MTraceEvent)
+    return;
+  if (Event && xptiCheckTraceEnabled(MStreamID, xpti::trace_signal))
+    xptiNotifySubscribers(MStreamID, xpti::trace_signal,
+                          detail::GSYCLGraphEvent,
+                          static_cast<xpti_td *>(MTraceEvent), MInstanceID,
+                          (void *)Event);
+  if (xptiCheckTraceEnabled(MStreamID, xpti::trace_task_end))
+    xptiNotifySubscribers(MStreamID, xpti::trace_task_end,
+                          detail::GSYCLGraphEvent,
+                          static_cast<xpti_td *>(MTraceEvent), MInstanceID,
+                          nullptr);
+#else
+  std::ignore = Event;
+#endif
+}
+
 void ExecCGCommand::emitInstrumentationData() {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   constexpr uint16_t NotificationTraceType = xpti::trace_node_create;
@@ -2214,7 +2299,17 @@ void SetArgBasedOnType(
     const std::shared_ptr<device_image_impl> &DeviceImageImpl,
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc,
     const sycl::context &Context, bool IsHost, detail::ArgDesc &Arg,
-    size_t NextTrueIndex) {
+    size_t NextTrueIndex, KernelArgShadow *ArgShadow) {
+  // Arguments passed by value are skipped if the kernel already has them.
+  auto NeedsUpdate = [ArgShadow, &Arg, NextTrueIndex]() {
+    return !ArgShadow ||
+           ArgShadow->needsUpdate(NextTrueIndex, Arg.MPtr, Arg.MSize);
+  };
+  auto Update = [ArgShadow, &Arg, NextTrueIndex]() {
+    if (ArgShadow)
+      ArgShadow->update(NextTrueIndex, Arg.MPtr, Arg.MSize);
+  };
+
   switch (Arg.MType) {
   case kernel_param_kind_t::kind_stream:
     break;
@@ -2249,8 +2344,11 @@ void SetArgBasedOnType(
     break;
   }
   case kernel_param_kind_t::kind_std_layout: {
+    if (!NeedsUpdate())
+      break;
     Plugin->call<PiApiKind::piKernelSetArg>(Kernel, NextTrueIndex, Arg.MSize,
                                             Arg.MPtr);
+    Update();
     break;
   }
   case kernel_param_kind_t::kind_sampler: {
@@ -2262,8 +2360,11 @@ void SetArgBasedOnType(
     break;
   }
   case kernel_param_kind_t::kind_pointer: {
+    if (!NeedsUpdate())
+      break;
     Plugin->call<PiApiKind::piextKernelSetArgPointer>(Kernel, NextTrueIndex,
                                                       Arg.MSize, Arg.MPtr);
+    Update();
     break;
   }
   case kernel_param_kind_t::kind_specialization_constants_buffer: {
@@ -2303,14 +2404,16 @@ static pi_result SetKernelParamsAndLaunch(
     std::vector<sycl::detail::pi::PiEvent> &RawEvents,
     const detail::EventImplPtr &OutEventImpl,
     const KernelArgMask *EliminatedArgMask,
-    const std::function<void *(Requirement *Req)> &getMemAllocationFunc) {
+    const std::function<void *(Requirement *Req)> &getMemAllocationFunc,
+    KernelArgShadow *ArgShadow, bool SampleProfiling) {
   const PluginPtr &Plugin = Queue->getPlugin();
 
   auto setFunc = [&Plugin, Kernel, &DeviceImageImpl, &getMemAllocationFunc,
-                  &Queue](detail::ArgDesc &Arg, size_t NextTrueIndex) {
+                  &Queue, ArgShadow](detail::ArgDesc &Arg,
+                                     size_t NextTrueIndex) {
     SetArgBasedOnType(Plugin, Kernel, DeviceImageImpl, getMemAllocationFunc,
                       Queue->get_context(), Queue->is_host(), Arg,
-                      NextTrueIndex);
+                      NextTrueIndex, ArgShadow);
   };
 
   applyFuncOnFilteredArgs(EliminatedArgMask, Args, setFunc);
@@ -2341,8 +2444,11 @@ static pi_result SetKernelParamsAndLaunch(
   }
   if (OutEventImpl != nullptr)
     OutEventImpl->setHostEnqueueTime();
+  sycl::detail::pi::PiQueue &PiQueue =
+      SampleProfiling ? Queue->getSampledProfilingQueueHandleRef()
+                      : Queue->getHandleRef();
   pi_result Error = Plugin->call_nocheck<PiApiKind::piEnqueueKernelLaunch>(
-      Queue->getHandleRef(), Kernel, NDRDesc.Dims, &NDRDesc.GlobalOffset[0],
+      PiQueue, Kernel, NDRDesc.Dims, &NDRDesc.GlobalOffset[0],
       &NDRDesc.GlobalSize[0], LocalSize, RawEvents.size(),
       RawEvents.empty() ? nullptr : &RawEvents[0],
       OutEventImpl ? &OutEventImpl->getHandleRef() : nullptr);
@@ -2383,27 +2489,41 @@ pi_int32 enqueueImpCommandBufferKernel(
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc) {
   auto ContextImpl = sycl::detail::getSyclObjImpl(Ctx);
   const sycl::detail::PluginPtr &Plugin = ContextImpl->getPlugin();
+  // Cached kernels must not be evicted until they are added to the buffer.
+  auto CacheGuard = ContextImpl->getKernelProgramCache().acquireEvictionGuard();
   pi_kernel PiKernel = nullptr;
-  std::mutex *KernelMutex = nullptr;
+  KernelLaunchState *LaunchState = nullptr;
   pi_program PiProgram = nullptr;
 
   auto Kernel = CommandGroup.MSyclKernel;
   const KernelArgMask *EliminatedArgMask = nullptr;
   if (Kernel != nullptr) {
     PiKernel = Kernel->getHandleRef();
+    // The handle may be shared with the launches of a cached kernel, which
+    // rely on knowing the arguments last set on it.
+    LaunchState =
+        ContextImpl->getKernelProgramCache().findKernelLaunchState(PiKernel);
   } else {
-    std::tie(PiKernel, KernelMutex, EliminatedArgMask, PiProgram) =
+    std::tie(PiKernel, LaunchState, EliminatedArgMask, PiProgram) =
         sycl::detail::ProgramManager::getInstance().getOrCreateKernel(
             ContextImpl, DeviceImpl, CommandGroup.MKernelName, nullptr);
   }
 
-  auto SetFunc = [&Plugin, &PiKernel, &Ctx, &getMemAllocationFunc](
-                     sycl::detail::ArgDesc &Arg, size_t NextTrueIndex) {
+  // The arguments are read when the kernel is added to the buffer.
+  std::unique_lock<std::mutex> Lock;
+  KernelArgShadow *ArgShadow = nullptr;
+  if (LaunchState) {
+    Lock = std::unique_lock<std::mutex>(LaunchState->Mutex);
+    ArgShadow = &LaunchState->Args;
+  }
+
+  auto SetFunc = [&Plugin, &PiKernel, &Ctx, &getMemAllocationFunc,
+                  ArgShadow](sycl::detail::ArgDesc &Arg, size_t NextTrueIndex) {
     sycl::detail::SetArgBasedOnType(
         Plugin, PiKernel,
         nullptr /* TODO: Handle spec constants and pass device image here */
         ,
-        getMemAllocationFunc, Ctx, false, Arg, NextTrueIndex);
+        getMemAllocationFunc, Ctx, false, Arg, NextTrueIndex, ArgShadow);
   };
   // Copy args for modification
   auto Args = CommandGroup.MArgs;
@@ -2463,8 +2583,14 @@ pi_int32 enqueueImpKernel(
   // Run OpenCL kernel
   auto ContextImpl = Queue->getContextImplPtr();
   auto DeviceImpl = Queue->getDeviceImplPtr();
+  // Cached kernels and programs must not be evicted until the kernel is
+  // enqueued.
+  auto CacheGuard = ContextImpl->getKernelProgramCache().acquireEvictionGuard();
   sycl::detail::pi::PiKernel Kernel = nullptr;
   std::mutex *KernelMutex = nullptr;
+  // Set for kernels owned by the cache, the runtime is the only one setting
+  // their arguments.
+  KernelLaunchState *LaunchState = nullptr;
   sycl::detail::pi::PiProgram Program = nullptr;
   const KernelArgMask *EliminatedArgMask;
 
@@ -2489,7 +2615,7 @@ pi_int32 enqueueImpKernel(
 
     Program = DeviceImageImpl->get_program_ref();
 
-    std::tie(Kernel, KernelMutex, EliminatedArgMask) =
+    std::tie(Kernel, LaunchState, EliminatedArgMask) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             KernelBundleImplPtr->get_context(), KernelName,
             /*PropList=*/{}, Program);
@@ -2501,7 +2627,7 @@ pi_int32 enqueueImpKernel(
     Program = SyclProg->getHandleRef();
     if (SyclProg->is_cacheable()) {
       sycl::detail::pi::PiKernel FoundKernel = nullptr;
-      std::tie(FoundKernel, KernelMutex, EliminatedArgMask, std::ignore) =
+      std::tie(FoundKernel, LaunchState, EliminatedArgMask, std::ignore) =
           detail::ProgramManager::getInstance().getOrCreateKernel(
               ContextImpl, DeviceImpl, KernelName, SyclProg.get());
       assert(FoundKernel == Kernel);
@@ -2516,7 +2642,7 @@ pi_int32 enqueueImpKernel(
       EliminatedArgMask = MSyclKernel->getKernelArgMask();
     }
   } else {
-    std::tie(Kernel, KernelMutex, EliminatedArgMask, Program) =
+    std::tie(Kernel, LaunchState, EliminatedArgMask, Program) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             ContextImpl, DeviceImpl, KernelName, nullptr);
   }
@@ -2539,10 +2665,37 @@ pi_int32 enqueueImpKernel(
     EventsWaitList = EventsWithDeviceGlobalInits;
   }
 
+  // A kernel sampled for profiling goes to a native queue with profiling
+  // enabled. The queue is out-of-order, so its dependencies are passed as
+  // events anyway.
+  const bool SampleProfiling =
+      OutEventImpl != nullptr && Queue->sampleProfiling(KernelName);
+  if (SampleProfiling)
+    OutEventImpl->setProfilingSampled();
+  if (OutEventImpl != nullptr)
+    queue_impl::ProfilingRequest::addKernelEvent(OutEventImpl);
+
   pi_result Error = PI_SUCCESS;
   {
-    assert(KernelMutex);
-    std::lock_guard<std::mutex> Lock(*KernelMutex);
+    std::unique_lock<std::mutex> Lock;
+    std::optional<KernelProgramCache::KernelCloneGuard> CloneGuard;
+    KernelArgShadow *ArgShadow = nullptr;
+    if (LaunchState) {
+      // Concurrent launches of a cached kernel don't wait for each other,
+      // those which find the kernel in use take a clone of it.
+      Lock = std::unique_lock<std::mutex>(LaunchState->Mutex, std::try_to_lock);
+      if (Lock.owns_lock()) {
+        ArgShadow = &LaunchState->Args;
+      } else {
+        CloneGuard.emplace(ContextImpl->getKernelProgramCache(), *LaunchState,
+                           Program, KernelName);
+        Kernel = CloneGuard->get().Kernel;
+        ArgShadow = &CloneGuard->get().Args;
+      }
+    } else {
+      assert(KernelMutex);
+      Lock = std::unique_lock<std::mutex>(*KernelMutex);
+    }
 
     // Set SLM/Cache configuration for the kernel if non-default value is
     // provided.
@@ -2556,7 +2709,8 @@ pi_int32 enqueueImpKernel(
 
     Error = SetKernelParamsAndLaunch(Queue, Args, DeviceImageImpl, Kernel,
                                      NDRDesc, EventsWaitList, OutEventImpl,
-                                     EliminatedArgMask, getMemAllocationFunc);
+                                     EliminatedArgMask, getMemAllocationFunc,
+                                     ArgShadow, SampleProfiling);
   }
   if (PI_SUCCESS != Error) {
     // If we have got non-success error code, let's analyze it to emit nice
@@ -2999,11 +3153,9 @@ pi_int32 ExecCGCommand::enqueueImpQueue() {
       // NOP for host device.
       return PI_SUCCESS;
     }
-    const PluginPtr &Plugin = MQueue->getPlugin();
     if (MEvent != nullptr)
       MEvent->setHostEnqueueTime();
-    Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
-        MQueue->getHandleRef(), 0, nullptr, Event);
+    MQueue->enqueueBarrier({}, Event);
 
     return PI_SUCCESS;
   }
@@ -3017,11 +3169,9 @@ pi_int32 ExecCGCommand::enqueueImpQueue() {
       // If Events is empty, then the barrier has no effect.
       return PI_SUCCESS;
     }
-    const PluginPtr &Plugin = MQueue->getPlugin();
     if (MEvent != nullptr)
       MEvent->setHostEnqueueTime();
-    Plugin->call<PiApiKind::piEnqueueEventsWaitWithBarrier>(
-        MQueue->getHandleRef(), PiEvents.size(), &PiEvents[0], Event);
+    MQueue->enqueueBarrier(PiEvents, Event);
 
     return PI_SUCCESS;
   }
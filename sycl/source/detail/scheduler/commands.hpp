@@ -234,6 +234,11 @@ public:
   std::vector<sycl::detail::pi::PiEvent>
   getPiEvents(const std::vector<EventImplPtr> &EventImpls) const;
   /// Collect PI events from EventImpls and filter out some of them in case of
+  /// in order queue. Used by submissions that have no associated command.
+  static std::vector<sycl::detail::pi::PiEvent>
+  getPiEvents(const std::vector<EventImplPtr> &EventImpls,
+              const QueueImplPtr &CommandQueue, bool IsHostTaskCommand);
+  /// Collect PI events from EventImpls and filter out some of them in case of
   /// in order queue. Does blocking enqueue if event is expected to produce pi
   /// event but has empty native handle.
   std::vector<sycl::detail::pi::PiEvent>
@@ -319,6 +324,9 @@ public:
     bool MVisited = false;
     /// Used for marking the node for deletion during cleanup.
     bool MToBeDeleted = false;
+    /// The latest graph traversal which visited the node, see
+    /// GraphBuilder::MVisitGeneration.
+    size_t MVisitGeneration = 0;
   };
   /// Used for marking the node during graph traversal.
   Marks MMarks;
@@ -687,6 +695,27 @@ void emitKernelInstrumentationData(
     const std::shared_ptr<detail::kernel_bundle_impl> &KernelBundleImplPtr,
     std::vector<ArgDesc> &CGArgs);
 
+// For XPTI instrumentation only.
+// Emits the trace points of ExecCGCommand for a non-kernel command group
+// which is enqueued without creating a node in graph: the node is created on
+// construction, and the enqueue is wrapped in task begin and end events.
+class BypassedCGInstrumentation {
+public:
+  BypassedCGInstrumentation(CG::CGTYPE Type,
+                            const detail::code_location &CodeLoc,
+                            const QueueImplPtr &Queue);
+
+  void emitTaskBegin();
+  /// Emits the signal for the native event of the command, if any, and the
+  /// task end event.
+  void emitTaskEnd(sycl::detail::pi::PiEvent Event);
+
+private:
+  void *MTraceEvent = nullptr;
+  int32_t MStreamID = -1;
+  uint64_t MInstanceID = 0;
+};
+
 class UpdateHostRequirementCommand : public Command {
 public:
   UpdateHostRequirementCommand(QueueImplPtr Queue, Requirement Req,
@@ -734,6 +763,13 @@ public:
 
   bool isActive() const { return MStatus == FusionStatus::ACTIVE; }
 
+  /// Marks the fusion as started by the scheduler rather than the user.
+  void setAutomatic() { MAutomatic = true; }
+
+  bool isAutomatic() const { return MAutomatic; }
+
+  bool isCancelled() const { return MStatus == FusionStatus::CANCELLED; }
+
   bool readyForDeletion() const { return MStatus == FusionStatus::DELETED; }
 
 private:
@@ -744,6 +780,8 @@ private:
   std::vector<Command *> MAuxiliaryCommands;
 
   FusionStatus MStatus;
+
+  bool MAutomatic = false;
 };
 
 // Enqueues a given kernel to a PiExtCommandBuffer
@@ -38,13 +38,22 @@ namespace detail {
 ///
 /// This information can be used to prove that executing two kernels that
 /// work on different parts of the memory object in parallel is legal.
+/// A sub-buffer is a contiguous region of its parent buffer, so accesses to
+/// disjoint sub-buffers are independent. Any other access is assumed to touch
+/// the whole memory object.
 // TODO merge with LeavesCollection's version of doOverlap (see
 // leaves_collection.cpp).
 static bool doOverlap(const Requirement *LHS, const Requirement *RHS) {
-  return (LHS->MOffsetInBytes + LHS->MAccessRange.size() * LHS->MElemSize >=
-          RHS->MOffsetInBytes) ||
-         (RHS->MOffsetInBytes + RHS->MAccessRange.size() * RHS->MElemSize >=
-          LHS->MOffsetInBytes);
+  if (!LHS->MIsSubBuffer || !RHS->MIsSubBuffer)
+    return true;
+
+  const size_t LHSStart = LHS->MOffsetInBytes;
+  const size_t LHSEnd = LHSStart + LHS->MMemoryRange.size() * LHS->MElemSize;
+
+  const size_t RHSStart = RHS->MOffsetInBytes;
+  const size_t RHSEnd = RHSStart + RHS->MMemoryRange.size() * RHS->MElemSize;
+
+  return LHSStart < RHSEnd && RHSStart < LHSEnd;
 }
 
 static bool sameCtx(const ContextImplPtr &LHS, const ContextImplPtr &RHS) {
@@ -132,6 +141,17 @@ static bool markNodeAsVisited(Command *Cmd, std::vector<Command *> &Visited) {
   return true;
 }
 
+/// Marks the node as visited by the traversal of the generation. Unlike the
+/// version above it doesn't need a separate pass to reset the marks.
+/// \return false if the node was already visited by the traversal.
+static bool markNodeAsVisited(Command *Cmd, size_t Generation) {
+  assert(Cmd && "Cmd can't be nullptr");
+  if (Cmd->MMarks.MVisitGeneration == Generation)
+    return false;
+  Cmd->MMarks.MVisitGeneration = Generation;
+  return true;
+}
+
 static void unmarkVisitedNodes(std::vector<Command *> &Visited) {
   for (Command *Cmd : Visited)
     Cmd->MMarks.MVisited = false;
@@ -246,7 +266,9 @@ MemObjRecord *Scheduler::GraphBuilder::getOrInsertMemObjRecord(
     MemObject->MRecord.reset(new MemObjRecord{Queue->getContextImplPtr(),
                                               LeafLimit, AllocateDependency});
 
-  MMemObjs.push_back(MemObject);
+  auto [Position, Inserted] = MMemObjPositions.try_emplace(MemObject);
+  if (Inserted)
+    Position->second = MMemObjs.insert(MMemObjs.end(), MemObject);
   return MemObject->MRecord.get();
 }
 
@@ -584,22 +606,21 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record,
                                         const Requirement *Req,
                                         const ContextImplPtr &Context) {
   std::set<Command *> RetDeps;
-  std::vector<Command *> Visited;
+  const size_t VisitGeneration = ++MVisitGeneration;
   const bool ReadOnlyReq = Req->MAccessMode == access::mode::read;
 
-  std::vector<Command *> ToAnalyze{Record->MWriteLeaves.toVector()};
-
-  if (!ReadOnlyReq) {
-    std::vector<Command *> V{Record->MReadLeaves.toVector()};
-
-    ToAnalyze.insert(ToAnalyze.begin(), V.begin(), V.end());
-  }
+  std::vector<Command *> ToAnalyze;
+  if (!ReadOnlyReq)
+    ToAnalyze = Record->MReadLeaves.toVector();
+  for (Command *Leaf : Record->MWriteLeaves)
+    ToAnalyze.push_back(Leaf);
 
+  std::vector<Command *> NewAnalyze;
   while (!ToAnalyze.empty()) {
     Command *DepCmd = ToAnalyze.back();
     ToAnalyze.pop_back();
 
-    std::vector<Command *> NewAnalyze;
+    NewAnalyze.clear();
 
     for (const DepDesc &Dep : DepCmd->MDeps) {
       if (Dep.MDepRequirement->MSYCLMemObj != Req->MSYCLMemObj)
@@ -626,12 +647,11 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record,
         break;
       }
 
-      if (markNodeAsVisited(Dep.MDepCommand, Visited))
+      if (markNodeAsVisited(Dep.MDepCommand, VisitGeneration))
         NewAnalyze.push_back(Dep.MDepCommand);
     }
     ToAnalyze.insert(ToAnalyze.end(), NewAnalyze.begin(), NewAnalyze.end());
   }
-  unmarkVisitedNodes(Visited);
   return RetDeps;
 }
 
@@ -720,14 +740,19 @@ AllocaCommandBase *Scheduler::GraphBuilder::getOrCreateAllocaForReq(
       // memory is supported regardless of the access mode (the pointer will be
       // reused). For devices without host unified memory the initialization
       // will be performed as a write operation.
-      // TODO the case where the first alloca is made with a discard mode and
-      // the user pointer is read-only is still not handled: it leads to
-      // unnecessary copy on devices with unified host memory support.
+      // A read-only user pointer is not reused for a discard access mode: the
+      // data is going to be overwritten anyway, so the allocation would only
+      // be a read-only copy of it.
       const bool HostUnifiedMemory =
           checkHostUnifiedMemory(Queue->getContextImplPtr());
       SYCLMemObjI *MemObj = Req->MSYCLMemObj;
-      const bool InitFromUserData = Record->MAllocaCommands.empty() &&
-                                    (HostUnifiedMemory || MemObj->isInterop());
+      const bool DiscardReadOnlyUserData =
+          MemObj->isHostPointerReadOnly() && !MemObj->isInterop() &&
+          (Req->MAccessMode == access::mode::discard_write ||
+           Req->MAccessMode == access::mode::discard_read_write);
+      const bool InitFromUserData =
+          Record->MAllocaCommands.empty() && !DiscardReadOnlyUserData &&
+          (HostUnifiedMemory || MemObj->isInterop());
       AllocaCommandBase *LinkedAllocaCmd = nullptr;
 
       // For the first allocation on a device without host unified memory we
@@ -1283,11 +1308,11 @@ void Scheduler::GraphBuilder::cleanupCommand(
 }
 
 void Scheduler::GraphBuilder::removeRecordForMemObj(SYCLMemObjI *MemObject) {
-  const auto It = std::find_if(
-      MMemObjs.begin(), MMemObjs.end(),
-      [MemObject](const SYCLMemObjI *Obj) { return Obj == MemObject; });
-  if (It != MMemObjs.end())
-    MMemObjs.erase(It);
+  auto Position = MMemObjPositions.find(MemObject);
+  if (Position != MMemObjPositions.end()) {
+    MMemObjs.erase(Position->second);
+    MMemObjPositions.erase(Position);
+  }
   MemObject->MRecord.reset();
 }
 
@@ -1598,7 +1623,10 @@ Scheduler::GraphBuilder::completeFusion(QueueImplPtr Queue,
   // them from the graph to restore the state before starting fusion, so we can
   // add the fused kernel to the graph in the next step.
   // Clean up the old commands after successfully fusing them.
+  // The events of the old commands remain with the user, waiting for them
+  // waits for the fused kernel instead.
   for (auto OldCmd = CmdList.rbegin(); OldCmd != CmdList.rend(); ++OldCmd) {
+    (*OldCmd)->getEvent()->attachEventToComplete(FusedKernelCmd->getEvent());
     removeNodeFromGraph(*OldCmd, ToEnqueue);
     cleanupCommand(*OldCmd, /* AllowUnsubmitted */ true);
   }
@@ -1640,6 +1668,117 @@ Scheduler::GraphBuilder::completeFusion(QueueImplPtr Queue,
 #endif // SYCL_EXT_CODEPLAY_KERNEL_FUSION
 }
 
+// The largest number of kernels fused automatically, longer chains are split
+// into several fusions.
+static constexpr size_t MaxAutomaticFusionKernels = 16;
+
+static bool usesAnyMemObj(CG &CommandGroup,
+                          const std::vector<SYCLMemObjI *> &MemObjs) {
+  return std::any_of(CommandGroup.getRequirements().begin(),
+                     CommandGroup.getRequirements().end(),
+                     [&](const Requirement *Req) {
+                       return std::find(MemObjs.begin(), MemObjs.end(),
+                                        Req->MSYCLMemObj) != MemObjs.end();
+                     });
+}
+
+static bool usesAnyMemObj(KernelFusionCommand &Fusion,
+                          const std::vector<SYCLMemObjI *> &MemObjs) {
+  return std::any_of(Fusion.getFusionList().begin(),
+                     Fusion.getFusionList().end(), [&](ExecCGCommand *Cmd) {
+                       return usesAnyMemObj(Cmd->getCG(), MemObjs);
+                     });
+}
+
+static std::vector<SYCLMemObjI *> getMemObjs(CG &CommandGroup) {
+  std::vector<SYCLMemObjI *> MemObjs;
+  for (const Requirement *Req : CommandGroup.getRequirements())
+    MemObjs.push_back(Req->MSYCLMemObj);
+  return MemObjs;
+}
+
+// The cost model of the automatic fusion: a kernel extends the fusion if it
+// has the same iteration space as the kernels fused so far and passes data
+// through a memory object with them, as elementwise chains do.
+static bool extendsAutomaticFusion(KernelFusionCommand &Fusion,
+                                   CG &CommandGroup) {
+  const std::vector<ExecCGCommand *> &FusionList = Fusion.getFusionList();
+  if (FusionList.empty())
+    return true;
+  if (FusionList.size() >= MaxAutomaticFusionKernels)
+    return false;
+  const NDRDescT &First =
+      static_cast<CGExecKernel &>(FusionList.front()->getCG()).MNDRDesc;
+  const NDRDescT &NDR = static_cast<CGExecKernel &>(CommandGroup).MNDRDesc;
+  if (NDR.Dims != First.Dims || NDR.GlobalSize != First.GlobalSize ||
+      NDR.LocalSize != First.LocalSize ||
+      NDR.GlobalOffset != First.GlobalOffset)
+    return false;
+  return usesAnyMemObj(Fusion, getMemObjs(CommandGroup));
+}
+
+void Scheduler::GraphBuilder::prepareAutomaticFusion(
+    CG &CommandGroup, bool IsCandidate, const QueueImplPtr &Queue,
+    std::vector<Command *> &ToEnqueue) {
+  auto QUniqueID = std::hash<sycl::detail::queue_impl *>()(Queue.get());
+  KernelFusionCommand *OwnFusion =
+      isInAutomaticFusion(QUniqueID) ? findFusionList(QUniqueID)->second.get()
+                                     : nullptr;
+  const bool ExtendsOwnFusion =
+      OwnFusion && IsCandidate &&
+      extendsAutomaticFusion(*OwnFusion, CommandGroup);
+
+  // Commands from other queues can't be part of the fusion, the fusion needs
+  // to be completed before they are added to the graph depending on it.
+  const std::vector<SYCLMemObjI *> MemObjs = getMemObjs(CommandGroup);
+  for (auto &[QueueID, Fusion] : MFusionMap) {
+    if (!Fusion->isActive() || !Fusion->isAutomatic())
+      continue;
+    if (Fusion.get() == OwnFusion ? !ExtendsOwnFusion
+                                  : usesAnyMemObj(*Fusion, MemObjs))
+      completeAutomaticFusion(Fusion->getQueue(), ToEnqueue);
+  }
+
+  if (IsCandidate && !isInFusionMode(QUniqueID)) {
+    startFusion(Queue);
+    findFusionList(QUniqueID)->second->setAutomatic();
+  }
+}
+
+void Scheduler::GraphBuilder::completeAutomaticFusions(
+    const std::vector<SYCLMemObjI *> &MemObjs,
+    std::vector<Command *> &ToEnqueue) {
+  for (auto &[QueueID, Fusion] : MFusionMap) {
+    if (Fusion->isActive() && Fusion->isAutomatic() &&
+        usesAnyMemObj(*Fusion, MemObjs))
+      completeAutomaticFusion(Fusion->getQueue(), ToEnqueue);
+  }
+}
+
+void Scheduler::GraphBuilder::completeAutomaticFusion(
+    QueueImplPtr Queue, std::vector<Command *> &ToEnqueue) {
+  auto QUniqueID = std::hash<sycl::detail::queue_impl *>()(Queue.get());
+  if (!isInAutomaticFusion(QUniqueID))
+    return;
+  auto *FusionCmd = findFusionList(QUniqueID)->second.get();
+
+  std::vector<std::string> KernelNames;
+  for (ExecCGCommand *Cmd : FusionCmd->getFusionList())
+    KernelNames.push_back(
+        static_cast<CGExecKernel &>(Cmd->getCG()).getKernelName());
+  if (KernelNames.size() < 2 || MUnprofitableFusions.count(KernelNames)) {
+    cancelFusion(Queue, ToEnqueue);
+    return;
+  }
+
+  completeFusion(Queue, ToEnqueue, property_list{});
+  // Fusions compiled in the background are cancelled until they are ready,
+  // that is no reason to give up on them.
+  if (FusionCmd->isCancelled() &&
+      !SYCLConfig<SYCL_ENABLE_ASYNC_FUSION>::get())
+    MUnprofitableFusions.insert(std::move(KernelNames));
+}
+
 bool Scheduler::GraphBuilder::isInFusionMode(QueueIdT Id) {
   auto FusionList = findFusionList(Id);
   if (FusionList == MFusionMap.end()) {
@@ -1648,6 +1787,10 @@ bool Scheduler::GraphBuilder::isInFusionMode(QueueIdT Id) {
   return FusionList->second->isActive();
 }
 
+bool Scheduler::GraphBuilder::isInAutomaticFusion(QueueIdT Id) {
+  return isInFusionMode(Id) && findFusionList(Id)->second->isAutomatic();
+}
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
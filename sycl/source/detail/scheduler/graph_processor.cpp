@@ -31,6 +31,24 @@ void Scheduler::GraphProcessor::waitForEvent(const EventImplPtr &Event,
   if (!Cmd)
     return;
 
+  KernelFusionCommand *FusionCmd = isPartOfActiveFusion(Cmd);
+  if (FusionCmd && FusionCmd->isAutomatic()) {
+    // Waiting for a kernel of an automatic fusion completes the fusion first.
+    // The fused kernel replaces the kernel, its event then waits for the
+    // fused kernel.
+    GraphReadLock.unlock();
+    Scheduler::getInstance().flushAutomaticFusion(FusionCmd->getQueue());
+    GraphReadLock.lock();
+    Cmd = getCommand(Event);
+    if (!Cmd) {
+      GraphReadLock.unlock();
+      Event->wait(Event);
+      if (LockTheLock)
+        GraphReadLock.lock();
+      return;
+    }
+  }
+
   EnqueueResultT Res;
   bool Enqueued =
       enqueueCommand(Cmd, GraphReadLock, Res, ToCleanUp, Cmd, BLOCKING);
@@ -93,14 +111,21 @@ bool Scheduler::GraphProcessor::enqueueCommand(
     // on one of the kernels in the fusion list has triggered it to be
     // enqueued. To avoid circular dependencies and deadlocks, we will need to
     // cancel fusion here and enqueue the kernels in the fusion list right
-    // away.
-    printFusionWarning("Aborting fusion because synchronization with one of "
-                       "the kernels in the fusion list was requested");
+    // away. Automatic fusions are completed instead when the placeholder
+    // itself is requested, see also waitForEvent, as completing the fusion
+    // only removes the kernels in the fusion list from the graph.
+    bool CompleteFusion = FusionCmd->isAutomatic() && Cmd == FusionCmd;
+    if (!CompleteFusion)
+      printFusionWarning("Aborting fusion because synchronization with one of "
+                         "the kernels in the fusion list was requested");
     // We need to unlock the read lock, as cancelFusion in the scheduler will
     // acquire a write lock to alter the graph.
     GraphReadLock.unlock();
     // Cancel fusion will take care of enqueueing all the kernels.
-    Scheduler::getInstance().cancelFusion(FusionCmd->getQueue());
+    if (CompleteFusion)
+      Scheduler::getInstance().flushAutomaticFusion(FusionCmd->getQueue());
+    else
+      Scheduler::getInstance().cancelFusion(FusionCmd->getQueue());
     // Lock the read lock again.
     GraphReadLock.lock();
     // The fusion (placeholder) command should have been enqueued by
@@ -8,11 +8,13 @@
 
 #include "detail/sycl_mem_obj_i.hpp"
 #include <detail/global_handler.hpp>
+#include <detail/kernel_impl.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/stream_impl.hpp>
 #include <sycl/device_selector.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <memory>
@@ -91,6 +93,26 @@ void Scheduler::waitForRecordToFinish(MemObjRecord *Record,
   }
 }
 
+// Only kernels passing their data through buffers are fused automatically,
+// the JIT compiler can't handle streams and reductions.
+static bool isAutomaticFusionCandidate(
+    CG &CommandGroup, const QueueImplPtr &Queue,
+    sycl::detail::pi::PiExtCommandBuffer CommandBuffer, bool HasStreams,
+    bool HasAuxiliaryResources) {
+  if (CommandGroup.getType() != CG::Kernel || CommandBuffer || HasStreams ||
+      HasAuxiliaryResources || !Queue->isInOrder() || Queue->is_host() ||
+      CommandGroup.getRequirements().empty())
+    return false;
+  auto &KernelCG = static_cast<CGExecKernel &>(CommandGroup);
+  if (KernelCG.MKernelName.empty() ||
+      (KernelCG.MSyclKernel && KernelCG.MSyclKernel->isInterop()))
+    return false;
+  return std::none_of(KernelCG.MArgs.begin(), KernelCG.MArgs.end(),
+                      [](const ArgDesc &Arg) {
+                        return Arg.MType == kernel_param_kind_t::kind_pointer;
+                      });
+}
+
 EventImplPtr Scheduler::addCG(
     std::unique_ptr<detail::CG> CommandGroup, const QueueImplPtr &Queue,
     sycl::detail::pi::PiExtCommandBuffer CommandBuffer,
@@ -118,9 +140,19 @@ EventImplPtr Scheduler::addCG(
   CommandGroup->clearAuxiliaryResources();
 
   bool ShouldEnqueue = true;
+  std::vector<Command *> FusionCmds;
   {
     WriteLockT Lock = acquireWriteLock();
 
+    if (SYCLConfig<SYCL_ENABLE_AUTO_FUSION>::get()) {
+      WriteLockT FusionMapLock = acquireFusionWriteLock();
+      bool IsCandidate = isAutomaticFusionCandidate(
+          *CommandGroup, Queue, CommandBuffer, !Streams.empty(),
+          !AuxiliaryResources.empty());
+      MGraphBuilder.prepareAutomaticFusion(*CommandGroup, IsCandidate, Queue,
+                                           FusionCmds);
+    }
+
     Command *NewCmd = nullptr;
     switch (Type) {
     case CG::UpdateHost:
@@ -145,8 +177,14 @@ EventImplPtr Scheduler::addCG(
       NewEvent = Result.NewEvent;
       ShouldEnqueue = Result.ShouldEnqueue;
     }
-    NewEvent->setSubmissionTime();
   }
+  // The completed automatic fusions precede the new command.
+  if (!FusionCmds.empty())
+    enqueueCommandForCG(nullptr, FusionCmds);
+
+  // Querying the device timer may involve a backend call, don't hold the graph
+  // lock for it.
+  NewEvent->setSubmissionTime();
 
   if (ShouldEnqueue) {
     enqueueCommandForCG(NewEvent, AuxiliaryCmds);
@@ -224,6 +262,10 @@ EventImplPtr Scheduler::addCopyBack(Requirement *Req) {
   Command *NewCmd = nullptr;
   {
     WriteLockT Lock = acquireWriteLock();
+    if (SYCLConfig<SYCL_ENABLE_AUTO_FUSION>::get()) {
+      WriteLockT FusionMapLock = acquireFusionWriteLock();
+      MGraphBuilder.completeAutomaticFusions({Req->MSYCLMemObj}, AuxiliaryCmds);
+    }
     NewCmd = MGraphBuilder.addCopyBack(Req, AuxiliaryCmds);
     // Command was not creted because there were no operations with
     // buffer.
@@ -278,6 +320,20 @@ bool Scheduler::removeMemoryObject(detail::SYCLMemObjI *MemObj,
     // No operations were performed on the mem object
     return true;
 
+  // Enqueueing the leaves of the record would cancel an automatic fusion.
+  if (SYCLConfig<SYCL_ENABLE_AUTO_FUSION>::get()) {
+    std::vector<Command *> ToEnqueue;
+    {
+      WriteLockT Lock = StrictLock ? acquireWriteLock()
+                                   : WriteLockT(MGraphLock, std::try_to_lock);
+      if (!Lock.owns_lock())
+        return false;
+      WriteLockT FusionMapLock = acquireFusionWriteLock();
+      MGraphBuilder.completeAutomaticFusions({MemObj}, ToEnqueue);
+    }
+    enqueueCommandForCG(nullptr, ToEnqueue);
+  }
+
   {
     // This only needs a shared mutex as it only involves enqueueing and
     // awaiting for events
@@ -305,6 +361,10 @@ EventImplPtr Scheduler::addHostAccessor(Requirement *Req) {
 
   {
     WriteLockT Lock = acquireWriteLock();
+    if (SYCLConfig<SYCL_ENABLE_AUTO_FUSION>::get()) {
+      WriteLockT FusionMapLock = acquireFusionWriteLock();
+      MGraphBuilder.completeAutomaticFusions({Req->MSYCLMemObj}, AuxiliaryCmds);
+    }
 
     Command *NewCmd = MGraphBuilder.addHostAccessor(Req, AuxiliaryCmds);
     if (!NewCmd)
@@ -433,12 +493,28 @@ void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds) {
       return;
   }
 
+  // Accumulate finished commands and only take the graph lock once enough of
+  // them have built up, so that the cost of acquiring it is amortized.
+  bool Batched = false;
+  if (size_t BatchSize =
+          SYCLConfig<SYCL_EXECUTION_GRAPH_CLEANUP_BATCH_SIZE>::get();
+      BatchSize > 1 && !Cmds.empty()) {
+    std::lock_guard<std::mutex> Lock{MDeferredCleanupMutex};
+    MDeferredCleanupCommands.insert(MDeferredCleanupCommands.end(),
+                                    Cmds.begin(), Cmds.end());
+    if (MDeferredCleanupCommands.size() < BatchSize)
+      return;
+    Batched = true;
+  }
+
   WriteLockT Lock(MGraphLock, std::try_to_lock);
   // In order to avoid deadlocks related to blocked commands, defer cleanup if
   // the lock wasn't acquired.
   if (Lock.owns_lock()) {
-    for (Command *Cmd : Cmds) {
-      MGraphBuilder.cleanupCommand(Cmd);
+    if (!Batched) {
+      for (Command *Cmd : Cmds) {
+        MGraphBuilder.cleanupCommand(Cmd);
+      }
     }
     std::vector<Command *> DeferredCleanupCommands;
     {
@@ -449,7 +525,7 @@ void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds) {
       MGraphBuilder.cleanupCommand(Cmd);
     }
 
-  } else {
+  } else if (!Batched) {
     std::lock_guard<std::mutex> Lock{MDeferredCleanupMutex};
     MDeferredCleanupCommands.insert(MDeferredCleanupCommands.end(),
                                     Cmds.begin(), Cmds.end());
@@ -568,9 +644,15 @@ void Scheduler::cleanupAuxiliaryResources(BlockingT Blocking) {
 }
 
 void Scheduler::startFusion(QueueImplPtr Queue) {
-  WriteLockT Lock = acquireWriteLock();
-  WriteLockT FusionMapLock = acquireFusionWriteLock();
-  MGraphBuilder.startFusion(Queue);
+  std::vector<Command *> ToEnqueue;
+  {
+    WriteLockT Lock = acquireWriteLock();
+    WriteLockT FusionMapLock = acquireFusionWriteLock();
+    // The user takes over from the automatic fusion.
+    MGraphBuilder.completeAutomaticFusion(Queue, ToEnqueue);
+    MGraphBuilder.startFusion(Queue);
+  }
+  enqueueCommandForCG(nullptr, ToEnqueue);
 }
 
 void Scheduler::cleanUpCmdFusion(sycl::detail::queue_impl *Queue) {
@@ -609,12 +691,55 @@ bool Scheduler::isInFusionMode(QueueIdT queue) {
   return MGraphBuilder.isInFusionMode(queue);
 }
 
+bool Scheduler::isInAutomaticFusion(QueueIdT Queue) {
+  ReadLockT Lock = acquireFusionReadLock();
+  return MGraphBuilder.isInAutomaticFusion(Queue);
+}
+
+void Scheduler::flushAutomaticFusion(QueueImplPtr Queue) {
+  std::vector<Command *> ToEnqueue;
+  {
+    WriteLockT Lock = acquireWriteLock();
+    WriteLockT FusionMapLock = acquireFusionWriteLock();
+    MGraphBuilder.completeAutomaticFusion(std::move(Queue), ToEnqueue);
+  }
+  enqueueCommandForCG(nullptr, ToEnqueue);
+}
+
 void Scheduler::printFusionWarning(const std::string &Message) {
   if (detail::SYCLConfig<detail::SYCL_RT_WARNING_LEVEL>::get() > 0) {
     std::cerr << "WARNING: " << Message << "\n";
   }
 }
 
+bool Scheduler::CheckEventReadiness(const ContextImplPtr &Context,
+                                    const EventImplPtr &SyclEventImplPtr) {
+  // Events that don't have an initialized context are throwaway events that
+  // don't represent actual dependencies. Calling getContextImpl() would set
+  // their context, which we wish to avoid as it is expensive.
+  if (!SyclEventImplPtr->isContextInitialized())
+    return true;
+  // Host events (e.g. produced by host tasks) can't be passed to the backend,
+  // the only way to satisfy them is to wait for their completion.
+  if (SyclEventImplPtr->is_host())
+    return SyclEventImplPtr->isCompleted();
+  // Cross-context dependencies can't be passed to the backend directly.
+  if (SyclEventImplPtr->getContextImpl() != Context)
+    return false;
+
+  // A nullptr here means that the command does not produce a PI event or it
+  // hasn't been enqueued yet.
+  return SyclEventImplPtr->getHandleRef() != nullptr;
+}
+
+bool Scheduler::areEventsSafeForSchedulerBypass(
+    const std::vector<EventImplPtr> &DepEvents, const ContextImplPtr &Context) {
+  return std::all_of(DepEvents.begin(), DepEvents.end(),
+                     [&Context](const EventImplPtr &SyclEventImplPtr) {
+                       return CheckEventReadiness(Context, SyclEventImplPtr);
+                     });
+}
+
 KernelFusionCommand *Scheduler::isPartOfActiveFusion(Command *Cmd) {
   auto CmdType = Cmd->getType();
   switch (CmdType) {
@@ -14,6 +14,7 @@
 #include <sycl/detail/cg.hpp>
 
 #include <cstddef>
+#include <list>
 #include <memory>
 #include <queue>
 #include <set>
@@ -457,6 +458,13 @@ public:
 
   bool isInFusionMode(QueueIdT Queue);
 
+  /// \return true if the queue is in a fusion started by the scheduler with
+  /// SYCL_ENABLE_AUTO_FUSION.
+  bool isInAutomaticFusion(QueueIdT Queue);
+
+  /// Completes the fusion started by the scheduler on the queue, if any.
+  void flushAutomaticFusion(QueueImplPtr Queue);
+
   Scheduler();
   ~Scheduler();
   void releaseResources();
@@ -466,6 +474,18 @@ public:
                            std::vector<Command *> &AuxilaryCmds,
                            BlockingT Blocking = NON_BLOCKING);
 
+  /// Checks whether all the events can be passed to the backend as native
+  /// dependencies of a command enqueued directly, i.e. without adding the
+  /// command group to the graph.
+  ///
+  /// \param DepEvents is a list of events the command group depends on.
+  /// \param Context is the context of the queue the command group is
+  /// submitted to.
+  /// \return true if the command group may bypass the scheduler.
+  static bool
+  areEventsSafeForSchedulerBypass(const std::vector<EventImplPtr> &DepEvents,
+                                  const ContextImplPtr &Context);
+
 protected:
   using RWLockT = std::shared_timed_mutex;
   using ReadLockT = std::shared_lock<RWLockT>;
@@ -517,6 +537,11 @@ protected:
   /// avoidance to the Fusion map
   ReadLockT acquireFusionReadLock() { return ReadLockT{MFusionMapLock}; }
 
+  /// Checks that a single event may be used as a native dependency of a
+  /// command that bypasses the scheduler.
+  static bool CheckEventReadiness(const ContextImplPtr &Context,
+                                  const EventImplPtr &SyclEventImplPtr);
+
   void cleanupCommands(const std::vector<Command *> &Cmds);
 
   void NotifyHostTaskCompletion(Command *Cmd);
@@ -664,7 +689,32 @@ protected:
 
     bool isInFusionMode(QueueIdT queue);
 
-    std::vector<SYCLMemObjI *> MMemObjs;
+    bool isInAutomaticFusion(QueueIdT Queue);
+
+    /// Prepares the automatic fusion for a command group submitted to the
+    /// queue. Automatic fusions which the command group depends on through
+    /// memory objects are completed, unless the command group extends the
+    /// fusion of the queue. A fusion is started for a candidate command group
+    /// if the queue isn't in fusion mode.
+    void prepareAutomaticFusion(CG &CommandGroup, bool IsCandidate,
+                                const QueueImplPtr &Queue,
+                                std::vector<Command *> &ToEnqueue);
+
+    /// Completes the automatic fusions using any of the memory objects.
+    void completeAutomaticFusions(const std::vector<SYCLMemObjI *> &MemObjs,
+                                  std::vector<Command *> &ToEnqueue);
+
+    /// Completes the automatic fusion of the queue, if any. Single kernels and
+    /// kernel sequences which failed to fuse before are executed unfused.
+    void completeAutomaticFusion(QueueImplPtr Queue,
+                                 std::vector<Command *> &ToEnqueue);
+
+    /// Memory objects that have a record in the graph, in the order their
+    /// records were created. Removal happens under the graph write lock, so
+    /// the position of each object is kept to remove it in constant time.
+    std::list<SYCLMemObjI *> MMemObjs;
+    std::unordered_map<SYCLMemObjI *, std::list<SYCLMemObjI *>::iterator>
+        MMemObjPositions;
 
   private:
     /// Inserts the command required to update the memory object state in the
@@ -745,11 +795,18 @@ protected:
     std::queue<Command *> MCmdsToVisit;
     /// Used to track commands that have been visited during graph traversal.
     std::vector<Command *> MVisitedCmds;
+    /// Identifies the latest traversal which marks the visited commands with
+    /// Command::Marks::MVisitGeneration.
+    size_t MVisitGeneration = 0;
 
     /// Used to track queues that are in fusion mode and the
     /// command-groups/kernels submitted for fusion.
     FusionMap MFusionMap;
 
+    /// Names of the kernel sequences the JIT compiler failed to fuse, they
+    /// are not fused automatically again.
+    std::set<std::vector<std::string>> MUnprofitableFusions;
+
     /// Prints contents of graph to text file in DOT format
     ///
     /// \param ModeName is a stringified printing mode name to be used
@@ -0,0 +1,422 @@
+//==------- spirv_pruning.cpp - Removal of unused SPIR-V functions ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/spirv_pruning.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+namespace {
+
+constexpr uint32_t SPIRVMagicNumber = 0x07230203;
+constexpr size_t SPIRVHeaderWords = 5;
+
+constexpr uint32_t DecorationLinkageAttributes = 41;
+constexpr uint32_t LinkageTypeExport = 0;
+
+// Opcodes from the SPIR-V specification which are handled here.
+enum Op : uint16_t {
+  OpUndef = 1,
+  OpSourceContinued = 2,
+  OpSource = 3,
+  OpSourceExtension = 4,
+  OpName = 5,
+  OpMemberName = 6,
+  OpString = 7,
+  OpLine = 8,
+  OpExtension = 10,
+  OpExtInstImport = 11,
+  OpExtInst = 12,
+  OpMemoryModel = 14,
+  OpEntryPoint = 15,
+  OpExecutionMode = 16,
+  OpCapability = 17,
+  OpTypeVoid = 19,
+  OpTypePipe = 38,
+  OpTypeForwardPointer = 39,
+  OpConstantTrue = 41,
+  OpConstantNull = 46,
+  OpSpecConstantTrue = 48,
+  OpSpecConstantOp = 52,
+  OpFunction = 54,
+  OpFunctionEnd = 56,
+  OpVariable = 59,
+  OpDecorate = 71,
+  OpMemberDecorate = 72,
+  OpDecorationGroup = 73,
+  OpGroupDecorate = 74,
+  OpGroupMemberDecorate = 75,
+  OpLabel = 248,
+  OpNoLine = 317,
+  OpTypePipeStorage = 322,
+  OpTypeNamedBarrier = 327,
+  OpModuleProcessed = 330,
+  OpExecutionModeId = 331,
+  OpDecorateId = 332,
+  OpConstantFunctionPointerINTEL = 5600,
+  OpAsmTargetINTEL = 5609,
+  OpAsmINTEL = 5610,
+  OpDecorateString = 5632,
+  OpMemberDecorateString = 5633,
+  OpTypeStructContinuedINTEL = 6090,
+  OpConstantCompositeContinuedINTEL = 6091,
+  OpSpecConstantCompositeContinuedINTEL = 6092,
+};
+
+/// Where a module-level instruction keeps its result id.
+enum class ResultPos { Unknown, None, Word1, Word2 };
+
+ResultPos getModuleLevelResultPos(uint16_t Opcode, bool &IsType) {
+  IsType = false;
+  if ((Opcode >= OpTypeVoid && Opcode <= OpTypePipe) ||
+      Opcode == OpTypePipeStorage || Opcode == OpTypeNamedBarrier) {
+    IsType = true;
+    return ResultPos::Word1;
+  }
+  if ((Opcode >= OpConstantTrue && Opcode <= OpConstantNull) ||
+      (Opcode >= OpSpecConstantTrue && Opcode <= OpSpecConstantOp))
+    return ResultPos::Word2;
+  switch (Opcode) {
+  case OpSourceContinued:
+  case OpSource:
+  case OpSourceExtension:
+  case OpName:
+  case OpMemberName:
+  case OpLine:
+  case OpExtension:
+  case OpMemoryModel:
+  case OpEntryPoint:
+  case OpExecutionMode:
+  case OpCapability:
+  case OpTypeForwardPointer:
+  case OpDecorate:
+  case OpMemberDecorate:
+  case OpNoLine:
+  case OpModuleProcessed:
+  case OpExecutionModeId:
+  case OpDecorateId:
+  case OpDecorateString:
+  case OpMemberDecorateString:
+  case OpTypeStructContinuedINTEL:
+  case OpConstantCompositeContinuedINTEL:
+  case OpSpecConstantCompositeContinuedINTEL:
+    return ResultPos::None;
+  case OpString:
+  case OpExtInstImport:
+  case OpDecorationGroup:
+    return ResultPos::Word1;
+  case OpUndef:
+  case OpExtInst:
+  case OpVariable:
+  case OpConstantFunctionPointerINTEL:
+  case OpAsmTargetINTEL:
+  case OpAsmINTEL:
+    return ResultPos::Word2;
+  default:
+    return ResultPos::Unknown;
+  }
+}
+
+/// Instructions which only attach information to the id in their first
+/// operand.
+bool isAnnotation(uint16_t Opcode) {
+  switch (Opcode) {
+  case OpName:
+  case OpMemberName:
+  case OpDecorate:
+  case OpMemberDecorate:
+  case OpDecorateId:
+  case OpDecorateString:
+  case OpMemberDecorateString:
+    return true;
+  default:
+    return false;
+  }
+}
+
+std::string getLiteralString(const uint32_t *Begin, const uint32_t *End) {
+  std::string Str;
+  for (const uint32_t *W = Begin; W != End; ++W)
+    for (unsigned Byte = 0; Byte < 4; ++Byte) {
+      char C = static_cast<char>((*W >> (8 * Byte)) & 0xff);
+      if (C == '\0')
+        return Str;
+      Str += C;
+    }
+  return Str;
+}
+
+struct Instruction {
+  /// Index of the first word of the instruction.
+  size_t Offset;
+  uint16_t Opcode;
+  uint16_t NumWords;
+};
+
+struct Function {
+  uint32_t Id;
+  /// The instructions from OpFunction to OpFunctionEnd, both included.
+  size_t BeginInst;
+  size_t EndInst;
+};
+
+struct Export {
+  uint32_t Target;
+  std::string Name;
+};
+
+/// A SPIR-V module split into instructions.
+class SPIRVModule {
+public:
+  bool parse(const std::vector<char> &Binary) {
+    if (Binary.size() % sizeof(uint32_t) != 0 ||
+        Binary.size() < SPIRVHeaderWords * sizeof(uint32_t))
+      return false;
+    Words.resize(Binary.size() / sizeof(uint32_t));
+    std::memcpy(Words.data(), Binary.data(), Binary.size());
+    if (Words[0] != SPIRVMagicNumber)
+      return false;
+
+    bool InFunction = false;
+    for (size_t Offset = SPIRVHeaderWords; Offset < Words.size();) {
+      uint16_t Opcode = Words[Offset] & 0xffff;
+      uint16_t NumWords = Words[Offset] >> 16;
+      if (NumWords == 0 || Offset + NumWords > Words.size())
+        return false;
+      if (Opcode == OpFunction) {
+        if (InFunction || NumWords < 5)
+          return false;
+        InFunction = true;
+        Functions.push_back({Words[Offset + 2], Insts.size(), 0});
+      } else if (Opcode == OpFunctionEnd) {
+        if (!InFunction)
+          return false;
+        InFunction = false;
+        Functions.back().EndInst = Insts.size();
+      }
+      ModuleLevel.push_back(!InFunction && Opcode != OpFunctionEnd);
+      Insts.push_back({Offset, Opcode, NumWords});
+      Offset += NumWords;
+    }
+    return !InFunction;
+  }
+
+  /// \return true if the instruction is outside of function bodies.
+  bool isModuleLevel(size_t InstIdx) const { return ModuleLevel[InstIdx]; }
+
+  const uint32_t *operands(const Instruction &Inst) const {
+    return Words.data() + Inst.Offset + 1;
+  }
+
+  std::vector<Export> getExports() const {
+    std::vector<Export> Exports;
+    for (const Instruction &Inst : Insts) {
+      if (Inst.Opcode == OpFunction)
+        break;
+      if (Inst.Opcode != OpDecorate || Inst.NumWords < 5)
+        continue;
+      const uint32_t *Ops = operands(Inst);
+      if (Ops[1] != DecorationLinkageAttributes ||
+          Ops[Inst.NumWords - 2] != LinkageTypeExport)
+        continue;
+      Exports.push_back(
+          {Ops[0], getLiteralString(Ops + 2, Ops + Inst.NumWords - 2)});
+    }
+    return Exports;
+  }
+
+  std::vector<uint32_t> Words;
+  std::vector<Instruction> Insts;
+  std::vector<Function> Functions;
+
+private:
+  std::vector<bool> ModuleLevel;
+};
+
+} // namespace
+
+std::vector<std::string>
+getSPIRVExportedFunctions(const std::vector<char> &Binary) {
+  SPIRVModule M;
+  std::vector<std::string> Names;
+  if (!M.parse(Binary))
+    return Names;
+  for (Export &E : M.getExports())
+    Names.push_back(std::move(E.Name));
+  return Names;
+}
+
+bool pruneSPIRVFunctions(std::vector<char> &Binary,
+                         const std::vector<std::string> &Roots) {
+  SPIRVModule M;
+  if (!M.parse(Binary))
+    return false;
+
+  std::unordered_map<uint32_t, size_t> FunctionIdx;
+  for (size_t I = 0; I < M.Functions.size(); ++I)
+    FunctionIdx[M.Functions[I].Id] = I;
+
+  std::vector<bool> Reachable(M.Functions.size(), false);
+  std::vector<size_t> Worklist;
+  auto MarkReferenced = [&](const uint32_t *Begin, const uint32_t *End) {
+    for (const uint32_t *W = Begin; W != End; ++W) {
+      auto It = FunctionIdx.find(*W);
+      if (It != FunctionIdx.end() && !Reachable[It->second]) {
+        Reachable[It->second] = true;
+        Worklist.push_back(It->second);
+      }
+    }
+  };
+
+  // Collect the ids defined outside of functions, and the functions used
+  // there.
+  std::unordered_set<uint32_t> ModuleIds;
+  std::unordered_set<uint32_t> TypeIds;
+  for (size_t I = 0; I < M.Insts.size(); ++I) {
+    if (!M.isModuleLevel(I))
+      continue;
+    const Instruction &Inst = M.Insts[I];
+    // Decoration groups would need to be followed to the decorated ids.
+    if (Inst.Opcode == OpGroupDecorate || Inst.Opcode == OpGroupMemberDecorate)
+      return false;
+    bool IsType = false;
+    ResultPos Pos = getModuleLevelResultPos(Inst.Opcode, IsType);
+    if (Pos == ResultPos::Unknown)
+      return false;
+    const uint32_t *Ops = M.operands(Inst);
+    const uint32_t *OpsEnd = Ops + Inst.NumWords - 1;
+    if (Pos == ResultPos::Word1 && Inst.NumWords >= 2) {
+      ModuleIds.insert(Ops[0]);
+      if (IsType)
+        TypeIds.insert(Ops[0]);
+    } else if (Pos == ResultPos::Word2 && Inst.NumWords >= 3) {
+      ModuleIds.insert(Ops[1]);
+    }
+    // An annotation of a function doesn't keep it alive.
+    MarkReferenced(isAnnotation(Inst.Opcode) && Ops != OpsEnd ? Ops + 1 : Ops,
+                   OpsEnd);
+  }
+
+  std::unordered_set<std::string> RootNames(Roots.begin(), Roots.end());
+  for (const Export &E : M.getExports()) {
+    auto It = FunctionIdx.find(E.Target);
+    if (It != FunctionIdx.end() && RootNames.count(E.Name) &&
+        !Reachable[It->second]) {
+      Reachable[It->second] = true;
+      Worklist.push_back(It->second);
+    }
+  }
+
+  while (!Worklist.empty()) {
+    const Function &F = M.Functions[Worklist.back()];
+    Worklist.pop_back();
+    for (size_t I = F.BeginInst; I <= F.EndInst; ++I) {
+      const uint32_t *Ops = M.operands(M.Insts[I]);
+      MarkReferenced(Ops, Ops + M.Insts[I].NumWords - 1);
+    }
+  }
+
+  bool AllReachable = true;
+  for (bool R : Reachable)
+    AllReachable &= R;
+  if (AllReachable)
+    return true;
+
+  // The annotations of ids local to functions go away with the function. Such
+  // an id is found in the body of the function defining it, and any other
+  // function body it is found in holds it as a literal.
+  std::unordered_map<uint32_t, unsigned> LocalTargets;
+  for (size_t I = 0; I < M.Insts.size(); ++I) {
+    const Instruction &Inst = M.Insts[I];
+    if (!M.isModuleLevel(I) || !isAnnotation(Inst.Opcode) || Inst.NumWords < 2)
+      continue;
+    uint32_t Target = M.operands(Inst)[0];
+    if (!ModuleIds.count(Target) && !FunctionIdx.count(Target))
+      LocalTargets.emplace(Target, 0);
+  }
+
+  constexpr unsigned FoundInKept = 1, FoundInDropped = 2, DefinedInKept = 4,
+                     DefinedInDropped = 8;
+  if (!LocalTargets.empty())
+    for (size_t FI = 0; FI < M.Functions.size(); ++FI) {
+      const Function &F = M.Functions[FI];
+      for (size_t I = F.BeginInst; I <= F.EndInst; ++I) {
+        const Instruction &Inst = M.Insts[I];
+        const uint32_t *Ops = M.operands(Inst);
+        for (uint16_t Op = 0; Op + 1 < Inst.NumWords; ++Op) {
+          auto It = LocalTargets.find(Ops[Op]);
+          if (It == LocalTargets.end())
+            continue;
+          It->second |= Reachable[FI] ? FoundInKept : FoundInDropped;
+          // Instructions in function bodies have their result id either after
+          // the result type or, for labels, as the only operand.
+          bool Defines = (Op == 0 && Inst.Opcode == OpLabel) ||
+                         (Op == 1 && TypeIds.count(Ops[0]));
+          if (Defines)
+            It->second |= Reachable[FI] ? DefinedInKept : DefinedInDropped;
+        }
+      }
+    }
+
+  auto IsDroppedTarget = [&](uint32_t Target, bool &Ambiguous) {
+    auto FIt = FunctionIdx.find(Target);
+    if (FIt != FunctionIdx.end())
+      return !Reachable[FIt->second];
+    auto LIt = LocalTargets.find(Target);
+    if (LIt == LocalTargets.end())
+      return false;
+    unsigned Found = LIt->second;
+    if (!(Found & FoundInKept))
+      return (Found & FoundInDropped) != 0;
+    if (!(Found & FoundInDropped))
+      return false;
+    bool InKept = Found & DefinedInKept, InDropped = Found & DefinedInDropped;
+    Ambiguous = InKept == InDropped;
+    return InDropped;
+  };
+
+  std::vector<uint32_t> Pruned(M.Words.begin(),
+                               M.Words.begin() + SPIRVHeaderWords);
+  Pruned.reserve(M.Words.size());
+  size_t NextFunction = 0;
+  for (size_t I = 0; I < M.Insts.size(); ++I) {
+    if (NextFunction < M.Functions.size() &&
+        M.Functions[NextFunction].BeginInst == I) {
+      const Function &F = M.Functions[NextFunction++];
+      if (!Reachable[NextFunction - 1]) {
+        I = F.EndInst;
+        continue;
+      }
+    }
+    const Instruction &Inst = M.Insts[I];
+    if (M.isModuleLevel(I) && isAnnotation(Inst.Opcode) && Inst.NumWords >= 2) {
+      bool Ambiguous = false;
+      bool Dropped = IsDroppedTarget(M.operands(Inst)[0], Ambiguous);
+      if (Ambiguous)
+        return false;
+      if (Dropped)
+        continue;
+    }
+    Pruned.insert(Pruned.end(), M.Words.begin() + Inst.Offset,
+                  M.Words.begin() + Inst.Offset + Inst.NumWords);
+  }
+
+  Binary.resize(Pruned.size() * sizeof(uint32_t));
+  std::memcpy(Binary.data(), Pruned.data(), Binary.size());
+  return true;
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,41 @@
+//==------- spirv_pruning.hpp - Removal of unused SPIR-V functions ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// \return the names of the functions exported by a SPIR-V module, i.e. the
+/// targets of LinkageAttributes decorations with the Export linkage type. The
+/// result is empty if the module can't be parsed.
+std::vector<std::string>
+getSPIRVExportedFunctions(const std::vector<char> &Binary);
+
+/// Removes the functions of a SPIR-V module which can't be reached from the
+/// exported functions named in \p Roots, along with their debug names and
+/// decorations. Functions referenced by module-level instructions, e.g. entry
+/// points, are always kept. References are found by looking for function ids
+/// among all the operands, literals included, so more functions than needed
+/// may be kept but a function in use is never removed.
+///
+/// Types, constants and global variables are kept as is, the device compiler
+/// removes the unused ones.
+///
+/// \return false if the module can't be parsed or uses instructions which
+/// aren't handled, the binary is left unchanged then.
+bool pruneSPIRVFunctions(std::vector<char> &Binary,
+                         const std::vector<std::string> &Roots);
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -107,10 +107,14 @@ void stream_impl::flush(const EventImplPtr &LeadEvent) {
     // kernel will be a leaf for the flush buffer and scheduler will not be able
     // to cleanup the kernel. TODO: get rid of finalize method by using host
     // accessor to the flush buffer.
+    // The contents of the flush buffer aren't needed, so the accessor only
+    // covers one element: the copy to the host made for it follows the access
+    // range, and the whole buffer would otherwise be read back after every
+    // kernel.
     auto FlushBufHostAcc =
         FlushBuf_
             .get_access<access::mode::read_write, access::target::host_buffer>(
-                cgh);
+                cgh, range<1>(1), id<1>(0));
     cgh.host_task([=] {
       if (!BufHostAcc.empty()) {
         // SYCL 2020, 4.16:
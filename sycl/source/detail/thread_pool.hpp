@@ -11,8 +11,10 @@
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
@@ -22,46 +24,102 @@ namespace sycl {
 inline namespace _V1 {
 namespace detail {
 
+/// A pool of worker threads executing host tasks.
+///
+/// Every worker owns a job queue guarded by its own mutex, submissions are
+/// distributed over the queues in a round-robin manner and a worker that runs
+/// out of work steals jobs from the queues of the other workers. This keeps
+/// submitting threads and workers from serializing on a single queue mutex.
+/// The shared mutex and condition variable are only used to put idle workers
+/// to sleep and to wake them up, and are not touched by a submission while
+/// all the workers are busy.
 class ThreadPool {
+  struct WorkerQueue {
+    std::deque<std::function<void()>> MJobs;
+    std::mutex MMutex;
+  };
+
   std::vector<std::thread> MLaunchedThreads;
 
   size_t MThreadCount;
-  std::queue<std::function<void()>> MJobQueue;
-  std::mutex MJobQueueMutex;
+  std::unique_ptr<WorkerQueue[]> MWorkerQueues;
+  std::mutex MSleepMutex;
   std::condition_variable MDoSmthOrStop;
   std::atomic_bool MStop;
   std::atomic_uint MJobsInPool;
+  // Number of jobs sitting in the worker queues, i.e. not yet picked up.
+  std::atomic_uint MJobsQueued;
+  std::atomic_uint MSleepingWorkers;
+  std::atomic_size_t MNextQueueIdx;
+
+  // Takes a job from the worker's own queue or, if it is empty, steals one
+  // from the queue of another worker.
+  bool tryPopJob(size_t WorkerIdx, std::function<void()> &Job) {
+    for (size_t I = 0; I < MThreadCount; ++I) {
+      WorkerQueue &Queue = MWorkerQueues[(WorkerIdx + I) % MThreadCount];
+      std::lock_guard<std::mutex> Lock(Queue.MMutex);
+      if (Queue.MJobs.empty())
+        continue;
+      Job = std::move(Queue.MJobs.front());
+      Queue.MJobs.pop_front();
+      MJobsQueued--;
+      return true;
+    }
+    return false;
+  }
 
-  void worker() {
+  void worker(size_t WorkerIdx) {
     GlobalHandler::instance().registerSchedulerUsage(/*ModifyCounter*/ false);
-    std::unique_lock<std::mutex> Lock(MJobQueueMutex);
+    std::function<void()> Job;
     while (true) {
-      MDoSmthOrStop.wait(
-          Lock, [this]() { return !MJobQueue.empty() || MStop.load(); });
-
       if (MStop.load())
         break;
 
-      std::function<void()> Job = std::move(MJobQueue.front());
-      MJobQueue.pop();
-      Lock.unlock();
-
-      Job();
+      if (tryPopJob(WorkerIdx, Job)) {
+        Job();
+        Job = nullptr;
+        MJobsInPool--;
+        continue;
+      }
 
-      Lock.lock();
-
-      MJobsInPool--;
+      std::unique_lock<std::mutex> Lock(MSleepMutex);
+      MSleepingWorkers++;
+      MDoSmthOrStop.wait(
+          Lock, [this]() { return MJobsQueued.load() != 0 || MStop.load(); });
+      MSleepingWorkers--;
     }
   }
 
   void start() {
     MLaunchedThreads.reserve(MThreadCount);
+    MWorkerQueues.reset(new WorkerQueue[MThreadCount]);
 
     MStop.store(false);
     MJobsInPool.store(0);
+    MJobsQueued.store(0);
+    MSleepingWorkers.store(0);
+    MNextQueueIdx.store(0);
 
     for (size_t Idx = 0; Idx < MThreadCount; ++Idx)
-      MLaunchedThreads.emplace_back([this] { worker(); });
+      MLaunchedThreads.emplace_back([this, Idx] { worker(Idx); });
+  }
+
+  void pushJob(std::function<void()> &&Job) {
+    // Count the job before it becomes visible to the workers, so that drain()
+    // never misses it.
+    MJobsInPool++;
+    {
+      WorkerQueue &Queue = MWorkerQueues[MNextQueueIdx++ % MThreadCount];
+      std::lock_guard<std::mutex> Lock(Queue.MMutex);
+      Queue.MJobs.push_back(std::move(Job));
+      MJobsQueued++;
+    }
+    // A worker going to sleep registers itself before re-checking MJobsQueued
+    // under MSleepMutex, so either it sees the new job or we see it sleeping.
+    if (MSleepingWorkers.load() != 0) {
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
+      MDoSmthOrStop.notify_one();
+    }
   }
 
 public:
@@ -79,7 +137,10 @@ public:
   void finishAndWait() {
     MStop.store(true);
 
-    MDoSmthOrStop.notify_all();
+    {
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
+      MDoSmthOrStop.notify_all();
+    }
 
     for (std::thread &Thread : MLaunchedThreads)
       if (Thread.joinable())
@@ -87,22 +148,10 @@ public:
   }
 
   template <typename T> void submit(T &&Func) {
-    {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
-      MJobQueue.emplace([F = std::move(Func)]() { F(); });
-    }
-    MJobsInPool++;
-    MDoSmthOrStop.notify_one();
+    pushJob([F = std::move(Func)]() { F(); });
   }
 
-  void submit(std::function<void()> &&Func) {
-    {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
-      MJobQueue.emplace(Func);
-    }
-    MJobsInPool++;
-    MDoSmthOrStop.notify_one();
-  }
+  void submit(std::function<void()> &&Func) { pushJob(std::move(Func)); }
 };
 
 } // namespace detail
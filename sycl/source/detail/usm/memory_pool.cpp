@@ -0,0 +1,82 @@
+//==------------ memory_pool.cpp -------------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/ext/oneapi/experimental/memory_pool.hpp>
+
+#include <detail/event_impl.hpp>
+#include <detail/queue_impl.hpp>
+#include <detail/usm/memory_pool_impl.hpp>
+#include <sycl/queue.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+memory_pool::memory_pool(const context &SyclContext, const device &SyclDevice,
+                         usm::alloc Kind, size_t MaxCachedSize)
+    : impl(std::make_shared<sycl::detail::memory_pool_impl>(
+          sycl::detail::getSyclObjImpl(SyclContext),
+          sycl::detail::getSyclObjImpl(SyclDevice), Kind, MaxCachedSize)) {}
+
+memory_pool::memory_pool(const queue &SyclQueue, usm::alloc Kind,
+                         size_t MaxCachedSize)
+    : memory_pool(SyclQueue.get_context(), SyclQueue.get_device(), Kind,
+                  MaxCachedSize) {}
+
+void *memory_pool::malloc(size_t NumBytes) { return impl->allocate(NumBytes); }
+
+void memory_pool::free(void *Ptr) { impl->deallocate(Ptr); }
+
+// Returns the block to the pool once the commands submitted to the queue so
+// far are complete.
+static void deallocateOrdered(sycl::detail::memory_pool_impl &Pool, void *Ptr,
+                              const queue &SyclQueue) {
+  const auto &QueueImpl = sycl::detail::getSyclObjImpl(SyclQueue);
+  if (sycl::detail::EventImplPtr Event =
+          QueueImpl->getEventForSubmittedCommands(QueueImpl))
+    Pool.deallocate(Ptr, std::move(Event));
+  else
+    Pool.deallocate(Ptr);
+}
+
+void memory_pool::free(void *Ptr, queue &SyclQueue) {
+  deallocateOrdered(*impl, Ptr, SyclQueue);
+}
+
+void memory_pool::trim() { impl->trim(); }
+
+size_t memory_pool::get_used_size() const { return impl->getUsedSize(); }
+
+size_t memory_pool::get_cached_size() const { return impl->getCachedSize(); }
+
+context memory_pool::get_context() const {
+  return sycl::detail::createSyclObjFromImpl<context>(
+      impl->getContextImplPtr());
+}
+
+device memory_pool::get_device() const {
+  return sycl::detail::createSyclObjFromImpl<device>(impl->getDeviceImplPtr());
+}
+
+usm::alloc memory_pool::get_alloc_kind() const { return impl->getAllocKind(); }
+
+void *async_malloc(const queue &SyclQueue, size_t NumBytes) {
+  return sycl::detail::getSyclObjImpl(SyclQueue)
+      ->getDefaultMemoryPool()
+      .allocate(NumBytes);
+}
+
+void async_free(const queue &SyclQueue, void *Ptr) {
+  deallocateOrdered(
+      sycl::detail::getSyclObjImpl(SyclQueue)->getDefaultMemoryPool(), Ptr,
+      SyclQueue);
+}
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
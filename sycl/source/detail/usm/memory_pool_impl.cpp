@@ -0,0 +1,218 @@
+//==------------ memory_pool_impl.cpp - USM memory pool -------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/context_impl.hpp>
+#include <detail/device_impl.hpp>
+#include <detail/event_impl.hpp>
+#include <detail/usm/memory_pool_impl.hpp>
+#include <detail/usm/usm_impl.hpp>
+#include <sycl/exception.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+#include "xpti/xpti_trace_framework.hpp"
+#include <detail/xpti_registry.hpp>
+#endif
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+// Reports blocks allocated from or released to the backend together with the
+// statistics of the pool.
+static void notifyPoolBlockChange(const memory_pool_impl *Pool,
+                                  const char *Action, void *Ptr,
+                                  size_t BlockSize, size_t UsedSize,
+                                  size_t CachedSize) {
+  XPTIScope PrepareNotify((void *)Pool,
+                          (uint16_t)xpti::trace_point_type_t::node_create,
+                          SYCL_MEM_ALLOC_STREAM_NAME, Action);
+  PrepareNotify.addMetadata([&](auto TEvent) {
+    xpti::addMetadata(TEvent, "memory_ptr", reinterpret_cast<size_t>(Ptr));
+    xpti::addMetadata(TEvent, "memory_size", BlockSize);
+    xpti::addMetadata(TEvent, "memory_pool_used_size", UsedSize);
+    xpti::addMetadata(TEvent, "memory_pool_cached_size", CachedSize);
+  });
+  PrepareNotify.notify();
+}
+#endif
+
+memory_pool_impl::memory_pool_impl(ContextImplPtr Context,
+                                   DeviceImplPtr Device, sycl::usm::alloc Kind,
+                                   size_t MaxCachedSize)
+    : MContext(std::move(Context)), MDevice(std::move(Device)), MKind(Kind),
+      MMaxCachedSize(MaxCachedSize) {
+  if (MKind != sycl::usm::alloc::device && MKind != sycl::usm::alloc::shared)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "Memory pools only support device and shared USM "
+                          "allocations");
+}
+
+memory_pool_impl::~memory_pool_impl() {
+  try {
+    std::lock_guard<std::mutex> Lock{MMutex};
+    for (PendingBlock &Block : MPendingBlocks) {
+      Block.Event->wait(Block.Event);
+      releaseBlock(Block.Ptr, Block.BlockSize);
+    }
+    releaseCachedBlocks();
+    // The pool owns the memory allocated from it.
+    for (const auto &[Ptr, BlockSize] : MAllocatedBlocks)
+      releaseBlock(Ptr, BlockSize);
+  } catch (std::exception &E) {
+    std::cerr << "Exception caught in ~memory_pool_impl: " << E.what()
+              << std::endl;
+  }
+}
+
+size_t memory_pool_impl::getBlockSize(size_t Size) {
+  constexpr size_t MinBlockSize = 256;
+  if (Size <= MinBlockSize)
+    return MinBlockSize;
+  if (Size > std::numeric_limits<size_t>::max() / 2)
+    return Size;
+
+  // Four block sizes per power of two keep the unused part of a block under
+  // a quarter of it.
+  size_t PowerOfTwo = MinBlockSize;
+  while (PowerOfTwo * 2 < Size)
+    PowerOfTwo *= 2;
+  const size_t Step = PowerOfTwo / 4;
+  return (Size + Step - 1) / Step * Step;
+}
+
+void *memory_pool_impl::allocate(size_t Size) {
+  if (Size == 0)
+    return nullptr;
+  const size_t BlockSize = getBlockSize(Size);
+
+  std::lock_guard<std::mutex> Lock{MMutex};
+  auto TakeFreeBlock = [&]() -> void * {
+    auto It = MFreeBlocks.find(BlockSize);
+    if (It == MFreeBlocks.end() || It->second.empty())
+      return nullptr;
+    void *Ptr = It->second.back();
+    It->second.pop_back();
+    MCachedSize -= BlockSize;
+    return Ptr;
+  };
+
+  void *Ptr = TakeFreeBlock();
+  if (!Ptr && !MPendingBlocks.empty()) {
+    reclaimPendingBlocks();
+    Ptr = TakeFreeBlock();
+  }
+  if (!Ptr) {
+    Ptr = usm::alignedAllocInternal(/*Alignment=*/0, BlockSize, MContext.get(),
+                                    MDevice.get(), MKind);
+    // The cached blocks may be what exhausts the device memory.
+    if (!Ptr && MCachedSize != 0) {
+      releaseCachedBlocks();
+      Ptr = usm::alignedAllocInternal(/*Alignment=*/0, BlockSize,
+                                      MContext.get(), MDevice.get(), MKind);
+    }
+    if (!Ptr)
+      return nullptr;
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+    notifyPoolBlockChange(this, "memory_pool.allocate", Ptr, BlockSize,
+                          MUsedSize + BlockSize, MCachedSize);
+#endif
+  }
+
+  MAllocatedBlocks.emplace(Ptr, BlockSize);
+  MUsedSize += BlockSize;
+  return Ptr;
+}
+
+void memory_pool_impl::deallocate(void *Ptr) {
+  if (!Ptr)
+    return;
+  std::lock_guard<std::mutex> Lock{MMutex};
+  cacheBlock(Ptr, takeAllocatedBlock(Ptr));
+}
+
+void memory_pool_impl::deallocate(void *Ptr, EventImplPtr Event) {
+  if (!Ptr)
+    return;
+  std::lock_guard<std::mutex> Lock{MMutex};
+  const size_t BlockSize = takeAllocatedBlock(Ptr);
+  MPendingBlocks.push_back({Ptr, BlockSize, std::move(Event)});
+}
+
+void memory_pool_impl::trim() {
+  std::lock_guard<std::mutex> Lock{MMutex};
+  reclaimPendingBlocks();
+  releaseCachedBlocks();
+}
+
+size_t memory_pool_impl::getUsedSize() const {
+  std::lock_guard<std::mutex> Lock{MMutex};
+  return MUsedSize;
+}
+
+size_t memory_pool_impl::getCachedSize() const {
+  std::lock_guard<std::mutex> Lock{MMutex};
+  return MCachedSize;
+}
+
+size_t memory_pool_impl::takeAllocatedBlock(void *Ptr) {
+  auto It = MAllocatedBlocks.find(Ptr);
+  if (It == MAllocatedBlocks.end())
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "Pointer was not allocated from this memory pool");
+  const size_t BlockSize = It->second;
+  MAllocatedBlocks.erase(It);
+  MUsedSize -= BlockSize;
+  return BlockSize;
+}
+
+void memory_pool_impl::cacheBlock(void *Ptr, size_t BlockSize) {
+  if (MCachedSize + BlockSize > MMaxCachedSize) {
+    releaseBlock(Ptr, BlockSize);
+    return;
+  }
+  MFreeBlocks[BlockSize].push_back(Ptr);
+  MCachedSize += BlockSize;
+}
+
+void memory_pool_impl::reclaimPendingBlocks() {
+  auto NotCompleted = [](const PendingBlock &Block) {
+    return !Block.Event->isCompleted();
+  };
+  auto FirstCompleted = std::stable_partition(
+      MPendingBlocks.begin(), MPendingBlocks.end(), NotCompleted);
+  for (auto It = FirstCompleted; It != MPendingBlocks.end(); ++It)
+    cacheBlock(It->Ptr, It->BlockSize);
+  MPendingBlocks.erase(FirstCompleted, MPendingBlocks.end());
+}
+
+void memory_pool_impl::releaseCachedBlocks() {
+  for (auto &[BlockSize, Blocks] : MFreeBlocks)
+    for (void *Ptr : Blocks)
+      releaseBlock(Ptr, BlockSize);
+  MFreeBlocks.clear();
+  MCachedSize = 0;
+}
+
+void memory_pool_impl::releaseBlock(void *Ptr, size_t BlockSize) {
+  usm::freeInternal(Ptr, MContext.get());
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  notifyPoolBlockChange(this, "memory_pool.release", Ptr, BlockSize, MUsedSize,
+                        MCachedSize);
+#else
+  (void)BlockSize;
+#endif
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,106 @@
+//==------------ memory_pool_impl.hpp - USM memory pool -------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/usm.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class context_impl;
+class device_impl;
+class event_impl;
+using ContextImplPtr = std::shared_ptr<context_impl>;
+using DeviceImplPtr = std::shared_ptr<device_impl>;
+using EventImplPtr = std::shared_ptr<event_impl>;
+
+/// Caches USM blocks of one kind of one device of a context. Freed blocks
+/// are kept in free lists per block size, up to a limit on the total size of
+/// the cached memory.
+class memory_pool_impl {
+public:
+  memory_pool_impl(ContextImplPtr Context, DeviceImplPtr Device,
+                   sycl::usm::alloc Kind, size_t MaxCachedSize);
+
+  ~memory_pool_impl();
+
+  memory_pool_impl(const memory_pool_impl &) = delete;
+  memory_pool_impl &operator=(const memory_pool_impl &) = delete;
+
+  void *allocate(size_t Size);
+
+  /// Returns the block to the pool right away.
+  void deallocate(void *Ptr);
+
+  /// Returns the block to the pool once the event is complete.
+  void deallocate(void *Ptr, EventImplPtr Event);
+
+  /// Releases all cached blocks.
+  void trim();
+
+  size_t getUsedSize() const;
+
+  size_t getCachedSize() const;
+
+  const ContextImplPtr &getContextImplPtr() const { return MContext; }
+
+  const DeviceImplPtr &getDeviceImplPtr() const { return MDevice; }
+
+  sycl::usm::alloc getAllocKind() const { return MKind; }
+
+  /// \return the size of the block used for an allocation of the size.
+  static size_t getBlockSize(size_t Size);
+
+private:
+  /// Removes the block of the pointer from the allocated blocks.
+  /// \return the size of the block.
+  size_t takeAllocatedBlock(void *Ptr);
+
+  /// Puts a block to its free list, or releases it if the cache is full.
+  void cacheBlock(void *Ptr, size_t BlockSize);
+
+  /// Caches the blocks whose pending events are complete.
+  void reclaimPendingBlocks();
+
+  void releaseCachedBlocks();
+
+  void releaseBlock(void *Ptr, size_t BlockSize);
+
+  struct PendingBlock {
+    void *Ptr;
+    size_t BlockSize;
+    EventImplPtr Event;
+  };
+
+  const ContextImplPtr MContext;
+  const DeviceImplPtr MDevice;
+  const sycl::usm::alloc MKind;
+  const size_t MMaxCachedSize;
+
+  /// Protects all the fields below.
+  mutable std::mutex MMutex;
+
+  std::unordered_map<size_t, std::vector<void *>> MFreeBlocks;
+  std::unordered_map<void *, size_t> MAllocatedBlocks;
+  std::vector<PendingBlock> MPendingBlocks;
+  size_t MCachedSize = 0;
+  size_t MUsedSize = 0;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
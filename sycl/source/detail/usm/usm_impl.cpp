@@ -121,8 +121,8 @@ void *alignedAllocHost(size_t Alignment, size_t Size, const context &Ctxt,
       return nullptr;
   }
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  xpti::addMetadata(PrepareNotify.traceEvent(), "memory_ptr",
-                    reinterpret_cast<size_t>(RetVal));
+  if (xpti::trace_event_data_t *TEvent = PrepareNotify.traceEvent())
+    xpti::addMetadata(TEvent, "memory_ptr", reinterpret_cast<size_t>(RetVal));
 #endif
   return RetVal;
 }
@@ -256,8 +256,8 @@ void *alignedAlloc(size_t Alignment, size_t Size, const context &Ctxt,
       alignedAllocInternal(Alignment, Size, getSyclObjImpl(Ctxt).get(),
                            getSyclObjImpl(Dev).get(), Kind, PropList);
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  xpti::addMetadata(PrepareNotify.traceEvent(), "memory_ptr",
-                    reinterpret_cast<size_t>(RetVal));
+  if (xpti::trace_event_data_t *TEvent = PrepareNotify.traceEvent())
+    xpti::addMetadata(TEvent, "memory_ptr", reinterpret_cast<size_t>(RetVal));
 #endif
   return RetVal;
 }
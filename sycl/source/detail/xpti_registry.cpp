@@ -6,17 +6,42 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/config.hpp>
 #include <detail/global_handler.hpp>
 #include <detail/xpti_registry.hpp>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
 #include "xpti/xpti_trace_framework.hpp"
+#include <atomic>
 #include <sstream>
 #endif
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
+// The number of submissions the submitting thread is nested in and whether
+// the outermost of them is traced.
+static thread_local size_t GSubmissionDepth = 0;
+static thread_local bool GSubmissionSampled = true;
+
+XPTISubmissionSample::XPTISubmissionSample() {
+  if (GSubmissionDepth++ != 0)
+    return;
+  const size_t Rate = SYCLConfig<SYCL_XPTI_SAMPLING_RATE>::get();
+  if (Rate == 1)
+    return;
+  static std::atomic<size_t> NumSubmissions{0};
+  GSubmissionSampled =
+      NumSubmissions.fetch_add(1, std::memory_order_relaxed) % Rate == 0;
+}
+
+XPTISubmissionSample::~XPTISubmissionSample() {
+  if (--GSubmissionDepth == 0)
+    GSubmissionSampled = true;
+}
+
+bool XPTISubmissionSample::isSampled() { return GSubmissionSampled; }
+
 xpti::trace_event_data_t *XPTIRegistry::createTraceEvent(
     const void *Obj, const void *FuncPtr, uint64_t &IId,
     const detail::code_location &CodeLoc, uint16_t TraceEventType) {
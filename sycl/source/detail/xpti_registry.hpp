@@ -158,6 +158,24 @@ private:
 #endif // XPTI_ENABLE_INSTRUMENTATION
 };
 
+#if XPTI_ENABLE_INSTRUMENTATION
+/// Decides whether a submission to a queue is traced when
+/// SYCL_XPTI_SAMPLING_RATE limits tracing to one in N submissions. The
+/// decision covers all the trace points reached by the submitting thread
+/// while the object is alive, nested submissions follow the outermost one.
+class XPTISubmissionSample {
+public:
+  XPTISubmissionSample();
+  ~XPTISubmissionSample();
+
+  XPTISubmissionSample(const XPTISubmissionSample &) = delete;
+  XPTISubmissionSample &operator=(const XPTISubmissionSample &) = delete;
+
+  /// \return false if the current submission of this thread isn't traced.
+  static bool isSampled();
+};
+#endif
+
 /// @brief Helper class to enable XPTI implementation
 /// @details This class simplifies the instrumentation and encapsulates the
 /// verbose call sequences
@@ -176,6 +194,13 @@ public:
             const char *UserData)
       : MUserData(UserData), MStreamID(0), MInstanceID(0), MScopedNotify(false),
         MTraceType(0) {
+    // Don't query the code location or build a payload if nobody listens to
+    // the stream.
+    if (!xptiTraceEnabled() || !XPTISubmissionSample::isSampled())
+      return;
+    MStreamID = xptiRegisterStream(StreamName);
+    if (!xptiCheckTraceEnabled(MStreamID))
+      return;
     detail::tls_code_loc_t Tls;
     auto TData = Tls.query();
     // If TLS is not set, we can still genertate universal IDs with user data
@@ -190,8 +215,8 @@ public:
         MTraceType == (uint16_t)xpti::trace_point_type_t::node_create ||
         MTraceType == (uint16_t)xpti::trace_point_type_t::edge_create)
       MTP->parent_event(GSYCLGraphEvent);
-    // Now if tracing is enabled, create trace events and notify
-    if (xptiTraceEnabled() && MTP) {
+    // Create the trace events to notify
+    if (MTP) {
       MTP->stream(StreamName).trace_type((xpti::trace_point_type_t)TraceType);
       MTraceEvent = const_cast<xpti::trace_event_data_t *>(MTP->trace_event());
       MStreamID = MTP->stream_id();
@@ -209,7 +234,7 @@ public:
 
   XPTIScope &
   addMetadata(const std::function<void(xpti::trace_event_data_t *)> &Callback) {
-    if (xptiTraceEnabled() && MTP) {
+    if (MTP) {
       auto TEvent = const_cast<xpti::trace_event_data_t *>(MTP->trace_event());
       Callback(TEvent);
     }
@@ -217,7 +242,8 @@ public:
   }
 
   XPTIScope &notify() {
-    MTP->notify(static_cast<const void *>(MUserData));
+    if (MTP)
+      MTP->notify(static_cast<const void *>(MUserData));
     return *this;
   }
 
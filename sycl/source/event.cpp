@@ -23,7 +23,7 @@
 namespace sycl {
 inline namespace _V1 {
 
-event::event() : impl(std::make_shared<detail::event_impl>(std::nullopt)) {}
+event::event() : impl(detail::createEventImpl(std::nullopt)) {}
 
 event::event(cl_event ClEvent, const context &SyclContext)
     : impl(std::make_shared<detail::event_impl>(
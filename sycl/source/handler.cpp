@@ -15,7 +15,9 @@
 #include <detail/image_impl.hpp>
 #include <detail/kernel_bundle_impl.hpp>
 #include <detail/kernel_impl.hpp>
+#include <detail/memory_manager.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/recycling_allocator.hpp>
 #include <detail/scheduler/commands.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/usm/usm_impl.hpp>
@@ -78,8 +80,9 @@ handler::handler(std::shared_ptr<detail::queue_impl> Queue,
                  std::shared_ptr<detail::queue_impl> PrimaryQueue,
                  std::shared_ptr<detail::queue_impl> SecondaryQueue,
                  bool IsHost)
-    : MImpl(std::make_shared<detail::handler_impl>(std::move(PrimaryQueue),
-                                                   std::move(SecondaryQueue))),
+    : MImpl(std::allocate_shared<detail::handler_impl>(
+          detail::RecyclingAllocator<detail::handler_impl>{},
+          std::move(PrimaryQueue), std::move(SecondaryQueue))),
       MQueue(std::move(Queue)), MIsHost(IsHost) {}
 
 handler::handler(
@@ -170,6 +173,31 @@ event handler::finalize() {
     }
   }
 
+  // Dependencies on events which are already backed by native events of the
+  // same context can be handed to the backend directly, so they don't require
+  // the dependency graph either. The host queue and the ESIMD emulator handle
+  // its kernels synchronously and don't accept a wait list.
+  auto DepEventsAreSafeForBypass = [&]() {
+    if (CGData.MEvents.empty())
+      return true;
+    if (MQueue->is_host() || MQueue->getDeviceImplPtr()->getBackend() ==
+                                 backend::ext_intel_esimd_emulator)
+      return false;
+    return detail::Scheduler::areEventsSafeForSchedulerBypass(
+        CGData.MEvents, MQueue->getContextImplPtr());
+  };
+
+  // If user does not add a new dependency to the dependency graph, i.e. the
+  // graph is not changed, and the queue is not in fusion mode, then the
+  // command can be submitted bypassing the scheduler, avoiding CommandGroup
+  // and Command objects creation.
+  auto CanBypassScheduler = [&]() {
+    return MQueue && !MGraph && !MSubgraphNode && !MQueue->getCommandGraph() &&
+           !MQueue->is_in_fusion_mode() &&
+           CGData.MRequirements.size() + MStreamStorage.size() == 0 &&
+           DepEventsAreSafeForBypass();
+  };
+
   const auto &type = getType();
   if (type == detail::CG::Kernel) {
     // If there were uses of set_specialization_constant build the kernel_bundle
@@ -223,17 +251,14 @@ event handler::finalize() {
       }
     }
 
-    if (MQueue && !MGraph && !MSubgraphNode && !MQueue->getCommandGraph() &&
-        !MQueue->is_in_fusion_mode() &&
-        CGData.MRequirements.size() + CGData.MEvents.size() +
-                MStreamStorage.size() ==
-            0) {
-      // if user does not add a new dependency to the dependency graph, i.e.
-      // the graph is not changed, and the queue is not in fusion mode, then
-      // this faster path is used to submit kernel bypassing scheduler and
-      // avoiding CommandGroup, Command objects creation.
-
-      std::vector<sycl::detail::pi::PiEvent> RawEvents;
+    if (CanBypassScheduler()) {
+      std::vector<sycl::detail::pi::PiEvent> RawEvents =
+          detail::Command::getPiEvents(CGData.MEvents, MQueue,
+                                       /*IsHostTaskCommand=*/false);
+      // Make sure that the commands producing the dependencies are submitted
+      // to the device, otherwise the kernel may wait on them forever.
+      for (const detail::EventImplPtr &DepEvent : CGData.MEvents)
+        DepEvent->flushIfNeeded(MQueue);
       detail::EventImplPtr NewEvent;
 
       auto EnqueueKernel = [&]() {
@@ -284,7 +309,7 @@ event handler::finalize() {
           throw runtime_error("Enqueue process failed.",
                               PI_ERROR_INVALID_OPERATION);
       } else {
-        NewEvent = std::make_shared<detail::event_impl>(MQueue);
+        NewEvent = detail::createEventImpl(MQueue);
         NewEvent->setContextImpl(MQueue->getContextImplPtr());
         NewEvent->setStateIncomplete();
         NewEvent->setSubmissionTime();
@@ -301,6 +326,64 @@ event handler::finalize() {
     }
   }
 
+  // USM operations only synchronize through events, the same fast path is
+  // used for them. This way in-order queues only using USM never involve the
+  // scheduler.
+  if ((type == detail::CG::CopyUSM || type == detail::CG::FillUSM ||
+       type == detail::CG::PrefetchUSM || type == detail::CG::AdviseUSM) &&
+      CanBypassScheduler()) {
+    std::vector<sycl::detail::pi::PiEvent> RawEvents =
+        detail::Command::getPiEvents(CGData.MEvents, MQueue,
+                                     /*IsHostTaskCommand=*/false);
+    for (const detail::EventImplPtr &DepEvent : CGData.MEvents)
+      DepEvent->flushIfNeeded(MQueue);
+
+    auto EnqueueUSMCommand = [&](sycl::detail::pi::PiEvent *OutEvent,
+                                 const detail::EventImplPtr &OutEventImpl) {
+      switch (type) {
+      case detail::CG::CopyUSM:
+        detail::MemoryManager::copy_usm(MSrcPtr, MQueue, MLength, MDstPtr,
+                                        std::move(RawEvents), OutEvent,
+                                        OutEventImpl);
+        break;
+      case detail::CG::FillUSM:
+        detail::MemoryManager::fill_usm(MDstPtr, MQueue, MLength, MPattern[0],
+                                        std::move(RawEvents), OutEvent,
+                                        OutEventImpl);
+        break;
+      case detail::CG::PrefetchUSM:
+        detail::MemoryManager::prefetch_usm(MDstPtr, MQueue, MLength,
+                                            std::move(RawEvents), OutEvent,
+                                            OutEventImpl);
+        break;
+      default:
+        detail::MemoryManager::advise_usm(MDstPtr, MQueue, MLength,
+                                          MImpl->MAdvice, std::move(RawEvents),
+                                          OutEvent, OutEventImpl);
+        break;
+      }
+    };
+
+    // Emit the trace points the command would have emitted in the graph.
+    detail::BypassedCGInstrumentation Instrumentation{type, MCodeLoc, MQueue};
+    Instrumentation.emitTaskBegin();
+    if (MQueue->has_discard_events_support()) {
+      EnqueueUSMCommand(nullptr, nullptr);
+      Instrumentation.emitTaskEnd(nullptr);
+    } else {
+      detail::EventImplPtr NewEvent = detail::createEventImpl(MQueue);
+      NewEvent->setContextImpl(MQueue->getContextImplPtr());
+      NewEvent->setStateIncomplete();
+      NewEvent->setSubmissionTime();
+      EnqueueUSMCommand(&NewEvent->getHandleRef(), NewEvent);
+      Instrumentation.emitTaskEnd(NewEvent->getHandleRef());
+      if (NewEvent->is_host() || NewEvent->getHandleRef() == nullptr)
+        NewEvent->setComplete();
+      MLastEvent = detail::createSyclObjFromImpl<event>(NewEvent);
+    }
+    return MLastEvent;
+  }
+
   std::unique_ptr<detail::CG> CommandGroup;
   switch (type) {
   case detail::CG::Kernel: {
@@ -445,14 +528,13 @@ event handler::finalize() {
   // so it can be retrieved by the graph later.
   if (MGraph) {
     MGraphNodeCG = std::move(CommandGroup);
-    return detail::createSyclObjFromImpl<event>(
-        std::make_shared<detail::event_impl>());
+    return detail::createSyclObjFromImpl<event>(detail::createEventImpl());
   }
 
   // If the queue has an associated graph then we need to take the CG and pass
   // it to the graph to create a node, rather than submit it to the scheduler.
   if (auto GraphImpl = MQueue->getCommandGraph(); GraphImpl) {
-    auto EventImpl = std::make_shared<detail::event_impl>();
+    auto EventImpl = detail::createEventImpl();
     std::shared_ptr<ext::oneapi::experimental::detail::node_impl> NodeImpl =
         nullptr;
 
@@ -833,6 +915,16 @@ void handler::GetRangeRoundingSettings(size_t &MinFactor, size_t &GoodFactor,
       MinFactor, GoodFactor, MinRange);
 }
 
+void handler::GetRangeRoundingSettings(size_t Range, size_t &MinFactor,
+                                       size_t &GoodFactor, size_t &MinRange) {
+  if (SYCLConfig<SYCL_PARALLEL_FOR_RANGE_ROUNDING_PARAMS>::GetSettings(
+          MinFactor, GoodFactor, MinRange) ||
+      !MQueue || MQueue->is_host())
+    return;
+  GoodFactor =
+      MQueue->getDeviceImplPtr()->getRangeRoundingFactor(Range, GoodFactor);
+}
+
 void handler::memcpy(void *Dest, const void *Src, size_t Count) {
   throwIfActionIsCreated();
   MSrcPtr = const_cast<void *>(Src);
@@ -346,5 +346,30 @@ bool is_compatible(const std::vector<kernel_id> &KernelIDs, const device &Dev) {
   return true;
 }
 
+namespace ext::oneapi::experimental {
+
+void prebuild_kernels(const context &Ctx) {
+  detail::ProgramManager::getInstance().prebuildKernels(getSyclObjImpl(Ctx),
+                                                        {});
+}
+
+void prebuild_kernels(const context &Ctx,
+                      const std::vector<kernel_id> &KernelIDs) {
+  if (KernelIDs.empty())
+    return;
+  detail::ProgramManager::getInstance().prebuildKernels(getSyclObjImpl(Ctx),
+                                                        KernelIDs);
+}
+
+void prebuild_kernels(
+    const std::vector<kernel_bundle<bundle_state::input>> &Bundles) {
+  std::vector<device_image_plain> DeviceImages;
+  for (const kernel_bundle<bundle_state::input> &Bundle : Bundles)
+    DeviceImages.insert(DeviceImages.end(), Bundle.begin(), Bundle.end());
+  detail::ProgramManager::getInstance().prebuildDeviceImages(DeviceImages);
+}
+
+} // namespace ext::oneapi::experimental
+
 } // namespace _V1
 } // namespace sycl
@@ -156,9 +156,7 @@ event queue::mem_advise(const void *Ptr, size_t Length, int Advice,
 event queue::discard_or_return(const event &Event) {
   if (!(impl->MDiscardEvents))
     return Event;
-  using detail::event_impl;
-  auto Impl = std::make_shared<event_impl>(event_impl::HES_Discarded);
-  return detail::createSyclObjFromImpl<event>(Impl);
+  return detail::createSyclObjFromImpl<event>(detail::getDiscardedEventImpl());
 }
 
 event queue::submit_impl(std::function<void(handler &)> CGH,
@@ -184,6 +182,13 @@ event queue::submit_impl_and_postprocess(
   return impl->submit(CGH, impl, SecondQueue.impl, CodeLoc, &PostProcess);
 }
 
+event queue::submit_batch_impl(
+    const std::vector<std::function<void(handler &)>> &CGFs,
+    const detail::code_location &CodeLoc,
+    const SubmitPostProcessF *PostProcess) {
+  return impl->submitBatch(CGFs, impl, CodeLoc, PostProcess);
+}
+
 void queue::wait_proxy(const detail::code_location &CodeLoc) {
   impl->wait(CodeLoc);
 }
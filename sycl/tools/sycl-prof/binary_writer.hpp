@@ -0,0 +1,305 @@
+//==----------------- binary_writer.hpp ------------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// The binary trace starts with the magic and the version, followed by chunks.
+// Each chunk is a one byte kind and a 32-bit size:
+//  * a string chunk holds Size bytes of a string, strings get consecutive IDs
+//    starting from zero;
+//  * an events chunk holds Size BinaryEventRecord entries, which only refer
+//    to strings of earlier chunks.
+// Values are stored in the native byte order, the trace is meant to be
+// converted on the machine it was recorded on.
+constexpr char BinaryTraceMagic[8] = {'S', 'Y', 'C', 'L', 'P', 'R', 'O', 'F'};
+constexpr uint32_t BinaryTraceVersion = 1;
+
+enum class BinaryChunkKind : uint8_t { String = 1, Events = 2 };
+
+enum class BinaryEventKind : uint8_t { Begin = 0, End = 1 };
+
+struct BinaryEventRecord {
+  uint64_t TimeStamp;
+  uint64_t PID;
+  uint64_t TID;
+  uint32_t NameID;
+  uint32_t CategoryID;
+  BinaryEventKind Kind;
+};
+
+/// Keeps events in per-thread ring buffers, which a background thread drains
+/// into a binary trace. Recording an event only takes a lock the first time a
+/// thread sees a name, so the traced application is barely slowed down.
+class BinaryWriter : public Writer {
+public:
+  explicit BinaryWriter(const std::string &OutPath)
+      : MOutFile(OutPath, std::ios::binary) {}
+
+  void init() final {
+    if (!MOutFile.is_open())
+      return;
+
+    MOutFile.write(BinaryTraceMagic, sizeof(BinaryTraceMagic));
+    writeValue(BinaryTraceVersion);
+    MFlushThread = std::thread([this] { flushLoop(); });
+  }
+
+  void writeBegin(std::string_view Name, std::string_view Category, size_t PID,
+                  size_t TID, size_t TimeStamp) override {
+    record(BinaryEventKind::Begin, Name, Category, PID, TID, TimeStamp);
+  }
+
+  void writeEnd(std::string_view Name, std::string_view Category, size_t PID,
+                size_t TID, size_t TimeStamp) override {
+    record(BinaryEventKind::End, Name, Category, PID, TID, TimeStamp);
+  }
+
+  void finalize() final {
+    {
+      std::lock_guard<std::mutex> _{MFlushMutex};
+      if (MStop.exchange(true))
+        return;
+    }
+    MFlushCV.notify_one();
+    if (MFlushThread.joinable())
+      MFlushThread.join();
+
+    if (!MOutFile.is_open())
+      return;
+
+    flush();
+    MOutFile.close();
+  }
+
+  ~BinaryWriter() { finalize(); }
+
+private:
+  /// A single producer single consumer queue of the events of one thread.
+  struct ThreadBuffer {
+    static constexpr size_t Capacity = size_t{1} << 14;
+
+    std::array<BinaryEventRecord, Capacity> Records;
+    /// The number of records written by the thread.
+    std::atomic<size_t> Head{0};
+    /// The number of records flushed by the background thread.
+    std::atomic<size_t> Tail{0};
+    /// IDs of the strings the thread has seen, only used by the thread.
+    std::unordered_map<std::string_view, uint32_t> StringIDs;
+  };
+
+  template <typename T> void writeValue(const T &Value) {
+    MOutFile.write(reinterpret_cast<const char *>(&Value), sizeof(T));
+  }
+
+  void writeChunkHeader(BinaryChunkKind Kind, uint32_t Size) {
+    writeValue(Kind);
+    writeValue(Size);
+  }
+
+  ThreadBuffer &getThreadBuffer() {
+    // There is only one writer per process.
+    thread_local ThreadBuffer *TLBuffer = nullptr;
+    if (TLBuffer)
+      return *TLBuffer;
+
+    // Buffers are owned by the writer, so that the events of finished threads
+    // are still flushed.
+    auto Buffer = std::make_unique<ThreadBuffer>();
+    TLBuffer = Buffer.get();
+    std::lock_guard<std::mutex> _{MBuffersMutex};
+    MBuffers.push_back(std::move(Buffer));
+    return *TLBuffer;
+  }
+
+  uint32_t getStringID(ThreadBuffer &Buffer, std::string_view Str) {
+    auto It = Buffer.StringIDs.find(Str);
+    if (It != Buffer.StringIDs.end())
+      return It->second;
+
+    std::lock_guard<std::mutex> _{MStringsMutex};
+    auto GlobalIt = MStringIDs.find(Str);
+    if (GlobalIt == MStringIDs.end()) {
+      const std::string &Stored = MStrings.emplace_back(Str);
+      GlobalIt =
+          MStringIDs.emplace(Stored, static_cast<uint32_t>(MStrings.size() - 1))
+              .first;
+    }
+    // Keys point to the strings owned by the writer, names passed by the
+    // callbacks may be temporary.
+    Buffer.StringIDs.emplace(GlobalIt->first, GlobalIt->second);
+    return GlobalIt->second;
+  }
+
+  void record(BinaryEventKind Kind, std::string_view Name,
+              std::string_view Category, size_t PID, size_t TID,
+              size_t TimeStamp) {
+    if (MStop.load(std::memory_order_relaxed))
+      return;
+
+    ThreadBuffer &Buffer = getThreadBuffer();
+    BinaryEventRecord Record{TimeStamp,
+                             PID,
+                             TID,
+                             getStringID(Buffer, Name),
+                             getStringID(Buffer, Category),
+                             Kind};
+
+    const size_t Head = Buffer.Head.load(std::memory_order_relaxed);
+    // The time stamp is already taken, so waiting for the background thread
+    // doesn't affect the recorded timings. Dropping the event would leave
+    // unmatched begin and end events in the trace instead.
+    while (Head - Buffer.Tail.load(std::memory_order_acquire) ==
+           ThreadBuffer::Capacity) {
+      if (MStop.load(std::memory_order_relaxed))
+        return;
+      MFlushCV.notify_one();
+      std::this_thread::yield();
+    }
+    Buffer.Records[Head % ThreadBuffer::Capacity] = Record;
+    Buffer.Head.store(Head + 1, std::memory_order_release);
+  }
+
+  void flushLoop() {
+    std::unique_lock<std::mutex> Lock{MFlushMutex};
+    while (!MStop) {
+      MFlushCV.wait_for(Lock, std::chrono::milliseconds(10));
+      Lock.unlock();
+      flush();
+      Lock.lock();
+    }
+  }
+
+  /// Writes the new strings and events to the file. Only called by the
+  /// background thread, or by finalize() once the thread is joined.
+  void flush() {
+    std::vector<std::pair<ThreadBuffer *, size_t>> Heads;
+    {
+      std::lock_guard<std::mutex> _{MBuffersMutex};
+      for (auto &Buffer : MBuffers)
+        Heads.emplace_back(Buffer.get(),
+                           Buffer->Head.load(std::memory_order_acquire));
+    }
+
+    // Strings of the events read above were added before the events, so they
+    // get written before them.
+    {
+      std::lock_guard<std::mutex> _{MStringsMutex};
+      for (; MFlushedStrings < MStrings.size(); ++MFlushedStrings) {
+        const std::string &Str = MStrings[MFlushedStrings];
+        writeChunkHeader(BinaryChunkKind::String,
+                         static_cast<uint32_t>(Str.size()));
+        MOutFile.write(Str.data(), Str.size());
+      }
+    }
+
+    for (auto [Buffer, Head] : Heads) {
+      size_t Tail = Buffer->Tail.load(std::memory_order_relaxed);
+      if (Tail == Head)
+        continue;
+      writeChunkHeader(BinaryChunkKind::Events,
+                       static_cast<uint32_t>(Head - Tail));
+      while (Tail != Head) {
+        // Write the records up to the end of the ring at once.
+        const size_t Begin = Tail % ThreadBuffer::Capacity;
+        const size_t Count =
+            std::min(Head - Tail, ThreadBuffer::Capacity - Begin);
+        MOutFile.write(
+            reinterpret_cast<const char *>(&Buffer->Records[Begin]),
+            Count * sizeof(BinaryEventRecord));
+        Tail += Count;
+      }
+      Buffer->Tail.store(Tail, std::memory_order_release);
+    }
+    MOutFile.flush();
+  }
+
+  std::ofstream MOutFile;
+
+  std::mutex MBuffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> MBuffers;
+
+  std::mutex MStringsMutex;
+  std::deque<std::string> MStrings;
+  std::unordered_map<std::string_view, uint32_t> MStringIDs;
+  /// The number of strings already written, only used by flush().
+  size_t MFlushedStrings = 0;
+
+  std::mutex MFlushMutex;
+  std::condition_variable MFlushCV;
+  std::atomic<bool> MStop{false};
+  std::thread MFlushThread;
+};
+
+/// Replays the events of a binary trace written by BinaryWriter into another
+/// writer.
+///
+/// \return false if the trace can't be read or is malformed.
+inline bool convertBinaryTrace(const std::string &InPath, Writer &Out) {
+  std::ifstream In(InPath, std::ios::binary);
+  auto ReadValue = [&In](auto &Value) {
+    return static_cast<bool>(
+        In.read(reinterpret_cast<char *>(&Value), sizeof(Value)));
+  };
+
+  char Magic[sizeof(BinaryTraceMagic)];
+  uint32_t Version = 0;
+  if (!In.read(Magic, sizeof(Magic)) ||
+      std::memcmp(Magic, BinaryTraceMagic, sizeof(Magic)) != 0 ||
+      !ReadValue(Version) || Version != BinaryTraceVersion)
+    return false;
+
+  std::vector<std::string> Strings;
+  Out.init();
+  BinaryChunkKind Kind;
+  while (ReadValue(Kind)) {
+    uint32_t Size = 0;
+    if (!ReadValue(Size))
+      return false;
+
+    if (Kind == BinaryChunkKind::String) {
+      std::string &Str = Strings.emplace_back(Size, '\0');
+      if (!In.read(Str.data(), Size))
+        return false;
+      continue;
+    }
+    if (Kind != BinaryChunkKind::Events)
+      return false;
+
+    for (uint32_t I = 0; I < Size; ++I) {
+      BinaryEventRecord Record;
+      if (!ReadValue(Record) || Record.NameID >= Strings.size() ||
+          Record.CategoryID >= Strings.size())
+        return false;
+      const std::string &Name = Strings[Record.NameID];
+      const std::string &Category = Strings[Record.CategoryID];
+      if (Record.Kind == BinaryEventKind::Begin)
+        Out.writeBegin(Name, Category, Record.PID, Record.TID,
+                       Record.TimeStamp);
+      else
+        Out.writeEnd(Name, Category, Record.PID, Record.TID, Record.TimeStamp);
+    }
+  }
+  Out.finalize();
+  return true;
+}
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "binary_writer.hpp"
 #include "writer.hpp"
 #include "xpti/xpti_data_types.h"
 
@@ -67,7 +68,11 @@ XPTI_CALLBACK_API void xptiTraceInit(unsigned int /*major_version*/,
     if (!ProfOutFile)
       throw std::runtime_error(
           "SYCL_PROF_OUT_FILE environment variable is not specified");
-    GWriter = new JSONWriter(ProfOutFile);
+    const char *ProfOutFormat = std::getenv("SYCL_PROF_OUT_FORMAT");
+    if (ProfOutFormat && std::string_view{ProfOutFormat} == "binary")
+      GWriter = new BinaryWriter(ProfOutFile);
+    else
+      GWriter = new JSONWriter(ProfOutFile);
     GWriter->init();
   }
 
@@ -6,15 +6,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "binary_writer.hpp"
 #include "launch.hpp"
+#include "writer.hpp"
 #include "llvm/Support/CommandLine.h"
 
+#include <cstdio>
+#include <fcntl.h>
 #include <iostream>
 #include <string>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace llvm;
 
-enum OutputFormatKind { JSON };
+enum OutputFormatKind { JSON, Binary };
 
 int main(int argc, char **argv, char *env[]) {
   cl::opt<OutputFormatKind> OutputFormat(
@@ -22,7 +28,11 @@ int main(int argc, char **argv, char *env[]) {
       cl::values(
           // TODO performance summary
           clEnumValN(JSON, "json",
-                     "JSON file, compatible with chrome://tracing")));
+                     "JSON file, compatible with chrome://tracing"),
+          clEnumValN(Binary, "binary",
+                     "Record a compact binary trace in the background and "
+                     "convert it to a JSON file, compatible with "
+                     "chrome://tracing, once the application exits")));
   cl::opt<std::string> OutputFilename("o", cl::desc("Specify output filename"),
                                       cl::value_desc("filename"), cl::Required);
   cl::opt<std::string> TargetExecutable(
@@ -40,8 +50,15 @@ int main(int argc, char **argv, char *env[]) {
       NewEnv.emplace_back(env[I++]);
   }
 
-  std::string ProfOutFile = "SYCL_PROF_OUT_FILE=" + OutputFilename;
+  // The binary trace is converted to the requested output file by this
+  // process once the application exits.
+  const std::string TraceFile = OutputFormat == Binary
+                                    ? OutputFilename + ".bin"
+                                    : std::string(OutputFilename);
+  std::string ProfOutFile = "SYCL_PROF_OUT_FILE=" + TraceFile;
   NewEnv.push_back(ProfOutFile);
+  if (OutputFormat == Binary)
+    NewEnv.push_back("SYCL_PROF_OUT_FORMAT=binary");
   NewEnv.push_back("XPTI_FRAMEWORK_DISPATCHER=libxptifw.so");
   NewEnv.push_back("XPTI_SUBSCRIBERS=libsycl_profiler_collector.so");
   NewEnv.push_back("XPTI_TRACE_ENABLE=1");
@@ -52,13 +69,63 @@ int main(int argc, char **argv, char *env[]) {
   Args.push_back(TargetExecutable);
   std::copy(Argv.begin(), Argv.end(), std::back_inserter(Args));
 
-  int Err = launch(TargetExecutable, Args, NewEnv);
+  // In binary mode the child reports a failed launch through a pipe, which
+  // is closed without writing to it when the launch succeeds.
+  int LaunchErrorPipe[2] = {-1, -1};
+  if (OutputFormat == Binary && pipe2(LaunchErrorPipe, O_CLOEXEC) != 0) {
+    std::cerr << "Failed to launch target application\n";
+    return 1;
+  }
+
+  pid_t Child = OutputFormat == Binary ? fork() : 0;
+  if (Child < 0) {
+    std::cerr << "Failed to launch target application\n";
+    return 1;
+  }
+
+  if (Child == 0) {
+    if (OutputFormat == Binary)
+      close(LaunchErrorPipe[0]);
+
+    int Err = launch(TargetExecutable, Args, NewEnv);
+
+    if (Err) {
+      std::cerr << "Failed to launch target application. Error code " << Err
+                << "\n";
+      if (OutputFormat == Binary) {
+        (void)!::write(LaunchErrorPipe[1], &Err, sizeof(Err));
+        _exit(Err);
+      }
+      return Err;
+    }
+
+    return 0;
+  }
+
+  close(LaunchErrorPipe[1]);
+  int LaunchErr = 0;
+  const bool LaunchFailed =
+      read(LaunchErrorPipe[0], &LaunchErr, sizeof(LaunchErr)) > 0;
+  close(LaunchErrorPipe[0]);
+
+  int Status = 0;
+  if (waitpid(Child, &Status, 0) != Child || LaunchFailed) {
+    std::remove(TraceFile.c_str());
+    return 1;
+  }
+  // The trace of an application killed by a signal may be cut anywhere.
+  if (!WIFEXITED(Status)) {
+    std::cerr << "Target application terminated abnormally\n";
+    std::remove(TraceFile.c_str());
+    return 1;
+  }
 
-  if (Err) {
-    std::cerr << "Failed to launch target application. Error code " << Err
-              << "\n";
-    return Err;
+  JSONWriter Out(OutputFilename);
+  if (!convertBinaryTrace(TraceFile, Out)) {
+    std::cerr << "Failed to convert the trace " << TraceFile << "\n";
+    return 1;
   }
+  std::remove(TraceFile.c_str());
 
-  return 0;
+  return WEXITSTATUS(Status);
 }
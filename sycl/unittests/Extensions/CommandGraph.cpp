@@ -1941,3 +1941,60 @@ TEST_F(MultiThreadGraphTest, Finalize) {
     ASSERT_EQ(checkExecGraphSchedule(GraphExecImpl, GraphExecRefImpl), true);
   }
 }
+
+static pi_result redefinedDeviceGetInfoNoCommandBufferAfter(
+    pi_device Device, pi_device_info ParamName, size_t ParamValueSize,
+    void *ParamValue, size_t *ParamValueSizeRet) {
+  // Hide the command-buffer support to make graphs use emulation.
+  if (ParamName == PI_DEVICE_INFO_EXTENSIONS && ParamValue) {
+    std::string_view Extensions(static_cast<const char *>(ParamValue));
+    constexpr std::string_view CmdBufferExt = "ur_exp_command_buffer";
+    if (size_t Pos = Extensions.find(CmdBufferExt);
+        Pos != std::string_view::npos)
+      std::memset(static_cast<char *>(ParamValue) + Pos, ' ',
+                  CmdBufferExt.size());
+  }
+  return PI_SUCCESS;
+}
+
+static std::vector<pi_event> LaunchEvents;
+static std::vector<std::vector<pi_event>> LaunchWaitLists;
+static pi_result redefinedEnqueueKernelLaunchAfter(
+    pi_queue, pi_kernel, pi_uint32, const size_t *, const size_t *,
+    const size_t *, pi_uint32 NumEventsInWaitList,
+    const pi_event *EventWaitList, pi_event *Event) {
+  LaunchEvents.push_back(*Event);
+  LaunchWaitLists.emplace_back(EventWaitList,
+                               EventWaitList + NumEventsInWaitList);
+  return PI_SUCCESS;
+}
+
+TEST_F(CommandGraphTest, EmulatedNodeDependencies) {
+  Mock.redefineAfter<detail::PiApiKind::piDeviceGetInfo>(
+      redefinedDeviceGetInfoNoCommandBufferAfter);
+  Mock.redefineAfter<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunchAfter);
+  LaunchEvents.clear();
+  LaunchWaitLists.clear();
+
+  auto Node1 = Graph.add(
+      [&](sycl::handler &cgh) { cgh.single_task<TestKernel<>>([]() {}); });
+  auto Empty = Graph.add({experimental::property::node::depends_on(Node1)});
+  Graph.add([&](sycl::handler &cgh) { cgh.single_task<TestKernel<>>([]() {}); },
+            {experimental::property::node::depends_on(Empty)});
+
+  auto GraphExec = Graph.finalize();
+  ASSERT_EQ(Dev.get_info<experimental::info::device::graph_support>(),
+            experimental::graph_support_level::unsupported);
+
+  // The second kernel has to wait for the first one through the empty node
+  // on every execution of the graph.
+  for (size_t Execution = 0; Execution < 2; ++Execution) {
+    Queue.submit([&](sycl::handler &CGH) { CGH.ext_oneapi_graph(GraphExec); });
+    ASSERT_EQ(LaunchEvents.size(), 2 * (Execution + 1));
+    const std::vector<pi_event> &WaitList = LaunchWaitLists.back();
+    EXPECT_EQ(WaitList.size(), 1u);
+    EXPECT_TRUE(std::find(WaitList.begin(), WaitList.end(),
+                          LaunchEvents[2 * Execution]) != WaitList.end());
+  }
+}
@@ -0,0 +1,134 @@
+//==------------------ DeviceGlobalInitEvents.cpp --------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <sycl/detail/pi.hpp>
+#include <sycl/sycl.hpp>
+
+#include <helpers/MockKernelInfo.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+
+using sycl::detail::PiApiKind;
+
+class DeviceGlobalPairTestKernel;
+constexpr const char *DeviceGlobalPairTestKernelName =
+    "DeviceGlobalPairTestKernel";
+constexpr const char *FirstDeviceGlobalName = "FirstDeviceGlobalName";
+constexpr const char *SecondDeviceGlobalName = "SecondDeviceGlobalName";
+
+sycl::ext::oneapi::experimental::device_global<int> FirstDeviceGlobal;
+sycl::ext::oneapi::experimental::device_global<int> SecondDeviceGlobal;
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+template <>
+struct KernelInfo<DeviceGlobalPairTestKernel>
+    : public unittest::MockKernelInfoBase {
+  static constexpr const char *getName() {
+    return DeviceGlobalPairTestKernelName;
+  }
+};
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+static sycl::unittest::PiImage generateDeviceGlobalPairImage() {
+  using namespace sycl::unittest;
+
+  // Call device global map initializer explicitly to mimic the integration
+  // header.
+  sycl::detail::device_global_map::add(&FirstDeviceGlobal,
+                                       FirstDeviceGlobalName);
+  sycl::detail::device_global_map::add(&SecondDeviceGlobal,
+                                       SecondDeviceGlobalName);
+
+  PiPropertySet PropSet;
+  PropSet.insert(
+      __SYCL_PI_PROPERTY_SET_SYCL_DEVICE_GLOBALS,
+      PiArray<PiProperty>{
+          makeDeviceGlobalInfo(FirstDeviceGlobalName, sizeof(int), 0),
+          makeDeviceGlobalInfo(SecondDeviceGlobalName, sizeof(int), 0)});
+
+  std::vector<unsigned char> Bin{10, 11, 12, 13, 14, 15}; // Random data
+
+  PiArray<PiOffloadEntry> Entries =
+      makeEmptyKernels({DeviceGlobalPairTestKernelName});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+namespace {
+sycl::unittest::PiImage Img = generateDeviceGlobalPairImage();
+sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+thread_local unsigned NumDeviceGlobalWrites = 0;
+thread_local std::optional<pi_event> MarkerEvent = std::nullopt;
+
+pi_result after_piextEnqueueDeviceGlobalVariableWrite(
+    pi_queue, pi_program, const char *, pi_bool, size_t, size_t, const void *,
+    pi_uint32, const pi_event *, pi_event *) {
+  ++NumDeviceGlobalWrites;
+  return PI_SUCCESS;
+}
+
+pi_result after_piEnqueueEventsWait(pi_queue, pi_uint32 NumEvents,
+                                    const pi_event *, pi_event *Event) {
+  // Both pointer writes and both zero-fills.
+  EXPECT_EQ(NumEvents, 4u);
+  EXPECT_FALSE(MarkerEvent.has_value());
+  MarkerEvent = *Event;
+  return PI_SUCCESS;
+}
+
+pi_result after_piEnqueueKernelLaunch(pi_queue, pi_kernel, pi_uint32,
+                                      const size_t *, const size_t *,
+                                      const size_t *, pi_uint32 NumEvents,
+                                      const pi_event *EventWaitList,
+                                      pi_event *) {
+  EXPECT_TRUE(MarkerEvent.has_value());
+  EXPECT_EQ(NumEvents, 1u);
+  if (MarkerEvent.has_value() && NumEvents == 1)
+    EXPECT_EQ(EventWaitList[0], *MarkerEvent);
+  return PI_SUCCESS;
+}
+} // namespace
+
+TEST(DeviceGlobalInitEventsTest, InitEventsAreMerged) {
+  sycl::unittest::PiMock Mock;
+  Mock.redefineAfter<PiApiKind::piextEnqueueDeviceGlobalVariableWrite>(
+      after_piextEnqueueDeviceGlobalVariableWrite);
+  Mock.redefineAfter<PiApiKind::piEnqueueEventsWait>(
+      after_piEnqueueEventsWait);
+  Mock.redefineAfter<PiApiKind::piEnqueueKernelLaunch>(
+      after_piEnqueueKernelLaunch);
+
+  sycl::platform Plt = Mock.getPlatform();
+  // Create new context to isolate device_global initialization.
+  sycl::context C{Plt.get_devices()[0]};
+  sycl::queue Q{C, Plt.get_devices()[0]};
+
+  Q.single_task<DeviceGlobalPairTestKernel>([]() {});
+  EXPECT_EQ(NumDeviceGlobalWrites, 2u);
+
+  // The marker is still pending, so the next launch waits on it alone.
+  Q.single_task<DeviceGlobalPairTestKernel>([]() {});
+  EXPECT_EQ(NumDeviceGlobalWrites, 2u);
+}
@@ -0,0 +1,157 @@
+//==------------------------- MemoryPool.cpp -------------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <gtest/gtest.h>
+#include <helpers/PiMock.hpp>
+#include <sycl/sycl.hpp>
+
+using namespace sycl;
+using ext::oneapi::experimental::memory_pool;
+
+static size_t NumDeviceAllocs = 0;
+static size_t NumFrees = 0;
+static bool EventsAreComplete = false;
+
+static pi_result redefinedUSMDeviceAllocAfter(void **, pi_context, pi_device,
+                                              pi_usm_mem_properties *, size_t,
+                                              pi_uint32) {
+  ++NumDeviceAllocs;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedUSMFreeAfter(pi_context, void *) {
+  ++NumFrees;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEventGetInfoAfter(pi_event, pi_event_info ParamName,
+                                            size_t, void *ParamValue,
+                                            size_t *) {
+  if (ParamName == PI_EVENT_INFO_COMMAND_EXECUTION_STATUS && ParamValue &&
+      EventsAreComplete)
+    *static_cast<pi_event_status *>(ParamValue) = PI_EVENT_COMPLETE;
+  return PI_SUCCESS;
+}
+
+class MemoryPoolTest : public ::testing::Test {
+public:
+  MemoryPoolTest() : Mock{}, Queue{Mock.getPlatform().get_devices()[0]} {}
+
+protected:
+  void SetUp() override {
+    Mock.redefineAfter<detail::PiApiKind::piextUSMDeviceAlloc>(
+        redefinedUSMDeviceAllocAfter);
+    Mock.redefineAfter<detail::PiApiKind::piextUSMFree>(redefinedUSMFreeAfter);
+    Mock.redefineAfter<detail::PiApiKind::piEventGetInfo>(
+        redefinedEventGetInfoAfter);
+    NumDeviceAllocs = 0;
+    NumFrees = 0;
+    EventsAreComplete = false;
+  }
+
+  unittest::PiMock Mock;
+  queue Queue;
+};
+
+TEST_F(MemoryPoolTest, FreedMemoryIsReused) {
+  memory_pool Pool{Queue, usm::alloc::device};
+
+  void *Ptr = Pool.malloc(1000);
+  ASSERT_NE(Ptr, nullptr);
+  EXPECT_EQ(NumDeviceAllocs, 1u);
+  EXPECT_EQ(Pool.get_used_size(), 1024u);
+  Pool.free(Ptr);
+  EXPECT_EQ(Pool.get_used_size(), 0u);
+  EXPECT_EQ(Pool.get_cached_size(), 1024u);
+
+  // A smaller allocation of the same size class reuses the block.
+  EXPECT_EQ(Pool.malloc(900), Ptr);
+  EXPECT_EQ(NumDeviceAllocs, 1u);
+  EXPECT_EQ(Pool.get_cached_size(), 0u);
+  EXPECT_EQ(NumFrees, 0u);
+
+  // A larger one needs a new block.
+  void *OtherPtr = Pool.malloc(2000);
+  EXPECT_EQ(NumDeviceAllocs, 2u);
+  Pool.free(OtherPtr);
+  Pool.trim();
+  EXPECT_EQ(NumFrees, 1u);
+  EXPECT_EQ(Pool.get_cached_size(), 0u);
+
+  EXPECT_THROW(Pool.free(OtherPtr), sycl::exception);
+}
+
+TEST_F(MemoryPoolTest, CachedSizeIsLimited) {
+  {
+    memory_pool Pool{Queue, usm::alloc::device, /*MaxCachedSize=*/1024};
+    void *FirstPtr = Pool.malloc(1024);
+    void *SecondPtr = Pool.malloc(1024);
+    Pool.free(FirstPtr);
+    Pool.free(SecondPtr);
+    EXPECT_EQ(NumFrees, 1u);
+    EXPECT_EQ(Pool.get_cached_size(), 1024u);
+  }
+  // Destroying the pool releases the cached memory.
+  EXPECT_EQ(NumFrees, 2u);
+}
+
+TEST_F(MemoryPoolTest, QueueOrderedFree) {
+  memory_pool Pool{Queue, usm::alloc::device};
+
+  void *Ptr = Pool.malloc(1024);
+  Pool.free(Ptr, Queue);
+  // The memory can't be reused until the commands of the queue are complete.
+  void *OtherPtr = Pool.malloc(1024);
+  EXPECT_NE(OtherPtr, Ptr);
+  EXPECT_EQ(NumDeviceAllocs, 2u);
+  Pool.free(OtherPtr);
+
+  EventsAreComplete = true;
+  Pool.trim();
+  EXPECT_EQ(NumFrees, 2u);
+  EXPECT_EQ(Pool.get_cached_size(), 0u);
+}
+
+TEST_F(MemoryPoolTest, AsyncMallocFree) {
+  using ext::oneapi::experimental::async_free;
+  using ext::oneapi::experimental::async_malloc;
+  queue InOrderQueue{Queue.get_context(), Queue.get_device(),
+                     property::queue::in_order{}};
+
+  void *Ptr = async_malloc(InOrderQueue, 1024);
+  ASSERT_NE(Ptr, nullptr);
+  InOrderQueue.memset(Ptr, 0, 1024);
+  async_free(InOrderQueue, Ptr);
+
+  // The memset may still be using the memory.
+  void *OtherPtr = async_malloc(InOrderQueue, 1024);
+  EXPECT_NE(OtherPtr, Ptr);
+  EXPECT_EQ(NumDeviceAllocs, 2u);
+
+  EventsAreComplete = true;
+  async_free(InOrderQueue, OtherPtr);
+  void *ReusedPtr = async_malloc(InOrderQueue, 1024);
+  EXPECT_TRUE(ReusedPtr == Ptr || ReusedPtr == OtherPtr);
+  EXPECT_EQ(NumDeviceAllocs, 2u);
+  EXPECT_EQ(NumFrees, 0u);
+}
+
+TEST_F(MemoryPoolTest, ReductionScratchMemIsReused) {
+  auto QueueImpl = detail::getSyclObjImpl(Queue);
+
+  std::shared_ptr<void> Scratch = detail::reduGetScratchMem(QueueImpl, 1024);
+  ASSERT_NE(Scratch, nullptr);
+  void *Ptr = Scratch.get();
+  EXPECT_EQ(NumDeviceAllocs, 1u);
+
+  // Dropping the last reference returns the memory to the queue's pool.
+  Scratch.reset();
+  EXPECT_EQ(detail::reduGetScratchMem(QueueImpl, 1024).get(), Ptr);
+  EXPECT_EQ(NumDeviceAllocs, 1u);
+  EXPECT_EQ(NumFrees, 0u);
+}
@@ -0,0 +1,51 @@
+//==------- EventRecycling.cpp --- Check event_impl memory recycling -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/event_impl.hpp>
+#include <helpers/PiMock.hpp>
+#include <helpers/TestKernel.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace sycl;
+
+// Check that the memory of a deallocated object is used for the next
+// allocation on the same thread.
+TEST(EventRecyclingTest, MemoryIsReused) {
+  struct TestObject {
+    void *Data[4];
+  };
+  detail::RecyclingAllocator<TestObject> Allocator;
+
+  TestObject *First = Allocator.allocate(1);
+  Allocator.deallocate(First, 1);
+  TestObject *Second = Allocator.allocate(1);
+  EXPECT_EQ(Second, First);
+  Allocator.deallocate(Second, 1);
+
+  detail::EventImplPtr Event = detail::createEventImpl(std::nullopt);
+  EXPECT_FALSE(Event->is_host());
+}
+
+// Check that commands submitted to a queue discarding events share the
+// discarded event.
+TEST(EventRecyclingTest, DiscardedEventIsShared) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+
+  queue Queue{Plt.get_devices()[0],
+              {property::queue::in_order{},
+               ext::oneapi::property::queue::discard_events{}}};
+  event FirstEvent = Queue.single_task<TestKernel<>>([] {});
+  event SecondEvent = Queue.single_task<TestKernel<>>([] {});
+
+  detail::EventImplPtr FirstEventImpl = detail::getSyclObjImpl(FirstEvent);
+  EXPECT_TRUE(FirstEventImpl->isDiscarded());
+  EXPECT_EQ(FirstEventImpl, detail::getSyclObjImpl(SecondEvent));
+}
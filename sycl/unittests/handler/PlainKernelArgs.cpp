@@ -0,0 +1,128 @@
+//==------ PlainKernelArgs.cpp --- Arguments set without descriptors walk --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <helpers/MockKernelInfo.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+
+class PlainArgsKernel;
+class NonConstexprArgsKernel;
+
+struct KernelWithPlainArgs {
+  int Value;
+  int *Ptr;
+
+  void operator()() const {}
+};
+
+// Same as the signatures emitted in the integration header.
+static constexpr sycl::detail::kernel_param_desc_t PlainArgsSignatures[] = {
+    {sycl::detail::kernel_param_kind_t::kind_std_layout, sizeof(int),
+     offsetof(KernelWithPlainArgs, Value)},
+    {sycl::detail::kernel_param_kind_t::kind_pointer, sizeof(int *),
+     offsetof(KernelWithPlainArgs, Ptr)}};
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+template <>
+struct KernelInfo<PlainArgsKernel> : public unittest::MockKernelInfoBase {
+  static constexpr const char *getName() { return "PlainArgsKernel"; }
+  static constexpr unsigned getNumParams() { return 2; }
+  static constexpr const kernel_param_desc_t &getParamDesc(unsigned Index) {
+    return PlainArgsSignatures[Index];
+  }
+  static constexpr int64_t getKernelSize() {
+    return sizeof(KernelWithPlainArgs);
+  }
+};
+
+template <>
+struct KernelInfo<NonConstexprArgsKernel>
+    : public unittest::MockKernelInfoBase {
+  static constexpr unsigned getNumParams() { return 1; }
+  static const kernel_param_desc_t &getParamDesc(int Index) {
+    return PlainArgsSignatures[Index];
+  }
+};
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+using PlainArgsKI = sycl::detail::KernelInfo<PlainArgsKernel>;
+static_assert(sycl::detail::hasOnlyPlainKernelParams<PlainArgsKI>());
+static_assert(!sycl::detail::hasOnlyPlainKernelParams<
+              sycl::detail::KernelInfo<NonConstexprArgsKernel>>());
+
+static sycl::unittest::PiImage generateImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+
+  std::vector<unsigned char> Bin{0, 1, 2, 3, 4, 5}; // Random data
+
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({"PlainArgsKernel"});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Img = generateImage();
+static sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+static int SetValue = 0;
+static pi_uint32 SetValueIndex = 0;
+static int *SetPtr = nullptr;
+static pi_uint32 SetPtrIndex = 0;
+
+static pi_result redefinedKernelSetArg(pi_kernel, pi_uint32 Index, size_t Size,
+                                       const void *Value) {
+  EXPECT_EQ(Size, sizeof(int));
+  std::memcpy(&SetValue, Value, sizeof(int));
+  SetValueIndex = Index;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedKernelSetArgPointer(pi_kernel, pi_uint32 Index,
+                                              size_t Size, const void *Value) {
+  EXPECT_EQ(Size, sizeof(int *));
+  std::memcpy(&SetPtr, Value, sizeof(int *));
+  SetPtrIndex = Index;
+  return PI_SUCCESS;
+}
+
+TEST(PlainKernelArgs, ArgumentsAreSetFromCaptures) {
+  sycl::unittest::PiMock Mock;
+  sycl::platform Plt = Mock.getPlatform();
+  Mock.redefineBefore<sycl::detail::PiApiKind::piKernelSetArg>(
+      redefinedKernelSetArg);
+  Mock.redefineBefore<sycl::detail::PiApiKind::piextKernelSetArgPointer>(
+      redefinedKernelSetArgPointer);
+
+  sycl::queue Queue{Plt.get_devices()[0]};
+  int Data = 0;
+  Queue.single_task<PlainArgsKernel>(KernelWithPlainArgs{42, &Data}).wait();
+
+  EXPECT_EQ(SetValue, 42);
+  EXPECT_EQ(SetValueIndex, 0u);
+  EXPECT_EQ(SetPtr, &Data);
+  EXPECT_EQ(SetPtrIndex, 1u);
+}
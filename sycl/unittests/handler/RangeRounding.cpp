@@ -0,0 +1,41 @@
+//==------ RangeRounding.cpp --- parallel_for range rounding factor --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/device_impl.hpp>
+#include <helpers/PiMock.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+static pi_result redefinedDeviceGetInfoAfter(pi_device, pi_device_info Name,
+                                             size_t, void *Value, size_t *) {
+  if (Name == PI_DEVICE_INFO_MAX_WORK_GROUP_SIZE && Value)
+    *static_cast<size_t *>(Value) = 256;
+  return PI_SUCCESS;
+}
+
+TEST(RangeRounding, FactorIsBoundByPaddingAndWorkGroupSize) {
+  sycl::unittest::PiMock Mock;
+  Mock.redefineAfter<sycl::detail::PiApiKind::piDeviceGetInfo>(
+      redefinedDeviceGetInfoAfter);
+  sycl::device Dev = Mock.getPlatform().get_devices()[0];
+  auto DevImpl = sycl::detail::getSyclObjImpl(Dev);
+
+  // Ranges too small to pad by 1/16 of a larger factor keep the default.
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(1000, 32), 32u);
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(1023, 32), 32u);
+  // The factor doubles once the range is at least 16 times the new factor.
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(1024, 32), 64u);
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(2047, 32), 64u);
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(2048, 32), 128u);
+  // It never exceeds the maximum work-group size of the device.
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(4096, 32), 256u);
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(1 << 20, 32), 256u);
+  // The factor given is the lower bound, even past the work-group size.
+  EXPECT_EQ(DevImpl->getRangeRoundingFactor(100, 512), 512u);
+}
@@ -12,8 +12,10 @@
 #define SYCL2020_DISABLE_DEPRECATION_WARNINGS
 
 #include "detail/context_impl.hpp"
+#include "detail/global_handler.hpp"
 #include "detail/kernel_program_cache.hpp"
 #include "detail/program_impl.hpp"
+#include "detail/thread_pool.hpp"
 #include "sycl/detail/pi.h"
 #include <helpers/MockKernelInfo.hpp>
 #include <helpers/PiImage.hpp>
@@ -254,6 +256,56 @@ TEST_F(KernelAndProgramCacheTest, SpecConstantCacheNegative) {
   EXPECT_EQ(Cache.size(), 2U) << "Expect an entry for each build in the cache.";
 }
 
+// Check that kernels prebuilt in background are cached.
+TEST_F(KernelAndProgramCacheTest, PrebuildKernels) {
+  std::vector<sycl::device> Devices = Plt.get_devices();
+  sycl::context Ctx(Devices[0]);
+
+  sycl::ext::oneapi::experimental::prebuild_kernels<CacheTestKernel>(Ctx);
+  detail::GlobalHandler::instance().getProgramBuildThreadPool().drain();
+
+  auto CtxImpl = detail::getSyclObjImpl(Ctx);
+  detail::KernelProgramCache::ProgramCache &Cache =
+      CtxImpl->getKernelProgramCache().acquireCachedPrograms().get();
+  EXPECT_EQ(Cache.size(), 1U) << "Expect the prebuilt program in the cache.";
+
+  detail::KernelProgramCache::KernelCacheT &KernelCache =
+      CtxImpl->getKernelProgramCache().acquireKernelsPerProgramCache().get();
+  ASSERT_EQ(KernelCache.size(), 1U) << "Expect the prebuilt kernel cached.";
+  EXPECT_EQ(KernelCache.begin()->second.size(), 1U)
+      << "Expect the prebuilt kernel cached.";
+}
+
+// Check that prebuilt specialization constant variants are used by later
+// builds with the same values.
+TEST_F(KernelAndProgramCacheTest, PrebuildSpecConstantVariants) {
+  std::vector<sycl::device> Devices = Plt.get_devices();
+  sycl::context Ctx(Devices[0]);
+
+  auto KernelID = sycl::get_kernel_id<CacheTestKernel>();
+  std::vector<kernel_bundle<sycl::bundle_state::input>> Variants;
+  for (int Value : {1, 2, 3}) {
+    auto Bundle =
+        sycl::get_kernel_bundle<sycl::bundle_state::input>(Ctx, {KernelID});
+    Bundle.set_specialization_constant<SpecConst1>(Value);
+    Variants.push_back(Bundle);
+  }
+
+  sycl::ext::oneapi::experimental::prebuild_kernels(Variants);
+  detail::GlobalHandler::instance().getProgramBuildThreadPool().drain();
+
+  auto CtxImpl = detail::getSyclObjImpl(Ctx);
+  detail::KernelProgramCache::ProgramCache &Cache =
+      CtxImpl->getKernelProgramCache().acquireCachedPrograms().get();
+  EXPECT_EQ(Cache.size(), 3U) << "Expect an entry for each variant.";
+
+  auto Bundle =
+      sycl::get_kernel_bundle<sycl::bundle_state::input>(Ctx, {KernelID});
+  Bundle.set_specialization_constant<SpecConst1>(2);
+  sycl::build(Bundle);
+  EXPECT_EQ(Cache.size(), 3U) << "Expect the prebuilt variant to be used.";
+}
+
 // Check that kernel_bundle created through join() is not cached.
 TEST_F(KernelAndProgramCacheTest, KernelBundleJoin) {
   std::vector<sycl::device> Devices = Plt.get_devices();
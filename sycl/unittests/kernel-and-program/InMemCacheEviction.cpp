@@ -0,0 +1,150 @@
+//==--- InMemCacheEviction.cpp --- in-memory program cache eviction test ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/kernel_program_cache.hpp>
+#include <helpers/MockKernelInfo.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace sycl;
+
+class EvictionTestKernelA;
+class EvictionTestKernelB;
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+template <>
+struct KernelInfo<EvictionTestKernelA> : public unittest::MockKernelInfoBase {
+  static constexpr const char *getName() { return "EvictionTestKernelA"; }
+};
+template <>
+struct KernelInfo<EvictionTestKernelB> : public unittest::MockKernelInfoBase {
+  static constexpr const char *getName() { return "EvictionTestKernelB"; }
+};
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+static sycl::unittest::PiImage generateImage(const char *KernelName) {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+  std::vector<unsigned char> Bin{0, 1, 2, 3, 4, 5}; // Random data
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({KernelName});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Imgs[] = {generateImage("EvictionTestKernelA"),
+                                         generateImage("EvictionTestKernelB")};
+static sycl::unittest::PiImageArray<2> ImgArray{Imgs};
+
+inline constexpr auto InMemCacheMaxSizeName = "SYCL_IN_MEM_CACHE_MAX_SIZE";
+
+static size_t NumProgramsCreated = 0;
+static size_t NumProgramsReleased = 0;
+
+static pi_result redefinedProgramCreateAfter(pi_context, const void *, size_t,
+                                             pi_program *) {
+  ++NumProgramsCreated;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedProgramReleaseAfter(pi_program) {
+  ++NumProgramsReleased;
+  return PI_SUCCESS;
+}
+
+// Check that least recently used programs are evicted from the in-memory
+// cache once the size of cached programs exceeds SYCL_IN_MEM_CACHE_MAX_SIZE.
+TEST(InMemCacheEvictionTest, EvictLeastRecentlyUsedProgram) {
+  // Mock programs report a binary size of one byte, so only a single program
+  // fits into the cache.
+  unittest::ScopedEnvVar MaxSizeVar{
+      InMemCacheMaxSizeName, "1",
+      detail::SYCLConfig<detail::SYCL_IN_MEM_CACHE_MAX_SIZE>::reset};
+  unittest::PiMock Mock;
+  Mock.redefineAfter<detail::PiApiKind::piProgramCreate>(
+      redefinedProgramCreateAfter);
+  Mock.redefineAfter<detail::PiApiKind::piProgramRelease>(
+      redefinedProgramReleaseAfter);
+  NumProgramsCreated = 0;
+  NumProgramsReleased = 0;
+
+  context Ctx{Mock.getPlatform()};
+  queue Queue{Ctx, default_selector_v};
+  detail::KernelProgramCache &Cache =
+      detail::getSyclObjImpl(Ctx)->getKernelProgramCache();
+  auto getNumCachedPrograms = [&Cache]() {
+    return Cache.acquireCachedPrograms().get().size();
+  };
+
+  Queue.single_task<EvictionTestKernelA>([] {});
+  EXPECT_EQ(NumProgramsCreated, 1u);
+  EXPECT_EQ(getNumCachedPrograms(), 1u);
+
+  // Kernel B doesn't fit alongside kernel A, so the program of the latter
+  // is evicted.
+  Queue.single_task<EvictionTestKernelB>([] {});
+  EXPECT_EQ(NumProgramsCreated, 2u);
+  EXPECT_EQ(NumProgramsReleased, 1u);
+  EXPECT_EQ(getNumCachedPrograms(), 1u);
+
+  // Kernel B is served from the cache.
+  Queue.single_task<EvictionTestKernelB>([] {});
+  EXPECT_EQ(NumProgramsCreated, 2u);
+  EXPECT_EQ(NumProgramsReleased, 1u);
+
+  // Kernel A has to be rebuilt.
+  Queue.single_task<EvictionTestKernelA>([] {});
+  EXPECT_EQ(NumProgramsCreated, 3u);
+  EXPECT_EQ(NumProgramsReleased, 2u);
+  EXPECT_EQ(getNumCachedPrograms(), 1u);
+}
+
+// Check that nothing is evicted while the cache is in use.
+TEST(InMemCacheEvictionTest, NoEvictionUnderGuard) {
+  unittest::ScopedEnvVar MaxSizeVar{
+      InMemCacheMaxSizeName, "1",
+      detail::SYCLConfig<detail::SYCL_IN_MEM_CACHE_MAX_SIZE>::reset};
+  unittest::PiMock Mock;
+  Mock.redefineAfter<detail::PiApiKind::piProgramRelease>(
+      redefinedProgramReleaseAfter);
+  NumProgramsReleased = 0;
+
+  context Ctx{Mock.getPlatform()};
+  queue Queue{Ctx, default_selector_v};
+  detail::KernelProgramCache &Cache =
+      detail::getSyclObjImpl(Ctx)->getKernelProgramCache();
+
+  {
+    auto CacheGuard = Cache.acquireEvictionGuard();
+    Queue.single_task<EvictionTestKernelA>([] {});
+    Queue.single_task<EvictionTestKernelB>([] {});
+    EXPECT_EQ(NumProgramsReleased, 0u);
+    EXPECT_EQ(Cache.acquireCachedPrograms().get().size(), 2u);
+  }
+  // The eviction is performed once the last guard is released.
+  EXPECT_EQ(NumProgramsReleased, 1u);
+  EXPECT_EQ(Cache.acquireCachedPrograms().get().size(), 1u);
+}
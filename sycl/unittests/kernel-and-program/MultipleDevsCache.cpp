@@ -8,12 +8,16 @@
 
 #define SYCL2020_DISABLE_DEPRECATION_WARNINGS
 
+#include "detail/config.hpp"
 #include "detail/context_impl.hpp"
+#include "detail/global_handler.hpp"
 #include "detail/kernel_bundle_impl.hpp"
 #include "detail/kernel_program_cache.hpp"
+#include "detail/thread_pool.hpp"
 #include <helpers/MockKernelInfo.hpp>
 #include <helpers/PiImage.hpp>
 #include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
 
 #include <gtest/gtest.h>
 
@@ -120,6 +124,22 @@ static pi_result redefinedKernelRelease(pi_kernel kernel) {
   return PI_SUCCESS;
 }
 
+static int ProgramCreateCounter = 0;
+static pi_result redefinedProgramCreate(pi_context, const void *, size_t,
+                                        pi_program *) {
+  ++ProgramCreateCounter;
+  return PI_SUCCESS;
+}
+
+static int ProgramCreateWithBinaryCounter = 0;
+static pi_result redefinedProgramCreateWithBinary(
+    pi_context, pi_uint32, const pi_device *, const size_t *,
+    const unsigned char **, size_t, const pi_device_binary_property *,
+    pi_int32 *, pi_program *) {
+  ++ProgramCreateWithBinaryCounter;
+  return PI_SUCCESS;
+}
+
 class MultipleDeviceCacheTest : public ::testing::Test {
 public:
   MultipleDeviceCacheTest() : Mock{}, Plt{Mock.getPlatform()} {}
@@ -194,3 +214,37 @@ TEST_F(MultipleDeviceCacheTest, ProgramRetain) {
   // expect 2 piKernelRelease calls.
   EXPECT_EQ(KernelReleaseCounter, 2) << "Expect 2 piKernelRelease calls";
 }
+
+// Test that the program is built for the other device of the context in
+// background and that the device code is shared between devices of the same
+// kind
+TEST_F(MultipleDeviceCacheTest, ParallelDeviceBuild) {
+  unittest::ScopedEnvVar ParallelBuildVar{
+      "SYCL_PARALLEL_DEVICE_BUILD", "1",
+      detail::SYCLConfig<detail::SYCL_PARALLEL_DEVICE_BUILD>::reset};
+  Mock.redefineBefore<detail::PiApiKind::piProgramCreate>(
+      redefinedProgramCreate);
+  Mock.redefineBefore<detail::PiApiKind::piProgramCreateWithBinary>(
+      redefinedProgramCreateWithBinary);
+  ProgramCreateCounter = 0;
+  ProgramCreateWithBinaryCounter = 0;
+
+  std::vector<sycl::device> Devices = Plt.get_devices(info::device_type::gpu);
+  sycl::context Context(Devices);
+  sycl::queue Queue(Context, Devices[0]);
+  assert(Devices.size() == 2 && Context.get_devices().size() == 2);
+
+  Queue.single_task<MultipleDevsCacheTestKernel>([]() {});
+  detail::GlobalHandler::instance().getProgramBuildThreadPool().drain();
+
+  auto CtxImpl = detail::getSyclObjImpl(Context);
+  EXPECT_EQ(CtxImpl->getKernelProgramCache()
+                .acquireCachedPrograms()
+                .get()
+                .size(),
+            size_t{2})
+      << "Expect a program for each device";
+  EXPECT_EQ(ProgramCreateCounter, 1) << "Expect 1 JIT compiled program";
+  EXPECT_EQ(ProgramCreateWithBinaryCounter, 1)
+      << "Expect 1 program created from the shared device code";
+}
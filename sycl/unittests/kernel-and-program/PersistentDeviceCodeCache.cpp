@@ -9,9 +9,13 @@
 // Detailed description of the tests cases can be seen per test function.
 #include "../thread_safety/ThreadUtils.h"
 #include "detail/persistent_device_code_cache.hpp"
+#include <detail/persistent_fused_kernels.hpp>
 #include <detail/device_binary_image.hpp>
+#include <detail/global_handler.hpp>
+#include <detail/thread_pool.hpp>
 #include <gtest/gtest.h>
 #include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
 #include <llvm/Support/FileSystem.h>
 #include <sycl/detail/os_util.hpp>
 #include <sycl/sycl.hpp>
@@ -267,6 +271,188 @@ TEST_P(PersistentDeviceCodeCache, KeysWithNullTermSymbol) {
   ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
 }
 
+/* Checks that an item which is already stored, e.g. by another process, is
+ * not stored again.
+ */
+TEST_P(PersistentDeviceCodeCache, NoDuplicateItems) {
+  std::string BuildOptions{"--no-duplicates"};
+  std::string ItemDir = detail::PersistentDeviceCodeCache::getCacheItemPath(
+      Dev, Img, {}, BuildOptions);
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+
+  detail::PersistentDeviceCodeCache::putItemToDisc(Dev, Img, {}, BuildOptions,
+                                                   NativeProg);
+  detail::PersistentDeviceCodeCache::putItemToDisc(Dev, Img, {}, BuildOptions,
+                                                   NativeProg);
+  EXPECT_TRUE(llvm::sys::fs::exists(ItemDir + "/0.bin")) << "No file created";
+  EXPECT_FALSE(llvm::sys::fs::exists(ItemDir + "/1.bin"))
+      << "Duplicate item created";
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+}
+
+/* Checks that results of the reduction auto-tuner are found by their key and
+ * that an item stored already is not replaced.
+ */
+TEST_P(PersistentDeviceCodeCache, ReductionTuningItems) {
+  std::string ItemsDir =
+      std::string{detail::SYCLConfig<detail::SYCL_CACHE_DIR>::get()} +
+      "/reduction";
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemsDir));
+
+  std::string Key{"i;plus;10;3"};
+  std::vector<char> Data{'2'};
+  detail::PersistentDeviceCodeCache::putReductionTuningToDisc(Dev, Key, Data);
+  detail::PersistentDeviceCodeCache::putReductionTuningToDisc(Dev, Key, {'1'});
+  EXPECT_EQ(
+      detail::PersistentDeviceCodeCache::getReductionTuningFromDisc(Dev, Key),
+      Data);
+  EXPECT_TRUE(detail::PersistentDeviceCodeCache::getReductionTuningFromDisc(
+                  Dev, "i;plus;11;3")
+                  .empty());
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemsDir));
+}
+
+/* Checks that a persisted fused kernel is found again by its name in memory
+ * and, by another process, in the persistent cache, and that it is not found
+ * for a different fusion with the same name.
+ */
+TEST_P(PersistentDeviceCodeCache, FusedKernelItems) {
+  std::string ItemsDir =
+      std::string{detail::SYCLConfig<detail::SYCL_CACHE_DIR>::get()} +
+      "/fusion";
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemsDir));
+
+  const std::string Name{"fused_42"};
+  const std::string Key{"spirv;3;KernelA;KernelB"};
+  const std::vector<char> Data{'f', 'u', 's', 'e', 'd'};
+  bool FromDisc = true;
+  {
+    detail::PersistentFusedKernels Kernels;
+    EXPECT_EQ(Kernels.find(Dev, Name, Key, FromDisc), nullptr);
+    Kernels.add(Dev, Name, Key, Data);
+
+    const std::vector<char> *Found = Kernels.find(Dev, Name, Key, FromDisc);
+    ASSERT_NE(Found, nullptr);
+    EXPECT_EQ(*Found, Data);
+    EXPECT_FALSE(FromDisc);
+
+    const std::string OtherKey{"spirv;3;KernelA;KernelC"};
+    EXPECT_TRUE(Kernels.clashes(Name, OtherKey));
+    EXPECT_FALSE(Kernels.clashes(Name, Key));
+    EXPECT_EQ(Kernels.find(Dev, Name, OtherKey, FromDisc), nullptr);
+  }
+
+  // A new process only knows the fused kernel from the persistent cache.
+  detail::PersistentFusedKernels Kernels;
+  EXPECT_FALSE(Kernels.clashes(Name, Key));
+  const std::vector<char> *Found = Kernels.find(Dev, Name, Key, FromDisc);
+  ASSERT_NE(Found, nullptr);
+  EXPECT_EQ(*Found, Data);
+  EXPECT_TRUE(FromDisc);
+  Found = Kernels.find(Dev, Name, Key, FromDisc);
+  ASSERT_NE(Found, nullptr);
+  EXPECT_FALSE(FromDisc);
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemsDir));
+}
+
+/* Checks that least recently used items are evicted once total size of cache
+ * items exceeds SYCL_CACHE_MAX_SIZE, while the item just added is kept.
+ */
+TEST_P(PersistentDeviceCodeCache, EvictionBySize) {
+  unittest::ScopedEnvVar MaxSizeVar{
+      "SYCL_CACHE_MAX_SIZE", "1",
+      detail::SYCLConfig<detail::SYCL_CACHE_MAX_SIZE>::reset};
+  std::string BuildOptions{"--eviction"};
+  std::string TinyItemDir =
+      detail::PersistentDeviceCodeCache::getCacheItemPath(Dev, Img, {'T'},
+                                                          BuildOptions);
+  std::string BigItemDir = detail::PersistentDeviceCodeCache::getCacheItemPath(
+      Dev, Img, {'B'}, BuildOptions);
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(TinyItemDir));
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(BigItemDir));
+
+  DeviceCodeID = 0;
+  detail::PersistentDeviceCodeCache::putItemToDisc(Dev, Img, {'T'},
+                                                   BuildOptions, NativeProg);
+  EXPECT_TRUE(llvm::sys::fs::exists(TinyItemDir + "/0.bin"))
+      << "No file created";
+
+  // The big item alone exceeds 1 MB, so the tiny one has to be evicted.
+  DeviceCodeID = 2;
+  detail::PersistentDeviceCodeCache::putItemToDisc(Dev, Img, {'B'},
+                                                   BuildOptions, NativeProg);
+  EXPECT_TRUE(llvm::sys::fs::exists(BigItemDir + "/0.bin"))
+      << "No file created";
+  EXPECT_FALSE(llvm::sys::fs::exists(TinyItemDir + "/0.bin"))
+      << "Item was not evicted";
+  EXPECT_FALSE(llvm::sys::fs::exists(TinyItemDir + "/0.src"))
+      << "Item was not evicted";
+
+  auto Res = detail::PersistentDeviceCodeCache::getItemFromDisc(
+      Dev, Img, {'T'}, BuildOptions);
+  EXPECT_EQ(Res.size(), static_cast<size_t>(0)) << "Evicted item was read";
+
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(TinyItemDir));
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(BigItemDir));
+}
+
+/* Checks that reading an item from the cache records its use in the cache
+ * index only once per process.
+ */
+TEST_P(PersistentDeviceCodeCache, UseRecordedOncePerProcess) {
+  std::string BuildOptions{"--use-records"};
+  std::string ItemDir = detail::PersistentDeviceCodeCache::getCacheItemPath(
+      Dev, Img, {}, BuildOptions);
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+
+  detail::PersistentDeviceCodeCache::putItemToDisc(Dev, Img, {}, BuildOptions,
+                                                   NativeProg);
+  for (int I = 0; I < 3; ++I) {
+    auto Res = detail::PersistentDeviceCodeCache::getItemFromDisc(
+        Dev, Img, {}, BuildOptions);
+    EXPECT_NE(Res.size(), static_cast<size_t>(0)) << "Failed to load item";
+  }
+
+  std::ifstream Index{detail::SYCLConfig<detail::SYCL_CACHE_DIR>::get() +
+                      std::string{"/index"}};
+  size_t NumUseRecords = 0;
+  std::string Line;
+  while (std::getline(Index, Line))
+    NumUseRecords += !Line.empty() && Line[0] == 'U';
+  EXPECT_EQ(NumUseRecords, 1u);
+
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+}
+
+/* Checks that items stored in background become available once the writer
+ * thread is done with them.
+ */
+TEST_P(PersistentDeviceCodeCache, AsyncWrite) {
+  std::string BuildOptions{"--async-write"};
+  std::string ItemDir = detail::PersistentDeviceCodeCache::getCacheItemPath(
+      Dev, Img, {}, BuildOptions);
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+
+  detail::PersistentDeviceCodeCache::putItemToDiscAsync(
+      Dev, Img, {}, BuildOptions, NativeProg);
+  detail::GlobalHandler::instance()
+      .getPersistentCacheWriterThreadPool()
+      .drain();
+  EXPECT_TRUE(llvm::sys::fs::exists(ItemDir + "/0.bin")) << "No file created";
+  EXPECT_FALSE(llvm::sys::fs::exists(ItemDir + "/0.lock")) << "Item locked";
+
+  auto Res = detail::PersistentDeviceCodeCache::getItemFromDisc(Dev, Img, {},
+                                                                BuildOptions);
+  EXPECT_NE(Res.size(), static_cast<size_t>(0)) << "Failed to load cache item";
+  for (size_t i = 0; i < Res.size(); ++i) {
+    for (size_t j = 0; j < Res[i].size(); ++j) {
+      EXPECT_EQ(Res[i][j], static_cast<unsigned char>(i))
+          << "Corrupted image loaded from persistent cache";
+    }
+  }
+  ASSERT_NO_ERROR(llvm::sys::fs::remove_directories(ItemDir));
+}
+
 /* Do read/write for the same cache item to/from 300 threads for small device
  * code size. Make sure that there is no data corruption or crashes.
  */
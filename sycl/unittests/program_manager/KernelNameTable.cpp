@@ -0,0 +1,64 @@
+//==------- KernelNameTable.cpp --- Kernel name table unit tests -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/kernel_name_table.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using sycl::detail::KernelNameTable;
+
+TEST(KernelNameTable, EntriesAreFoundOnceCommitted) {
+  KernelNameTable<int> Table;
+  Table.insert("KernelA", KernelNameTable<int>::hash("KernelA"), 1);
+  EXPECT_EQ(Table.find("KernelA"), nullptr);
+
+  Table.commit();
+  Table.insert("KernelB", KernelNameTable<int>::hash("KernelB"), 2);
+  ASSERT_NE(Table.find("KernelA"), nullptr);
+  EXPECT_EQ(*Table.find("KernelA"), 1);
+  EXPECT_EQ(Table.find("KernelB"), nullptr);
+
+  Table.commit();
+  ASSERT_NE(Table.find("KernelB"), nullptr);
+  EXPECT_EQ(*Table.find("KernelB"), 2);
+  EXPECT_EQ(Table.find("KernelC"), nullptr);
+  EXPECT_EQ(Table.size(), 2u);
+}
+
+TEST(KernelNameTable, NamesWithSameHashAreDistinguished) {
+  KernelNameTable<int> Table;
+  // Force a collision to check that names are compared.
+  Table.insert("KernelA", 42, 1);
+  Table.insert("KernelB", 42, 2);
+  Table.commit();
+
+  ASSERT_NE(Table.find("KernelA", 42), nullptr);
+  EXPECT_EQ(*Table.find("KernelA", 42), 1);
+  ASSERT_NE(Table.find("KernelB", 42), nullptr);
+  EXPECT_EQ(*Table.find("KernelB", 42), 2);
+  EXPECT_EQ(Table.find("KernelC", 42), nullptr);
+}
+
+TEST(KernelNameTable, LongNames) {
+  KernelNameTable<int> Table;
+  // Mangled names of template kernels share long prefixes.
+  const std::string Prefix(4096, 'N');
+  const std::string NameA = Prefix + "A";
+  const std::string NameB = Prefix + "B";
+  Table.insert(NameB, KernelNameTable<int>::hash(NameB), 2);
+  Table.insert(NameA, KernelNameTable<int>::hash(NameA), 1);
+  Table.commit();
+
+  ASSERT_NE(Table.find(NameA), nullptr);
+  EXPECT_EQ(*Table.find(NameA), 1);
+  ASSERT_NE(Table.find(NameB), nullptr);
+  EXPECT_EQ(*Table.find(NameB), 2);
+  EXPECT_EQ(Table.find(Prefix), nullptr);
+}
@@ -0,0 +1,208 @@
+//==--------- SPIRVPruning.cpp --- SPIR-V function pruning unit tests ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/spirv_pruning.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using sycl::detail::getSPIRVExportedFunctions;
+using sycl::detail::pruneSPIRVFunctions;
+
+namespace {
+
+enum : uint32_t {
+  OpName = 5,
+  OpMemoryModel = 14,
+  OpEntryPoint = 15,
+  OpCapability = 17,
+  OpTypeVoid = 19,
+  OpTypeInt = 21,
+  OpTypeFunction = 33,
+  OpConstant = 43,
+  OpFunction = 54,
+  OpFunctionEnd = 56,
+  OpFunctionCall = 57,
+  OpDecorate = 71,
+  OpIAdd = 128,
+  OpLabel = 248,
+  OpReturn = 253,
+};
+
+enum : uint32_t {
+  DecorationLinkageAttributes = 41,
+  DecorationNoSignedWrap = 4469,
+  LinkageTypeExport = 0,
+};
+
+// Ids of the test module.
+enum : uint32_t {
+  Void = 1,
+  Int = 2,
+  FnTy = 3,
+  One = 4,
+  FuncA = 10,
+  FuncB = 11,
+  FuncC = 12,
+  LocalA = 15,
+  LocalB = 18,
+  Bound = 20,
+};
+
+class ModuleBuilder {
+public:
+  ModuleBuilder() : Words{0x07230203, 0x00010000, 0, Bound, 0} {}
+
+  void add(uint32_t Opcode, std::vector<uint32_t> Ops) {
+    Words.push_back(Opcode | (uint32_t(Ops.size() + 1) << 16));
+    Words.insert(Words.end(), Ops.begin(), Ops.end());
+  }
+
+  static std::vector<uint32_t> str(const std::string &S) {
+    std::vector<uint32_t> Ws(S.size() / 4 + 1, 0);
+    std::memcpy(Ws.data(), S.data(), S.size());
+    return Ws;
+  }
+
+  void addLinkage(uint32_t Target, const std::string &Name) {
+    std::vector<uint32_t> Ops = {Target, DecorationLinkageAttributes};
+    for (uint32_t W : str(Name))
+      Ops.push_back(W);
+    Ops.push_back(LinkageTypeExport);
+    add(OpDecorate, Ops);
+  }
+
+  void addFunction(uint32_t Id, uint32_t Label,
+                   const std::vector<std::vector<uint32_t>> &Body) {
+    add(OpFunction, {Void, Id, 0, FnTy});
+    add(OpLabel, {Label});
+    for (const std::vector<uint32_t> &Inst : Body)
+      add(Inst[0], std::vector<uint32_t>(Inst.begin() + 1, Inst.end()));
+    add(OpReturn, {});
+    add(OpFunctionEnd, {});
+  }
+
+  std::vector<char> bytes() const {
+    std::vector<char> Bytes(Words.size() * sizeof(uint32_t));
+    std::memcpy(Bytes.data(), Words.data(), Bytes.size());
+    return Bytes;
+  }
+
+  std::vector<uint32_t> Words;
+};
+
+// Exported A calls C, exported B is independent. Both A and B have a local id
+// with a name or a decoration.
+ModuleBuilder buildModule(bool WithEntryPointB = false) {
+  ModuleBuilder B;
+  B.add(OpCapability, {5 /* Linkage */});
+  B.add(OpMemoryModel, {2, 2});
+  if (WithEntryPointB) {
+    std::vector<uint32_t> Ops = {6 /* Kernel */, FuncB};
+    for (uint32_t W : ModuleBuilder::str("b"))
+      Ops.push_back(W);
+    B.add(OpEntryPoint, Ops);
+  }
+  B.add(OpName, {LocalB, ModuleBuilder::str("x")[0]});
+  B.addLinkage(FuncA, "a");
+  B.addLinkage(FuncB, "b");
+  B.add(OpDecorate, {LocalA, DecorationNoSignedWrap});
+  B.add(OpDecorate, {LocalB, DecorationNoSignedWrap});
+  B.add(OpTypeVoid, {Void});
+  B.add(OpTypeInt, {Int, 32, 0});
+  B.add(OpTypeFunction, {FnTy, Void});
+  B.add(OpConstant, {Int, One, 1});
+  B.addFunction(FuncC, 13, {});
+  B.addFunction(FuncA, 14,
+                {{OpIAdd, Int, LocalA, One, One},
+                 {OpFunctionCall, Void, 16, FuncC}});
+  B.addFunction(FuncB, 17, {{OpIAdd, Int, LocalB, One, One}});
+  return B;
+}
+
+struct Summary {
+  std::vector<uint32_t> Functions;
+  std::vector<uint32_t> AnnotationTargets;
+};
+
+Summary summarize(const std::vector<char> &Bytes) {
+  std::vector<uint32_t> Words(Bytes.size() / sizeof(uint32_t));
+  std::memcpy(Words.data(), Bytes.data(), Bytes.size());
+  Summary S;
+  for (size_t I = 5; I < Words.size(); I += Words[I] >> 16) {
+    uint32_t Opcode = Words[I] & 0xffff;
+    if (Opcode == OpFunction)
+      S.Functions.push_back(Words[I + 2]);
+    else if (Opcode == OpName || Opcode == OpDecorate)
+      S.AnnotationTargets.push_back(Words[I + 1]);
+  }
+  return S;
+}
+
+} // namespace
+
+TEST(SPIRVPruning, ExportedFunctionsAreListed) {
+  std::vector<std::string> Exports =
+      getSPIRVExportedFunctions(buildModule().bytes());
+  EXPECT_EQ(Exports, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(SPIRVPruning, UnreachableFunctionsAreRemoved) {
+  std::vector<char> Binary = buildModule().bytes();
+  ASSERT_TRUE(pruneSPIRVFunctions(Binary, {"a"}));
+
+  Summary S = summarize(Binary);
+  EXPECT_EQ(S.Functions, (std::vector<uint32_t>{FuncC, FuncA}));
+  // The name and the decorations of B and of its local id are gone.
+  EXPECT_EQ(S.AnnotationTargets, (std::vector<uint32_t>{FuncA, LocalA}));
+  EXPECT_EQ(getSPIRVExportedFunctions(Binary), std::vector<std::string>{"a"});
+}
+
+TEST(SPIRVPruning, CalleesOfRemovedFunctionsAreRemoved) {
+  std::vector<char> Binary = buildModule().bytes();
+  ASSERT_TRUE(pruneSPIRVFunctions(Binary, {"b", "not_in_module"}));
+
+  Summary S = summarize(Binary);
+  EXPECT_EQ(S.Functions, std::vector<uint32_t>{FuncB});
+  EXPECT_EQ(S.AnnotationTargets,
+            (std::vector<uint32_t>{LocalB, FuncB, LocalB}));
+}
+
+TEST(SPIRVPruning, EntryPointsAreKept) {
+  std::vector<char> Binary = buildModule(/*WithEntryPointB=*/true).bytes();
+  ASSERT_TRUE(pruneSPIRVFunctions(Binary, {"a"}));
+  EXPECT_EQ(summarize(Binary).Functions,
+            (std::vector<uint32_t>{FuncC, FuncA, FuncB}));
+}
+
+TEST(SPIRVPruning, ModuleIsUnchangedIfAllFunctionsAreUsed) {
+  std::vector<char> Binary = buildModule().bytes();
+  std::vector<char> Original = Binary;
+  ASSERT_TRUE(pruneSPIRVFunctions(Binary, {"a", "b"}));
+  EXPECT_EQ(Binary, Original);
+}
+
+TEST(SPIRVPruning, UnknownInstructionsStopPruning) {
+  ModuleBuilder B = buildModule();
+  // Insert an instruction the pruning doesn't know before the functions.
+  auto FirstFunction =
+      std::find(B.Words.begin(), B.Words.end(), OpFunction | (5u << 16));
+  B.Words.insert(FirstFunction, 0xffff | (1u << 16));
+  std::vector<char> Binary = B.bytes();
+  std::vector<char> Original = Binary;
+  EXPECT_FALSE(pruneSPIRVFunctions(Binary, {"a"}));
+  EXPECT_EQ(Binary, Original);
+
+  std::vector<char> NotSPIRV = {'B', 'C', 0x17, 0x0b};
+  EXPECT_FALSE(pruneSPIRVFunctions(NotSPIRV, {"a"}));
+}
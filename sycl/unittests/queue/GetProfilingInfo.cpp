@@ -18,8 +18,10 @@
 #include <helpers/MockKernelInfo.hpp>
 #include <helpers/PiImage.hpp>
 #include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
 #include <helpers/TestKernel.hpp>
 
+#include <detail/config.hpp>
 #include <detail/context_impl.hpp>
 
 class InfoTestKernel;
@@ -449,3 +451,120 @@ TEST(GetProfilingInfo, fallback_profiling_mock_piEnqueueKernelLaunch) {
   EXPECT_LT(submit_time, start_time);
   EXPECT_LT(submit_time, end_time);
 }
+
+static pi_queue MainQueue = nullptr;
+static pi_queue SampledProfilingQueue = nullptr;
+static size_t NumSampledKernels = 0;
+
+static pi_result redefinedQueueCreateAfter(pi_context, pi_device,
+                                           pi_queue_properties *Properties,
+                                           pi_queue *Queue) {
+  if (Properties[1] & PI_QUEUE_FLAG_PROFILING_ENABLE) {
+    EXPECT_EQ(SampledProfilingQueue, nullptr);
+    SampledProfilingQueue = *Queue;
+  } else {
+    MainQueue = *Queue;
+  }
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEnqueueKernelLaunchBefore(
+    pi_queue Queue, pi_kernel, pi_uint32, const size_t *, const size_t *,
+    const size_t *, pi_uint32, const pi_event *, pi_event *) {
+  if (Queue == SampledProfilingQueue)
+    ++NumSampledKernels;
+  return PI_SUCCESS;
+}
+
+TEST(GetProfilingInfo, sampled_profiling_without_enable_profiling) {
+  using namespace sycl;
+  unittest::ScopedEnvVar SampleRate{
+      "SYCL_PROFILING_SAMPLE_RATE", "2",
+      detail::SYCLConfig<detail::SYCL_PROFILING_SAMPLE_RATE>::reset};
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  Mock.redefineBefore<detail::PiApiKind::piEventGetProfilingInfo>(
+      redefinedPiEventGetProfilingInfo);
+  Mock.redefineAfter<detail::PiApiKind::piextQueueCreate>(
+      redefinedQueueCreateAfter);
+  Mock.redefineBefore<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunchBefore);
+  MainQueue = nullptr;
+  SampledProfilingQueue = nullptr;
+  NumSampledKernels = 0;
+
+  queue Queue{Plt.get_devices()[0]};
+  std::vector<event> Events;
+  for (int I = 0; I < 4; ++I)
+    Events.push_back(Queue.submit(
+        [&](handler &CGH) { CGH.single_task<TestKernel<>>([]() {}); }));
+  Queue.wait();
+
+  // Every second kernel goes to the profiling queue and has profiling info.
+  EXPECT_EQ(NumSampledKernels, 2u);
+  for (size_t I = 0; I < Events.size(); ++I) {
+    bool HasProfilingInfo = true;
+    try {
+      (void)Events[I].get_profiling_info<info::event_profiling::command_end>();
+    } catch (sycl::exception &) {
+      HasProfilingInfo = false;
+    }
+    EXPECT_EQ(HasProfilingInfo, I % 2 == 0);
+  }
+}
+
+// The number of events the barriers enqueued to either native queue wait for.
+static std::vector<pi_uint32> MainQueueBarriers;
+static std::vector<pi_uint32> SampledProfilingQueueBarriers;
+
+static pi_result redefinedEnqueueEventsWaitWithBarrierBefore(
+    pi_queue Queue, pi_uint32 NumEventsInWaitList, const pi_event *,
+    pi_event *) {
+  if (Queue == MainQueue)
+    MainQueueBarriers.push_back(NumEventsInWaitList);
+  else if (Queue == SampledProfilingQueue)
+    SampledProfilingQueueBarriers.push_back(NumEventsInWaitList);
+  return PI_SUCCESS;
+}
+
+TEST(GetProfilingInfo, sampled_profiling_barriers) {
+  using namespace sycl;
+  unittest::ScopedEnvVar SampleRate{
+      "SYCL_PROFILING_SAMPLE_RATE", "1",
+      detail::SYCLConfig<detail::SYCL_PROFILING_SAMPLE_RATE>::reset};
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  Mock.redefineAfter<detail::PiApiKind::piextQueueCreate>(
+      redefinedQueueCreateAfter);
+  Mock.redefineBefore<detail::PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      redefinedEnqueueEventsWaitWithBarrierBefore);
+  MainQueue = nullptr;
+  SampledProfilingQueue = nullptr;
+  MainQueueBarriers.clear();
+  SampledProfilingQueueBarriers.clear();
+
+  queue Queue{Plt.get_devices()[0]};
+  event KernelEvent = Queue.submit(
+      [&](handler &CGH) { CGH.single_task<TestKernel<>>([]() {}); });
+  ASSERT_NE(SampledProfilingQueue, nullptr);
+  // The new profiling queue waits for the commands of the main queue, which
+  // may include earlier barriers.
+  EXPECT_EQ(MainQueueBarriers, std::vector<pi_uint32>({0}));
+  EXPECT_EQ(SampledProfilingQueueBarriers, std::vector<pi_uint32>({1}));
+
+  // A barrier without a wait list covers the commands of both native queues
+  // and holds back later commands of both.
+  MainQueueBarriers.clear();
+  SampledProfilingQueueBarriers.clear();
+  Queue.ext_oneapi_submit_barrier();
+  EXPECT_EQ(MainQueueBarriers, std::vector<pi_uint32>({0, 2}));
+  EXPECT_EQ(SampledProfilingQueueBarriers, std::vector<pi_uint32>({0, 1}));
+
+  // A barrier with a wait list holds back later commands of both queues.
+  MainQueueBarriers.clear();
+  SampledProfilingQueueBarriers.clear();
+  Queue.ext_oneapi_submit_barrier({KernelEvent});
+  EXPECT_EQ(MainQueueBarriers, std::vector<pi_uint32>({1}));
+  EXPECT_EQ(SampledProfilingQueueBarriers, std::vector<pi_uint32>({1}));
+  Queue.wait();
+}
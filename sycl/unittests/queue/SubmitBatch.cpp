@@ -0,0 +1,81 @@
+//==---------- SubmitBatch.cpp --- queue::ext_oneapi_submit_batch tests ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <helpers/PiMock.hpp>
+#include <helpers/TestKernel.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace sycl;
+
+static size_t NumKernelLaunches = 0;
+
+static pi_result redefinedEnqueueKernelLaunchAfter(pi_queue, pi_kernel,
+                                                   pi_uint32, const size_t *,
+                                                   const size_t *,
+                                                   const size_t *, pi_uint32,
+                                                   const pi_event *,
+                                                   pi_event *) {
+  ++NumKernelLaunches;
+  return PI_SUCCESS;
+}
+
+static size_t NumBarriers = 0;
+
+static pi_result redefinedEnqueueEventsWaitWithBarrierAfter(pi_queue,
+                                                            pi_uint32,
+                                                            const pi_event *,
+                                                            pi_event *) {
+  ++NumBarriers;
+  return PI_SUCCESS;
+}
+
+static std::vector<std::function<void(handler &)>> makeBatch(size_t Size) {
+  std::vector<std::function<void(handler &)>> CGFs(
+      Size, [](handler &CGH) { CGH.single_task<TestKernel<>>([] {}); });
+  return CGFs;
+}
+
+TEST(SubmitBatch, InOrderQueue) {
+  unittest::PiMock Mock;
+  Mock.redefineAfter<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunchAfter);
+  Mock.redefineAfter<detail::PiApiKind::piEnqueueEventsWaitWithBarrier>(
+      redefinedEnqueueEventsWaitWithBarrierAfter);
+  NumKernelLaunches = 0;
+  NumBarriers = 0;
+
+  context Ctx{Mock.getPlatform()};
+  queue Queue{Ctx, default_selector_v, property::queue::in_order{}};
+
+  event Event = Queue.ext_oneapi_submit_batch(makeBatch(4));
+  EXPECT_EQ(NumKernelLaunches, 4u);
+  // The last command group of an in-order queue represents the whole batch,
+  // so no barrier is needed to join the events.
+  EXPECT_EQ(NumBarriers, 0u);
+  Event.wait();
+}
+
+TEST(SubmitBatch, OutOfOrderQueue) {
+  unittest::PiMock Mock;
+  Mock.redefineAfter<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunchAfter);
+  NumKernelLaunches = 0;
+
+  context Ctx{Mock.getPlatform()};
+  queue Queue{Ctx, default_selector_v};
+
+  event Event = Queue.ext_oneapi_submit_batch(makeBatch(4));
+  EXPECT_EQ(NumKernelLaunches, 4u);
+  Event.wait();
+
+  // An empty batch doesn't submit anything.
+  Queue.ext_oneapi_submit_batch({}).wait();
+  EXPECT_EQ(NumKernelLaunches, 4u);
+}
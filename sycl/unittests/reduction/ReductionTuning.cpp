@@ -0,0 +1,202 @@
+//==------------ ReductionTuning.cpp --- Reduction tuning unit tests -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/queue_impl.hpp>
+#include <detail/reduction_tuning.hpp>
+#include <gtest/gtest.h>
+#include <helpers/PiMock.hpp>
+#include <helpers/ScopedEnvVar.hpp>
+#include <helpers/TestKernel.hpp>
+#include <sycl/sycl.hpp>
+
+#include <map>
+#include <vector>
+
+using namespace sycl;
+
+TEST(ReductionTuning, FastestConfigWins) {
+  detail::ReductionTuning Tuning(3);
+  EXPECT_FALSE(Tuning.isTuned());
+  // Every configuration is tried twice in turn, the fastest run counts.
+  const uint64_t Times[][3] = {{300, 100, 400}, {200, 150, 50}};
+  for (unsigned Round = 0; Round < 2; ++Round) {
+    for (size_t Config = 0; Config < 3; ++Config) {
+      ASSERT_FALSE(Tuning.isTuned());
+      EXPECT_EQ(Tuning.getNextConfig(), Config);
+      EXPECT_EQ(Tuning.addTrial(Config, Times[Round][Config]),
+                Round == 1 && Config == 2);
+    }
+  }
+  ASSERT_TRUE(Tuning.isTuned());
+  EXPECT_EQ(Tuning.getWinner(), 2u);
+  // Late trials don't change the result.
+  EXPECT_FALSE(Tuning.addTrial(0, 1));
+  EXPECT_EQ(Tuning.getWinner(), 2u);
+}
+
+TEST(ReductionTuning, ConcurrentTrialsOfOneConfig) {
+  detail::ReductionTuning Tuning(2);
+  // Two trials of configuration 0 are enough, the next one is 1.
+  EXPECT_FALSE(Tuning.addTrial(0, 100));
+  EXPECT_EQ(Tuning.getNextConfig(), 1u);
+  EXPECT_FALSE(Tuning.addTrial(0, 100));
+  EXPECT_EQ(Tuning.getNextConfig(), 1u);
+  EXPECT_FALSE(Tuning.addTrial(1, 50));
+  EXPECT_EQ(Tuning.getNextConfig(), 1u);
+  EXPECT_TRUE(Tuning.addTrial(1, 60));
+  EXPECT_EQ(Tuning.getWinner(), 1u);
+}
+
+TEST(ReductionTuning, EarlierWinner) {
+  detail::ReductionTuning Tuning(3, /*Winner=*/1);
+  ASSERT_TRUE(Tuning.isTuned());
+  EXPECT_EQ(Tuning.getWinner(), 1u);
+  // A winner out of range, e.g. from a corrupted cache item, is ignored.
+  EXPECT_FALSE(detail::ReductionTuning(3, /*Winner=*/3).isTuned());
+}
+
+// The device time each kernel takes.
+static std::map<pi_event, uint64_t> KernelTimes;
+static uint64_t NextKernelTime = 0;
+static size_t NumProfiledKernels = 0;
+static pi_queue ProfilingQueue = nullptr;
+
+static pi_result redefinedQueueCreateAfter(pi_context, pi_device,
+                                           pi_queue_properties *Properties,
+                                           pi_queue *Queue) {
+  if (Properties[1] & PI_QUEUE_FLAG_PROFILING_ENABLE)
+    ProfilingQueue = *Queue;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEnqueueKernelLaunchAfter(
+    pi_queue Queue, pi_kernel, pi_uint32, const size_t *, const size_t *,
+    const size_t *, pi_uint32, const pi_event *, pi_event *Event) {
+  if (Queue == ProfilingQueue)
+    ++NumProfiledKernels;
+  if (Event)
+    KernelTimes[*Event] = NextKernelTime;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEventGetInfoAfter(pi_event, pi_event_info ParamName,
+                                            size_t, void *ParamValue,
+                                            size_t *) {
+  if (ParamName == PI_EVENT_INFO_COMMAND_EXECUTION_STATUS && ParamValue)
+    *static_cast<pi_event_status *>(ParamValue) = PI_EVENT_COMPLETE;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedEventGetProfilingInfo(pi_event Event,
+                                                pi_profiling_info ParamName,
+                                                size_t, void *ParamValue,
+                                                size_t *) {
+  const uint64_t Start = 1000;
+  if (ParamValue)
+    *static_cast<uint64_t *>(ParamValue) =
+        ParamName == PI_PROFILING_INFO_COMMAND_END ? Start + KernelTimes[Event]
+                                                   : Start;
+  return PI_SUCCESS;
+}
+
+class ReductionTunerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    Mock.redefineAfter<detail::PiApiKind::piextQueueCreate>(
+        redefinedQueueCreateAfter);
+    Mock.redefineAfter<detail::PiApiKind::piEnqueueKernelLaunch>(
+        redefinedEnqueueKernelLaunchAfter);
+    Mock.redefineAfter<detail::PiApiKind::piEventGetInfo>(
+        redefinedEventGetInfoAfter);
+    Mock.redefineBefore<detail::PiApiKind::piEventGetProfilingInfo>(
+        redefinedEventGetProfilingInfo);
+    KernelTimes.clear();
+    NumProfiledKernels = 0;
+    ProfilingQueue = nullptr;
+  }
+
+  // Runs a reduction with three configurations, configuration I takes
+  // Times[I]. Returns the configuration used.
+  size_t runReduction(queue &Q, const char *TypeName, const uint64_t *Times,
+                      bool &IsTrial) {
+    size_t Config = 0;
+    IsTrial = false;
+    std::shared_ptr<detail::queue_impl> QImpl = detail::getSyclObjImpl(Q);
+    detail::reduRunWithTunedConfig(
+        QImpl, TypeName, "plus", /*NWorkItems=*/1024, /*NumConfigs=*/3,
+        [&](size_t C, bool T) {
+          Config = C;
+          IsTrial = T;
+          NextKernelTime = Times[C];
+          return Q.single_task<TestKernel<>>([]() {});
+        });
+    return Config;
+  }
+
+  unittest::ScopedEnvVar AutoTune{
+      "SYCL_REDUCTION_AUTO_TUNE", "1",
+      detail::SYCLConfig<detail::SYCL_REDUCTION_AUTO_TUNE>::reset};
+  unittest::PiMock Mock;
+};
+
+TEST_F(ReductionTunerTest, TrialsDoNotBlock) {
+  queue Q{Mock.getPlatform().get_devices()[0],
+          property::queue::enable_profiling{}};
+  const uint64_t Times[] = {300, 100, 200};
+  std::vector<size_t> Configs;
+  std::vector<bool> Trials;
+  for (int I = 0; I < 10; ++I) {
+    bool IsTrial = false;
+    Configs.push_back(runReduction(Q, "TrialsDoNotBlock", Times, IsTrial));
+    Trials.push_back(IsTrial);
+  }
+  // Each completed trial is collected by the next submission, which then
+  // tries the next configuration. Once each one was tried twice, the fastest
+  // one is used.
+  EXPECT_EQ(Configs, std::vector<size_t>({0, 1, 2, 0, 1, 2, 1, 1, 1, 1}));
+  EXPECT_EQ(Trials, std::vector<bool>({true, true, true, true, true, true,
+                                       false, false, false, false}));
+}
+
+TEST_F(ReductionTunerTest, FailedTrialSubmission) {
+  queue Q{Mock.getPlatform().get_devices()[0],
+          property::queue::enable_profiling{}};
+  std::shared_ptr<detail::queue_impl> QImpl = detail::getSyclObjImpl(Q);
+  EXPECT_THROW(detail::reduRunWithTunedConfig(
+                   QImpl, "FailedTrialSubmission", "plus", 1024, 3,
+                   [](size_t, bool) -> event {
+                     throw sycl::exception(make_error_code(errc::runtime),
+                                           "Submission failed");
+                   }),
+               sycl::exception);
+
+  // The failed submission doesn't keep the tuning from going on.
+  const uint64_t Times[] = {300, 100, 200};
+  bool IsTrial = false;
+  EXPECT_EQ(runReduction(Q, "FailedTrialSubmission", Times, IsTrial), 0u);
+  EXPECT_TRUE(IsTrial);
+  EXPECT_EQ(runReduction(Q, "FailedTrialSubmission", Times, IsTrial), 1u);
+  EXPECT_TRUE(IsTrial);
+}
+
+TEST_F(ReductionTunerTest, TrialsAreSampled) {
+  // Without enable_profiling only the trials collect device timestamps.
+  queue Q{Mock.getPlatform().get_devices()[0]};
+  const uint64_t Times[] = {300, 100, 200};
+  bool IsTrial = false;
+  for (int I = 0; I < 6; ++I) {
+    runReduction(Q, "TrialsAreSampled", Times, IsTrial);
+    EXPECT_TRUE(IsTrial);
+  }
+  EXPECT_EQ(NumProfiledKernels, 6u);
+  EXPECT_EQ(runReduction(Q, "TrialsAreSampled", Times, IsTrial), 1u);
+  EXPECT_FALSE(IsTrial);
+  Q.single_task<TestKernel<>>([]() {});
+  EXPECT_EQ(NumProfiledKernels, 6u);
+}
@@ -0,0 +1,71 @@
+//==--------- DiscardReadOnlyHostPtr.cpp --- Scheduler unit tests ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SchedulerTest.hpp"
+#include "SchedulerTestUtils.hpp"
+
+#include <helpers/PiMock.hpp>
+
+using namespace sycl;
+
+static pi_result redefinedDeviceGetInfoAfter(pi_device Device,
+                                             pi_device_info ParamName,
+                                             size_t ParamValueSize,
+                                             void *ParamValue,
+                                             size_t *ParamValueSizeRet) {
+  if (ParamName == PI_DEVICE_INFO_HOST_UNIFIED_MEMORY) {
+    auto *Result = reinterpret_cast<pi_bool *>(ParamValue);
+    *Result = true;
+  }
+  return PI_SUCCESS;
+}
+
+static void *BufferHostPtr = nullptr;
+static pi_mem_flags BufferFlags = 0;
+static pi_result
+redefinedMemBufferCreate(pi_context context, pi_mem_flags flags, size_t size,
+                         void *host_ptr, pi_mem *ret_mem,
+                         const pi_mem_properties *properties = nullptr) {
+  BufferHostPtr = host_ptr;
+  BufferFlags = flags;
+  return PI_SUCCESS;
+}
+
+// A read-only user pointer should not be used to initialize the first
+// allocation if its contents are discarded.
+TEST_F(SchedulerTest, DiscardReadOnlyHostPtr) {
+  unittest::PiMock Mock;
+  Mock.redefineAfter<detail::PiApiKind::piDeviceGetInfo>(
+      redefinedDeviceGetInfoAfter);
+  Mock.redefineBefore<detail::PiApiKind::piMemBufferCreate>(
+      redefinedMemBufferCreate);
+  queue Q{Mock.getPlatform().get_devices()[0]};
+
+  const int Data[4] = {0, 1, 2, 3};
+  {
+    buffer<int, 1> Buf(Data, range<1>(4));
+    BufferHostPtr = reinterpret_cast<void *>(1);
+    Q.submit([&](handler &CGH) {
+       auto Acc = Buf.get_access<access::mode::discard_write>(CGH);
+       CGH.fill(Acc, 42);
+     }).wait();
+    EXPECT_EQ(BufferHostPtr, nullptr);
+    EXPECT_EQ(BufferFlags, PI_MEM_FLAGS_ACCESS_RW);
+  }
+  // The user pointer is still reused when the data is read.
+  {
+    buffer<int, 1> Buf(Data, range<1>(4));
+    int Result[4];
+    BufferHostPtr = nullptr;
+    Q.submit([&](handler &CGH) {
+       auto Acc = Buf.get_access<access::mode::read>(CGH);
+       CGH.copy(Acc, Result);
+     }).wait();
+    EXPECT_EQ(BufferHostPtr, Data);
+  }
+}
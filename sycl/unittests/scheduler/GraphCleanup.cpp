@@ -26,6 +26,8 @@ namespace {
 using namespace sycl;
 
 inline constexpr auto HostUnifiedMemoryName = "SYCL_HOST_UNIFIED_MEMORY";
+inline constexpr auto CleanupBatchSizeName =
+    "SYCL_EXECUTION_GRAPH_CLEANUP_BATCH_SIZE";
 
 int val;
 static pi_result redefinedEnqueueMemBufferMap(
@@ -310,6 +312,48 @@ TEST_F(SchedulerTest, HostTaskCleanup) {
   ASSERT_EQ(EventImpl->getCommand(), nullptr);
 }
 
+// Check that finished commands are accumulated and cleaned up in batches
+// when SYCL_EXECUTION_GRAPH_CLEANUP_BATCH_SIZE is set.
+TEST_F(SchedulerTest, BatchedPostEnqueueCleanup) {
+  unittest::ScopedEnvVar BatchSizeVar{
+      CleanupBatchSizeName, "3",
+      detail::SYCLConfig<
+          detail::SYCL_EXECUTION_GRAPH_CLEANUP_BATCH_SIZE>::reset};
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  context Ctx{Plt};
+  queue Queue{Ctx, default_selector_v};
+  detail::QueueImplPtr QueueImpl = detail::getSyclObjImpl(Queue);
+  MockScheduler MS;
+
+  size_t DeletedCmdsCount = 0;
+  std::function<void()> Callback = [&DeletedCmdsCount]() {
+    ++DeletedCmdsCount;
+  };
+  detail::Requirement MockReq = getMockRequirement();
+  auto EnqueueAndCleanup = [&]() {
+    MockCommand *Cmd =
+        new MockCommandWithCallback(QueueImpl, MockReq, Callback);
+    detail::EnqueueResultT Res;
+    std::vector<detail::Command *> ToCleanUp;
+    EXPECT_TRUE(Cmd->enqueue(Res, detail::NON_BLOCKING, ToCleanUp));
+    ASSERT_EQ(ToCleanUp.size(), 1u);
+    MS.cleanupCommands(ToCleanUp);
+  };
+
+  EnqueueAndCleanup();
+  EnqueueAndCleanup();
+  EXPECT_EQ(DeletedCmdsCount, 0u);
+  EnqueueAndCleanup();
+  EXPECT_EQ(DeletedCmdsCount, 3u);
+
+  // Leftovers are released on an explicit flush of the deferred commands.
+  EnqueueAndCleanup();
+  EXPECT_EQ(DeletedCmdsCount, 3u);
+  MS.cleanupCommands({});
+  EXPECT_EQ(DeletedCmdsCount, 4u);
+}
+
 struct AttachSchedulerWrapper {
   AttachSchedulerWrapper(MockScheduler *MSPtr) {
     sycl::detail::GlobalHandler::instance().attachScheduler(
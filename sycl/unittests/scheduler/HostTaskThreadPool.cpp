@@ -0,0 +1,48 @@
+//==------------ HostTaskThreadPool.cpp --- Scheduler unit tests -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/global_handler.hpp>
+#include <detail/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+using namespace sycl;
+
+TEST(HostTaskThreadPool, AllJobsAreExecuted) {
+  detail::ThreadPool Pool(/*ThreadCount=*/3);
+  constexpr size_t JobsCount = 1000;
+  std::atomic_size_t ExecutedJobsCount = 0;
+  for (size_t I = 0; I < JobsCount; ++I)
+    Pool.submit([&ExecutedJobsCount]() { ++ExecutedJobsCount; });
+  Pool.drain();
+  EXPECT_EQ(ExecutedJobsCount.load(), JobsCount);
+}
+
+// A job blocked on another job queued behind it must not deadlock the pool as
+// long as there is an idle worker that can take the other job.
+TEST(HostTaskThreadPool, IdleWorkerStealsJobs) {
+  detail::ThreadPool Pool(/*ThreadCount=*/2);
+  std::promise<void> Unblock;
+  std::shared_future<void> Unblocked = Unblock.get_future().share();
+  std::atomic_bool BlockedJobFinished = false;
+
+  // Jobs are distributed round-robin, so the blocked job and the job
+  // unblocking it land in the queue of the same worker.
+  Pool.submit([Unblocked, &BlockedJobFinished]() {
+    Unblocked.wait();
+    BlockedJobFinished = true;
+  });
+  Pool.submit([]() {});
+  Pool.submit([&Unblock]() { Unblock.set_value(); });
+
+  Pool.drain();
+  EXPECT_TRUE(BlockedJobFinished.load());
+}
@@ -0,0 +1,118 @@
+//==------ KernelArgShadow.cpp --- Check skipping of unchanged arguments ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <helpers/MockKernelInfo.hpp>
+#include <helpers/PiImage.hpp>
+#include <helpers/PiMock.hpp>
+#include <sycl/sycl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+class TestKernelWithArgs;
+
+struct KernelWithArgs {
+  int Value;
+  int *Ptr;
+
+  void operator()() const {}
+};
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+template <>
+struct KernelInfo<TestKernelWithArgs> : public unittest::MockKernelInfoBase {
+  static constexpr const char *getName() { return "TestKernelWithArgs"; }
+  static constexpr unsigned getNumParams() { return 2; }
+  static const detail::kernel_param_desc_t &getParamDesc(int Index) {
+    static detail::kernel_param_desc_t Desc[] = {
+        {detail::kernel_param_kind_t::kind_std_layout, sizeof(int),
+         offsetof(KernelWithArgs, Value)},
+        {detail::kernel_param_kind_t::kind_pointer, sizeof(int *),
+         offsetof(KernelWithArgs, Ptr)}};
+    return Desc[Index];
+  }
+  static constexpr uint32_t getKernelSize() { return sizeof(KernelWithArgs); }
+};
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+static sycl::unittest::PiImage generateImage() {
+  using namespace sycl::unittest;
+
+  PiPropertySet PropSet;
+
+  std::vector<unsigned char> Bin{0, 1, 2, 3, 4, 5}; // Random data
+
+  PiArray<PiOffloadEntry> Entries = makeEmptyKernels({"TestKernelWithArgs"});
+
+  PiImage Img{PI_DEVICE_BINARY_TYPE_SPIRV,            // Format
+              __SYCL_PI_DEVICE_BINARY_TARGET_SPIRV64, // DeviceTargetSpec
+              "",                                     // Compile options
+              "",                                     // Link options
+              std::move(Bin),
+              std::move(Entries),
+              std::move(PropSet)};
+
+  return Img;
+}
+
+static sycl::unittest::PiImage Img = generateImage();
+static sycl::unittest::PiImageArray<1> ImgArray{&Img};
+
+static size_t NumSetArgCalls = 0;
+static size_t NumSetArgPointerCalls = 0;
+
+static pi_result redefinedKernelSetArg(pi_kernel, pi_uint32, size_t,
+                                       const void *) {
+  ++NumSetArgCalls;
+  return PI_SUCCESS;
+}
+
+static pi_result redefinedKernelSetArgPointer(pi_kernel, pi_uint32, size_t,
+                                              const void *) {
+  ++NumSetArgPointerCalls;
+  return PI_SUCCESS;
+}
+
+TEST(KernelArgShadow, UnchangedArgumentsAreNotSetAgain) {
+  sycl::unittest::PiMock Mock;
+  sycl::platform Plt = Mock.getPlatform();
+  Mock.redefineBefore<sycl::detail::PiApiKind::piKernelSetArg>(
+      redefinedKernelSetArg);
+  Mock.redefineBefore<sycl::detail::PiApiKind::piextKernelSetArgPointer>(
+      redefinedKernelSetArgPointer);
+  NumSetArgCalls = 0;
+  NumSetArgPointerCalls = 0;
+
+  sycl::queue Queue{Plt.get_devices()[0]};
+  int Data[2] = {0, 0};
+  auto Launch = [&](int Value, int *Ptr) {
+    Queue.single_task<TestKernelWithArgs>(KernelWithArgs{Value, Ptr}).wait();
+  };
+
+  Launch(1, &Data[0]);
+  EXPECT_EQ(NumSetArgCalls, 1u);
+  EXPECT_EQ(NumSetArgPointerCalls, 1u);
+
+  Launch(1, &Data[0]);
+  EXPECT_EQ(NumSetArgCalls, 1u);
+  EXPECT_EQ(NumSetArgPointerCalls, 1u);
+
+  // Only the argument which changed is set.
+  Launch(1, &Data[1]);
+  EXPECT_EQ(NumSetArgCalls, 1u);
+  EXPECT_EQ(NumSetArgPointerCalls, 2u);
+
+  Launch(2, &Data[1]);
+  EXPECT_EQ(NumSetArgCalls, 2u);
+  EXPECT_EQ(NumSetArgPointerCalls, 2u);
+}
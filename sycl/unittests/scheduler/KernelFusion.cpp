@@ -9,6 +9,7 @@
 #include "SchedulerTest.hpp"
 #include "SchedulerTestUtils.hpp"
 
+#include <detail/config.hpp>
 #include <helpers/PiMock.hpp>
 #include <helpers/ScopedEnvVar.hpp>
 #include <helpers/TestKernel.hpp>
@@ -148,3 +149,230 @@ TEST_F(SchedulerTest, CancelKernelFusion) {
   EXPECT_TRUE(dependsOnViaEvent(placeHolderCmd, fusionCmd4));
   EXPECT_TRUE(dependsOnViaEvent(placeHolderCmd, fusionCmd1));
 }
+
+TEST_F(SchedulerTest, AsyncFusionRunsKernelsUnfused) {
+  unittest::ScopedEnvVar AsyncFusion{
+      "SYCL_ENABLE_ASYNC_FUSION", "1",
+      detail::SYCLConfig<detail::SYCL_ENABLE_ASYNC_FUSION>::reset};
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (!CheckTestExecRequirements(Plt))
+    return;
+
+  queue QueueDev(context(Plt), default_selector_v);
+  MockScheduler MS;
+
+  detail::QueueImplPtr QueueDevImpl = detail::getSyclObjImpl(QueueDev);
+
+  buffer<int, 1> b1{range<1>{4}};
+  buffer<int, 1> b2{range<1>{4}};
+
+  auto *nonFusionCmd = CreateTaskCommand(MS, QueueDevImpl, b1);
+
+  MS.startFusion(QueueDevImpl);
+
+  auto *fusionCmd1 = CreateTaskCommand(MS, QueueDevImpl, b1);
+  auto *fusionCmd2 = CreateTaskCommand(MS, QueueDevImpl, b1);
+  auto *fusionCmd3 = CreateTaskCommand(MS, QueueDevImpl, b2);
+
+  // The first time a fusion is seen, its fused kernel is only started to be
+  // compiled in the background. Completing the fusion doesn't wait for it, but
+  // enqueues the kernels unfused as if the fusion was cancelled.
+  std::vector<detail::Command *> ToEnqueue;
+  EventImplPtr FusionEvent = MS.completeFusion(QueueDevImpl, ToEnqueue);
+
+  EXPECT_EQ(ToEnqueue.size(), 4u);
+  EXPECT_TRUE(containsCommand(fusionCmd1, ToEnqueue));
+  EXPECT_TRUE(containsCommand(fusionCmd2, ToEnqueue));
+  EXPECT_TRUE(containsCommand(fusionCmd3, ToEnqueue));
+
+  // The kernels keep their dependencies on each other and on the commands
+  // submitted before the fusion.
+  EXPECT_TRUE(dependsOnViaDep(fusionCmd1, nonFusionCmd));
+  EXPECT_EQ(fusionCmd1->MDeps.size(), 1u);
+  EXPECT_TRUE(dependsOnViaDep(fusionCmd2, fusionCmd1));
+  EXPECT_EQ(fusionCmd2->MDeps.size(), 1u);
+  EXPECT_TRUE(fusionCmd3->MDeps.empty());
+
+  // The event returned for the fusion is the one of the placeholder command,
+  // which completes with all of the kernels.
+  auto FusionCmdIt = std::find_if(
+      ToEnqueue.begin(), ToEnqueue.end(), [](detail::Command *Cmd) {
+        return Cmd->getType() == sycl::_V1::detail::Command::FUSION;
+      });
+  ASSERT_NE(FusionCmdIt, ToEnqueue.end());
+  auto *placeHolderCmd =
+      static_cast<detail::KernelFusionCommand *>(*FusionCmdIt);
+  EXPECT_EQ(FusionEvent, placeHolderCmd->getEvent());
+  EXPECT_EQ(placeHolderCmd->getPreparedDepsEvents().size(), 3u);
+  EXPECT_TRUE(dependsOnViaEvent(placeHolderCmd, fusionCmd1));
+  EXPECT_TRUE(dependsOnViaEvent(placeHolderCmd, fusionCmd2));
+  EXPECT_TRUE(dependsOnViaEvent(placeHolderCmd, fusionCmd3));
+
+  // The kernels still have commands of their own, so their events aren't
+  // redirected to a fused kernel.
+  EXPECT_EQ(fusionCmd1->getEvent()->getCommand(), fusionCmd1);
+  EXPECT_EQ(fusionCmd2->getEvent()->getCommand(), fusionCmd2);
+  EXPECT_EQ(fusionCmd3->getEvent()->getCommand(), fusionCmd3);
+}
+
+// Submits a kernel accessing the buffer the way Scheduler::addCG does with
+// SYCL_ENABLE_AUTO_FUSION.
+template <typename T, int Dim>
+detail::Command *
+CreateAutoFusionTaskCommand(MockScheduler &MS, detail::QueueImplPtr DevQueue,
+                            buffer<T, Dim> &buf, bool IsCandidate,
+                            std::vector<detail::Command *> &ToEnqueue) {
+  MockHandlerCustomFinalize MockCGH(DevQueue, false);
+
+  auto acc = buf.get_access(static_cast<sycl::handler &>(MockCGH));
+
+  kernel_bundle KernelBundle =
+      sycl::get_kernel_bundle<sycl::bundle_state::input>(
+          DevQueue->get_context());
+  auto ExecBundle = sycl::build(KernelBundle);
+  MockCGH.use_kernel_bundle(ExecBundle);
+  MockCGH.single_task<TestKernel<>>([] {});
+
+  auto CmdGrp = MockCGH.finalize();
+  MS.prepareAutomaticFusion(*CmdGrp, IsCandidate, DevQueue, ToEnqueue);
+  return MS.addCG(std::move(CmdGrp), DevQueue, ToEnqueue);
+}
+
+TEST_F(SchedulerTest, AutomaticFusionCollectsChains) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (!CheckTestExecRequirements(Plt))
+    return;
+
+  queue QueueDev(context(Plt), default_selector_v);
+  MockScheduler MS;
+
+  detail::QueueImplPtr QueueDevImpl = detail::getSyclObjImpl(QueueDev);
+
+  buffer<int, 1> b1{range<1>{4}};
+  buffer<int, 1> b2{range<1>{4}};
+
+  // Two kernels passing data through the same buffer are collected in one
+  // fusion without being enqueued.
+  std::vector<detail::Command *> ToEnqueue;
+  auto *Cmd1 = CreateAutoFusionTaskCommand(MS, QueueDevImpl, b1,
+                                           /*IsCandidate=*/true, ToEnqueue);
+  auto *Cmd2 = CreateAutoFusionTaskCommand(MS, QueueDevImpl, b1,
+                                           /*IsCandidate=*/true, ToEnqueue);
+  EXPECT_TRUE(ToEnqueue.empty());
+  EXPECT_TRUE(MS.isInAutomaticFusion(QueueDevImpl));
+  auto *FusionCmd = static_cast<detail::ExecCGCommand *>(Cmd1)->MFusionCmd;
+  ASSERT_NE(FusionCmd, nullptr);
+  EXPECT_EQ(static_cast<detail::ExecCGCommand *>(Cmd2)->MFusionCmd, FusionCmd);
+  EXPECT_EQ(FusionCmd->getFusionList().size(), 2u);
+
+  // Commands not using the buffers of the fusion don't complete it.
+  MS.completeAutomaticFusions({detail::getSyclObjImpl(b2).get()}, ToEnqueue);
+  EXPECT_TRUE(ToEnqueue.empty());
+  EXPECT_TRUE(MS.isInAutomaticFusion(QueueDevImpl));
+
+  MS.cancelFusion(QueueDevImpl, ToEnqueue);
+  EXPECT_TRUE(containsCommand(Cmd1, ToEnqueue));
+  EXPECT_TRUE(containsCommand(Cmd2, ToEnqueue));
+}
+
+TEST_F(SchedulerTest, AutomaticFusionSkipsSingleKernels) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (!CheckTestExecRequirements(Plt))
+    return;
+
+  queue QueueDev(context(Plt), default_selector_v);
+  MockScheduler MS;
+
+  detail::QueueImplPtr QueueDevImpl = detail::getSyclObjImpl(QueueDev);
+
+  buffer<int, 1> b1{range<1>{4}};
+
+  std::vector<detail::Command *> ToEnqueue;
+  auto *FusionCandidate = CreateAutoFusionTaskCommand(
+      MS, QueueDevImpl, b1, /*IsCandidate=*/true, ToEnqueue);
+  EXPECT_TRUE(ToEnqueue.empty());
+  EXPECT_TRUE(MS.isInAutomaticFusion(QueueDevImpl));
+
+  // A command which can't be fused ends the fusion. Fusing a single kernel
+  // isn't worth the JIT compilation, so it is enqueued unfused before the
+  // new command.
+  auto *NonCandidate = CreateAutoFusionTaskCommand(
+      MS, QueueDevImpl, b1, /*IsCandidate=*/false, ToEnqueue);
+  EXPECT_FALSE(MS.isInAutomaticFusion(QueueDevImpl));
+  EXPECT_TRUE(containsCommand(FusionCandidate, ToEnqueue));
+  EXPECT_TRUE(dependsOnViaDep(NonCandidate, FusionCandidate));
+}
+
+static bool EventsWaitCalled = false;
+static pi_result redefinedEventsWait(pi_uint32, const pi_event *) {
+  EventsWaitCalled = true;
+  return PI_SUCCESS;
+}
+
+TEST_F(SchedulerTest, EventOfFusedKernelWaitsForFusedKernel) {
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  queue QueueDev(context(Plt), default_selector_v);
+  detail::QueueImplPtr QueueDevImpl = detail::getSyclObjImpl(QueueDev);
+  EventsWaitCalled = false;
+  Mock.redefineBefore<detail::PiApiKind::piEventsWait>(redefinedEventsWait);
+
+  // Completing a fusion replaces the commands of the kernels in the fusion
+  // list, their events are left without a command or native handle.
+  auto KernelEvent = std::make_shared<detail::event_impl>(std::nullopt);
+  auto FusedEvent = std::make_shared<detail::event_impl>(QueueDevImpl);
+  FusedEvent->setContextImpl(QueueDevImpl->getContextImplPtr());
+  pi_event PIEvent = nullptr;
+  ASSERT_EQ(mock_piEventCreate(/*pi_context=*/0x0, &PIEvent), PI_SUCCESS);
+  FusedEvent->getHandleRef() = PIEvent;
+  KernelEvent->attachEventToComplete(FusedEvent);
+
+  KernelEvent->wait(KernelEvent);
+  EXPECT_TRUE(EventsWaitCalled);
+}
+
+static size_t KernelLaunchCounter = 0;
+static pi_result redefinedEnqueueKernelLaunch(pi_queue, pi_kernel, pi_uint32,
+                                              const size_t *, const size_t *,
+                                              const size_t *, pi_uint32,
+                                              const pi_event *, pi_event *) {
+  ++KernelLaunchCounter;
+  return PI_SUCCESS;
+}
+
+TEST_F(SchedulerTest, WaitingForKernelCompletesAutomaticFusion) {
+  unittest::ScopedEnvVar AutoFusion{
+      "SYCL_ENABLE_AUTO_FUSION", "1",
+      detail::SYCLConfig<detail::SYCL_ENABLE_AUTO_FUSION>::reset};
+  unittest::PiMock Mock;
+  platform Plt = Mock.getPlatform();
+  if (!CheckTestExecRequirements(Plt))
+    return;
+  KernelLaunchCounter = 0;
+  Mock.redefineBefore<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunch);
+
+  queue QueueDev(context(Plt), default_selector_v,
+                 property::queue::in_order{});
+  buffer<int, 1> Buf{range<1>{4}};
+
+  // Two kernels passing data through a buffer on an in-order queue are
+  // collected in an automatic fusion and not enqueued yet.
+  auto SubmitKernel = [&] {
+    return QueueDev.submit([&](handler &CGH) {
+      auto Acc = Buf.get_access<access::mode::read_write>(CGH);
+      CGH.single_task<TestKernel<>>([=] { (void)Acc; });
+    });
+  };
+  event FirstKernel = SubmitKernel();
+  SubmitKernel();
+  EXPECT_EQ(KernelLaunchCounter, 0u);
+
+  // Waiting for one of the kernels completes the fusion. The fused kernel
+  // can't be JIT compiled here, so both kernels are enqueued unfused.
+  FirstKernel.wait();
+  EXPECT_EQ(KernelLaunchCounter, 2u);
+}
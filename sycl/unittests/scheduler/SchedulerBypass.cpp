@@ -0,0 +1,108 @@
+//==------------ SchedulerBypass.cpp --- Scheduler unit tests --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SchedulerTest.hpp"
+#include "SchedulerTestUtils.hpp"
+
+#include <helpers/PiMock.hpp>
+#include <helpers/TestKernel.hpp>
+
+#include <detail/event_impl.hpp>
+#include <detail/queue_impl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace sycl;
+
+static std::vector<std::vector<pi_event>> LaunchWaitLists;
+
+static pi_result redefinedEnqueueKernelLaunchAfter(
+    pi_queue, pi_kernel, pi_uint32, const size_t *, const size_t *,
+    const size_t *, pi_uint32 NumEventsInWaitList,
+    const pi_event *EventWaitList, pi_event *) {
+  LaunchWaitLists.emplace_back(EventWaitList,
+                               EventWaitList + NumEventsInWaitList);
+  return PI_SUCCESS;
+}
+
+TEST_F(SchedulerTest, BypassWithNativeEventDeps) {
+  sycl::unittest::PiMock Mock;
+  sycl::platform Plt = Mock.getPlatform();
+  Mock.redefineAfter<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunchAfter);
+  LaunchWaitLists.clear();
+
+  context Ctx{Plt};
+  queue Queue{Ctx, default_selector_v};
+
+  event FirstEvent = Queue.single_task<TestKernel<>>([] {});
+  detail::EventImplPtr FirstEventImpl = detail::getSyclObjImpl(FirstEvent);
+  ASSERT_NE(FirstEventImpl->getHandleRef(), nullptr);
+
+  EXPECT_TRUE(detail::Scheduler::areEventsSafeForSchedulerBypass(
+      {FirstEventImpl}, detail::getSyclObjImpl(Ctx)));
+
+  event SecondEvent = Queue.submit([&](handler &CGH) {
+    CGH.depends_on(FirstEvent);
+    CGH.single_task<TestKernel<>>([] {});
+  });
+
+  // The second kernel must not be added to the graph, but it still has to
+  // receive the native event of the first one.
+  EXPECT_EQ(detail::getSyclObjImpl(SecondEvent)->getCommand(), nullptr);
+  ASSERT_EQ(LaunchWaitLists.size(), 2u);
+  ASSERT_EQ(LaunchWaitLists[1].size(), 1u);
+  EXPECT_EQ(LaunchWaitLists[1][0], FirstEventImpl->getHandleRef());
+}
+
+TEST_F(SchedulerTest, NoBypassWithUnsafeEventDeps) {
+  sycl::unittest::PiMock Mock;
+  sycl::platform Plt = Mock.getPlatform();
+
+  context Ctx{Plt};
+  context OtherCtx{Plt};
+  queue OtherQueue{OtherCtx, default_selector_v};
+  detail::ContextImplPtr CtxImpl = detail::getSyclObjImpl(Ctx);
+
+  // Throwaway events don't represent actual dependencies.
+  auto DefaultEvent = std::make_shared<detail::event_impl>();
+  EXPECT_TRUE(detail::Scheduler::areEventsSafeForSchedulerBypass(
+      {DefaultEvent}, CtxImpl));
+
+  // Incomplete host events can only be satisfied by waiting on them.
+  auto HostEvent = std::make_shared<detail::event_impl>(
+      detail::Scheduler::getInstance().getDefaultHostQueue());
+  EXPECT_FALSE(
+      detail::Scheduler::areEventsSafeForSchedulerBypass({HostEvent}, CtxImpl));
+
+  // Native events of a different context can't be passed to the backend.
+  event OtherEvent = OtherQueue.single_task<TestKernel<>>([] {});
+  EXPECT_FALSE(detail::Scheduler::areEventsSafeForSchedulerBypass(
+      {detail::getSyclObjImpl(OtherEvent)}, CtxImpl));
+}
+
+TEST_F(SchedulerTest, BypassForUSMCommandsInOrderQueue) {
+  sycl::unittest::PiMock Mock;
+  sycl::platform Plt = Mock.getPlatform();
+
+  context Ctx{Plt};
+  queue Queue{Ctx, default_selector_v, property::queue::in_order{}};
+  int Src = 0, Dst = 0;
+
+  // USM commands only depend on the previous native event of the queue, so
+  // they are enqueued without involving the scheduler.
+  event CopyEvent = Queue.submit(
+      [&](handler &CGH) { CGH.memcpy(&Dst, &Src, sizeof(int)); });
+  event FillEvent =
+      Queue.submit([&](handler &CGH) { CGH.memset(&Dst, 0, sizeof(int)); });
+  EXPECT_EQ(detail::getSyclObjImpl(CopyEvent)->getCommand(), nullptr);
+  EXPECT_EQ(detail::getSyclObjImpl(FillEvent)->getCommand(), nullptr);
+  EXPECT_NE(detail::getSyclObjImpl(FillEvent)->getHandleRef(), nullptr);
+}
@@ -207,6 +207,31 @@ public:
                     std::vector<sycl::detail::Command *> &ToEnqueue) {
     MGraphBuilder.cancelFusion(Queue, ToEnqueue);
   }
+
+  sycl::detail::EventImplPtr
+  completeFusion(sycl::detail::QueueImplPtr Queue,
+                 std::vector<sycl::detail::Command *> &ToEnqueue,
+                 const sycl::property_list &PropList = {}) {
+    return MGraphBuilder.completeFusion(Queue, ToEnqueue, PropList);
+  }
+
+  void prepareAutomaticFusion(sycl::detail::CG &CommandGroup, bool IsCandidate,
+                              const sycl::detail::QueueImplPtr &Queue,
+                              std::vector<sycl::detail::Command *> &ToEnqueue) {
+    MGraphBuilder.prepareAutomaticFusion(CommandGroup, IsCandidate, Queue,
+                                         ToEnqueue);
+  }
+
+  void completeAutomaticFusions(
+      const std::vector<sycl::detail::SYCLMemObjI *> &MemObjs,
+      std::vector<sycl::detail::Command *> &ToEnqueue) {
+    MGraphBuilder.completeAutomaticFusions(MemObjs, ToEnqueue);
+  }
+
+  bool isInAutomaticFusion(const sycl::detail::QueueImplPtr &Queue) {
+    return MGraphBuilder.isInAutomaticFusion(
+        std::hash<sycl::detail::queue_impl *>()(Queue.get()));
+  }
 };
 
 void addEdge(sycl::detail::Command *User, sycl::detail::Command *Dep,
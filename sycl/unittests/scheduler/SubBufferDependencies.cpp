@@ -0,0 +1,65 @@
+//==--------- SubBufferDependencies.cpp --- Scheduler unit tests -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SchedulerTest.hpp"
+#include "SchedulerTestUtils.hpp"
+
+#include <helpers/PiMock.hpp>
+
+#include <detail/event_impl.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace sycl;
+
+static std::vector<std::vector<pi_event>> FillWaitLists;
+
+static pi_result redefinedEnqueueMemBufferFillAfter(
+    pi_queue, pi_mem, const void *, size_t, size_t, size_t,
+    pi_uint32 NumEventsInWaitList, const pi_event *EventWaitList, pi_event *) {
+  FillWaitLists.emplace_back(EventWaitList,
+                             EventWaitList + NumEventsInWaitList);
+  return PI_SUCCESS;
+}
+
+static bool waitsFor(const std::vector<pi_event> &WaitList, const event &E) {
+  pi_event Handle = detail::getSyclObjImpl(E)->getHandleRef();
+  return std::find(WaitList.begin(), WaitList.end(), Handle) != WaitList.end();
+}
+
+// Commands writing to disjoint sub-buffers of a buffer must not depend on each
+// other.
+TEST_F(SchedulerTest, SubBufferDependencies) {
+  unittest::PiMock Mock;
+  Mock.redefineAfter<detail::PiApiKind::piEnqueueMemBufferFill>(
+      redefinedEnqueueMemBufferFillAfter);
+  FillWaitLists.clear();
+  queue Q{Mock.getPlatform().get_devices()[0]};
+
+  buffer<int, 1> Buf(range<1>(192));
+  buffer<int, 1> First(Buf, id<1>(0), range<1>(64));
+  buffer<int, 1> Second(Buf, id<1>(64), range<1>(64));
+  buffer<int, 1> Overlapping(Buf, id<1>(32), range<1>(64));
+
+  auto Fill = [&](buffer<int, 1> &SubBuf) {
+    return Q.submit([&](handler &CGH) {
+      auto Acc = SubBuf.get_access<access::mode::write>(CGH);
+      CGH.fill(Acc, 42);
+    });
+  };
+
+  event FirstEvent = Fill(First);
+  event SecondEvent = Fill(Second);
+  Fill(Overlapping);
+
+  ASSERT_EQ(FillWaitLists.size(), 3u);
+  EXPECT_FALSE(waitsFor(FillWaitLists[1], FirstEvent));
+  EXPECT_TRUE(waitsFor(FillWaitLists[2], FirstEvent));
+  EXPECT_TRUE(waitsFor(FillWaitLists[2], SecondEvent));
+}
@@ -0,0 +1,149 @@
+//==------- BinaryTrace.cpp --- sycl-prof binary trace unit test ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "binary_writer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using Event = std::tuple<bool, std::string, std::string, size_t, size_t,
+                         size_t>;
+
+/// Keeps the events replayed by convertBinaryTrace.
+class RecordingWriter : public Writer {
+public:
+  void init() final { ++NumInits; }
+  void finalize() final { ++NumFinalizes; }
+
+  void writeBegin(std::string_view Name, std::string_view Category, size_t PID,
+                  size_t TID, size_t TimeStamp) override {
+    Events.emplace_back(true, Name, Category, PID, TID, TimeStamp);
+  }
+
+  void writeEnd(std::string_view Name, std::string_view Category, size_t PID,
+                size_t TID, size_t TimeStamp) override {
+    Events.emplace_back(false, Name, Category, PID, TID, TimeStamp);
+  }
+
+  std::vector<Event> Events;
+  int NumInits = 0;
+  int NumFinalizes = 0;
+};
+
+class BinaryTraceTest : public ::testing::Test {
+protected:
+  void TearDown() override { std::remove(TracePath); }
+
+  const char *TracePath = "sycl_prof_trace.bin";
+};
+
+TEST_F(BinaryTraceTest, RoundTrip) {
+  constexpr size_t NumThreads = 4;
+  // More events than fit in a thread's ring buffer.
+  constexpr size_t NumEvents = 20000;
+
+  {
+    BinaryWriter Out(TracePath);
+    Out.init();
+    std::vector<std::thread> Threads;
+    for (size_t TID = 0; TID < NumThreads; ++TID)
+      Threads.emplace_back([&Out, TID] {
+        for (size_t I = 0; I < NumEvents; ++I) {
+          // A temporary name, the writer has to keep its own copy.
+          std::string Name = "kernel" + std::to_string(I % 3);
+          Out.writeBegin(Name, "task", 1, TID, 2 * I);
+          Out.writeEnd(Name, "task", 1, TID, 2 * I + 1);
+        }
+      });
+    for (std::thread &T : Threads)
+      T.join();
+    Out.finalize();
+  }
+
+  RecordingWriter In;
+  ASSERT_TRUE(convertBinaryTrace(TracePath, In));
+  EXPECT_EQ(In.NumInits, 1);
+  EXPECT_EQ(In.NumFinalizes, 1);
+  ASSERT_EQ(In.Events.size(), NumThreads * NumEvents * 2);
+
+  // Chunks of different threads may interleave, but the events of each
+  // thread keep their order.
+  std::vector<size_t> NextEvent(NumThreads, 0);
+  for (const Event &E : In.Events) {
+    const auto &[IsBegin, Name, Category, PID, TID, TimeStamp] = E;
+    ASSERT_LT(TID, NumThreads);
+    const size_t Index = NextEvent[TID]++;
+    EXPECT_EQ(IsBegin, Index % 2 == 0);
+    EXPECT_EQ(Name, "kernel" + std::to_string(Index / 2 % 3));
+    EXPECT_EQ(Category, "task");
+    EXPECT_EQ(PID, 1u);
+    EXPECT_EQ(TimeStamp, Index);
+  }
+  for (size_t Count : NextEvent)
+    EXPECT_EQ(Count, NumEvents * 2);
+}
+
+TEST_F(BinaryTraceTest, EmptyTrace) {
+  {
+    BinaryWriter Out(TracePath);
+    Out.init();
+  }
+
+  RecordingWriter In;
+  ASSERT_TRUE(convertBinaryTrace(TracePath, In));
+  EXPECT_TRUE(In.Events.empty());
+}
+
+TEST_F(BinaryTraceTest, RejectsMalformedTrace) {
+  RecordingWriter In;
+  // Missing file.
+  EXPECT_FALSE(convertBinaryTrace(TracePath, In));
+
+  {
+    BinaryWriter Out(TracePath);
+    Out.init();
+    Out.writeBegin("kernel", "task", 1, 1, 0);
+  }
+  std::string Trace;
+  {
+    std::ifstream File(TracePath, std::ios::binary);
+    Trace.assign(std::istreambuf_iterator<char>(File), {});
+  }
+
+  // A record cut in the middle.
+  {
+    std::ofstream File(TracePath, std::ios::binary | std::ios::trunc);
+    File.write(Trace.data(), Trace.size() - 1);
+  }
+  EXPECT_FALSE(convertBinaryTrace(TracePath, In));
+
+  // A record referring to a string that isn't in the trace.
+  {
+    std::ofstream File(TracePath, std::ios::binary | std::ios::trunc);
+    File.write(BinaryTraceMagic, sizeof(BinaryTraceMagic));
+    File.write(reinterpret_cast<const char *>(&BinaryTraceVersion),
+               sizeof(BinaryTraceVersion));
+    const BinaryChunkKind Kind = BinaryChunkKind::Events;
+    const uint32_t Size = 1;
+    const BinaryEventRecord Record{0, 1, 1, 0, 0, BinaryEventKind::Begin};
+    File.write(reinterpret_cast<const char *>(&Kind), sizeof(Kind));
+    File.write(reinterpret_cast<const char *>(&Size), sizeof(Size));
+    File.write(reinterpret_cast<const char *>(&Record), sizeof(Record));
+  }
+  EXPECT_FALSE(convertBinaryTrace(TracePath, In));
+}
+
+} // namespace
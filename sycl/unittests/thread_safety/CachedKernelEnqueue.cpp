@@ -0,0 +1,96 @@
+//==-------- CachedKernelEnqueue.cpp --- Thread safety unit tests ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/context_impl.hpp>
+#include <gtest/gtest.h>
+#include <helpers/PiMock.hpp>
+#include <helpers/TestKernel.hpp>
+#include <sycl/sycl.hpp>
+
+#include "ThreadUtils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
+namespace {
+using namespace sycl;
+
+constexpr std::size_t ThreadCount = 4;
+
+std::mutex LaunchMutex;
+std::condition_variable LaunchCV;
+std::size_t LaunchesInFlight = 0;
+std::size_t MaxLaunchesInFlight = 0;
+std::set<pi_kernel> LaunchedKernels;
+std::size_t KernelsCreated = 0;
+std::size_t KernelsReleased = 0;
+
+pi_result redefinedKernelCreate(pi_program, const char *, pi_kernel *) {
+  ++KernelsCreated;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedKernelRelease(pi_kernel) {
+  ++KernelsReleased;
+  return PI_SUCCESS;
+}
+
+pi_result redefinedEnqueueKernelLaunch(pi_queue, pi_kernel Kernel, pi_uint32,
+                                       const size_t *, const size_t *,
+                                       const size_t *, pi_uint32,
+                                       const pi_event *, pi_event *) {
+  std::unique_lock<std::mutex> Lock(LaunchMutex);
+  LaunchedKernels.insert(Kernel);
+  ++LaunchesInFlight;
+  MaxLaunchesInFlight = std::max(MaxLaunchesInFlight, LaunchesInFlight);
+  LaunchCV.notify_all();
+  // Launches serialized by the runtime never get here at the same time, the
+  // timeout keeps the test from hanging then.
+  LaunchCV.wait_for(Lock, std::chrono::seconds(10), [] {
+    return MaxLaunchesInFlight == ThreadCount;
+  });
+  --LaunchesInFlight;
+  return PI_SUCCESS;
+}
+
+TEST(KernelEnqueue, CachedKernelIsLaunchedConcurrently) {
+  unittest::PiMock Mock;
+  Mock.redefineBefore<detail::PiApiKind::piEnqueueKernelLaunch>(
+      redefinedEnqueueKernelLaunch);
+  Mock.redefineBefore<detail::PiApiKind::piKernelCreate>(
+      redefinedKernelCreate);
+  Mock.redefineBefore<detail::PiApiKind::piKernelRelease>(
+      redefinedKernelRelease);
+
+  platform Plt = Mock.getPlatform();
+  queue Q{Plt.get_devices()[0]};
+  // Build and cache the kernel before the threads race for it.
+  Q.single_task<TestKernel<>>([] {}).wait();
+  MaxLaunchesInFlight = 0;
+  LaunchedKernels.clear();
+  KernelsCreated = 0;
+
+  auto TestLambda = [&](std::size_t) {
+    Q.single_task<TestKernel<>>([] {}).wait();
+  };
+  { ThreadPool Pool(ThreadCount, TestLambda); }
+
+  EXPECT_EQ(MaxLaunchesInFlight, ThreadCount);
+  // Each concurrent launch uses its own native handle.
+  EXPECT_EQ(LaunchedKernels.size(), ThreadCount);
+
+  // The clones are released along with the rest of the cache.
+  ASSERT_GT(KernelsCreated, 0u);
+  KernelsReleased = 0;
+  detail::getSyclObjImpl(Q.get_context())->getKernelProgramCache().reset();
+  EXPECT_EQ(KernelsReleased, KernelsCreated);
+}
+} // namespace
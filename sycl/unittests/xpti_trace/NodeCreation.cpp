@@ -10,6 +10,7 @@
 #include <helpers/ScopedEnvVar.hpp>
 #include <helpers/TestKernel.hpp>
 
+#include <detail/config.hpp>
 #include <detail/xpti_registry.hpp>
 
 #include <gmock/gmock.h>
@@ -88,3 +89,43 @@ TEST_F(NodeCreation, QueueParallelForWithNoGraphNode) {
   EXPECT_EQ(TraceType, xpti::trace_node_create);
   EXPECT_THAT(Message, HasSubstr("TestKernel"));
 }
+
+TEST_F(NodeCreation, QueueMemcpyWithNoGraphNode) {
+  sycl::queue Q;
+  int Src = 0, Dst = 0;
+  try {
+    Q.memcpy(&Dst, &Src, sizeof(int));
+  } catch (sycl::exception &e) {
+    std::ignore = e;
+  }
+  Q.wait();
+  uint16_t TraceType = 0;
+  std::string Message;
+  ASSERT_TRUE(queryReceivedNotifications(TraceType, Message));
+  EXPECT_EQ(TraceType, xpti::trace_node_create);
+  EXPECT_THAT(Message, HasSubstr("copy usm"));
+}
+
+TEST_F(NodeCreation, QueueParallelForSampled) {
+  unittest::ScopedEnvVar SamplingRate{
+      "SYCL_XPTI_SAMPLING_RATE", "2",
+      detail::SYCLConfig<detail::SYCL_XPTI_SAMPLING_RATE>::reset};
+  sycl::queue Q;
+  for (int I = 0; I < 4; ++I) {
+    try {
+      Q.parallel_for<TestKernel<KernelSize>>(1, [=](sycl::id<1> idx) {});
+    } catch (sycl::exception &e) {
+      std::ignore = e;
+    }
+  }
+  Q.wait();
+  // Only every second submission is traced.
+  uint16_t TraceType = 0;
+  std::string Message;
+  size_t NumNodes = 0;
+  while (queryReceivedNotifications(TraceType, Message)) {
+    EXPECT_EQ(TraceType, xpti::trace_node_create);
+    ++NumNodes;
+  }
+  EXPECT_EQ(NumNodes, 2u);
+}
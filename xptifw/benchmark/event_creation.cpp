@@ -0,0 +1,46 @@
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include "xpti/xpti_trace_framework.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+// Threads submitting from the same place in the code create the same event
+// again and again.
+static void BM_MakeSameEvent(benchmark::State &State) {
+  xpti::payload_t Payload("kernel", "file.cpp", 10, 1, nullptr);
+  uint64_t InstanceNo;
+  for (auto _ : State)
+    benchmark::DoNotOptimize(xptiMakeEvent("kernel", &Payload,
+                                           xpti::trace_graph_event,
+                                           xpti_at::active, &InstanceNo));
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_MakeSameEvent)->ThreadRange(1, 32)->UseRealTime();
+
+// Each thread creates its own set of events.
+static void BM_MakeDistinctEvents(benchmark::State &State) {
+  constexpr int NumEvents = 256;
+  std::vector<std::string> Names;
+  for (int I = 0; I < NumEvents; ++I)
+    Names.push_back("kernel_" + std::to_string(State.thread_index()) + "_" +
+                    std::to_string(I));
+
+  uint64_t InstanceNo;
+  int I = 0;
+  for (auto _ : State) {
+    const std::string &Name = Names[I++ % NumEvents];
+    xpti::payload_t Payload(Name.c_str(), "file.cpp", I % NumEvents, 1,
+                            nullptr);
+    benchmark::DoNotOptimize(xptiMakeEvent(Name.c_str(), &Payload,
+                                           xpti::trace_graph_event,
+                                           xpti_at::active, &InstanceNo));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_MakeDistinctEvents)->ThreadRange(1, 32)->UseRealTime();
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -244,10 +245,21 @@ private:
 /// \details The class uses the global string table to register the strings it
 /// encounters in various payloads and builds internal hash maps to manage them.
 /// This is a single point for managing tracepoints.
+///
+/// The tables are split into shards by the universal ID, each protected by
+/// its own reader-writer lock, so looking up tracepoints that already exist
+/// doesn't serialize the threads creating events. Each thread also caches the
+/// events it created recently, so creating the same event again only locks
+/// that event to update its instance ID.
 class Tracepoints {
 public:
+  /// An event along with the lock protecting its instance ID.
+  struct EventEntry {
+    xpti::trace_event_data_t Event;
+    std::mutex InstanceMutex;
+  };
   using uid_payload_lut = std::unordered_map<uint64_t, xpti::payload_t>;
-  using uid_event_lut = std::unordered_map<uint64_t, xpti::trace_event_data_t>;
+  using uid_event_lut = std::unordered_map<uint64_t, EventEntry>;
 
   Tracepoints(xpti::StringTable &st)
       : MUId(1), MStringTableRef(st), MInsertions(0), MRetrievals(0) {
@@ -263,8 +275,13 @@ public:
     // and -1 is invalid_id
     MUId = 1;
     MInsertions = MRetrievals = 0;
-    MPayloads.clear();
-    MEvents.clear();
+    for (Shard &S : MShards) {
+      std::unique_lock<std::shared_mutex> Lock(S.Mutex);
+      S.Payloads.clear();
+      S.Events.clear();
+      // Events of the shard cached by the threads are gone after this.
+      ++S.Generation;
+    }
   }
 
   inline uint64_t makeUniqueID() { return MUId++; }
@@ -286,9 +303,13 @@ public:
   //  1. Create a hash for the payload and cache it
   //  2. Create a mapping from Universal ID <--> Payload
   //  3. Create a mapping from Universal ID <--> Event
+  //
+  //  The event and activity types are set while the event can't be dropped
+  //  by clear() on another thread.
   xpti::trace_event_data_t *create(const xpti::payload_t *Payload,
+                                   uint16_t EventType, uint16_t ActivityType,
                                    uint64_t *InstanceNo) {
-    return register_event(Payload, InstanceNo);
+    return register_event(Payload, EventType, ActivityType, InstanceNo);
   }
   // Method to get the payload information from the event structure. This method
   // uses the Universal ID in the event structure to lookup the payload
@@ -298,38 +319,42 @@ public:
   const xpti::payload_t *payloadData(xpti::trace_event_data_t *Event) {
     if (!Event || Event->unique_id == xpti::invalid_uid)
       return nullptr;
-    // Scoped lock until the information is retrieved from the map
+    Shard &S = shard(Event->unique_id);
     {
-      std::lock_guard<std::mutex> Lock(MEventMutex);
+      std::shared_lock<std::shared_mutex> Lock(S.Mutex);
       if (Event->reserved.payload)
         return Event->reserved.payload;
-      else {
-        // Cache it in case it is not already cached
-        Event->reserved.payload = &MPayloads[Event->unique_id];
-        return Event->reserved.payload;
-      }
     }
+    // Cache it in case it is not already cached
+    std::unique_lock<std::shared_mutex> Lock(S.Mutex);
+    if (!Event->reserved.payload)
+      Event->reserved.payload = &S.Payloads[Event->unique_id];
+    return Event->reserved.payload;
   }
 
   const xpti::payload_t *payloadDataByUID(uint64_t uid) {
     if (uid == xpti::invalid_uid)
       return nullptr;
-    // Scoped lock until the information is retrieved from the map
+    Shard &S = shard(uid);
     {
-      std::lock_guard<std::mutex> Lock(MEventMutex);
-      // Cache it in case it is not already cached
-      return &MPayloads[uid];
+      std::shared_lock<std::shared_mutex> Lock(S.Mutex);
+      auto PLoc = S.Payloads.find(uid);
+      if (PLoc != S.Payloads.end())
+        return &PLoc->second;
     }
+    std::unique_lock<std::shared_mutex> Lock(S.Mutex);
+    return &S.Payloads[uid];
   }
 
   const xpti::trace_event_data_t *eventData(uint64_t UId) {
     if (UId == xpti::invalid_uid)
       return nullptr;
 
-    std::lock_guard<std::mutex> Lock(MEventMutex);
-    auto EvLoc = MEvents.find(UId);
-    if (EvLoc != MEvents.end())
-      return &(EvLoc->second);
+    Shard &S = shard(UId);
+    std::shared_lock<std::shared_mutex> Lock(S.Mutex);
+    auto EvLoc = S.Events.find(UId);
+    if (EvLoc != S.Events.end())
+      return &(EvLoc->second.Event);
     else
       return nullptr;
   }
@@ -378,10 +403,11 @@ public:
     if (HashValue == xpti::invalid_uid)
       return xpti::invalid_uid;
 
-    std::lock_guard<std::mutex> Lock(MEventMutex);
+    Shard &S = shard(HashValue);
+    std::unique_lock<std::shared_mutex> Lock(S.Mutex);
     // We also want to query the payload by universal ID that has been
     // generated
-    auto &CurrentPayload = MPayloads[HashValue];
+    auto &CurrentPayload = S.Payloads[HashValue];
     Payload->flags |= (uint64_t)payload_flag_t::PayloadRegistered;
     CurrentPayload = *Payload; // when it uses tbb, should be thread-safe
 
@@ -452,6 +478,8 @@ private:
   //
   // This method is thread-safe
   xpti::trace_event_data_t *register_event(const xpti::payload_t *Payload,
+                                           uint16_t EventType,
+                                           uint16_t ActivityType,
                                            uint64_t *InstanceNo) {
     xpti::payload_t TempPayload = *Payload;
     // Initialize to invalid
@@ -462,9 +490,9 @@ private:
     // written to the same field in the structure. If we have a lock guard, we
     // may be spinning and wasting time instead. We will just compute this in
     // parallel.
-    // 2. MPayloads is queried and updated in a critical section. So, multiple
-    // threads attempting to register the same payload to receive an event
-    // should get the same event.
+    // 2. The payload and event tables are queried and updated in a critical
+    // section of their shard. So, multiple threads attempting to register the
+    // same payload to receive an event should get the same event.
     //
     //  Make a hash value from the payload. If the hash value created is
     //  invalid, return immediately
@@ -472,29 +500,42 @@ private:
     if (HashValue == xpti::invalid_uid)
       return nullptr;
 
-    std::lock_guard<std::mutex> Lock(MEventMutex);
-    auto EvLoc = MEvents.find(HashValue);
-    if (EvLoc != MEvents.end()) {
-#ifdef XPTI_STATISTICS
-      MRetrievals++;
-#endif
-      EvLoc->second.instance_id++;
-      // Guarantees that the returned instance ID will be accurate as
-      // it is on the stack
-      if (InstanceNo)
-        *InstanceNo = EvLoc->second.instance_id;
-      return &(EvLoc->second);
+    CachedEvent &Cached = cachedEvent(HashValue);
+    Shard &S = shard(HashValue);
+    {
+      std::shared_lock<std::shared_mutex> Lock(S.Mutex);
+      if (Cached.Entry && Cached.UId == HashValue &&
+          Cached.Generation == S.Generation)
+        return nextInstance(*Cached.Entry, EventType, ActivityType,
+                            InstanceNo);
+
+      auto EvLoc = S.Events.find(HashValue);
+      if (EvLoc != S.Events.end()) {
+        Cached = {HashValue, S.Generation, &EvLoc->second};
+        return nextInstance(EvLoc->second, EventType, ActivityType,
+                            InstanceNo);
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> Lock(S.Mutex);
+    // Another thread may have registered the payload in the meantime.
+    auto EvLoc = S.Events.find(HashValue);
+    if (EvLoc != S.Events.end()) {
+      Cached = {HashValue, S.Generation, &EvLoc->second};
+      return nextInstance(EvLoc->second, EventType, ActivityType, InstanceNo);
     } else {
 #ifdef XPTI_STATISTICS
       MInsertions++;
 #endif
       // We also want to query the payload by universal ID that has been
       // generated
-      auto &CurrentPayload = MPayloads[HashValue];
+      auto &CurrentPayload = S.Payloads[HashValue];
       CurrentPayload = TempPayload; // when it uses tbb, should be thread-safe
       CurrentPayload.flags |= (uint64_t)payload_flag_t::PayloadRegistered;
 
-      xpti::trace_event_data_t *Event = &MEvents[HashValue];
+      EventEntry &Entry = S.Events[HashValue];
+      Cached = {HashValue, S.Generation, &Entry};
+      xpti::trace_event_data_t *Event = &Entry.Event;
       // We are seeing this unique ID for the first time, so we will
       // initialize the event structure with defaults and set the unique_id to
       // the newly generated unique id (uid)
@@ -504,21 +545,67 @@ private:
       Event->data_id = Event->source_id = Event->target_id = 0;
       Event->instance_id = 1;
       Event->global_user_data = nullptr;
-      Event->event_type = (uint16_t)xpti::trace_event_type_t::unknown_event;
-      Event->activity_type =
-          (uint16_t)xpti::trace_activity_type_t::unknown_activity;
+      Event->event_type = EventType;
+      Event->activity_type = ActivityType;
       *InstanceNo = Event->instance_id;
       return Event;
     }
   }
 
+  // Counts another instance of an event that exists already.
+  xpti::trace_event_data_t *nextInstance(EventEntry &Entry, uint16_t EventType,
+                                         uint16_t ActivityType,
+                                         uint64_t *InstanceNo) {
+#ifdef XPTI_STATISTICS
+    MRetrievals++;
+#endif
+    std::lock_guard<std::mutex> Lock(Entry.InstanceMutex);
+    Entry.Event.instance_id++;
+    Entry.Event.event_type = EventType;
+    Entry.Event.activity_type = ActivityType;
+    // Guarantees that the returned instance ID will be accurate as
+    // it is on the stack
+    if (InstanceNo)
+      *InstanceNo = Entry.Event.instance_id;
+    return &Entry.Event;
+  }
+
+  static constexpr size_t NumShards = 64;
+  static constexpr size_t NumCachedEvents = 16;
+
+  struct Shard {
+    std::shared_mutex Mutex;
+    uid_payload_lut Payloads;
+    uid_event_lut Events;
+    // Bumped by clear() under the exclusive lock.
+    uint64_t Generation = 1;
+  };
+
+  // An event created recently by the current thread. The entries of the
+  // event tables don't move, so the pointer stays valid until clear() moves
+  // its shard on to the next generation. The generation is compared and the
+  // entry used with the shard lock held, so clear() can't drop the entry in
+  // between.
+  struct CachedEvent {
+    uint64_t UId = xpti::invalid_uid;
+    uint64_t Generation = 0;
+    EventEntry *Entry = nullptr;
+  };
+
+  Shard &shard(uint64_t UId) {
+    return MShards[(UId ^ (UId >> 32)) % NumShards];
+  }
+
+  static CachedEvent &cachedEvent(uint64_t UId) {
+    static thread_local std::array<CachedEvent, NumCachedEvents> Cache;
+    return Cache[(UId ^ (UId >> 32)) % NumCachedEvents];
+  }
+
   xpti::safe_int64_t MUId;
   xpti::StringTable &MStringTableRef;
   xpti::safe_uint64_t MInsertions, MRetrievals;
-  uid_payload_lut MPayloads;
-  uid_event_lut MEvents;
+  std::array<Shard, NumShards> MShards;
   std::mutex MMetadataMutex;
-  std::mutex MEventMutex;
 };
 
 /// \brief Helper class to manage subscriber callbacks for a given tracepoint
@@ -809,7 +896,8 @@ public:
     if (Payload->flags == 0)
       return nullptr;
 
-    xpti::trace_event_data_t *Event = MTracepoints.create(Payload, InstanceNo);
+    xpti::trace_event_data_t *Event = MTracepoints.create(
+        Payload, EventType, (uint16_t)ActivityType, InstanceNo);
 
     // Event is not managed by anyone. The unique_id that is a part of the
     // event structure can be used to determine the payload that forms the
@@ -821,8 +909,6 @@ public:
     // On the other hand, the 'UserData' field is for user data and should be
     // managed by the user code. The framework will NOT free any memory
     // allocated to this pointer
-    Event->event_type = EventType;
-    Event->activity_type = (uint16_t)ActivityType;
     return Event;
   }
 
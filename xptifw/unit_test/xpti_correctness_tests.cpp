@@ -7,11 +7,14 @@
 #include "xpti/xpti_trace_framework.hpp"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <random>
 #include <set>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 static bool TPCBCalled = false;
 
@@ -56,6 +59,50 @@ TEST_F(xptiCorrectnessTest, xptiMakeEvent) {
   EXPECT_EQ(Result->reserved.payload->line_no, 1u);
 }
 
+TEST_F(xptiCorrectnessTest, xptiMakeEventAfterResetOnOtherThread) {
+  uint64_t Instance = 0;
+  xpti::payload_t p((void *)13);
+  auto Result =
+      xptiMakeEvent("foo", &p, 0, (xpti::trace_activity_type_t)1, &Instance);
+  ASSERT_NE(Result, nullptr);
+  EXPECT_EQ(Instance, 1u);
+  p = xpti::payload_t((void *)13);
+  (void)xptiMakeEvent("foo", &p, 0, (xpti::trace_activity_type_t)1, &Instance);
+  EXPECT_EQ(Instance, 2u);
+
+  // The event cached by this thread must not survive the reset.
+  std::thread([] { xptiReset(); }).join();
+  p = xpti::payload_t((void *)13);
+  Result =
+      xptiMakeEvent("foo", &p, 0, (xpti::trace_activity_type_t)1, &Instance);
+  ASSERT_NE(Result, nullptr);
+  EXPECT_EQ(Instance, 1u);
+}
+
+TEST_F(xptiCorrectnessTest, xptiMakeEventConcurrentWithReset) {
+  constexpr int NumThreads = 4;
+  constexpr int NumEvents = 8;
+  constexpr int NumIterations = 20000;
+  std::atomic<int> Finished{0};
+  std::vector<std::thread> Threads;
+  for (int T = 0; T < NumThreads; ++T)
+    Threads.emplace_back([&] {
+      for (int I = 0; I < NumIterations; ++I) {
+        uint64_t Instance = 0;
+        xpti::payload_t p((void *)(uintptr_t)(I % NumEvents + 1));
+        auto Result = xptiMakeEvent("foo", &p, 0,
+                                    (xpti::trace_activity_type_t)1, &Instance);
+        EXPECT_NE(Result, nullptr);
+        EXPECT_GE(Instance, 1u);
+      }
+      ++Finished;
+    });
+  while (Finished < NumThreads)
+    xptiReset();
+  for (auto &Thread : Threads)
+    Thread.join();
+}
+
 TEST_F(xptiCorrectnessTest, xptiRegisterString) {
   char *TStr = nullptr;
   auto ID = xptiRegisterString("foo", &TStr);